@@ -4,26 +4,78 @@
 #include <vector>
 
 // Custom class for efficient BTCS method matrix operations using Thomas algorithm.
-class BTCSMatrixSolver {
+// Templated on the scalar type; float halves memory traffic and doubles the
+// SIMD width of the batched sweeps for screening runs. Instantiated for float
+// and double in BTCSMatrixSolver.cpp.
+template <typename Real>
+class BasicBTCSMatrixSolver {
 public:
-    BTCSMatrixSolver();
-    ~BTCSMatrixSolver();
+    BasicBTCSMatrixSolver();
+    ~BasicBTCSMatrixSolver();
 
     // Setup the solver matrix with the given size.
     void setupMatrix(int size);
 
     // Solve the tridiagonal matrix equation A * x = b using Thomas algorithm.
-    std::vector<double> solve(const std::vector<double>& b);
+    std::vector<Real> solve(const std::vector<Real>& b);
+
+    // Same as solve(), but overwrites rhs with the solution and reuses the
+    // solver's own scratch buffer, so repeated calls do not allocate.
+    void solveInPlace(std::vector<Real>& rhs);
+
+    // Precompute the forward-elimination factors (c' and the pivot
+    // denominators) of the current a_/b_/c_. Call again whenever they change.
+    void factorize();
+
+    // Forward/back substitution with the factors from factorize(); rhs is
+    // overwritten with the solution. Bit-identical to solveInPlace().
+    void solveFactored(std::vector<Real>& rhs) const;
+
+    // Batched mode: nSystems independent systems of the same size, stored
+    // structure-of-arrays (element i of system s at [i * nSystems + s]) so the
+    // sweeps walk contiguously across systems and the inner loop vectorizes.
+    void setupBatch(int size, int nSystems);
+
+    // Solve all batched systems in place: rhs holds the right-hand sides on
+    // entry and the solutions on return, in the same interleaved layout.
+    void solveBatch(std::vector<Real>& rhs);
+
+    // Batched counterparts of factorize()/solveFactored(): factor the current
+    // batchA_/batchB_/batchC_ once, then solve any number of right-hand sides.
+    // Bit-identical to solveBatch().
+    void factorizeBatch();
+    void solveBatchFactored(std::vector<Real>& rhs) const;
+
+    int getBatchSystems() const { return batchSystems; }
+
+    // Interleaved coefficients for the batched mode (filled by the caller)
+    std::vector<Real> batchA_; // Sub-diagonal,   (size - 1) * nSystems
+    std::vector<Real> batchB_; // Main diagonal,  size * nSystems
+    std::vector<Real> batchC_; // Super-diagonal, (size - 1) * nSystems
 
     // making public for testing
-    std::vector<double> a_; // Sub-diagonal
-    std::vector<double> b_; // Main diagonal
-    std::vector<double> c_; // Super-diagonal
+    std::vector<Real> a_; // Sub-diagonal
+    std::vector<Real> b_; // Main diagonal
+    std::vector<Real> c_; // Super-diagonal
 private:
     int matrixSize;
-    // std::vector<double> a_; // Sub-diagonal
-    // std::vector<double> b_; // Main diagonal
-    // std::vector<double> c_; // Super-diagonal
+    std::vector<Real> cPrime_;      // Scratch for the forward sweep of solveInPlace
+    std::vector<Real> factorCPrime_; // c' from factorize()
+    std::vector<Real> factorDenom_;  // Pivot denominators from factorize()
+    int batchSize;
+    int batchSystems;
+    std::vector<Real> batchCPrime_; // Scratch for the forward sweep, reused across calls
+    std::vector<Real> batchFactorCPrime_; // c' from factorizeBatch()
+    std::vector<Real> batchFactorDenom_;  // Pivot denominators from factorizeBatch()
+    // std::vector<Real> a_; // Sub-diagonal
+    // std::vector<Real> b_; // Main diagonal
+    // std::vector<Real> c_; // Super-diagonal
 };
 
+extern template class BasicBTCSMatrixSolver<float>;
+extern template class BasicBTCSMatrixSolver<double>;
+
+// Double precision, the reference solver
+using BTCSMatrixSolver = BasicBTCSMatrixSolver<double>;
+
 #endif // BTCS_MATRIX_SOLVER_H
\ No newline at end of file
@@ -2,6 +2,9 @@
 #define BOUNDARY_CONDITIONS_H
 
 #include <array>
+#include <cstddef>
+#include <string>
+#include <vector>
 
 enum class BoundaryType {
     Dirichlet,
@@ -13,6 +16,14 @@ public:
     virtual ~BoundaryCondition() {}
     virtual BoundaryType getType() const = 0;
     virtual float getValue(const std::array<float, 3>& position) const = 0;
+
+    // Values at many points at one time, in one pass. The default calls
+    // getValue() per point, which is right for time-independent conditions.
+    virtual void evaluate(double time, const std::vector<std::array<float, 3>>& positions,
+                          std::vector<float>& out) const;
+
+    // Whether evaluate() depends on time (solvers then re-read it every step)
+    virtual bool isTimeDependent() const { return false; }
 };
 
 // Dirichlet: fixed temperature
@@ -41,5 +52,59 @@ private:
     float flux_;
 };
 
+// Surface temperature over time and l/L, e.g. from trajectory data. The
+// input columns are resampled once onto tableSize uniform l/L points, so a
+// lookup is a multiply and two linear blends with no search; times are
+// searched once per evaluate(). Outside the table the edge values hold.
+class BoundaryProfile {
+public:
+    BoundaryProfile();
+
+    // times and lL ascending (lL within [0, 1]), values[k * lL.size() + j]
+    // at times[k], lL[j]; throws std::runtime_error on inconsistent sizes
+    BoundaryProfile(const std::vector<double>& times, const std::vector<double>& lL,
+                    const std::vector<double>& values, int tableSize = 1025);
+
+    // Time-independent profile of an l/L law, e.g. MaterialProperties::getExhaustTemp
+    static BoundaryProfile fromFunction(double (*law)(double), int tableSize = 1025);
+
+    // CSV: a "time,<l/L>,<l/L>,..." header, then one "t,T,T,..." row per
+    // time; throws std::runtime_error on a missing or malformed file
+    static BoundaryProfile loadCsv(const std::string& path, int tableSize = 1025);
+
+    bool empty() const { return table_.empty(); }
+    bool isTimeDependent() const { return times_.size() > 1; }
+
+    // Temperatures at one time for count l/L values
+    void evaluate(double time, const double* lL, std::size_t count, double* out) const;
+    double valueAt(double time, double lL) const;
+
+private:
+    std::vector<double> times_;
+    int tableSize_;
+    std::vector<double> table_;     // [k * tableSize_ + m] at l/L = m / (tableSize_ - 1)
+};
+
+// Dirichlet condition read from a BoundaryProfile. A point's l/L is
+// (z - zMin) / height of its position; the profile is not owned. Keeps
+// scratch buffers, so one condition is evaluated by one thread at a time.
+class TabulatedCondition : public BoundaryCondition {
+public:
+    TabulatedCondition(const BoundaryProfile* profile, float zMin = 0.0f, float height = 1.0f);
+    ~TabulatedCondition() override;
+
+    BoundaryType getType() const override;
+    float getValue(const std::array<float, 3>& position) const override; // At t = 0
+    void evaluate(double time, const std::vector<std::array<float, 3>>& positions,
+                  std::vector<float>& out) const override;
+    bool isTimeDependent() const override;
+
+private:
+    const BoundaryProfile* profile_;
+    float zMin_;
+    float height_;
+    mutable std::vector<double> lL_;    // evaluate() scratch
+    mutable std::vector<double> values_;
+};
 
 #endif // BOUNDARY_CONDITIONS_H
\ No newline at end of file
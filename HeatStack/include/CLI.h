@@ -17,6 +17,41 @@ public:
     int         getNumSlices() const;
     int         getPointsPerLayer() const;
     double      getTheta() const;
+    int         getNumThreads() const;
+    int         getSearchWays() const;
+    bool        useResultCache() const;
+    std::string getCacheDir() const;
+    double      getAdaptiveTolerance() const;
+    double      getMinTimeStep() const;
+    double      getMaxTimeStep() const;
+    double      getSteadyStateTolerance() const;
+    bool        useBinaryHistory() const;
+    int         getHistoryEvery() const;
+    double      getHistoryDelta() const;
+    std::string getProfileFile() const;
+    bool        useMeshCache() const;
+    bool        useLateralConduction() const;
+    std::string getSweepFile() const;
+    std::string getPrecision() const;
+    std::string getGridSpacing() const;
+    double      getGridFourier() const;
+    double      getGridStretch() const;
+    std::string getSurrogateFile() const;
+    std::string getSurrogateBuildFile() const;
+    std::string getSearchMethod() const;
+    std::string getSnapshotFile() const;
+    double      getSnapshotQuantum() const;
+    int         getSnapshotEvery() const;
+    std::string getCheckpointDir() const;
+    double      getCheckpointInterval() const;
+    bool        isResume() const;
+    std::string getSurfaceProfileFile() const;
+    bool        isServe() const;
+    int         getWorkerPort() const;
+    std::string getWorkerBind() const;
+    std::string getWorkerList() const;
+    std::string getGroupsFile() const;
+    std::string getStacksFile() const;
 
 
 private:
@@ -36,4 +71,39 @@ private:
     int         numSlices       = 10;
     int         pointsPerLayer  = 10;
     double      theta           = 1.0;
+    int         numThreads      = 0;    // 0 = hardware_concurrency
+    int         searchWays      = 2;    // 2 = serial bisection
+    bool        resultCache     = false;
+    std::string cacheDir;               // empty = memory-only cache
+    double      adaptiveTolerance = 1e-2; // K, RMS step-doubling error
+    double      minTimeStep     = 0.0;  // 0 = TimeHandler default
+    double      maxTimeStep     = 0.0;  // 0 = TimeHandler default
+    double      steadyStateTol  = 0.0;  // K/s, 0 = run to the end
+    bool        binaryHistory   = false;
+    int         historyEvery    = 1;    // keep every Nth history row
+    double      historyDelta    = 0.0;  // K, also keep rows that moved more (0 = off)
+    std::string profileFile;            // Chrome trace output, empty = profiling off
+    bool        meshCache       = true; // .meshbin sidecar next to the mesh
+    bool        lateral         = false; // coupled re-run with conduction between slices
+    std::string sweepFile;              // --sweep manifest, empty = single run
+    std::string precision       = "double"; // TPS search trials: double, float or mixed
+    std::string gridSpacing     = "uniform"; // or clustered (GridOptions)
+    double      gridFourier     = 1.0;  // clustered: alpha*dt/dx^2 at interfaces
+    double      gridStretch     = 1.2;  // clustered: neighbouring cell ratio
+    std::string surrogateFile;          // SurrogateTable to query first, empty = off
+    std::string surrogateBuildFile;     // --surrogate-build output, empty = normal run
+    std::string searchMethod    = "bisect"; // TPS search: bisect or newton
+    std::string snapshotFile;           // full T(x, t) of the optimized runs, empty = off
+    double      snapshotQuantum = 0.01; // K, snapshot rounding step (0 = lossless)
+    int         snapshotEvery   = 1;    // keep every Nth snapshot frame
+    std::string checkpointDir;          // per-slice checkpoints, empty = off
+    double      checkpointInterval = 60.0; // s (wall clock) between checkpoints within a stage
+    bool        resume          = false; // continue from the checkpoints in checkpointDir
+    std::string surfaceProfileFile;     // T(time, l/L) CSV for the outer surface, empty = exhaust law
+    bool        serve           = false; // answer JSON requests on stdin/stdout (HeatStackService)
+    int         workerPort      = 0;    // --worker: serve coordinators on this TCP port, 0 = off
+    std::string workerBind      = "127.0.0.1"; // --worker listen address (unauthenticated: loopback by default)
+    std::string workerList;             // --workers host:port,...: distribute the slices, empty = local
+    std::string groupsFile;             // MeshX metadata JSON with the mesh's face groups, empty = none
+    std::string stacksFile;             // Stack file (MaterialProperties::loadStacks) for the groups
 };
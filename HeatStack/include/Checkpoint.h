@@ -0,0 +1,43 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <cstdint>
+#include <string>
+#include "TemperatureComparator.h"
+
+// Progress of one CLI slice for checkpoint/restart. A slice runs the
+// original transient, the TPS search, then the transient at the suggested
+// thickness; the checkpoint names the stage it is in plus what the stages
+// before it produced, and within a transient the solver state and the size
+// of the history file at that state.
+//
+// Layout (native endianness): "HSCK" | u32 version | run key (u32 length,
+// bytes) | u32 stage | u64 history bytes | solver state (u32 length, bytes)
+// | f64 original carbon/glue, glue/steel, steel | SearchProgress fields |
+// f64 suggested thickness | u8 from surrogate
+struct SliceCheckpoint {
+    enum class Stage : std::uint32_t { OriginalSolve, Search, OptimizedSolve, Done };
+
+    Stage stage = Stage::OriginalSolve;
+    std::string solverState;        // HeatEquationSolver::saveCheckpoint, empty = stage start
+    std::uint64_t historyBytes = 0; // History file size at solverState (HistoryWriter::sync)
+    double origCarbonGlue = 0.0;    // Original run's interface temperatures (from Search on)
+    double origGlueSteel = 0.0;
+    double origSteel = 0.0;
+    SearchProgress search;          // Search bracket (during Search)
+    double tpsOpt = 0.0;            // Suggested thickness (from OptimizedSolve on)
+    bool fromSurrogate = false;
+
+    // File of a slice (0-based) in a checkpoint directory
+    static std::string path(const std::string& directory, int slice);
+
+    // Written to a temporary file and renamed, so a crash mid-write leaves
+    // the previous checkpoint; false if it cannot be written
+    bool save(const std::string& path, const std::string& runKey) const;
+
+    // False (checkpoint unchanged) for a missing or corrupt file, or one
+    // written by a run with another key (other settings)
+    bool load(const std::string& path, const std::string& runKey);
+};
+
+#endif // CHECKPOINT_H
@@ -0,0 +1,113 @@
+#ifndef COUPLED_SLICE_SOLVER_H
+#define COUPLED_SLICE_SOLVER_H
+
+#include <array>
+#include <memory>
+#include <vector>
+#include "BoundaryConditions.h"
+#include "BTCSMatrixSolver.h"
+#include "TimeHandler.h"
+#include "MaterialProperties.h"
+
+// Solves all slices of a run as one 2-D problem: conduction through each
+// stack (x) plus lateral conduction between neighbouring slices along l/L (y).
+//
+// Peaceman-Rachford ADI: each step is a half step implicit through the
+// thickness (one tridiagonal system per slice) followed by a half step
+// implicit along l/L (one system per grid node line). Both sweeps are batched
+// BTCSMatrixSolver solves, split into blocks that run on a persistent thread
+// team. Second order in time and unconditionally stable; with no lateral
+// temperature differences one step equals a Crank-Nicolson step.
+//
+// Slices couple node by node: node i of a slice exchanges heat with node i of
+// its neighbours. generateGrid() gives every layer the same number of points,
+// so node i lies in the same material in every slice. The outer surface is a
+// fixed temperature per slice, the inner face and the first/last slice
+// (along l/L) are insulated.
+class CoupledSliceSolver {
+public:
+    // numThreads <= 0 selects std::thread::hardware_concurrency()
+    explicit CoupledSliceSolver(int numThreads = 0);
+    ~CoupledSliceSolver();
+
+    // One stack per slice in l/L order (at least two, all with the same grid
+    // size); sliceSpacing is the distance between neighbouring slices (m).
+    // Steps use timeHandler's dt; adaptive stepping is not supported.
+    void initialize(const std::vector<Stack>& stacks, double sliceSpacing,
+                    const TimeHandler& timeHandler);
+
+    // Same initial profile for every slice, or one slice's profile
+    void setInitialTemperature(const std::vector<double>& initialTemp);
+    void setInitialTemperature(int slice, const std::vector<double>& initialTemp);
+
+    // Outer surface temperature of every slice (Dirichlet)
+    void setSurfaceTemperatures(const std::vector<double>& temperatures);
+
+    // Outer surface from a (time-dependent) Dirichlet condition at one
+    // position per slice: all slices are evaluated in one batched call at
+    // the middle of each step for the thickness sweep and at its end for
+    // the surface row. The condition is not owned; nullptr reverts to the
+    // fixed temperatures.
+    void setSurfaceCondition(const BoundaryCondition* condition,
+                             const std::vector<std::array<float, 3>>& positions);
+
+    // Advance all slices by one time step
+    void step();
+
+    bool isFinished() const;
+    double getCurrentTime() const;
+
+    int getNumSlices() const;
+    int getNumNodes() const;
+    int getNumThreads() const;
+
+    // Temperature profile of one slice, and a single node
+    std::vector<double> getTemperatureDistribution(int slice) const;
+    double getTemperature(int slice, int node) const;
+
+private:
+    struct Team; // Persistent worker threads for the line sweeps
+
+    // A range of systems solved together by one batched solver: slices for
+    // the thickness sweep, node lines for the lateral sweep
+    struct Block {
+        int begin = 0;
+        int end = 0;
+        BTCSMatrixSolver solver;   // Factored for cachedDt_
+        std::vector<double> rhs;   // Interleaved right-hand sides / solutions
+    };
+
+    int numThreads_;
+    int nSlices_;
+    int nNodes_;
+    double sliceSpacing_;
+    TimeHandler timeHandler_;
+    std::vector<Stack> stacks_;
+    std::vector<double> alpha_;        // Diffusivity, node-major [node * nSlices_ + slice]
+    std::vector<double> rx_;           // alpha*(dt/2)/dx^2 through the thickness, node-major
+    std::vector<double> ry_;           // alpha*(dt/2)/dy^2 along l/L, node-major
+    std::vector<double> temperature_;  // Current field, node-major
+    std::vector<double> half_;         // Field after the thickness half step, node-major
+    std::vector<double> surface_;      // Outer surface temperature per slice
+    const BoundaryCondition* surfaceCondition_; // Source of surface_, if set
+    std::vector<std::array<float, 3>> surfacePositions_; // One per slice
+    std::vector<float> surfaceValues_; // surfaceCondition_ output
+    std::vector<Block> sliceBlocks_;
+    std::vector<Block> lineBlocks_;    // Lines 1..nNodes_-1; line 0 is the surface
+    double cachedDt_;
+    std::unique_ptr<Team> team_;
+
+    // Refresh surface_ from surfaceCondition_ at a time
+    void updateSurface(double time);
+
+    // Fill and factor every block's matrices for a full step of dt
+    void buildSystems(double dt);
+
+    // Half step implicit through the thickness: temperature_ -> half_
+    void sweepThickness(Block& block);
+
+    // Half step implicit along l/L: half_ -> temperature_
+    void sweepLateral(Block& block);
+};
+
+#endif // COUPLED_SLICE_SOLVER_H
@@ -1,67 +1,171 @@
 #ifndef HEAT_EQUATION_SOLVER_H
 #define HEAT_EQUATION_SOLVER_H
 
+#include <iosfwd>
 #include <vector>
 #include "BTCSMatrixSolver.h"
 #include "TimeHandler.h"
 #include "MaterialProperties.h"
 #include "BoundaryConditions.h"
+#include "StepObserver.h"
 
 // Solver for the 1D heat equation using the θ-method (BTCS when θ=1, Crank-Nicolson when θ=0.5)
-class HeatEquationSolver {
+// Real is the scalar of the temperatures and the tridiagonal systems; the
+// grid, diffusivities and dt stay double, and coefficients are formed in
+// double before being stored as Real. Instantiated for float and double.
+template <typename Real>
+class BasicHeatEquationSolver {
 public:
-    HeatEquationSolver(double theta = 0.5);
-    ~HeatEquationSolver();
+    BasicHeatEquationSolver(double theta = 0.5);
+    ~BasicHeatEquationSolver();
 
-    // Initialize the solver with stack properties and time handling
+    // Initialize the solver with stack properties and time handling.
+    // Clustered grids are discretised in flux form (face conductivities and
+    // split node heat capacities); uniform grids keep the per-node
+    // alpha*dt/dx^2 stencil.
     void initialize(const Stack& stack, const TimeHandler& timeHandler);
 
     // Set the initial temperature distribution
     void setInitialTemperature(const std::vector<double>& initialTemp);
 
-    // Set boundary conditions
+    // Set boundary conditions; also picks the RHS kernel for the scheme and
+    // this Dirichlet/Neumann pair. Neumann is the zero-flux mirror condition.
+    // Time-dependent conditions are evaluated at the end of every (sub)step.
     void setBoundaryConditions(BoundaryCondition* outerBC, BoundaryCondition* innerBC);
 
+    // Position the boundary conditions are evaluated at (default origin)
+    void setBoundaryPosition(const std::array<float, 3>& position);
+
     // Advance the simulation by one time step
     void step();
 
+    // Step until finished, steady (setSteadyStateTolerance) or stopped by an
+    // observer. Every observer sees every step, in order; the first one to
+    // return false is reported. Observers are not owned.
+    RunResult run(const std::vector<BasicStepObserver<Real>*>& observers = {});
+
     // Retrieve the current temperature distribution
-    const std::vector<double>& getTemperatureDistribution() const;
+    const std::vector<Real>& getTemperatureDistribution() const;
 
-    // Adjust time step based on CFL or error criteria
+    // Adjust time step from the step-doubling error estimate (PI controller)
     void adjustTimeStep(double errorThreshold = 1e-3);
 
-    // Return whether the solver’s own timeHandler_ has reached totalTime
+    // Target step-doubling error (RMS, K) per adaptive step
+    void setAdaptiveTolerance(double tolerance);
+
+    // Stop early once max|ΔT|/dt drops below rate (K/s); 0 disables
+    void setSteadyStateTolerance(double rate);
+    bool reachedSteadyState() const;
+
+    // Return whether the solver’s own timeHandler_ has reached totalTime,
+    // or steady state was detected
     bool isFinished() const;
 
+    // Size of the last accepted step
+    double getLastTimeStep() const;
+
     // Get the current time from the time handler
     double getCurrentTime() const;
 
+    // Tangent-linear run alongside step(): d(T)/d(thickness of one layer),
+    // starting from zero (initial temperatures do not depend on it). Reuses
+    // the factored matrix, so each step costs one more RHS and substitution.
+    // Needs the uniform-grid stencil and fixed dt; call after initialize().
+    void enableThicknessSensitivity(int layer);
+    const std::vector<Real>& getThicknessSensitivity() const;
+
+    // Binary checkpoint of the transient: temperatures, sensitivity, clock
+    // and the grid it belongs to. Load after initialize() on the same grid
+    // and θ (and enableThicknessSensitivity() if one was saved); the
+    // handler's total time is kept, so a longer run can branch from a saved
+    // prefix. Throws std::runtime_error on a mismatch or a corrupt stream.
+    void saveCheckpoint(std::ostream& out) const;
+    void loadCheckpoint(std::istream& in);
+
 private:
     double theta_;                      // θ parameter (1 for BTCS, 0.5 for Crank-Nicolson)
     int problemSize_;                   // Number of grid points
-    std::vector<double> temperature_;   // Current temperature distribution
-    std::vector<double> prevTemperature_; // Previous time step for error estimation
+    std::vector<Real> temperature_;     // Current temperature distribution
+    std::vector<Real> prevTemperature_; // Previous time step for error estimation
+    std::vector<Real> rhs_;             // Step workspace: RHS, then the new temperature
+    std::vector<double> alpha_;         // Thermal diffusivity per node, set in initialize()
+    bool fluxForm_;                     // Conservative stencil (clustered grids)
+    std::vector<double> faceK_;         // Flux form: conductivity of cell [i, i+1]
+    std::vector<double> heatCapacity_;  // Flux form: rho*c*volume per node and area
+    std::vector<Real> r_;               // alpha*dt/dx^2 per node for cachedDt_; in flux
+                                        // form lower coefficients, then upper ones at [n, 2n)
+    double cachedDt_;                   // dt the matrix and factors were built for
+    bool coefficientsValid_;            // False until built, or after BC/grid changes
+    BasicBTCSMatrixSolver<Real> halfSolver_; // Factored dt/2 system for estimateError
+    std::vector<Real> halfR_;           // r coefficients for halfDt_
+    double halfDt_;                     // dt/2 that halfSolver_ is factored for (0 = none)
+    std::vector<Real> errFull_;         // estimateError workspace: full step
+    std::vector<Real> errHalf_;         // estimateError workspace: two half steps
+    double adaptiveTolerance_;          // Error target for adaptive steps
+    double steadyStateRate_;            // Early-stop threshold, 0 = off
+    bool steadyState_;                  // Set once the threshold is reached
+    double lastDt_;                     // Size of the last accepted step
     Stack stack_;                       // Material stack properties
-    BTCSMatrixSolver matrixSolver_;     // Matrix solver (Thomas algorithm)
+    BasicBTCSMatrixSolver<Real> matrixSolver_; // Matrix solver (Thomas algorithm)
     TimeHandler timeHandler_;           // Time stepping control
     BoundaryCondition* outerBC_;        // Outer boundary condition (Dirichlet)
     BoundaryCondition* innerBC_;        // Inner boundary condition (Neumann)
-
-    // Setup the tridiagonal matrix A for AX = B
-    void setupMatrix(std::vector<std::vector<double>>& A, double dt);
-
-    // Setup the right-hand side vector B
-    void setupRHS(std::vector<double>& b, double dt);
-
-    // Apply boundary conditions to the matrix and RHS
-    void applyBoundaryConditions(std::vector<std::vector<double>>& A, std::vector<double>& b, double dt);
+    std::vector<double> gridSens_;      // Sensitivity run: d(dxm)/d(thickness) / dxm per node
+    std::vector<Real> sens_;            // d(T)/d(thickness), empty = off
+    std::vector<Real> sensRhs_;         // Sensitivity workspace
+
+    // RHS assembly specialised at compile time on θ (BTCS, Crank-Nicolson or
+    // run-time θ) and on both boundary types: T, r, rhs, n, explicit weight,
+    // outer Dirichlet value, inner Dirichlet value. The flux form has its own kernels.
+    using RHSKernel = void (*)(const Real*, const Real*, Real*, int, Real, Real, Real);
+    RHSKernel rhsKernel_;               // Chosen in setBoundaryConditions()
+    Real outerValue_;                   // Dirichlet values, read once from constant BCs
+    Real innerValue_;
+    bool timeDependentBC_;              // Re-read outerValue_/innerValue_ per step
+    std::vector<std::array<float, 3>> bcPosition_; // One point, as evaluate() takes it
+    std::vector<float> bcValue_;        // evaluate() result
+
+    // Fill solver's tridiagonal matrix (interior + BC rows) for dt, store the
+    // per-node r coefficients and factorize
+    void buildSystem(double dt, BasicBTCSMatrixSolver<Real>& solver, std::vector<Real>& r) const;
+
+    // buildSystem for the flux form (fluxForm_)
+    void buildFluxSystem(double dt, BasicBTCSMatrixSolver<Real>& solver, std::vector<Real>& r) const;
+
+    // Read the Dirichlet values at a time (no-op for constant conditions)
+    void updateBoundaryValues(double time);
+
+    // Build the θ-method right-hand side for temperatures T with coefficients r
+    void buildRHS(const std::vector<Real>& T, const std::vector<Real>& r, std::vector<Real>& rhs) const;
 
     // Compute thermal diffusivity for a grid point
     double getThermalDiffusivity(int i) const;
 
-    // Estimate error for adaptive time stepping (Crank-Nicolson)
+    // Rebuild r_, the tridiagonal matrix and its factors for the given dt
+    void updateCoefficients(double dt);
+
+    // Step-doubling error estimate for adaptive time stepping:
+    // RMS difference between one step of dt and two steps of dt/2. Leaves the
+    // solver state untouched; the two-half-step result is left in rhs_.
     double estimateError(double dt);
+
+    // One accepted adaptive step: retry with smaller dt until the error
+    // estimate meets adaptiveTolerance_ (or dt hits its minimum)
+    void adaptiveStep();
+
+    // Update steadyState_ from the change between rhs_ (old) and temperature_
+    void checkSteadyState(double dt);
+
+    // Advance sens_ over the step just taken from old to temperature_: the
+    // step's matrix on d(T), plus d(r)/d(thickness) times the θ-weighted
+    // second differences of the forward temperatures
+    void stepSensitivity(const std::vector<Real>& old);
 };
 
+extern template class BasicHeatEquationSolver<float>;
+extern template class BasicHeatEquationSolver<double>;
+
+// Double precision, the reference solver
+using HeatEquationSolver = BasicHeatEquationSolver<double>;
+
 #endif // HEAT_EQUATION_SOLVER_H
\ No newline at end of file
@@ -0,0 +1,92 @@
+#ifndef HEATSTACK_SERVICE_H
+#define HEATSTACK_SERVICE_H
+
+#include "ParameterSweep.h"
+#include "MeshHandler.h"
+#include "SimulationCache.h"
+#include "SliceScheduler.h"
+#include <iosfwd>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Long-running request/response mode (heatstack --serve). Requests and
+// responses are single-line JSON objects, one per line, on stdin/stdout:
+//
+//   {"id": 1, "op": "simulate", "slices": 12, "slice": 3, "time": 60}
+//   {"id": 1, "ok": true, "rows": [{"slice": 3, "lL": 0.18, ...}]}
+//
+// Ops:
+//   simulate  final interface temperatures of the original stacks
+//   suggest   TPS search per slice, then the optimized run (as --sweep)
+//   stats     requests served, meshes loaded, result cache counters
+//   shutdown  answer, then stop serving
+//
+// simulate/suggest take "mesh", "init", "slices", an optional 1-based
+// "slice" (a number or a list) and the config keys of a sweep manifest (dt,
+// theta, points, time, adaptive and the three limits); anything left out
+// comes from the defaults. "zRange": [zMin, zMax] replaces the mesh and
+// "initTemperature": [...] the init file, so a --worker needs neither file.
+// In worker mode (setWorkerMode) a request may not name server-side files
+// ("mesh", "init") or stop the service ("shutdown"); the peer is any process
+// that reaches the TCP port. Rows carry the SweepRow fields. A bad request gets
+// {"id": ..., "ok": false, "error": "..."} and the service keeps going.
+//
+// Between requests the service keeps every mesh and initial temperature
+// profile it has loaded, one result cache (so repeated trial stacks are
+// solved once per process) and one worker pool.
+class HeatStackService {
+public:
+    struct Stats {
+        long long requests = 0;     // Requests answered, errors included
+        long long errors = 0;       // Answered with ok = false
+        int meshLoads = 0;          // Meshes parsed (or read from .meshbin)
+    };
+
+    // defaults: mesh, init, slices and configs[0] for fields a request
+    // leaves out. options.cache, mesh, z range, initialTemperature, scheduler
+    // and slices are set by the service per request.
+    HeatStackService(const SweepManifest& defaults, const SweepOptions& options,
+                     const std::string& cacheDir = std::string());
+
+    // Answer one request line (without the trailing newline)
+    std::string handle(const std::string& request);
+
+    // Answer requests from in until end of input or "shutdown"
+    void serve(std::istream& in, std::ostream& out);
+
+    bool isShutdownRequested() const { return shutdown_; }
+    Stats getStats() const { return stats_; }
+    SimulationCache::Stats getCacheStats() const { return cache_.getStats(); }
+
+    // Read and write the "<mesh>.meshbin" sidecar when loading (on by default)
+    void setUseMeshCache(bool enable);
+
+    // Requests come from --workers coordinators: refuse "mesh", "init" and
+    // "shutdown" (off by default)
+    void setWorkerMode(bool enable) { workerMode_ = enable; }
+
+private:
+    // Mesh / initial profile loaded once per path; throws if unreadable
+    const MeshHandler& mesh(const std::string& path);
+    const std::vector<double>& initialTemperature(const std::string& path);
+
+    // Run a simulate or suggest request, rows as a JSON array
+    std::string runRequest(const JsonValue& request, bool search);
+
+    std::string statsJson() const;
+
+    SweepManifest defaults_;
+    SweepOptions options_;
+    bool useMeshCache_ = true;
+    bool workerMode_ = false;
+    bool shutdown_ = false;
+    Stats stats_;
+    SimulationCache cache_;
+    SliceScheduler scheduler_;
+    std::map<std::string, std::unique_ptr<MeshHandler>> meshes_;
+    std::map<std::string, std::vector<double>> initialTemperatures_;
+};
+
+#endif // HEATSTACK_SERVICE_H
@@ -0,0 +1,109 @@
+#ifndef HISTORY_WRITER_H
+#define HISTORY_WRITER_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <initializer_list>
+#include <cstddef>
+#include <cstdint>
+
+enum class HistoryFormat { Csv, Binary };
+
+// Output and decimation settings for a HistoryWriter
+struct HistoryOptions {
+    HistoryFormat format = HistoryFormat::Csv;
+    int every = 1;                  // Keep every Nth row
+    double deltaThreshold = 0.0;    // Also keep rows where any value moved by more (0 = off)
+    std::size_t blockRows = 4096;   // Rows per block handed to the writer thread
+    std::size_t maxPendingBlocks = 4; // record() waits when this many blocks are queued
+    std::uint64_t resumeBytes = 0;  // Continue a file cut back to this size (from sync()), 0 = new file
+};
+
+// Streaming time-history sink. Rows are collected into fixed-size blocks and
+// handed to a background thread that formats and writes them, so the solver
+// thread never formats doubles and memory stays bounded per history
+// ((maxPendingBlocks + 2) blocks) however long the run is.
+//
+// Binary layout (native endianness):
+//   "HSTH" | u32 version | u32 nColumns | nColumns x (u32 length, name bytes)
+//   then blocks: u32 rows | column 0 values (rows doubles) | column 1 ...
+class HistoryWriter {
+public:
+    // Column 0 is the time column; the ΔT threshold looks at the others
+    HistoryWriter(const std::string& path, const std::vector<std::string>& columns,
+                  const HistoryOptions& options = HistoryOptions());
+    ~HistoryWriter();
+
+    HistoryWriter(const HistoryWriter&) = delete;
+    HistoryWriter& operator=(const HistoryWriter&) = delete;
+
+    bool isOpen() const;
+
+    // Offer one row (one value per column); decimation decides if it is kept
+    void record(std::initializer_list<double> row);
+
+    // Flush, keep the last offered row if decimation dropped it, join the thread
+    void close();
+
+    // Write out every kept row and return the file size, for a checkpoint
+    // to resume from (HistoryOptions::resumeBytes). A row decimation is
+    // holding back is not included; decimation restarts on resume.
+    std::uint64_t sync();
+
+    // Rows actually written (after decimation)
+    std::size_t getWrittenRows() const;
+
+    // Read a binary history back, values grouped per column
+    static bool readBinary(const std::string& path, std::vector<std::string>& columns,
+                           std::vector<std::vector<double>>& data);
+
+    // Convert a binary history to the CSV layout
+    static bool exportCsv(const std::string& binaryPath, const std::string& csvPath);
+
+    // File extension matching a format (".csv" / ".bin")
+    static const char* extension(HistoryFormat format);
+
+private:
+    struct Block {
+        std::vector<double> values; // Row-major, blockRows x nColumns
+        std::size_t rows = 0;
+    };
+
+    void append(const double* row);
+    void flushCurrent();
+    void writerLoop();
+    void writeHeader();
+    void writeBlock(const Block& block);
+
+    HistoryOptions options_;
+    std::size_t nColumns_;
+    std::vector<std::string> columns_;
+    std::ofstream out_;
+
+    // Decimation state (solver thread only)
+    std::vector<double> lastKept_;
+    std::vector<double> lastOffered_;
+    bool hasKept_ = false;
+    bool lastDropped_ = false;
+    int sinceKept_ = 0;
+    std::size_t writtenRows_ = 0;
+
+    Block current_;
+    std::deque<Block> pending_;     // Full blocks waiting for the writer thread
+    std::vector<Block> freeBlocks_; // Recycled blocks
+    std::mutex mutex_;
+    std::condition_variable workReady_;
+    std::condition_variable spaceReady_;
+    bool closing_ = false;
+    bool writing_ = false;          // Writer thread is outside the lock with a block
+    std::condition_variable idle_;
+    bool closed_ = false;
+    std::thread worker_;
+};
+
+#endif // HISTORY_WRITER_H
@@ -0,0 +1,33 @@
+#ifndef JSON_H
+#define JSON_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+// Minimal JSON value for manifests and service requests: objects, arrays,
+// numbers, strings, booleans
+struct JsonValue {
+    enum class Type { Null, Bool, Number, String, Array, Object };
+    Type type = Type::Null;
+    bool boolean = false;
+    double number = 0.0;
+    std::string string;
+    std::vector<JsonValue> array;
+    std::vector<std::pair<std::string, JsonValue>> object; // In file order
+
+    // Member of an object, nullptr if missing (or not an object)
+    const JsonValue* find(const std::string& key) const;
+};
+
+// Parse one JSON document. Errors throw std::runtime_error as
+// "<context>: <what> at offset <n>".
+JsonValue parseJson(const std::string& text, const std::string& context);
+
+// s as a quoted JSON string
+std::string jsonString(const std::string& s);
+
+// value with enough digits to read back the same double
+std::string jsonNumber(double value);
+
+#endif // JSON_H
@@ -0,0 +1,30 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+// Read-only view of a whole file: memory-mapped where possible (POSIX mmap,
+// Win32 file mapping), otherwise read into an owned buffer.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& filename);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool isOpen() const { return open_; }
+    const char* data() const { return data_; }
+    std::size_t size() const { return size_; }
+
+private:
+    const char* data_;
+    std::size_t size_;
+    bool open_;
+    bool mapped_;
+    void* mapping_;     // Win32 mapping handle
+    std::string buffer_;
+};
+
+#endif // MAPPED_FILE_H
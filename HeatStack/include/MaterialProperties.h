@@ -22,12 +22,37 @@ struct Layer {
     int numPoints;              // Number of grid points in this layer
 };
 
+// Node placement used by MaterialProperties::generateGrid
+enum class GridSpacing {
+    Uniform,    // pointsPerLayer evenly spaced nodes in every layer
+    Clustered   // Fine cells at interfaces and the hot surface, stretched geometrically
+};
+
 // Structure to define a stack (TPS, carbon-fiber, glue, steel)
 struct Stack {
     int id;                     // Stack ID
     std::vector<Layer> layers;  // Layers in the stack (outer to inner)
     double totalThickness;      // Total thickness (m)
     std::vector<double> xGrid;  // Grid points across the stack
+    GridSpacing spacing = GridSpacing::Uniform; // Set by generateGrid
+    std::vector<std::string> groups; // Mesh face groups (MeshGroups) using this stack
+};
+
+// Carbon/glue interface, glue/steel interface and inner steel face nodes of
+// a stack with its grid generated (TPS, carbon fiber, glue, steel layers)
+std::array<int, 3> interfaceNodes(const Stack& stack);
+
+// Clustered grid: the cells touching each interface are sized for a target
+// cell Fourier number Fo = alpha*dt/dx^2, then grow by stretchRatio towards
+// the middle of the layer (the insulated inner face is not refined). The
+// point budget of a layer therefore follows its diffusivity and thickness.
+struct GridOptions {
+    GridSpacing spacing = GridSpacing::Uniform;
+    double timeStep = 0.5;          // dt the Fourier target refers to (s)
+    double targetFourier = 1.0;     // Fo of the cells at each interface
+    double stretchRatio = 1.2;      // Max size ratio of neighbouring cells
+    int    minPointsPerLayer = 3;
+    int    maxPointsPerLayer = 200;
 };
 
 // Class to manage material properties and stack configurations
@@ -36,30 +61,60 @@ public:
     MaterialProperties();
     ~MaterialProperties();
 
-    // Load stack configurations from a file or predefined data
+    // Load stack configurations from a JSON file; a stack replaces the one
+    // with the same id. Throws std::runtime_error.
+    //
+    //   { "stacks": [
+    //       { "id": 2, "groups": ["Nozzle", "Skirt"],
+    //         "layers": [ { "material": "TPS", "thickness": 0.002 },
+    //                     { "material": { "name": "CFRP", "k": 5, "rho": 1550, "c": 900,
+    //                                     "maxTemp": 0, "glassTransitionTemp": 420 } },
+    //                     { "material": "Glue" }, { "material": "Steel" } ] } ] }
+    //
+    // Materials are built-in names (getMaterial) or objects; maxTemp and
+    // glassTransitionTemp default to 0 (no limit; the TPS search limits the
+    // steel by maxTemp, glue and carbon by glassTransitionTemp). A layer without a thickness keeps 0
+    // for the caller to fill in (the slice run uses the l/L profiles).
     void loadStacks(const std::string& filename);
 
     // Get stack by ID
     Stack getStack(int id) const;
+    const std::vector<Stack>& getStacks() const { return stacks; }
 
-    // Generate grid points for a stack, ensuring interface alignment
+    // Built-in material: TPS, CarbonFiber, Glue or Steel. Throws if unknown.
+    static Material getMaterial(const std::string& name);
+
+    // Generate grid points for a stack, ensuring interface alignment.
+    // pointsPerLayer is only used by the uniform spacing.
     void generateGrid(Stack& stack, int pointsPerLayer = 10);
 
+    // Spacing used by generateGrid (uniform by default)
+    void setGridOptions(const GridOptions& options);
+    const GridOptions& getGridOptions() const { return gridOptions; }
+
     // Map thickness profiles based on non-dimensional position (l/L)
     double getTPSThickness(double l_over_L) const;
     double getCarbonFiberThickness(double l_over_L) const;
     double getGlueThickness(double l_over_L) const;
     double getSteelThickness(double l_over_L) const;
 
+    // Interior l/L where a thickness profile jumps or kinks (sorted); the
+    // steel sawtooth jumps and carbon-fiber |sin| kinks
+    std::vector<double> getProfileBreakpoints() const;
+
     // Get TPS thickness bounds
     double getMinTPSThickness() const { return 0.0001; } // 0.01 cm
     double getMaxTPSThickness() const { return 0.5; }   // 50 cm
 
     // External surface temperature profile (Dirichlet BC)
-    double getExhaustTemp(double l_over_L) const;
+    static double getExhaustTemp(double l_over_L);
 
 private:
     std::vector<Stack> stacks;  // List of stacks
+    GridOptions gridOptions;
+
+    // Clustered spacing (GridOptions), interface nodes placed exactly
+    void generateClusteredGrid(Stack& stack) const;
 };
 
 #endif // MATERIAL_PROPERTIES_H
\ No newline at end of file
@@ -0,0 +1,115 @@
+#ifndef MESH_BIN_H
+#define MESH_BIN_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "MappedFile.h"
+
+// Binary mesh cache (.meshbin), shared with MeshX (MeshX/include/MeshBin.h
+// implements the same layout). A fixed header is followed by flat arrays,
+// each padded to 8 bytes, in this order:
+//
+//   positions        vertexCount * 3 floats (double if PositionsF64)
+//   triangles        triangleCount * 3 int32 (fan-triangulated faces)
+//   polygonOffsets   (polygonCount + 1) int32       if HasPolygons
+//   polygonElements  polygonElementCount * 3 int32  if HasPolygons (v, vt, vn)
+//   normals          normalCount * 3 doubles
+//   texCoords        texCoordCount * 2 doubles
+//
+// All indices are 0-based. Files are written in native byte order; a reader
+// on the other byte order sees a wrong version and falls back to the OBJ.
+// The source stamp (size, mtime and a content fingerprint) ties a sidecar
+// cache "<mesh>.meshbin" to the OBJ it was built from.
+namespace MeshBin {
+
+constexpr std::uint32_t kVersion = 1;
+
+enum Flags : std::uint32_t {
+    PositionsF64 = 1u << 0,
+    HasPolygons  = 1u << 1,
+    Lenient      = 1u << 2   // Writer skipped malformed OBJ lines
+};
+
+struct Header {
+    char          magic[8];             // "MESHBIN\0"
+    std::uint32_t version;
+    std::uint32_t flags;
+    std::uint64_t sourceSize;
+    std::int64_t  sourceMtime;          // Seconds since the epoch
+    std::uint64_t sourceHash;
+    std::uint64_t vertexCount;
+    std::uint64_t triangleCount;
+    std::uint64_t polygonCount;
+    std::uint64_t polygonElementCount;
+    std::uint64_t normalCount;
+    std::uint64_t texCoordCount;
+    double        bounds[6];            // min x, y, z, max x, y, z
+};
+
+// Identity of a source file, cheap to compute (reads at most 128 KiB)
+struct SourceStamp {
+    std::uint64_t size = 0;
+    std::int64_t  mtime = 0;
+    std::uint64_t hash = 0;             // FNV-1a of the first and last 64 KiB
+};
+
+bool stampOf(const std::string& path, SourceStamp& stamp);
+
+// Sidecar cache path for a mesh file
+std::string sidecarPath(const std::string& meshPath);
+
+// Arrays to write; null pointers / zero counts leave a section empty
+struct Data {
+    const void*         positions = nullptr;
+    bool                positionsF64 = false;
+    std::uint64_t       vertexCount = 0;
+    const std::int32_t* triangles = nullptr;
+    std::uint64_t       triangleCount = 0;
+    const std::int32_t* polygonOffsets = nullptr;
+    const std::int32_t* polygonElements = nullptr;
+    std::uint64_t       polygonCount = 0;
+    std::uint64_t       polygonElementCount = 0;
+    const double*       normals = nullptr;
+    std::uint64_t       normalCount = 0;
+    const double*       texCoords = nullptr;
+    std::uint64_t       texCoordCount = 0;
+    double              bounds[6] = {0, 0, 0, 0, 0, 0};
+    std::uint32_t       extraFlags = 0;  // e.g. Lenient
+};
+
+// Write atomically (temp file + rename); returns false on any I/O error
+bool write(const std::string& path, const Data& data, const SourceStamp& stamp);
+
+// Memory-mapped, validated .meshbin file; the accessors point into the mapping
+class View {
+public:
+    // Maps path and checks magic, version and section sizes
+    bool open(const std::string& path);
+    bool matches(const SourceStamp& stamp) const;
+
+    const Header& header() const { return *header_; }
+    bool positionsF64() const { return (header_->flags & PositionsF64) != 0; }
+    const float* positionsF32() const { return reinterpret_cast<const float*>(positions_); }
+    const double* positionsF64Data() const { return reinterpret_cast<const double*>(positions_); }
+    const std::int32_t* triangles() const { return triangles_; }
+    const std::int32_t* polygonOffsets() const { return polygonOffsets_; }
+    const std::int32_t* polygonElements() const { return polygonElements_; }
+    const double* normals() const { return normals_; }
+    const double* texCoords() const { return texCoords_; }
+
+private:
+    std::unique_ptr<MappedFile> file_;
+    const Header* header_ = nullptr;
+    const char* positions_ = nullptr;
+    const std::int32_t* triangles_ = nullptr;
+    const std::int32_t* polygonOffsets_ = nullptr;
+    const std::int32_t* polygonElements_ = nullptr;
+    const double* normals_ = nullptr;
+    const double* texCoords_ = nullptr;
+};
+
+} // namespace MeshBin
+
+#endif // MESH_BIN_H
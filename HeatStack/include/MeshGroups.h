@@ -0,0 +1,48 @@
+#ifndef MESH_GROUPS_H
+#define MESH_GROUPS_H
+
+#include <string>
+#include <vector>
+#include "MeshHandler.h"
+
+// One face group of a mesh (MeshX metadata group)
+struct MeshGroup {
+    std::string name;
+    std::vector<int> faces;         // Polygon indices, sorted and unique
+    std::vector<std::string> tags;  // elementTags
+};
+
+// Face groups of a mesh, read from the metadata JSON MeshX exports
+// (MetadataExporter): an object of groups keyed by name,
+//
+//   {
+//     "Nozzle": {
+//       "faceIndices": [0, 1, 2],            // or "faceRanges": [first, count, ...]
+//       "spatialData": [ { "faceIndex": 7, "centroid": [...] } ],
+//                                            // or columnar: { "faceIndex": [...], ... }
+//       "elementTags": ["hot"], ...
+//     }, ...
+//   }
+//
+// A group's faces are the union of its face lists; other keys (boundary
+// conditions, material properties, centroids) are not used here. Face
+// indices number the polygons as MeshX stores them, which MeshHandler maps
+// onto its triangles (getPolygonOffsets). Groups keep their file order.
+struct MeshGroups {
+    std::vector<MeshGroup> groups;
+
+    // Index of the group with this name, -1 if none
+    int find(const std::string& name) const;
+
+    // Group of every triangle of mesh (MeshHandler::getFaces), -1 if none. A
+    // face listed by several groups goes to the first of them. Faces past
+    // the end of the mesh throw std::runtime_error (metadata of another
+    // mesh). Runs in parallel; numThreads <= 0 uses all cores.
+    std::vector<int> triangleGroups(const MeshHandler& mesh, int numThreads = 0) const;
+
+    // Parse metadata text / read a file. Throws std::runtime_error.
+    static MeshGroups parse(const std::string& json);
+    static MeshGroups load(const std::string& path);
+};
+
+#endif // MESH_GROUPS_H
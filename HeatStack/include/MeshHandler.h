@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 #include <array>
+#include "MeshBin.h"
 
 class MeshHandler {
 public:
@@ -11,14 +12,28 @@ public:
     MeshHandler(const std::string& filename); // New constructor
     ~MeshHandler();
 
-    // Loads a mesh from a .obj file
+    // Loads a mesh from a .obj file (memory-mapped, parsed in parallel
+    // chunks for large files), or from its .meshbin sidecar when current.
+    // A .meshbin file (e.g. exported by MeshX) is read directly.
     bool loadMesh(const std::string &filename);
 
+    // Number of parse chunks for loadMesh(): 0 = automatic, 1 = serial
+    void setParseThreads(int numThreads);
+
+    // Read and write the "<file>.meshbin" sidecar cache (on by default)
+    void setUseMeshCache(bool enable);
+
     // Access mesh data
     const std::vector<std::array<float, 3>>& getVertices() const;
     const std::vector<std::array<int, 3>>& getFaces() const;
 
-    // Get mesh bounds (min/max values for each axis)
+    // Source faces (OBJ "f" lines, MeshX polygons) are fan-triangulated:
+    // polygon p became the faces [offsets[p], offsets[p + 1]). Empty when
+    // every polygon is one triangle, so polygon p is face p.
+    const std::vector<int>& getPolygonOffsets() const;
+    size_t getPolygonCount() const;
+
+    // Get mesh bounds (min/max values for each axis), computed during load
     float getMinZ() const;
     float getMaxZ() const;
     float getMinX() const;
@@ -29,6 +44,16 @@ public:
 private:
     std::vector<std::array<float, 3>> vertices;
     std::vector<std::array<int, 3>> faces;
+    std::vector<int> polygonOffsets;
+    std::array<float, 3> minBound;
+    std::array<float, 3> maxBound;
+    int parseThreads;
+    bool useMeshCache;
+
+    void resetBounds();
+    bool parseObj(const std::string& filename);
+    // stamp == nullptr: a .meshbin mesh of its own, not a sidecar
+    bool loadCache(const std::string& cachePath, const MeshBin::SourceStamp* stamp);
 };
 
 #endif // MESH_HANDLER_H
\ No newline at end of file
@@ -0,0 +1,100 @@
+#ifndef MESH_RENDERER_H
+#define MESH_RENDERER_H
+
+#include <array>
+#include <vector>
+#include "MeshHandler.h"
+#include "PlaybackFrames.h"
+
+// Retained-mode renderer for the HeatStack mesh views. Positions (already
+// Y-Z swapped) and flat face normals are built once per mesh and uploaded to
+// vertex buffer objects; per-face colors live in their own buffer and are only
+// re-uploaded when the caller hands in new ones. When the driver lacks VBOs
+// (GL < 1.5) the same arrays are drawn as client-side vertex arrays.
+//
+// All methods that touch GL must run on the thread owning the GL context.
+class MeshRenderer {
+public:
+    MeshRenderer();
+    ~MeshRenderer();
+
+    // Build and upload geometry for mesh, tagged with the caller's revision
+    // counter; ensureMesh() only rebuilds when the revision changes.
+    void ensureMesh(const MeshHandler& mesh, int revision);
+    bool hasMesh() const { return vertexCount_ > 0; }
+
+    // True if the uploaded colors were built from the same (tag, version, param)
+    bool colorsMatch(int tag, unsigned long version, int param) const;
+
+    // Upload one RGB color per face (faceColors.size() must equal the face count)
+    void setFaceColors(const std::vector<std::array<float, 3>>& faceColors,
+                       int tag, unsigned long version, int param);
+
+    // Draw the mesh; with colors = false the current glColor is used
+    void draw(bool colors) const;
+
+    // True if playback can run on the GPU (GLSL, float textures, VBOs).
+    // Compiles the shader on first use.
+    bool supportsPlayback();
+
+    // Largest frame count the history texture can hold
+    int maxPlaybackFrames() const { return maxTextureSize_; }
+
+    // Upload the slice of every face (SliceIndex::getFaceSlices) for the
+    // mesh revision and slice count they were binned for
+    bool faceSlicesMatch(int revision, int nSlices) const;
+    void setFaceSlices(const std::vector<int>& faceSlices, int revision, int nSlices);
+
+    // Upload the history texture, colored from minTemp (blue) to maxTemp
+    // (red); false if the driver rejects it (too many frames or slices), then
+    // hasPlaybackFrames() stays false until the next upload and the caller
+    // colors on the CPU. Match reports the last upload, failed or not.
+    bool playbackFramesMatch(int tag, unsigned long version) const;
+    bool setPlaybackFrames(const PlaybackFrames& frames, double minTemp, double maxTemp,
+                           int tag, unsigned long version);
+    bool hasPlaybackFrames() const { return framesCount_ > 0; }
+
+    // Draw with the playback shader at a continuous frame position
+    // (PlaybackFrames::frameOf); only that uniform changes between calls
+    void drawPlayback(double frame) const;
+
+    // Free the GL buffers (call before the context is destroyed)
+    void release();
+
+private:
+    bool loadFunctions();
+    bool buildProgram();
+    void upload(unsigned int& buffer, const std::vector<float>& data, bool dynamic);
+
+    std::vector<float> positions_;  // 3 floats per vertex, triangle soup
+    std::vector<float> normals_;    // Face normal repeated for its 3 vertices
+    std::vector<float> colors_;     // RGB per vertex
+    int vertexCount_;
+    int meshRevision_;
+    bool haveColors_;
+    int colorTag_;
+    unsigned long colorVersion_;
+    int colorParam_;
+
+    bool functionsLoaded_;
+    bool useVbo_;
+    unsigned int positionBuffer_;
+    unsigned int normalBuffer_;
+    unsigned int colorBuffer_;
+
+    // Playback
+    bool programTried_;
+    unsigned int program_;
+    int sliceAttribute_;
+    int frameUniform_;
+    int maxTextureSize_;
+    unsigned int sliceBuffer_;
+    int sliceRevision_;
+    int sliceCount_;
+    unsigned int framesTexture_;
+    int framesTag_;
+    unsigned long framesVersion_;
+    int framesCount_;
+};
+
+#endif // MESH_RENDERER_H
@@ -0,0 +1,116 @@
+#ifndef PARAMETER_SWEEP_H
+#define PARAMETER_SWEEP_H
+
+#include "TemperatureComparator.h"
+#include <string>
+#include <vector>
+
+class SimulationCache;
+class MeshHandler;
+class SliceScheduler;
+struct JsonValue;
+
+// One point of a parameter sweep: everything that changes a slice's result
+struct SweepConfig {
+    double dt = 0.5;
+    double theta = 1.0;
+    int    pointsPerLayer = 10;
+    double duration = 300.0;
+    bool   adaptive = false;
+    double maxSteelTemp = 800.0;    // Limit at the glue/steel interface (K)
+    double maxGlueTemp = 400.0;     // Limit at the carbon/glue interface (K)
+    double maxCarbonTemp = 350.0;   // Limit for the carbon-fiber layer (K)
+};
+
+// Set one config field from a JSON value (the keys of a manifest's "base"
+// and "sweep"). False for an unknown key; a wrong type throws
+// std::runtime_error prefixed with context.
+bool setSweepConfigKey(SweepConfig& config, const std::string& key, const JsonValue& value,
+                       const std::string& context);
+
+// A parsed --sweep manifest: shared inputs plus the expanded parameter grid.
+//
+//   {
+//     "mesh": "tests/humanoid_robot.obj",   // optional, default --mesh
+//     "init": "initial_temperature.csv",    // optional, default --init
+//     "output": "sweep_results.csv",        // optional
+//     "slices": 12,                         // optional, default --slices
+//     "base":  { "time": 300, "dt": 0.5 },  // optional, default from the CLI
+//     "sweep": { "theta": [0.5, 1.0], "points": [10, 20] }
+//   }
+//
+// Config keys (in "base" and "sweep"): dt, theta, points, time, adaptive,
+// maxSteelTemp, maxGlueTemp, maxCarbonTemp. Every "sweep" key holds a list
+// and the configs are the cartesian product, first key slowest.
+struct SweepManifest {
+    std::string meshFile;
+    std::string initFile;
+    std::string outputFile = "sweep_results.csv";
+    int nSlices = 10;
+    std::vector<SweepConfig> configs;
+
+    // Parse manifest text; fields it leaves out keep the values in defaults
+    // (whose configs[0], if any, is the base config). Throws std::runtime_error.
+    static SweepManifest parse(const std::string& json, const SweepManifest& defaults);
+    static SweepManifest load(const std::string& path, const SweepManifest& defaults);
+};
+
+// Result of one (config, slice) job, one row of the results table
+struct SweepRow {
+    int    config = 0;              // Index into SweepManifest::configs
+    int    slice = 0;               // 1-based slice number
+    double lL = 0.0;
+    double originalTPS = 0.0;
+    double optimizedTPS = 0.0;
+    double preCarbonTemp = 0.0, preGlueTemp = 0.0, preSteelTemp = 0.0;
+    double postCarbonTemp = 0.0, postGlueTemp = 0.0, postSteelTemp = 0.0;
+};
+
+// Solver settings that are not swept, shared by all jobs
+struct SweepOptions {
+    int    numThreads = 0;          // 0 = hardware_concurrency
+    int    searchWays = 2;
+    SearchPrecision precision = SearchPrecision::Double;
+    SearchMethod method = SearchMethod::Bisection;
+    GridOptions grid;               // timeStep is replaced by each config's dt
+    double adaptiveTolerance = 1e-2;
+    double minTimeStep = 0.0;
+    double maxTimeStep = 0.0;
+    double steadyStateTol = 0.0;
+    SimulationCache* cache = nullptr;
+    const SurrogateTable* surrogate = nullptr; // Tried before each TPS search
+    bool searchTPS = true;          // false: original stacks only (optimized = original)
+    std::vector<int> slices;        // 1-based subset of each config's slices, empty = all
+
+    // Kept warm by a long-lived caller (HeatStackService), not owned:
+    const MeshHandler* mesh = nullptr;          // Loaded manifest mesh, else run() loads it
+    bool   hasZRange = false;                   // Mesh z extent given: no mesh is loaded at all
+    double zMin = 0.0, zMax = 0.0;
+    const std::vector<double>* initialTemperature = nullptr; // Loaded manifest init profile
+    SliceScheduler* scheduler = nullptr;        // Pool for the jobs, else one per run()
+};
+
+// Runs a manifest in one process: the mesh, initial temperature and material
+// tables are loaded once, then every (config, slice) pair is one job on a
+// single SliceScheduler, so slow configs do not hold up the rest.
+class ParameterSweep {
+public:
+    ParameterSweep(const SweepManifest& manifest, const SweepOptions& options);
+
+    // Run all jobs; rows come back ordered by config, then slice (in
+    // SweepOptions::slices order when given).
+    // Throws std::runtime_error if the shared inputs cannot be loaded.
+    std::vector<SweepRow> run();
+
+    // Write rows as one table (config parameters repeated on every row)
+    bool writeTable(const std::string& path, const std::vector<SweepRow>& rows) const;
+
+    int getNumThreads() const;
+
+private:
+    SweepManifest manifest_;
+    SweepOptions options_;
+    int numThreads_;
+};
+
+#endif // PARAMETER_SWEEP_H
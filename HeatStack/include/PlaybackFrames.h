@@ -0,0 +1,47 @@
+#ifndef PLAYBACK_FRAMES_H
+#define PLAYBACK_FRAMES_H
+
+#include <memory>
+#include <vector>
+#include "ResultsStore.h"
+
+// Interface temperature shown by the playback
+enum class HistoryField { CarbonGlue, GlueSteel, Steel };
+
+// Per-slice temperature histories resampled onto one shared time grid, laid
+// out as the texture the playback shader samples: row s is slice s (0-based,
+// as the SliceIndex bands) and column f the time startTime + f * frameStep().
+// Slices sample their own history linearly; before its first and after its
+// last row a slice holds the end value (runs stopped early at steady state).
+struct PlaybackFrames {
+    static const int kMaxFrames = 4096;
+
+    int nSlices = 0;
+    int nFrames = 0;
+    double startTime = 0.0;
+    double endTime = 0.0;
+    double minTemp = 0.0;             // Range over all slices and frames
+    double maxTemp = 0.0;
+    std::vector<float> values;        // nSlices * nFrames, slice-major
+    std::vector<unsigned char> valid; // Per slice: 0 if it has no history
+
+    bool empty() const { return nFrames == 0; }
+    double frameStep() const { return nFrames > 1 ? (endTime - startTime) / (nFrames - 1) : 0.0; }
+
+    // Continuous frame position of a time, clamped to [0, nFrames - 1]
+    double frameOf(double time) const;
+
+    // Temperature of a slice at a time, interpolated between frames as the
+    // shader's linear texture filter does
+    double sample(int slice, double time) const;
+
+    // Resample the published results (ResultsStore::getAll) of an nSlices
+    // run. optimized selects the optimized runs; slices without one use the
+    // original run, as the summary does. At most maxFrames columns, fewer if
+    // no slice has that many history rows.
+    static PlaybackFrames build(const std::vector<std::shared_ptr<const SliceResult>>& results,
+                                int nSlices, HistoryField field, bool optimized,
+                                int maxFrames = kMaxFrames);
+};
+
+#endif // PLAYBACK_FRAMES_H
@@ -0,0 +1,93 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <string>
+
+// Event counters kept per thread by the profiler
+enum class ProfileCounter {
+    SolverSteps,          // HeatEquationSolver::step() calls
+    MatrixSolves,         // Tridiagonal solves (any BTCSMatrixSolver path)
+    SearchIterations,     // Rounds of the TPS thickness search
+    TrialRuns,            // Transient runs done by the TPS search
+    EarlyStops,           // Trial runs stopped once an interface reached its limit
+    Count
+};
+
+// Lightweight instrumentation: scoped zones and counters recorded into
+// per-thread buffers, summarised as text or exported as a Chrome trace
+// (chrome://tracing, ui.perfetto.dev). While disabled a zone costs one
+// relaxed atomic load and records nothing.
+//
+// enable(), reset(), summary() and writeChromeTrace() must not run while
+// other threads are inside zones (call them before or after a run).
+class Profiler {
+public:
+    static void enable(bool on);
+    static bool isEnabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    // Drop all recorded zones and counters and restart the trace clock
+    static void reset();
+
+    static void count(ProfileCounter counter, unsigned long long n = 1) {
+        if (isEnabled()) addCount(counter, n);
+    }
+
+    // Per-zone totals, per-thread busy time and counters, one line each
+    static std::string summary();
+
+    // Chrome trace event JSON; returns false if the file cannot be written
+    static bool writeChromeTrace(const std::string& path);
+
+    // Called by ProfileZone
+    static void record(const char* name, int slice,
+                       std::chrono::steady_clock::time_point start,
+                       std::chrono::steady_clock::time_point end);
+
+private:
+    static void addCount(ProfileCounter counter, unsigned long long n);
+    static std::atomic<bool> enabled_;
+};
+
+// RAII zone. name must outlive the profiler (use string literals).
+// If accumulateMs is given the zone's duration is added to it even while
+// profiling is disabled, which replaces the hand-written phase timers.
+class ProfileZone {
+public:
+    explicit ProfileZone(const char* name, int slice = -1, double* accumulateMs = nullptr)
+        : name_(name), slice_(slice), accumulateMs_(accumulateMs),
+          active_(accumulateMs != nullptr || Profiler::isEnabled()) {
+        if (active_) start_ = std::chrono::steady_clock::now();
+    }
+
+    ~ProfileZone() { stop(); }
+
+    // End the zone early (the destructor then does nothing)
+    void stop() {
+        if (!active_) return;
+        active_ = false;
+        auto end = std::chrono::steady_clock::now();
+        if (accumulateMs_) {
+            *accumulateMs_ += std::chrono::duration<double, std::milli>(end - start_).count();
+        }
+        if (Profiler::isEnabled()) Profiler::record(name_, slice_, start_, end);
+    }
+
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+    const char* name_;
+    int slice_;
+    double* accumulateMs_;
+    bool active_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+#define HS_PROFILE_CONCAT_(a, b) a##b
+#define HS_PROFILE_CONCAT(a, b) HS_PROFILE_CONCAT_(a, b)
+// Zone covering the rest of the enclosing scope
+#define HS_PROFILE_ZONE(name) ProfileZone HS_PROFILE_CONCAT(hsProfileZone_, __LINE__)(name)
+
+#endif // PROFILER_H
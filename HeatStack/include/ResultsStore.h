@@ -0,0 +1,77 @@
+#ifndef RESULTS_STORE_H
+#define RESULTS_STORE_H
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Interface temperatures over time for one run of one slice
+struct SliceHistory {
+    std::vector<double> time;
+    std::vector<double> carbonGlueTemp;
+    std::vector<double> glueSteelTemp;
+    std::vector<double> steelTemp;
+
+    void append(double t, double carbonGlue, double glueSteel, double steel);
+    bool empty() const { return time.empty(); }
+};
+
+// Temperature profile through the stack at the end of a run
+struct TemperatureProfile {
+    std::vector<double> positions;
+    std::vector<double> temperatures;
+};
+
+// Everything the GUI shows for one slice (the same data the CSVs export)
+struct SliceResult {
+    int slice = 0;                  // 1-based slice number
+    double lL = 0.0;                // l/L position along the mesh
+    double tpsThickness = 0.0;      // Original layer thicknesses (m)
+    double carbonFiberThickness = 0.0;
+    double glueThickness = 0.0;
+    double steelThickness = 0.0;
+    double optimizedTPS = -1.0;     // <= 0 when the optimization produced nothing
+    double preCarbonTemp = 0.0, preGlueTemp = 0.0, preSteelTemp = 0.0;
+    double postCarbonTemp = 0.0, postGlueTemp = 0.0, postSteelTemp = 0.0;
+    SliceHistory origHistory;
+    SliceHistory optHistory;
+    TemperatureProfile finalOrig;
+    TemperatureProfile finalOpt;
+
+    // TPS thickness reported in the summary (optimized if available)
+    double reportedTPS() const { return optimizedTPS > 0 ? optimizedTPS : tpsThickness; }
+};
+
+// Results of the last simulation run, filled by the simulation thread and read
+// by the render loop. Published slices are immutable and handed out as shared
+// pointers, so a frame only takes the lock long enough to copy a pointer.
+class ResultsStore {
+public:
+    ResultsStore();
+
+    // Drop all results and size the store for a new run
+    void reset(int nSlices);
+
+    // Publish the result of slice index (0-based); replaces any earlier one
+    void publish(int index, SliceResult result);
+
+    // nullptr if the slice has not been published (or index is out of range)
+    std::shared_ptr<const SliceResult> getSlice(int index) const;
+
+    // All published slices in slice order
+    std::vector<std::shared_ptr<const SliceResult>> getAll() const;
+
+    // Min/max reportedTPS() over positive values; false (arguments left
+    // untouched) if there are none
+    bool thicknessRange(double& minThickness, double& maxThickness) const;
+
+    // Incremented on every reset/publish so readers can cache derived data
+    unsigned long getVersion() const;
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<std::shared_ptr<const SliceResult>> slices_;
+    unsigned long version_;
+};
+
+#endif // RESULTS_STORE_H
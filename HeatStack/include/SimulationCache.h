@@ -0,0 +1,77 @@
+#ifndef SIMULATION_CACHE_H
+#define SIMULATION_CACHE_H
+
+#include <string>
+#include <unordered_map>
+#include <mutex>
+#include <cstddef>
+#include "MaterialProperties.h"
+
+// Final interface temperatures of one transient run
+struct InterfaceTemperatures {
+    double carbonGlue = 0.0;    // Carbon-fiber/glue interface (K)
+    double glueSteel  = 0.0;    // Glue/steel interface (K)
+    double steel      = 0.0;    // Inner steel surface (K)
+};
+
+// Step control of a run beyond dt and the adaptive flag
+struct StepOptions {
+    double adaptiveTolerance = 1e-2;    // K, step-doubling error target (adaptive runs)
+    double minTimeStep = 0.0;           // Adaptive dt bounds, 0 = TimeHandler default
+    double maxTimeStep = 0.0;
+    double steadyStateRate = 0.0;       // K/s early stop, 0 = run to the end
+};
+
+// Content-addressed cache of simulation results. The key covers everything
+// that decides the outcome (layer thicknesses and materials, grid resolution,
+// dt and step control, θ, duration and the surface BC value), so identical runs from
+// neighbouring slices, repeated GUI runs or overlapping sweeps are solved once.
+// An optional directory adds a persistent tier shared between processes.
+// All methods are thread-safe.
+class SimulationCache {
+public:
+    struct Stats {
+        std::size_t hits = 0;       // Served from memory
+        std::size_t diskHits = 0;   // Served from the disk tier
+        std::size_t misses = 0;     // Had to be simulated
+        double hitRate() const;
+    };
+
+    SimulationCache();
+    explicit SimulationCache(const std::string& diskDirectory);
+    ~SimulationCache();
+
+    // Enable the on-disk tier (empty string disables it)
+    void setDiskDirectory(const std::string& directory);
+
+    // Build the lookup key; doubles are encoded bit-exactly. Results of
+    // float solver runs, of clustered grids and of non-default step control
+    // get their own keys.
+    static std::string makeKey(const Stack& stack, int pointsPerLayer, double dt,
+                               bool adaptive, double theta, double duration,
+                               double surfaceTemp, bool singlePrecision = false,
+                               const GridOptions& grid = GridOptions(),
+                               const StepOptions& steps = StepOptions());
+
+    // Look the key up in memory, then on disk; counts a hit or a miss
+    bool lookup(const std::string& key, InterfaceTemperatures& result);
+
+    // Store a result in memory and, if enabled, on disk
+    void store(const std::string& key, const InterfaceTemperatures& result);
+
+    Stats getStats() const;
+    std::size_t size() const;
+    void clear();
+
+private:
+    std::string diskPath(const std::string& key) const;
+    bool loadFromDisk(const std::string& key, InterfaceTemperatures& result) const;
+    void saveToDisk(const std::string& key, const InterfaceTemperatures& result) const;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, InterfaceTemperatures> entries_;
+    std::string diskDirectory_;
+    Stats stats_;
+};
+
+#endif // SIMULATION_CACHE_H
@@ -0,0 +1,94 @@
+#ifndef SIMULATION_JOB_H
+#define SIMULATION_JOB_H
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+// Thrown by CancellationToken::throwIfCancelled() to unwind a cancelled run
+class JobCancelled : public std::runtime_error {
+public:
+    JobCancelled() : std::runtime_error("job cancelled") {}
+};
+
+// Cooperative cancellation flag. Copies share the same flag; long loops poll
+// it between solver steps.
+class CancellationToken {
+public:
+    CancellationToken();
+
+    void cancel() const;
+    bool isCancelled() const;
+    void throwIfCancelled() const;
+
+private:
+    std::shared_ptr<std::atomic<bool>> flag_;
+};
+
+// A background simulation run with a cancellation token, lock-free progress
+// counters, a status line and a log that the GUI drains every frame.
+// Results are expected to be published by the task itself as they become
+// available (see ResultsStore).
+class SimulationJob {
+public:
+    enum class State { Running, Completed, Failed, Cancelled };
+
+    // Return false to mark the job as failed; exceptions also fail it,
+    // except JobCancelled (or any return after cancel()), which cancels it.
+    using Task = std::function<bool(SimulationJob&)>;
+
+    // Run task on a new thread. A still-running previous job is cancelled and
+    // the new job waits for it on its own thread, so the caller never blocks
+    // and two runs never write the same output at the same time.
+    static std::shared_ptr<SimulationJob> start(Task task,
+                                                std::shared_ptr<SimulationJob> previous = nullptr);
+
+    // Cancels and joins
+    ~SimulationJob();
+
+    SimulationJob(const SimulationJob&) = delete;
+    SimulationJob& operator=(const SimulationJob&) = delete;
+
+    void cancel();
+    bool isCancelled() const;
+    const CancellationToken& getToken() const { return token_; }
+
+    State getState() const;
+    bool isDone() const;
+    void wait();
+
+    // Progress in arbitrary units (lock-free, callable from any thread)
+    void setTotal(int units);
+    void advance(int units = 1);
+    int getDone() const;
+    int getTotal() const;
+    float getFraction() const;
+
+    // Status line and log text (thread-safe)
+    void setStatus(const std::string& status);
+    std::string getStatus() const;
+    void log(const std::string& text);
+    std::string takeLog();
+
+private:
+    SimulationJob();
+    void run(const Task& task, std::shared_ptr<SimulationJob> previous);
+
+    CancellationToken token_;
+    std::atomic<int> state_;
+    std::atomic<int> done_;
+    std::atomic<int> total_;
+
+    mutable std::mutex textMutex_;
+    std::string status_;
+    std::string log_;
+
+    std::mutex joinMutex_;
+    std::thread thread_;
+};
+
+#endif // SIMULATION_JOB_H
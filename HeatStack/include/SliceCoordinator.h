@@ -0,0 +1,56 @@
+#ifndef SLICE_COORDINATOR_H
+#define SLICE_COORDINATOR_H
+
+#include "ParameterSweep.h"
+#include <string>
+#include <vector>
+
+// Address of a heatstack --worker process
+struct WorkerAddress {
+    std::string host;
+    int port = 0;
+};
+
+// Parse "host:port,host:port,..."; throws std::runtime_error
+std::vector<WorkerAddress> parseWorkerList(const std::string& list);
+
+// Everything a worker needs for the slices of one run. The mesh itself is
+// not sent: slice positions only need its z extent.
+struct SliceRequest {
+    SweepConfig config;
+    int nSlices = 10;
+    double zMin = 0.0, zMax = 1.0;
+    std::vector<double> initialTemperature;    // Empty = uniform 300 K
+    bool search = true;                        // suggest (true) or simulate
+};
+
+// Rank 0 of a multi-node run (--workers). Each worker connection takes the
+// next batch of slices from a shared queue as soon as its previous batch is
+// answered, so nodes that draw cheap slices (short bisections) take more.
+// Batches shrink towards the end of the queue so the last ones finish
+// together. A worker that cannot be reached or drops its connection hands
+// its batch back to the others; the run fails only when none is left.
+// Search settings (--search-ways, --precision, --grid, ...) are those the
+// workers were started with.
+class SliceCoordinator {
+public:
+    explicit SliceCoordinator(const std::vector<WorkerAddress>& workers);
+
+    // Slices per request; 0 (default) = the worker's thread count
+    void setBatchSize(int slices);
+
+    // Rows of every slice, in slice order. Throws std::runtime_error if a
+    // worker rejects the request or no worker is left.
+    std::vector<SweepRow> run(const SliceRequest& request);
+
+    // Slices each worker answered in the last run (workers() order)
+    const std::vector<int>& getSlicesPerWorker() const { return slicesPerWorker_; }
+    const std::vector<WorkerAddress>& workers() const { return workers_; }
+
+private:
+    std::vector<WorkerAddress> workers_;
+    int batchSize_ = 0;
+    std::vector<int> slicesPerWorker_;
+};
+
+#endif // SLICE_COORDINATOR_H
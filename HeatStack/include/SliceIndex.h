@@ -0,0 +1,52 @@
+#ifndef SLICE_INDEX_H
+#define SLICE_INDEX_H
+
+#include <cstddef>
+#include <vector>
+#include "MeshHandler.h"
+
+// Face -> slice binning of a mesh into nSlices equal bands along one axis,
+// by face centroid. Built once per mesh and slice count (in parallel, with
+// direct arithmetic instead of a boundary search) and then shared by the
+// thickness coloring, the slice planes and any per-slice analysis.
+class SliceIndex {
+public:
+    SliceIndex();
+
+    // Bin every face of mesh; revision is the caller's mesh revision counter.
+    // numThreads <= 0 uses all cores.
+    void build(const MeshHandler& mesh, int revision, int nSlices, int axis = 1, int numThreads = 0);
+
+    // True if the index was built for this mesh revision and slice count
+    bool isCurrent(int revision, int nSlices) const;
+
+    // Band of a coordinate along the axis. A value on a band edge belongs to
+    // the lower band, values outside the range go to slice 0.
+    int binOf(double value) const;
+
+    int getNumSlices() const { return nSlices_; }
+    int sliceOf(size_t face) const { return faceSlices_[face]; }
+    const std::vector<int>& getFaceSlices() const { return faceSlices_; }
+    const std::vector<size_t>& getFaceCounts() const { return faceCounts_; }
+
+    double getMin() const { return min_; }
+    double getMax() const { return max_; }
+
+    // Lower edge of band i (i == nSlices gives the upper end of the range)
+    double boundary(int i) const;
+
+    // Position of slice i's 1D stack (l/L = i / (nSlices - 1))
+    double samplePosition(int i) const;
+
+private:
+    int revision_;
+    int nSlices_;
+    int axis_;
+    double min_;
+    double max_;
+    double range_; // max_ - min_, or 1 for a flat mesh
+    std::vector<int> faceSlices_;
+    std::vector<size_t> faceCounts_;
+};
+
+#endif // SLICE_INDEX_H
@@ -0,0 +1,89 @@
+#ifndef SLICE_RUN_H
+#define SLICE_RUN_H
+
+#include <array>
+#include <functional>
+#include <vector>
+#include "HeatEquationSolver.h"
+#include "MaterialProperties.h"
+#include "SimulationCache.h"
+#include "TemperatureComparator.h"
+
+// Solver and search settings shared by every slice of a run
+struct SliceSettings {
+    double dt = 0.5;
+    double theta = 1.0;
+    double duration = 300.0;
+    bool   adaptive = false;
+    int    pointsPerLayer = 10;
+    StepOptions steps;              // Adaptive tolerance, dt bounds, steady-state stop
+    GridOptions grid;               // Node placement; timeStep should be dt
+    const std::vector<double>* initialTemperature = nullptr; // Per-node start, else 300 K. Not owned
+    const BoundaryProfile* surfaceProfile = nullptr;         // Outer T(time, l/L), else the exhaust law. Not owned
+
+    // TPS search (TemperatureComparator)
+    int    searchWays = 2;
+    int    searchThreads = 0;       // Per slice, see SliceScheduler::nestedThreads
+    SearchPrecision precision = SearchPrecision::Double;
+    SearchMethod method = SearchMethod::Bisection;
+    SimulationCache* cache = nullptr;
+    const SurrogateTable* surrogate = nullptr;
+    const CancellationToken* cancelToken = nullptr; // Polled between steps and by the search
+};
+
+// One slice of the mesh: its stack at l/L, the transients on it and the TPS
+// search. The CLI pipeline, ParameterSweep (--sweep, --serve, --workers) and
+// the GUI all run their slices through it and only add their own outputs
+// (histories, checkpoints, tables) from the step callbacks.
+class SliceRun {
+public:
+    // Default stack at l/L: built-in materials (MaterialProperties::getMaterial)
+    // and the thickness profiles. A group stack replaces the materials and
+    // the thicknesses it sets (nonzero). id is the stack id of the results.
+    SliceRun(const SliceSettings& settings, int id, double l_over_L, const Stack* groupStack = nullptr);
+
+    const Stack& getStack() const { return stack_; }
+    double getLOverL() const { return lL_; }
+
+    // Carbon/glue, glue/steel and inner steel nodes of the current grid
+    const std::array<int, 3>& getInterfaceNodes() const { return nodes_; }
+    InterfaceTemperatures readInterfaces(const std::vector<double>& temperature) const;
+
+    // Prepare a solver (constructed with settings.theta) for a transient of
+    // the current stack: step control, initial temperature and outer
+    // condition. Throws std::runtime_error if the initial profile does not
+    // fit the grid.
+    void setUp(HeatEquationSolver& solver) const;
+
+    // Step solver to the end, calling onStep after every step; the interface
+    // temperatures at the end. Throws JobCancelled when the token is cancelled.
+    InterfaceTemperatures transient(HeatEquationSolver& solver,
+                                    const std::function<void(const HeatEquationSolver&)>& onStep = nullptr) const;
+
+    // Search limits from the stack's materials: steel maxTemp, glue and
+    // carbon-fiber glassTransitionTemp (0 = no limit), in the interface
+    // fields the search checks them at
+    InterfaceTemperatures materialLimits() const;
+
+    // Smallest TPS thickness keeping the interfaces below limits (as from
+    // materialLimits). progress and onRound as in
+    // TemperatureComparator::setSearchProgress.
+    double suggestThickness(const InterfaceTemperatures& limits, SearchProgress* progress = nullptr,
+                            std::function<void()> onRound = nullptr);
+    bool lastSuggestionFromSurrogate() const { return fromSurrogate_; }
+
+    // Change the TPS thickness; the grid and interface nodes follow
+    void setTPSThickness(double thickness);
+
+private:
+    void generateGrid();
+
+    SliceSettings settings_;
+    MaterialProperties props_;      // Grid generation and thickness bounds
+    Stack stack_;
+    double lL_;
+    std::array<int, 3> nodes_;
+    bool fromSurrogate_ = false;
+};
+
+#endif // SLICE_RUN_H
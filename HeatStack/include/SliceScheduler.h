@@ -0,0 +1,39 @@
+#ifndef SLICE_SCHEDULER_H
+#define SLICE_SCHEDULER_H
+
+#include <functional>
+#include <memory>
+
+// Work-stealing scheduler for running independent slices concurrently.
+// Every worker starts with a contiguous block of slices and, once its own
+// block is drained, steals from the back of the other workers' blocks so that
+// expensive slices (long bisections) do not leave cores idle.
+//
+// Worker threads are started by the first parallel run() and then parked
+// between runs until the scheduler is destroyed, so a long-lived scheduler
+// (HeatStackService) does not start threads per request. run() is not
+// reentrant: tasks must not call run() on the scheduler running them.
+class SliceScheduler {
+public:
+    // numThreads <= 0 selects std::thread::hardware_concurrency()
+    explicit SliceScheduler(int numThreads = 0);
+    ~SliceScheduler();
+
+    // Run task(slice) for every slice in [0, nSlices) and block until all are done.
+    // The first exception thrown by a task is rethrown here after all workers stop.
+    void run(int nSlices, const std::function<void(int)>& task);
+
+    int getNumThreads() const;
+
+    // Threads each of outerThreads concurrent tasks may use for its own nested
+    // run() without oversubscribing the cores (at least 1)
+    static int nestedThreads(int outerThreads);
+
+private:
+    struct Pool;
+
+    int numThreads_;
+    std::unique_ptr<Pool> pool_;    // Parked helper threads, created on demand
+};
+
+#endif // SLICE_SCHEDULER_H
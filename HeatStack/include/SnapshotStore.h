@@ -0,0 +1,150 @@
+#ifndef SNAPSHOT_STORE_H
+#define SNAPSHOT_STORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "MappedFile.h"
+#include "TemperatureDistribution.h"
+
+// Encoding and decimation settings for a SnapshotWriter
+struct SnapshotOptions {
+    double quantum = 0.01;  // K; values are rounded to multiples, error <= quantum/2 (0 = lossless)
+    int chunkFrames = 64;   // Frames per chunk: the most a random read has to decode
+    int every = 1;          // Keep every Nth offered frame (the last one is always kept)
+};
+
+// Full temperature fields T(x, t) of many slices in one compressed file.
+// Each slice's frames are cut into chunks of chunkFrames; a chunk's first
+// frame is stored as node-to-node differences, the others as differences to
+// the previous frame of the same node, zigzag varint coded. In the bounded
+// error mode the differences are between quantized values, so errors do not
+// accumulate; typical fields take one to two bytes per node. Lossless mode
+// stores the XOR of the raw bits with their significant bytes only.
+//
+// Layout (native endianness):
+//   "HSSN" | u32 version | f64 quantum | chunk payloads ...
+//   index: u32 slices, per slice: u32 slice | u32 nodes | u32 grid size |
+//          grid f64s | u32 chunks, per chunk: u64 offset | u64 bytes |
+//          u32 frames | frame times f64
+//   u64 index offset | "HSSN"
+class SnapshotWriter {
+public:
+    SnapshotWriter(const std::string& path, const SnapshotOptions& options = SnapshotOptions());
+    ~SnapshotWriter();
+
+    SnapshotWriter(const SnapshotWriter&) = delete;
+    SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+
+    bool isOpen() const;
+
+    // Node positions stored with the slice (optional)
+    void setGrid(int slice, const std::vector<double>& xGrid);
+
+    // Offer one field of a slice. Safe to call from several threads for
+    // different slices; one slice's frames come in time order with a fixed
+    // node count.
+    void record(int slice, double time, const std::vector<double>& field);
+    void record(int slice, double time, const TemperatureDistribution& field);
+
+    // Flush partial chunks and write the index; false on a write error
+    bool close();
+
+    std::size_t getWrittenFrames() const;
+    std::uint64_t getRawBytes() const;      // As plain doubles
+    std::uint64_t getWrittenBytes() const;  // Whole file, once closed
+
+private:
+    struct Chunk {
+        std::uint64_t offset = 0;
+        std::uint64_t bytes = 0;
+        std::vector<double> times;
+    };
+    struct SliceState {
+        std::size_t nodes = 0;
+        std::vector<double> grid;
+        std::vector<Chunk> chunks;
+        std::vector<double> times;      // Frames of the open chunk
+        std::vector<double> values;     // Frame-major, times.size() x nodes
+        std::vector<double> lastOffered;
+        double lastTime = 0.0;
+        bool lastDropped = false;
+        int sinceKept = 0;
+    };
+
+    SliceState& state(int slice);
+    void keep(SliceState& st, double time, const std::vector<double>& field);
+    void flushChunk(SliceState& st);
+
+    SnapshotOptions options_;
+    std::ofstream out_;
+    std::map<int, SliceState> slices_;  // Node addresses stay put, so a slice's
+    std::mutex slicesMutex_;            // thread works on its state unlocked
+    std::mutex fileMutex_;
+    std::size_t writtenFrames_ = 0;
+    std::uint64_t rawBytes_ = 0;
+    std::uint64_t fileBytes_ = 0;
+    bool closed_ = false;
+    bool failed_ = false;
+};
+
+// Random access to a snapshot file through a memory mapping: opening reads
+// only the index, and a frame decodes at most one chunk. The last decoded
+// chunk is kept, so scrubbing through time decodes each chunk once. Not
+// thread-safe; use one reader per thread.
+class SnapshotReader {
+public:
+    explicit SnapshotReader(const std::string& path);
+
+    bool isOpen() const { return open_; }
+    double getQuantum() const { return quantum_; }
+
+    // Slice ids present in the file, ascending
+    std::vector<int> getSlices() const;
+    bool hasSlice(int slice) const;
+
+    std::size_t getNodeCount(int slice) const;
+    const std::vector<double>& getGrid(int slice) const; // Empty if not stored
+    std::size_t getFrameCount(int slice) const;
+    double getFrameTime(int slice, std::size_t frame) const;
+
+    // Last frame at or before time (the first frame if time is earlier)
+    std::size_t findFrame(int slice, double time) const;
+
+    // One field; false for an unknown slice or frame, or a corrupt chunk
+    bool read(int slice, std::size_t frame, TemperatureDistribution& field) const;
+
+private:
+    struct Chunk {
+        std::uint64_t offset;
+        std::uint64_t bytes;
+        std::size_t firstFrame;
+        std::size_t frames;
+    };
+    struct SliceIndex {
+        std::size_t nodes = 0;
+        std::vector<double> grid;
+        std::vector<double> times;
+        std::vector<Chunk> chunks;
+    };
+
+    const SliceIndex* find(int slice) const;
+    bool parseIndex();
+
+    std::unique_ptr<MappedFile> file_;
+    std::map<int, SliceIndex> slices_;
+    double quantum_ = 0.0;
+    bool open_ = false;
+
+    // Decoded chunk cache
+    mutable int cachedSlice_ = -1;
+    mutable std::size_t cachedChunk_ = 0;
+    mutable std::vector<double> cachedValues_;
+};
+
+#endif // SNAPSHOT_STORE_H
@@ -0,0 +1,38 @@
+#ifndef STACK_ASSIGNMENT_H
+#define STACK_ASSIGNMENT_H
+
+#include <vector>
+#include "MaterialProperties.h"
+#include "MeshGroups.h"
+#include "MeshHandler.h"
+#include "SliceIndex.h"
+
+// Material stacks of a grouped mesh. A triangle takes the stack whose
+// "groups" list holds its MeshX group (MeshGroups::triangleGroups), and a
+// slice (SliceIndex band) the stack covering most of its surface area, so
+// the 1D slice runs use the materials of the part they cut through.
+class StackAssignment {
+public:
+    // Assign the triangles of mesh, in parallel (numThreads <= 0: all cores).
+    // Throws std::runtime_error if a stack names a group the metadata lacks
+    // or two stacks claim the same group.
+    void build(const MeshHandler& mesh, const MeshGroups& groups, const std::vector<Stack>& stacks,
+               const SliceIndex& index, int numThreads = 0);
+
+    // Stack id of every triangle, 0 if its group has no stack or it has no group
+    const std::vector<int>& getTriangleStacks() const { return triangleStacks_; }
+
+    // Stack id of a slice, 0 if none of its surface has a stack; ties go to
+    // the stack listed first
+    int getSliceStack(int slice) const { return sliceStacks_[slice]; }
+
+    // Share of the slice's surface area on its stack (0 to 1)
+    double getSliceCoverage(int slice) const { return sliceCoverage_[slice]; }
+
+private:
+    std::vector<int> triangleStacks_;
+    std::vector<int> sliceStacks_;
+    std::vector<double> sliceCoverage_;
+};
+
+#endif // STACK_ASSIGNMENT_H
@@ -0,0 +1,102 @@
+#ifndef STEP_OBSERVER_H
+#define STEP_OBSERVER_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+// Why BasicHeatEquationSolver::run() returned
+enum class StopReason {
+    Finished,       // Reached the total time
+    SteadyState,    // The solver's own steady-state tolerance was met
+    Observer        // An observer stopped the run
+};
+
+struct RunResult {
+    StopReason reason = StopReason::Finished;
+    double time = 0.0;      // Solver time when the run stopped
+    long long steps = 0;    // Steps taken by this run() call
+    int observer = -1;      // Index of the observer that stopped it (StopReason::Observer)
+    std::string detail;     // That observer's describeStop()
+};
+
+// Watches a time-marching run. onStep() is called after every accepted step
+// with the solver time, the step size and the new temperatures; returning
+// false stops the run after that step.
+template <typename Real>
+class BasicStepObserver {
+public:
+    virtual ~BasicStepObserver() {}
+    virtual bool onStep(double time, double dt, const std::vector<Real>& temperature) = 0;
+
+    // Why the observer stopped the run, for RunResult::detail
+    virtual std::string describeStop() const { return std::string(); }
+};
+
+// Stops the run once a watched node reaches its limit (T >= limit, so a run
+// it stops fails a T < limit check). Where temperatures only rise, e.g. a
+// BTCS run heated from a uniform start by a constant surface, the final
+// temperature fails the same check.
+template <typename Real>
+class LimitMonitor : public BasicStepObserver<Real> {
+public:
+    void addLimit(const std::string& name, int node, double limit);
+
+    bool onStep(double time, double dt, const std::vector<Real>& temperature) override;
+    std::string describeStop() const override;
+
+    // Index (addLimit order) of the limit that was reached, -1 = none
+    int exceededLimit() const { return exceeded_; }
+
+private:
+    struct Limit {
+        std::string name;
+        int node;
+        double limit;
+    };
+    std::vector<Limit> limits_;
+    int exceeded_ = -1;
+    double exceededTime_ = 0.0;
+    double exceededTemp_ = 0.0;
+};
+
+// Stops the run once max|ΔT|/dt between two steps drops below rate (K/s)
+template <typename Real>
+class SteadyStateMonitor : public BasicStepObserver<Real> {
+public:
+    explicit SteadyStateMonitor(double rate) : rate_(rate) {}
+
+    bool onStep(double time, double dt, const std::vector<Real>& temperature) override;
+    std::string describeStop() const override;
+
+private:
+    double rate_;
+    double lastRate_ = 0.0;
+    std::vector<Real> previous_;
+};
+
+// Calls a function after every step, e.g. a history sink; the function
+// returns false to stop
+template <typename Real>
+class CallbackObserver : public BasicStepObserver<Real> {
+public:
+    using Callback = std::function<bool(double time, const std::vector<Real>& temperature)>;
+    explicit CallbackObserver(Callback callback) : callback_(std::move(callback)) {}
+
+    bool onStep(double time, double dt, const std::vector<Real>& temperature) override;
+
+private:
+    Callback callback_;
+};
+
+extern template class LimitMonitor<float>;
+extern template class LimitMonitor<double>;
+extern template class SteadyStateMonitor<float>;
+extern template class SteadyStateMonitor<double>;
+extern template class CallbackObserver<float>;
+extern template class CallbackObserver<double>;
+
+// Observer of the double precision solver
+using StepObserver = BasicStepObserver<double>;
+
+#endif // STEP_OBSERVER_H
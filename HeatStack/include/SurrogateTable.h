@@ -0,0 +1,105 @@
+#ifndef SURROGATE_TABLE_H
+#define SURROGATE_TABLE_H
+
+#include <string>
+#include <vector>
+#include "MaterialProperties.h"
+#include "SimulationCache.h"
+#include "SimulationJob.h"
+
+// Axes and solver settings of a surrogate table
+struct SurrogateSpec {
+    double minTPS = 0.0001;         // TPS thickness axis, log-spaced (m)
+    double maxTPS = 0.5;
+    int    tpsPoints = 48;
+    int    lLPointsPerSegment = 17; // l/L nodes between profile breakpoints (ends included)
+    double maxDuration = 300.0;     // Duration axis [0, maxDuration] (s), nodes ~ k^2 (diffusion ~ sqrt(t))
+    int    durationPoints = 31;
+    double dt = 0.5;                // Fixed step of the tabulated runs
+    double theta = 1.0;
+    int    pointsPerLayer = 10;     // Uniform grid
+    int    validationSamples = 64;  // Random real solves for the error estimate
+};
+
+// Final interface temperatures tabulated over (TPS thickness, l/L, duration)
+// for one layer stack whose carbon, glue and steel thicknesses and surface
+// temperature follow the MaterialProperties l/L profiles, as the CLI builds
+// its slices. Queries interpolate trilinearly (log thickness, sqrt duration)
+// in float data, so a suggestion costs microseconds; TemperatureComparator
+// confirms it with one real solve. The l/L axis is split at the profile
+// breakpoints, with a node on each side of every jump, so no cell straddles
+// a discontinuity. Files are native byte order, like .meshbin caches.
+class SurrogateTable {
+public:
+    SurrogateTable();
+
+    // One transient per (thickness, l/L) node, run to maxDuration and sampled
+    // at every duration node (bit-identical to separate runs of that length),
+    // then validationSamples off-node solves for the error estimate. The
+    // layout supplies the materials; its thicknesses are replaced.
+    static SurrogateTable build(const SurrogateSpec& spec, const Stack& layout,
+                                const MaterialProperties& props, int numThreads = 0,
+                                const CancellationToken* cancel = nullptr);
+
+    bool save(const std::string& path) const;
+    bool load(const std::string& path);  // False (table unchanged) on a bad file
+    bool empty() const { return values_.empty(); }
+
+    const SurrogateSpec& getSpec() const { return spec_; }
+
+    // Largest and RMS interface error of the validation solves (K); the
+    // suggestion keeps getMaxError() below every limit
+    double getMaxError() const { return maxError_; }
+    double getRmsError() const { return rmsError_; }
+
+    // Whether this table was built for the stack's materials and l/L profile
+    // and for these solver settings (fixed dt, uniform grid)
+    bool matches(const Stack& stack, double l_over_L, const MaterialProperties& props,
+                 double dt, bool adaptive, double theta, int pointsPerLayer,
+                 const GridOptions& grid) const;
+
+    // Interpolated interface temperatures of the stack (layer 0 is the TPS),
+    // read at the grid nodes the TPS search would read; false outside the table
+    bool interpolate(const Stack& stack, double l_over_L, double duration,
+                     InterfaceTemperatures& temps) const;
+
+    // Smallest TPS thickness for the stack whose interpolated temperatures
+    // stay getMaxError() below the limits; false if the table has none
+    bool suggestThickness(const Stack& stack, double l_over_L, double duration,
+                          double maxSteelTemp, double maxGlueTemp, double maxCarbonTemp,
+                          double& thickness) const;
+
+private:
+    SurrogateSpec spec_;
+    std::vector<Material> materials_;   // Layer materials the table was built for
+    std::vector<double> edges_;         // l/L segment edges: 0, breakpoints, 1
+    std::vector<float> values_;         // [((tps * lL + l) * duration + d) * 5 + slot]
+    double maxError_;
+    double rmsError_;
+
+    int lLCount() const;
+    double tpsAt(int i) const;
+    double lLAt(int j) const;           // Nudged inside the segment at its ends
+    double durationAt(int k) const;
+
+    // Thickness and duration positions in node units, the l/L cell (lower
+    // node j, fraction fv); false outside the table
+    bool locate(double thickness, double l_over_L, double duration,
+                double& u, int& j, double& fv, double& w) const;
+
+    // Bilinear (l/L, duration) value of one slot at thickness node i; slots
+    // are the carbon/glue node and the next, glue/steel node and the next,
+    // and the steel surface
+    double planeValue(int i, int j, double fv, double w, int slot) const;
+
+    // Carbon/glue, glue/steel and steel values at thickness node i, taking
+    // the slots the grid of (tps, carbon, glue) reads
+    void nodeTemperatures(int i, int j, double fv, double w, double tps,
+                          double carbon, double glue, double out[3]) const;
+
+    // Stack at (thickness, l/L) on the table's grid
+    Stack stackAt(const Stack& layout, const MaterialProperties& props,
+                  double thickness, double l_over_L) const;
+};
+
+#endif // SURROGATE_TABLE_H
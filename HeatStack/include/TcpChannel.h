@@ -0,0 +1,55 @@
+#ifndef TCP_CHANNEL_H
+#define TCP_CHANNEL_H
+
+#include <memory>
+#include <string>
+
+// One end of a TCP connection carrying newline-terminated messages, the
+// transport between a --workers coordinator and its --worker processes.
+// Blocking; one reader and one writer at a time.
+class TcpChannel {
+public:
+    // Connect to host:port; throws std::runtime_error on failure
+    static std::unique_ptr<TcpChannel> connect(const std::string& host, int port);
+
+    ~TcpChannel();
+    TcpChannel(const TcpChannel&) = delete;
+    TcpChannel& operator=(const TcpChannel&) = delete;
+
+    // Next line without its newline; false once the peer has closed
+    bool readLine(std::string& line);
+
+    // Send line plus a newline; false if the connection is gone
+    bool writeLine(const std::string& line);
+
+private:
+    friend class TcpListener;
+    explicit TcpChannel(long long socket);
+
+    long long socket_;      // SOCKET on Windows, file descriptor elsewhere
+    std::string buffer_;    // Received bytes not yet returned by readLine
+};
+
+// Listening socket of a --worker; accepts coordinators one after another
+class TcpListener {
+public:
+    // Listen on bindAddress (a host name or IP; "0.0.0.0" = all IPv4
+    // interfaces). The protocol has no authentication, so the default is
+    // loopback only. Throws std::runtime_error if the port is taken.
+    explicit TcpListener(int port, const std::string& bindAddress = "127.0.0.1");
+    ~TcpListener();
+    TcpListener(const TcpListener&) = delete;
+    TcpListener& operator=(const TcpListener&) = delete;
+
+    // Block until a coordinator connects; throws std::runtime_error on failure
+    std::unique_ptr<TcpChannel> accept();
+
+    // Bound port (useful with port 0 = any free port)
+    int getPort() const { return port_; }
+
+private:
+    long long socket_;
+    int port_;
+};
+
+#endif // TCP_CHANNEL_H
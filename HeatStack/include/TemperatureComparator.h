@@ -1,8 +1,37 @@
 #ifndef TEMPERATURE_COMPARATOR_H
 #define TEMPERATURE_COMPARATOR_H
 
+#include <functional>
 #include <vector>
 #include "MaterialProperties.h"
+#include "SimulationCache.h"
+#include "SimulationJob.h"
+
+class BoundaryCondition;
+class BoundaryProfile;
+class SurrogateTable;
+
+// Scalar type of the TPS search's trial runs
+enum class SearchPrecision {
+    Double,     // Every trial in double (reference)
+    Float,      // Every trial in float, for screening runs
+    Mixed       // Float for the wide rounds, double for the final bracket
+};
+
+// Root finder of the TPS search
+enum class SearchMethod {
+    Bisection,  // Bisection or k-section (setSearchWays), the reference
+    Newton      // Safeguarded Newton on the tangent-linear slope, secant without one
+};
+
+// Bracket of a TPS search in progress, for checkpoints
+struct SearchProgress {
+    int rounds = 0;             // Completed rounds, 0 = not started
+    double minThickness = 0.0;  // Failing end
+    double maxThickness = 0.0;  // Passing end
+    double thickness = 0.0;     // Bisection: last midpoint; Newton: next trial
+    double lastStep = 0.0;      // Newton: size of the last log-thickness step
+};
 
 // Class for comparing temperature distributions to suggest TPS thickness
 class TemperatureComparator {
@@ -14,6 +43,69 @@ public:
     void setTimeStep(double dt, bool adaptive);
     void setGridResolution(int pointsPerLayer);
 
+    // Step control of the trial runs, as set on the verification runs
+    // (HeatEquationSolver and TimeHandler setters of the same names)
+    void setAdaptiveTolerance(double tolerance);
+    void setTimeStepLimits(double minTimeStep, double maxTimeStep);
+    void setSteadyStateTolerance(double rate);
+
+    // Number of sub-intervals per search round. 2 (default) is the serial
+    // bisection reference; k > 2 evaluates the k-1 interior candidates of each
+    // round concurrently, reaching the bisection bracket in log_k(2) as many rounds.
+    void setSearchWays(int ways);
+
+    // Worker threads for the parallel search (0 = hardware_concurrency)
+    void setSearchThreads(int numThreads);
+
+    // Newton keeps a bracket like bisection and ends at the same tolerance,
+    // but steps to the root of the largest limit excess using
+    // d(T)/d(thickness) from the tangent-linear run (fixed dt, uniform grid;
+    // secant steps otherwise), falling back to bisection when a step leaves
+    // the bracket or stalls. Returns the passing end of the bracket.
+    void setSearchMethod(SearchMethod method);
+
+    // Share a result cache between searches (nullptr disables caching).
+    // The cache is not owned and must outlive the comparator.
+    void setCache(SimulationCache* cache);
+
+    // Precision of the trial runs. In Mixed mode rounds whose bracket is wider
+    // than getMixedRefineWidth() run in float, and a float trial that lands
+    // within getMixedGuard() K of a limit is repeated in double, so the search
+    // takes the same decisions as Double while float is accurate to the guard.
+    void setPrecision(SearchPrecision precision);
+
+    static double getMixedRefineWidth() { return 1e-3; } // m
+    static double getMixedGuard() { return 0.5; }        // K
+
+    // Grid of the trial runs (uniform with setGridResolution() by default)
+    void setGridOptions(const GridOptions& options);
+
+    // Ask a precomputed table first: when it was built for the stack and
+    // these settings, its suggestion is returned once one real solve confirms
+    // it, otherwise the search runs as usual. Not owned (nullptr disables).
+    void setSurrogate(const SurrogateTable* table);
+    bool lastSuggestionFromSurrogate() const { return surrogateHit; }
+
+    // Outer surface of the trial runs from a T(time, l/L) table instead of
+    // the exhaust law. Cache keys and surrogate tables only describe the
+    // law, so both are bypassed while a profile is set. Not owned.
+    void setSurfaceProfile(const BoundaryProfile* profile);
+
+    // Stop a bisection or k-section trial as soon as an interface reaches
+    // its limit (on by default). Only used where temperatures cannot fall
+    // again, so verdicts match full runs: θ = 1, a constant surface at or
+    // above the 300 K start. Stopped trials are not cached.
+    void setEarlyStop(bool enabled);
+
+    // Abort searches when the token is cancelled: trial runs poll it between
+    // steps and throw JobCancelled (nothing partial is cached). Not owned.
+    void setCancellationToken(const CancellationToken* token);
+
+    // Resume and record the search: a progress with rounds > 0 is where the
+    // (same) search continues, and it is updated after every round, then
+    // onRound is called (e.g. to checkpoint it). Not owned; nullptr disables.
+    void setSearchProgress(SearchProgress* progress, std::function<void()> onRound = nullptr);
+
     // Run simulation for a given TPS thickness
     std::vector<double> runSimulation(Stack stack, double duration, double theta = 0.5, double l_over_L = 0.0);
 
@@ -24,6 +116,8 @@ public:
     //   - steel/glue ≤ maxSteelTemp
     //   - glue/carbon ≤ maxGlueTemp
     //   - carbon/external ≤ maxCarbonTemp
+    // Every search method returns the passing end of its final bracket, so
+    // the result meets the limits (unless even the maximum thickness fails).
     double suggestTPSThickness(const Stack& stack,
                                    double maxSteelTemp,
                                    double maxGlueTemp,
@@ -34,9 +128,84 @@ public:
                                    double theta = 0.5);
 
 private:
+    // Serial bisection, the reference search
+    double bisectTPSThickness(const Stack& stack, double maxSteelTemp, double maxGlueTemp,
+                              double maxCarbonTemp, double duration, double l_over_L,
+                              const MaterialProperties& props, double theta);
+
+    // k-section search, candidates of one round solved in parallel
+    double ksectTPSThickness(const Stack& stack, double maxSteelTemp, double maxGlueTemp,
+                             double maxCarbonTemp, double duration, double l_over_L,
+                             const MaterialProperties& props, double theta);
+
+    // Safeguarded Newton/secant search (SearchMethod::Newton)
+    double newtonTPSThickness(const Stack& stack, double maxSteelTemp, double maxGlueTemp,
+                              double maxCarbonTemp, double duration, double l_over_L,
+                              const MaterialProperties& props, double theta);
+
+    // Bracket and position of a resumed search; false for a fresh one
+    bool resumeSearch(double& minThickness, double& maxThickness, double& thickness,
+                      double& lastStep) const;
+
+    // Update the progress after a round and notify
+    void recordRound(double minThickness, double maxThickness, double thickness, double lastStep);
+
+    // Surface (Dirichlet) temperature used by runSimulation
+    double surfaceTemperature(double l_over_L) const;
+
+    // Outer condition of a trial run: Dirichlet at surfaceTemperature, or
+    // from surfaceProfile when one is set
+    BoundaryCondition* surfaceCondition(double l_over_L) const;
+
+    // Run the transient for one TPS thickness and check all interface limits;
+    // bracketWidth is the width of the search round (decides Mixed precision)
+    bool meetsLimits(const Stack& stack, double thickness, double maxSteelTemp,
+                     double maxGlueTemp, double maxCarbonTemp, double duration,
+                     double l_over_L, double theta, double bracketWidth);
+
+    // Final interface temperatures for one TPS thickness, through the cache.
+    // With stopAt, a run where early stopping is safe ends once an interface
+    // reaches its stopAt value; *stopped then tells, and the temperatures
+    // are those at the stop.
+    InterfaceTemperatures trialTemperatures(const Stack& stack, double thickness, double duration,
+                                            double l_over_L, double theta, bool singlePrecision,
+                                            const InterfaceTemperatures* stopAt = nullptr,
+                                            bool* stopped = nullptr);
+
+    // Whether interface temperatures only rise during a trial run
+    bool canStopEarly(double theta, double l_over_L) const;
+
+    // trialTemperatures plus d(T)/d(thickness) at the interfaces; false (no
+    // slopes) for cache hits and runs without a tangent-linear solve
+    bool trialSlopes(const Stack& stack, double thickness, double duration, double l_over_L,
+                     double theta, InterfaceTemperatures& temps, InterfaceTemperatures& slopes);
+
+    // runSimulation in the given scalar type; sensitivity, if given, receives
+    // d(T)/d(TPS thickness) from the tangent-linear run. stopAt/stopped as
+    // in trialTemperatures (the caller decides whether stopping is safe).
+    template <typename Real>
+    std::vector<double> runSimulationAs(const Stack& stack, double duration, double theta, double l_over_L,
+                                        std::vector<double>* sensitivity = nullptr,
+                                        const InterfaceTemperatures* stopAt = nullptr,
+                                        bool* stopped = nullptr);
+
     double compDt    = 1.0;
     bool   compAdapt = false;
     int compPoints = 10;
+    StepOptions stepOptions;
+    int searchWays = 2;
+    int searchThreads = 0;
+    SearchMethod method = SearchMethod::Bisection;
+    SearchPrecision precision = SearchPrecision::Double;
+    GridOptions gridOptions;
+    SimulationCache* cache = nullptr;
+    const CancellationToken* cancelToken = nullptr;
+    const SurrogateTable* surrogate = nullptr;
+    const BoundaryProfile* surfaceProfile = nullptr;
+    bool earlyStop = true;
+    bool surrogateHit = false;
+    SearchProgress* progress = nullptr;
+    std::function<void()> onRound;
 };
 
 #endif // TEMPERATURE_COMPARATOR_H
\ No newline at end of file
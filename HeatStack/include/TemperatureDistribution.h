@@ -4,28 +4,35 @@
 #include <vector>
 #include <string>
 
-// A memory-efficient container for temperature distributions.
-class TemperatureDistribution {
+// A memory-efficient container for temperature distributions, in the scalar
+// type of the solver that produced them (instantiated for float and double).
+template <typename Real>
+class BasicTemperatureDistribution {
 public:
-    TemperatureDistribution();
-    ~TemperatureDistribution();
+    BasicTemperatureDistribution();
+    ~BasicTemperatureDistribution();
 
     // Initialize the distribution with a given size and default value.
-    void initialize(int size, double defaultValue = 0.0);
+    void initialize(int size, Real defaultValue = Real(0));
 
     // Access the underlying data (modifiable).
-    std::vector<double>& data();
+    std::vector<Real>& data();
 
     // Access the underlying data (read-only).
-    const std::vector<double>& data() const;
-    void update(const std::vector<double>& newTemperatures);
-    double getTemperatureAt(int index) const;
-    std::vector<double> getTemperatureRange(int start, int end) const;
+    const std::vector<Real>& data() const;
+    void update(const std::vector<Real>& newTemperatures);
+    Real getTemperatureAt(int index) const;
+    std::vector<Real> getTemperatureRange(int start, int end) const;
     void exportToFile(const std::string& filename) const;
 
 private:
     // Using std::vector here; can later be replaced with a custom container if needed.
-    std::vector<double> temperatures;
+    std::vector<Real> temperatures;
 };
 
+extern template class BasicTemperatureDistribution<float>;
+extern template class BasicTemperatureDistribution<double>;
+
+using TemperatureDistribution = BasicTemperatureDistribution<double>;
+
 #endif // TEMPERATURE_DISTRIBUTION_H
\ No newline at end of file
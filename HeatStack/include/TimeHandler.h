@@ -1,5 +1,7 @@
 #pragma once
 
+#include <iosfwd>
+
 class TimeHandler {
 public:
     TimeHandler(double totalTime, double initialTimeStep, bool adaptive = false);
@@ -7,23 +9,46 @@ public:
     // Advance the simulation time
     void advance();
 
+    // Advance by an explicit step (adaptive steps may be shorter than dt)
+    void advance(double stepDt);
+
     // Accessors
     double getCurrentTime() const;
     double getTimeStep() const;
     double getTotalTime() const;
     int getStepCount() const;
 
-    // Adaptive timestep control (stub for now)
-    void adjustTimeStep(double newTimeStep); // Can be used by solver based on stability
+    // Adaptive timestep control
+    void adjustTimeStep(double newTimeStep); // Clamped to [minDt, maxDt]; ignored unless adaptive
     bool isAdaptive() const;
 
+    // Bounds for adaptive dt (defaults: initialTimeStep/1000 and totalTime)
+    void setTimeStepLimits(double minTimeStep, double maxTimeStep);
+    double getMinTimeStep() const;
+    double getMaxTimeStep() const;
+
+    // PI step-size controller. Given a step of size stepDt with error estimate
+    // error, return the next dt aimed at tolerance. order is the order of the
+    // error estimate (error ~ dt^(order+1)); accepted feeds the P part with the
+    // previous accepted error, a rejected step uses the I part only.
+    double proposeTimeStep(double stepDt, double error, double tolerance, int order, bool accepted);
+
     // Check if simulation is complete
     bool isFinished() const;
 
+    // Binary state for checkpoints. load() keeps this handler's total time,
+    // so a run can continue past the end of the one that was saved; false
+    // (handler unchanged) on a short read.
+    void save(std::ostream& out) const;
+    bool load(std::istream& in);
+
 private:
     double totalTime;
     double dt;
     double currentTime;
     bool adaptive;
     int stepCount;
+    double minDt;
+    double maxDt;
+    double prevError; // Error of the last accepted step, for the PI controller
 };
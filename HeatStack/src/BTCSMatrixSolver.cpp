@@ -1,32 +1,39 @@
 #include "BTCSMatrixSolver.h"
+#include "Profiler.h"
 #include <stdexcept>
 
-BTCSMatrixSolver::BTCSMatrixSolver() : matrixSize(0) {}
+template <typename Real>
+BasicBTCSMatrixSolver<Real>::BasicBTCSMatrixSolver() : matrixSize(0), batchSize(0), batchSystems(0) {}
 
-BTCSMatrixSolver::~BTCSMatrixSolver() {}
+template <typename Real>
+BasicBTCSMatrixSolver<Real>::~BasicBTCSMatrixSolver() {}
 
-void BTCSMatrixSolver::setupMatrix(int size) {
+template <typename Real>
+void BasicBTCSMatrixSolver<Real>::setupMatrix(int size) {
     matrixSize = size;
     a_.resize(size - 1, 0.0); // Sub-diagonal
     b_.resize(size, 0.0);     // Main diagonal
     c_.resize(size - 1, 0.0); // Super-diagonal
+    cPrime_.resize(size - 1, 0.0);
 }
 
-std::vector<double> BTCSMatrixSolver::solve(const std::vector<double>& b) {
+template <typename Real>
+std::vector<Real> BasicBTCSMatrixSolver<Real>::solve(const std::vector<Real>& b) {
     if (b.size() != static_cast<size_t>(matrixSize)) {
         throw std::runtime_error("Size mismatch in BTCSMatrixSolver::solve");
     }
+    Profiler::count(ProfileCounter::MatrixSolves);
 
     // Thomas algorithm for tridiagonal matrix
-    std::vector<double> c_prime(matrixSize - 1, 0.0);
-    std::vector<double> d_prime(matrixSize, 0.0);
-    std::vector<double> x(matrixSize, 0.0);
+    std::vector<Real> c_prime(matrixSize - 1, 0.0);
+    std::vector<Real> d_prime(matrixSize, 0.0);
+    std::vector<Real> x(matrixSize, 0.0);
 
     // Forward elimination
     c_prime[0] = c_[0] / b_[0];
     d_prime[0] = b[0] / b_[0];
     for (int i = 1; i < matrixSize - 1; ++i) {
-        double denom = b_[i] - a_[i - 1] * c_prime[i - 1];
+        Real denom = b_[i] - a_[i - 1] * c_prime[i - 1];
         c_prime[i] = c_[i] / denom;
         d_prime[i] = (b[i] - a_[i - 1] * d_prime[i - 1]) / denom;
     }
@@ -40,4 +47,213 @@ std::vector<double> BTCSMatrixSolver::solve(const std::vector<double>& b) {
     }
 
     return x;
-}
\ No newline at end of file
+}
+
+template <typename Real>
+void BasicBTCSMatrixSolver<Real>::solveInPlace(std::vector<Real>& rhs) {
+    if (rhs.size() != static_cast<size_t>(matrixSize)) {
+        throw std::runtime_error("Size mismatch in BTCSMatrixSolver::solveInPlace");
+    }
+    Profiler::count(ProfileCounter::MatrixSolves);
+
+    const int n = matrixSize;
+    Real* d = rhs.data(); // d' during elimination, x after back substitution
+
+    // Forward elimination (same operation order as solve())
+    cPrime_[0] = c_[0] / b_[0];
+    d[0] = d[0] / b_[0];
+    for (int i = 1; i < n - 1; ++i) {
+        Real denom = b_[i] - a_[i - 1] * cPrime_[i - 1];
+        cPrime_[i] = c_[i] / denom;
+        d[i] = (d[i] - a_[i - 1] * d[i - 1]) / denom;
+    }
+    d[n - 1] = (d[n - 1] - a_[n - 2] * d[n - 2]) /
+               (b_[n - 1] - a_[n - 2] * cPrime_[n - 2]);
+
+    // Back substitution
+    for (int i = n - 2; i >= 0; --i) {
+        d[i] = d[i] - cPrime_[i] * d[i + 1];
+    }
+}
+
+template <typename Real>
+void BasicBTCSMatrixSolver<Real>::factorize() {
+    const int n = matrixSize;
+    factorCPrime_.resize(n - 1);
+    factorDenom_.resize(n);
+
+    factorDenom_[0] = b_[0];
+    factorCPrime_[0] = c_[0] / b_[0];
+    for (int i = 1; i < n - 1; ++i) {
+        factorDenom_[i] = b_[i] - a_[i - 1] * factorCPrime_[i - 1];
+        factorCPrime_[i] = c_[i] / factorDenom_[i];
+    }
+    factorDenom_[n - 1] = b_[n - 1] - a_[n - 2] * factorCPrime_[n - 2];
+}
+
+template <typename Real>
+void BasicBTCSMatrixSolver<Real>::solveFactored(std::vector<Real>& rhs) const {
+    if (rhs.size() != static_cast<size_t>(matrixSize) ||
+        factorDenom_.size() != static_cast<size_t>(matrixSize)) {
+        throw std::runtime_error("Size mismatch in BTCSMatrixSolver::solveFactored");
+    }
+    Profiler::count(ProfileCounter::MatrixSolves);
+
+    const int n = matrixSize;
+    Real* d = rhs.data();
+
+    // Forward substitution
+    d[0] = d[0] / factorDenom_[0];
+    for (int i = 1; i < n; ++i) {
+        d[i] = (d[i] - a_[i - 1] * d[i - 1]) / factorDenom_[i];
+    }
+
+    // Back substitution
+    for (int i = n - 2; i >= 0; --i) {
+        d[i] = d[i] - factorCPrime_[i] * d[i + 1];
+    }
+}
+
+template <typename Real>
+void BasicBTCSMatrixSolver<Real>::setupBatch(int size, int nSystems) {
+    if (size < 2 || nSystems < 1) {
+        throw std::runtime_error("Invalid batch dimensions in BTCSMatrixSolver::setupBatch");
+    }
+    batchSize = size;
+    batchSystems = nSystems;
+    batchA_.assign(static_cast<size_t>(size - 1) * nSystems, 0.0);
+    batchB_.assign(static_cast<size_t>(size) * nSystems, 0.0);
+    batchC_.assign(static_cast<size_t>(size - 1) * nSystems, 0.0);
+    batchCPrime_.assign(static_cast<size_t>(size - 1) * nSystems, 0.0);
+}
+
+template <typename Real>
+void BasicBTCSMatrixSolver<Real>::solveBatch(std::vector<Real>& rhs) {
+    const int n = batchSize;
+    const int m = batchSystems;
+    if (rhs.size() != static_cast<size_t>(n) * m) {
+        throw std::runtime_error("Size mismatch in BTCSMatrixSolver::solveBatch");
+    }
+    Profiler::count(ProfileCounter::MatrixSolves, static_cast<unsigned long long>(m));
+
+    const Real* a = batchA_.data();
+    const Real* b = batchB_.data();
+    const Real* c = batchC_.data();
+    Real* cp = batchCPrime_.data();
+    Real* d = rhs.data();
+
+    // Forward elimination, row by row; every inner loop runs over the systems.
+    // Same operation order as solve(), so each system matches it bit for bit.
+    for (int s = 0; s < m; ++s) {
+        cp[s] = c[s] / b[s];
+        d[s]  = d[s] / b[s];
+    }
+    for (int i = 1; i < n; ++i) {
+        const Real* ai  = a + (i - 1) * m;
+        const Real* bi  = b + i * m;
+        const Real* cpl = cp + (i - 1) * m;
+        const Real* dl  = d + (i - 1) * m;
+        Real* di = d + i * m;
+        if (i < n - 1) {
+            const Real* ci = c + i * m;
+            Real* cpi = cp + i * m;
+            for (int s = 0; s < m; ++s) {
+                Real denom = bi[s] - ai[s] * cpl[s];
+                cpi[s] = ci[s] / denom;
+                di[s]  = (di[s] - ai[s] * dl[s]) / denom;
+            }
+        } else {
+            for (int s = 0; s < m; ++s) {
+                di[s] = (di[s] - ai[s] * dl[s]) / (bi[s] - ai[s] * cpl[s]);
+            }
+        }
+    }
+
+    // Back substitution
+    for (int i = n - 2; i >= 0; --i) {
+        const Real* cpi = cp + i * m;
+        const Real* dn  = d + (i + 1) * m;
+        Real* di = d + i * m;
+        for (int s = 0; s < m; ++s) {
+            di[s] -= cpi[s] * dn[s];
+        }
+    }
+}
+
+template <typename Real>
+void BasicBTCSMatrixSolver<Real>::factorizeBatch() {
+    const int n = batchSize;
+    const int m = batchSystems;
+    batchFactorCPrime_.resize(static_cast<size_t>(n - 1) * m);
+    batchFactorDenom_.resize(static_cast<size_t>(n) * m);
+
+    const Real* a = batchA_.data();
+    const Real* b = batchB_.data();
+    const Real* c = batchC_.data();
+    Real* cp = batchFactorCPrime_.data();
+    Real* denom = batchFactorDenom_.data();
+
+    for (int s = 0; s < m; ++s) {
+        denom[s] = b[s];
+        cp[s] = c[s] / b[s];
+    }
+    for (int i = 1; i < n; ++i) {
+        const Real* ai  = a + (i - 1) * m;
+        const Real* bi  = b + i * m;
+        const Real* cpl = cp + (i - 1) * m;
+        Real* deni = denom + i * m;
+        for (int s = 0; s < m; ++s) {
+            deni[s] = bi[s] - ai[s] * cpl[s];
+        }
+        if (i < n - 1) {
+            const Real* ci = c + i * m;
+            Real* cpi = cp + i * m;
+            for (int s = 0; s < m; ++s) {
+                cpi[s] = ci[s] / deni[s];
+            }
+        }
+    }
+}
+
+template <typename Real>
+void BasicBTCSMatrixSolver<Real>::solveBatchFactored(std::vector<Real>& rhs) const {
+    const int n = batchSize;
+    const int m = batchSystems;
+    if (rhs.size() != static_cast<size_t>(n) * m ||
+        batchFactorDenom_.size() != static_cast<size_t>(n) * m) {
+        throw std::runtime_error("Size mismatch in BTCSMatrixSolver::solveBatchFactored");
+    }
+    Profiler::count(ProfileCounter::MatrixSolves, static_cast<unsigned long long>(m));
+
+    const Real* a = batchA_.data();
+    const Real* cp = batchFactorCPrime_.data();
+    const Real* denom = batchFactorDenom_.data();
+    Real* d = rhs.data();
+
+    // Forward substitution
+    for (int s = 0; s < m; ++s) {
+        d[s] = d[s] / denom[s];
+    }
+    for (int i = 1; i < n; ++i) {
+        const Real* ai   = a + (i - 1) * m;
+        const Real* deni = denom + i * m;
+        const Real* dl   = d + (i - 1) * m;
+        Real* di = d + i * m;
+        for (int s = 0; s < m; ++s) {
+            di[s] = (di[s] - ai[s] * dl[s]) / deni[s];
+        }
+    }
+
+    // Back substitution
+    for (int i = n - 2; i >= 0; --i) {
+        const Real* cpi = cp + i * m;
+        const Real* dn  = d + (i + 1) * m;
+        Real* di = d + i * m;
+        for (int s = 0; s < m; ++s) {
+            di[s] -= cpi[s] * dn[s];
+        }
+    }
+}
+
+template class BasicBTCSMatrixSolver<float>;
+template class BasicBTCSMatrixSolver<double>;
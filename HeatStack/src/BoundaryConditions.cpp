@@ -1,4 +1,9 @@
 #include "BoundaryConditions.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
 
 /////////////////////////////////////////
 // DirichletCondition: T = constant
@@ -30,3 +35,150 @@ float NeumannCondition::getValue(const std::array<float, 3>& position) const {
     return flux_;
 }
 
+
+/////////////////////////////////////////
+// BoundaryCondition: batched evaluation
+/////////////////////////////////////////
+void BoundaryCondition::evaluate(double /*time*/, const std::vector<std::array<float, 3>>& positions,
+                                 std::vector<float>& out) const {
+    out.resize(positions.size());
+    for (std::size_t i = 0; i < positions.size(); ++i) out[i] = getValue(positions[i]);
+}
+
+/////////////////////////////////////////
+// BoundaryProfile: T(time, l/L) lookup table
+/////////////////////////////////////////
+BoundaryProfile::BoundaryProfile() : tableSize_(0) {}
+
+BoundaryProfile::BoundaryProfile(const std::vector<double>& times, const std::vector<double>& lL,
+                                 const std::vector<double>& values, int tableSize)
+    : times_(times), tableSize_(std::max(tableSize, 2)) {
+    if (times.empty() || lL.empty() || values.size() != times.size() * lL.size()) {
+        throw std::runtime_error("Boundary profile: values do not match the time and l/L columns");
+    }
+    if (!std::is_sorted(times.begin(), times.end()) || !std::is_sorted(lL.begin(), lL.end())) {
+        throw std::runtime_error("Boundary profile: times and l/L must be ascending");
+    }
+
+    // Resample each time row onto the uniform l/L table
+    std::size_t columns = lL.size();
+    table_.resize(times.size() * tableSize_);
+    for (std::size_t k = 0; k < times.size(); ++k) {
+        const double* row = &values[k * columns];
+        std::size_t j = 0;
+        for (int m = 0; m < tableSize_; ++m) {
+            double x = double(m) / (tableSize_ - 1);
+            while (j + 1 < columns && lL[j + 1] <= x) ++j;
+            double v = row[j];
+            if (j + 1 < columns && x > lL[j]) {
+                v += (x - lL[j]) / (lL[j + 1] - lL[j]) * (row[j + 1] - row[j]);
+            }
+            table_[k * tableSize_ + m] = v;
+        }
+    }
+}
+
+BoundaryProfile BoundaryProfile::fromFunction(double (*law)(double), int tableSize) {
+    tableSize = std::max(tableSize, 2);
+    std::vector<double> lL(tableSize), values(tableSize);
+    for (int m = 0; m < tableSize; ++m) {
+        lL[m] = double(m) / (tableSize - 1);
+        values[m] = law(lL[m]);
+    }
+    return BoundaryProfile({ 0.0 }, lL, values, tableSize);
+}
+
+BoundaryProfile BoundaryProfile::loadCsv(const std::string& path, int tableSize) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("Cannot open boundary profile " + path);
+
+    auto parseRow = [&](const std::string& line, std::vector<double>& row) {
+        row.clear();
+        std::stringstream ss(line);
+        std::string cell;
+        while (std::getline(ss, cell, ',')) {
+            char* end = nullptr;
+            double v = std::strtod(cell.c_str(), &end);
+            if (end == cell.c_str()) return false;
+            row.push_back(v);
+        }
+        return true;
+    };
+
+    std::string line;
+    std::vector<double> header, row, times, values;
+    // Header: a label, then the l/L columns
+    if (!std::getline(in, line)) throw std::runtime_error("Empty boundary profile " + path);
+    auto comma = line.find(',');
+    if (comma == std::string::npos || !parseRow(line.substr(comma + 1), header) || header.empty()) {
+        throw std::runtime_error("Boundary profile " + path + ": bad header");
+    }
+    while (std::getline(in, line)) {
+        if (line.empty() || line == "\r") continue;
+        if (!parseRow(line, row) || row.size() != header.size() + 1) {
+            throw std::runtime_error("Boundary profile " + path + ": bad row " + std::to_string(times.size() + 2));
+        }
+        times.push_back(row[0]);
+        values.insert(values.end(), row.begin() + 1, row.end());
+    }
+    return BoundaryProfile(times, header, values, tableSize);
+}
+
+void BoundaryProfile::evaluate(double time, const double* lL, std::size_t count, double* out) const {
+    // Time interval once for the whole batch
+    std::size_t k = std::upper_bound(times_.begin(), times_.end(), time) - times_.begin();
+    std::size_t k0 = k == 0 ? 0 : k - 1;
+    std::size_t k1 = std::min(k, times_.size() - 1);
+    double w = (k1 == k0) ? 0.0 : (time - times_[k0]) / (times_[k1] - times_[k0]);
+    const double* a = &table_[k0 * tableSize_];
+    const double* b = &table_[k1 * tableSize_];
+
+    double scale = tableSize_ - 1;
+    for (std::size_t i = 0; i < count; ++i) {
+        double u = std::min(std::max(lL[i], 0.0), 1.0) * scale;
+        int m = std::min(static_cast<int>(u), tableSize_ - 2);
+        double f = u - m;
+        double va = a[m] + f * (a[m + 1] - a[m]);
+        double vb = b[m] + f * (b[m + 1] - b[m]);
+        out[i] = va + w * (vb - va);
+    }
+}
+
+double BoundaryProfile::valueAt(double time, double lL) const {
+    double value;
+    evaluate(time, &lL, 1, &value);
+    return value;
+}
+
+/////////////////////////////////////////
+// TabulatedCondition: T from a BoundaryProfile
+/////////////////////////////////////////
+TabulatedCondition::TabulatedCondition(const BoundaryProfile* profile, float zMin, float height)
+    : profile_(profile), zMin_(zMin), height_(height) {
+    if (!profile_ || profile_->empty()) throw std::runtime_error("Tabulated condition needs a profile");
+}
+
+TabulatedCondition::~TabulatedCondition() {}
+
+BoundaryType TabulatedCondition::getType() const {
+    return BoundaryType::Dirichlet;
+}
+
+float TabulatedCondition::getValue(const std::array<float, 3>& position) const {
+    return static_cast<float>(profile_->valueAt(0.0, (position[2] - zMin_) / height_));
+}
+
+void TabulatedCondition::evaluate(double time, const std::vector<std::array<float, 3>>& positions,
+                                  std::vector<float>& out) const {
+    std::size_t n = positions.size();
+    lL_.resize(n);
+    values_.resize(n);
+    for (std::size_t i = 0; i < n; ++i) lL_[i] = (positions[i][2] - zMin_) / height_;
+    profile_->evaluate(time, lL_.data(), n, values_.data());
+    out.resize(n);
+    for (std::size_t i = 0; i < n; ++i) out[i] = static_cast<float>(values_[i]);
+}
+
+bool TabulatedCondition::isTimeDependent() const {
+    return profile_->isTimeDependent();
+}
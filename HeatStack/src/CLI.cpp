@@ -41,6 +41,138 @@ void CLI::parseArguments(int argc, char* argv[]) {
         else if (std::strcmp(argv[i], "--theta") == 0 && i+1 < argc) {
             theta = std::atof(argv[++i]);
         }
+        else if (std::strcmp(argv[i], "--threads") == 0 && i+1 < argc) {
+            numThreads = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--search-ways") == 0 && i+1 < argc) {
+            searchWays = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--adapt-tol") == 0 && i+1 < argc) {
+            adaptiveTolerance = std::atof(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--dt-min") == 0 && i+1 < argc) {
+            minTimeStep = std::atof(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--dt-max") == 0 && i+1 < argc) {
+            maxTimeStep = std::atof(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--steady-tol") == 0 && i+1 < argc) {
+            steadyStateTol = std::atof(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--history-format") == 0 && i+1 < argc) {
+            std::string format = argv[++i];
+            if (format != "csv" && format != "bin") {
+                std::cerr << "Unknown history format: " << format << "\n";
+                helpRequested = true;
+                printUsage();
+                break;
+            }
+            binaryHistory = format == "bin";
+        }
+        else if (std::strcmp(argv[i], "--history-every") == 0 && i+1 < argc) {
+            historyEvery = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--history-delta") == 0 && i+1 < argc) {
+            historyDelta = std::atof(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--snapshots") == 0 && i+1 < argc) {
+            snapshotFile = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--snapshot-quantum") == 0 && i+1 < argc) {
+            snapshotQuantum = std::atof(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--snapshot-every") == 0 && i+1 < argc) {
+            snapshotEvery = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--checkpoint") == 0 && i+1 < argc) {
+            checkpointDir = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--checkpoint-every") == 0 && i+1 < argc) {
+            checkpointInterval = std::atof(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--resume") == 0 && i+1 < argc) {
+            checkpointDir = argv[++i];
+            resume = true;
+        }
+        else if (std::strcmp(argv[i], "--surface-profile") == 0 && i+1 < argc) {
+            surfaceProfileFile = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--groups") == 0 && i+1 < argc) {
+            groupsFile = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--stacks") == 0 && i+1 < argc) {
+            stacksFile = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--profile") == 0 && i+1 < argc) {
+            profileFile = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--cache") == 0) {
+            resultCache = true;
+        }
+        else if (std::strcmp(argv[i], "--cache-dir") == 0 && i+1 < argc) {
+            resultCache = true;
+            cacheDir = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--no-mesh-cache") == 0) {
+            meshCache = false;
+        }
+        else if (std::strcmp(argv[i], "--lateral") == 0) {
+            lateral = true;
+        }
+        else if (std::strcmp(argv[i], "--sweep") == 0 && i+1 < argc) {
+            sweepFile = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--precision") == 0 && i+1 < argc) {
+            precision = argv[++i];
+            if (precision != "double" && precision != "float" && precision != "mixed") {
+                std::cerr << "Unknown precision: " << precision << "\n";
+                helpRequested = true;
+                printUsage();
+                break;
+            }
+        }
+        else if (std::strcmp(argv[i], "--search-method") == 0 && i+1 < argc) {
+            searchMethod = argv[++i];
+            if (searchMethod != "bisect" && searchMethod != "newton") {
+                std::cerr << "Unknown search method: " << searchMethod << "\n";
+                helpRequested = true;
+                printUsage();
+                break;
+            }
+        }
+        else if (std::strcmp(argv[i], "--grid") == 0 && i+1 < argc) {
+            gridSpacing = argv[++i];
+            if (gridSpacing != "uniform" && gridSpacing != "clustered") {
+                std::cerr << "Unknown grid: " << gridSpacing << "\n";
+                helpRequested = true;
+                printUsage();
+                break;
+            }
+        }
+        else if (std::strcmp(argv[i], "--grid-fo") == 0 && i+1 < argc) {
+            gridFourier = std::atof(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--grid-stretch") == 0 && i+1 < argc) {
+            gridStretch = std::atof(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--surrogate") == 0 && i+1 < argc) {
+            surrogateFile = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--surrogate-build") == 0 && i+1 < argc) {
+            surrogateBuildFile = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--serve") == 0) {
+            serve = true;
+        }
+        else if (std::strcmp(argv[i], "--worker") == 0 && i+1 < argc) {
+            workerPort = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--worker-bind") == 0 && i+1 < argc) {
+            workerBind = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--workers") == 0 && i+1 < argc) {
+            workerList = argv[++i];
+        }
         else { //old flags
             std::cerr << "Unknown option: " << argv[i] << "\n";
             helpRequested = true;
@@ -57,7 +189,54 @@ void CLI::printUsage() const {
               << "  --time <duration>   Total simulation time (in seconds)\n"
               << "  --dt <timestep>     Fixed timestep size (ignored if --adaptive)\n"
               << "  --adaptive          Use adaptive time stepping\n"
+              << "  --adapt-tol <K>     Adaptive error target per step (default 0.01)\n"
+              << "  --dt-min <s>        Smallest adaptive timestep\n"
+              << "  --dt-max <s>        Largest adaptive timestep\n"
+              << "  --steady-tol <K/s>  Stop once max dT/dt falls below this rate\n"
               << "  --output <file>     Output file for temperature results\n"
+              << "  --grid <g>          uniform (default) or clustered: fine cells at interfaces\n"
+              << "                      and the surface, budget per layer from --grid-fo\n"
+              << "  --grid-fo <Fo>      Clustered: cell Fourier number alpha*dt/dx^2 at interfaces (1)\n"
+              << "  --grid-stretch <q>  Clustered: size ratio of neighbouring cells (1.2)\n"
+              << "  --threads <n>       Worker threads for slices (0 = all cores)\n"
+              << "  --search-ways <k>   Candidates per TPS search round (2 = bisection)\n"
+              << "  --search-method <m> TPS search: bisect (default) or newton (thickness\n"
+              << "                      sensitivity from the solver, uniform grid and fixed dt)\n"
+              << "  --precision <p>     TPS search trials in double (default), float or mixed\n"
+              << "                      (float on wide brackets, double near the answer)\n"
+              << "  --history-format <f> Time history as csv (default) or bin\n"
+              << "  --history-every <n> Keep every Nth time-history row\n"
+              << "  --history-delta <K> Also keep rows where a temperature moved more than K\n"
+              << "  --snapshots <file>  Store full temperature fields of the optimized runs\n"
+              << "  --snapshot-quantum <K> Snapshot rounding step, error <= K/2 (0.01; 0 = lossless)\n"
+              << "  --snapshot-every <n> Keep every Nth snapshot frame\n"
+              << "  --checkpoint <dir>  Checkpoint every slice's progress to <dir>\n"
+              << "  --checkpoint-every <s> Wall-clock seconds between checkpoints in a stage (60)\n"
+              << "  --resume <dir>      Continue from the checkpoints in <dir> (same settings)\n"
+              << "  --surface-profile <csv> Outer surface T(time, l/L) from a table (header\n"
+              << "                      time,<l/L>,...; one row per time) instead of the exhaust law\n"
+              << "  --groups <json>     Face groups of the mesh from a MeshX metadata export\n"
+              << "  --stacks <json>     Material stacks per group; each slice uses the stack\n"
+              << "                      covering most of its surface (needs --groups;\n"
+              << "                      local runs only, not --sweep, --serve or --workers)\n"
+              << "  --profile <file>    Record zones/counters, write a Chrome trace JSON\n"
+              << "  --cache             Reuse results of identical TPS trial runs\n"
+              << "  --cache-dir <dir>   Also persist cached results in <dir>\n"
+              << "  --no-mesh-cache     Do not read or write the <mesh>.meshbin cache\n"
+              << "  --lateral           Re-run the optimized stacks coupled along l/L (fixed dt),\n"
+              << "                      write lateral_summary.csv\n"
+              << "  --sweep <manifest>  Run a JSON parameter grid in one process, write one table\n"
+              << "  --surrogate <file>  Try a precomputed response table before each TPS search\n"
+              << "  --surrogate-build <file> Tabulate interface temperatures up to --time for\n"
+              << "                      --dt/--theta/--points, write the table and exit\n"
+              << "  --serve             Answer JSON requests (simulate, suggest) line by line on\n"
+              << "                      stdin/stdout, keeping meshes, results and threads warm\n"
+              << "  --worker <port>     Serve the same requests to --workers coordinators over TCP\n"
+              << "                      (z range and initial profile inline, no files, no shutdown)\n"
+              << "  --worker-bind <addr> Listen address of --worker (default 127.0.0.1; the port\n"
+              << "                      is unauthenticated, open it only on a trusted cluster network)\n"
+              << "  --workers <h:p,...> Run the slices on --worker processes (dynamic batches),\n"
+              << "                      write summary and stack details here; no mesh needed there\n"
               << "  --help              Print this help message\n";
 }
 
@@ -88,4 +267,39 @@ bool CLI::isHelpRequested() const {
 std::string CLI::getInitFile() const       { return initFile; }
 int         CLI::getNumSlices() const     { return numSlices; }
 int         CLI::getPointsPerLayer() const{ return pointsPerLayer; }
-double      CLI::getTheta() const         { return theta; }
\ No newline at end of file
+double      CLI::getTheta() const         { return theta; }
+int         CLI::getNumThreads() const    { return numThreads; }
+int         CLI::getSearchWays() const    { return searchWays; }
+bool        CLI::useResultCache() const   { return resultCache; }
+std::string CLI::getCacheDir() const      { return cacheDir; }
+double      CLI::getAdaptiveTolerance() const   { return adaptiveTolerance; }
+double      CLI::getMinTimeStep() const         { return minTimeStep; }
+double      CLI::getMaxTimeStep() const         { return maxTimeStep; }
+double      CLI::getSteadyStateTolerance() const{ return steadyStateTol; }
+bool        CLI::useBinaryHistory() const       { return binaryHistory; }
+int         CLI::getHistoryEvery() const        { return historyEvery; }
+double      CLI::getHistoryDelta() const        { return historyDelta; }
+std::string CLI::getProfileFile() const         { return profileFile; }
+bool        CLI::useMeshCache() const           { return meshCache; }
+bool        CLI::useLateralConduction() const   { return lateral; }
+std::string CLI::getSweepFile() const           { return sweepFile; }
+std::string CLI::getPrecision() const           { return precision; }
+std::string CLI::getGridSpacing() const         { return gridSpacing; }
+double      CLI::getGridFourier() const         { return gridFourier; }
+double      CLI::getGridStretch() const         { return gridStretch; }
+std::string CLI::getSurrogateFile() const       { return surrogateFile; }
+std::string CLI::getSurrogateBuildFile() const  { return surrogateBuildFile; }
+std::string CLI::getSearchMethod() const        { return searchMethod; }
+std::string CLI::getSnapshotFile() const        { return snapshotFile; }
+double      CLI::getSnapshotQuantum() const     { return snapshotQuantum; }
+int         CLI::getSnapshotEvery() const       { return snapshotEvery; }
+std::string CLI::getCheckpointDir() const       { return checkpointDir; }
+double      CLI::getCheckpointInterval() const  { return checkpointInterval; }
+bool        CLI::isResume() const               { return resume; }
+std::string CLI::getSurfaceProfileFile() const  { return surfaceProfileFile; }
+bool        CLI::isServe() const                { return serve; }
+int         CLI::getWorkerPort() const          { return workerPort; }
+std::string CLI::getWorkerBind() const          { return workerBind; }
+std::string CLI::getWorkerList() const          { return workerList; }
+std::string CLI::getGroupsFile() const          { return groupsFile; }
+std::string CLI::getStacksFile() const          { return stacksFile; }
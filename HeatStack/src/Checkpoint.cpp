@@ -0,0 +1,96 @@
+#include "Checkpoint.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace {
+
+const char kMagic[4] = {'H', 'S', 'C', 'K'};
+const std::uint32_t kVersion = 1;
+
+template <typename T>
+void writeValue(std::ostream& out, T value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+bool readValue(std::istream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+void writeString(std::ostream& out, const std::string& s) {
+    writeValue(out, static_cast<std::uint32_t>(s.size()));
+    out.write(s.data(), static_cast<std::streamsize>(s.size()));
+}
+
+bool readString(std::istream& in, std::string& s) {
+    std::uint32_t length;
+    if (!readValue(in, length)) return false;
+    s.resize(length);
+    return length == 0 || static_cast<bool>(in.read(&s[0], length));
+}
+
+} // namespace
+
+std::string SliceCheckpoint::path(const std::string& directory, int slice) {
+    return (std::filesystem::path(directory) / ("slice_" + std::to_string(slice + 1) + ".ckpt")).string();
+}
+
+bool SliceCheckpoint::save(const std::string& path, const std::string& runKey) const {
+    std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        out.write(kMagic, sizeof(kMagic));
+        writeValue(out, kVersion);
+        writeString(out, runKey);
+        writeValue(out, static_cast<std::uint32_t>(stage));
+        writeValue(out, historyBytes);
+        writeString(out, solverState);
+        writeValue(out, origCarbonGlue);
+        writeValue(out, origGlueSteel);
+        writeValue(out, origSteel);
+        writeValue(out, static_cast<std::int32_t>(search.rounds));
+        writeValue(out, search.minThickness);
+        writeValue(out, search.maxThickness);
+        writeValue(out, search.thickness);
+        writeValue(out, search.lastStep);
+        writeValue(out, tpsOpt);
+        writeValue(out, static_cast<std::uint8_t>(fromSurrogate));
+        out.flush();
+        if (!out) return false;
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec) std::filesystem::remove(tmpPath, ec);
+    return !ec;
+}
+
+bool SliceCheckpoint::load(const std::string& path, const std::string& runKey) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+
+    char magic[4];
+    std::uint32_t version, stageValue;
+    std::string key;
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, kMagic, sizeof(magic)) != 0 ||
+        !readValue(in, version) || version != kVersion ||
+        !readString(in, key) || key != runKey) return false;
+
+    SliceCheckpoint c;
+    std::int32_t rounds;
+    std::uint8_t surrogate;
+    if (!readValue(in, stageValue) || stageValue > static_cast<std::uint32_t>(Stage::Done) ||
+        !readValue(in, c.historyBytes) || !readString(in, c.solverState) ||
+        !readValue(in, c.origCarbonGlue) || !readValue(in, c.origGlueSteel) || !readValue(in, c.origSteel) ||
+        !readValue(in, rounds) || !readValue(in, c.search.minThickness) ||
+        !readValue(in, c.search.maxThickness) || !readValue(in, c.search.thickness) ||
+        !readValue(in, c.search.lastStep) || !readValue(in, c.tpsOpt) || !readValue(in, surrogate)) {
+        return false;
+    }
+    c.stage = static_cast<Stage>(stageValue);
+    c.search.rounds = rounds;
+    c.fromSurrogate = surrogate != 0;
+    *this = c;
+    return true;
+}
@@ -0,0 +1,369 @@
+#include "CoupledSliceSolver.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace {
+
+// Smallest number of unknowns worth handing to a separate block
+const int kMinBlockWork = 4096;
+
+int blockCount(int nSystems, int systemSize, int numThreads) {
+    long long work = static_cast<long long>(nSystems) * systemSize;
+    long long blocks = std::max(1LL, work / kMinBlockWork);
+    return static_cast<int>(std::min<long long>({ blocks, numThreads, nSystems }));
+}
+
+} // namespace
+
+// Workers sleep between sweeps; run() wakes them, hands out blocks through an
+// atomic counter and returns once every block is done. The calling thread
+// takes blocks too, so nWorkers extra threads give nWorkers + 1 lanes.
+struct CoupledSliceSolver::Team {
+    explicit Team(int nWorkers) {
+        for (int w = 0; w < nWorkers; ++w) threads.emplace_back([this] { work(); });
+    }
+
+    ~Team() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        wake.notify_all();
+        for (auto& t : threads) t.join();
+    }
+
+    // The sweeps do not throw: block sizes are fixed when the blocks are built
+    void run(int blocks, const std::function<void(int)>& fn) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            task = &fn;
+            nBlocks = blocks;
+            next.store(0, std::memory_order_relaxed);
+            busy = static_cast<int>(threads.size());
+            ++generation;
+        }
+        wake.notify_all();
+        drain();
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this] { return busy == 0; });
+        task = nullptr;
+    }
+
+    void work() {
+        unsigned long seen = 0;
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            wake.wait(lock, [&] { return stop || generation != seen; });
+            if (stop) return;
+            seen = generation;
+            lock.unlock();
+            drain();
+            lock.lock();
+            if (--busy == 0) done.notify_one();
+        }
+    }
+
+    void drain() {
+        for (int b; (b = next.fetch_add(1, std::memory_order_relaxed)) < nBlocks; ) (*task)(b);
+    }
+
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    const std::function<void(int)>* task = nullptr;
+    int nBlocks = 0;
+    std::atomic<int> next{0};
+    int busy = 0;
+    unsigned long generation = 0;
+    bool stop = false;
+};
+
+CoupledSliceSolver::CoupledSliceSolver(int numThreads)
+    : numThreads_(numThreads), nSlices_(0), nNodes_(0), sliceSpacing_(0.0),
+      timeHandler_(0.0, 1.0, false), surfaceCondition_(nullptr), cachedDt_(0.0) {
+    if (numThreads_ <= 0) {
+        numThreads_ = static_cast<int>(std::thread::hardware_concurrency());
+        if (numThreads_ <= 0) numThreads_ = 1;
+    }
+}
+
+CoupledSliceSolver::~CoupledSliceSolver() {}
+
+void CoupledSliceSolver::initialize(const std::vector<Stack>& stacks, double sliceSpacing,
+                                    const TimeHandler& timeHandler) {
+    if (stacks.size() < 2) {
+        throw std::runtime_error("CoupledSliceSolver needs at least two slices.");
+    }
+    if (sliceSpacing <= 0.0) {
+        throw std::runtime_error("CoupledSliceSolver slice spacing must be positive.");
+    }
+    const int n = static_cast<int>(stacks[0].xGrid.size());
+    if (n < 3) {
+        throw std::runtime_error("CoupledSliceSolver needs at least three grid points per slice.");
+    }
+    for (const auto& s : stacks) {
+        if (static_cast<int>(s.xGrid.size()) != n) {
+            throw std::runtime_error("All coupled slices must have the same number of grid points.");
+        }
+    }
+
+    stacks_ = stacks;
+    nSlices_ = static_cast<int>(stacks.size());
+    nNodes_ = n;
+    sliceSpacing_ = sliceSpacing;
+    timeHandler_ = timeHandler;
+    const size_t cells = static_cast<size_t>(nNodes_) * nSlices_;
+    temperature_.assign(cells, 0.0);
+    half_.assign(cells, 0.0);
+    surface_.assign(nSlices_, 0.0);
+
+    // Same layer lookup as HeatEquationSolver::getThermalDiffusivity
+    alpha_.assign(cells, 0.0);
+    for (int s = 0; s < nSlices_; ++s) {
+        const Stack& stack = stacks_[s];
+        for (int i = 0; i < nNodes_; ++i) {
+            const Material* mat = &stack.layers.back().material;
+            double x_start = 0.0;
+            for (const auto& layer : stack.layers) {
+                if (stack.xGrid[i] <= x_start + layer.thickness) {
+                    mat = &layer.material;
+                    break;
+                }
+                x_start += layer.thickness;
+            }
+            alpha_[static_cast<size_t>(i) * nSlices_ + s] = mat->k / (mat->rho * mat->c);
+        }
+    }
+
+    // Blocks of whole systems; each gets its own batched solver
+    auto makeBlocks = [](std::vector<Block>& blocks, int first, int nSystems, int nBlocks) {
+        blocks = std::vector<Block>(nBlocks);
+        for (int b = 0; b < nBlocks; ++b) {
+            blocks[b].begin = first + static_cast<int>(static_cast<long long>(nSystems) * b / nBlocks);
+            blocks[b].end   = first + static_cast<int>(static_cast<long long>(nSystems) * (b + 1) / nBlocks);
+        }
+    };
+    makeBlocks(sliceBlocks_, 0, nSlices_, blockCount(nSlices_, nNodes_, numThreads_));
+    makeBlocks(lineBlocks_, 1, nNodes_ - 1, blockCount(nNodes_ - 1, nSlices_, numThreads_));
+    for (auto& block : sliceBlocks_) {
+        int m = block.end - block.begin;
+        block.solver.setupBatch(nNodes_, m);
+        block.rhs.assign(static_cast<size_t>(nNodes_) * m, 0.0);
+    }
+    for (auto& block : lineBlocks_) {
+        int m = block.end - block.begin;
+        block.solver.setupBatch(nSlices_, m);
+        block.rhs.assign(static_cast<size_t>(nSlices_) * m, 0.0);
+    }
+
+    int lanes = static_cast<int>(std::max(sliceBlocks_.size(), lineBlocks_.size()));
+    team_.reset(lanes > 1 ? new Team(lanes - 1) : nullptr);
+    cachedDt_ = 0.0;
+}
+
+void CoupledSliceSolver::setInitialTemperature(const std::vector<double>& initialTemp) {
+    for (int s = 0; s < nSlices_; ++s) setInitialTemperature(s, initialTemp);
+}
+
+void CoupledSliceSolver::setInitialTemperature(int slice, const std::vector<double>& initialTemp) {
+    if (slice < 0 || slice >= nSlices_) {
+        throw std::runtime_error("Slice index out of range: " + std::to_string(slice));
+    }
+    if (initialTemp.size() != static_cast<size_t>(nNodes_)) {
+        throw std::runtime_error("Initial temperature vector size does not match problem size.");
+    }
+    for (int i = 0; i < nNodes_; ++i) {
+        temperature_[static_cast<size_t>(i) * nSlices_ + slice] = initialTemp[i];
+    }
+}
+
+void CoupledSliceSolver::setSurfaceTemperatures(const std::vector<double>& temperatures) {
+    if (temperatures.size() != static_cast<size_t>(nSlices_)) {
+        throw std::runtime_error("Surface temperature count does not match the number of slices.");
+    }
+    surface_ = temperatures;
+}
+
+void CoupledSliceSolver::setSurfaceCondition(const BoundaryCondition* condition,
+                                             const std::vector<std::array<float, 3>>& positions) {
+    if (condition && positions.size() != static_cast<size_t>(nSlices_)) {
+        throw std::runtime_error("Surface position count does not match the number of slices.");
+    }
+    if (condition && condition->getType() != BoundaryType::Dirichlet) {
+        throw std::runtime_error("Surface condition must be Dirichlet.");
+    }
+    surfaceCondition_ = condition;
+    surfacePositions_ = positions;
+    updateSurface(timeHandler_.getCurrentTime());
+}
+
+void CoupledSliceSolver::updateSurface(double time) {
+    if (!surfaceCondition_) return;
+    surfaceCondition_->evaluate(time, surfacePositions_, surfaceValues_);
+    std::copy(surfaceValues_.begin(), surfaceValues_.end(), surface_.begin());
+}
+
+void CoupledSliceSolver::buildSystems(double dt) {
+    const double h = 0.5 * dt;
+    const int S = nSlices_;
+    const int n = nNodes_;
+    rx_.assign(alpha_.size(), 0.0);
+    ry_.assign(alpha_.size(), 0.0);
+    for (int s = 0; s < S; ++s) {
+        const std::vector<double>& x = stacks_[s].xGrid;
+        for (int i = 1; i < n; ++i) {
+            // Interior nodes use the mean spacing, the insulated face its last cell
+            double dxl = x[i] - x[i - 1];
+            double dx = (i < n - 1) ? 0.5 * (dxl + (x[i + 1] - x[i])) : dxl;
+            size_t k = static_cast<size_t>(i) * S + s;
+            rx_[k] = alpha_[k] * h / (dx * dx);
+            ry_[k] = alpha_[k] * h / (sliceSpacing_ * sliceSpacing_);
+        }
+    }
+
+    // Thickness systems: surface row fixed, interior rows, mirrored inner face
+    for (auto& block : sliceBlocks_) {
+        const int m = block.end - block.begin;
+        BTCSMatrixSolver& solver = block.solver;
+        for (int j = 0; j < m; ++j) {
+            const int s = block.begin + j;
+            solver.batchB_[j] = 1.0;
+            solver.batchC_[j] = 0.0;
+            for (int i = 1; i < n; ++i) {
+                double r = rx_[static_cast<size_t>(i) * S + s];
+                solver.batchA_[(i - 1) * m + j] = (i < n - 1) ? -r : -2.0 * r;
+                solver.batchB_[i * m + j] = 1.0 + 2.0 * r;
+                if (i < n - 1) solver.batchC_[i * m + j] = -r;
+            }
+        }
+        solver.factorizeBatch();
+    }
+
+    // Lateral systems, one per node line, mirrored at the first/last slice
+    for (auto& block : lineBlocks_) {
+        const int m = block.end - block.begin;
+        BTCSMatrixSolver& solver = block.solver;
+        for (int j = 0; j < m; ++j) {
+            const double* r = ry_.data() + static_cast<size_t>(block.begin + j) * S;
+            for (int s = 0; s < S; ++s) {
+                solver.batchB_[s * m + j] = 1.0 + 2.0 * r[s];
+                if (s > 0)     solver.batchA_[(s - 1) * m + j] = (s < S - 1) ? -r[s] : -2.0 * r[s];
+                if (s < S - 1) solver.batchC_[s * m + j] = (s > 0) ? -r[s] : -2.0 * r[s];
+            }
+        }
+        solver.factorizeBatch();
+    }
+    cachedDt_ = dt;
+}
+
+void CoupledSliceSolver::sweepThickness(Block& block) {
+    const int S = nSlices_;
+    const int n = nNodes_;
+    const int m = block.end - block.begin;
+    double* rhs = block.rhs.data();
+
+    // Right-hand side: fixed surface, then T + ry * lateral second difference
+    for (int j = 0; j < m; ++j) rhs[j] = surface_[block.begin + j];
+    for (int i = 1; i < n; ++i) {
+        const double* T = temperature_.data() + static_cast<size_t>(i) * S;
+        const double* r = ry_.data() + static_cast<size_t>(i) * S;
+        double* out = rhs + i * m;
+        for (int j = 0; j < m; ++j) {
+            const int s = block.begin + j;
+            double left  = T[s > 0 ? s - 1 : s + 1];
+            double right = T[s < S - 1 ? s + 1 : s - 1];
+            out[j] = T[s] + r[s] * (left - 2.0 * T[s] + right);
+        }
+    }
+
+    block.solver.solveBatchFactored(block.rhs);
+
+    for (int i = 0; i < n; ++i) {
+        std::copy(rhs + i * m, rhs + (i + 1) * m, half_.begin() + static_cast<size_t>(i) * S + block.begin);
+    }
+}
+
+void CoupledSliceSolver::sweepLateral(Block& block) {
+    const int S = nSlices_;
+    const int n = nNodes_;
+    const int m = block.end - block.begin;
+    double* rhs = block.rhs.data();
+
+    // Right-hand side: T* + rx * second difference through the thickness
+    for (int j = 0; j < m; ++j) {
+        const int i = block.begin + j;
+        const double* up   = half_.data() + static_cast<size_t>(i - 1) * S;
+        const double* mid  = half_.data() + static_cast<size_t>(i) * S;
+        const double* down = half_.data() + static_cast<size_t>(i < n - 1 ? i + 1 : i - 1) * S;
+        const double* r = rx_.data() + static_cast<size_t>(i) * S;
+        for (int s = 0; s < S; ++s) {
+            rhs[s * m + j] = mid[s] + r[s] * (up[s] - 2.0 * mid[s] + down[s]);
+        }
+    }
+
+    block.solver.solveBatchFactored(block.rhs);
+
+    for (int j = 0; j < m; ++j) {
+        double* T = temperature_.data() + static_cast<size_t>(block.begin + j) * S;
+        for (int s = 0; s < S; ++s) T[s] = rhs[s * m + j];
+    }
+}
+
+void CoupledSliceSolver::step() {
+    Profiler::count(ProfileCounter::SolverSteps);
+    double dt = timeHandler_.getTimeStep();
+    if (dt != cachedDt_) buildSystems(dt);
+    double time = timeHandler_.getCurrentTime();
+    updateSurface(time + 0.5 * dt);
+
+    // Tasks capture only this, so std::function does not allocate per sweep
+    if (team_) {
+        team_->run(static_cast<int>(sliceBlocks_.size()), [this](int b) { sweepThickness(sliceBlocks_[b]); });
+        team_->run(static_cast<int>(lineBlocks_.size()), [this](int b) { sweepLateral(lineBlocks_[b]); });
+    } else {
+        for (auto& block : sliceBlocks_) sweepThickness(block);
+        for (auto& block : lineBlocks_) sweepLateral(block);
+    }
+    updateSurface(time + dt);
+    std::copy(surface_.begin(), surface_.end(), temperature_.begin());
+
+    timeHandler_.advance();
+}
+
+bool CoupledSliceSolver::isFinished() const {
+    return timeHandler_.isFinished();
+}
+
+double CoupledSliceSolver::getCurrentTime() const {
+    return timeHandler_.getCurrentTime();
+}
+
+int CoupledSliceSolver::getNumSlices() const {
+    return nSlices_;
+}
+
+int CoupledSliceSolver::getNumNodes() const {
+    return nNodes_;
+}
+
+int CoupledSliceSolver::getNumThreads() const {
+    return team_ ? static_cast<int>(team_->threads.size()) + 1 : 1;
+}
+
+std::vector<double> CoupledSliceSolver::getTemperatureDistribution(int slice) const {
+    std::vector<double> T(nNodes_);
+    for (int i = 0; i < nNodes_; ++i) T[i] = getTemperature(slice, i);
+    return T;
+}
+
+double CoupledSliceSolver::getTemperature(int slice, int node) const {
+    return temperature_[static_cast<size_t>(node) * nSlices_ + slice];
+}
@@ -1,96 +1,280 @@
 #include "HeatEquationSolver.h"
 #include "utils.h"
+#include "Profiler.h"
 #include <stdexcept>
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <iostream> 
 
-HeatEquationSolver::HeatEquationSolver(double theta) 
-    : theta_(theta), problemSize_(0), outerBC_(nullptr), innerBC_(nullptr), timeHandler_(0.0, 1.0, false) {}
+namespace {
 
-HeatEquationSolver::~HeatEquationSolver() {
+const char kCheckpointMagic[4] = {'H', 'S', 'C', 'S'};
+const std::uint32_t kCheckpointVersion = 1;
+
+// Checkpoint vectors: u32 count, then the values as doubles whatever Real is
+template <typename T>
+void writeVector(std::ostream& out, const std::vector<T>& values) {
+    std::uint32_t n = static_cast<std::uint32_t>(values.size());
+    out.write(reinterpret_cast<const char*>(&n), sizeof(n));
+    for (T v : values) {
+        double d = static_cast<double>(v);
+        out.write(reinterpret_cast<const char*>(&d), sizeof(d));
+    }
+}
+
+template <typename T>
+bool readVector(std::istream& in, std::vector<T>& values) {
+    std::uint32_t n;
+    if (!in.read(reinterpret_cast<char*>(&n), sizeof(n))) return false;
+    std::vector<double> d(n);
+    if (n && !in.read(reinterpret_cast<char*>(d.data()), n * sizeof(double))) return false;
+    values.assign(d.begin(), d.end());
+    return true;
+}
+
+// θ of the RHS kernels: the two schemes the tools use are compile-time
+// constants, anything else is read at run time
+enum class Scheme { Implicit, CrankNicolson, Runtime };
+
+// θ-method right-hand side with the scheme and boundary types fixed, so the
+// interior loop has no branches and the boundary rows no virtual calls
+template <typename Real, Scheme S, BoundaryType Outer, BoundaryType Inner>
+void assembleRHS(const Real* T, const Real* r, Real* rhs, int n,
+                 Real explicitWeight, Real outerValue, Real innerValue) {
+    if constexpr (S == Scheme::Implicit) {
+        // θ = 1: the explicit part vanishes
+        for (int i = 1; i < n - 1; ++i) rhs[i] = T[i];
+    } else {
+        const Real w = (S == Scheme::CrankNicolson) ? Real(0.5) : explicitWeight;
+        for (int i = 1; i < n - 1; ++i) {
+            rhs[i] = T[i] + w * r[i] * (T[i-1] - 2*T[i] + T[i+1]);
+        }
+    }
+
+    if constexpr (Outer == BoundaryType::Dirichlet) {
+        rhs[0] = outerValue;
+    } else if constexpr (S == Scheme::Implicit) {
+        rhs[0] = T[0];
+    } else {
+        const Real w = (S == Scheme::CrankNicolson) ? Real(0.5) : explicitWeight;
+        rhs[0] = T[0] + w * r[0] * (T[1] - 2 * T[0] + T[1]);
+    }
+
+    if constexpr (Inner == BoundaryType::Dirichlet) {
+        rhs[n - 1] = innerValue;
+    } else if constexpr (S == Scheme::Implicit) {
+        rhs[n - 1] = T[n - 1];
+    } else {
+        // Mirror assumption: T[i+1] ≈ T[i-1] for Neumann (∂T/∂x = 0)
+        const Real w = (S == Scheme::CrankNicolson) ? Real(0.5) : explicitWeight;
+        int i = n - 1;
+        rhs[i] = T[i] + w * r[i] * (T[i - 1] - 2 * T[i] + T[i - 1]);
+    }
+}
+
+// Flux form: lower coefficients in r[0, n), upper ones in r[n, 2n)
+template <typename Real, Scheme S, BoundaryType Outer, BoundaryType Inner>
+void assembleFluxRHS(const Real* T, const Real* r, Real* rhs, int n,
+                     Real explicitWeight, Real outerValue, Real innerValue) {
+    const Real* up = r + n;
+    if constexpr (S == Scheme::Implicit) {
+        for (int i = 0; i < n; ++i) rhs[i] = T[i];
+    } else {
+        const Real w = (S == Scheme::CrankNicolson) ? Real(0.5) : explicitWeight;
+        for (int i = 1; i < n - 1; ++i) {
+            rhs[i] = T[i] + w * (r[i] * (T[i-1] - T[i]) + up[i] * (T[i+1] - T[i]));
+        }
+        // Insulated faces only exchange heat with their one neighbour
+        rhs[0] = T[0] + w * up[0] * (T[1] - T[0]);
+        rhs[n - 1] = T[n - 1] + w * r[n - 1] * (T[n - 2] - T[n - 1]);
+    }
+    if constexpr (Outer == BoundaryType::Dirichlet) rhs[0] = outerValue;
+    if constexpr (Inner == BoundaryType::Dirichlet) rhs[n - 1] = innerValue;
+}
+
+template <typename Real, Scheme S, bool Flux>
+auto pickBoundaries(BoundaryType outer, BoundaryType inner) {
+    constexpr BoundaryType D = BoundaryType::Dirichlet;
+    constexpr BoundaryType N = BoundaryType::Neumann;
+    if constexpr (Flux) {
+        if (outer == D) return inner == D ? &assembleFluxRHS<Real, S, D, D> : &assembleFluxRHS<Real, S, D, N>;
+        return inner == D ? &assembleFluxRHS<Real, S, N, D> : &assembleFluxRHS<Real, S, N, N>;
+    } else {
+        if (outer == D) return inner == D ? &assembleRHS<Real, S, D, D> : &assembleRHS<Real, S, D, N>;
+        return inner == D ? &assembleRHS<Real, S, N, D> : &assembleRHS<Real, S, N, N>;
+    }
+}
+
+template <typename Real, bool Flux>
+auto pickScheme(double theta, BoundaryType outer, BoundaryType inner) {
+    if (theta == 1.0) return pickBoundaries<Real, Scheme::Implicit, Flux>(outer, inner);
+    if (theta == 0.5) return pickBoundaries<Real, Scheme::CrankNicolson, Flux>(outer, inner);
+    return pickBoundaries<Real, Scheme::Runtime, Flux>(outer, inner);
+}
+
+template <typename Real>
+auto pickRHSKernel(double theta, BoundaryType outer, BoundaryType inner, bool flux) {
+    return flux ? pickScheme<Real, true>(theta, outer, inner)
+                : pickScheme<Real, false>(theta, outer, inner);
+}
+
+} // namespace
+
+template <typename Real>
+BasicHeatEquationSolver<Real>::BasicHeatEquationSolver(double theta) 
+    : theta_(theta), problemSize_(0), fluxForm_(false), cachedDt_(0.0), coefficientsValid_(false),
+      halfDt_(0.0), adaptiveTolerance_(1e-2), steadyStateRate_(0.0), steadyState_(false), lastDt_(0.0),
+      timeHandler_(0.0, 1.0, false), outerBC_(nullptr), innerBC_(nullptr),
+      rhsKernel_(nullptr), outerValue_(0), innerValue_(0), timeDependentBC_(false),
+      bcPosition_(1, std::array<float, 3>{0, 0, 0}) {}
+
+template <typename Real>
+BasicHeatEquationSolver<Real>::~BasicHeatEquationSolver() {
     delete outerBC_;
     delete innerBC_;
 }
 
-void HeatEquationSolver::initialize(const Stack& stack, const TimeHandler& timeHandler) {
+template <typename Real>
+void BasicHeatEquationSolver<Real>::initialize(const Stack& stack, const TimeHandler& timeHandler) {
     stack_ = stack;
     problemSize_ = static_cast<int>(stack.xGrid.size()); // Explicit cast to int
     timeHandler_ = timeHandler;
     temperature_.resize(problemSize_, 0.0);
     prevTemperature_.resize(problemSize_, 0.0);
+    rhs_.assign(problemSize_, 0.0);
     matrixSolver_.setupMatrix(problemSize_);
+    steadyState_ = false;
+
+    // Diffusivity only depends on the grid, so look the layers up once
+    alpha_.clear();
+    for (int i = 0; i < problemSize_; ++i) {
+        alpha_.push_back(getThermalDiffusivity(i));
+    }
+
+    // Flux form: every cell lies in one layer (interfaces are nodes), and a
+    // node's heat capacity is split between the cells on either side
+    fluxForm_ = stack.spacing == GridSpacing::Clustered;
+    faceK_.clear();
+    heatCapacity_.assign(fluxForm_ ? problemSize_ : 0, 0.0);
+    if (fluxForm_) {
+        for (int i = 0; i + 1 < problemSize_; ++i) {
+            double mid = 0.5 * (stack_.xGrid[i] + stack_.xGrid[i + 1]);
+            const Material* m = &stack_.layers.back().material;
+            double x_start = 0.0;
+            for (const auto& layer : stack_.layers) {
+                if (mid <= x_start + layer.thickness) { m = &layer.material; break; }
+                x_start += layer.thickness;
+            }
+            double half = 0.5 * (stack_.xGrid[i + 1] - stack_.xGrid[i]);
+            faceK_.push_back(m->k);
+            heatCapacity_[i]     += m->rho * m->c * half;
+            heatCapacity_[i + 1] += m->rho * m->c * half;
+        }
+    }
+    if (outerBC_ && innerBC_) {
+        rhsKernel_ = pickRHSKernel<Real>(theta_, outerBC_->getType(), innerBC_->getType(), fluxForm_);
+    }
+    coefficientsValid_ = false;
+    halfDt_ = 0.0;
+    gridSens_.clear();
+    sens_.clear();
 }
 
-void HeatEquationSolver::setInitialTemperature(const std::vector<double>& initialTemp) {
+template <typename Real>
+void BasicHeatEquationSolver<Real>::setInitialTemperature(const std::vector<double>& initialTemp) {
     if (initialTemp.size() != static_cast<size_t>(problemSize_)) {
         throw std::runtime_error("Initial temperature vector size does not match problem size.");
     }
-    temperature_ = initialTemp;
-    prevTemperature_ = initialTemp;
+    temperature_.assign(initialTemp.begin(), initialTemp.end());
+    prevTemperature_.assign(initialTemp.begin(), initialTemp.end());
 }
 
-void HeatEquationSolver::setBoundaryConditions(BoundaryCondition* outerBC, BoundaryCondition* innerBC) {
+template <typename Real>
+void BasicHeatEquationSolver<Real>::setBoundaryConditions(BoundaryCondition* outerBC, BoundaryCondition* innerBC) {
     outerBC_ = outerBC;
     innerBC_ = innerBC;
+    coefficientsValid_ = false; // BC type decides the boundary rows
+    halfDt_ = 0.0;
+
+    // Constant conditions are read once here, time-dependent ones every step
+    timeDependentBC_ = outerBC_->isTimeDependent() || innerBC_->isTimeDependent();
+    outerValue_ = static_cast<Real>(outerBC_->getValue(bcPosition_[0]));
+    innerValue_ = static_cast<Real>(innerBC_->getValue(bcPosition_[0]));
+    updateBoundaryValues(timeHandler_.getCurrentTime());
+    rhsKernel_ = pickRHSKernel<Real>(theta_, outerBC_->getType(), innerBC_->getType(), fluxForm_);
 }
 
-void HeatEquationSolver::step() {
-    double dt = timeHandler_.getTimeStep();
-    int n = problemSize_;
+template <typename Real>
+void BasicHeatEquationSolver<Real>::setBoundaryPosition(const std::array<float, 3>& position) {
+    bcPosition_[0] = position;
+    if (outerBC_ && innerBC_) {
+        outerValue_ = static_cast<Real>(outerBC_->getValue(position));
+        innerValue_ = static_cast<Real>(innerBC_->getValue(position));
+        updateBoundaryValues(timeHandler_.getCurrentTime());
+    }
+}
 
-    // Debug: print dt and solver time before stepping
-    // std::cerr << "[debug] before step: currentTime=" 
-    //           << timeHandler_.getCurrentTime() 
-    //           << "  dt=" << dt << "\n";
+template <typename Real>
+void BasicHeatEquationSolver<Real>::updateBoundaryValues(double time) {
+    if (!timeDependentBC_) return;
+    outerBC_->evaluate(time, bcPosition_, bcValue_);
+    outerValue_ = static_cast<Real>(bcValue_[0]);
+    innerBC_->evaluate(time, bcPosition_, bcValue_);
+    innerValue_ = static_cast<Real>(bcValue_[0]);
+}
 
-    // 1) Resize tridiagonal and RHS
-    matrixSolver_.setupMatrix(n);
-    std::vector<double> rhs(n, 0.0);
-    std::vector<double> a(n-1, 0.0), b(n, 0.0), c(n-1, 0.0);
+template <typename Real>
+void BasicHeatEquationSolver<Real>::buildSystem(double dt, BasicBTCSMatrixSolver<Real>& solver, std::vector<Real>& r) const {
+    int n = problemSize_;
+    if (static_cast<int>(solver.b_.size()) != n) {
+        solver.setupMatrix(n);
+    }
+    std::vector<Real>& a = solver.a_;
+    std::vector<Real>& b = solver.b_;
+    std::vector<Real>& c = solver.c_;
+    std::fill(a.begin(), a.end(), Real(0));
+    std::fill(b.begin(), b.end(), Real(0));
+    std::fill(c.begin(), c.end(), Real(0));
+    if (fluxForm_) {
+        buildFluxSystem(dt, solver, r);
+        return;
+    }
+    r.assign(n, Real(0));
 
-    // 2) Fill interior rows
+    // Interior rows
     for (int i = 1; i < n - 1; ++i) {
         double dxl   = stack_.xGrid[i]   - stack_.xGrid[i - 1];
         double dxr   = stack_.xGrid[i+1] - stack_.xGrid[i];
         double dxm   = 0.5 * (dxl + dxr);
-        double alpha = getThermalDiffusivity(i);
-        double r     = alpha * dt / (dxm * dxm);
-
-        // Debug first interior setup
-        // if (i == 1) {
-        //     std::cerr << "[debug] i=1  dxl=" << dxl
-        //               << " dxr=" << dxr
-        //               << " dxm=" << dxm
-        //               << " alpha=" << alpha
-        //               << " r=" << r << "\n";
-        // }
-
-        a[i-1] = -theta_ * r;
-        b[i]   =  1 + 2 * theta_ * r;
-        c[i]   = -theta_ * r;
+        double ri    = alpha_[i] * dt / (dxm * dxm);
+        r[i] = static_cast<Real>(ri);
 
-        rhs[i] = temperature_[i]
-               + (1 - theta_) * r
-                 * (temperature_[i-1] - 2*temperature_[i] + temperature_[i+1]);
+        a[i-1] = static_cast<Real>(-theta_ * ri);
+        b[i]   = static_cast<Real>( 1 + 2 * theta_ * ri);
+        c[i]   = static_cast<Real>(-theta_ * ri);
     }
 
-    // 3) Dirichlet outer BC
+    // Dirichlet outer BC
     if (outerBC_->getType() == BoundaryType::Dirichlet) {
-        auto* dirichlet = dynamic_cast<DirichletCondition*>(outerBC_);
-        if (!dirichlet) throw std::runtime_error("Outer BC cast to Dirichlet failed.");
-        double T0 = dirichlet->getValue({0,0,0});
-        b[0]   = 1.0;
-        rhs[0] = T0;
-        c[0]   = 0.0;
+        b[0] = 1.0;
+        c[0] = 0.0;
+    }
+
+    // Outer Neumann (mirror, like the inner face)
+    if (outerBC_->getType() == BoundaryType::Neumann) {
+        double dx = stack_.xGrid[1] - stack_.xGrid[0];
+        double ri = alpha_[0] * dt / (dx * dx);
+        r[0] = static_cast<Real>(ri);
+
+        c[0] = static_cast<Real>(-2 * theta_ * ri);
+        b[0] = static_cast<Real>(1 + 2 * theta_ * ri);
     }
 
     // Inner Dirichlet
     if (innerBC_->getType() == BoundaryType::Dirichlet) {
-        auto* dirichlet = dynamic_cast<DirichletCondition*>(innerBC_);
-        if (!dirichlet) throw std::runtime_error("Inner BC cast to Dirichlet failed.");
-        double Tn = dirichlet->getValue({0, 0, 0});
         b[n - 1] = 1.0;
-        rhs[n - 1] = Tn;
         a[n - 2] = 0.0;
     }
 
@@ -98,96 +282,239 @@ void HeatEquationSolver::step() {
     if (innerBC_->getType() == BoundaryType::Neumann) {
         int i = n - 1;
         double dx = stack_.xGrid[i] - stack_.xGrid[i - 1];
-        double alpha = getThermalDiffusivity(i);
-        double r = alpha * dt / (dx * dx);
+        double ri = alpha_[i] * dt / (dx * dx);
+        r[i] = static_cast<Real>(ri);
+
+        a[i - 1] = static_cast<Real>(-2 * theta_ * ri);
+        b[i] = static_cast<Real>(1 + 2 * theta_ * ri);
+    }
+
+    solver.factorize();
+}
 
-        a[i - 1] = -2 * theta_ * r;
-        b[i] = 1 + 2 * theta_ * r;
+template <typename Real>
+void BasicHeatEquationSolver<Real>::buildFluxSystem(double dt, BasicBTCSMatrixSolver<Real>& solver, std::vector<Real>& r) const {
+    int n = problemSize_;
+    std::vector<Real>& a = solver.a_;
+    std::vector<Real>& b = solver.b_;
+    std::vector<Real>& c = solver.c_;
+    r.assign(2 * n, Real(0));
+    Real* up = r.data() + n;
+
+    // dT_i/dt = (k_r (T_i+1 - T_i)/dxr - k_l (T_i - T_i-1)/dxl) / C_i
+    for (int i = 0; i < n; ++i) {
+        double lo = (i > 0)     ? dt * faceK_[i - 1] / ((stack_.xGrid[i] - stack_.xGrid[i - 1]) * heatCapacity_[i]) : 0.0;
+        double hi = (i < n - 1) ? dt * faceK_[i]     / ((stack_.xGrid[i + 1] - stack_.xGrid[i]) * heatCapacity_[i]) : 0.0;
+        r[i]  = static_cast<Real>(lo);
+        up[i] = static_cast<Real>(hi);
+        if (i > 0)     a[i - 1] = static_cast<Real>(-theta_ * lo);
+        if (i < n - 1) c[i]     = static_cast<Real>(-theta_ * hi);
+        b[i] = static_cast<Real>(1 + theta_ * (lo + hi));
+    }
 
-        // Mirror assumption: temperature_[i+1] ≈ temperature_[i-1] for Neumann (∂T/∂x = 0)
-        rhs[i] = temperature_[i] + (1 - theta_) * r * (temperature_[i - 1] - 2 * temperature_[i] + temperature_[i - 1]);
+    if (outerBC_->getType() == BoundaryType::Dirichlet) {
+        b[0] = 1.0;
+        c[0] = 0.0;
+    }
+    if (innerBC_->getType() == BoundaryType::Dirichlet) {
+        b[n - 1] = 1.0;
+        a[n - 2] = 0.0;
     }
 
-    // // Debug main diagonal entries
-    // std::cerr << "[debug] diagonals b[0..2] = "
-    //           << b[0] << ", " << b[1] << ", " << b[2] << "\n";
+    solver.factorize();
+}
+
+template <typename Real>
+void BasicHeatEquationSolver<Real>::buildRHS(const std::vector<Real>& T, const std::vector<Real>& r, std::vector<Real>& rhs) const {
+    if (!rhsKernel_) throw std::runtime_error("Boundary conditions are not set.");
+    rhs.resize(problemSize_);
+    rhsKernel_(T.data(), r.data(), rhs.data(), problemSize_,
+               static_cast<Real>(1 - theta_), outerValue_, innerValue_);
+}
+
+template <typename Real>
+void BasicHeatEquationSolver<Real>::updateCoefficients(double dt) {
+    buildSystem(dt, matrixSolver_, r_);
+    cachedDt_ = dt;
+    coefficientsValid_ = true;
+}
 
-    // 5) Push into solver
-    matrixSolver_.a_ = std::move(a);
-    matrixSolver_.b_ = std::move(b);
-    matrixSolver_.c_ = std::move(c);
+template <typename Real>
+void BasicHeatEquationSolver<Real>::step() {
+    Profiler::count(ProfileCounter::SolverSteps);
+    if (timeHandler_.isAdaptive()) {
+        adaptiveStep();
+        return;
+    }
 
-    // 6) Solve and update
-    temperature_ = matrixSolver_.solve(rhs);
+    double dt = timeHandler_.getTimeStep();
 
-    // Debug first few temperatures after solve
-    // std::cerr << "[debug] T^{n+1}[0..2] = "
-    //           << temperature_[0] << ", "
-    //           << temperature_[1] << ", "
-    //           << temperature_[2] << "\n";
+    // 1) Matrix and factors only change with dt (adjustTimeStep) or the BCs
+    if (!coefficientsValid_ || dt != cachedDt_) {
+        updateCoefficients(dt);
+    }
+
+    // 2) RHS, then forward/back substitution with the cached factors
+    updateBoundaryValues(timeHandler_.getCurrentTime() + dt);
+    buildRHS(temperature_, r_, rhs_);
+    matrixSolver_.solveFactored(rhs_);
+    temperature_.swap(rhs_);
+    if (!sens_.empty()) stepSensitivity(rhs_);
 
     prevTemperature_ = temperature_;
+    lastDt_ = dt;
+    checkSteadyState(dt);
 
     // Advance the solver’s own clock
     timeHandler_.advance();
 }
 
+template <typename Real>
+RunResult BasicHeatEquationSolver<Real>::run(const std::vector<BasicStepObserver<Real>*>& observers) {
+    RunResult result;
+    while (!isFinished()) {
+        step();
+        ++result.steps;
+        double time = timeHandler_.getCurrentTime();
+        for (std::size_t k = 0; k < observers.size(); ++k) {
+            if (!observers[k]->onStep(time, lastDt_, temperature_) && result.observer < 0) {
+                result.observer = static_cast<int>(k);
+            }
+        }
+        if (result.observer >= 0) {
+            result.reason = StopReason::Observer;
+            result.detail = observers[result.observer]->describeStop();
+            break;
+        }
+    }
+    if (result.observer < 0 && steadyState_) result.reason = StopReason::SteadyState;
+    result.time = timeHandler_.getCurrentTime();
+    return result;
+}
 
+template <typename Real>
+void BasicHeatEquationSolver<Real>::adaptiveStep() {
+    int order = (theta_ == 0.5) ? 2 : 1; // Crank-Nicolson is second order
+    double remaining = timeHandler_.getTotalTime() - timeHandler_.getCurrentTime();
+    double dt = timeHandler_.getTimeStep();
 
-const std::vector<double>& HeatEquationSolver::getTemperatureDistribution() const {
-    return temperature_;
+    while (true) {
+        double trial = std::min(dt, remaining); // land exactly on totalTime
+        double error = estimateError(trial);
+
+        if (error <= adaptiveTolerance_ || trial <= timeHandler_.getMinTimeStep()) {
+            // Accept the more accurate two-half-step solution
+            temperature_.swap(rhs_);
+            prevTemperature_ = temperature_;
+            lastDt_ = trial;
+            checkSteadyState(trial);
+
+            timeHandler_.advance(trial);
+            timeHandler_.adjustTimeStep(
+                timeHandler_.proposeTimeStep(trial, error, adaptiveTolerance_, order, true));
+            return;
+        }
+        dt = timeHandler_.proposeTimeStep(trial, error, adaptiveTolerance_, order, false);
+    }
 }
 
-void HeatEquationSolver::setupMatrix(std::vector<std::vector<double>>& A, double dt) {
-    for (int i = 1; i < problemSize_ - 1; ++i) {
-        double dx_left = stack_.xGrid[i] - stack_.xGrid[i - 1];
-        double dx_right = stack_.xGrid[i + 1] - stack_.xGrid[i];
-        double dx_avg = (dx_left + dx_right) / 2.0;
-        double alpha = getThermalDiffusivity(i);
-        double r = alpha * dt / (dx_avg * dx_avg);
+template <typename Real>
+void BasicHeatEquationSolver<Real>::checkSteadyState(double dt) {
+    if (steadyStateRate_ <= 0.0 || dt <= 0.0) return;
+    double maxChange = 0.0;
+    for (int i = 0; i < problemSize_; ++i) {
+        maxChange = std::max(maxChange, static_cast<double>(std::fabs(temperature_[i] - rhs_[i])));
+    }
+    if (maxChange / dt < steadyStateRate_) steadyState_ = true;
+}
 
-        A[i][i - 1] = -theta_ * r;
-        A[i][i] = 1 + 2 * theta_ * r;
-        A[i][i + 1] = -theta_ * r;
+template <typename Real>
+void BasicHeatEquationSolver<Real>::enableThicknessSensitivity(int layer) {
+    if (fluxForm_ || timeHandler_.isAdaptive()) {
+        throw std::runtime_error("Thickness sensitivity needs a uniform grid and fixed dt");
+    }
+    if (layer < 0 || layer >= static_cast<int>(stack_.layers.size())) {
+        throw std::runtime_error("Thickness sensitivity: no such layer");
+    }
+    // Uniform layers: a node's position moves by its fraction of the layer
+    // when the layer thickens, and by the whole change past it
+    int first = 0;
+    for (int l = 0; l < layer; ++l) first += stack_.layers[l].numPoints - 1;
+    int cells = stack_.layers[layer].numPoints - 1;
+    std::vector<double> dxdh(problemSize_);
+    for (int i = 0; i < problemSize_; ++i) {
+        dxdh[i] = std::min(std::max(double(i - first) / cells, 0.0), 1.0);
     }
+
+    // Same spacings as buildSystem: averaged inside, one cell at mirror rows
+    int n = problemSize_;
+    gridSens_.assign(n, 0.0);
+    for (int i = 1; i < n - 1; ++i) {
+        double dxm = 0.5 * (stack_.xGrid[i + 1] - stack_.xGrid[i - 1]);
+        gridSens_[i] = 0.5 * (dxdh[i + 1] - dxdh[i - 1]) / dxm;
+    }
+    gridSens_[0]     = (dxdh[1] - dxdh[0]) / (stack_.xGrid[1] - stack_.xGrid[0]);
+    gridSens_[n - 1] = (dxdh[n - 1] - dxdh[n - 2]) / (stack_.xGrid[n - 1] - stack_.xGrid[n - 2]);
+    sens_.assign(n, Real(0));
+    sensRhs_.assign(n, Real(0));
 }
 
-void HeatEquationSolver::setupRHS(std::vector<double>& b, double dt) {
-    for (int i = 1; i < problemSize_ - 1; ++i) {
-        double dx_left = stack_.xGrid[i] - stack_.xGrid[i - 1];
-        double dx_right = stack_.xGrid[i + 1] - stack_.xGrid[i];
-        double dx_avg = (dx_left + dx_right) / 2.0;
-        double alpha = getThermalDiffusivity(i);
-        double r = alpha * dt / (dx_avg * dx_avg);
+template <typename Real>
+const std::vector<Real>& BasicHeatEquationSolver<Real>::getThicknessSensitivity() const {
+    return sens_;
+}
 
-        b[i] = temperature_[i] + (1 - theta_) * r * (temperature_[i - 1] - 2 * temperature_[i] + temperature_[i + 1]);
+template <typename Real>
+void BasicHeatEquationSolver<Real>::stepSensitivity(const std::vector<Real>& old) {
+    int n = problemSize_;
+    // Dirichlet values do not depend on the thickness
+    rhsKernel_(sens_.data(), r_.data(), sensRhs_.data(), n, static_cast<Real>(1 - theta_), Real(0), Real(0));
+
+    // r = alpha*dt/dxm^2, so dr/dh = -2 r (d dxm/dh) / dxm; Dirichlet rows have r = 0
+    auto second = [n](const std::vector<Real>& T, int i) -> double {
+        if (i == 0)     return 2.0 * (double(T[1]) - T[0]);
+        if (i == n - 1) return 2.0 * (double(T[n - 2]) - T[n - 1]);
+        return double(T[i - 1]) - 2.0 * T[i] + T[i + 1];
+    };
+    for (int i = 0; i < n; ++i) {
+        if (gridSens_[i] == 0.0 || r_[i] == Real(0)) continue;
+        double drdh = -2.0 * r_[i] * gridSens_[i];
+        sensRhs_[i] += static_cast<Real>(drdh * (theta_ * second(temperature_, i)
+                                                 + (1 - theta_) * second(old, i)));
     }
+    matrixSolver_.solveFactored(sensRhs_);
+    sens_.swap(sensRhs_);
 }
 
+template <typename Real>
+void BasicHeatEquationSolver<Real>::setAdaptiveTolerance(double tolerance) {
+    if (tolerance > 0.0) adaptiveTolerance_ = tolerance;
+}
 
+template <typename Real>
+void BasicHeatEquationSolver<Real>::setSteadyStateTolerance(double rate) {
+    steadyStateRate_ = rate;
+}
 
-void HeatEquationSolver::applyBoundaryConditions(std::vector<std::vector<double>>& A, std::vector<double>& b, double dt) {
-    if (outerBC_ && outerBC_->getType() == BoundaryType::Dirichlet) {
-        auto* dirichlet = dynamic_cast<DirichletCondition*>(outerBC_);
-        if (!dirichlet) throw std::runtime_error("Outer BC cast to Dirichlet failed.");
-        double T_surface = dirichlet->getValue({0, 0, 0});
-        A[0][0] = 1.0;
-        b[0] = T_surface;
-    }
+template <typename Real>
+bool BasicHeatEquationSolver<Real>::reachedSteadyState() const {
+    return steadyState_;
+}
 
-    if (innerBC_ && innerBC_->getType() == BoundaryType::Neumann) {
-        double dx = stack_.xGrid[problemSize_ - 1] - stack_.xGrid[problemSize_ - 2];
-        double alpha = getThermalDiffusivity(problemSize_ - 1);
-        double r = alpha * dt / (dx * dx);
+template <typename Real>
+double BasicHeatEquationSolver<Real>::getLastTimeStep() const {
+    return lastDt_;
+}
 
-        A[problemSize_ - 1][problemSize_ - 2] = -2 * theta_ * r;
-        A[problemSize_ - 1][problemSize_ - 1] = 1 + 2 * theta_ * r;
-        b[problemSize_ - 1] = temperature_[problemSize_ - 1]
-            + (1 - theta_) * r * (temperature_[problemSize_ - 2] - 2 * temperature_[problemSize_ - 1] + temperature_[problemSize_ - 2]);
-    }
+template <typename Real>
+const std::vector<Real>& BasicHeatEquationSolver<Real>::getTemperatureDistribution() const {
+    return temperature_;
 }
 
-double HeatEquationSolver::getThermalDiffusivity(int i) const {
+template <typename Real>
+double BasicHeatEquationSolver<Real>::getThermalDiffusivity(int i) const {
+    if (alpha_.size() == static_cast<size_t>(problemSize_)) return alpha_[i];
+
     double x = stack_.xGrid[i];
     double x_start = 0.0;
     for (const auto& layer : stack_.layers) {
@@ -199,64 +526,113 @@ double HeatEquationSolver::getThermalDiffusivity(int i) const {
     return stack_.layers.back().material.k / (stack_.layers.back().material.rho * stack_.layers.back().material.c);
 }
 
-void HeatEquationSolver::adjustTimeStep(double errorThreshold) {
-    if (theta_ == 0.5) { // Crank-Nicolson
-        double error = estimateError(timeHandler_.getTimeStep());
-        double dt = timeHandler_.getTimeStep();
-        if (error > errorThreshold) {
-            timeHandler_.adjustTimeStep(dt / 2.0);
-        } else if (error < errorThreshold / 2.0) {
-            timeHandler_.adjustTimeStep(dt * 2.0);
-        }
-    } else { // BTCS
-        double maxAlpha = 0.0;
-        for (int i = 0; i < problemSize_; ++i) {
-            double alpha = getThermalDiffusivity(i);
-            if (alpha > maxAlpha) maxAlpha = alpha;
-        }
-        double dx_min = stack_.xGrid[1] - stack_.xGrid[0];
-        for (int i = 1; i < problemSize_ - 1; ++i) {
-            double dx = stack_.xGrid[i + 1] - stack_.xGrid[i];
-            if (dx < dx_min) dx_min = dx;
-        }
-        double dt_max = 0.5 * dx_min * dx_min / maxAlpha;
-        if (timeHandler_.getTimeStep() > dt_max) {
-            timeHandler_.adjustTimeStep(dt_max);
-        }
-    }
+template <typename Real>
+void BasicHeatEquationSolver<Real>::adjustTimeStep(double errorThreshold) {
+    // Same PI controller step() uses in adaptive mode, driven manually
+    int order = (theta_ == 0.5) ? 2 : 1;
+    double dt = timeHandler_.getTimeStep();
+    double error = estimateError(dt);
+    timeHandler_.adjustTimeStep(
+        timeHandler_.proposeTimeStep(dt, error, errorThreshold, order, error <= errorThreshold));
 }
 
-double HeatEquationSolver::estimateError(double dt) {
-    std::vector<double> temp_half = temperature_;
+template <typename Real>
+double BasicHeatEquationSolver<Real>::estimateError(double dt) {
+    // One full step, reusing the step's own factors when dt matches
+    if (!coefficientsValid_ || dt != cachedDt_) {
+        updateCoefficients(dt);
+    }
+    double time = timeHandler_.getCurrentTime();
+    updateBoundaryValues(time + dt);
+    buildRHS(temperature_, r_, errFull_);
+    matrixSolver_.solveFactored(errFull_);
+
+    // Two half steps on a separately factored system
     double dt_half = dt / 2.0;
-    std::vector<std::vector<double>> A(problemSize_, std::vector<double>(problemSize_, 0.0));
-    std::vector<double> b(problemSize_, 0.0);
-
-    // First half step
-    setupMatrix(A, dt_half);
-    setupRHS(b, dt_half);
-    applyBoundaryConditions(A, b, dt_half);
-    temp_half = matrixSolver_.solve(b);
-
-    // Second half step
-    temperature_ = temp_half;
-    setupMatrix(A, dt_half);
-    setupRHS(b, dt_half);
-    applyBoundaryConditions(A, b, dt_half);
-    temp_half = matrixSolver_.solve(b);
-
-    // Compare with full step
+    if (halfDt_ != dt_half) {
+        buildSystem(dt_half, halfSolver_, halfR_);
+        halfDt_ = dt_half;
+    }
+    updateBoundaryValues(time + dt_half);
+    buildRHS(temperature_, halfR_, errHalf_);
+    halfSolver_.solveFactored(errHalf_);
+    updateBoundaryValues(time + dt);
+    buildRHS(errHalf_, halfR_, rhs_);
+    halfSolver_.solveFactored(rhs_);
+
+    // Compare full step with the two half steps
     double error = 0.0;
     for (int i = 0; i < problemSize_; ++i) {
-        error += std::pow(temp_half[i] - prevTemperature_[i], 2);
+        double diff = rhs_[i] - errFull_[i];
+        error += diff * diff;
     }
     return std::sqrt(error / problemSize_);
 }
 
-bool HeatEquationSolver::isFinished() const {
-        return timeHandler_.isFinished();
+template <typename Real>
+bool BasicHeatEquationSolver<Real>::isFinished() const {
+        return steadyState_ || timeHandler_.isFinished();
     }
 
-double HeatEquationSolver::getCurrentTime() const {
+template <typename Real>
+double BasicHeatEquationSolver<Real>::getCurrentTime() const {
     return timeHandler_.getCurrentTime();
-}
\ No newline at end of file
+}
+
+template <typename Real>
+void BasicHeatEquationSolver<Real>::saveCheckpoint(std::ostream& out) const {
+    out.write(kCheckpointMagic, sizeof(kCheckpointMagic));
+    out.write(reinterpret_cast<const char*>(&kCheckpointVersion), sizeof(kCheckpointVersion));
+    writeVector(out, stack_.xGrid);
+    writeVector(out, temperature_);
+    writeVector(out, prevTemperature_);
+    writeVector(out, sens_);
+    const double values[2] = { theta_, lastDt_ };
+    const char flag = steadyState_ ? 1 : 0;
+    out.write(reinterpret_cast<const char*>(values), sizeof(values));
+    out.write(&flag, 1);
+    timeHandler_.save(out);
+}
+
+template <typename Real>
+void BasicHeatEquationSolver<Real>::loadCheckpoint(std::istream& in) {
+    char magic[4];
+    std::uint32_t version = 0;
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, kCheckpointMagic, sizeof(magic)) != 0 ||
+        !in.read(reinterpret_cast<char*>(&version), sizeof(version)) || version != kCheckpointVersion) {
+        throw std::runtime_error("Not a solver checkpoint.");
+    }
+
+    std::vector<double> grid;
+    std::vector<Real> temperature, prevTemperature, sens;
+    double values[2];
+    char flag;
+    TimeHandler time = timeHandler_;
+    if (!readVector(in, grid) || !readVector(in, temperature) || !readVector(in, prevTemperature) ||
+        !readVector(in, sens) || !in.read(reinterpret_cast<char*>(values), sizeof(values)) ||
+        !in.read(&flag, 1) || !time.load(in)) {
+        throw std::runtime_error("Truncated solver checkpoint.");
+    }
+    // Bit-identical grid and scheme, so the run continues exactly where it stopped
+    if (grid != stack_.xGrid || values[0] != theta_ ||
+        temperature.size() != static_cast<size_t>(problemSize_) ||
+        prevTemperature.size() != temperature.size()) {
+        throw std::runtime_error("Solver checkpoint does not match this grid and scheme.");
+    }
+    if (!sens.empty() && sens.size() != temperature.size()) {
+        throw std::runtime_error("Solver checkpoint has a malformed sensitivity.");
+    }
+    if (!sens.empty() && sens_.empty()) {
+        throw std::runtime_error("Enable the thickness sensitivity before loading this checkpoint.");
+    }
+
+    temperature_.swap(temperature);
+    prevTemperature_.swap(prevTemperature);
+    if (!sens.empty()) sens_.swap(sens);
+    lastDt_ = values[1];
+    steadyState_ = flag != 0;
+    timeHandler_ = time;
+}
+
+template class BasicHeatEquationSolver<float>;
+template class BasicHeatEquationSolver<double>;
@@ -0,0 +1,201 @@
+#include "HeatStackService.h"
+#include "InitialTemperature.h"
+#include "Json.h"
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+const char* kContext = "Service request";
+
+std::string rowJson(const SweepRow& r) {
+    std::ostringstream out;
+    out << "{\"slice\":" << r.slice
+        << ",\"lL\":" << jsonNumber(r.lL)
+        << ",\"originalTPS\":" << jsonNumber(r.originalTPS)
+        << ",\"optimizedTPS\":" << jsonNumber(r.optimizedTPS)
+        << ",\"preCarbonTemp\":" << jsonNumber(r.preCarbonTemp)
+        << ",\"preGlueTemp\":" << jsonNumber(r.preGlueTemp)
+        << ",\"preSteelTemp\":" << jsonNumber(r.preSteelTemp)
+        << ",\"postCarbonTemp\":" << jsonNumber(r.postCarbonTemp)
+        << ",\"postGlueTemp\":" << jsonNumber(r.postGlueTemp)
+        << ",\"postSteelTemp\":" << jsonNumber(r.postSteelTemp) << "}";
+    return out.str();
+}
+
+// The request's id echoed back: a number, a string or null
+std::string idJson(const JsonValue* id) {
+    if (!id) return "null";
+    if (id->type == JsonValue::Type::Number) return jsonNumber(id->number);
+    if (id->type == JsonValue::Type::String) return jsonString(id->string);
+    return "null";
+}
+
+std::string asString(const JsonValue& v, const std::string& key) {
+    if (v.type != JsonValue::Type::String) throw std::runtime_error(std::string(kContext) + ": '" + key + "' must be a string");
+    return v.string;
+}
+
+int asInt(const JsonValue& v, const std::string& key) {
+    if (v.type != JsonValue::Type::Number) throw std::runtime_error(std::string(kContext) + ": '" + key + "' must be a number");
+    return static_cast<int>(v.number);
+}
+
+std::vector<double> asNumbers(const JsonValue& v, const std::string& key) {
+    if (v.type != JsonValue::Type::Array) throw std::runtime_error(std::string(kContext) + ": '" + key + "' must be a list");
+    std::vector<double> out;
+    for (const auto& item : v.array) {
+        if (item.type != JsonValue::Type::Number) throw std::runtime_error(std::string(kContext) + ": '" + key + "' must hold numbers");
+        out.push_back(item.number);
+    }
+    return out;
+}
+
+} // namespace
+
+HeatStackService::HeatStackService(const SweepManifest& defaults, const SweepOptions& options,
+                                   const std::string& cacheDir)
+    : defaults_(defaults), options_(options), cache_(cacheDir), scheduler_(options.numThreads) {
+    if (defaults_.configs.empty()) defaults_.configs.push_back(SweepConfig());
+    options_.cache = &cache_;
+    options_.scheduler = &scheduler_;
+}
+
+void HeatStackService::setUseMeshCache(bool enable) {
+    useMeshCache_ = enable;
+}
+
+const MeshHandler& HeatStackService::mesh(const std::string& path) {
+    auto it = meshes_.find(path);
+    if (it != meshes_.end()) return *it->second;
+    std::unique_ptr<MeshHandler> loaded(new MeshHandler());
+    loaded->setUseMeshCache(useMeshCache_);
+    if (!loaded->loadMesh(path)) throw std::runtime_error("Cannot load mesh " + path);
+    ++stats_.meshLoads;
+    return *(meshes_[path] = std::move(loaded));
+}
+
+const std::vector<double>& HeatStackService::initialTemperature(const std::string& path) {
+    auto it = initialTemperatures_.find(path);
+    if (it != initialTemperatures_.end()) return it->second;
+    InitialTemperature initTemp;
+    return initialTemperatures_[path] = initTemp.loadInitialTemperature(path);
+}
+
+std::string HeatStackService::runRequest(const JsonValue& request, bool search) {
+    SweepManifest manifest = defaults_;
+    SweepConfig config = defaults_.configs[0];
+    SweepOptions options = options_;
+    options.searchTPS = search;
+    std::vector<double> inlineInit;
+    for (const auto& entry : request.object) {
+        const std::string& key = entry.first;
+        const JsonValue& v = entry.second;
+        if (key == "id" || key == "op") continue;
+        if (workerMode_ && (key == "mesh" || key == "init")) {
+            throw std::runtime_error(std::string(kContext) + ": '" + key + "' is not accepted by a worker, send '"
+                                     + (key == "mesh" ? "zRange" : "initTemperature") + "'");
+        }
+        if (key == "mesh")        manifest.meshFile = asString(v, key);
+        else if (key == "init")   manifest.initFile = asString(v, key);
+        else if (key == "slices") manifest.nSlices = asInt(v, key);
+        else if (key == "slice") {
+            if (v.type == JsonValue::Type::Array) {
+                for (double slice : asNumbers(v, key)) options.slices.push_back(static_cast<int>(slice));
+            } else {
+                options.slices.assign(1, asInt(v, key));
+            }
+        }
+        else if (key == "zRange") {
+            std::vector<double> range = asNumbers(v, key);
+            if (range.size() != 2 || !(range[1] > range[0])) {
+                throw std::runtime_error(std::string(kContext) + ": 'zRange' must be [zMin, zMax] with zMax > zMin");
+            }
+            options.hasZRange = true;
+            options.zMin = range[0];
+            options.zMax = range[1];
+        }
+        else if (key == "initTemperature") {
+            inlineInit = asNumbers(v, key);
+            if (inlineInit.empty()) throw std::runtime_error(std::string(kContext) + ": 'initTemperature' is empty");
+        }
+        else if (!setSweepConfigKey(config, key, v, kContext)) {
+            throw std::runtime_error(std::string(kContext) + ": unknown key '" + key + "'");
+        }
+    }
+    if (manifest.nSlices < 2) throw std::runtime_error(std::string(kContext) + ": 'slices' must be at least 2");
+    if (config.dt <= 0.0 || config.duration <= 0.0 || config.pointsPerLayer < 2) {
+        throw std::runtime_error(std::string(kContext) + ": needs dt > 0, time > 0 and points >= 2");
+    }
+    manifest.configs.assign(1, config);
+
+    if (!options.hasZRange) {
+        if (workerMode_) throw std::runtime_error(std::string(kContext) + ": a worker needs 'zRange'");
+        options.mesh = &mesh(manifest.meshFile);
+    }
+    if (!inlineInit.empty()) {
+        manifest.initFile.clear();
+        options.initialTemperature = &inlineInit;
+    } else if (!manifest.initFile.empty()) {
+        options.initialTemperature = &initialTemperature(manifest.initFile);
+    }
+
+    ParameterSweep sweep(manifest, options);
+    std::vector<SweepRow> rows = sweep.run();
+    std::string out = "[";
+    for (size_t i = 0; i < rows.size(); ++i) {
+        if (i) out += ",";
+        out += rowJson(rows[i]);
+    }
+    return out + "]";
+}
+
+std::string HeatStackService::statsJson() const {
+    SimulationCache::Stats cs = cache_.getStats();
+    std::ostringstream out;
+    out << "{\"requests\":" << stats_.requests
+        << ",\"errors\":" << stats_.errors
+        << ",\"meshLoads\":" << stats_.meshLoads
+        << ",\"threads\":" << scheduler_.getNumThreads()
+        << ",\"cacheHits\":" << cs.hits + cs.diskHits
+        << ",\"cacheMisses\":" << cs.misses << "}";
+    return out.str();
+}
+
+std::string HeatStackService::handle(const std::string& request) {
+    ++stats_.requests;
+    const JsonValue* id = nullptr;
+    JsonValue root;
+    try {
+        root = parseJson(request, kContext);
+        if (root.type != JsonValue::Type::Object) throw std::runtime_error(std::string(kContext) + ": must be an object");
+        id = root.find("id");
+        const JsonValue* op = root.find("op");
+        if (!op) throw std::runtime_error(std::string(kContext) + ": missing 'op'");
+        std::string name = asString(*op, "op");
+
+        std::string body;
+        if (name == "simulate")      body = "\"rows\":" + runRequest(root, false);
+        else if (name == "suggest")  body = "\"rows\":" + runRequest(root, true);
+        else if (name == "stats")    body = "\"stats\":" + statsJson();
+        else if (name == "shutdown") {
+            if (workerMode_) throw std::runtime_error(std::string(kContext) + ": 'shutdown' is not accepted by a worker");
+            shutdown_ = true;
+            body = "\"shutdown\":true";
+        }
+        else throw std::runtime_error(std::string(kContext) + ": unknown op '" + name + "'");
+        return "{\"id\":" + idJson(id) + ",\"ok\":true," + body + "}";
+    } catch (const std::exception& e) {
+        ++stats_.errors;
+        return "{\"id\":" + idJson(id) + ",\"ok\":false,\"error\":" + jsonString(e.what()) + "}";
+    }
+}
+
+void HeatStackService::serve(std::istream& in, std::ostream& out) {
+    std::string line;
+    while (!shutdown_ && std::getline(in, line)) {
+        if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+        out << handle(line) << std::endl; // Flushed: the client waits for each answer
+    }
+}
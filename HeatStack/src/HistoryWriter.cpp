@@ -0,0 +1,260 @@
+#include "HistoryWriter.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+
+namespace {
+
+const char kMagic[4] = {'H', 'S', 'T', 'H'};
+const std::uint32_t kVersion = 1;
+
+void writeU32(std::ostream& out, std::uint32_t value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+bool readU32(std::istream& in, std::uint32_t& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+} // namespace
+
+HistoryWriter::HistoryWriter(const std::string& path, const std::vector<std::string>& columns,
+                             const HistoryOptions& options)
+    : options_(options), nColumns_(columns.size()), columns_(columns),
+      lastKept_(columns.size(), 0.0), lastOffered_(columns.size(), 0.0) {
+    options_.every = std::max(1, options_.every);
+    options_.blockRows = std::max<std::size_t>(1, options_.blockRows);
+    options_.maxPendingBlocks = std::max<std::size_t>(1, options_.maxPendingBlocks);
+
+    // Resuming cuts off rows written after the checkpoint; a file shorter
+    // than the checkpoint has lost rows and starts over
+    std::error_code ec;
+    bool resume = options_.resumeBytes > 0 &&
+                  std::filesystem::file_size(path, ec) >= options_.resumeBytes && !ec;
+    if (resume) {
+        std::filesystem::resize_file(path, options_.resumeBytes, ec);
+        resume = !ec;
+    }
+
+    std::ios::openmode mode = std::ios::out | (resume ? std::ios::app : std::ios::trunc);
+    if (options_.format == HistoryFormat::Binary) mode |= std::ios::binary;
+    out_.open(path, mode);
+    if (!out_) {
+        closed_ = true;
+        return;
+    }
+    if (resume) out_.seekp(0, std::ios::end); // tellp() reports the size before the first write
+    else writeHeader();
+
+    current_.values.resize(options_.blockRows * nColumns_);
+    worker_ = std::thread(&HistoryWriter::writerLoop, this);
+}
+
+HistoryWriter::~HistoryWriter() {
+    close();
+}
+
+bool HistoryWriter::isOpen() const {
+    return out_.is_open();
+}
+
+void HistoryWriter::record(std::initializer_list<double> row) {
+    if (closed_ || row.size() != nColumns_) return;
+    const double* values = row.begin();
+
+    bool keep = !hasKept_ || ++sinceKept_ >= options_.every;
+    if (!keep && options_.deltaThreshold > 0.0) {
+        for (std::size_t c = 1; c < nColumns_; ++c) {
+            if (std::fabs(values[c] - lastKept_[c]) > options_.deltaThreshold) {
+                keep = true;
+                break;
+            }
+        }
+    }
+
+    if (keep) {
+        append(values);
+        std::copy(values, values + nColumns_, lastKept_.begin());
+        hasKept_ = true;
+        sinceKept_ = 0;
+        lastDropped_ = false;
+    } else {
+        std::copy(values, values + nColumns_, lastOffered_.begin());
+        lastDropped_ = true;
+    }
+}
+
+void HistoryWriter::append(const double* row) {
+    std::copy(row, row + nColumns_, current_.values.begin() + current_.rows * nColumns_);
+    ++current_.rows;
+    ++writtenRows_;
+    if (current_.rows == options_.blockRows) flushCurrent();
+}
+
+void HistoryWriter::flushCurrent() {
+    if (current_.rows == 0) return;
+    std::unique_lock<std::mutex> lock(mutex_);
+    spaceReady_.wait(lock, [this] { return pending_.size() < options_.maxPendingBlocks; });
+    pending_.push_back(std::move(current_));
+
+    if (!freeBlocks_.empty()) {
+        current_ = std::move(freeBlocks_.back());
+        freeBlocks_.pop_back();
+    } else {
+        current_ = Block();
+        current_.values.resize(options_.blockRows * nColumns_);
+    }
+    current_.rows = 0;
+    lock.unlock();
+    workReady_.notify_one();
+}
+
+void HistoryWriter::close() {
+    if (closed_) return;
+    if (lastDropped_) {
+        append(lastOffered_.data()); // always end on the final state
+        lastDropped_ = false;
+    }
+    flushCurrent();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closing_ = true;
+    }
+    workReady_.notify_one();
+    if (worker_.joinable()) worker_.join();
+    out_.close();
+    closed_ = true;
+}
+
+std::uint64_t HistoryWriter::sync() {
+    if (closed_) return 0;
+    flushCurrent();
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.wait(lock, [this] { return pending_.empty() && !writing_; });
+    out_.flush();
+    return static_cast<std::uint64_t>(out_.tellp());
+}
+
+std::size_t HistoryWriter::getWrittenRows() const {
+    return writtenRows_;
+}
+
+void HistoryWriter::writerLoop() {
+    while (true) {
+        Block block;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            workReady_.wait(lock, [this] { return closing_ || !pending_.empty(); });
+            if (pending_.empty()) return; // closing and drained
+            block = std::move(pending_.front());
+            pending_.pop_front();
+            writing_ = true;
+        }
+        spaceReady_.notify_one();
+
+        writeBlock(block);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            freeBlocks_.push_back(std::move(block));
+            writing_ = false;
+        }
+        idle_.notify_all();
+    }
+}
+
+void HistoryWriter::writeHeader() {
+    if (options_.format == HistoryFormat::Csv) {
+        for (std::size_t c = 0; c < nColumns_; ++c) {
+            out_ << columns_[c] << (c + 1 < nColumns_ ? "," : "\n");
+        }
+        return;
+    }
+    out_.write(kMagic, sizeof(kMagic));
+    writeU32(out_, kVersion);
+    writeU32(out_, static_cast<std::uint32_t>(nColumns_));
+    for (const auto& name : columns_) {
+        writeU32(out_, static_cast<std::uint32_t>(name.size()));
+        out_.write(name.data(), name.size());
+    }
+}
+
+void HistoryWriter::writeBlock(const Block& block) {
+    if (options_.format == HistoryFormat::Csv) {
+        // Default stream formatting, same text the old ostringstream produced
+        for (std::size_t r = 0; r < block.rows; ++r) {
+            const double* row = block.values.data() + r * nColumns_;
+            for (std::size_t c = 0; c < nColumns_; ++c) {
+                out_ << row[c] << (c + 1 < nColumns_ ? "," : "\n");
+            }
+        }
+        return;
+    }
+
+    // Columnar: all values of column 0, then column 1, ...
+    writeU32(out_, static_cast<std::uint32_t>(block.rows));
+    std::vector<double> column(block.rows);
+    for (std::size_t c = 0; c < nColumns_; ++c) {
+        for (std::size_t r = 0; r < block.rows; ++r) {
+            column[r] = block.values[r * nColumns_ + c];
+        }
+        out_.write(reinterpret_cast<const char*>(column.data()), block.rows * sizeof(double));
+    }
+}
+
+bool HistoryWriter::readBinary(const std::string& path, std::vector<std::string>& columns,
+                               std::vector<std::vector<double>>& data) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+
+    char magic[4];
+    std::uint32_t version = 0, nColumns = 0;
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, kMagic, sizeof(magic)) != 0) return false;
+    if (!readU32(in, version) || version != kVersion || !readU32(in, nColumns)) return false;
+
+    columns.assign(nColumns, std::string());
+    for (auto& name : columns) {
+        std::uint32_t length = 0;
+        if (!readU32(in, length)) return false;
+        name.resize(length);
+        if (length && !in.read(&name[0], length)) return false;
+    }
+
+    data.assign(nColumns, std::vector<double>());
+    std::uint32_t rows = 0;
+    while (readU32(in, rows)) {
+        for (auto& column : data) {
+            std::size_t offset = column.size();
+            column.resize(offset + rows);
+            if (rows && !in.read(reinterpret_cast<char*>(column.data() + offset), rows * sizeof(double))) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool HistoryWriter::exportCsv(const std::string& binaryPath, const std::string& csvPath) {
+    std::vector<std::string> columns;
+    std::vector<std::vector<double>> data;
+    if (!readBinary(binaryPath, columns, data)) return false;
+
+    std::ofstream out(csvPath);
+    if (!out) return false;
+    for (std::size_t c = 0; c < columns.size(); ++c) {
+        out << columns[c] << (c + 1 < columns.size() ? "," : "\n");
+    }
+    std::size_t rows = data.empty() ? 0 : data[0].size();
+    for (std::size_t r = 0; r < rows; ++r) {
+        for (std::size_t c = 0; c < data.size(); ++c) {
+            out << data[c][r] << (c + 1 < data.size() ? "," : "\n");
+        }
+    }
+    return static_cast<bool>(out);
+}
+
+const char* HistoryWriter::extension(HistoryFormat format) {
+    return format == HistoryFormat::Binary ? ".bin" : ".csv";
+}
@@ -0,0 +1,174 @@
+#include "Json.h"
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+class JsonParser {
+public:
+    JsonParser(const std::string& text, const std::string& context)
+        : text_(text), context_(context), pos_(0) {}
+
+    JsonValue parseDocument() {
+        JsonValue value = parseValue();
+        skipSpace();
+        if (pos_ != text_.size()) fail("unexpected trailing characters");
+        return value;
+    }
+
+private:
+    const std::string& text_;
+    const std::string& context_;
+    size_t pos_;
+
+    [[noreturn]] void fail(const std::string& what) const {
+        throw std::runtime_error(context_ + ": " + what + " at offset " + std::to_string(pos_));
+    }
+
+    void skipSpace() {
+        while (pos_ < text_.size() && (text_[pos_] == ' ' || text_[pos_] == '\t' ||
+                                       text_[pos_] == '\n' || text_[pos_] == '\r')) ++pos_;
+    }
+
+    bool consume(char c) {
+        skipSpace();
+        if (pos_ < text_.size() && text_[pos_] == c) { ++pos_; return true; }
+        return false;
+    }
+
+    void expect(char c) {
+        if (!consume(c)) fail(std::string("expected '") + c + "'");
+    }
+
+    bool consumeWord(const char* word) {
+        size_t n = std::char_traits<char>::length(word);
+        if (text_.compare(pos_, n, word) != 0) return false;
+        pos_ += n;
+        return true;
+    }
+
+    JsonValue parseValue() {
+        skipSpace();
+        if (pos_ >= text_.size()) fail("unexpected end of input");
+        JsonValue value;
+        char c = text_[pos_];
+        if (c == '{') {
+            ++pos_;
+            value.type = JsonValue::Type::Object;
+            if (consume('}')) return value;
+            do {
+                skipSpace();
+                std::string key = parseString();
+                expect(':');
+                value.object.emplace_back(key, parseValue());
+            } while (consume(','));
+            expect('}');
+        } else if (c == '[') {
+            ++pos_;
+            value.type = JsonValue::Type::Array;
+            if (consume(']')) return value;
+            do {
+                value.array.push_back(parseValue());
+            } while (consume(','));
+            expect(']');
+        } else if (c == '"') {
+            value.type = JsonValue::Type::String;
+            value.string = parseString();
+        } else if (consumeWord("true")) {
+            value.type = JsonValue::Type::Bool;
+            value.boolean = true;
+        } else if (consumeWord("false")) {
+            value.type = JsonValue::Type::Bool;
+        } else if (consumeWord("null")) {
+            value.type = JsonValue::Type::Null;
+        } else {
+            const char* start = text_.c_str() + pos_;
+            char* end = nullptr;
+            value.number = std::strtod(start, &end);
+            if (end == start) fail("invalid value");
+            value.type = JsonValue::Type::Number;
+            pos_ += static_cast<size_t>(end - start);
+        }
+        return value;
+    }
+
+    std::string parseString() {
+        if (pos_ >= text_.size() || text_[pos_] != '"') fail("expected a string");
+        ++pos_;
+        std::string out;
+        while (pos_ < text_.size() && text_[pos_] != '"') {
+            char c = text_[pos_++];
+            if (c == '\\') {
+                if (pos_ >= text_.size()) break;
+                char e = text_[pos_++];
+                switch (e) {
+                    case '"': case '\\': case '/': out += e; break;
+                    case 'n': out += '\n'; break;
+                    case 't': out += '\t'; break;
+                    case 'r': out += '\r'; break;
+                    case 'u': {
+                        // ASCII only, as written by jsonString()
+                        if (pos_ + 4 > text_.size()) fail("truncated \\u escape");
+                        char* end = nullptr;
+                        std::string hex = text_.substr(pos_, 4);
+                        long code = std::strtol(hex.c_str(), &end, 16);
+                        if (end != hex.c_str() + 4 || code >= 0x80) fail("unsupported escape in string");
+                        out += static_cast<char>(code);
+                        pos_ += 4;
+                        break;
+                    }
+                    default: fail("unsupported escape in string");
+                }
+            } else {
+                out += c;
+            }
+        }
+        if (pos_ >= text_.size()) fail("unterminated string");
+        ++pos_;
+        return out;
+    }
+};
+
+} // namespace
+
+const JsonValue* JsonValue::find(const std::string& key) const {
+    for (const auto& entry : object) {
+        if (entry.first == key) return &entry.second;
+    }
+    return nullptr;
+}
+
+JsonValue parseJson(const std::string& text, const std::string& context) {
+    return JsonParser(text, context).parseDocument();
+}
+
+std::string jsonString(const std::string& s) {
+    std::string out = "\"";
+    for (char c : s) {
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\t': out += "\\t"; break;
+            case '\r': out += "\\r"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned>(c));
+                    out += buf;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    return out + "\"";
+}
+
+std::string jsonNumber(double value) {
+    std::ostringstream out;
+    out << std::setprecision(17) << value;
+    return out.str();
+}
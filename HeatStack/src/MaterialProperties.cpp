@@ -1,16 +1,32 @@
 #include "MaterialProperties.h"
+#include "Json.h"
 #include "utils.h"
 #include <fstream>
 #include <sstream>
 #include <cmath>
 #include <stdexcept>
+#include <algorithm>
+
+// Node closest to x; a node summed up to just below x still counts as at x
+static int nearestNode(const std::vector<double>& xGrid, double x) {
+    auto it = std::lower_bound(xGrid.begin(), xGrid.end(), x);
+    if (it == xGrid.end() || (it != xGrid.begin() && x - *(it - 1) < *it - x)) --it;
+    return static_cast<int>(it - xGrid.begin());
+}
+
+std::array<int, 3> interfaceNodes(const Stack& stack) {
+    double posCarbonGlue = stack.layers[0].thickness + stack.layers[1].thickness;
+    double posGlueSteel  = posCarbonGlue + stack.layers[2].thickness;
+    return { nearestNode(stack.xGrid, posCarbonGlue), nearestNode(stack.xGrid, posGlueSteel),
+             static_cast<int>(stack.xGrid.size()) - 1 };
+}
 
 MaterialProperties::MaterialProperties() {
     // Initialize predefined materials based on properties.m
-    Material tps = {"TPS", 0.2, 160, 1200, 0, 1200};
-    Material carbonFiber = {"CarbonFiber", 500, 1600, 700, 0, 350};
-    Material glue = {"Glue", 200, 1300, 900, 0, 400};
-    Material steel = {"Steel", 100, 7850, 500, 800, 0};
+    Material tps = getMaterial("TPS");
+    Material carbonFiber = getMaterial("CarbonFiber");
+    Material glue = getMaterial("Glue");
+    Material steel = getMaterial("Steel");
 
     // Example stack (will be replaced by loadStacks or dynamic assignment)
     Stack stack;
@@ -30,17 +46,112 @@ MaterialProperties::~MaterialProperties() {}
 
 
 // Exhaust gas temperature profile from MATLAB: T = -100*log(8*l+1)+900
-double MaterialProperties::getExhaustTemp(double l_over_L) const {
+double MaterialProperties::getExhaustTemp(double l_over_L) {
         return -100.0 * std::log(8.0 * l_over_L + 1.0) + 900.0;
     }
 
+Material MaterialProperties::getMaterial(const std::string& name) {
+    if (name == "TPS")         return {"TPS", 0.2, 160, 1200, 0, 1200};
+    if (name == "CarbonFiber") return {"CarbonFiber", 500, 1600, 700, 0, 350};
+    if (name == "Glue")        return {"Glue", 200, 1300, 900, 0, 400};
+    if (name == "Steel")       return {"Steel", 100, 7850, 500, 800, 0};
+    throw std::runtime_error("Unknown material: " + name);
+}
+
+namespace {
+
+double stackNumber(const JsonValue* v, const std::string& what, double fallback, bool required) {
+    if (!v) {
+        if (required) throw std::runtime_error("Stack file: " + what + " is missing");
+        return fallback;
+    }
+    if (v->type != JsonValue::Type::Number) throw std::runtime_error("Stack file: " + what + " must be a number");
+    return v->number;
+}
+
+Material stackMaterial(const JsonValue& v, const std::string& context) {
+    if (v.type == JsonValue::Type::String) {
+        try {
+            return MaterialProperties::getMaterial(v.string);
+        } catch (const std::runtime_error& e) {
+            throw std::runtime_error("Stack file: " + context + ": " + e.what());
+        }
+    }
+    if (v.type != JsonValue::Type::Object) {
+        throw std::runtime_error("Stack file: " + context + " must be a material name or object");
+    }
+    Material m;
+    const JsonValue* name = v.find("name");
+    m.name = (name && name->type == JsonValue::Type::String) ? name->string : "Material";
+    m.k   = stackNumber(v.find("k"),   context + " 'k'",   0.0, true);
+    m.rho = stackNumber(v.find("rho"), context + " 'rho'", 0.0, true);
+    m.c   = stackNumber(v.find("c"),   context + " 'c'",   0.0, true);
+    m.maxTemp = stackNumber(v.find("maxTemp"), context + " 'maxTemp'", 0.0, false);
+    m.glassTransitionTemp = stackNumber(v.find("glassTransitionTemp"), context + " 'glassTransitionTemp'", 0.0, false);
+    if (!(m.k > 0.0) || !(m.rho > 0.0) || !(m.c > 0.0)) {
+        throw std::runtime_error("Stack file: " + context + " needs positive k, rho and c");
+    }
+    return m;
+}
+
+} // namespace
+
 void MaterialProperties::loadStacks(const std::string& filename) {
-    // Placeholder: Read stack configurations from a file
     std::ifstream file(filename);
     if (!file.is_open()) {
         throw std::runtime_error("Unable to open stack file: " + filename);
     }
-    file.close();
+    std::stringstream text;
+    text << file.rdbuf();
+    JsonValue root = parseJson(text.str(), "Stack file");
+    const JsonValue* list = root.find("stacks");
+    if (!list || list->type != JsonValue::Type::Array) {
+        throw std::runtime_error("Stack file: top level must be an object with a 'stacks' list");
+    }
+
+    std::vector<Stack> loaded;
+    for (const auto& entry : list->array) {
+        if (entry.type != JsonValue::Type::Object) throw std::runtime_error("Stack file: stacks must be objects");
+        Stack stack;
+        stack.id = static_cast<int>(stackNumber(entry.find("id"), "stack 'id'", 0.0, true));
+        const std::string context = "stack " + std::to_string(stack.id);
+        if (stack.id < 1) throw std::runtime_error("Stack file: " + context + ": ids start at 1");
+        for (const auto& other : loaded) {
+            if (other.id == stack.id) throw std::runtime_error("Stack file: duplicate " + context);
+        }
+        if (const JsonValue* groups = entry.find("groups")) {
+            if (groups->type != JsonValue::Type::Array) throw std::runtime_error("Stack file: " + context + " 'groups' must be a list");
+            for (const auto& g : groups->array) {
+                if (g.type != JsonValue::Type::String) throw std::runtime_error("Stack file: " + context + " 'groups' must hold names");
+                stack.groups.push_back(g.string);
+            }
+        }
+        const JsonValue* layers = entry.find("layers");
+        if (!layers || layers->type != JsonValue::Type::Array || layers->array.empty()) {
+            throw std::runtime_error("Stack file: " + context + " needs a non-empty 'layers' list");
+        }
+        stack.totalThickness = 0.0;
+        for (size_t l = 0; l < layers->array.size(); ++l) {
+            const JsonValue& layer = layers->array[l];
+            const std::string layerContext = context + " layer " + std::to_string(l + 1);
+            const JsonValue* material = layer.type == JsonValue::Type::Object ? layer.find("material") : nullptr;
+            if (!material) throw std::runtime_error("Stack file: " + layerContext + " needs a 'material'");
+            Layer out;
+            out.material = stackMaterial(*material, layerContext);
+            out.thickness = stackNumber(layer.find("thickness"), layerContext + " 'thickness'", 0.0, false);
+            if (out.thickness < 0.0) throw std::runtime_error("Stack file: " + layerContext + " has a negative thickness");
+            out.numPoints = 0;
+            stack.totalThickness += out.thickness;
+            stack.layers.push_back(out);
+        }
+        loaded.push_back(stack);
+    }
+
+    for (auto& stack : loaded) {
+        auto same = std::find_if(stacks.begin(), stacks.end(), [&](const Stack& s) { return s.id == stack.id; });
+        if (same != stacks.end()) *same = std::move(stack);
+        else stacks.push_back(std::move(stack));
+    }
 }
 
 Stack MaterialProperties::getStack(int id) const {
@@ -51,6 +162,11 @@ Stack MaterialProperties::getStack(int id) const {
 }
 
 void MaterialProperties::generateGrid(Stack& stack, int pointsPerLayer) {
+    if (gridOptions.spacing == GridSpacing::Clustered) {
+        generateClusteredGrid(stack);
+        return;
+    }
+    stack.spacing = GridSpacing::Uniform;
     stack.xGrid.clear();
     double x = 0.0;
     stack.xGrid.push_back(x);
@@ -66,6 +182,65 @@ void MaterialProperties::generateGrid(Stack& stack, int pointsPerLayer) {
     stack.totalThickness = x;
 }
 
+void MaterialProperties::setGridOptions(const GridOptions& options) {
+    if (!(options.targetFourier > 0.0) || !(options.timeStep > 0.0) || !(options.stretchRatio >= 1.0)
+        || options.minPointsPerLayer < 2 || options.maxPointsPerLayer < options.minPointsPerLayer) {
+        throw std::runtime_error("Invalid grid options");
+    }
+    gridOptions = options;
+}
+
+void MaterialProperties::generateClusteredGrid(Stack& stack) const {
+    const GridOptions& g = gridOptions;
+    stack.spacing = GridSpacing::Clustered;
+    stack.xGrid.assign(1, 0.0);
+    double xStart = 0.0;
+
+    for (size_t l = 0; l < stack.layers.size(); ++l) {
+        Layer& layer = stack.layers[l];
+        const Material& m = layer.material;
+        double L = layer.thickness;
+        double alpha = m.k / (m.rho * m.c);
+
+        // Cells at the faces sized for the Fourier target; the last layer
+        // ends on the insulated face and is only refined at its outer side
+        bool twoSided = l + 1 < stack.layers.size();
+        double span = twoSided ? 0.5 * L : L;
+        double h0 = std::sqrt(alpha * g.timeStep / g.targetFourier);
+
+        // Cells needed per side to cover span with h0, h0*q, h0*q^2, ...
+        double q = g.stretchRatio;
+        int perSide = (q > 1.0)
+            ? static_cast<int>(std::ceil(std::log(1.0 + span * (q - 1.0) / h0) / std::log(q)))
+            : static_cast<int>(std::ceil(span / h0));
+        perSide = std::max(perSide, 1);
+        int cells = twoSided ? 2 * perSide : perSide;
+        cells = std::min(std::max(cells, g.minPointsPerLayer - 1), g.maxPointsPerLayer - 1);
+        if (twoSided && cells % 2) cells += (cells + 1 < g.maxPointsPerLayer) ? 1 : -1;
+        cells = std::max(cells, 1);
+        twoSided = twoSided && cells >= 2;
+        perSide = twoSided ? cells / 2 : cells;
+
+        // Keep the stretch ratio and scale the first cell so each side fills span
+        std::vector<double> widths(cells);
+        double w = (q > 1.0) ? span * (q - 1.0) / (std::pow(q, perSide) - 1.0) : span / perSide;
+        for (int i = 0; i < perSide; ++i, w *= q) {
+            widths[i] = w;
+            if (twoSided) widths[cells - 1 - i] = w;
+        }
+
+        double x = xStart;
+        for (int i = 0; i + 1 < cells; ++i) {
+            x += widths[i];
+            stack.xGrid.push_back(x);
+        }
+        xStart += L;
+        stack.xGrid.push_back(xStart); // interface node exactly at the layer sum
+        layer.numPoints = cells + 1;
+    }
+    stack.totalThickness = xStart;
+}
+
 double MaterialProperties::getTPSThickness(double l_over_L) const {
     return 0.001; // Placeholder, optimized in TemperatureComparator
 }
@@ -90,4 +265,12 @@ double MaterialProperties::getSteelThickness(double l_over_L) const {
     double t = l_over_L * 2.5;
     double sawtooth = 2 * (f * t - std::floor(f * t)) - 1;
     return ((A / 2) * (sawtooth + 1) + 0.001);
-}
\ No newline at end of file
+}
+
+std::vector<double> MaterialProperties::getProfileBreakpoints() const {
+    // Steel: f * t integer every 1 / 12.5; carbon fiber: sin zero every
+    // 1 / 2.5, which lands on a steel jump
+    std::vector<double> breaks;
+    for (int k = 1; k * 0.08 < 1.0 - 1e-12; ++k) breaks.push_back(k / 12.5);
+    return breaks;
+}
@@ -0,0 +1,169 @@
+#include "MeshBin.h"
+#include <sys/stat.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace MeshBin {
+
+namespace {
+
+const char kMagic[8] = {'M', 'E', 'S', 'H', 'B', 'I', 'N', '\0'};
+const std::size_t kFingerprintBlock = 64 * 1024;
+
+static_assert(sizeof(Header) == 136, "MeshBin header layout changed");
+
+std::uint64_t fnv1a(const char* data, std::size_t n, std::uint64_t h) {
+    for (std::size_t i = 0; i < n; ++i) {
+        h ^= static_cast<unsigned char>(data[i]);
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+std::uint64_t padded(std::uint64_t bytes) {
+    return (bytes + 7) & ~std::uint64_t(7);
+}
+
+// Byte sizes of the sections, in file order
+void sectionSizes(const Header& h, std::uint64_t sizes[6]) {
+    sizes[0] = h.vertexCount * 3 * ((h.flags & PositionsF64) ? sizeof(double) : sizeof(float));
+    sizes[1] = h.triangleCount * 3 * sizeof(std::int32_t);
+    sizes[2] = (h.flags & HasPolygons) ? (h.polygonCount + 1) * sizeof(std::int32_t) : 0;
+    sizes[3] = (h.flags & HasPolygons) ? h.polygonElementCount * 3 * sizeof(std::int32_t) : 0;
+    sizes[4] = h.normalCount * 3 * sizeof(double);
+    sizes[5] = h.texCoordCount * 2 * sizeof(double);
+}
+
+void writeSection(std::ofstream& out, const void* data, std::uint64_t bytes) {
+    static const char zeros[8] = {0};
+    if (bytes == 0) return;
+    out.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+    out.write(zeros, static_cast<std::streamsize>(padded(bytes) - bytes));
+}
+
+} // namespace
+
+bool stampOf(const std::string& path, SourceStamp& stamp) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) return false;
+    stamp.size = static_cast<std::uint64_t>(st.st_size);
+    stamp.mtime = static_cast<std::int64_t>(st.st_mtime);
+
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) return false;
+    std::vector<char> block(kFingerprintBlock);
+    std::uint64_t h = fnv1a(reinterpret_cast<const char*>(&stamp.size), sizeof(stamp.size),
+                            14695981039346656037ULL);
+    in.read(block.data(), static_cast<std::streamsize>(block.size()));
+    h = fnv1a(block.data(), static_cast<std::size_t>(in.gcount()), h);
+    if (stamp.size > kFingerprintBlock) {
+        in.clear();
+        std::uint64_t tail = std::max<std::uint64_t>(kFingerprintBlock, stamp.size - kFingerprintBlock);
+        in.seekg(static_cast<std::streamoff>(tail));
+        in.read(block.data(), static_cast<std::streamsize>(block.size()));
+        h = fnv1a(block.data(), static_cast<std::size_t>(in.gcount()), h);
+    }
+    stamp.hash = h;
+    return true;
+}
+
+std::string sidecarPath(const std::string& meshPath) {
+    return meshPath + ".meshbin";
+}
+
+bool write(const std::string& path, const Data& data, const SourceStamp& stamp) {
+    Header h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, kMagic, sizeof(kMagic));
+    h.version = kVersion;
+    h.flags = data.extraFlags;
+    if (data.positionsF64) h.flags |= PositionsF64;
+    if (data.polygonOffsets) h.flags |= HasPolygons;
+    h.sourceSize = stamp.size;
+    h.sourceMtime = stamp.mtime;
+    h.sourceHash = stamp.hash;
+    h.vertexCount = data.vertexCount;
+    h.triangleCount = data.triangleCount;
+    h.polygonCount = data.polygonOffsets ? data.polygonCount : 0;
+    h.polygonElementCount = data.polygonOffsets ? data.polygonElementCount : 0;
+    h.normalCount = data.normalCount;
+    h.texCoordCount = data.texCoordCount;
+    std::memcpy(h.bounds, data.bounds, sizeof(h.bounds));
+
+    std::uint64_t sizes[6];
+    sectionSizes(h, sizes);
+    const void* sections[6] = { data.positions, data.triangles, data.polygonOffsets,
+                                data.polygonElements, data.normals, data.texCoords };
+
+    // Several processes may build the same cache; the rename keeps it whole
+    std::ostringstream tmpName;
+    tmpName << path << "." << std::hash<std::thread::id>()(std::this_thread::get_id()) << ".tmp";
+    std::string tmpPath = tmpName.str();
+    {
+        std::ofstream out(tmpPath, std::ios::binary);
+        if (!out.is_open()) return false;
+        out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+        for (int s = 0; s < 6; ++s) writeSection(out, sections[s], sizes[s]);
+        if (!out) {
+            out.close();
+            std::remove(tmpPath.c_str());
+            return false;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec) {
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+    return true;
+}
+
+bool View::open(const std::string& path) {
+    file_.reset(new MappedFile(path));
+    header_ = nullptr;
+    if (!file_->isOpen() || file_->size() < sizeof(Header)) return false;
+
+    const Header* h = reinterpret_cast<const Header*>(file_->data());
+    if (std::memcmp(h->magic, kMagic, sizeof(kMagic)) != 0 || h->version != kVersion) return false;
+
+    // Rule out counts whose byte sizes would overflow
+    const std::uint64_t limit = file_->size();
+    if (h->vertexCount > limit || h->triangleCount > limit || h->polygonCount > limit
+        || h->polygonElementCount > limit || h->normalCount > limit || h->texCoordCount > limit)
+        return false;
+
+    std::uint64_t sizes[6];
+    sectionSizes(*h, sizes);
+    std::uint64_t total = sizeof(Header);
+    for (std::uint64_t s : sizes) total += padded(s);
+    if (total != file_->size()) return false;
+
+    const char* p = file_->data() + sizeof(Header);
+    const char* starts[6];
+    for (int s = 0; s < 6; ++s) {
+        starts[s] = sizes[s] ? p : nullptr;
+        p += padded(sizes[s]);
+    }
+    positions_ = starts[0];
+    triangles_ = reinterpret_cast<const std::int32_t*>(starts[1]);
+    polygonOffsets_ = reinterpret_cast<const std::int32_t*>(starts[2]);
+    polygonElements_ = reinterpret_cast<const std::int32_t*>(starts[3]);
+    normals_ = reinterpret_cast<const double*>(starts[4]);
+    texCoords_ = reinterpret_cast<const double*>(starts[5]);
+    header_ = h;
+    return true;
+}
+
+bool View::matches(const SourceStamp& stamp) const {
+    return header_ && header_->sourceSize == stamp.size && header_->sourceMtime == stamp.mtime
+        && header_->sourceHash == stamp.hash;
+}
+
+} // namespace MeshBin
@@ -0,0 +1,155 @@
+#include "MeshGroups.h"
+#include "Json.h"
+#include "SliceScheduler.h"
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+// Faces per parallel task
+const size_t kBlock = size_t(1) << 16;
+
+int faceIndex(const JsonValue& v, const std::string& group) {
+    if (v.type != JsonValue::Type::Number || v.number < 0 || v.number > INT_MAX
+        || v.number != static_cast<int>(v.number)) {
+        throw std::runtime_error("Mesh groups: group '" + group + "' has an invalid face index");
+    }
+    return static_cast<int>(v.number);
+}
+
+const JsonValue& list(const JsonValue& v, const std::string& key, const std::string& group) {
+    if (v.type != JsonValue::Type::Array) {
+        throw std::runtime_error("Mesh groups: '" + key + "' of group '" + group + "' must be a list");
+    }
+    return v;
+}
+
+} // namespace
+
+int MeshGroups::find(const std::string& name) const {
+    for (size_t g = 0; g < groups.size(); ++g) {
+        if (groups[g].name == name) return static_cast<int>(g);
+    }
+    return -1;
+}
+
+MeshGroups MeshGroups::parse(const std::string& json) {
+    JsonValue root = parseJson(json, "Mesh groups");
+    if (root.type != JsonValue::Type::Object) throw std::runtime_error("Mesh groups: top level must be an object");
+
+    MeshGroups result;
+    for (const auto& entry : root.object) {
+        if (entry.second.type != JsonValue::Type::Object) {
+            throw std::runtime_error("Mesh groups: group '" + entry.first + "' must be an object");
+        }
+        const JsonValue& g = entry.second;
+        MeshGroup group;
+        const JsonValue* name = g.find("groupName");
+        group.name = (name && name->type == JsonValue::Type::String) ? name->string : entry.first;
+
+        if (const JsonValue* indices = g.find("faceIndices")) {
+            for (const auto& v : list(*indices, "faceIndices", group.name).array) {
+                group.faces.push_back(faceIndex(v, group.name));
+            }
+        }
+        if (const JsonValue* ranges = g.find("faceRanges")) {
+            const auto& r = list(*ranges, "faceRanges", group.name).array;
+            if (r.size() % 2) throw std::runtime_error("Mesh groups: 'faceRanges' of group '" + group.name + "' must hold pairs");
+            for (size_t i = 0; i < r.size(); i += 2) {
+                int first = faceIndex(r[i], group.name), count = faceIndex(r[i + 1], group.name);
+                if (count > INT_MAX - first) throw std::runtime_error("Mesh groups: group '" + group.name + "' has an invalid face range");
+                for (int f = first; f < first + count; ++f) group.faces.push_back(f);
+            }
+        }
+        if (const JsonValue* spatial = g.find("spatialData")) {
+            if (spatial->type == JsonValue::Type::Object) {
+                // Columnar layout
+                if (const JsonValue* column = spatial->find("faceIndex")) {
+                    for (const auto& v : list(*column, "spatialData.faceIndex", group.name).array) {
+                        group.faces.push_back(faceIndex(v, group.name));
+                    }
+                }
+            } else {
+                for (const auto& row : list(*spatial, "spatialData", group.name).array) {
+                    const JsonValue* f = row.find("faceIndex");
+                    if (!f) throw std::runtime_error("Mesh groups: spatialData of group '" + group.name + "' lacks a faceIndex");
+                    group.faces.push_back(faceIndex(*f, group.name));
+                }
+            }
+        }
+        if (const JsonValue* tags = g.find("elementTags")) {
+            for (const auto& t : list(*tags, "elementTags", group.name).array) {
+                if (t.type == JsonValue::Type::String) group.tags.push_back(t.string);
+            }
+        }
+        std::sort(group.faces.begin(), group.faces.end());
+        group.faces.erase(std::unique(group.faces.begin(), group.faces.end()), group.faces.end());
+        if (result.find(group.name) >= 0) throw std::runtime_error("Mesh groups: duplicate group '" + group.name + "'");
+        result.groups.push_back(std::move(group));
+    }
+    return result;
+}
+
+MeshGroups MeshGroups::load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in.is_open()) throw std::runtime_error("Cannot open mesh groups " + path);
+    std::stringstream text;
+    text << in.rdbuf();
+    return parse(text.str());
+}
+
+std::vector<int> MeshGroups::triangleGroups(const MeshHandler& mesh, int numThreads) const {
+    const size_t nPolygons = mesh.getPolygonCount();
+    for (const auto& group : groups) {
+        if (!group.faces.empty() && static_cast<size_t>(group.faces.back()) >= nPolygons) {
+            throw std::runtime_error("Mesh groups: group '" + group.name + "' lists face "
+                                     + std::to_string(group.faces.back()) + " of a mesh with "
+                                     + std::to_string(nPolygons) + " faces");
+        }
+    }
+
+    SliceScheduler scheduler(numThreads);
+    const int polygonBlocks = static_cast<int>((nPolygons + kBlock - 1) / kBlock);
+
+    // Lowest group index per polygon; the minimum does not depend on the order
+    std::vector<std::atomic<int>> owner(nPolygons);
+    scheduler.run(polygonBlocks, [&](int b) {
+        size_t end = std::min(nPolygons, (b + 1) * kBlock);
+        for (size_t p = b * kBlock; p < end; ++p) owner[p].store(INT_MAX, std::memory_order_relaxed);
+    });
+    std::vector<std::pair<int, size_t>> tasks; // (group, first face)
+    for (size_t g = 0; g < groups.size(); ++g) {
+        for (size_t i = 0; i < groups[g].faces.size(); i += kBlock) tasks.emplace_back(static_cast<int>(g), i);
+    }
+    scheduler.run(static_cast<int>(tasks.size()), [&](int t) {
+        const int g = tasks[t].first;
+        const std::vector<int>& faces = groups[g].faces;
+        size_t end = std::min(faces.size(), tasks[t].second + kBlock);
+        for (size_t i = tasks[t].second; i < end; ++i) {
+            std::atomic<int>& o = owner[faces[i]];
+            int current = o.load(std::memory_order_relaxed);
+            while (g < current && !o.compare_exchange_weak(current, g, std::memory_order_relaxed)) {}
+        }
+    });
+
+    // Spread over the triangles of each polygon
+    const std::vector<int>& offsets = mesh.getPolygonOffsets();
+    std::vector<int> result(mesh.getFaces().size(), -1);
+    scheduler.run(polygonBlocks, [&](int b) {
+        size_t end = std::min(nPolygons, (b + 1) * kBlock);
+        for (size_t p = b * kBlock; p < end; ++p) {
+            int g = owner[p].load(std::memory_order_relaxed);
+            if (g == INT_MAX) continue;
+            if (offsets.empty()) {
+                result[p] = g;
+            } else {
+                for (int t = offsets[p]; t < offsets[p + 1]; ++t) result[t] = g;
+            }
+        }
+    });
+    return result;
+}
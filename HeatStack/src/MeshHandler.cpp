@@ -1,86 +1,366 @@
 #include "MeshHandler.h"
+#include "MappedFile.h"
+#include "MeshBin.h"
+#include "SliceScheduler.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
 #include <fstream>
 #include <sstream>
 #include <iostream>
 #include <limits>
+#include <thread>
 
-MeshHandler::MeshHandler() {}
+// Faces are handed to MeshBin as a flat int32 array
+static_assert(sizeof(std::array<int, 3>) == 3 * sizeof(std::int32_t), "unexpected face layout");
 
-MeshHandler::MeshHandler(const std::string& filename) {
-    if (!loadMesh(filename)) {
-        std::cerr << "Error: Failed to load mesh from file: " << filename << std::endl;
-    }
+namespace {
+
+// Diagnostic with a chunk-local line number, printed as text + line + detail
+struct Message {
+    std::string text;
+    size_t line = 0;
+    std::string detail;
+};
+
+// Result of parsing one chunk of whole lines
+struct ChunkResult {
+    std::vector<std::array<float, 3>> vertices;
+    std::vector<std::array<int, 3>> faces;
+    std::vector<int> polygonFaces;       // Triangles of each "f" line
+    std::vector<size_t> relativeFaces;   // Faces holding chunk-local negative indices
+    std::vector<Message> warnings;
+    Message error;                       // First fatal error, empty text if none
+    size_t lines = 0;
+    std::array<float, 3> minBound = {{ std::numeric_limits<float>::max(),
+                                       std::numeric_limits<float>::max(),
+                                       std::numeric_limits<float>::max() }};
+    std::array<float, 3> maxBound = {{ std::numeric_limits<float>::lowest(),
+                                       std::numeric_limits<float>::lowest(),
+                                       std::numeric_limits<float>::lowest() }};
+};
+
+inline bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f'; }
+
+inline const char* skipSpace(const char* p, const char* end) {
+    while (p < end && isSpace(*p)) ++p;
+    return p;
 }
 
-MeshHandler::~MeshHandler() {}
+inline const char* skipToken(const char* p, const char* end) {
+    while (p < end && !isSpace(*p)) ++p;
+    return p;
+}
 
-bool MeshHandler::loadMesh(const std::string &filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        std::cerr << "Failed to open mesh file: " << filename << std::endl;
-        return false;
-    }
+// from_chars does not take a leading '+', the stream parser did
+template <typename T>
+inline const char* parseNumber(const char* p, const char* end, T& value) {
+    if (p < end && *p == '+') ++p;
+    auto r = std::from_chars(p, end, value);
+    return r.ec == std::errc() ? r.ptr : nullptr;
+}
 
-    vertices.clear();
-    faces.clear();
+// Offsets from per-polygon triangle counts; empty if all counts are 1
+template <typename Count>
+std::vector<int> offsetsOf(size_t nPolygons, Count count) {
+    std::vector<int> offsets;
+    bool identity = true;
+    for (size_t p = 0; p < nPolygons && identity; ++p) identity = count(p) == 1;
+    if (identity) return offsets;
+    offsets.reserve(nPolygons + 1);
+    offsets.push_back(0);
+    for (size_t p = 0; p < nPolygons; ++p) offsets.push_back(offsets.back() + count(p));
+    return offsets;
+}
+
+// Parse the lines in [begin, end)
+void parseChunk(const char* begin, const char* end, ChunkResult& out) {
+    std::vector<int> indices;
+    const char* p = begin;
+    while (p < end) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        if (!lineEnd) lineEnd = end;
+        ++out.lines;
+        const char* line = p;
+        p = lineEnd + 1;
 
-    std::string line;
-    size_t lineNumber = 0;
-    while (std::getline(file, line)) {
-        ++lineNumber;
-        if (line.empty() || line[0] == '#') 
+        if (line == lineEnd || *line == '#')
             continue;  // skip comments and blank lines
 
-        std::istringstream ss(line);
-        std::string type;
-        if (!(ss >> type)) {
-            std::cerr << "Warning: Empty or invalid line at " << lineNumber << std::endl;
+        const char* q = skipSpace(line, lineEnd);
+        if (q == lineEnd) {
+            out.warnings.push_back({"Warning: Empty or invalid line at ", out.lines, ""});
             continue;
         }
+        const char* typeEnd = skipToken(q, lineEnd);
+        size_t typeLen = typeEnd - q;
 
-        if (type == "v") {
-            float x, y, z;
-            if (!(ss >> x >> y >> z)) {
-                std::cerr << "Error: Invalid vertex format at line " << lineNumber
-                          << " (expected 3 floats): \"" << line << "\"" << std::endl;
-                return false;
+        if (typeLen == 1 && *q == 'v') {
+            std::array<float, 3> v;
+            const char* r = typeEnd;
+            for (int k = 0; k < 3 && r; ++k) {
+                r = skipSpace(r, lineEnd);
+                r = parseNumber(r, lineEnd, v[k]);
+            }
+            if (!r) {
+                out.error = {"Error: Invalid vertex format at line ", out.lines,
+                             " (expected 3 floats): \"" + std::string(line, lineEnd) + "\""};
+                return;
+            }
+            for (int k = 0; k < 3; ++k) {
+                out.minBound[k] = std::min(out.minBound[k], v[k]);
+                out.maxBound[k] = std::max(out.maxBound[k], v[k]);
             }
-            vertices.push_back({x, y, z});
-
-        } else if (type == "f") {
-            std::vector<int> indices;
-            std::string token;
-            while (ss >> token) {
-                // OBJ face tokens can be "v", "v/vt", "v/vt/vn"
-                size_t slashPos = token.find('/');
-                std::string idxStr = (slashPos == std::string::npos)
-                                         ? token
-                                         : token.substr(0, slashPos);
-                try {
-                    int idx = std::stoi(idxStr) - 1;  // 1‐based → 0‐based
-                    indices.push_back(idx);
-                } catch (const std::exception&) {
-                    std::cerr << "Error: Invalid face index at line " << lineNumber
-                              << ": \"" << token << "\"" << std::endl;
-                    return false;
+            out.vertices.push_back(v);
+
+        } else if (typeLen == 1 && *q == 'f') {
+            // OBJ face tokens can be "v", "v/vt", "v/vt/vn" or "v//vn"
+            indices.clear();
+            bool relative = false;
+            const char* r = skipSpace(typeEnd, lineEnd);
+            while (r < lineEnd) {
+                const char* tokenEnd = skipToken(r, lineEnd);
+                int idx = 0;
+                if (!parseNumber(r, tokenEnd, idx)) {
+                    out.error = {"Error: Invalid face index at line ", out.lines,
+                                 ": \"" + std::string(r, tokenEnd) + "\""};
+                    return;
+                }
+                if (idx < 0) {
+                    // Relative to the vertices seen so far; fixed up by the caller
+                    idx = static_cast<int>(out.vertices.size()) + idx;
+                    relative = true;
+                } else {
+                    idx -= 1;  // 1‐based → 0‐based
                 }
+                indices.push_back(idx);
+                r = skipSpace(tokenEnd, lineEnd);
             }
 
             if (indices.size() < 3) {
-                std::cerr << "Warning: Face with fewer than 3 vertices at line "
-                          << lineNumber << std::endl;
+                out.warnings.push_back({"Warning: Face with fewer than 3 vertices at line ",
+                                        out.lines, ""});
+                out.polygonFaces.push_back(0);
                 continue;
             }
 
             // Fan triangulation
+            out.polygonFaces.push_back(static_cast<int>(indices.size() - 2));
             for (size_t i = 1; i + 1 < indices.size(); ++i) {
-                faces.push_back({indices[0], indices[i], indices[i + 1]});
+                if (relative) out.relativeFaces.push_back(out.faces.size());
+                out.faces.push_back({indices[0], indices[i], indices[i + 1]});
             }
+        }
+        // Unknown line types (vn, vt, usemtl, ...) are skipped
+    }
+}
+
+} // namespace
 
-        } else {
-            // // Unknown line type: skip or warn
-            // std::cerr << "Warning: Unrecognized line type \"" << type
-            //           << "\" at line " << lineNumber << std::endl;
+MeshHandler::MeshHandler() : parseThreads(0), useMeshCache(true) {
+    resetBounds();
+}
+
+MeshHandler::MeshHandler(const std::string& filename) : parseThreads(0), useMeshCache(true) {
+    resetBounds();
+    if (!loadMesh(filename)) {
+        std::cerr << "Error: Failed to load mesh from file: " << filename << std::endl;
+    }
+}
+
+MeshHandler::~MeshHandler() {}
+
+void MeshHandler::setParseThreads(int numThreads) {
+    parseThreads = numThreads;
+}
+
+void MeshHandler::setUseMeshCache(bool enable) {
+    useMeshCache = enable;
+}
+
+void MeshHandler::resetBounds() {
+    minBound.fill(std::numeric_limits<float>::max());
+    maxBound.fill(std::numeric_limits<float>::lowest());
+}
+
+bool MeshHandler::loadMesh(const std::string &filename) {
+    // A matching sidecar cache replaces the OBJ parse
+    const std::string ext = ".meshbin";
+    if (filename.size() > ext.size() && filename.compare(filename.size() - ext.size(), ext.size(), ext) == 0) {
+        if (loadCache(filename, nullptr)) return true;
+        std::cerr << "Error: Invalid or unreadable mesh file: " << filename << std::endl;
+        return false;
+    }
+
+    MeshBin::SourceStamp stamp;
+    bool cacheable = useMeshCache && MeshBin::stampOf(filename, stamp);
+    if (cacheable && loadCache(MeshBin::sidecarPath(filename), &stamp)) {
+        return true;
+    }
+
+    if (!parseObj(filename)) return false;
+
+    if (cacheable) {
+        MeshBin::Data data;
+        data.positions = vertices.data();
+        data.vertexCount = vertices.size();
+        data.triangles = reinterpret_cast<const std::int32_t*>(faces.data());
+        data.triangleCount = faces.size();
+        // Polygons rebuilt from their fans (v, no vt, no vn), so a cached
+        // load keeps the face numbering of the OBJ
+        std::vector<std::int32_t> elementOffsets, elements;
+        if (!polygonOffsets.empty()) {
+            elementOffsets.reserve(polygonOffsets.size());
+            elementOffsets.push_back(0);
+            for (size_t p = 0; p + 1 < polygonOffsets.size(); ++p) {
+                int first = polygonOffsets[p], last = polygonOffsets[p + 1];
+                if (first < last) {
+                    for (int v : { faces[first][0], faces[first][1] }) elements.insert(elements.end(), { v, -1, -1 });
+                    for (int f = first; f < last; ++f) elements.insert(elements.end(), { faces[f][2], -1, -1 });
+                }
+                elementOffsets.push_back(static_cast<std::int32_t>(elements.size() / 3));
+            }
+            data.polygonOffsets = elementOffsets.data();
+            data.polygonElements = elements.data();
+            data.polygonCount = polygonOffsets.size() - 1;
+            data.polygonElementCount = elements.size() / 3;
+        }
+        for (int k = 0; k < 3; ++k) {
+            data.bounds[k] = minBound[k];
+            data.bounds[k + 3] = maxBound[k];
+        }
+        MeshBin::write(MeshBin::sidecarPath(filename), data, stamp); // Best effort
+    }
+    return true;
+}
+
+bool MeshHandler::loadCache(const std::string& cachePath, const MeshBin::SourceStamp* stamp) {
+    MeshBin::View view;
+    if (!view.open(cachePath) || (stamp && !view.matches(*stamp))) return false;
+    const MeshBin::Header& h = view.header();
+    if ((stamp && (h.flags & MeshBin::Lenient)) || h.vertexCount == 0) return false;
+
+    std::vector<std::array<float, 3>> cachedVertices(h.vertexCount);
+    if (view.positionsF64()) {
+        // Written by MeshX, which parses coordinates as doubles
+        const double* p = view.positionsF64Data();
+        for (size_t i = 0; i < cachedVertices.size(); ++i) {
+            for (int k = 0; k < 3; ++k) cachedVertices[i][k] = static_cast<float>(p[3 * i + k]);
+        }
+    } else {
+        std::memcpy(cachedVertices.data(), view.positionsF32(), h.vertexCount * 3 * sizeof(float));
+    }
+    std::vector<std::array<int, 3>> cachedFaces(h.triangleCount);
+    if (h.triangleCount) {
+        std::memcpy(cachedFaces.data(), view.triangles(), h.triangleCount * 3 * sizeof(std::int32_t));
+    }
+    // Bad indices: let the OBJ parse report them
+    const int n = static_cast<int>(cachedVertices.size());
+    for (const auto& face : cachedFaces) {
+        for (int idx : face) {
+            if (idx < 0 || idx >= n) return false;
+        }
+    }
+
+    // Polygons whose fans do not add up to the triangles are left out
+    std::vector<int> cachedOffsets;
+    if (h.flags & MeshBin::HasPolygons) {
+        const std::int32_t* elementOffsets = view.polygonOffsets();
+        auto count = [elementOffsets](size_t p) {
+            return std::max(0, elementOffsets[p + 1] - elementOffsets[p] - 2);
+        };
+        cachedOffsets = offsetsOf(h.polygonCount, count);
+        if (!cachedOffsets.empty() && cachedOffsets.back() != static_cast<int>(h.triangleCount)) {
+            cachedOffsets.clear();
+        }
+    }
+
+    vertices.swap(cachedVertices);
+    faces.swap(cachedFaces);
+    polygonOffsets.swap(cachedOffsets);
+    resetBounds();
+    for (const auto& v : vertices) {
+        for (int k = 0; k < 3; ++k) {
+            minBound[k] = std::min(minBound[k], v[k]);
+            maxBound[k] = std::max(maxBound[k], v[k]);
+        }
+    }
+    return true;
+}
+
+bool MeshHandler::parseObj(const std::string& filename) {
+    MappedFile file(filename);
+    if (!file.isOpen()) {
+        std::cerr << "Failed to open mesh file: " << filename << std::endl;
+        return false;
+    }
+
+    vertices.clear();
+    faces.clear();
+    polygonOffsets.clear();
+    resetBounds();
+
+    const char* data = file.data();
+    const size_t size = file.size();
+
+    // Split into chunks of whole lines; small files stay on one thread
+    const size_t minChunk = size_t(4) << 20;
+    int nChunks = parseThreads;
+    if (nChunks <= 0) {
+        size_t cores = std::max(1u, std::thread::hardware_concurrency());
+        nChunks = static_cast<int>(std::min(cores, size / minChunk + 1));
+    }
+    nChunks = std::max(1, nChunks);
+    std::vector<size_t> starts(1, 0);
+    for (int c = 1; c < nChunks; ++c) {
+        size_t pos = std::max(starts.back(), size * c / nChunks);
+        const void* nl = pos < size ? std::memchr(data + pos, '\n', size - pos) : nullptr;
+        if (!nl) break;
+        starts.push_back(static_cast<const char*>(nl) - data + 1);
+    }
+    starts.push_back(size);
+    nChunks = static_cast<int>(starts.size() - 1);
+
+    std::vector<ChunkResult> chunks(nChunks);
+    SliceScheduler scheduler(nChunks);
+    scheduler.run(nChunks, [&](int c) {
+        parseChunk(data + starts[c], data + starts[c + 1], chunks[c]);
+    });
+
+    // Stitch chunks in order: messages, vertex offsets for relative indices
+    size_t lineOffset = 0;
+    size_t nVertices = 0, nFaces = 0;
+    for (auto& chunk : chunks) {
+        for (const auto& w : chunk.warnings) {
+            std::cerr << w.text << (lineOffset + w.line) << w.detail << std::endl;
+        }
+        if (!chunk.error.text.empty()) {
+            const Message& e = chunk.error;
+            std::cerr << e.text << (lineOffset + e.line) << e.detail << std::endl;
+            return false;
+        }
+        for (size_t f : chunk.relativeFaces) {
+            for (int& idx : chunk.faces[f]) idx += static_cast<int>(nVertices);
+        }
+        lineOffset += chunk.lines;
+        nVertices += chunk.vertices.size();
+        nFaces += chunk.faces.size();
+    }
+
+    std::vector<int> polygonFaces;
+    for (const auto& chunk : chunks) {
+        polygonFaces.insert(polygonFaces.end(), chunk.polygonFaces.begin(), chunk.polygonFaces.end());
+    }
+    polygonOffsets = offsetsOf(polygonFaces.size(), [&](size_t p) { return polygonFaces[p]; });
+
+    vertices.reserve(nVertices);
+    faces.reserve(nFaces);
+    for (auto& chunk : chunks) {
+        vertices.insert(vertices.end(), chunk.vertices.begin(), chunk.vertices.end());
+        faces.insert(faces.end(), chunk.faces.begin(), chunk.faces.end());
+        for (int k = 0; k < 3; ++k) {
+            minBound[k] = std::min(minBound[k], chunk.minBound[k]);
+            maxBound[k] = std::max(maxBound[k], chunk.maxBound[k]);
         }
     }
 
@@ -110,16 +390,21 @@ const std::vector<std::array<int, 3>>& MeshHandler::getFaces() const {
     return faces;
 }
 
+const std::vector<int>& MeshHandler::getPolygonOffsets() const {
+    return polygonOffsets;
+}
+
+size_t MeshHandler::getPolygonCount() const {
+    return polygonOffsets.empty() ? faces.size() : polygonOffsets.size() - 1;
+}
+
+// Bounds are computed once in loadMesh()
 float MeshHandler::getMinZ() const {
     if (vertices.empty()) {
         std::cerr << "Error: Cannot compute getMinZ()—no vertices loaded." << std::endl;
         return 0.0f;
     }
-    float minZ = std::numeric_limits<float>::max();
-    for (const auto& v : vertices) {
-        minZ = std::min(minZ, v[2]);
-    }
-    return minZ;
+    return minBound[2];
 }
 
 float MeshHandler::getMaxZ() const {
@@ -127,42 +412,22 @@ float MeshHandler::getMaxZ() const {
         std::cerr << "Error: Cannot compute getMaxZ()—no vertices loaded." << std::endl;
         return 0.0f;
     }
-    float maxZ = std::numeric_limits<float>::lowest();
-    for (const auto& v : vertices) {
-        maxZ = std::max(maxZ, v[2]);
-    }
-    return maxZ;
+    return maxBound[2];
 }
 
 
 float MeshHandler::getMinX() const {
-    float minX = std::numeric_limits<float>::max();
-    for (const auto& v : vertices) {
-        if (v[0] < minX) minX = v[0];
-    }
-    return minX;
+    return minBound[0];
 }
 
 float MeshHandler::getMaxX() const {
-    float maxX = std::numeric_limits<float>::lowest();
-    for (const auto& v : vertices) {
-        if (v[0] > maxX) maxX = v[0];
-    }
-    return maxX;
+    return maxBound[0];
 }
 
 float MeshHandler::getMinY() const {
-    float minY = std::numeric_limits<float>::max();
-    for (const auto& v : vertices) {
-        if (v[1] < minY) minY = v[1];
-    }
-    return minY;
+    return minBound[1];
 }
 
 float MeshHandler::getMaxY() const {
-    float maxY = std::numeric_limits<float>::lowest();
-    for (const auto& v : vertices) {
-        if (v[1] > maxY) maxY = v[1];
-    }
-    return maxY;
-}
\ No newline at end of file
+    return maxBound[1];
+}
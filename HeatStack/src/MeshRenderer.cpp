@@ -0,0 +1,451 @@
+#include "MeshRenderer.h"
+#include <cmath>
+#include <cstddef>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#endif
+#include <GL/gl.h>
+#include <GLFW/glfw3.h>
+
+// Buffer object entry points are not exported by the GL 1.1 headers on
+// Windows; fetch them at runtime through GLFW instead of adding a loader.
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+#ifndef GL_ARRAY_BUFFER
+#define GL_ARRAY_BUFFER 0x8892
+#endif
+#ifndef GL_STATIC_DRAW
+#define GL_STATIC_DRAW 0x88E4
+#endif
+#ifndef GL_DYNAMIC_DRAW
+#define GL_DYNAMIC_DRAW 0x88E8
+#endif
+#ifndef GL_FRAGMENT_SHADER
+#define GL_FRAGMENT_SHADER 0x8B30
+#endif
+#ifndef GL_VERTEX_SHADER
+#define GL_VERTEX_SHADER 0x8B31
+#endif
+#ifndef GL_COMPILE_STATUS
+#define GL_COMPILE_STATUS 0x8B81
+#endif
+#ifndef GL_LINK_STATUS
+#define GL_LINK_STATUS 0x8B82
+#endif
+#ifndef GL_CLAMP_TO_EDGE
+#define GL_CLAMP_TO_EDGE 0x812F
+#endif
+#ifndef GL_TEXTURE0
+#define GL_TEXTURE0 0x84C0
+#endif
+#ifndef GL_RG
+#define GL_RG 0x8227
+#endif
+#ifndef GL_RG32F
+#define GL_RG32F 0x8230
+#endif
+
+namespace {
+
+typedef void (APIENTRY *GenBuffersFn)(GLsizei, GLuint*);
+typedef void (APIENTRY *DeleteBuffersFn)(GLsizei, const GLuint*);
+typedef void (APIENTRY *BindBufferFn)(GLenum, GLuint);
+typedef void (APIENTRY *BufferDataFn)(GLenum, std::ptrdiff_t, const void*, GLenum);
+
+GenBuffersFn    hsGenBuffers    = nullptr;
+DeleteBuffersFn hsDeleteBuffers = nullptr;
+BindBufferFn    hsBindBuffer    = nullptr;
+BufferDataFn    hsBufferData    = nullptr;
+
+// Shader entry points (GL 2.0), for playback
+typedef GLuint (APIENTRY *CreateShaderFn)(GLenum);
+typedef void (APIENTRY *ShaderSourceFn)(GLuint, GLsizei, const char* const*, const GLint*);
+typedef void (APIENTRY *CompileShaderFn)(GLuint);
+typedef void (APIENTRY *GetShaderivFn)(GLuint, GLenum, GLint*);
+typedef void (APIENTRY *DeleteShaderFn)(GLuint);
+typedef GLuint (APIENTRY *CreateProgramFn)();
+typedef void (APIENTRY *AttachShaderFn)(GLuint, GLuint);
+typedef void (APIENTRY *LinkProgramFn)(GLuint);
+typedef void (APIENTRY *GetProgramivFn)(GLuint, GLenum, GLint*);
+typedef void (APIENTRY *DeleteProgramFn)(GLuint);
+typedef void (APIENTRY *UseProgramFn)(GLuint);
+typedef GLint (APIENTRY *GetLocationFn)(GLuint, const char*);
+typedef void (APIENTRY *Uniform1fFn)(GLint, GLfloat);
+typedef void (APIENTRY *Uniform1iFn)(GLint, GLint);
+typedef void (APIENTRY *Uniform2fFn)(GLint, GLfloat, GLfloat);
+typedef void (APIENTRY *AttribArrayFn)(GLuint);
+typedef void (APIENTRY *VertexAttribPointerFn)(GLuint, GLint, GLenum, GLboolean, GLsizei, const void*);
+typedef void (APIENTRY *ActiveTextureFn)(GLenum);
+
+CreateShaderFn        hsCreateShader        = nullptr;
+ShaderSourceFn        hsShaderSource        = nullptr;
+CompileShaderFn       hsCompileShader       = nullptr;
+GetShaderivFn         hsGetShaderiv         = nullptr;
+DeleteShaderFn        hsDeleteShader        = nullptr;
+CreateProgramFn       hsCreateProgram       = nullptr;
+AttachShaderFn        hsAttachShader        = nullptr;
+LinkProgramFn         hsLinkProgram         = nullptr;
+GetProgramivFn        hsGetProgramiv        = nullptr;
+DeleteProgramFn       hsDeleteProgram       = nullptr;
+UseProgramFn          hsUseProgram          = nullptr;
+GetLocationFn         hsGetUniformLocation  = nullptr;
+GetLocationFn         hsGetAttribLocation   = nullptr;
+Uniform1fFn           hsUniform1f           = nullptr;
+Uniform1iFn           hsUniform1i           = nullptr;
+Uniform2fFn           hsUniform2f           = nullptr;
+AttribArrayFn         hsEnableVertexAttribArray  = nullptr;
+AttribArrayFn         hsDisableVertexAttribArray = nullptr;
+VertexAttribPointerFn hsVertexAttribPointer = nullptr;
+ActiveTextureFn       hsActiveTexture       = nullptr;
+
+template <typename Fn>
+bool loadProc(Fn& fn, const char* name) {
+    fn = reinterpret_cast<Fn>(glfwGetProcAddress(name));
+    return fn != nullptr;
+}
+
+// Lit like the fixed-function path (ambient 0.3 + diffuse from light 0).
+// A row of the texture is one slice: red holds the temperature, green 1
+// where the slice has a history. Slices without one are drawn grey.
+const char* kPlaybackVertexShader =
+    "#version 120\n"
+    "attribute float sliceCoord;\n"
+    "uniform float sliceCount;\n"
+    "varying float row;\n"
+    "varying float shade;\n"
+    "void main() {\n"
+    "    vec4 eye = gl_ModelViewMatrix * gl_Vertex;\n"
+    "    vec3 n = normalize(gl_NormalMatrix * gl_Normal);\n"
+    "    vec3 l = normalize(gl_LightSource[0].position.xyz - eye.xyz);\n"
+    "    shade = 0.3 + 0.7 * max(dot(n, l), 0.0);\n"
+    "    row = (sliceCoord + 0.5) / sliceCount;\n"
+    "    gl_Position = ftransform();\n"
+    "}\n";
+
+const char* kPlaybackFragmentShader =
+    "#version 120\n"
+    "uniform sampler2D frames;\n"
+    "uniform float frame;\n"
+    "uniform vec2 range;\n"
+    "varying float row;\n"
+    "varying float shade;\n"
+    "void main() {\n"
+    "    vec2 texel = texture2D(frames, vec2(frame, row)).rg;\n"
+    "    float t = clamp((texel.r - range.x) / (range.y - range.x), 0.0, 1.0);\n"
+    "    vec3 color = texel.g > 0.5 ? vec3(t, 0.0, 1.0 - t) : vec3(0.5);\n"
+    "    gl_FragColor = vec4(color * shade, 1.0);\n"
+    "}\n";
+
+GLuint compileShader(GLenum type, const char* source) {
+    GLuint shader = hsCreateShader(type);
+    hsShaderSource(shader, 1, &source, nullptr);
+    hsCompileShader(shader);
+    GLint ok = 0;
+    hsGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+    if (!ok) {
+        hsDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+} // namespace
+
+MeshRenderer::MeshRenderer()
+    : vertexCount_(0), meshRevision_(-1), haveColors_(false), colorTag_(-1),
+      colorVersion_(0), colorParam_(0), functionsLoaded_(false), useVbo_(false),
+      positionBuffer_(0), normalBuffer_(0), colorBuffer_(0), programTried_(false), program_(0),
+      sliceAttribute_(-1), frameUniform_(-1), maxTextureSize_(0), sliceBuffer_(0), sliceRevision_(-1),
+      sliceCount_(0), framesTexture_(0), framesTag_(-1), framesVersion_(0), framesCount_(0) {}
+
+// GL objects can only be freed with a current context, see release()
+MeshRenderer::~MeshRenderer() {}
+
+bool MeshRenderer::loadFunctions() {
+    if (!functionsLoaded_) {
+        functionsLoaded_ = true;
+        hsGenBuffers    = reinterpret_cast<GenBuffersFn>(glfwGetProcAddress("glGenBuffers"));
+        hsDeleteBuffers = reinterpret_cast<DeleteBuffersFn>(glfwGetProcAddress("glDeleteBuffers"));
+        hsBindBuffer    = reinterpret_cast<BindBufferFn>(glfwGetProcAddress("glBindBuffer"));
+        hsBufferData    = reinterpret_cast<BufferDataFn>(glfwGetProcAddress("glBufferData"));
+        useVbo_ = hsGenBuffers && hsDeleteBuffers && hsBindBuffer && hsBufferData;
+    }
+    return useVbo_;
+}
+
+void MeshRenderer::upload(unsigned int& buffer, const std::vector<float>& data, bool dynamic) {
+    if (!useVbo_) return;
+    if (buffer == 0) hsGenBuffers(1, &buffer);
+    hsBindBuffer(GL_ARRAY_BUFFER, buffer);
+    hsBufferData(GL_ARRAY_BUFFER, static_cast<std::ptrdiff_t>(data.size() * sizeof(float)),
+                 data.data(), dynamic ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
+    hsBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void MeshRenderer::ensureMesh(const MeshHandler& mesh, int revision) {
+    if (revision == meshRevision_) return;
+    meshRevision_ = revision;
+    loadFunctions();
+
+    const auto& vertices = mesh.getVertices();
+    const auto& faces = mesh.getFaces();
+    positions_.clear();
+    normals_.clear();
+    positions_.reserve(faces.size() * 9);
+    normals_.reserve(faces.size() * 9);
+
+    for (const auto& face : faces) {
+        // Swap Y and Z so Z is the vertical axis (as drawVertexWithYZSwap)
+        float p[3][3];
+        for (int k = 0; k < 3; ++k) {
+            const auto& v = vertices[face[k]];
+            p[k][0] = v[0];
+            p[k][1] = v[2];
+            p[k][2] = v[1];
+        }
+        double ux = p[1][0] - p[0][0], uy = p[1][1] - p[0][1], uz = p[1][2] - p[0][2];
+        double vx = p[2][0] - p[0][0], vy = p[2][1] - p[0][1], vz = p[2][2] - p[0][2];
+        double nx = uy * vz - uz * vy;
+        double ny = uz * vx - ux * vz;
+        double nz = ux * vy - uy * vx;
+        double len = std::sqrt(nx * nx + ny * ny + nz * nz);
+        if (len > 0) { nx /= len; ny /= len; nz /= len; }
+
+        for (int k = 0; k < 3; ++k) {
+            positions_.insert(positions_.end(), { p[k][0], p[k][1], p[k][2] });
+            normals_.insert(normals_.end(), { float(nx), float(ny), float(nz) });
+        }
+    }
+    vertexCount_ = static_cast<int>(faces.size() * 3);
+
+    upload(positionBuffer_, positions_, false);
+    upload(normalBuffer_, normals_, false);
+    if (useVbo_) {
+        // The GPU copy is authoritative; drop the CPU arrays
+        std::vector<float>().swap(positions_);
+        std::vector<float>().swap(normals_);
+    }
+    haveColors_ = false; // Old colors belong to the old mesh
+    sliceRevision_ = -1;
+}
+
+bool MeshRenderer::colorsMatch(int tag, unsigned long version, int param) const {
+    return haveColors_ && tag == colorTag_ && version == colorVersion_ && param == colorParam_;
+}
+
+void MeshRenderer::setFaceColors(const std::vector<std::array<float, 3>>& faceColors,
+                                 int tag, unsigned long version, int param) {
+    if (static_cast<int>(faceColors.size() * 3) != vertexCount_) return;
+    colors_.resize(faceColors.size() * 9);
+    float* out = colors_.data();
+    for (const auto& c : faceColors) {
+        for (int k = 0; k < 3; ++k) {
+            *out++ = c[0];
+            *out++ = c[1];
+            *out++ = c[2];
+        }
+    }
+    upload(colorBuffer_, colors_, true);
+    haveColors_ = true;
+    colorTag_ = tag;
+    colorVersion_ = version;
+    colorParam_ = param;
+}
+
+void MeshRenderer::draw(bool colors) const {
+    if (vertexCount_ == 0) return;
+    bool withColors = colors && haveColors_;
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_NORMAL_ARRAY);
+    if (withColors) glEnableClientState(GL_COLOR_ARRAY);
+
+    if (useVbo_) {
+        hsBindBuffer(GL_ARRAY_BUFFER, positionBuffer_);
+        glVertexPointer(3, GL_FLOAT, 0, nullptr);
+        hsBindBuffer(GL_ARRAY_BUFFER, normalBuffer_);
+        glNormalPointer(GL_FLOAT, 0, nullptr);
+        if (withColors) {
+            hsBindBuffer(GL_ARRAY_BUFFER, colorBuffer_);
+            glColorPointer(3, GL_FLOAT, 0, nullptr);
+        }
+        hsBindBuffer(GL_ARRAY_BUFFER, 0);
+    } else {
+        glVertexPointer(3, GL_FLOAT, 0, positions_.data());
+        glNormalPointer(GL_FLOAT, 0, normals_.data());
+        if (withColors) glColorPointer(3, GL_FLOAT, 0, colors_.data());
+    }
+
+    glDrawArrays(GL_TRIANGLES, 0, vertexCount_);
+
+    if (withColors) glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_NORMAL_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+}
+
+bool MeshRenderer::buildProgram() {
+    bool loaded = loadProc(hsCreateShader, "glCreateShader") && loadProc(hsShaderSource, "glShaderSource")
+        && loadProc(hsCompileShader, "glCompileShader") && loadProc(hsGetShaderiv, "glGetShaderiv")
+        && loadProc(hsDeleteShader, "glDeleteShader") && loadProc(hsCreateProgram, "glCreateProgram")
+        && loadProc(hsAttachShader, "glAttachShader") && loadProc(hsLinkProgram, "glLinkProgram")
+        && loadProc(hsGetProgramiv, "glGetProgramiv") && loadProc(hsDeleteProgram, "glDeleteProgram")
+        && loadProc(hsUseProgram, "glUseProgram")
+        && loadProc(hsGetUniformLocation, "glGetUniformLocation")
+        && loadProc(hsGetAttribLocation, "glGetAttribLocation")
+        && loadProc(hsUniform1f, "glUniform1f") && loadProc(hsUniform1i, "glUniform1i")
+        && loadProc(hsUniform2f, "glUniform2f")
+        && loadProc(hsEnableVertexAttribArray, "glEnableVertexAttribArray")
+        && loadProc(hsDisableVertexAttribArray, "glDisableVertexAttribArray")
+        && loadProc(hsVertexAttribPointer, "glVertexAttribPointer")
+        && loadProc(hsActiveTexture, "glActiveTexture");
+    if (!loaded) return false;
+
+    GLuint vs = compileShader(GL_VERTEX_SHADER, kPlaybackVertexShader);
+    GLuint fs = compileShader(GL_FRAGMENT_SHADER, kPlaybackFragmentShader);
+    if (vs && fs) {
+        program_ = hsCreateProgram();
+        hsAttachShader(program_, vs);
+        hsAttachShader(program_, fs);
+        hsLinkProgram(program_);
+        GLint ok = 0;
+        hsGetProgramiv(program_, GL_LINK_STATUS, &ok);
+        if (!ok) {
+            hsDeleteProgram(program_);
+            program_ = 0;
+        }
+    }
+    if (vs) hsDeleteShader(vs); // Freed with the program
+    if (fs) hsDeleteShader(fs);
+    if (program_ == 0) return false;
+
+    sliceAttribute_ = hsGetAttribLocation(program_, "sliceCoord");
+    frameUniform_ = hsGetUniformLocation(program_, "frame");
+    hsUseProgram(program_);
+    hsUniform1i(hsGetUniformLocation(program_, "frames"), 0);
+    hsUseProgram(0);
+    GLint maxSize = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+    maxTextureSize_ = maxSize;
+    return sliceAttribute_ >= 0;
+}
+
+bool MeshRenderer::supportsPlayback() {
+    if (!programTried_) {
+        programTried_ = true;
+        if (loadFunctions() && !buildProgram() && program_ != 0) {
+            hsDeleteProgram(program_);
+            program_ = 0;
+        }
+    }
+    return program_ != 0;
+}
+
+bool MeshRenderer::faceSlicesMatch(int revision, int nSlices) const {
+    return revision == sliceRevision_ && nSlices == sliceCount_;
+}
+
+void MeshRenderer::setFaceSlices(const std::vector<int>& faceSlices, int revision, int nSlices) {
+    if (!useVbo_ || static_cast<int>(faceSlices.size() * 3) != vertexCount_) return;
+    std::vector<float> coords;
+    coords.reserve(faceSlices.size() * 3);
+    for (int slice : faceSlices) coords.insert(coords.end(), 3, static_cast<float>(slice));
+    upload(sliceBuffer_, coords, false);
+    sliceRevision_ = revision;
+    sliceCount_ = nSlices;
+}
+
+bool MeshRenderer::playbackFramesMatch(int tag, unsigned long version) const {
+    return tag == framesTag_ && version == framesVersion_;
+}
+
+bool MeshRenderer::setPlaybackFrames(const PlaybackFrames& frames, double minTemp, double maxTemp,
+                                     int tag, unsigned long version) {
+    framesTag_ = tag;
+    framesVersion_ = version;
+    framesCount_ = 0;
+    if (program_ == 0 || frames.empty()) return false;
+    if (frames.nFrames > maxTextureSize_ || frames.nSlices > maxTextureSize_) return false;
+
+    // Interleave (temperature, valid) per texel
+    std::vector<float> texels(frames.values.size() * 2);
+    for (int s = 0; s < frames.nSlices; ++s) {
+        float valid = frames.valid[s] ? 1.0f : 0.0f;
+        for (int f = 0; f < frames.nFrames; ++f) {
+            size_t i = static_cast<size_t>(s) * frames.nFrames + f;
+            texels[2 * i] = frames.values[i];
+            texels[2 * i + 1] = valid;
+        }
+    }
+
+    if (framesTexture_ == 0) glGenTextures(1, &framesTexture_);
+    glBindTexture(GL_TEXTURE_2D, framesTexture_);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    while (glGetError() != GL_NO_ERROR) {}
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RG32F, frames.nFrames, frames.nSlices, 0, GL_RG, GL_FLOAT, texels.data());
+    bool ok = glGetError() == GL_NO_ERROR;
+    glBindTexture(GL_TEXTURE_2D, 0);
+    if (!ok) return false;
+
+    double span = maxTemp > minTemp ? maxTemp - minTemp : 1.0;
+    hsUseProgram(program_);
+    hsUniform1f(hsGetUniformLocation(program_, "sliceCount"), static_cast<float>(frames.nSlices));
+    hsUniform2f(hsGetUniformLocation(program_, "range"), static_cast<float>(minTemp),
+                static_cast<float>(minTemp + span));
+    hsUseProgram(0);
+    framesCount_ = frames.nFrames;
+    return true;
+}
+
+void MeshRenderer::drawPlayback(double frame) const {
+    if (vertexCount_ == 0 || program_ == 0 || framesCount_ == 0 || sliceBuffer_ == 0) return;
+
+    hsUseProgram(program_);
+    // Texel centers, so the linear filter interpolates between frames
+    hsUniform1f(frameUniform_, static_cast<float>((frame + 0.5) / framesCount_));
+    hsActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, framesTexture_);
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_NORMAL_ARRAY);
+    hsEnableVertexAttribArray(static_cast<GLuint>(sliceAttribute_));
+    hsBindBuffer(GL_ARRAY_BUFFER, positionBuffer_);
+    glVertexPointer(3, GL_FLOAT, 0, nullptr);
+    hsBindBuffer(GL_ARRAY_BUFFER, normalBuffer_);
+    glNormalPointer(GL_FLOAT, 0, nullptr);
+    hsBindBuffer(GL_ARRAY_BUFFER, sliceBuffer_);
+    hsVertexAttribPointer(static_cast<GLuint>(sliceAttribute_), 1, GL_FLOAT, GL_FALSE, 0, nullptr);
+    hsBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glDrawArrays(GL_TRIANGLES, 0, vertexCount_);
+
+    hsDisableVertexAttribArray(static_cast<GLuint>(sliceAttribute_));
+    glDisableClientState(GL_NORMAL_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    hsUseProgram(0);
+}
+
+void MeshRenderer::release() {
+    if (useVbo_) {
+        GLuint buffers[4] = { positionBuffer_, normalBuffer_, colorBuffer_, sliceBuffer_ };
+        hsDeleteBuffers(4, buffers);
+    }
+    if (framesTexture_) glDeleteTextures(1, &framesTexture_);
+    if (program_) hsDeleteProgram(program_);
+    positionBuffer_ = normalBuffer_ = colorBuffer_ = sliceBuffer_ = 0;
+    framesTexture_ = 0;
+    program_ = 0;
+    programTried_ = false;
+    vertexCount_ = 0;
+    meshRevision_ = -1;
+    haveColors_ = false;
+    sliceRevision_ = -1;
+    framesTag_ = -1;
+    framesCount_ = 0;
+}
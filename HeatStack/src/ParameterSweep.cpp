@@ -0,0 +1,261 @@
+#include "ParameterSweep.h"
+#include "MeshHandler.h"
+#include "MaterialProperties.h"
+#include "InitialTemperature.h"
+#include "HeatEquationSolver.h"
+#include "SliceRun.h"
+#include "SliceScheduler.h"
+#include "SimulationCache.h"
+#include "Json.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+double asNumber(const JsonValue& v, const std::string& key, const std::string& context = "Sweep manifest") {
+    if (v.type != JsonValue::Type::Number) throw std::runtime_error(context + ": '" + key + "' must be a number");
+    return v.number;
+}
+
+std::string asString(const JsonValue& v, const std::string& key) {
+    if (v.type != JsonValue::Type::String) throw std::runtime_error("Sweep manifest: '" + key + "' must be a string");
+    return v.string;
+}
+
+// Set one config field from a manifest value
+void applyConfigKey(SweepConfig& config, const std::string& key, const JsonValue& v) {
+    if (!setSweepConfigKey(config, key, v, "Sweep manifest")) {
+        throw std::runtime_error("Sweep manifest: unknown config key '" + key + "'");
+    }
+}
+
+} // namespace
+
+bool setSweepConfigKey(SweepConfig& config, const std::string& key, const JsonValue& v,
+                       const std::string& context) {
+    if (key == "dt")                 config.dt = asNumber(v, key, context);
+    else if (key == "theta")         config.theta = asNumber(v, key, context);
+    else if (key == "points")        config.pointsPerLayer = static_cast<int>(asNumber(v, key, context));
+    else if (key == "time")          config.duration = asNumber(v, key, context);
+    else if (key == "maxSteelTemp")  config.maxSteelTemp = asNumber(v, key, context);
+    else if (key == "maxGlueTemp")   config.maxGlueTemp = asNumber(v, key, context);
+    else if (key == "maxCarbonTemp") config.maxCarbonTemp = asNumber(v, key, context);
+    else if (key == "adaptive") {
+        if (v.type != JsonValue::Type::Bool) throw std::runtime_error(context + ": 'adaptive' must be true or false");
+        config.adaptive = v.boolean;
+    }
+    else return false;
+    return true;
+}
+
+SweepManifest SweepManifest::parse(const std::string& json, const SweepManifest& defaults) {
+    JsonValue root = parseJson(json, "Sweep manifest");
+    if (root.type != JsonValue::Type::Object) throw std::runtime_error("Sweep manifest: top level must be an object");
+
+    SweepManifest manifest = defaults;
+    SweepConfig base = defaults.configs.empty() ? SweepConfig() : defaults.configs[0];
+    const JsonValue* sweep = nullptr;
+    for (const auto& entry : root.object) {
+        const std::string& key = entry.first;
+        const JsonValue& v = entry.second;
+        if (key == "mesh")        manifest.meshFile = asString(v, key);
+        else if (key == "init")   manifest.initFile = asString(v, key);
+        else if (key == "output") manifest.outputFile = asString(v, key);
+        else if (key == "slices") manifest.nSlices = static_cast<int>(asNumber(v, key));
+        else if (key == "base") {
+            if (v.type != JsonValue::Type::Object) throw std::runtime_error("Sweep manifest: 'base' must be an object");
+            for (const auto& field : v.object) applyConfigKey(base, field.first, field.second);
+        }
+        else if (key == "sweep") {
+            if (v.type != JsonValue::Type::Object) throw std::runtime_error("Sweep manifest: 'sweep' must be an object");
+            sweep = &v;
+        }
+        else throw std::runtime_error("Sweep manifest: unknown key '" + key + "'");
+    }
+    if (manifest.nSlices < 2) throw std::runtime_error("Sweep manifest: 'slices' must be at least 2");
+
+    // Cartesian product of the swept lists; the last key varies fastest
+    manifest.configs.assign(1, base);
+    if (sweep) {
+        for (const auto& axis : sweep->object) {
+            if (axis.second.type != JsonValue::Type::Array || axis.second.array.empty()) {
+                throw std::runtime_error("Sweep manifest: sweep '" + axis.first + "' must be a non-empty list");
+            }
+            std::vector<SweepConfig> expanded;
+            expanded.reserve(manifest.configs.size() * axis.second.array.size());
+            for (const auto& config : manifest.configs) {
+                for (const auto& value : axis.second.array) {
+                    SweepConfig c = config;
+                    applyConfigKey(c, axis.first, value);
+                    expanded.push_back(c);
+                }
+            }
+            manifest.configs.swap(expanded);
+        }
+    }
+    for (const auto& c : manifest.configs) {
+        if (c.dt <= 0.0 || c.duration <= 0.0 || c.pointsPerLayer < 2) {
+            throw std::runtime_error("Sweep manifest: configs need dt > 0, time > 0 and points >= 2");
+        }
+    }
+    return manifest;
+}
+
+SweepManifest SweepManifest::load(const std::string& path, const SweepManifest& defaults) {
+    std::ifstream in(path);
+    if (!in.is_open()) throw std::runtime_error("Cannot open sweep manifest: " + path);
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    return parse(buffer.str(), defaults);
+}
+
+ParameterSweep::ParameterSweep(const SweepManifest& manifest, const SweepOptions& options)
+    : manifest_(manifest), options_(options),
+      numThreads_(options.scheduler ? options.scheduler->getNumThreads()
+                                    : SliceScheduler(options.numThreads).getNumThreads()) {}
+
+int ParameterSweep::getNumThreads() const {
+    return numThreads_;
+}
+
+std::vector<SweepRow> ParameterSweep::run() {
+    // ---- Shared inputs, loaded once for every config ----
+    double zmin = options_.zMin, height = options_.zMax - options_.zMin;
+    if (!options_.hasZRange) {
+        MeshHandler ownMesh;
+        const MeshHandler* mesh = options_.mesh;
+        if (!mesh) {
+            if (!ownMesh.loadMesh(manifest_.meshFile)) {
+                throw std::runtime_error("Cannot load mesh " + manifest_.meshFile);
+            }
+            mesh = &ownMesh;
+        }
+        zmin = mesh->getMinZ();
+        height = mesh->getMaxZ() - zmin;
+    }
+
+    std::vector<double> uniformInit;
+    if (!manifest_.initFile.empty() || options_.initialTemperature) {
+        if (options_.grid.spacing == GridSpacing::Clustered) {
+            throw std::runtime_error("An initial temperature profile needs the uniform grid");
+        }
+        if (options_.initialTemperature) {
+            uniformInit = *options_.initialTemperature;
+        } else {
+            InitialTemperature initTemp;
+            uniformInit = initTemp.loadInitialTemperature(manifest_.initFile);
+        }
+    }
+
+    const int nSlices = manifest_.nSlices;
+    std::vector<int> slices; // 0-based
+    for (int slice : options_.slices) {
+        if (slice < 1 || slice > nSlices) {
+            throw std::runtime_error("Slice " + std::to_string(slice) + " is not in 1.." + std::to_string(nSlices));
+        }
+        slices.push_back(slice - 1);
+    }
+    if (slices.empty()) {
+        for (int slice = 0; slice < nSlices; ++slice) slices.push_back(slice);
+    }
+    const int perConfig = static_cast<int>(slices.size());
+    const int nJobs = static_cast<int>(manifest_.configs.size()) * perConfig;
+    std::vector<SweepRow> rows(nJobs);
+
+    // Job j is slices[j % perConfig] of config (j / perConfig)
+    auto runJob = [&](int job) {
+        const SweepConfig& cfg = manifest_.configs[job / perConfig];
+        const int slice = slices[job % perConfig];
+        SweepRow& row = rows[job];
+        row.config = job / perConfig;
+        row.slice = slice + 1;
+
+        SliceSettings settings;
+        settings.dt             = cfg.dt;
+        settings.theta          = cfg.theta;
+        settings.duration       = cfg.duration;
+        settings.adaptive       = cfg.adaptive;
+        settings.pointsPerLayer = cfg.pointsPerLayer;
+        settings.steps.adaptiveTolerance = options_.adaptiveTolerance;
+        settings.steps.minTimeStep       = options_.minTimeStep;
+        settings.steps.maxTimeStep       = options_.maxTimeStep;
+        settings.steps.steadyStateRate   = options_.steadyStateTol;
+        settings.grid           = options_.grid;
+        settings.grid.timeStep  = cfg.dt;
+        if (!uniformInit.empty()) settings.initialTemperature = &uniformInit;
+        settings.searchWays     = options_.searchWays;
+        settings.searchThreads  = SliceScheduler::nestedThreads(numThreads_);
+        settings.precision      = options_.precision;
+        settings.method         = options_.method;
+        settings.cache          = options_.cache;
+        settings.surrogate      = options_.surrogate;
+
+        double z = zmin + (double(slice)/(nSlices-1)) * height;
+        double lL = (z - zmin) / height;
+        row.lL = lL;
+
+        SliceRun run(settings, slice + 1, lL);
+        row.originalTPS = run.getStack().layers[0].thickness;
+
+        // Same transient run as the CLI, for the current stack
+        auto simulate = [&](double& carbon, double& glue, double& steel) {
+            HeatEquationSolver solver(cfg.theta);
+            run.setUp(solver);
+            InterfaceTemperatures temps = run.transient(solver);
+            carbon = temps.carbonGlue;
+            glue = temps.glueSteel;
+            steel = temps.steel;
+        };
+
+        simulate(row.preCarbonTemp, row.preGlueTemp, row.preSteelTemp);
+        if (!options_.searchTPS) {
+            row.optimizedTPS = row.originalTPS;
+            row.postCarbonTemp = row.preCarbonTemp;
+            row.postGlueTemp = row.preGlueTemp;
+            row.postSteelTemp = row.preSteelTemp;
+            return;
+        }
+
+        InterfaceTemperatures limits;
+        limits.carbonGlue = cfg.maxCarbonTemp;
+        limits.glueSteel  = cfg.maxGlueTemp;
+        limits.steel      = cfg.maxSteelTemp;
+        row.optimizedTPS = run.suggestThickness(limits);
+
+        run.setTPSThickness(row.optimizedTPS);
+        simulate(row.postCarbonTemp, row.postGlueTemp, row.postSteelTemp);
+    };
+
+    if (options_.scheduler) {
+        options_.scheduler->run(nJobs, runJob);
+    } else {
+        SliceScheduler scheduler(options_.numThreads);
+        scheduler.run(nJobs, runJob);
+    }
+    return rows;
+}
+
+bool ParameterSweep::writeTable(const std::string& path, const std::vector<SweepRow>& rows) const {
+    std::ofstream out(path);
+    if (!out) return false;
+    out << "config,dt,theta,points,time,adaptive,maxSteelTemp,maxGlueTemp,maxCarbonTemp,"
+        << "slice,l/L,OriginalTPS,OptimizedTPS,"
+        << "PreCarbonTemp,PreGlueTemp,PreSteelTemp,"
+        << "PostCarbonTemp,PostGlueTemp,PostSteelTemp\n";
+    for (const auto& r : rows) {
+        const SweepConfig& c = manifest_.configs[r.config];
+        out << r.config << ","
+            << c.dt << "," << c.theta << "," << c.pointsPerLayer << "," << c.duration << ","
+            << (c.adaptive ? 1 : 0) << ","
+            << c.maxSteelTemp << "," << c.maxGlueTemp << "," << c.maxCarbonTemp << ","
+            << r.slice << "," << r.lL << ","
+            << r.originalTPS << "," << r.optimizedTPS << ","
+            << r.preCarbonTemp << "," << r.preGlueTemp << "," << r.preSteelTemp << ","
+            << r.postCarbonTemp << "," << r.postGlueTemp << "," << r.postSteelTemp << "\n";
+    }
+    return static_cast<bool>(out);
+}
@@ -0,0 +1,97 @@
+#include "PlaybackFrames.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const std::vector<double>& column(const SliceHistory& h, HistoryField field) {
+    switch (field) {
+    case HistoryField::CarbonGlue: return h.carbonGlueTemp;
+    case HistoryField::GlueSteel:  return h.glueSteelTemp;
+    default:                       return h.steelTemp;
+    }
+}
+
+} // namespace
+
+double PlaybackFrames::frameOf(double time) const {
+    if (nFrames < 2 || !(endTime > startTime)) return 0.0;
+    double f = (time - startTime) / (endTime - startTime) * (nFrames - 1);
+    return std::clamp(f, 0.0, static_cast<double>(nFrames - 1));
+}
+
+double PlaybackFrames::sample(int slice, double time) const {
+    if (empty() || slice < 0 || slice >= nSlices) return 0.0;
+    const float* row = &values[static_cast<size_t>(slice) * nFrames];
+    double f = frameOf(time);
+    int i = static_cast<int>(f);
+    if (i >= nFrames - 1) return row[nFrames - 1];
+    double w = f - i;
+    return row[i] * (1.0 - w) + row[i + 1] * w;
+}
+
+PlaybackFrames PlaybackFrames::build(const std::vector<std::shared_ptr<const SliceResult>>& results,
+                                     int nSlices, HistoryField field, bool optimized, int maxFrames) {
+    PlaybackFrames frames;
+    if (nSlices <= 0) return frames;
+
+    // History of each slice row
+    std::vector<const SliceHistory*> histories(nSlices, nullptr);
+    size_t longest = 0;
+    bool any = false;
+    for (const auto& result : results) {
+        int s = result->slice - 1;
+        if (s < 0 || s >= nSlices) continue;
+        const SliceHistory* h = (optimized && !result->optHistory.empty()) ? &result->optHistory
+                                                                          : &result->origHistory;
+        if (h->empty()) continue;
+        histories[s] = h;
+        longest = std::max(longest, h->time.size());
+        frames.startTime = any ? std::min(frames.startTime, h->time.front()) : h->time.front();
+        frames.endTime = any ? std::max(frames.endTime, h->time.back()) : h->time.back();
+        any = true;
+    }
+    if (!any) return frames;
+
+    frames.nSlices = nSlices;
+    frames.nFrames = static_cast<int>(std::min<size_t>(longest, static_cast<size_t>(std::max(maxFrames, 1))));
+    if (!(frames.endTime > frames.startTime)) frames.nFrames = 1;
+    frames.values.assign(static_cast<size_t>(nSlices) * frames.nFrames, 0.0f);
+    frames.valid.assign(nSlices, 0);
+
+    const double step = frames.frameStep();
+    bool haveRange = false;
+    for (int s = 0; s < nSlices; ++s) {
+        if (!histories[s]) continue;
+        const std::vector<double>& t = histories[s]->time;
+        const std::vector<double>& v = column(*histories[s], field);
+        const size_t n = std::min(t.size(), v.size());
+        if (n == 0) continue;
+        frames.valid[s] = 1;
+
+        // Frame times increase, so one pass over the rows
+        float* row = &frames.values[static_cast<size_t>(s) * frames.nFrames];
+        size_t k = 0;
+        for (int f = 0; f < frames.nFrames; ++f) {
+            double time = frames.startTime + f * step;
+            while (k + 1 < n && t[k + 1] <= time) ++k;
+            double value;
+            if (time <= t[0]) {
+                value = v[0];
+            } else if (k + 1 >= n) {
+                value = v[n - 1];
+            } else {
+                double span = t[k + 1] - t[k];
+                double w = span > 0.0 ? (time - t[k]) / span : 1.0;
+                value = v[k] * (1.0 - w) + v[k + 1] * w;
+            }
+            row[f] = static_cast<float>(value);
+        }
+        for (size_t i = 0; i < n; ++i) {
+            frames.minTemp = haveRange ? std::min(frames.minTemp, v[i]) : v[i];
+            frames.maxTemp = haveRange ? std::max(frames.maxTemp, v[i]) : v[i];
+            haveRange = true;
+        }
+    }
+    return frames;
+}
@@ -0,0 +1,192 @@
+#include "Profiler.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+using TimePoint = std::chrono::steady_clock::time_point;
+
+struct ZoneEvent {
+    const char* name;
+    int slice;
+    TimePoint start;
+    TimePoint end;
+};
+
+// Written only by its own thread; read by summary/export between runs
+struct ThreadBuffer {
+    int id = 0;
+    std::vector<ZoneEvent> events;
+    unsigned long long counters[static_cast<int>(ProfileCounter::Count)] = {};
+};
+
+const char* counterNames[] = { "solver steps", "matrix solves", "search iterations", "trial runs",
+                               "early stops" };
+
+std::mutex registryMutex;
+std::vector<std::shared_ptr<ThreadBuffer>> buffers; // shared: buffers outlive their threads
+TimePoint epoch = std::chrono::steady_clock::now();
+
+ThreadBuffer& localBuffer() {
+    thread_local std::shared_ptr<ThreadBuffer> buffer;
+    if (!buffer) {
+        buffer = std::make_shared<ThreadBuffer>();
+        buffer->events.reserve(1024);
+        std::lock_guard<std::mutex> lock(registryMutex);
+        buffer->id = static_cast<int>(buffers.size());
+        buffers.push_back(buffer);
+    }
+    return *buffer;
+}
+
+double toMicros(TimePoint t) {
+    return std::chrono::duration<double, std::micro>(t - epoch).count();
+}
+
+double toMillis(TimePoint a, TimePoint b) {
+    return std::chrono::duration<double, std::milli>(b - a).count();
+}
+
+std::string jsonEscape(const char* s) {
+    std::string out;
+    for (; *s; ++s) {
+        if (*s == '"' || *s == '\\') out += '\\';
+        out += *s;
+    }
+    return out;
+}
+
+// Wall time covered by at least one zone (nested zones counted once)
+double busyMillis(std::vector<ZoneEvent> events) {
+    std::sort(events.begin(), events.end(),
+              [](const ZoneEvent& a, const ZoneEvent& b) { return a.start < b.start; });
+    double total = 0.0;
+    size_t i = 0;
+    while (i < events.size()) {
+        TimePoint begin = events[i].start, end = events[i].end;
+        for (++i; i < events.size() && events[i].start <= end; ++i) {
+            end = std::max(end, events[i].end);
+        }
+        total += toMillis(begin, end);
+    }
+    return total;
+}
+
+} // namespace
+
+std::atomic<bool> Profiler::enabled_(false);
+
+void Profiler::enable(bool on) {
+    enabled_.store(on);
+}
+
+void Profiler::reset() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (auto& b : buffers) {
+        b->events.clear();
+        std::fill(std::begin(b->counters), std::end(b->counters), 0ULL);
+    }
+    epoch = std::chrono::steady_clock::now();
+}
+
+void Profiler::record(const char* name, int slice, TimePoint start, TimePoint end) {
+    localBuffer().events.push_back({ name, slice, start, end });
+}
+
+void Profiler::addCount(ProfileCounter counter, unsigned long long n) {
+    localBuffer().counters[static_cast<int>(counter)] += n;
+}
+
+std::string Profiler::summary() {
+    struct ZoneTotal { size_t calls = 0; double totalMs = 0.0; double maxMs = 0.0; };
+    std::map<std::string, ZoneTotal> zones;
+    unsigned long long totals[static_cast<int>(ProfileCounter::Count)] = {};
+    std::ostringstream threads;
+    char line[160];
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (const auto& b : buffers) {
+        if (b->events.empty()) {
+            bool any = false;
+            for (auto c : b->counters) any = any || c != 0;
+            if (!any) continue;
+        }
+        for (const auto& e : b->events) {
+            ZoneTotal& z = zones[e.name];
+            double ms = toMillis(e.start, e.end);
+            z.calls++;
+            z.totalMs += ms;
+            z.maxMs = std::max(z.maxMs, ms);
+        }
+        std::snprintf(line, sizeof(line), "thread %-3d %8zu zones  busy %10.2f ms ",
+                      b->id, b->events.size(), busyMillis(b->events));
+        threads << line;
+        for (int c = 0; c < static_cast<int>(ProfileCounter::Count); ++c) {
+            totals[c] += b->counters[c];
+            threads << " " << counterNames[c] << "=" << b->counters[c];
+        }
+        threads << "\n";
+    }
+
+    std::ostringstream out;
+    std::snprintf(line, sizeof(line), "%-28s %8s %12s %12s\n", "zone", "calls", "total ms", "max ms");
+    out << line;
+    for (const auto& z : zones) {
+        std::snprintf(line, sizeof(line), "%-28s %8zu %12.2f %12.2f\n",
+                      z.first.c_str(), z.second.calls, z.second.totalMs, z.second.maxMs);
+        out << line;
+    }
+    out << threads.str();
+    for (int c = 0; c < static_cast<int>(ProfileCounter::Count); ++c) {
+        out << (c ? ", " : "Counters: ") << counterNames[c] << " " << totals[c];
+    }
+    out << "\n";
+    return out.str();
+}
+
+bool Profiler::writeChromeTrace(const std::string& path) {
+    std::ofstream out(path);
+    if (!out) return false;
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    char buf[64];
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    auto sep = [&]() { if (!first) out << ",\n"; first = false; };
+
+    for (const auto& b : buffers) {
+        sep();
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << b->id
+            << ",\"args\":{\"name\":\"worker " << b->id << "\"}}";
+
+        TimePoint last = epoch;
+        for (const auto& e : b->events) {
+            sep();
+            std::snprintf(buf, sizeof(buf), "%.3f", toMicros(e.start));
+            out << "{\"name\":\"" << jsonEscape(e.name) << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << b->id
+                << ",\"ts\":" << buf;
+            std::snprintf(buf, sizeof(buf), "%.3f", std::chrono::duration<double, std::micro>(e.end - e.start).count());
+            out << ",\"dur\":" << buf;
+            if (e.slice >= 0) out << ",\"args\":{\"slice\":" << (e.slice + 1) << "}";
+            out << "}";
+            last = std::max(last, e.end);
+        }
+
+        // Counter totals as one sample at the end of the thread's activity
+        sep();
+        std::snprintf(buf, sizeof(buf), "%.3f", toMicros(last));
+        out << "{\"name\":\"counters\",\"ph\":\"C\",\"pid\":1,\"tid\":" << b->id << ",\"ts\":" << buf << ",\"args\":{";
+        for (int c = 0; c < static_cast<int>(ProfileCounter::Count); ++c) {
+            out << (c ? "," : "") << "\"" << counterNames[c] << "\":" << b->counters[c];
+        }
+        out << "}}";
+    }
+    out << "\n]}\n";
+    return static_cast<bool>(out);
+}
@@ -0,0 +1,60 @@
+#include "ResultsStore.h"
+#include <algorithm>
+
+void SliceHistory::append(double t, double carbonGlue, double glueSteel, double steel) {
+    time.push_back(t);
+    carbonGlueTemp.push_back(carbonGlue);
+    glueSteelTemp.push_back(glueSteel);
+    steelTemp.push_back(steel);
+}
+
+ResultsStore::ResultsStore() : version_(0) {}
+
+void ResultsStore::reset(int nSlices) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    slices_.assign(std::max(nSlices, 0), nullptr);
+    ++version_;
+}
+
+void ResultsStore::publish(int index, SliceResult result) {
+    auto shared = std::make_shared<const SliceResult>(std::move(result));
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (index < 0) return;
+    if (static_cast<size_t>(index) >= slices_.size()) slices_.resize(index + 1);
+    slices_[index] = std::move(shared);
+    ++version_;
+}
+
+std::shared_ptr<const SliceResult> ResultsStore::getSlice(int index) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (index < 0 || static_cast<size_t>(index) >= slices_.size()) return nullptr;
+    return slices_[index];
+}
+
+std::vector<std::shared_ptr<const SliceResult>> ResultsStore::getAll() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::shared_ptr<const SliceResult>> all;
+    for (const auto& s : slices_) {
+        if (s) all.push_back(s);
+    }
+    return all;
+}
+
+bool ResultsStore::thicknessRange(double& minThickness, double& maxThickness) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    bool found = false;
+    for (const auto& s : slices_) {
+        if (!s) continue;
+        double t = s->reportedTPS();
+        if (t <= 0) continue;
+        if (!found || t < minThickness) minThickness = t;
+        if (!found || t > maxThickness) maxThickness = t;
+        found = true;
+    }
+    return found;
+}
+
+unsigned long ResultsStore::getVersion() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return version_;
+}
@@ -0,0 +1,190 @@
+#include "SimulationCache.h"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <iostream>
+#include <cstring>
+#include <cstdint>
+#include <functional>
+#include <thread>
+
+namespace {
+
+// Append the bit pattern of a double so the key is exact
+void appendDouble(std::ostringstream& out, double value) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    out << std::hex << std::setw(16) << std::setfill('0') << bits << ';';
+}
+
+// FNV-1a, used only to name the disk files
+std::uint64_t hashKey(const std::string& key) {
+    std::uint64_t h = 1469598103934665603ull;
+    for (unsigned char ch : key) {
+        h ^= ch;
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+} // namespace
+
+double SimulationCache::Stats::hitRate() const {
+    std::size_t total = hits + diskHits + misses;
+    return total ? static_cast<double>(hits + diskHits) / total : 0.0;
+}
+
+SimulationCache::SimulationCache() {}
+
+SimulationCache::SimulationCache(const std::string& diskDirectory) {
+    setDiskDirectory(diskDirectory);
+}
+
+SimulationCache::~SimulationCache() {}
+
+void SimulationCache::setDiskDirectory(const std::string& directory) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    diskDirectory_ = directory;
+    if (!diskDirectory_.empty()) {
+        std::error_code ec;
+        std::filesystem::create_directories(diskDirectory_, ec);
+        if (ec) {
+            std::cerr << "Warning: cannot create cache directory " << diskDirectory_
+                      << ": " << ec.message() << "\n";
+            diskDirectory_.clear();
+        }
+    }
+}
+
+std::string SimulationCache::makeKey(const Stack& stack, int pointsPerLayer, double dt,
+                                     bool adaptive, double theta, double duration,
+                                     double surfaceTemp, bool singlePrecision,
+                                     const GridOptions& grid, const StepOptions& steps) {
+    std::ostringstream out;
+    out << (singlePrecision ? "v1f;" : "v1;") << pointsPerLayer << ';' << (adaptive ? 1 : 0) << ';';
+    appendDouble(out, dt);
+    appendDouble(out, theta);
+    appendDouble(out, duration);
+    appendDouble(out, surfaceTemp);
+    for (const auto& layer : stack.layers) {
+        appendDouble(out, layer.thickness);
+        appendDouble(out, layer.material.k);
+        appendDouble(out, layer.material.rho);
+        appendDouble(out, layer.material.c);
+    }
+    if (grid.spacing == GridSpacing::Clustered) {
+        out << "g;" << grid.minPointsPerLayer << ';' << grid.maxPointsPerLayer << ';';
+        appendDouble(out, grid.timeStep);
+        appendDouble(out, grid.targetFourier);
+        appendDouble(out, grid.stretchRatio);
+    }
+    const StepOptions defaults;
+    if (adaptive && (steps.adaptiveTolerance != defaults.adaptiveTolerance
+                     || steps.minTimeStep > 0.0 || steps.maxTimeStep > 0.0)) {
+        out << "a;";
+        appendDouble(out, steps.adaptiveTolerance);
+        appendDouble(out, steps.minTimeStep);
+        appendDouble(out, steps.maxTimeStep);
+    }
+    if (steps.steadyStateRate > 0.0) {
+        out << "s;";
+        appendDouble(out, steps.steadyStateRate);
+    }
+    return out.str();
+}
+
+bool SimulationCache::lookup(const std::string& key, InterfaceTemperatures& result) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(key);
+        if (it != entries_.end()) {
+            result = it->second;
+            ++stats_.hits;
+            return true;
+        }
+        if (diskDirectory_.empty()) {
+            ++stats_.misses;
+            return false;
+        }
+    }
+
+    // Disk read outside the lock; racing loads of the same key are harmless
+    InterfaceTemperatures loaded;
+    bool found = loadFromDisk(key, loaded);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (found) {
+        entries_[key] = loaded;
+        result = loaded;
+        ++stats_.diskHits;
+    } else {
+        ++stats_.misses;
+    }
+    return found;
+}
+
+void SimulationCache::store(const std::string& key, const InterfaceTemperatures& result) {
+    bool persist;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_[key] = result;
+        persist = !diskDirectory_.empty();
+    }
+    if (persist) saveToDisk(key, result);
+}
+
+SimulationCache::Stats SimulationCache::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+std::size_t SimulationCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+void SimulationCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    stats_ = Stats();
+}
+
+std::string SimulationCache::diskPath(const std::string& key) const {
+    std::ostringstream name;
+    name << std::hex << std::setw(16) << std::setfill('0') << hashKey(key) << ".cache";
+    return (std::filesystem::path(diskDirectory_) / name.str()).string();
+}
+
+bool SimulationCache::loadFromDisk(const std::string& key, InterfaceTemperatures& result) const {
+    std::ifstream in(diskPath(key));
+    if (!in) return false;
+
+    // The full key is stored with the result to rule out hash collisions
+    std::string storedKey;
+    if (!std::getline(in, storedKey) || storedKey != key) return false;
+    InterfaceTemperatures temps;
+    if (!(in >> temps.carbonGlue >> temps.glueSteel >> temps.steel)) return false;
+    result = temps;
+    return true;
+}
+
+void SimulationCache::saveToDisk(const std::string& key, const InterfaceTemperatures& result) const {
+    std::string path = diskPath(key);
+    std::ostringstream tmpName;
+    tmpName << path << "." << std::hash<std::thread::id>()(std::this_thread::get_id()) << ".tmp";
+    std::string tmpPath = tmpName.str();
+    {
+        std::ofstream out(tmpPath);
+        if (!out) {
+            std::cerr << "Warning: cannot write cache entry " << path << "\n";
+            return;
+        }
+        out << key << "\n" << std::setprecision(17)
+            << result.carbonGlue << " " << result.glueSteel << " " << result.steel << "\n";
+    }
+    // Rename so concurrent readers never see a partial entry
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec) std::filesystem::remove(tmpPath, ec);
+}
@@ -0,0 +1,127 @@
+#include "SimulationJob.h"
+#include <algorithm>
+
+CancellationToken::CancellationToken() : flag_(std::make_shared<std::atomic<bool>>(false)) {}
+
+void CancellationToken::cancel() const {
+    flag_->store(true, std::memory_order_relaxed);
+}
+
+bool CancellationToken::isCancelled() const {
+    return flag_->load(std::memory_order_relaxed);
+}
+
+void CancellationToken::throwIfCancelled() const {
+    if (isCancelled()) throw JobCancelled();
+}
+
+SimulationJob::SimulationJob()
+    : state_(static_cast<int>(State::Running)), done_(0), total_(0) {}
+
+std::shared_ptr<SimulationJob> SimulationJob::start(Task task, std::shared_ptr<SimulationJob> previous) {
+    if (previous) previous->cancel();
+    std::shared_ptr<SimulationJob> job(new SimulationJob());
+    // The thread only uses the raw pointer; the destructor joins it
+    SimulationJob* self = job.get();
+    job->thread_ = std::thread([self, task = std::move(task), previous]() mutable {
+        self->run(task, std::move(previous));
+    });
+    return job;
+}
+
+SimulationJob::~SimulationJob() {
+    cancel();
+    wait();
+}
+
+void SimulationJob::run(const Task& task, std::shared_ptr<SimulationJob> previous) {
+    if (previous) {
+        setStatus("Waiting for the previous run to stop...");
+        previous->wait();
+        previous.reset();
+    }
+
+    State result = State::Failed;
+    if (token_.isCancelled()) {
+        result = State::Cancelled;
+    } else {
+        try {
+            result = task(*this) ? State::Completed : State::Failed;
+        } catch (const JobCancelled&) {
+            result = State::Cancelled;
+        } catch (const std::exception& e) {
+            log(std::string("❌ Exception in simulation job: ") + e.what() + "\n");
+        } catch (...) {
+            log("❌ Unknown exception in simulation job.\n");
+        }
+        // A task that bails out after a cancel request counts as cancelled
+        if (result != State::Cancelled && token_.isCancelled()) result = State::Cancelled;
+    }
+    setStatus("");
+    state_.store(static_cast<int>(result), std::memory_order_release);
+}
+
+void SimulationJob::cancel() {
+    token_.cancel();
+}
+
+bool SimulationJob::isCancelled() const {
+    return token_.isCancelled();
+}
+
+SimulationJob::State SimulationJob::getState() const {
+    return static_cast<State>(state_.load(std::memory_order_acquire));
+}
+
+bool SimulationJob::isDone() const {
+    return getState() != State::Running;
+}
+
+void SimulationJob::wait() {
+    std::lock_guard<std::mutex> lock(joinMutex_);
+    if (thread_.joinable()) thread_.join();
+}
+
+void SimulationJob::setTotal(int units) {
+    total_.store(units, std::memory_order_relaxed);
+}
+
+void SimulationJob::advance(int units) {
+    done_.fetch_add(units, std::memory_order_relaxed);
+}
+
+int SimulationJob::getDone() const {
+    return done_.load(std::memory_order_relaxed);
+}
+
+int SimulationJob::getTotal() const {
+    return total_.load(std::memory_order_relaxed);
+}
+
+float SimulationJob::getFraction() const {
+    int total = getTotal();
+    if (total <= 0) return 0.0f;
+    return std::min(1.0f, static_cast<float>(getDone()) / total);
+}
+
+void SimulationJob::setStatus(const std::string& status) {
+    std::lock_guard<std::mutex> lock(textMutex_);
+    status_ = status;
+}
+
+std::string SimulationJob::getStatus() const {
+    std::lock_guard<std::mutex> lock(textMutex_);
+    return status_;
+}
+
+void SimulationJob::log(const std::string& text) {
+    std::lock_guard<std::mutex> lock(textMutex_);
+    log_ += text;
+}
+
+std::string SimulationJob::takeLog() {
+    std::lock_guard<std::mutex> lock(textMutex_);
+    std::string text;
+    text.swap(log_);
+    return text;
+}
@@ -0,0 +1,221 @@
+#include "SliceCoordinator.h"
+#include "Json.h"
+#include "TcpChannel.h"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+double field(const JsonValue& row, const char* key) {
+    const JsonValue* v = row.find(key);
+    if (!v || v->type != JsonValue::Type::Number) {
+        throw std::runtime_error(std::string("Worker response: missing '") + key + "'");
+    }
+    return v->number;
+}
+
+SweepRow parseRow(const JsonValue& row) {
+    SweepRow r;
+    r.slice          = static_cast<int>(field(row, "slice"));
+    r.lL             = field(row, "lL");
+    r.originalTPS    = field(row, "originalTPS");
+    r.optimizedTPS   = field(row, "optimizedTPS");
+    r.preCarbonTemp  = field(row, "preCarbonTemp");
+    r.preGlueTemp    = field(row, "preGlueTemp");
+    r.preSteelTemp   = field(row, "preSteelTemp");
+    r.postCarbonTemp = field(row, "postCarbonTemp");
+    r.postGlueTemp   = field(row, "postGlueTemp");
+    r.postSteelTemp  = field(row, "postSteelTemp");
+    return r;
+}
+
+// Request members shared by every batch of a run
+std::string commonFields(const SliceRequest& request) {
+    const SweepConfig& c = request.config;
+    std::ostringstream out;
+    out << "\"op\":" << (request.search ? "\"suggest\"" : "\"simulate\"")
+        << ",\"slices\":" << request.nSlices
+        << ",\"zRange\":[" << jsonNumber(request.zMin) << "," << jsonNumber(request.zMax) << "]"
+        << ",\"dt\":" << jsonNumber(c.dt)
+        << ",\"theta\":" << jsonNumber(c.theta)
+        << ",\"points\":" << c.pointsPerLayer
+        << ",\"time\":" << jsonNumber(c.duration)
+        << ",\"adaptive\":" << (c.adaptive ? "true" : "false")
+        << ",\"maxSteelTemp\":" << jsonNumber(c.maxSteelTemp)
+        << ",\"maxGlueTemp\":" << jsonNumber(c.maxGlueTemp)
+        << ",\"maxCarbonTemp\":" << jsonNumber(c.maxCarbonTemp);
+    if (!request.initialTemperature.empty()) {
+        out << ",\"initTemperature\":[";
+        for (size_t i = 0; i < request.initialTemperature.size(); ++i) {
+            out << (i ? "," : "") << jsonNumber(request.initialTemperature[i]);
+        }
+        out << "]";
+    }
+    return out.str();
+}
+
+} // namespace
+
+std::vector<WorkerAddress> parseWorkerList(const std::string& list) {
+    std::vector<WorkerAddress> workers;
+    std::istringstream in(list);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        std::size_t colon = item.rfind(':');
+        WorkerAddress w;
+        if (colon == std::string::npos || colon == 0) throw std::runtime_error("Worker '" + item + "' is not host:port");
+        w.host = item.substr(0, colon);
+        try {
+            w.port = std::stoi(item.substr(colon + 1));
+        } catch (const std::exception&) {
+            w.port = 0;
+        }
+        if (w.port <= 0 || w.port > 65535) throw std::runtime_error("Worker '" + item + "' has no valid port");
+        workers.push_back(w);
+    }
+    if (workers.empty()) throw std::runtime_error("No workers given");
+    return workers;
+}
+
+SliceCoordinator::SliceCoordinator(const std::vector<WorkerAddress>& workers) : workers_(workers) {}
+
+void SliceCoordinator::setBatchSize(int slices) {
+    batchSize_ = std::max(0, slices);
+}
+
+std::vector<SweepRow> SliceCoordinator::run(const SliceRequest& request) {
+    const int nSlices = request.nSlices;
+    const std::string common = commonFields(request);
+    std::vector<SweepRow> rows(nSlices);
+    slicesPerWorker_.assign(workers_.size(), 0);
+
+    // Shared work queue of 1-based slices; failed batches go back to the front,
+    // so idle workers wait as long as batches are out
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::deque<int> pending;
+    for (int slice = 1; slice <= nSlices; ++slice) pending.push_back(slice);
+    int done = 0;
+    int inFlight = 0;
+    int alive = static_cast<int>(workers_.size());
+    std::string error; // First rejected request: the run fails
+    long long nextId = 0;
+
+    auto worker = [&](int w) {
+        const WorkerAddress& address = workers_[w];
+        std::unique_ptr<TcpChannel> channel;
+        std::vector<int> batch;
+        auto giveBack = [&](const std::string& why) {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending.insert(pending.begin(), batch.begin(), batch.end());
+            inFlight -= static_cast<int>(batch.size());
+            --alive;
+            changed.notify_all();
+            std::cerr << "Warning: worker " << address.host << ":" << address.port << " dropped: " << why << "\n";
+        };
+        try {
+            channel = TcpChannel::connect(address.host, address.port);
+        } catch (const std::exception& e) {
+            giveBack(e.what());
+            return;
+        }
+
+        // Batch size: as many slices as the worker runs at once
+        int perRequest = batchSize_;
+        std::string line;
+        if (perRequest == 0) {
+            if (!channel->writeLine("{\"op\":\"stats\"}") || !channel->readLine(line)) {
+                giveBack("no answer");
+                return;
+            }
+            try {
+                JsonValue answer = parseJson(line, "Worker response");
+                const JsonValue* stats = answer.find("stats");
+                const JsonValue* threads = stats ? stats->find("threads") : nullptr;
+                perRequest = threads ? static_cast<int>(threads->number) : 1;
+            } catch (const std::exception& e) {
+                giveBack(e.what());
+                return;
+            }
+        }
+        perRequest = std::max(1, perRequest);
+
+        for (;;) {
+            long long id;
+            {
+                // Guided: at most an even share of what is left
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [&] { return !error.empty() || !pending.empty() || inFlight == 0; });
+                if (!error.empty() || pending.empty()) return;
+                int share = (static_cast<int>(pending.size()) + alive - 1) / std::max(1, alive);
+                int take = std::min(perRequest, std::max(1, share));
+                batch.assign(pending.begin(), pending.begin() + take);
+                pending.erase(pending.begin(), pending.begin() + take);
+                inFlight += take;
+                id = nextId++;
+            }
+            std::ostringstream message;
+            message << "{\"id\":" << id << "," << common << ",\"slice\":[";
+            for (size_t i = 0; i < batch.size(); ++i) message << (i ? "," : "") << batch[i];
+            message << "]}";
+            if (!channel->writeLine(message.str()) || !channel->readLine(line)) {
+                giveBack("connection lost");
+                return;
+            }
+
+            std::vector<SweepRow> answered;
+            std::string rejected;
+            try {
+                JsonValue answer = parseJson(line, "Worker response");
+                const JsonValue* ok = answer.find("ok");
+                if (!ok || !ok->boolean) {
+                    const JsonValue* what = answer.find("error");
+                    rejected = what ? what->string : std::string("request failed");
+                } else {
+                    const JsonValue* list = answer.find("rows");
+                    if (!list || list->array.size() != batch.size()) throw std::runtime_error("Worker response: wrong row count");
+                    for (const auto& row : list->array) {
+                        answered.push_back(parseRow(row));
+                        int slice = answered.back().slice;
+                        if (std::find(batch.begin(), batch.end(), slice) == batch.end()) {
+                            throw std::runtime_error("Worker response: unexpected slice " + std::to_string(slice));
+                        }
+                    }
+                }
+            } catch (const std::exception& e) {
+                giveBack(e.what());
+                return;
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            inFlight -= static_cast<int>(batch.size());
+            batch.clear();
+            changed.notify_all();
+            if (!rejected.empty()) {
+                // Same request, same answer on any worker: stop the run
+                if (error.empty()) error = address.host + ":" + std::to_string(address.port) + ": " + rejected;
+                return;
+            }
+            for (const auto& row : answered) rows[row.slice - 1] = row;
+            slicesPerWorker_[w] += static_cast<int>(answered.size());
+            done += static_cast<int>(answered.size());
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t w = 0; w < workers_.size(); ++w) threads.emplace_back(worker, static_cast<int>(w));
+    for (auto& t : threads) t.join();
+
+    if (!error.empty()) throw std::runtime_error("Worker rejected a request: " + error);
+    if (done != nSlices) {
+        throw std::runtime_error("No worker left: " + std::to_string(nSlices - done) + " slices not run");
+    }
+    return rows;
+}
@@ -0,0 +1,80 @@
+#include "SliceIndex.h"
+#include "SliceScheduler.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+SliceIndex::SliceIndex()
+    : revision_(-1), nSlices_(0), axis_(1), min_(0.0), max_(0.0), range_(1.0) {}
+
+void SliceIndex::build(const MeshHandler& mesh, int revision, int nSlices, int axis, int numThreads) {
+    const auto& vertices = mesh.getVertices();
+    const auto& faces = mesh.getFaces();
+
+    revision_ = revision;
+    nSlices_ = std::max(nSlices, 1);
+    axis_ = axis;
+
+    float lo = std::numeric_limits<float>::max();
+    float hi = std::numeric_limits<float>::lowest();
+    for (const auto& v : vertices) {
+        lo = std::min(lo, v[axis]);
+        hi = std::max(hi, v[axis]);
+    }
+    min_ = vertices.empty() ? 0.0 : lo;
+    max_ = vertices.empty() ? 0.0 : hi;
+    range_ = max_ - min_;
+    if (range_ <= 0) range_ = 1.0; // Flat mesh: one band of unit width
+
+    faceSlices_.assign(faces.size(), 0);
+    faceCounts_.assign(nSlices_, 0);
+
+    // Contiguous chunks of faces, one task each
+    const size_t chunk = 1 << 16;
+    int nChunks = static_cast<int>((faces.size() + chunk - 1) / chunk);
+    std::vector<std::vector<size_t>> chunkCounts(nChunks, std::vector<size_t>(nSlices_, 0));
+
+    SliceScheduler scheduler(numThreads);
+    scheduler.run(nChunks, [&](int c) {
+        size_t begin = c * chunk;
+        size_t end = std::min(faces.size(), begin + chunk);
+        for (size_t f = begin; f < end; ++f) {
+            const auto& face = faces[f];
+            double centroid = (vertices[face[0]][axis] + vertices[face[1]][axis] + vertices[face[2]][axis]) / 3.0;
+            int s = binOf(centroid);
+            faceSlices_[f] = s;
+            chunkCounts[c][s]++;
+        }
+    });
+
+    for (const auto& counts : chunkCounts) {
+        for (int s = 0; s < nSlices_; ++s) faceCounts_[s] += counts[s];
+    }
+}
+
+bool SliceIndex::isCurrent(int revision, int nSlices) const {
+    return revision == revision_ && std::max(nSlices, 1) == nSlices_;
+}
+
+int SliceIndex::binOf(double value) const {
+    if (nSlices_ <= 1) return 0;
+    double k = std::floor((value - min_) / range_ * nSlices_);
+    if (!(k >= 0)) return 0;  // Below the range (or NaN)
+    int s = static_cast<int>(std::min(k, double(nSlices_)));
+    if (s == nSlices_) {
+        if (value > boundary(nSlices_)) return 0; // Above the range
+        s = nSlices_ - 1;
+    }
+    // Edges are inclusive on both sides; the lower band wins
+    if (s > 0 && value <= boundary(s)) --s;
+    return s;
+}
+
+double SliceIndex::boundary(int i) const {
+    return min_ + (static_cast<double>(i) / nSlices_) * range_;
+}
+
+double SliceIndex::samplePosition(int i) const {
+    if (nSlices_ <= 1) return min_ + range_ / 2.0;
+    return min_ + (double(i) / (nSlices_ - 1)) * range_;
+}
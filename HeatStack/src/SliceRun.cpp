@@ -0,0 +1,116 @@
+#include "SliceRun.h"
+#include "BoundaryConditions.h"
+#include "SimulationJob.h"
+#include "TimeHandler.h"
+#include <limits>
+
+namespace {
+
+// Interface limit from a maxTemp or glassTransitionTemp; 0 means not applicable
+double interfaceLimit(double temperature) {
+    return temperature > 0.0 ? temperature : std::numeric_limits<double>::infinity();
+}
+
+} // namespace
+
+SliceRun::SliceRun(const SliceSettings& settings, int id, double l_over_L, const Stack* groupStack)
+    : settings_(settings), lL_(l_over_L) {
+    props_.setGridOptions(settings_.grid);
+    const int points = settings_.pointsPerLayer;
+    stack_.id = id;
+    stack_.layers = {
+        { MaterialProperties::getMaterial("TPS"),         props_.getTPSThickness(lL_),         points },
+        { MaterialProperties::getMaterial("CarbonFiber"), props_.getCarbonFiberThickness(lL_), points },
+        { MaterialProperties::getMaterial("Glue"),        props_.getGlueThickness(lL_),        points },
+        { MaterialProperties::getMaterial("Steel"),       props_.getSteelThickness(lL_),       points }
+    };
+    if (groupStack) {
+        // Group stack materials; thicknesses it leaves at 0 follow the profiles
+        for (size_t i = 0; i < stack_.layers.size(); ++i) {
+            stack_.layers[i].material = groupStack->layers[i].material;
+            if (groupStack->layers[i].thickness > 0.0) stack_.layers[i].thickness = groupStack->layers[i].thickness;
+        }
+    }
+    generateGrid();
+}
+
+void SliceRun::generateGrid() {
+    props_.generateGrid(stack_, settings_.pointsPerLayer);
+    nodes_ = interfaceNodes(stack_);
+}
+
+void SliceRun::setTPSThickness(double thickness) {
+    stack_.layers[0].thickness = thickness;
+    generateGrid();
+}
+
+InterfaceTemperatures SliceRun::readInterfaces(const std::vector<double>& temperature) const {
+    InterfaceTemperatures out;
+    out.carbonGlue = temperature[nodes_[0]];
+    out.glueSteel  = temperature[nodes_[1]];
+    out.steel      = temperature[nodes_[2]];
+    return out;
+}
+
+void SliceRun::setUp(HeatEquationSolver& solver) const {
+    TimeHandler timeHandler(settings_.duration, settings_.dt, settings_.adaptive);
+    timeHandler.setTimeStepLimits(settings_.steps.minTimeStep, settings_.steps.maxTimeStep);
+    solver.initialize(stack_, timeHandler);
+    solver.setAdaptiveTolerance(settings_.steps.adaptiveTolerance);
+    solver.setSteadyStateTolerance(settings_.steps.steadyStateRate);
+    solver.setInitialTemperature(settings_.initialTemperature
+        ? *settings_.initialTemperature
+        : std::vector<double>(stack_.xGrid.size(), 300.0));
+
+    // Outer Dirichlet condition: the exhaust-gas law, or the profile at l/L
+    if (settings_.surfaceProfile) {
+        solver.setBoundaryConditions(new TabulatedCondition(settings_.surfaceProfile), new NeumannCondition(0.0f));
+        solver.setBoundaryPosition({ 0.0f, 0.0f, static_cast<float>(lL_) });
+    } else {
+        solver.setBoundaryConditions(
+            new DirichletCondition(static_cast<float>(MaterialProperties::getExhaustTemp(lL_))),
+            new NeumannCondition(0.0f));
+    }
+}
+
+InterfaceTemperatures SliceRun::transient(HeatEquationSolver& solver,
+                                          const std::function<void(const HeatEquationSolver&)>& onStep) const {
+    while (!solver.isFinished()) {
+        if (settings_.cancelToken) settings_.cancelToken->throwIfCancelled();
+        solver.step();
+        if (onStep) onStep(solver);
+    }
+    return readInterfaces(solver.getTemperatureDistribution());
+}
+
+InterfaceTemperatures SliceRun::materialLimits() const {
+    InterfaceTemperatures limits;
+    limits.carbonGlue = interfaceLimit(stack_.layers[1].material.glassTransitionTemp);
+    limits.glueSteel  = interfaceLimit(stack_.layers[2].material.glassTransitionTemp);
+    limits.steel      = interfaceLimit(stack_.layers[3].material.maxTemp);
+    return limits;
+}
+
+double SliceRun::suggestThickness(const InterfaceTemperatures& limits, SearchProgress* progress,
+                                  std::function<void()> onRound) {
+    TemperatureComparator comp;
+    comp.setTimeStep(settings_.dt, settings_.adaptive);
+    comp.setTimeStepLimits(settings_.steps.minTimeStep, settings_.steps.maxTimeStep);
+    comp.setAdaptiveTolerance(settings_.steps.adaptiveTolerance);
+    comp.setSteadyStateTolerance(settings_.steps.steadyStateRate);
+    comp.setGridResolution(settings_.pointsPerLayer);
+    comp.setGridOptions(settings_.grid);
+    comp.setSearchWays(settings_.searchWays);
+    comp.setSearchThreads(settings_.searchThreads);
+    comp.setPrecision(settings_.precision);
+    comp.setSearchMethod(settings_.method);
+    comp.setCache(settings_.cache);
+    comp.setSurrogate(settings_.surrogate);
+    comp.setSurfaceProfile(settings_.surfaceProfile);
+    comp.setCancellationToken(settings_.cancelToken);
+    if (progress) comp.setSearchProgress(progress, std::move(onRound));
+    double thickness = comp.suggestTPSThickness(stack_, limits.steel, limits.glueSteel, limits.carbonGlue,
+                                                settings_.duration, lL_, props_, settings_.theta);
+    fromSurrogate_ = comp.lastSuggestionFromSurrogate();
+    return thickness;
+}
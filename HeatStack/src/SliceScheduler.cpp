@@ -0,0 +1,161 @@
+#include "SliceScheduler.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Per-worker slice queue. The owner pops from the front, thieves from the back.
+struct WorkQueue {
+    std::mutex mutex;
+    std::deque<int> slices;
+
+    bool popFront(int& slice) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (slices.empty()) return false;
+        slice = slices.front();
+        slices.pop_front();
+        return true;
+    }
+
+    bool stealBack(int& slice) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (slices.empty()) return false;
+        slice = slices.back();
+        slices.pop_back();
+        return true;
+    }
+};
+
+} // namespace
+
+// Helper threads 1..n-1; worker 0 is always the thread calling run()
+struct SliceScheduler::Pool {
+    std::mutex mutex;
+    std::condition_variable wake;       // A run started, or stop
+    std::condition_variable finished;   // The last helper of a run is done
+    std::vector<std::thread> threads;
+    const std::function<void(int)>* work = nullptr; // Worker body of the current run
+    int helpers = 0;                    // Helpers taking part in the current run
+    int busy = 0;                       // ... that have not finished it yet
+    unsigned long long generation = 0;  // Number of runs started
+    bool stop = false;
+
+    void helperLoop(int id) {
+        unsigned long long seen = 0;
+        for (;;) {
+            const std::function<void(int)>* body;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&] { return stop || generation != seen; });
+                if (stop) return;
+                seen = generation;
+                if (id > helpers) continue; // Not needed for this run
+                body = work;
+            }
+            (*body)(id);
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--busy == 0) finished.notify_one();
+        }
+    }
+};
+
+SliceScheduler::SliceScheduler(int numThreads) : numThreads_(numThreads) {
+    if (numThreads_ <= 0) {
+        numThreads_ = static_cast<int>(std::thread::hardware_concurrency());
+        if (numThreads_ <= 0) numThreads_ = 1;
+    }
+}
+
+SliceScheduler::~SliceScheduler() {
+    if (!pool_) return;
+    {
+        std::lock_guard<std::mutex> lock(pool_->mutex);
+        pool_->stop = true;
+    }
+    pool_->wake.notify_all();
+    for (auto& t : pool_->threads) t.join();
+}
+
+int SliceScheduler::getNumThreads() const {
+    return numThreads_;
+}
+
+int SliceScheduler::nestedThreads(int outerThreads) {
+    int cores = SliceScheduler(0).getNumThreads();
+    return std::max(1, cores / SliceScheduler(outerThreads).getNumThreads());
+}
+
+void SliceScheduler::run(int nSlices, const std::function<void(int)>& task) {
+    if (nSlices <= 0) return;
+
+    int nWorkers = std::min(numThreads_, nSlices);
+    if (nWorkers <= 1) {
+        for (int slice = 0; slice < nSlices; ++slice) task(slice);
+        return;
+    }
+
+    // Hand out contiguous blocks so neighbouring slices stay on one worker
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    for (int w = 0; w < nWorkers; ++w) {
+        queues.push_back(std::make_unique<WorkQueue>());
+        int begin = static_cast<int>(static_cast<long long>(nSlices) * w / nWorkers);
+        int end   = static_cast<int>(static_cast<long long>(nSlices) * (w + 1) / nWorkers);
+        for (int slice = begin; slice < end; ++slice) queues[w]->slices.push_back(slice);
+    }
+
+    std::atomic<bool> failed(false);
+    std::exception_ptr firstError;
+    std::mutex errorMutex;
+
+    auto worker = [&](int id) {
+        int slice;
+        while (!failed.load()) {
+            bool found = queues[id]->popFront(slice);
+            // Own queue drained: try to steal from the others, nearest first
+            for (int k = 1; !found && k < nWorkers; ++k) {
+                found = queues[(id + k) % nWorkers]->stealBack(slice);
+            }
+            if (!found) return; // no task spawns new work, so we are done
+
+            try {
+                task(slice);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!firstError) firstError = std::current_exception();
+                failed.store(true);
+            }
+        }
+    };
+
+    // Wake (or first start) the helpers; the calling thread is worker 0
+    if (!pool_) pool_ = std::make_unique<Pool>();
+    Pool& pool = *pool_;
+    const std::function<void(int)> body = worker;
+    {
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        while (static_cast<int>(pool.threads.size()) < nWorkers - 1) {
+            int id = static_cast<int>(pool.threads.size()) + 1;
+            pool.threads.emplace_back([&pool, id] { pool.helperLoop(id); });
+        }
+        pool.work = &body;
+        pool.helpers = nWorkers - 1;
+        pool.busy = nWorkers - 1;
+        ++pool.generation;
+    }
+    pool.wake.notify_all();
+    worker(0);
+    {
+        std::unique_lock<std::mutex> lock(pool.mutex);
+        pool.finished.wait(lock, [&] { return pool.busy == 0; });
+        pool.work = nullptr;
+    }
+
+    if (firstError) std::rethrow_exception(firstError);
+}
@@ -0,0 +1,385 @@
+#include "SnapshotStore.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+const char kMagic[4] = {'H', 'S', 'S', 'N'};
+const std::uint32_t kVersion = 1;
+
+template <typename T>
+void writeValue(std::ostream& out, T value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void putVarint(std::string& buf, std::uint64_t value) {
+    while (value >= 0x80) {
+        buf.push_back(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    buf.push_back(static_cast<char>(value));
+}
+
+bool getVarint(const unsigned char*& p, const unsigned char* end, std::uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && p < end; shift += 7) {
+        unsigned char byte = *p++;
+        value |= std::uint64_t(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+std::uint64_t zigzag(std::int64_t v) {
+    return (static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63);
+}
+
+std::int64_t unzigzag(std::uint64_t v) {
+    return static_cast<std::int64_t>(v >> 1) ^ -static_cast<std::int64_t>(v & 1);
+}
+
+std::uint64_t bitsOf(double v) {
+    std::uint64_t u;
+    std::memcpy(&u, &v, sizeof(u));
+    return u;
+}
+
+double fromBits(std::uint64_t u) {
+    double v;
+    std::memcpy(&v, &u, sizeof(v));
+    return v;
+}
+
+// Frame-major values of one chunk; see SnapshotWriter for the scheme
+std::string encodeChunk(const std::vector<double>& values, std::size_t frames,
+                        std::size_t nodes, double quantum) {
+    std::string buf;
+    buf.reserve(frames * nodes * 2);
+    if (quantum > 0.0) {
+        std::vector<std::int64_t> prev(nodes, 0);
+        for (std::size_t f = 0; f < frames; ++f) {
+            std::int64_t left = 0;
+            for (std::size_t i = 0; i < nodes; ++i) {
+                std::int64_t q = std::llround(values[f * nodes + i] / quantum);
+                putVarint(buf, zigzag(f == 0 ? q - left : q - prev[i]));
+                left = q;
+                prev[i] = q;
+            }
+        }
+    } else {
+        for (std::size_t f = 0; f < frames; ++f) {
+            for (std::size_t i = 0; i < nodes; ++i) {
+                std::uint64_t ref = f > 0 ? bitsOf(values[(f - 1) * nodes + i])
+                                  : i > 0 ? bitsOf(values[i - 1]) : 0;
+                std::uint64_t x = bitsOf(values[f * nodes + i]) ^ ref;
+                int n = 0;
+                while (n < 8 && (x >> (8 * n)) != 0) ++n;
+                buf.push_back(static_cast<char>(n));
+                for (int b = 0; b < n; ++b) buf.push_back(static_cast<char>(x >> (8 * b)));
+            }
+        }
+    }
+    return buf;
+}
+
+bool decodeChunk(const unsigned char* p, const unsigned char* end, std::size_t frames,
+                 std::size_t nodes, double quantum, std::vector<double>& values) {
+    values.resize(frames * nodes);
+    if (quantum > 0.0) {
+        std::vector<std::int64_t> prev(nodes, 0);
+        for (std::size_t f = 0; f < frames; ++f) {
+            std::int64_t left = 0;
+            for (std::size_t i = 0; i < nodes; ++i) {
+                std::uint64_t z;
+                if (!getVarint(p, end, z)) return false;
+                std::int64_t q = (f == 0 ? left : prev[i]) + unzigzag(z);
+                values[f * nodes + i] = double(q) * quantum;
+                left = q;
+                prev[i] = q;
+            }
+        }
+    } else {
+        for (std::size_t f = 0; f < frames; ++f) {
+            for (std::size_t i = 0; i < nodes; ++i) {
+                if (p >= end) return false;
+                int n = *p++;
+                if (n > 8 || end - p < n) return false;
+                std::uint64_t x = 0;
+                for (int b = 0; b < n; ++b) x |= std::uint64_t(*p++) << (8 * b);
+                std::uint64_t ref = f > 0 ? bitsOf(values[(f - 1) * nodes + i])
+                                  : i > 0 ? bitsOf(values[i - 1]) : 0;
+                values[f * nodes + i] = fromBits(x ^ ref);
+            }
+        }
+    }
+    return p == end;
+}
+
+// Bounds-checked reads from the mapped index
+struct Cursor {
+    const char* p;
+    const char* end;
+
+    template <typename T>
+    bool read(T& value) {
+        if (end - p < static_cast<std::ptrdiff_t>(sizeof(T))) return false;
+        std::memcpy(&value, p, sizeof(T));
+        p += sizeof(T);
+        return true;
+    }
+
+    bool readDoubles(std::vector<double>& v, std::uint32_t n) {
+        if (static_cast<std::size_t>(end - p) / sizeof(double) < n) return false;
+        v.resize(n);
+        if (n) std::memcpy(v.data(), p, n * sizeof(double));
+        p += n * sizeof(double);
+        return true;
+    }
+};
+
+} // namespace
+
+SnapshotWriter::SnapshotWriter(const std::string& path, const SnapshotOptions& options)
+    : options_(options) {
+    options_.chunkFrames = std::max(1, options_.chunkFrames);
+    options_.every = std::max(1, options_.every);
+    options_.quantum = std::max(0.0, options_.quantum);
+
+    out_.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!out_) {
+        closed_ = true;
+        return;
+    }
+    out_.write(kMagic, sizeof(kMagic));
+    writeValue(out_, kVersion);
+    writeValue(out_, options_.quantum);
+}
+
+SnapshotWriter::~SnapshotWriter() {
+    close();
+}
+
+bool SnapshotWriter::isOpen() const {
+    return out_.is_open();
+}
+
+SnapshotWriter::SliceState& SnapshotWriter::state(int slice) {
+    std::lock_guard<std::mutex> lock(slicesMutex_);
+    return slices_[slice];
+}
+
+void SnapshotWriter::setGrid(int slice, const std::vector<double>& xGrid) {
+    if (closed_) return;
+    state(slice).grid = xGrid;
+}
+
+void SnapshotWriter::record(int slice, double time, const TemperatureDistribution& field) {
+    record(slice, time, field.data());
+}
+
+void SnapshotWriter::record(int slice, double time, const std::vector<double>& field) {
+    if (closed_) return;
+    SliceState& st = state(slice);
+    if (st.nodes == 0) st.nodes = field.size();
+    if (field.size() != st.nodes || field.empty()) return;
+
+    bool first = st.chunks.empty() && st.times.empty();
+    if (first || ++st.sinceKept >= options_.every) {
+        keep(st, time, field);
+        st.sinceKept = 0;
+        st.lastDropped = false;
+    } else {
+        st.lastOffered = field;
+        st.lastTime = time;
+        st.lastDropped = true;
+    }
+}
+
+void SnapshotWriter::keep(SliceState& st, double time, const std::vector<double>& field) {
+    st.times.push_back(time);
+    st.values.insert(st.values.end(), field.begin(), field.end());
+    if (st.times.size() >= static_cast<std::size_t>(options_.chunkFrames)) flushChunk(st);
+}
+
+void SnapshotWriter::flushChunk(SliceState& st) {
+    if (st.times.empty()) return;
+    // Encode on the slice's own thread, only the append is serialised
+    std::string payload = encodeChunk(st.values, st.times.size(), st.nodes, options_.quantum);
+
+    Chunk chunk;
+    chunk.times.swap(st.times);
+    chunk.bytes = payload.size();
+    {
+        std::lock_guard<std::mutex> lock(fileMutex_);
+        chunk.offset = static_cast<std::uint64_t>(out_.tellp());
+        out_.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+        if (!out_) failed_ = true;
+        writtenFrames_ += chunk.times.size();
+        rawBytes_ += chunk.times.size() * st.nodes * sizeof(double);
+    }
+    st.chunks.push_back(std::move(chunk));
+    st.values.clear();
+}
+
+bool SnapshotWriter::close() {
+    if (closed_) return !failed_;
+    closed_ = true;
+
+    for (auto& entry : slices_) {
+        SliceState& st = entry.second;
+        if (st.lastDropped) keep(st, st.lastTime, st.lastOffered);
+        flushChunk(st);
+    }
+
+    std::uint64_t indexOffset = static_cast<std::uint64_t>(out_.tellp());
+    writeValue(out_, static_cast<std::uint32_t>(slices_.size()));
+    for (const auto& entry : slices_) {
+        const SliceState& st = entry.second;
+        writeValue(out_, static_cast<std::uint32_t>(entry.first));
+        writeValue(out_, static_cast<std::uint32_t>(st.nodes));
+        writeValue(out_, static_cast<std::uint32_t>(st.grid.size()));
+        out_.write(reinterpret_cast<const char*>(st.grid.data()),
+                   static_cast<std::streamsize>(st.grid.size() * sizeof(double)));
+        writeValue(out_, static_cast<std::uint32_t>(st.chunks.size()));
+        for (const Chunk& c : st.chunks) {
+            writeValue(out_, c.offset);
+            writeValue(out_, c.bytes);
+            writeValue(out_, static_cast<std::uint32_t>(c.times.size()));
+            out_.write(reinterpret_cast<const char*>(c.times.data()),
+                       static_cast<std::streamsize>(c.times.size() * sizeof(double)));
+        }
+    }
+    writeValue(out_, indexOffset);
+    out_.write(kMagic, sizeof(kMagic));
+
+    out_.flush();
+    if (!out_) failed_ = true;
+    fileBytes_ = static_cast<std::uint64_t>(out_.tellp());
+    out_.close();
+    return !failed_;
+}
+
+std::size_t SnapshotWriter::getWrittenFrames() const {
+    return writtenFrames_;
+}
+
+std::uint64_t SnapshotWriter::getRawBytes() const {
+    return rawBytes_;
+}
+
+std::uint64_t SnapshotWriter::getWrittenBytes() const {
+    return fileBytes_;
+}
+
+SnapshotReader::SnapshotReader(const std::string& path)
+    : file_(new MappedFile(path)) {
+    open_ = file_->isOpen() && parseIndex();
+    if (!open_) slices_.clear();
+}
+
+bool SnapshotReader::parseIndex() {
+    const char* data = file_->data();
+    std::size_t size = file_->size();
+    const std::size_t headerBytes = sizeof(kMagic) + sizeof(std::uint32_t) + sizeof(double);
+    const std::size_t footerBytes = sizeof(std::uint64_t) + sizeof(kMagic);
+    if (size < headerBytes + footerBytes) return false;
+    if (std::memcmp(data, kMagic, sizeof(kMagic)) != 0 ||
+        std::memcmp(data + size - sizeof(kMagic), kMagic, sizeof(kMagic)) != 0) return false;
+
+    Cursor header{ data + sizeof(kMagic), data + headerBytes };
+    std::uint32_t version;
+    if (!header.read(version) || version != kVersion || !header.read(quantum_)) return false;
+
+    std::uint64_t indexOffset;
+    std::memcpy(&indexOffset, data + size - footerBytes, sizeof(indexOffset));
+    if (indexOffset < headerBytes || indexOffset > size - footerBytes) return false;
+
+    Cursor in{ data + indexOffset, data + size - footerBytes };
+    std::uint32_t sliceCount;
+    if (!in.read(sliceCount)) return false;
+    for (std::uint32_t s = 0; s < sliceCount; ++s) {
+        std::uint32_t id, nodes, gridSize, chunkCount;
+        if (!in.read(id) || !in.read(nodes) || !in.read(gridSize)) return false;
+        SliceIndex& slice = slices_[static_cast<int>(id)];
+        slice.nodes = nodes;
+        if (!in.readDoubles(slice.grid, gridSize) || !in.read(chunkCount)) return false;
+        for (std::uint32_t c = 0; c < chunkCount; ++c) {
+            Chunk chunk;
+            std::uint32_t frames;
+            std::vector<double> times;
+            if (!in.read(chunk.offset) || !in.read(chunk.bytes) || !in.read(frames) ||
+                !in.readDoubles(times, frames)) return false;
+            if (chunk.offset < headerBytes || chunk.offset > indexOffset ||
+                chunk.bytes > indexOffset - chunk.offset) return false;
+            chunk.firstFrame = slice.times.size();
+            chunk.frames = frames;
+            slice.times.insert(slice.times.end(), times.begin(), times.end());
+            slice.chunks.push_back(chunk);
+        }
+    }
+    return true;
+}
+
+const SnapshotReader::SliceIndex* SnapshotReader::find(int slice) const {
+    auto it = slices_.find(slice);
+    return it == slices_.end() ? nullptr : &it->second;
+}
+
+std::vector<int> SnapshotReader::getSlices() const {
+    std::vector<int> ids;
+    for (const auto& entry : slices_) ids.push_back(entry.first);
+    return ids;
+}
+
+bool SnapshotReader::hasSlice(int slice) const {
+    return find(slice) != nullptr;
+}
+
+std::size_t SnapshotReader::getNodeCount(int slice) const {
+    const SliceIndex* s = find(slice);
+    return s ? s->nodes : 0;
+}
+
+const std::vector<double>& SnapshotReader::getGrid(int slice) const {
+    static const std::vector<double> none;
+    const SliceIndex* s = find(slice);
+    return s ? s->grid : none;
+}
+
+std::size_t SnapshotReader::getFrameCount(int slice) const {
+    const SliceIndex* s = find(slice);
+    return s ? s->times.size() : 0;
+}
+
+double SnapshotReader::getFrameTime(int slice, std::size_t frame) const {
+    const SliceIndex* s = find(slice);
+    return s && frame < s->times.size() ? s->times[frame] : 0.0;
+}
+
+std::size_t SnapshotReader::findFrame(int slice, double time) const {
+    const SliceIndex* s = find(slice);
+    if (!s || s->times.empty()) return 0;
+    auto it = std::upper_bound(s->times.begin(), s->times.end(), time);
+    return it == s->times.begin() ? 0 : static_cast<std::size_t>(it - s->times.begin()) - 1;
+}
+
+bool SnapshotReader::read(int slice, std::size_t frame, TemperatureDistribution& field) const {
+    const SliceIndex* s = find(slice);
+    if (!s || frame >= s->times.size()) return false;
+
+    std::size_t c = std::upper_bound(s->chunks.begin(), s->chunks.end(), frame,
+        [](std::size_t f, const Chunk& chunk) { return f < chunk.firstFrame; }) - s->chunks.begin() - 1;
+    const Chunk& chunk = s->chunks[c];
+    if (cachedSlice_ != slice || cachedChunk_ != c) {
+        cachedSlice_ = -1;
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(file_->data()) + chunk.offset;
+        if (!decodeChunk(p, p + chunk.bytes, chunk.frames, s->nodes, quantum_, cachedValues_)) return false;
+        cachedSlice_ = slice;
+        cachedChunk_ = c;
+    }
+
+    auto first = cachedValues_.begin() + (frame - chunk.firstFrame) * s->nodes;
+    field.data().assign(first, first + s->nodes);
+    return true;
+}
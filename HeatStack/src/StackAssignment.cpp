@@ -0,0 +1,81 @@
+#include "StackAssignment.h"
+#include "SliceScheduler.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+void StackAssignment::build(const MeshHandler& mesh, const MeshGroups& groups, const std::vector<Stack>& stacks,
+                            const SliceIndex& index, int numThreads) {
+    // Stack of each group, by position in stacks (-1: none)
+    std::vector<int> groupStack(groups.groups.size(), -1);
+    for (size_t s = 0; s < stacks.size(); ++s) {
+        for (const auto& name : stacks[s].groups) {
+            int g = groups.find(name);
+            if (g < 0) throw std::runtime_error("Stack " + std::to_string(stacks[s].id) + " names unknown group '" + name + "'");
+            if (groupStack[g] >= 0) throw std::runtime_error("Group '" + name + "' is in more than one stack");
+            groupStack[g] = static_cast<int>(s);
+        }
+    }
+
+    const std::vector<int> triangleGroups = groups.triangleGroups(mesh, numThreads);
+    const auto& vertices = mesh.getVertices();
+    const auto& faces = mesh.getFaces();
+    const int nSlices = index.getNumSlices();
+    const int nStacks = static_cast<int>(stacks.size());
+
+    // Area per (slice, stack) for each chunk of triangles, column nStacks
+    // for the rest; chunks are summed in order, so results do not depend on
+    // the thread count
+    triangleStacks_.assign(faces.size(), 0);
+    const size_t chunk = 1 << 16;
+    int nChunks = static_cast<int>((faces.size() + chunk - 1) / chunk);
+    const size_t width = static_cast<size_t>(nStacks) + 1;
+    std::vector<std::vector<double>> chunkAreas(nChunks, std::vector<double>(nSlices * width, 0.0));
+
+    SliceScheduler scheduler(numThreads);
+    scheduler.run(nChunks, [&](int c) {
+        size_t begin = c * chunk;
+        size_t end = std::min(faces.size(), begin + chunk);
+        std::vector<double>& areas = chunkAreas[c];
+        for (size_t f = begin; f < end; ++f) {
+            int g = triangleGroups[f];
+            int s = g >= 0 ? groupStack[g] : -1;
+            if (s >= 0) triangleStacks_[f] = stacks[s].id;
+
+            const auto& a = vertices[faces[f][0]];
+            const auto& b = vertices[faces[f][1]];
+            const auto& d = vertices[faces[f][2]];
+            double u[3], v[3];
+            for (int k = 0; k < 3; ++k) {
+                u[k] = double(b[k]) - a[k];
+                v[k] = double(d[k]) - a[k];
+            }
+            double cx = u[1] * v[2] - u[2] * v[1];
+            double cy = u[2] * v[0] - u[0] * v[2];
+            double cz = u[0] * v[1] - u[1] * v[0];
+            double area = 0.5 * std::sqrt(cx * cx + cy * cy + cz * cz);
+            areas[index.sliceOf(f) * width + (s >= 0 ? s : nStacks)] += area;
+        }
+    });
+
+    std::vector<double> areas(nSlices * width, 0.0);
+    for (const auto& c : chunkAreas) {
+        for (size_t i = 0; i < areas.size(); ++i) areas[i] += c[i];
+    }
+
+    sliceStacks_.assign(nSlices, 0);
+    sliceCoverage_.assign(nSlices, 0.0);
+    for (int slice = 0; slice < nSlices; ++slice) {
+        const double* row = &areas[slice * width];
+        double total = 0.0;
+        for (size_t i = 0; i < width; ++i) total += row[i];
+        int best = -1;
+        for (int s = 0; s < nStacks; ++s) {
+            if (row[s] > 0.0 && (best < 0 || row[s] > row[best])) best = s;
+        }
+        if (best >= 0) {
+            sliceStacks_[slice] = stacks[best].id;
+            sliceCoverage_[slice] = total > 0.0 ? row[best] / total : 0.0;
+        }
+    }
+}
@@ -0,0 +1,76 @@
+#include "StepObserver.h"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+/////////////////////////////////////////
+// LimitMonitor
+/////////////////////////////////////////
+template <typename Real>
+void LimitMonitor<Real>::addLimit(const std::string& name, int node, double limit) {
+    limits_.push_back({ name, node, limit });
+}
+
+template <typename Real>
+bool LimitMonitor<Real>::onStep(double time, double /*dt*/, const std::vector<Real>& temperature) {
+    for (std::size_t k = 0; k < limits_.size(); ++k) {
+        double T = temperature[limits_[k].node];
+        if (T >= limits_[k].limit) {
+            exceeded_ = static_cast<int>(k);
+            exceededTime_ = time;
+            exceededTemp_ = T;
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename Real>
+std::string LimitMonitor<Real>::describeStop() const {
+    if (exceeded_ < 0) return std::string();
+    const Limit& l = limits_[exceeded_];
+    std::ostringstream out;
+    out << l.name << " reached " << exceededTemp_ << " K (limit " << l.limit
+        << " K) at t = " << exceededTime_ << " s";
+    return out.str();
+}
+
+/////////////////////////////////////////
+// SteadyStateMonitor
+/////////////////////////////////////////
+template <typename Real>
+bool SteadyStateMonitor<Real>::onStep(double /*time*/, double dt, const std::vector<Real>& temperature) {
+    if (previous_.size() != temperature.size() || dt <= 0.0) {
+        previous_ = temperature;
+        return true;
+    }
+    double maxChange = 0.0;
+    for (std::size_t i = 0; i < temperature.size(); ++i) {
+        maxChange = std::max(maxChange, static_cast<double>(std::fabs(temperature[i] - previous_[i])));
+    }
+    previous_ = temperature;
+    lastRate_ = maxChange / dt;
+    return lastRate_ >= rate_;
+}
+
+template <typename Real>
+std::string SteadyStateMonitor<Real>::describeStop() const {
+    std::ostringstream out;
+    out << "steady state: max |dT/dt| " << lastRate_ << " K/s < " << rate_ << " K/s";
+    return out.str();
+}
+
+/////////////////////////////////////////
+// CallbackObserver
+/////////////////////////////////////////
+template <typename Real>
+bool CallbackObserver<Real>::onStep(double time, double /*dt*/, const std::vector<Real>& temperature) {
+    return callback_(time, temperature);
+}
+
+template class LimitMonitor<float>;
+template class LimitMonitor<double>;
+template class SteadyStateMonitor<float>;
+template class SteadyStateMonitor<double>;
+template class CallbackObserver<float>;
+template class CallbackObserver<double>;
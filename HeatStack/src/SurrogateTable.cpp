@@ -0,0 +1,393 @@
+#include "SurrogateTable.h"
+#include "HeatEquationSolver.h"
+#include "BoundaryConditions.h"
+#include "SliceScheduler.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+
+namespace {
+
+const char kMagic[8] = {'H', 'S', 'S', 'U', 'R', 'R', '\0', '\0'};
+constexpr std::uint32_t kVersion = 1;
+
+struct FileHeader {
+    char          magic[8];
+    std::uint32_t version;
+    std::uint32_t layerCount;
+    std::uint32_t edgeCount;
+    double        minTPS, maxTPS, maxDuration, dt, theta;
+    std::int32_t  tpsPoints, lLPointsPerSegment, durationPoints, pointsPerLayer;
+    double        maxError, rmsError;
+    std::uint64_t valueCount;
+};
+
+struct FileMaterial {
+    double k, rho, c;
+};
+
+// Per entry: carbon/glue node and the next, glue/steel node and the next,
+// inner steel surface
+constexpr int kSlots = 5;
+
+// Interface node indices of a stack's grid, as the TPS search reads them
+void interfaceIndices(const Stack& s, size_t& carbonGlue, size_t& glueSteel) {
+    double posCG = s.layers[0].thickness + s.layers[1].thickness;
+    double posGS = posCG + s.layers[2].thickness;
+    carbonGlue = std::lower_bound(s.xGrid.begin(), s.xGrid.end(), posCG) - s.xGrid.begin();
+    glueSteel  = std::lower_bound(s.xGrid.begin(), s.xGrid.end(), posGS) - s.xGrid.begin();
+}
+
+// The search's lower_bound lands on the interface node or, when rounding in
+// generateGrid's running sum leaves that node just short, on the next one.
+// Redo the sum (no allocation) to tell which: 0 or 1 past the interface node
+void readOffsets(double tps, double carbon, double glue, int pointsPerLayer, int& offCG, int& offGS) {
+    const double thick[3] = { tps, carbon, glue };
+    double posCG = tps + carbon;
+    double posGS = posCG + glue;
+    double x = 0.0, xCG = 0.0;
+    for (int l = 0; l < 3; ++l) {
+        double dx = thick[l] / (pointsPerLayer - 1);
+        for (int i = 1; i < pointsPerLayer; ++i) x += dx;
+        if (l == 1) xCG = x;
+    }
+    offCG = (xCG >= posCG) ? 0 : 1;
+    offGS = (x >= posGS) ? 0 : 1;
+}
+
+} // namespace
+
+SurrogateTable::SurrogateTable() : maxError_(0.0), rmsError_(0.0) {}
+
+double SurrogateTable::tpsAt(int i) const {
+    double a = std::log(spec_.minTPS), b = std::log(spec_.maxTPS);
+    return std::exp(a + (b - a) * i / (spec_.tpsPoints - 1));
+}
+
+int SurrogateTable::lLCount() const {
+    return static_cast<int>(edges_.size() - 1) * spec_.lLPointsPerSegment;
+}
+
+double SurrogateTable::lLAt(int j) const {
+    const int P = spec_.lLPointsPerSegment;
+    const int segments = static_cast<int>(edges_.size()) - 1;
+    int seg = j / P, p = j % P;
+    double a = edges_[seg], b = edges_[seg + 1];
+    // Ends sit just inside the segment so they take its side of a jump
+    if (p == 0 && seg > 0) return a + 1e-9 * (b - a);
+    if (p == P - 1 && seg + 1 < segments) return b - 1e-9 * (b - a);
+    return a + (b - a) * p / (P - 1);
+}
+
+double SurrogateTable::durationAt(int k) const {
+    double f = double(k) / (spec_.durationPoints - 1);
+    return spec_.maxDuration * f * f;
+}
+
+Stack SurrogateTable::stackAt(const Stack& layout, const MaterialProperties& props,
+                              double thickness, double l_over_L) const {
+    Stack s = layout;
+    s.layers[0].thickness = thickness;
+    s.layers[1].thickness = props.getCarbonFiberThickness(l_over_L);
+    s.layers[2].thickness = props.getGlueThickness(l_over_L);
+    s.layers[3].thickness = props.getSteelThickness(l_over_L);
+    MaterialProperties gridProps;
+    gridProps.generateGrid(s, spec_.pointsPerLayer);
+    return s;
+}
+
+SurrogateTable SurrogateTable::build(const SurrogateSpec& spec, const Stack& layout,
+                                     const MaterialProperties& props, int numThreads,
+                                     const CancellationToken* cancel) {
+    if (layout.layers.size() != 4 || spec.tpsPoints < 2 || spec.lLPointsPerSegment < 2 || spec.durationPoints < 2
+        || !(spec.minTPS > 0.0) || !(spec.maxTPS > spec.minTPS) || !(spec.dt > 0.0)
+        || !(spec.maxDuration > 0.0) || spec.pointsPerLayer < 2) {
+        throw std::runtime_error("Invalid surrogate table spec");
+    }
+    SurrogateTable table;
+    table.spec_ = spec;
+    for (const auto& layer : layout.layers) table.materials_.push_back(layer.material);
+    table.edges_.push_back(0.0);
+    for (double b : props.getProfileBreakpoints()) {
+        if (b > table.edges_.back() && b < 1.0) table.edges_.push_back(b);
+    }
+    table.edges_.push_back(1.0);
+    const int nL = table.lLCount(), nD = spec.durationPoints;
+    table.values_.assign(size_t(spec.tpsPoints) * nL * nD * kSlots, 0.0f);
+
+    // One run per (thickness, l/L) node, sampled as it passes each duration
+    // node; TimeHandler sums dt the same way for every total time, so the
+    // sample equals a separate run of that duration
+    SliceScheduler scheduler(numThreads);
+    scheduler.run(spec.tpsPoints * nL, [&](int job) {
+        int i = job / nL, j = job % nL;
+        double lL = table.lLAt(j);
+        Stack s = table.stackAt(layout, props, table.tpsAt(i), lL);
+        const size_t idxCG = 2 * (spec.pointsPerLayer - 1), idxGS = 3 * (spec.pointsPerLayer - 1);
+
+        HeatEquationSolver solver(spec.theta);
+        TimeHandler th(spec.maxDuration, spec.dt, false);
+        solver.initialize(s, th);
+        solver.setInitialTemperature(std::vector<double>(s.xGrid.size(), 300.0));
+        solver.setBoundaryConditions(new DirichletCondition(static_cast<float>(props.getExhaustTemp(lL))),
+                                     new NeumannCondition(0.0f));
+        float* out = &table.values_[size_t(job) * nD * kSlots];
+        int k = 0;
+        while (true) {
+            const auto& T = solver.getTemperatureDistribution();
+            for (; k < nD && (k == 0 ? solver.getCurrentTime() >= 0.0
+                                     : solver.getCurrentTime() >= table.durationAt(k)); ++k) {
+                float* v = out + k * kSlots;
+                v[0] = static_cast<float>(T[idxCG]);
+                v[1] = static_cast<float>(T[idxCG + 1]);
+                v[2] = static_cast<float>(T[idxGS]);
+                v[3] = static_cast<float>(T[idxGS + 1]);
+                v[4] = static_cast<float>(T.back());
+            }
+            if (k == nD || solver.isFinished()) break;
+            if (cancel) cancel->throwIfCancelled();
+            solver.step();
+        }
+    });
+
+    // Error estimate: real solves at random off-node points (fixed seed)
+    const int samples = std::max(spec.validationSamples, 0);
+    std::vector<double> errors(samples, 0.0);
+    std::mt19937 rng(20240601u);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::vector<std::array<double, 3>> points(samples);
+    for (auto& p : points) {
+        p[0] = spec.minTPS * std::pow(spec.maxTPS / spec.minTPS, unit(rng));
+        p[1] = unit(rng);
+        p[2] = spec.dt * std::max(1.0, std::round(unit(rng) * spec.maxDuration / spec.dt));
+    }
+    scheduler.run(samples, [&](int n) {
+        const auto& p = points[n];
+        Stack s = table.stackAt(layout, props, p[0], p[1]);
+        size_t idxCG, idxGS;
+        interfaceIndices(s, idxCG, idxGS);
+        HeatEquationSolver solver(spec.theta);
+        solver.initialize(s, TimeHandler(p[2], spec.dt, false));
+        solver.setInitialTemperature(std::vector<double>(s.xGrid.size(), 300.0));
+        solver.setBoundaryConditions(new DirichletCondition(static_cast<float>(props.getExhaustTemp(p[1]))),
+                                     new NeumannCondition(0.0f));
+        while (!solver.isFinished()) {
+            if (cancel) cancel->throwIfCancelled();
+            solver.step();
+        }
+        const auto& T = solver.getTemperatureDistribution();
+        InterfaceTemperatures interp;
+        table.interpolate(s, p[1], p[2], interp);
+        errors[n] = std::max({ std::fabs(interp.carbonGlue - T[idxCG]),
+                               std::fabs(interp.glueSteel - T[idxGS]),
+                               std::fabs(interp.steel - T.back()) });
+    });
+    double sumSq = 0.0;
+    for (double e : errors) {
+        table.maxError_ = std::max(table.maxError_, e);
+        sumSq += e * e;
+    }
+    table.rmsError_ = samples ? std::sqrt(sumSq / samples) : 0.0;
+    return table;
+}
+
+bool SurrogateTable::locate(double thickness, double l_over_L, double duration,
+                            double& u, int& j, double& fv, double& w) const {
+    if (empty()) return false;
+    if (!(thickness >= spec_.minTPS && thickness <= spec_.maxTPS)) return false;
+    if (!(l_over_L >= 0.0 && l_over_L <= 1.0)) return false;
+    if (!(duration >= 0.0 && duration <= spec_.maxDuration)) return false;
+    u = std::log(thickness / spec_.minTPS) / std::log(spec_.maxTPS / spec_.minTPS) * (spec_.tpsPoints - 1);
+    // A query on a breakpoint takes the segment to its right, as floor() does
+    const int P = spec_.lLPointsPerSegment;
+    int seg = static_cast<int>(std::upper_bound(edges_.begin() + 1, edges_.end() - 1, l_over_L)
+                               - (edges_.begin() + 1));
+    double x = (l_over_L - edges_[seg]) / (edges_[seg + 1] - edges_[seg]) * (P - 1);
+    int p = std::min(static_cast<int>(x), P - 2);
+    j = seg * P + p;
+    fv = x - p;
+    w = std::sqrt(duration / spec_.maxDuration) * (spec_.durationPoints - 1);
+    return true;
+}
+
+double SurrogateTable::planeValue(int i, int j, double fv, double w, int slot) const {
+    const int nL = lLCount(), nD = spec_.durationPoints;
+    int k = std::min(static_cast<int>(w), nD - 2);
+    double fw = w - k;
+    auto at = [&](int jj, int kk) {
+        return double(values_[((size_t(i) * nL + jj) * nD + kk) * kSlots + slot]);
+    };
+    double lo = at(j, k)     + fw * (at(j, k + 1)     - at(j, k));
+    double hi = at(j + 1, k) + fw * (at(j + 1, k + 1) - at(j + 1, k));
+    return lo + fv * (hi - lo);
+}
+
+void SurrogateTable::nodeTemperatures(int i, int j, double fv, double w, double tps,
+                                      double carbon, double glue, double out[3]) const {
+    int offCG, offGS;
+    readOffsets(tps, carbon, glue, spec_.pointsPerLayer, offCG, offGS);
+    out[0] = planeValue(i, j, fv, w, 0 + offCG);
+    out[1] = planeValue(i, j, fv, w, 2 + offGS);
+    out[2] = planeValue(i, j, fv, w, 4);
+}
+
+bool SurrogateTable::interpolate(const Stack& stack, double l_over_L, double duration,
+                                 InterfaceTemperatures& temps) const {
+    if (stack.layers.size() != 4) return false;
+    double u, fv, w;
+    int j;
+    const double tps = stack.layers[0].thickness;
+    if (!locate(tps, l_over_L, duration, u, j, fv, w)) return false;
+    int i = std::min(static_cast<int>(u), spec_.tpsPoints - 2);
+    double fu = u - i;
+    // Both thickness planes read the node the query's own grid gives
+    double a[3], b[3];
+    nodeTemperatures(i, j, fv, w, tps, stack.layers[1].thickness, stack.layers[2].thickness, a);
+    nodeTemperatures(i + 1, j, fv, w, tps, stack.layers[1].thickness, stack.layers[2].thickness, b);
+    temps.carbonGlue = a[0] + fu * (b[0] - a[0]);
+    temps.glueSteel  = a[1] + fu * (b[1] - a[1]);
+    temps.steel      = a[2] + fu * (b[2] - a[2]);
+    return true;
+}
+
+bool SurrogateTable::suggestThickness(const Stack& stack, double l_over_L, double duration,
+                                      double maxSteelTemp, double maxGlueTemp, double maxCarbonTemp,
+                                      double& thickness) const {
+    if (stack.layers.size() != 4) return false;
+    double u, fv, w;
+    int j;
+    if (!locate(spec_.minTPS, l_over_L, duration, u, j, fv, w)) return false;
+    // Same order as nodeTemperatures: carbon/glue, glue/steel, steel
+    const double limit[3] = { maxCarbonTemp - maxError_, maxGlueTemp - maxError_, maxSteelTemp - maxError_ };
+    const double carbon = stack.layers[1].thickness, glue = stack.layers[2].thickness;
+
+    // Temperatures fall with thickness: first node under every limit, then
+    // the crossing of the interpolant inside the cell before it
+    double prev[3] = {0, 0, 0};
+    for (int i = 0; i < spec_.tpsPoints; ++i) {
+        double cur[3];
+        nodeTemperatures(i, j, fv, w, tpsAt(i), carbon, glue, cur);
+        bool under = cur[0] < limit[0] && cur[1] < limit[1] && cur[2] < limit[2];
+        if (under) {
+            double f = 0.0;
+            if (i > 0) {
+                for (int c = 0; c < 3; ++c) {
+                    if (prev[c] >= limit[c] && prev[c] > cur[c]) {
+                        f = std::max(f, (prev[c] - limit[c]) / (prev[c] - cur[c]));
+                    }
+                }
+            }
+            double node = (i > 0) ? (i - 1) + f : 0.0;
+            double a = std::log(spec_.minTPS), b = std::log(spec_.maxTPS);
+            // Just past the crossing, so the interpolant is strictly under
+            thickness = std::min(spec_.maxTPS,
+                                 std::exp(a + (b - a) * node / (spec_.tpsPoints - 1)) * (1.0 + 1e-9));
+            return true;
+        }
+        std::copy(cur, cur + 3, prev);
+    }
+    return false;
+}
+
+bool SurrogateTable::matches(const Stack& stack, double l_over_L, const MaterialProperties& props,
+                             double dt, bool adaptive, double theta, int pointsPerLayer,
+                             const GridOptions& grid) const {
+    if (empty() || adaptive || grid.spacing != GridSpacing::Uniform) return false;
+    if (dt != spec_.dt || theta != spec_.theta || pointsPerLayer != spec_.pointsPerLayer) return false;
+    if (stack.layers.size() != materials_.size()) return false;
+    for (size_t l = 0; l < materials_.size(); ++l) {
+        const Material& a = stack.layers[l].material;
+        const Material& b = materials_[l];
+        if (a.k != b.k || a.rho != b.rho || a.c != b.c) return false;
+    }
+    return stack.layers[1].thickness == props.getCarbonFiberThickness(l_over_L)
+        && stack.layers[2].thickness == props.getGlueThickness(l_over_L)
+        && stack.layers[3].thickness == props.getSteelThickness(l_over_L);
+}
+
+bool SurrogateTable::save(const std::string& path) const {
+    if (empty()) return false;
+    FileHeader h{};
+    std::memcpy(h.magic, kMagic, sizeof(kMagic));
+    h.version = kVersion;
+    h.layerCount = static_cast<std::uint32_t>(materials_.size());
+    h.edgeCount = static_cast<std::uint32_t>(edges_.size());
+    h.minTPS = spec_.minTPS;
+    h.maxTPS = spec_.maxTPS;
+    h.maxDuration = spec_.maxDuration;
+    h.dt = spec_.dt;
+    h.theta = spec_.theta;
+    h.tpsPoints = spec_.tpsPoints;
+    h.lLPointsPerSegment = spec_.lLPointsPerSegment;
+    h.durationPoints = spec_.durationPoints;
+    h.pointsPerLayer = spec_.pointsPerLayer;
+    h.maxError = maxError_;
+    h.rmsError = rmsError_;
+    h.valueCount = values_.size();
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+    out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    for (const auto& m : materials_) {
+        FileMaterial fm = { m.k, m.rho, m.c };
+        out.write(reinterpret_cast<const char*>(&fm), sizeof(fm));
+    }
+    out.write(reinterpret_cast<const char*>(edges_.data()),
+              static_cast<std::streamsize>(edges_.size() * sizeof(double)));
+    out.write(reinterpret_cast<const char*>(values_.data()),
+              static_cast<std::streamsize>(values_.size() * sizeof(float)));
+    return static_cast<bool>(out);
+}
+
+bool SurrogateTable::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    FileHeader h{};
+    if (!in.read(reinterpret_cast<char*>(&h), sizeof(h))) return false;
+    if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0 || h.version != kVersion) return false;
+    if (h.tpsPoints < 2 || h.lLPointsPerSegment < 2 || h.durationPoints < 2 || h.layerCount > 64
+        || h.edgeCount < 2 || h.edgeCount > 4096
+        || h.valueCount != std::uint64_t(h.tpsPoints) * (h.edgeCount - 1) * h.lLPointsPerSegment
+                           * h.durationPoints * kSlots) {
+        return false;
+    }
+
+    SurrogateTable t;
+    t.spec_.minTPS = h.minTPS;
+    t.spec_.maxTPS = h.maxTPS;
+    t.spec_.maxDuration = h.maxDuration;
+    t.spec_.dt = h.dt;
+    t.spec_.theta = h.theta;
+    t.spec_.tpsPoints = h.tpsPoints;
+    t.spec_.lLPointsPerSegment = h.lLPointsPerSegment;
+    t.spec_.durationPoints = h.durationPoints;
+    t.spec_.pointsPerLayer = h.pointsPerLayer;
+    t.maxError_ = h.maxError;
+    t.rmsError_ = h.rmsError;
+    for (std::uint32_t l = 0; l < h.layerCount; ++l) {
+        FileMaterial fm;
+        if (!in.read(reinterpret_cast<char*>(&fm), sizeof(fm))) return false;
+        Material m{};
+        m.k = fm.k;
+        m.rho = fm.rho;
+        m.c = fm.c;
+        t.materials_.push_back(m);
+    }
+    t.edges_.resize(h.edgeCount);
+    if (!in.read(reinterpret_cast<char*>(t.edges_.data()),
+                 static_cast<std::streamsize>(t.edges_.size() * sizeof(double)))) {
+        return false;
+    }
+    t.values_.resize(h.valueCount);
+    if (!in.read(reinterpret_cast<char*>(t.values_.data()),
+                 static_cast<std::streamsize>(t.values_.size() * sizeof(float)))) {
+        return false;
+    }
+    *this = std::move(t);
+    return true;
+}
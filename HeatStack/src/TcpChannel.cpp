@@ -0,0 +1,160 @@
+#include "TcpChannel.h"
+#include <cstring>
+#include <stdexcept>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+using SocketHandle = SOCKET;
+#else
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+using SocketHandle = int;
+#define INVALID_SOCKET (-1)
+#endif
+
+namespace {
+
+#ifdef _WIN32
+// WSAStartup once per process, before the first socket
+void startNetwork() {
+    static bool started = [] {
+        WSADATA data;
+        return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+    }();
+    if (!started) throw std::runtime_error("Cannot initialise Winsock");
+}
+void closeSocket(SocketHandle s) { closesocket(s); }
+#else
+void startNetwork() {}
+void closeSocket(SocketHandle s) { ::close(s); }
+#endif
+
+SocketHandle handle(long long s) { return static_cast<SocketHandle>(s); }
+
+// Messages are small request/response lines: send them without delay
+void setNoDelay(SocketHandle s) {
+    int on = 1;
+    setsockopt(s, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&on), sizeof(on));
+}
+
+} // namespace
+
+/////////////////////////////////////////
+// TcpChannel
+/////////////////////////////////////////
+TcpChannel::TcpChannel(long long socket) : socket_(socket) {}
+
+TcpChannel::~TcpChannel() {
+    closeSocket(handle(socket_));
+}
+
+std::unique_ptr<TcpChannel> TcpChannel::connect(const std::string& host, int port) {
+    startNetwork();
+    addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addresses = nullptr;
+    const std::string where = host + ":" + std::to_string(port);
+    if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses) != 0) {
+        throw std::runtime_error("Cannot resolve worker " + where);
+    }
+    SocketHandle s = INVALID_SOCKET;
+    for (addrinfo* a = addresses; a; a = a->ai_next) {
+        s = ::socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+        if (s == INVALID_SOCKET) continue;
+        if (::connect(s, a->ai_addr, static_cast<int>(a->ai_addrlen)) == 0) break;
+        closeSocket(s);
+        s = INVALID_SOCKET;
+    }
+    freeaddrinfo(addresses);
+    if (s == INVALID_SOCKET) throw std::runtime_error("Cannot connect to worker " + where);
+    setNoDelay(s);
+    return std::unique_ptr<TcpChannel>(new TcpChannel(static_cast<long long>(s)));
+}
+
+bool TcpChannel::readLine(std::string& line) {
+    for (;;) {
+        std::size_t end = buffer_.find('\n');
+        if (end != std::string::npos) {
+            line.assign(buffer_, 0, end);
+            buffer_.erase(0, end + 1);
+            return true;
+        }
+        char chunk[65536];
+        auto n = ::recv(handle(socket_), chunk, sizeof(chunk), 0);
+        if (n <= 0) return false;
+        buffer_.append(chunk, static_cast<std::size_t>(n));
+    }
+}
+
+bool TcpChannel::writeLine(const std::string& line) {
+    std::string message = line + "\n";
+    const char* data = message.data();
+    std::size_t left = message.size();
+    while (left > 0) {
+#ifdef _WIN32
+        int n = ::send(handle(socket_), data, static_cast<int>(left), 0);
+#else
+        auto n = ::send(handle(socket_), data, left, MSG_NOSIGNAL);
+#endif
+        if (n <= 0) return false;
+        data += n;
+        left -= static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+/////////////////////////////////////////
+// TcpListener
+/////////////////////////////////////////
+TcpListener::TcpListener(int port, const std::string& bindAddress) : socket_(-1), port_(port) {
+    startNetwork();
+    addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE;
+    addrinfo* addresses = nullptr;
+    const std::string where = bindAddress + ":" + std::to_string(port);
+    if (getaddrinfo(bindAddress.c_str(), std::to_string(port).c_str(), &hints, &addresses) != 0) {
+        throw std::runtime_error("Cannot resolve listen address " + where);
+    }
+    SocketHandle s = INVALID_SOCKET;
+    for (addrinfo* a = addresses; a; a = a->ai_next) {
+        s = ::socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+        if (s == INVALID_SOCKET) continue;
+        int on = 1;
+        setsockopt(s, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&on), sizeof(on));
+        if (::bind(s, a->ai_addr, static_cast<int>(a->ai_addrlen)) == 0 && ::listen(s, 8) == 0) break;
+        closeSocket(s);
+        s = INVALID_SOCKET;
+    }
+    freeaddrinfo(addresses);
+    if (s == INVALID_SOCKET) throw std::runtime_error("Cannot listen on " + where);
+
+    sockaddr_storage address;
+    socklen_t length = sizeof(address);
+    if (::getsockname(s, reinterpret_cast<sockaddr*>(&address), &length) == 0) {
+        if (address.ss_family == AF_INET6) port_ = ntohs(reinterpret_cast<sockaddr_in6*>(&address)->sin6_port);
+        else port_ = ntohs(reinterpret_cast<sockaddr_in*>(&address)->sin_port);
+    }
+    socket_ = static_cast<long long>(s);
+}
+
+TcpListener::~TcpListener() {
+    closeSocket(handle(socket_));
+}
+
+std::unique_ptr<TcpChannel> TcpListener::accept() {
+    SocketHandle s = ::accept(handle(socket_), nullptr, nullptr);
+    if (s == INVALID_SOCKET) throw std::runtime_error("Cannot accept a connection on port " + std::to_string(port_));
+    setNoDelay(s);
+    return std::unique_ptr<TcpChannel>(new TcpChannel(static_cast<long long>(s)));
+}
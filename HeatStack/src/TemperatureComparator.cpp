@@ -2,9 +2,27 @@
 #include "HeatEquationSolver.h"
 #include "TimeHandler.h"
 #include "BoundaryConditions.h"
+#include "SliceScheduler.h"
+#include "Profiler.h"
+#include "SurrogateTable.h"
 #include <iostream>
 #include <cmath>
 #include <algorithm>
+#include <array>
+
+namespace {
+
+// Carbon/glue, glue/steel and inner steel values of a per-node vector
+InterfaceTemperatures readInterfaces(const Stack& stack, const std::vector<double>& values) {
+    std::array<int, 3> nodes = interfaceNodes(stack);
+    InterfaceTemperatures out;
+    out.carbonGlue = values[nodes[0]];
+    out.glueSteel  = values[nodes[1]];
+    out.steel      = values[nodes[2]];
+    return out;
+}
+
+} // namespace
 
 TemperatureComparator::TemperatureComparator() {}
 
@@ -21,72 +39,363 @@ double TemperatureComparator::suggestTPSThickness(
         const MaterialProperties& props,
         double theta) 
     {
+    surrogateHit = false;
+    double suggested;
+    if (surrogate && !surfaceProfile && stepOptions.steadyStateRate <= 0.0
+        && surrogate->matches(stack, l_over_L, props, compDt, compAdapt, theta, compPoints, gridOptions)
+        && surrogate->suggestThickness(stack, l_over_L, duration, maxSteelTemp, maxGlueTemp,
+                                       maxCarbonTemp, suggested)
+        && meetsLimits(stack, suggested, maxSteelTemp, maxGlueTemp, maxCarbonTemp,
+                       duration, l_over_L, theta, 0.0)) {
+        surrogateHit = true;
+        return suggested;
+    }
+    if (method == SearchMethod::Newton) {
+        return newtonTPSThickness(stack, maxSteelTemp, maxGlueTemp, maxCarbonTemp,
+                                  duration, l_over_L, props, theta);
+    }
+    if (searchWays > 2) {
+        return ksectTPSThickness(stack, maxSteelTemp, maxGlueTemp, maxCarbonTemp,
+                                 duration, l_over_L, props, theta);
+    }
+    return bisectTPSThickness(stack, maxSteelTemp, maxGlueTemp, maxCarbonTemp,
+                              duration, l_over_L, props, theta);
+}
+
+double TemperatureComparator::bisectTPSThickness(
+        const Stack& stack,
+        double maxSteelTemp,
+        double maxGlueTemp,
+        double maxCarbonTemp,
+        double duration,
+        double l_over_L,
+        const MaterialProperties& props,
+        double theta)
+    {
     double minThickness = props.getMinTPSThickness();
     double maxThickness = props.getMaxTPSThickness();
     double tolerance = 0.00001; // 0.001 cm
     double thickness = minThickness;
+    double unused;
+    resumeSearch(minThickness, maxThickness, thickness, unused);
 
     while (maxThickness - minThickness > tolerance) {
+        Profiler::count(ProfileCounter::SearchIterations);
         thickness = (minThickness + maxThickness) / 2.0;
-        Stack testStack = stack;
-        testStack.layers[0].thickness = thickness;
-        MaterialProperties tempProps;
-        tempProps.generateGrid(testStack, compPoints);
-
-        // std::vector<double> temperatures = runSimulation(testStack, duration, theta, l_over_L);
-        // double steelTemp = temperatures.back();
-        // std::cerr << "[cmp] steelTemp=" << steelTemp << "\n";
-
-        std::vector<double> temperatures =
-            runSimulation(testStack, duration, theta, l_over_L);
-        // compute each interface temperature
-        const auto& xGrid = testStack.xGrid;
-        double tpsThick    = testStack.layers[0].thickness;
-        double carbonThick = testStack.layers[1].thickness;
-        double glueThick   = testStack.layers[2].thickness;
-        double posCarbonGlue = tpsThick + carbonThick;
-        double posGlueSteel  = posCarbonGlue + glueThick;
-        auto idxCarbonGlue = std::lower_bound(xGrid.begin(), xGrid.end(), posCarbonGlue)
-                          - xGrid.begin();
-        auto idxGlueSteel  = std::lower_bound(xGrid.begin(), xGrid.end(), posGlueSteel)
-                          - xGrid.begin();
-        double carbonTemp = temperatures[idxCarbonGlue];
-        double glueTemp   = temperatures[idxGlueSteel];
-        double steelTemp  = temperatures.back();
-
-       bool allUnder = (steelTemp < maxSteelTemp)
-                     && (glueTemp  < maxGlueTemp)
-                     && (carbonTemp< maxCarbonTemp);
+        bool allUnder = meetsLimits(stack, thickness, maxSteelTemp, maxGlueTemp,
+                                    maxCarbonTemp, duration, l_over_L, theta,
+                                    maxThickness - minThickness);
 
         if (allUnder) {
         maxThickness = thickness;
         } else {
             minThickness = thickness;
         }
+        recordRound(minThickness, maxThickness, thickness, 0.0);
+    }
+    // Upper end of the final bracket: the thinnest thickness known to pass
+    // (the last midpoint may be one that failed)
+    return maxThickness;
+}
+
+double TemperatureComparator::ksectTPSThickness(
+        const Stack& stack,
+        double maxSteelTemp,
+        double maxGlueTemp,
+        double maxCarbonTemp,
+        double duration,
+        double l_over_L,
+        const MaterialProperties& props,
+        double theta)
+    {
+    double minThickness = props.getMinTPSThickness();
+    double maxThickness = props.getMaxTPSThickness();
+    double tolerance = 0.00001; // 0.001 cm
+    int k = searchWays;
+    double unused, unusedStep;
+    resumeSearch(minThickness, maxThickness, unused, unusedStep);
+
+    SliceScheduler scheduler(searchThreads);
+    std::vector<double> candidates(k - 1);
+    std::vector<char> under(k - 1);
+
+    while (maxThickness - minThickness > tolerance) {
+        Profiler::count(ProfileCounter::SearchIterations);
+        double width = maxThickness - minThickness;
+        for (int j = 1; j < k; ++j) {
+            candidates[j - 1] = minThickness + width * j / k;
+        }
+
+        scheduler.run(k - 1, [&](int j) {
+            under[j] = meetsLimits(stack, candidates[j], maxSteelTemp, maxGlueTemp,
+                                   maxCarbonTemp, duration, l_over_L, theta, width);
+        });
+
+        // Temperatures fall monotonically with thickness: keep the interval
+        // between the last failing and the first passing candidate
+        int firstUnder = k - 1;
+        for (int j = 0; j < k - 1; ++j) {
+            if (under[j]) { firstUnder = j; break; }
+        }
+        double lo = (firstUnder == 0) ? minThickness : candidates[firstUnder - 1];
+        double hi = (firstUnder == k - 1) ? maxThickness : candidates[firstUnder];
+        minThickness = lo;
+        maxThickness = hi;
+        recordRound(minThickness, maxThickness, maxThickness, 0.0);
+    }
+    // Upper end of the final bracket: the thinnest thickness known to pass
+    return maxThickness;
+}
+
+double TemperatureComparator::newtonTPSThickness(
+        const Stack& stack,
+        double maxSteelTemp,
+        double maxGlueTemp,
+        double maxCarbonTemp,
+        double duration,
+        double l_over_L,
+        const MaterialProperties& props,
+        double theta)
+    {
+    double minThickness = props.getMinTPSThickness();
+    double maxThickness = props.getMaxTPSThickness();
+    double tolerance = 0.00001; // 0.001 cm, as bisection
+    const double initialTemp = 300.0; // runSimulationAs starts from room temperature
+    const double limit[3] = { maxSteelTemp, maxGlueTemp, maxCarbonTemp };
+
+    // Newton on g = max over the limits of log((T - T0) / (limit - T0)) in
+    // log thickness: T - T0 decays like the tail of the penetration profile,
+    // which this makes close to linear, where T - limit saturates at both ends
+    double thickness = std::sqrt(minThickness * maxThickness);
+    double lastStep = std::log(maxThickness / minThickness);
+    resumeSearch(minThickness, maxThickness, thickness, lastStep);
+
+    while (maxThickness - minThickness > tolerance) {
+        Profiler::count(ProfileCounter::SearchIterations);
+        InterfaceTemperatures temps, slopes;
+        bool haveSlope = trialSlopes(stack, thickness, duration, l_over_L, theta, temps, slopes);
+        const double T[3]  = { temps.steel, temps.glueSteel, temps.carbonGlue };
+        const double dT[3] = { slopes.steel, slopes.glueSteel, slopes.carbonGlue };
+
+        bool under = true;
+        double g = -HUGE_VAL, dg = 0.0;
+        for (int c = 0; c < 3; ++c) {
+            under = under && T[c] < limit[c];
+            double rise = T[c] - initialTemp;
+            if (rise <= 0.0 || limit[c] <= initialTemp) continue;
+            double gc = std::log(rise / (limit[c] - initialTemp));
+            if (gc > g) {
+                g = gc;
+                dg = dT[c] / rise * thickness; // d(g)/d(log thickness)
+            }
+        }
+        if (under) maxThickness = thickness;
+        else       minThickness = thickness;
+        if (maxThickness - minThickness <= tolerance) {
+            recordRound(minThickness, maxThickness, thickness, lastStep);
+            break;
+        }
+
+        // Newton aimed half a tolerance past the root, onto the side of the
+        // bracket that has not moved, so the bracket closes from both ends.
+        // Bisect when there is no slope, the step leaves the bracket, or it
+        // is not at least halving (rtsafe's safeguard)
+        double next = -1.0;
+        double step = 0.0;
+        if (haveSlope && dg < 0.0 && std::isfinite(g)) {
+            step = -g / dg;
+            next = thickness * std::exp(step) + (under ? -0.5 : 0.5) * tolerance;
+        }
+        if (!(next > minThickness && next < maxThickness) || std::fabs(step) > 0.5 * lastStep) {
+            next = (minThickness + maxThickness) / 2.0;
+            step = std::log(next / thickness);
+        }
+        lastStep = std::fabs(step);
+        thickness = next;
+        recordRound(minThickness, maxThickness, thickness, lastStep);
+    }
+    // Upper end of the final bracket: the thinnest thickness known to pass
+    return maxThickness;
+}
+
+bool TemperatureComparator::meetsLimits(const Stack& stack, double thickness,
+                                        double maxSteelTemp, double maxGlueTemp,
+                                        double maxCarbonTemp, double duration,
+                                        double l_over_L, double theta, double bracketWidth) {
+    bool singlePrecision = precision == SearchPrecision::Float
+        || (precision == SearchPrecision::Mixed && bracketWidth > getMixedRefineWidth());
+    // A trial may stop once an interface reaches its limit: it fails either
+    // way. Float trials of Mixed stop a guard past it, where double could
+    // not disagree.
+    double guard = (singlePrecision && precision == SearchPrecision::Mixed) ? getMixedGuard() : 0.0;
+    InterfaceTemperatures stopAt;
+    stopAt.carbonGlue = maxCarbonTemp + guard;
+    stopAt.glueSteel  = maxGlueTemp + guard;
+    stopAt.steel      = maxSteelTemp + guard;
+    bool stopped = false;
+    InterfaceTemperatures temps = trialTemperatures(stack, thickness, duration, l_over_L,
+                                                    theta, singlePrecision, &stopAt, &stopped);
+    if (stopped) return false;
+
+    // Too close to call in float: let double decide
+    if (singlePrecision && precision == SearchPrecision::Mixed) {
+        double margin = std::min({ std::fabs(temps.steel - maxSteelTemp),
+                                   std::fabs(temps.glueSteel - maxGlueTemp),
+                                   std::fabs(temps.carbonGlue - maxCarbonTemp) });
+        if (margin < getMixedGuard()) {
+            temps = trialTemperatures(stack, thickness, duration, l_over_L, theta, false);
+        }
+    }
+
+    return (temps.steel      < maxSteelTemp)
+        && (temps.glueSteel  < maxGlueTemp)
+        && (temps.carbonGlue < maxCarbonTemp);
+}
+
+InterfaceTemperatures TemperatureComparator::trialTemperatures(const Stack& stack, double thickness,
+                                                               double duration, double l_over_L,
+                                                               double theta, bool singlePrecision,
+                                                               const InterfaceTemperatures* stopAt,
+                                                               bool* stopped) {
+    Stack testStack = stack;
+    testStack.layers[0].thickness = thickness;
+
+    InterfaceTemperatures temps;
+    std::string key;
+    if (cache && !surfaceProfile) {
+        key = SimulationCache::makeKey(testStack, compPoints, compDt, compAdapt, theta,
+                                       duration, surfaceTemperature(l_over_L), singlePrecision,
+                                       gridOptions, stepOptions);
+        if (cache->lookup(key, temps)) return temps;
     }
-    return thickness;
+
+    HS_PROFILE_ZONE("tps_search.trial");
+    Profiler::count(ProfileCounter::TrialRuns);
+    MaterialProperties tempProps;
+    tempProps.setGridOptions(gridOptions);
+    tempProps.generateGrid(testStack, compPoints);
+
+    if (!canStopEarly(theta, l_over_L)) stopAt = nullptr;
+    bool stoppedEarly = false;
+    std::vector<double> temperatures = singlePrecision
+        ? runSimulationAs<float>(testStack, duration, theta, l_over_L, nullptr, stopAt, &stoppedEarly)
+        : runSimulationAs<double>(testStack, duration, theta, l_over_L, nullptr, stopAt, &stoppedEarly);
+    // compute each interface temperature
+    temps = readInterfaces(testStack, temperatures);
+    if (stopped) *stopped = stoppedEarly;
+    if (stoppedEarly) {
+        Profiler::count(ProfileCounter::EarlyStops);
+        return temps;
+    }
+
+    if (cache && !surfaceProfile) cache->store(key, temps);
+    return temps;
+}
+
+bool TemperatureComparator::trialSlopes(const Stack& stack, double thickness, double duration,
+                                        double l_over_L, double theta, InterfaceTemperatures& temps,
+                                        InterfaceTemperatures& slopes) {
+    bool singlePrecision = precision == SearchPrecision::Float;
+    if (compAdapt || gridOptions.spacing != GridSpacing::Uniform) {
+        temps = trialTemperatures(stack, thickness, duration, l_over_L, theta, singlePrecision);
+        return false;
+    }
+    Stack testStack = stack;
+    testStack.layers[0].thickness = thickness;
+
+    std::string key;
+    if (cache && !surfaceProfile) {
+        key = SimulationCache::makeKey(testStack, compPoints, compDt, compAdapt, theta,
+                                       duration, surfaceTemperature(l_over_L), singlePrecision,
+                                       gridOptions, stepOptions);
+        if (cache->lookup(key, temps)) return false;
+    }
+
+    HS_PROFILE_ZONE("tps_search.trial");
+    Profiler::count(ProfileCounter::TrialRuns);
+    MaterialProperties tempProps;
+    tempProps.generateGrid(testStack, compPoints);
+
+    std::vector<double> sensitivity;
+    std::vector<double> temperatures = singlePrecision
+        ? runSimulationAs<float>(testStack, duration, theta, l_over_L, &sensitivity)
+        : runSimulationAs<double>(testStack, duration, theta, l_over_L, &sensitivity);
+    temps  = readInterfaces(testStack, temperatures);
+    slopes = readInterfaces(testStack, sensitivity);
+
+    if (cache && !surfaceProfile) cache->store(key, temps);
+    return true;
+}
+
+double TemperatureComparator::surfaceTemperature(double l_over_L) const {
+    return MaterialProperties::getExhaustTemp(l_over_L); // Exhaust gas temperature
+}
+
+BoundaryCondition* TemperatureComparator::surfaceCondition(double l_over_L) const {
+    if (surfaceProfile) return new TabulatedCondition(surfaceProfile);
+    return new DirichletCondition(static_cast<float>(surfaceTemperature(l_over_L)));
 }
 
 std::vector<double> TemperatureComparator::runSimulation(Stack stack, double duration, double theta, double l_over_L) {
+    return runSimulationAs<double>(stack, duration, theta, l_over_L);
+}
+
+bool TemperatureComparator::canStopEarly(double theta, double l_over_L) const {
+    // BTCS from a uniform start under a constant surface hotter than it:
+    // each step's change is the previous one through a nonnegative inverse
+    // (M-matrix), so no temperature ever falls
+    const double initialTemp = 300.0; // runSimulationAs starts from room temperature
+    if (!earlyStop || theta != 1.0) return false;
+    if (surfaceProfile) {
+        return !surfaceProfile->isTimeDependent() && surfaceProfile->valueAt(0.0, l_over_L) >= initialTemp;
+    }
+    return surfaceTemperature(l_over_L) >= initialTemp;
+}
+
+template <typename Real>
+std::vector<double> TemperatureComparator::runSimulationAs(const Stack& stack, double duration, double theta, double l_over_L,
+                                                           std::vector<double>* sensitivity,
+                                                           const InterfaceTemperatures* stopAt, bool* stopped) {
     TimeHandler timeHandler(duration, compDt, compAdapt);
-    HeatEquationSolver solver(theta);
+    timeHandler.setTimeStepLimits(stepOptions.minTimeStep, stepOptions.maxTimeStep);
+    BasicHeatEquationSolver<Real> solver(theta);
     solver.initialize(stack, timeHandler);
+    solver.setAdaptiveTolerance(stepOptions.adaptiveTolerance);
+    solver.setSteadyStateTolerance(stepOptions.steadyStateRate);
+    if (sensitivity) solver.enableThicknessSensitivity(0);
 
     // Set initial temperature (room temperature: 300K)
     std::vector<double> initialTemp(stack.xGrid.size(), 300.0);
     solver.setInitialTemperature(initialTemp);
 
     // Set boundary conditions (Dirichlet with exhaust gas temp, Neumann)
-    double T_surface = -100 * std::log(8 * l_over_L + 1) + 900; // Exhaust gas temperature
-    solver.setBoundaryConditions(new DirichletCondition(static_cast<float>(T_surface)), new NeumannCondition(0.0f));
+    solver.setBoundaryConditions(surfaceCondition(l_over_L), new NeumannCondition(0.0f));
+    solver.setBoundaryPosition({ 0.0f, 0.0f, static_cast<float>(l_over_L) });
 
 
-    // Run simulation
-    while (!solver.isFinished()) {
-        solver.step();
-        // timeHandler.advance();
+    // Run simulation, polling the token between steps
+    CallbackObserver<Real> cancel([this](double, const std::vector<Real>&) {
+        if (cancelToken) cancelToken->throwIfCancelled();
+        return true;
+    });
+    LimitMonitor<Real> limits;
+    std::vector<BasicStepObserver<Real>*> observers = { &cancel };
+    if (stopAt) {
+        std::array<int, 3> nodes = interfaceNodes(stack);
+        limits.addLimit("carbon/glue", nodes[0], stopAt->carbonGlue);
+        limits.addLimit("glue/steel",  nodes[1], stopAt->glueSteel);
+        limits.addLimit("steel",       nodes[2], stopAt->steel);
+        observers.push_back(&limits);
+    }
+    if (cancelToken) cancelToken->throwIfCancelled();
+    RunResult result = solver.run(observers);
+    if (stopped) *stopped = result.reason == StopReason::Observer && limits.exceededLimit() >= 0;
+    if (sensitivity) {
+        const auto& S = solver.getThicknessSensitivity();
+        sensitivity->assign(S.begin(), S.end());
     }
-    return solver.getTemperatureDistribution();
+    const auto& T = solver.getTemperatureDistribution();
+    return std::vector<double>(T.begin(), T.end());
 }
 
 
@@ -97,4 +406,83 @@ void TemperatureComparator::setTimeStep(double dt, bool adaptive) {
 
 void TemperatureComparator::setGridResolution(int pointsPerLayer) {
     compPoints = pointsPerLayer;
+}
+
+void TemperatureComparator::setAdaptiveTolerance(double tolerance) {
+    if (tolerance > 0.0) stepOptions.adaptiveTolerance = tolerance;
+}
+
+void TemperatureComparator::setTimeStepLimits(double minTimeStep, double maxTimeStep) {
+    stepOptions.minTimeStep = minTimeStep;
+    stepOptions.maxTimeStep = maxTimeStep;
+}
+
+void TemperatureComparator::setSteadyStateTolerance(double rate) {
+    stepOptions.steadyStateRate = rate;
+}
+
+void TemperatureComparator::setSearchWays(int ways) {
+    searchWays = std::max(2, ways);
+}
+
+void TemperatureComparator::setSearchThreads(int numThreads) {
+    searchThreads = numThreads;
+}
+
+void TemperatureComparator::setSearchMethod(SearchMethod searchMethod) {
+    method = searchMethod;
+}
+
+void TemperatureComparator::setSearchProgress(SearchProgress* searchProgress, std::function<void()> callback) {
+    progress = searchProgress;
+    onRound = std::move(callback);
+}
+
+bool TemperatureComparator::resumeSearch(double& minThickness, double& maxThickness,
+                                         double& thickness, double& lastStep) const {
+    if (!progress || progress->rounds <= 0) return false;
+    minThickness = progress->minThickness;
+    maxThickness = progress->maxThickness;
+    thickness = progress->thickness;
+    lastStep = progress->lastStep;
+    return true;
+}
+
+void TemperatureComparator::recordRound(double minThickness, double maxThickness,
+                                        double thickness, double lastStep) {
+    if (!progress) return;
+    ++progress->rounds;
+    progress->minThickness = minThickness;
+    progress->maxThickness = maxThickness;
+    progress->thickness = thickness;
+    progress->lastStep = lastStep;
+    if (onRound) onRound();
+}
+
+void TemperatureComparator::setCache(SimulationCache* resultCache) {
+    cache = resultCache;
+}
+
+void TemperatureComparator::setPrecision(SearchPrecision searchPrecision) {
+    precision = searchPrecision;
+}
+
+void TemperatureComparator::setGridOptions(const GridOptions& options) {
+    gridOptions = options;
+}
+
+void TemperatureComparator::setSurrogate(const SurrogateTable* table) {
+    surrogate = table;
+}
+
+void TemperatureComparator::setSurfaceProfile(const BoundaryProfile* profile) {
+    surfaceProfile = profile;
+}
+
+void TemperatureComparator::setEarlyStop(bool enabled) {
+    earlyStop = enabled;
+}
+
+void TemperatureComparator::setCancellationToken(const CancellationToken* token) {
+    cancelToken = token;
 }
\ No newline at end of file
@@ -3,44 +3,53 @@
 #include <stdexcept>
 #include <sstream>
 
-TemperatureDistribution::TemperatureDistribution() {}
+template <typename Real>
+BasicTemperatureDistribution<Real>::BasicTemperatureDistribution() {}
 
-TemperatureDistribution::~TemperatureDistribution() {}
+template <typename Real>
+BasicTemperatureDistribution<Real>::~BasicTemperatureDistribution() {}
 
-void TemperatureDistribution::initialize(int size, double defaultValue) {
+template <typename Real>
+void BasicTemperatureDistribution<Real>::initialize(int size, Real defaultValue) {
     temperatures.resize(size, defaultValue);
 }
 
-std::vector<double>& TemperatureDistribution::data() {
+template <typename Real>
+std::vector<Real>& BasicTemperatureDistribution<Real>::data() {
     return temperatures;
 }
 
-const std::vector<double>& TemperatureDistribution::data() const {
+template <typename Real>
+const std::vector<Real>& BasicTemperatureDistribution<Real>::data() const {
     return temperatures;
 }
 
-void TemperatureDistribution::update(const std::vector<double>& newTemperatures) {
+template <typename Real>
+void BasicTemperatureDistribution<Real>::update(const std::vector<Real>& newTemperatures) {
     if (newTemperatures.size() != temperatures.size()) {
         throw std::invalid_argument("Error: Size of new temperature data does not match the current distribution size.");
     }
     temperatures = newTemperatures;
 }
 
-double TemperatureDistribution::getTemperatureAt(int index) const {
+template <typename Real>
+Real BasicTemperatureDistribution<Real>::getTemperatureAt(int index) const {
     if (index < 0 || index >= static_cast<int>(temperatures.size())) {
         throw std::out_of_range("Error: Index out of range.");
     }
     return temperatures[index];
 }
 
-std::vector<double> TemperatureDistribution::getTemperatureRange(int start, int end) const {
+template <typename Real>
+std::vector<Real> BasicTemperatureDistribution<Real>::getTemperatureRange(int start, int end) const {
     if (start < 0 || end >= static_cast<int>(temperatures.size()) || start > end) {
         throw std::out_of_range("Error: Invalid range specified.");
     }
-    return std::vector<double>(temperatures.begin() + start, temperatures.begin() + end + 1);
+    return std::vector<Real>(temperatures.begin() + start, temperatures.begin() + end + 1);
 }
 
-void TemperatureDistribution::exportToFile(const std::string& filename) const {
+template <typename Real>
+void BasicTemperatureDistribution<Real>::exportToFile(const std::string& filename) const {
     std::ofstream file(filename);
     if (!file.is_open()) {
         throw std::runtime_error("Error: Unable to open file " + filename);
@@ -53,4 +62,7 @@ void TemperatureDistribution::exportToFile(const std::string& filename) const {
         }
     }
     file.close();
-}
\ No newline at end of file
+}
+
+template class BasicTemperatureDistribution<float>;
+template class BasicTemperatureDistribution<double>;
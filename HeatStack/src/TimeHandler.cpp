@@ -1,13 +1,23 @@
 #include "TimeHandler.h"
+#include <algorithm>
+#include <cmath>
+#include <istream>
+#include <ostream>
 
 TimeHandler::TimeHandler(double totalTime_, double initialTimeStep, bool adaptive_)
-    : totalTime(totalTime_), dt(initialTimeStep), currentTime(0.0), adaptive(adaptive_), stepCount(0) {}
+    : totalTime(totalTime_), dt(initialTimeStep), currentTime(0.0), adaptive(adaptive_), stepCount(0),
+      minDt(initialTimeStep * 1e-3), maxDt(std::max(totalTime_, initialTimeStep)), prevError(0.0) {}
 
 void TimeHandler::advance() {
     currentTime += dt;
     stepCount++;
 }
 
+void TimeHandler::advance(double stepDt) {
+    currentTime += stepDt;
+    stepCount++;
+}
+
 double TimeHandler::getCurrentTime() const {
     return currentTime;
 }
@@ -26,9 +36,45 @@ int TimeHandler::getStepCount() const {
 
 void TimeHandler::adjustTimeStep(double newTimeStep) {
     if (adaptive) {
-        dt = newTimeStep;
-        // Optional: add logging or safety checks
+        dt = std::clamp(newTimeStep, minDt, maxDt);
+    }
+}
+
+void TimeHandler::setTimeStepLimits(double minTimeStep, double maxTimeStep) {
+    if (minTimeStep > 0.0) minDt = minTimeStep;
+    if (maxTimeStep > 0.0) maxDt = maxTimeStep;
+    if (maxDt < minDt) maxDt = minDt;
+}
+
+double TimeHandler::getMinTimeStep() const {
+    return minDt;
+}
+
+double TimeHandler::getMaxTimeStep() const {
+    return maxDt;
+}
+
+double TimeHandler::proposeTimeStep(double stepDt, double error, double tolerance, int order, bool accepted) {
+    const double safety = 0.9;
+    const double minFactor = 0.2, maxFactor = 5.0;
+    double k = order + 1.0;
+
+    double factor;
+    if (error <= 0.0) {
+        factor = maxFactor;
+    } else {
+        // Gustafsson PI: integral term on this error, proportional term on
+        // its change since the last accepted step
+        factor = safety * std::pow(tolerance / error, 0.7 / k);
+        if (accepted && prevError > 0.0) {
+            factor *= std::pow(prevError / tolerance, 0.4 / k);
+        }
     }
+    if (accepted) prevError = error;
+    else factor = std::min(factor, 1.0); // never grow right after a rejection
+
+    factor = std::clamp(factor, minFactor, maxFactor);
+    return std::clamp(stepDt * factor, minDt, maxDt);
 }
 
 bool TimeHandler::isAdaptive() const {
@@ -38,3 +84,25 @@ bool TimeHandler::isAdaptive() const {
 bool TimeHandler::isFinished() const {
     return currentTime >= totalTime;
 }
+
+void TimeHandler::save(std::ostream& out) const {
+    const double values[5] = { dt, currentTime, minDt, maxDt, prevError };
+    const int flags[2] = { stepCount, adaptive ? 1 : 0 };
+    out.write(reinterpret_cast<const char*>(values), sizeof(values));
+    out.write(reinterpret_cast<const char*>(flags), sizeof(flags));
+}
+
+bool TimeHandler::load(std::istream& in) {
+    double values[5];
+    int flags[2];
+    if (!in.read(reinterpret_cast<char*>(values), sizeof(values)) ||
+        !in.read(reinterpret_cast<char*>(flags), sizeof(flags))) return false;
+    dt = values[0];
+    currentTime = values[1];
+    minDt = values[2];
+    maxDt = values[3];
+    prevError = values[4];
+    stepCount = flags[0];
+    adaptive = flags[1] != 0;
+    return true;
+}
@@ -3,12 +3,31 @@
 #include "MaterialProperties.h"
 #include "InitialTemperature.h"
 #include "HeatEquationSolver.h"
+#include "CoupledSliceSolver.h"
 #include "TemperatureComparator.h"
+#include "SliceScheduler.h"
+#include "SliceRun.h"
+#include "SimulationCache.h"
+#include "HistoryWriter.h"
+#include "ParameterSweep.h"
+#include "HeatStackService.h"
+#include "SliceCoordinator.h"
+#include "TcpChannel.h"
+#include "SurrogateTable.h"
+#include "SnapshotStore.h"
+#include "Checkpoint.h"
+#include "Profiler.h"
+#include "MeshGroups.h"
+#include "SliceIndex.h"
+#include "StackAssignment.h"
 #include <iostream>
+#include <memory>
 #include <fstream>
 #include <vector>
 #include <chrono>
 #include <algorithm> 
+#include <filesystem>
+#include <iomanip>
 #include <sstream>
 #include <fstream>
 
@@ -16,6 +35,304 @@
 using Clock = std::chrono::high_resolution_clock;
 using MS    = std::chrono::duration<double, std::milli>;
 
+// Results and timings produced by one slice task
+struct SliceOutput {
+    std::string summaryRow;
+    std::string detailsRow;
+    double tStackSetup          = 0.0;
+    double tOrigSolve           = 0.0;
+    double tHistOrigSave        = 0.0;
+    double tOptSolve            = 0.0;
+    double tOptSuggestion       = 0.0;
+    double tHistOptSave         = 0.0;
+    double tSummaryDetailsWrite = 0.0;
+
+    // Optimized stack and probe indices, kept for the coupled --lateral run
+    Stack  optStack;
+    double lL          = 0.0;
+    double steelOpt    = 0.0;
+    size_t idxCarbonGlue = 0;
+    size_t idxGlueSteel  = 0;
+    bool   fromSurrogate = false; // TPS suggestion came from --surrogate
+};
+
+// --precision value as the TPS search setting (CLI has validated it)
+static SearchPrecision searchPrecision(const CLI& cli) {
+    if (cli.getPrecision() == "float") return SearchPrecision::Float;
+    if (cli.getPrecision() == "mixed") return SearchPrecision::Mixed;
+    return SearchPrecision::Double;
+}
+
+// --search-method value as the TPS search setting (CLI has validated it)
+static SearchMethod searchMethod(const CLI& cli) {
+    return cli.getSearchMethod() == "newton" ? SearchMethod::Newton : SearchMethod::Bisection;
+}
+
+// --grid settings; the Fourier target refers to the run's (initial) dt
+static GridOptions gridOptions(const CLI& cli, double dt) {
+    GridOptions grid;
+    if (cli.getGridSpacing() == "clustered") grid.spacing = GridSpacing::Clustered;
+    grid.timeStep      = dt;
+    grid.targetFourier = cli.getGridFourier();
+    grid.stretchRatio  = cli.getGridStretch();
+    return grid;
+}
+
+// Settings that decide a slice's results and history files; checkpoints
+// written under other settings are not resumed
+static std::string runKey(const CLI& cli) {
+    std::ostringstream key;
+    key << std::setprecision(17)
+        << cli.getMeshFile() << ";" << cli.getInitFile() << ";" << cli.getNumSlices() << ";"
+        << cli.getPointsPerLayer() << ";" << cli.getTimeDuration() << ";" << cli.getTimeStep() << ";"
+        << cli.useAdaptiveTimeStep() << ";" << cli.getAdaptiveTolerance() << ";"
+        << cli.getMinTimeStep() << ";" << cli.getMaxTimeStep() << ";" << cli.getSteadyStateTolerance() << ";"
+        << cli.getTheta() << ";" << cli.getSearchWays() << ";" << cli.getPrecision() << ";"
+        << cli.getSearchMethod() << ";" << cli.getGridSpacing() << ";" << cli.getGridFourier() << ";"
+        << cli.getGridStretch() << ";" << cli.getSurrogateFile() << ";" << cli.useBinaryHistory() << ";"
+        << cli.getHistoryEvery() << ";" << cli.getHistoryDelta() << ";" << cli.getSurfaceProfileFile() << ";"
+        << cli.getGroupsFile() << ";" << cli.getStacksFile();
+    return key.str();
+}
+
+// --surrogate-build: tabulate the CLI's stack for this run's solver settings
+static int runSurrogateBuild(const CLI& cli) {
+    auto start = Clock::now();
+    if (cli.useAdaptiveTimeStep() || !(cli.getTimeStep() > 0.0) || !(cli.getTimeDuration() > 0.0)) {
+        std::cerr << "Error: --surrogate-build needs --time and a fixed --dt\n";
+        return 1;
+    }
+    SurrogateSpec spec;
+    spec.maxDuration    = cli.getTimeDuration();
+    spec.dt             = cli.getTimeStep();
+    spec.theta          = cli.getTheta();
+    spec.pointsPerLayer = cli.getPointsPerLayer();
+
+    MaterialProperties props;
+    try {
+        SurrogateTable table = SurrogateTable::build(spec, props.getStack(1), props, cli.getNumThreads());
+        if (!table.save(cli.getSurrogateBuildFile())) {
+            std::cerr << "Error: cannot write " << cli.getSurrogateBuildFile() << "\n";
+            return 1;
+        }
+        std::cout << "Surrogate table written to " << cli.getSurrogateBuildFile() << "\n";
+        std::cout << "Validation error:             " << table.getMaxError() << " K max, "
+                  << table.getRmsError() << " K RMS (" << spec.validationSamples << " solves)\n";
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    std::cout << "Overall program time:         " << MS(Clock::now() - start).count() << " ms\n";
+    return 0;
+}
+
+// --sweep: every (config, slice) of the manifest on one pool, one results table
+static int runSweep(const CLI& cli) {
+    auto start = Clock::now();
+    if (!cli.getGroupsFile().empty() || !cli.getStacksFile().empty()) {
+        std::cerr << "Error: --sweep does not support --groups or --stacks\n";
+        return 1;
+    }
+    SweepManifest defaults;
+    defaults.meshFile = cli.getMeshFile();
+    defaults.initFile = cli.getInitFile();
+    defaults.nSlices  = cli.getNumSlices();
+    SweepConfig base;
+    base.dt             = cli.getTimeStep();
+    base.theta          = cli.getTheta();
+    base.pointsPerLayer = cli.getPointsPerLayer();
+    base.duration       = cli.getTimeDuration();
+    base.adaptive       = cli.useAdaptiveTimeStep();
+    defaults.configs.push_back(base);
+
+    SimulationCache resultCache(cli.getCacheDir());
+    SweepOptions options;
+    options.numThreads        = cli.getNumThreads();
+    options.searchWays        = cli.getSearchWays();
+    options.precision         = searchPrecision(cli);
+    options.method            = searchMethod(cli);
+    options.grid              = gridOptions(cli, cli.getTimeStep());
+    options.adaptiveTolerance = cli.getAdaptiveTolerance();
+    options.minTimeStep       = cli.getMinTimeStep();
+    options.maxTimeStep       = cli.getMaxTimeStep();
+    options.steadyStateTol    = cli.getSteadyStateTolerance();
+    if (cli.useResultCache()) options.cache = &resultCache;
+    SurrogateTable surrogate;
+    if (!cli.getSurrogateFile().empty()) {
+        if (!surrogate.load(cli.getSurrogateFile())) {
+            std::cerr << "Error: cannot load surrogate table " << cli.getSurrogateFile() << "\n";
+            return 1;
+        }
+        options.surrogate = &surrogate;
+    }
+
+    try {
+        SweepManifest manifest = SweepManifest::load(cli.getSweepFile(), defaults);
+        ParameterSweep sweep(manifest, options);
+        std::vector<SweepRow> rows = sweep.run();
+        if (!sweep.writeTable(manifest.outputFile, rows)) {
+            std::cerr << "Error: cannot write " << manifest.outputFile << "\n";
+            return 1;
+        }
+        std::cout << "Sweep: " << manifest.configs.size() << " configs x "
+                  << manifest.nSlices << " slices written to " << manifest.outputFile << "\n";
+        std::cout << "Worker threads:               " << sweep.getNumThreads() << "\n";
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    if (cli.useResultCache()) {
+        SimulationCache::Stats cs = resultCache.getStats();
+        std::cout << "Result cache:                 " << cs.hits << " hits, "
+                  << cs.diskHits << " disk hits, " << cs.misses << " misses ("
+                  << 100.0 * cs.hitRate() << "% hit rate)\n";
+    }
+    std::cout << "Overall program time:         " << MS(Clock::now() - start).count() << " ms\n";
+    return 0;
+}
+
+// --serve: answer requests on stdin/stdout until end of input or "shutdown".
+// stdout carries the protocol only; diagnostics go to stderr.
+// --worker: the same requests from --workers coordinators over TCP, one
+// connection at a time, keeping the warm state between coordinators. Any
+// process reaching the port is a coordinator, so workers listen on loopback
+// unless --worker-bind says otherwise and never open files or shut down on request.
+static int runService(const CLI& cli) {
+    if (!cli.getGroupsFile().empty() || !cli.getStacksFile().empty()) {
+        std::cerr << "Error: --serve and --worker do not support --groups or --stacks\n";
+        return 1;
+    }
+    SweepManifest defaults;
+    defaults.meshFile = cli.getMeshFile();
+    defaults.initFile = cli.getInitFile();
+    defaults.nSlices  = cli.getNumSlices();
+    SweepConfig base;
+    if (cli.getTimeStep() > 0.0) base.dt = cli.getTimeStep();
+    if (cli.getTimeDuration() > 0.0) base.duration = cli.getTimeDuration();
+    base.theta          = cli.getTheta();
+    base.pointsPerLayer = cli.getPointsPerLayer();
+    base.adaptive       = cli.useAdaptiveTimeStep();
+    defaults.configs.push_back(base);
+
+    SweepOptions options;
+    options.numThreads        = cli.getNumThreads();
+    options.searchWays        = cli.getSearchWays();
+    options.precision         = searchPrecision(cli);
+    options.method            = searchMethod(cli);
+    options.grid              = gridOptions(cli, base.dt);
+    options.adaptiveTolerance = cli.getAdaptiveTolerance();
+    options.minTimeStep       = cli.getMinTimeStep();
+    options.maxTimeStep       = cli.getMaxTimeStep();
+    options.steadyStateTol    = cli.getSteadyStateTolerance();
+    SurrogateTable surrogate;
+    if (!cli.getSurrogateFile().empty()) {
+        if (!surrogate.load(cli.getSurrogateFile())) {
+            std::cerr << "Error: cannot load surrogate table " << cli.getSurrogateFile() << "\n";
+            return 1;
+        }
+        options.surrogate = &surrogate;
+    }
+
+    HeatStackService service(defaults, options, cli.getCacheDir());
+    service.setUseMeshCache(cli.useMeshCache());
+    if (cli.getWorkerPort() <= 0) {
+        service.serve(std::cin, std::cout);
+        return 0;
+    }
+    service.setWorkerMode(true);
+    try {
+        TcpListener listener(cli.getWorkerPort(), cli.getWorkerBind());
+        std::cerr << "Worker listening on " << cli.getWorkerBind() << ":" << listener.getPort() << "\n";
+        while (!service.isShutdownRequested()) {
+            std::unique_ptr<TcpChannel> channel = listener.accept();
+            std::string line;
+            while (!service.isShutdownRequested() && channel->readLine(line)) {
+                if (!channel->writeLine(service.handle(line))) break;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+// --workers: rank 0 of a multi-node run. Slices go to the workers in
+// dynamic batches; summary and stack details come back here. Per-slice
+// histories and final fields are not written (as in --sweep).
+static int runDistributed(const CLI& cli) {
+    auto start = Clock::now();
+    if (!cli.getSurfaceProfileFile().empty() || !cli.getCheckpointDir().empty()
+        || !cli.getSnapshotFile().empty() || cli.useLateralConduction()
+        || !cli.getGroupsFile().empty() || !cli.getStacksFile().empty()) {
+        std::cerr << "Error: --workers does not support --surface-profile, --checkpoint, "
+                  << "--snapshots, --lateral, --groups or --stacks\n";
+        return 1;
+    }
+    SliceRequest request;
+    request.nSlices = cli.getNumSlices();
+    if (request.nSlices < 2) {
+        std::cerr << "Error: --workers needs at least 2 slices\n";
+        return 1;
+    }
+    if (cli.getTimeStep() > 0.0) request.config.dt = cli.getTimeStep();
+    if (cli.getTimeDuration() > 0.0) request.config.duration = cli.getTimeDuration();
+    request.config.theta          = cli.getTheta();
+    request.config.pointsPerLayer = cli.getPointsPerLayer();
+    request.config.adaptive       = cli.useAdaptiveTimeStep();
+
+    std::vector<SweepRow> rows;
+    std::vector<WorkerAddress> workers;
+    std::vector<int> perWorker;
+    try {
+        workers = parseWorkerList(cli.getWorkerList());
+        // Only the coordinator reads the mesh: workers get its z extent
+        MeshHandler mesh;
+        mesh.setUseMeshCache(cli.useMeshCache());
+        if (!mesh.loadMesh(cli.getMeshFile())) throw std::runtime_error("Cannot load mesh " + cli.getMeshFile());
+        request.zMin = mesh.getMinZ();
+        request.zMax = mesh.getMaxZ();
+        if (!cli.getInitFile().empty()) {
+            request.initialTemperature = InitialTemperature().loadInitialTemperature(cli.getInitFile());
+        }
+        SliceCoordinator coordinator(workers);
+        rows = coordinator.run(request);
+        perWorker = coordinator.getSlicesPerWorker();
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    // Same rows as the local pipeline
+    MaterialProperties matProps;
+    std::ofstream summaryOut(cli.getOutputFile());
+    summaryOut << "slice,l/L,method,finalSteelTemp,"
+               << "TPS_thickness,OriginalSteelTemp\n";
+    std::ofstream detailsOut("stack_details.csv");
+    detailsOut << "slice,l/L,OriginalTPS,CarbonFiber_thickness,"
+               << "Glue_thickness,Steel_thickness,"
+               << "PreCarbonTemp,PreGlueTemp,PreSteelTemp,"
+               << "OptimizedTPS,PostCarbonTemp,PostGlueTemp,PostSteelTemp\n";
+    for (const SweepRow& r : rows) {
+        summaryOut << r.slice << "," << r.lL << "," << "BTCS" << ","
+                   << r.postSteelTemp << "," << r.optimizedTPS << "," << r.preSteelTemp << "\n";
+        detailsOut << r.slice << "," << r.lL << ","
+                   << r.originalTPS << ","
+                   << matProps.getCarbonFiberThickness(r.lL) << ","
+                   << matProps.getGlueThickness(r.lL) << ","
+                   << matProps.getSteelThickness(r.lL) << ","
+                   << r.preCarbonTemp << "," << r.preGlueTemp << "," << r.preSteelTemp << ","
+                   << r.optimizedTPS << ","
+                   << r.postCarbonTemp << "," << r.postGlueTemp << "," << r.postSteelTemp << "\n";
+    }
+
+    for (size_t w = 0; w < workers.size(); ++w) {
+        std::cout << "Worker " << workers[w].host << ":" << workers[w].port << ": "
+                  << perWorker[w] << " slices\n";
+    }
+    std::cout << "Overall program time:         " << MS(Clock::now() - start).count() << " ms\n";
+    return 0;
+}
 
 int main(int argc, char* argv[]) {
 
@@ -29,34 +346,93 @@ int main(int argc, char* argv[]) {
     double tOptSuggestion      = 0.0;
     double tHistOptSave        = 0.0;
     double tSummaryDetailsWrite= 0.0;
+    double tLateralSolve       = 0.0;
 
     // overall timer
     auto overall_start = Clock::now();;
 
     CLI cli(argc, argv);
     if (cli.isHelpRequested()) return 0;
+    if (!cli.getSurrogateBuildFile().empty()) return runSurrogateBuild(cli);
+    if (!cli.getSweepFile().empty()) return runSweep(cli);
+    if (cli.isServe() || cli.getWorkerPort() > 0) return runService(cli);
+    if (!cli.getWorkerList().empty()) return runDistributed(cli);
+    if (!cli.getProfileFile().empty()) Profiler::enable(true);
+
+    // Clustered grids differ per slice and per TPS thickness
+    const GridOptions grid = gridOptions(cli, cli.getTimeStep());
+    try {
+        MaterialProperties().setGridOptions(grid);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    if (grid.spacing == GridSpacing::Clustered
+        && (!cli.getInitFile().empty() || cli.useLateralConduction())) {
+        std::cerr << "Error: --init and --lateral need --grid uniform\n";
+        return 1;
+    }
 
     // ---- Mesh loading ----
-    auto start = Clock::now();
+    ProfileZone meshZone("mesh_load", -1, &tMeshLoad);
     MeshHandler mesh;
+    mesh.setUseMeshCache(cli.useMeshCache());
     if (!mesh.loadMesh(cli.getMeshFile())) {
         std::cerr << "Error: cannot load mesh " 
                     << cli.getMeshFile() << "\n";
         return 1;
     }
-    tMeshLoad = MS(Clock::now() - start).count();
+    meshZone.stop();
     // grab bounds
     double zmin = mesh.getMinZ(), zmax = mesh.getMaxZ();
     double height = zmax - zmin;
 
+    // ---- Per-group stacks (--groups / --stacks) ----
+    // Each slice takes the stack covering most of its surface; slices
+    // without one keep the default stack
+    MaterialProperties groupProps;
+    std::vector<int> sliceStacks(std::max(cli.getNumSlices(), 0), 0);
+    if (!cli.getStacksFile().empty() && cli.getGroupsFile().empty()) {
+        std::cerr << "Error: --stacks needs --groups\n";
+        return 1;
+    }
+    if (!cli.getGroupsFile().empty()) {
+        try {
+            MeshGroups groups = MeshGroups::load(cli.getGroupsFile());
+            if (!cli.getStacksFile().empty()) groupProps.loadStacks(cli.getStacksFile());
+            for (const Stack& gs : groupProps.getStacks()) {
+                if (gs.layers.size() != 4) {
+                    throw std::runtime_error("Stack " + std::to_string(gs.id)
+                                             + " needs 4 layers (TPS, carbon fiber, glue, steel)");
+                }
+            }
+            SliceIndex sliceIndex;
+            sliceIndex.build(mesh, 0, cli.getNumSlices(), 2, cli.getNumThreads());
+            StackAssignment stackAssignment;
+            stackAssignment.build(mesh, groups, groupProps.getStacks(), sliceIndex, cli.getNumThreads());
+            std::cout << "Mesh groups: " << groups.groups.size() << "\n";
+            for (int slice = 0; slice < cli.getNumSlices(); ++slice) {
+                int id = sliceStacks[slice] = stackAssignment.getSliceStack(slice);
+                if (id == 0) continue;
+                std::cout << "  slice " << slice + 1 << ": stack " << id << " ("
+                          << std::fixed << std::setprecision(0)
+                          << 100.0 * stackAssignment.getSliceCoverage(slice) << "% of surface)\n"
+                          << std::defaultfloat << std::setprecision(6);
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << "\n";
+            return 1;
+        }
+    }
+
     // ---- Initial temperature loading ----
-    auto init_start = Clock::now();
+    ProfileZone initZone("init_temp_load", -1, &tInitTempLoad);
     InitialTemperature initTemp;
     std::vector<double> uniformInit;
     if (!cli.getInitFile().empty()) {
         uniformInit = initTemp.loadInitialTemperature(cli.getInitFile());
     }
-    tInitTempLoad = MS(Clock::now() - init_start).count();
+    initZone.stop();
 
     // Material properties
     MaterialProperties matProps;
@@ -82,152 +458,248 @@ int main(int argc, char* argv[]) {
 
     double totalSolveMs = 0.0;
 
-    // Loop over slices
-    for (int slice = 0; slice < nSlices; ++slice) {
+    // Time-history sink settings shared by all slices
+    const std::vector<std::string> historyColumns =
+        { "time[s]", "T_carbon_glue[K]", "T_glue_steel[K]", "T_steel[K]" };
+    HistoryOptions histOptions;
+    histOptions.format = cli.useBinaryHistory() ? HistoryFormat::Binary
+                                                : HistoryFormat::Csv;
+    histOptions.every = cli.getHistoryEvery();
+    histOptions.deltaThreshold = cli.getHistoryDelta();
+
+    // Shared across slices: neighbouring slices often try identical stacks
+    SimulationCache resultCache(cli.getCacheDir());
+
+    // Read-only, shared by all slices
+    SurrogateTable surrogate;
+    if (!cli.getSurrogateFile().empty() && !surrogate.load(cli.getSurrogateFile())) {
+        std::cerr << "Error: cannot load surrogate table " << cli.getSurrogateFile() << "\n";
+        return 1;
+    }
+
+    // Time-dependent surface temperatures, read-only, shared by all slices
+    BoundaryProfile surfaceProfile;
+    if (!cli.getSurfaceProfileFile().empty()) {
+        try {
+            surfaceProfile = BoundaryProfile::loadCsv(cli.getSurfaceProfileFile());
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << "\n";
+            return 1;
+        }
+    }
+
+    // Full fields of the optimized runs, one writer shared by all slices
+    std::unique_ptr<SnapshotWriter> snapshots;
+    if (!cli.getSnapshotFile().empty()) {
+        SnapshotOptions snapOptions;
+        snapOptions.quantum = cli.getSnapshotQuantum();
+        snapOptions.every = cli.getSnapshotEvery();
+        snapshots.reset(new SnapshotWriter(cli.getSnapshotFile(), snapOptions));
+        if (!snapshots->isOpen()) {
+            std::cerr << "Error: cannot write snapshots " << cli.getSnapshotFile() << "\n";
+            return 1;
+        }
+    }
+
+    // Checkpoints of each slice's progress, when asked for
+    const std::string checkpointDir = cli.getCheckpointDir();
+    const std::string key = runKey(cli);
+    if (!checkpointDir.empty()) {
+        std::error_code ec;
+        std::filesystem::create_directories(checkpointDir, ec);
+    }
+
+    // Each slice fills its own entry; rows are written in slice order afterwards
+    // so the CSVs are identical to a serial run regardless of thread count.
+    std::vector<SliceOutput> outputs(nSlices);
+
+    // Solver and search settings of every slice
+    SliceSettings settings;
+    settings.dt             = dt;
+    settings.theta          = theta;
+    settings.duration       = tFinal;
+    settings.adaptive       = adapt;
+    settings.pointsPerLayer = pointsPerLayer;
+    settings.steps.adaptiveTolerance = cli.getAdaptiveTolerance();
+    settings.steps.minTimeStep       = cli.getMinTimeStep();
+    settings.steps.maxTimeStep       = cli.getMaxTimeStep();
+    settings.steps.steadyStateRate   = cli.getSteadyStateTolerance();
+    settings.grid           = grid;
+    if (!uniformInit.empty()) settings.initialTemperature = &uniformInit;
+    if (!surfaceProfile.empty()) settings.surfaceProfile = &surfaceProfile;
+    settings.searchWays     = cli.getSearchWays();
+    // Cores left to each slice's k-way TPS search while the slice pool runs
+    settings.searchThreads  = SliceScheduler::nestedThreads(cli.getNumThreads());
+    settings.precision      = searchPrecision(cli);
+    settings.method         = searchMethod(cli);
+    if (cli.useResultCache()) settings.cache = &resultCache;
+    if (!surrogate.empty()) settings.surrogate = &surrogate;
+
+    auto runSlice = [&](int slice) {
+        SliceOutput& out = outputs[slice];
+        ProfileZone sliceZone("slice", slice);
+
         double z = zmin + (double(slice)/(nSlices-1)) * height;
         double lL = (z - zmin) / height;
 
         // ---- Stack setup (incl. grid gen) ----
-        auto stack_start = Clock::now();
-        Stack s;
-        s.id = slice + 1;
-        s.layers = {
-            {{"TPS",         0.2,  160.0, 1200.0,   0.0, 1200.0}, matProps.getTPSThickness(lL),          pointsPerLayer},
-            {{"CarbonFiber", 500.0,1600.0, 700.0,   0.0,  350.0}, matProps.getCarbonFiberThickness(lL),     pointsPerLayer},
-            {{"Glue",        200.0,1300.0, 900.0,   0.0,  400.0}, matProps.getGlueThickness(lL),            pointsPerLayer},
-            {{"Steel",       100.0,7850.0, 500.0, 800.0,    0.0}, matProps.getSteelThickness(lL),           pointsPerLayer}
+        ProfileZone stackZone("slice.stack_setup", slice, &out.tStackSetup);
+        Stack groupStack;
+        if (sliceStacks[slice] != 0) groupStack = groupProps.getStack(sliceStacks[slice]);
+        SliceRun run(settings, slice + 1, lL, sliceStacks[slice] != 0 ? &groupStack : nullptr);
+        stackZone.stop();
+        const Stack& s = run.getStack();
+        const double tpsThick   = s.layers[0].thickness;
+        const double cfThick    = s.layers[1].thickness;
+        const double glueThick  = s.layers[2].thickness;
+        const double steelThick = s.layers[3].thickness;
+
+        // ---- Checkpoint of this slice (--checkpoint / --resume) ----
+        SliceCheckpoint ck;
+        const std::string ckPath = checkpointDir.empty() ? std::string()
+                                                         : SliceCheckpoint::path(checkpointDir, slice);
+        if (cli.isResume()) ck.load(ckPath, key);
+        if (snapshots && ck.stage > SliceCheckpoint::Stage::Search) {
+            // The snapshot file is rewritten by every run: repeat the whole optimized transient
+            ck.stage = SliceCheckpoint::Stage::OptimizedSolve;
+            ck.solverState.clear();
+        }
+        auto lastCheckpoint = Clock::now();
+        auto checkpointDue = [&] {
+            return !ckPath.empty() &&
+                   MS(Clock::now() - lastCheckpoint).count() >= 1000.0 * cli.getCheckpointInterval();
         };
-        matProps.generateGrid(s, pointsPerLayer);
-        tStackSetup += MS(Clock::now() - stack_start).count();
-    
-        // compute interface indices once
-        double tpsThick   = matProps.getTPSThickness(lL);
-        double cfThick    = matProps.getCarbonFiberThickness(lL);
-        double glueThick  = matProps.getGlueThickness(lL);
-        double steelThick = matProps.getSteelThickness(lL);
-        double posCG = tpsThick + cfThick;
-        double posGS = posCG + glueThick;
-        auto idxCarbonGlue = std::lower_bound(s.xGrid.begin(), s.xGrid.end(), posCG) - s.xGrid.begin();
-        auto idxGlueSteel  = std::lower_bound(s.xGrid.begin(), s.xGrid.end(), posGS) - s.xGrid.begin();
-        
-    
+        auto writeCheckpoint = [&] {
+            if (ckPath.empty()) return;
+            if (!ck.save(ckPath, key)) std::cerr << "Warning: cannot write checkpoint " << ckPath << "\n";
+            lastCheckpoint = Clock::now();
+        };
+        // Mid-transient: solver state plus the history written up to it
+        auto checkpointTransient = [&](const HeatEquationSolver& solver, HistoryWriter& hist) {
+            std::ostringstream state;
+            solver.saveCheckpoint(state);
+            ck.solverState = state.str();
+            ck.historyBytes = hist.sync();
+            writeCheckpoint();
+        };
+        // Continue a transient from the checkpoint; history resume offset, or 0 to start over
+        auto resumeTransient = [&](HeatEquationSolver& solver) -> std::uint64_t {
+            if (ck.solverState.empty()) return 0;
+            try {
+                std::istringstream state(ck.solverState);
+                solver.loadCheckpoint(state);
+                return ck.historyBytes;
+            } catch (const std::runtime_error& e) {
+                std::cerr << "Warning: slice " << (slice+1) << " restarts its stage: " << e.what() << "\n";
+                return 0;
+            }
+        };
+
         // ---- Original solver run ----
-        TimeHandler th(tFinal, dt, adapt);
-        HeatEquationSolver solver(theta);
-        solver.initialize(s, th);
+        if (ck.stage == SliceCheckpoint::Stage::OriginalSolve) {
+            HeatEquationSolver solver(theta);
+            run.setUp(solver);
 
-        // Set initial temperature
-        if (!uniformInit.empty()) {
-            solver.setInitialTemperature(uniformInit);
-        } else {
-            solver.setInitialTemperature(std::vector<double>(s.xGrid.size(), 300.0));
-        }
+            // open time‐history file for this slice, original thickness;
+            // rows are formatted and written on the writer's own thread
+            HistoryOptions origOptions = histOptions;
+            origOptions.resumeBytes = resumeTransient(solver);
+            HistoryWriter histOrig(
+                "time_history_orig_slice_" + std::to_string(slice+1) + HistoryWriter::extension(histOptions.format),
+                historyColumns, origOptions);
 
-        // Boundary conditions
-        solver.setBoundaryConditions(
-            new DirichletCondition(static_cast<float>(matProps.getExhaustTemp(lL))),
-            new NeumannCondition(0.0f)
-        );
-        
-
-        // open time‐history file for this slice, original thickness
-        std::ostringstream histOrigBuffer;
-        histOrigBuffer << "time[s],T_carbon_glue[K],T_glue_steel[K],T_steel[K]\n";
-        
-        // Timer for solver per slice
-        auto solve_start = Clock::now();
-        // Time-marching loop
-        while (!solver.isFinished()) {
-            solver.step();
-            double t = solver.getCurrentTime();
-            const auto& Tdist = solver.getTemperatureDistribution();
-            histOrigBuffer 
-            << t                  << ","
-            << Tdist[idxCarbonGlue]   << ","
-            << Tdist[idxGlueSteel]    << ","
-            << Tdist.back()           << "\n";
-        }
-        tOrigSolve += MS(Clock::now() - solve_start).count();
+            // Timer for solver per slice
+            ProfileZone solveZone("slice.orig_solve", slice, &out.tOrigSolve);
+            InterfaceTemperatures orig = run.transient(solver, [&](const HeatEquationSolver& sv) {
+                InterfaceTemperatures T = run.readInterfaces(sv.getTemperatureDistribution());
+                histOrig.record({ sv.getCurrentTime(), T.carbonGlue, T.glueSteel, T.steel });
+                if (checkpointDue()) checkpointTransient(sv, histOrig);
+            });
+            solveZone.stop();
 
-        // ---- Original history CSV save ----
-        auto saveOrig_start = Clock::now();
-        {
-            std::ofstream histOrig(
-                "time_history_orig_slice_" + std::to_string(slice+1) + ".csv"
-            );
-            histOrig << histOrigBuffer.str();
+            // ---- Original history flush (waits for the writer thread) ----
+            {
+                ProfileZone zone("slice.orig_history_flush", slice, &out.tHistOrigSave);
+                histOrig.close();
+            }
+
+            // sample original temps
+            ck.origCarbonGlue = orig.carbonGlue;
+            ck.origGlueSteel  = orig.glueSteel;
+            ck.origSteel      = orig.steel;
+            ck.stage = SliceCheckpoint::Stage::Search;
+            ck.solverState.clear();
+            writeCheckpoint();
         }
-        tHistOrigSave += MS(Clock::now() - saveOrig_start).count();
-        
-        // sample original temps
-        const auto& Tdist = solver.getTemperatureDistribution();
-        double steelT = Tdist.back();
-        double origTempCarbon = Tdist[idxCarbonGlue];
-        double origTempGlue   = Tdist[idxGlueSteel];
+        double steelT = ck.origSteel;
+        double origTempCarbon = ck.origCarbonGlue;
+        double origTempGlue   = ck.origGlueSteel;
         double origTempSteel  = steelT;
 
-        // Suggest TPS thickness (optional optimization)
-        auto optSuggest_start = Clock::now();
-        TemperatureComparator comp;
-        comp.setTimeStep(cli.getTimeStep(), cli.useAdaptiveTimeStep());
-        comp.setGridResolution(cli.getPointsPerLayer());
-        // double tpsOpt = comp.suggestTPSThickness(s, 800.0, tFinal, lL, matProps, theta);
-        double tpsOpt = comp.suggestTPSThickness(
-                s,
-                800.0,   // max steel temp @ steel/glue
-                400.0,   // max glue  temp @ glue/carbon
-                350.0,   // max carbon temp @ carbon/external
-                tFinal,
-                lL,
-                matProps,
-                theta
-            );
-        tOptSuggestion += MS(Clock::now() - optSuggest_start).count();
+        // Suggest TPS thickness, against the slice's own material limits
+        if (ck.stage == SliceCheckpoint::Stage::Search) {
+            ProfileZone suggestZone("slice.tps_search", slice, &out.tOptSuggestion);
+            if (ckPath.empty()) {
+                ck.tpsOpt = run.suggestThickness(run.materialLimits());
+            } else {
+                ck.tpsOpt = run.suggestThickness(run.materialLimits(), &ck.search,
+                                                 [&] { if (checkpointDue()) writeCheckpoint(); });
+            }
+            suggestZone.stop();
+            ck.fromSurrogate = run.lastSuggestionFromSurrogate();
+            ck.stage = SliceCheckpoint::Stage::OptimizedSolve;
+            writeCheckpoint();
+        }
+        double tpsOpt = ck.tpsOpt;
+        out.fromSurrogate = ck.fromSurrogate;
 
         // --- NEW: re-run solver at optimized thickness ---
-        s.layers[0].thickness = tpsOpt;
-        matProps.generateGrid(s, pointsPerLayer);
-
-        TimeHandler th2(tFinal, dt, adapt);
+        run.setTPSThickness(tpsOpt);
         HeatEquationSolver solverOpt(theta);
-        solverOpt.initialize(s, th2);
-        solverOpt.setInitialTemperature(uniformInit.empty()
-            ? std::vector<double>(s.xGrid.size(), 300.0)
-            : uniformInit);
-        solverOpt.setBoundaryConditions(
-            new DirichletCondition(static_cast<float>(matProps.getExhaustTemp(lL))),
-            new NeumannCondition(0.0f)
-        );
-
-        auto solveOpt_start = Clock::now();
-        std::ostringstream histOptBuffer;
-        histOptBuffer << "time[s],T_carbon_glue[K],T_glue_steel[K],T_steel[K]\n";
-        
-        while (!solverOpt.isFinished()) {
-            solverOpt.step();
-            double t2 = solverOpt.getCurrentTime();
-            const auto& T2 = solverOpt.getTemperatureDistribution();
-            histOptBuffer
-              << t2                 << ","
-              << T2[idxCarbonGlue]  << ","
-              << T2[idxGlueSteel]   << ","
-              << T2.back()          << "\n";
+        run.setUp(solverOpt);
+
+        if (ck.stage == SliceCheckpoint::Stage::Done && resumeTransient(solverOpt) == 0) {
+            ck.stage = SliceCheckpoint::Stage::OptimizedSolve; // final state unusable, run it again
+            ck.solverState.clear();
         }
-        tOptSolve += MS(Clock::now() - solveOpt_start).count();
-            
-        // ---- Optimized history CSV save ----
-        auto saveOpt_start = Clock::now();
-        {
-            std::ofstream histOpt(
-                "time_history_opt_slice_" + std::to_string(slice+1) + ".csv"
-            );
-            histOpt << histOptBuffer.str();
+        if (ck.stage == SliceCheckpoint::Stage::OptimizedSolve) {
+            ProfileZone solveOptZone("slice.opt_solve", slice, &out.tOptSolve);
+            if (snapshots) snapshots->setGrid(slice + 1, s.xGrid);
+            HistoryOptions optOptions = histOptions;
+            optOptions.resumeBytes = resumeTransient(solverOpt);
+            HistoryWriter histOpt(
+                "time_history_opt_slice_" + std::to_string(slice+1) + HistoryWriter::extension(histOptions.format),
+                historyColumns, optOptions);
+
+            run.transient(solverOpt, [&](const HeatEquationSolver& sv) {
+                double t2 = sv.getCurrentTime();
+                const auto& T2 = sv.getTemperatureDistribution();
+                InterfaceTemperatures T = run.readInterfaces(T2);
+                histOpt.record({ t2, T.carbonGlue, T.glueSteel, T.steel });
+                if (snapshots) snapshots->record(slice + 1, t2, T2);
+                else if (checkpointDue()) checkpointTransient(sv, histOpt);
+            });
+            solveOptZone.stop();
+
+            // ---- Optimized history flush ----
+            {
+                ProfileZone zone("slice.opt_history_flush", slice, &out.tHistOptSave);
+                histOpt.close();
+            }
+
+            // Final state, so a resumed run only rewrites the outputs
+            if (!ckPath.empty()) {
+                std::ostringstream state;
+                solverOpt.saveCheckpoint(state);
+                ck.solverState = state.str();
+                ck.stage = SliceCheckpoint::Stage::Done;
+                writeCheckpoint();
+            }
         }
-        tHistOptSave += MS(Clock::now() - saveOpt_start).count();
 
         // Save final temperature distribution for this slice
-        auto saveFinalTemp_start = Clock::now();
         {
+            ProfileZone zone("slice.final_temp_write", slice);
             std::ofstream finalTempFile(
                 "final_temperature_slice_" + std::to_string(slice+1) + ".csv"
             );
@@ -240,27 +712,30 @@ int main(int argc, char* argv[]) {
             }
         }
 
-        // sample optimized steel temp
-        double steelOpt = solverOpt.getTemperatureDistribution().back();
-        const auto& Topt = solverOpt.getTemperatureDistribution();
-        double postTempCarbon = Topt[idxCarbonGlue];
-        double postTempGlue   = Topt[idxGlueSteel];
+        // sample optimized temps
+        InterfaceTemperatures post = run.readInterfaces(solverOpt.getTemperatureDistribution());
+        double steelOpt = post.steel;
+        double postTempCarbon = post.carbonGlue;
+        double postTempGlue   = post.glueSteel;
         double postTempSteel  = steelOpt;
 
-        // ---- Summary & details CSV writes ----
-        auto out_start = Clock::now();
+        // ---- Summary & details rows (written in order after the run) ----
+        ProfileZone rowsZone("slice.rows", slice, &out.tSummaryDetailsWrite);
 
-        // Write summary CSV with the optimized‐thickness temperature
-        summaryOut 
+        // Summary row with the optimized‐thickness temperature
+        std::ostringstream summaryRow;
+        summaryRow 
         << (slice+1) << ","
         << lL         << ","
         << "BTCS"     << ","
         << steelOpt   << ","
         << tpsOpt     << ","
         << steelT     << "\n";
+        out.summaryRow = summaryRow.str();
 
-        // write the detailed interface temps
-        detailsOut
+        // the detailed interface temps
+        std::ostringstream detailsRow;
+        detailsRow
           << (slice+1) << ","
           << lL         << ","
           << tpsThick   << ","  // original TPS
@@ -274,12 +749,80 @@ int main(int argc, char* argv[]) {
           << postTempCarbon << ","
           << postTempGlue   << ","
           << postTempSteel  << "\n";
+        out.detailsRow = detailsRow.str();
 
-          tSummaryDetailsWrite += MS(Clock::now() - out_start).count();
-    } // end for slices
+        out.optStack      = s;
+        out.lL            = lL;
+        out.steelOpt      = steelOpt;
+        out.idxCarbonGlue = run.getInterfaceNodes()[0];
+        out.idxGlueSteel  = run.getInterfaceNodes()[1];
+    };
 
+    // Run all slices on the work-stealing pool
+    SliceScheduler scheduler(cli.getNumThreads());
+    scheduler.run(nSlices, runSlice);
+    if (snapshots && !snapshots->close()) {
+        std::cerr << "Warning: snapshot file " << cli.getSnapshotFile() << " is incomplete\n";
+    }
+
+    // Gather rows and timers back in slice order
+    ProfileZone writeZone("write_rows", -1, &tSummaryDetailsWrite);
+    int surrogateHits = 0;
+    for (const auto& out : outputs) {
+        if (out.fromSurrogate) ++surrogateHits;
+        summaryOut << out.summaryRow;
+        detailsOut << out.detailsRow;
+        tStackSetup          += out.tStackSetup;
+        tOrigSolve           += out.tOrigSolve;
+        tHistOrigSave        += out.tHistOrigSave;
+        tOptSolve            += out.tOptSolve;
+        tOptSuggestion       += out.tOptSuggestion;
+        tHistOptSave         += out.tHistOptSave;
+        tSummaryDetailsWrite += out.tSummaryDetailsWrite;
+    }
     summaryOut.close();
     detailsOut.close();
+    writeZone.stop();
+
+    // ---- Optional coupled run: optimized stacks with lateral conduction ----
+    if (cli.useLateralConduction() && nSlices >= 2) {
+        ProfileZone lateralZone("lateral_solve", -1, &tLateralSolve);
+        std::vector<Stack> stacks;
+        std::vector<double> surface;
+        std::vector<std::array<float, 3>> surfacePositions;
+        for (const auto& out : outputs) {
+            stacks.push_back(out.optStack);
+            surface.push_back(static_cast<float>(matProps.getExhaustTemp(out.lL)));
+            surfacePositions.push_back({ 0.0f, 0.0f, static_cast<float>(out.lL) });
+        }
+        CoupledSliceSolver coupled(cli.getNumThreads());
+        coupled.initialize(stacks, height / (nSlices - 1), TimeHandler(tFinal, dt, false));
+        coupled.setInitialTemperature(uniformInit.empty()
+            ? std::vector<double>(stacks[0].xGrid.size(), 300.0)
+            : uniformInit);
+        coupled.setSurfaceTemperatures(surface);
+        std::unique_ptr<TabulatedCondition> surfaceCondition;
+        if (!surfaceProfile.empty()) {
+            surfaceCondition.reset(new TabulatedCondition(&surfaceProfile));
+            coupled.setSurfaceCondition(surfaceCondition.get(), surfacePositions);
+        }
+        while (!coupled.isFinished()) coupled.step();
+
+        std::ofstream lateralOut("lateral_summary.csv");
+        lateralOut << "slice,l/L,TPS_thickness,CarbonGlueTemp,GlueSteelTemp,"
+                   << "SteelTemp,UncoupledSteelTemp\n";
+        int last = coupled.getNumNodes() - 1;
+        for (int slice = 0; slice < nSlices; ++slice) {
+            const SliceOutput& out = outputs[slice];
+            lateralOut << (slice+1) << ","
+                       << out.lL << ","
+                       << out.optStack.layers[0].thickness << ","
+                       << coupled.getTemperature(slice, static_cast<int>(out.idxCarbonGlue)) << ","
+                       << coupled.getTemperature(slice, static_cast<int>(out.idxGlueSteel)) << ","
+                       << coupled.getTemperature(slice, last) << ","
+                       << out.steelOpt << "\n";
+        }
+    }
 
     // overall end
     double overallMs = MS(Clock::now() - overall_start).count();
@@ -295,7 +838,36 @@ int main(int argc, char* argv[]) {
     std::cout << "TPS-opt suggestion time:      " << tOptSuggestion      << " ms\n";
     std::cout << "Opt. history CSV save:        " << tHistOptSave        << " ms\n";
     std::cout << "Summary/details CSV writes:   " << tSummaryDetailsWrite<< " ms\n";
+    if (cli.useLateralConduction()) {
+        std::cout << "Lateral coupled solve:        " << tLateralSolve       << " ms\n";
+    }
+    std::cout << "Worker threads:               " << scheduler.getNumThreads() << "\n";
+    if (cli.useResultCache()) {
+        SimulationCache::Stats cs = resultCache.getStats();
+        std::cout << "Result cache:                 " << cs.hits << " hits, "
+                  << cs.diskHits << " disk hits, " << cs.misses << " misses ("
+                  << 100.0 * cs.hitRate() << "% hit rate)\n";
+    }
+    if (!surrogate.empty()) {
+        std::cout << "Surrogate suggestions:        " << surrogateHits << " of " << nSlices
+                  << " slices confirmed\n";
+    }
+    if (snapshots) {
+        std::cout << "Snapshots:                    " << snapshots->getWrittenFrames() << " frames, "
+                  << snapshots->getWrittenBytes() / 1024 << " KiB ("
+                  << 100.0 * snapshots->getWrittenBytes() / std::max<std::uint64_t>(1, snapshots->getRawBytes())
+                  << "% of raw)\n";
+    }
     std::cout << "Overall program time:         " << overallMs           << " ms\n";
 
+    if (Profiler::isEnabled()) {
+        std::cout << "\n=== Profile ===\n" << Profiler::summary();
+        if (Profiler::writeChromeTrace(cli.getProfileFile())) {
+            std::cout << "Chrome trace written to " << cli.getProfileFile() << "\n";
+        } else {
+            std::cerr << "Warning: cannot write trace " << cli.getProfileFile() << "\n";
+        }
+    }
+
     return 0;
 }
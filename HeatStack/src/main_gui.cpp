@@ -11,7 +11,8 @@
 #include <algorithm>  // for std::min_element, std::max_element, and std::min
 #include <array>
 #include <sstream> // Added include
-#include <future>  // Add for std::future and std::future_status
+#include <atomic>
+#include <mutex>
 
 // Define M_PI if not defined (e.g. on MSVC)
 #ifndef M_PI
@@ -26,6 +27,16 @@
 #include "TimeHandler.h"
 #include "MaterialProperties.h"
 #include "TemperatureComparator.h"
+#include "SliceScheduler.h"
+#include "SliceRun.h"
+#include "SimulationCache.h"
+#include "SimulationJob.h"
+#include "HistoryWriter.h"
+#include "Profiler.h"
+#include "ResultsStore.h"
+#include "MeshRenderer.h"
+#include "SliceIndex.h"
+#include "PlaybackFrames.h"
 
 // GUI + OpenGL includes
 #ifdef _WIN32
@@ -40,15 +51,37 @@
 #include "imgui_impl_opengl3.h"
 #include "tinyfiledialogs.h"
 
+// Inputs of one simulation run, copied from the GUI when the run starts
+// so edits made while it is running do not leak into it
+struct SimulationParams {
+    std::string meshPath;
+    std::string initTempPath;
+    std::string outputFile;
+    float simDuration = 10.0f;
+    float timeStep = 0.1f;
+    int nSlices = 10;
+    int pointsPerLayer = 100;
+    bool useAdaptiveTimeStep = false;
+    float adaptiveTolerance = 0.01f;
+    float steadyStateTolerance = 0.0f;
+    float theta = 0.5f;
+    int nThreads = 0;
+    int searchWays = 2;
+    bool useResultCache = true;
+    bool enableProfiling = false;
+    int historyEvery = 1;
+};
+
 // Forward declarations to fix reference errors
 void drawCoordinateAxes();
-void runSimulationLogic();
+bool runSimulationLogic(const SimulationParams& params, SimulationJob& job);
 void renderSimulationControls();
 void renderVisualizationControls();
 void renderVisualization(int vx, int vy, int vw, int vh, bool isHovered);
 void drawMeshWithTemperatures(const MeshHandler& mesh, const HeatEquationSolver& completedSolver);
 void drawMeshWithThickness(const MeshHandler& mesh, const HeatEquationSolver& solver);
 void drawMeshDefault(const MeshHandler& mesh);
+void drawMeshPlayback(const MeshHandler& mesh);
 void drawSliceLines(const MeshHandler& mesh);
 void drawTemperaturePlot(int x, int y, int width, int height); // Added forward declaration
 void updateMeshVisualization(); // Added forward declaration
@@ -68,7 +101,14 @@ std::string currentProcessingStatus = "";
 static int nSlices = 10;
 static int pointsPerLayer = 100;
 static bool useAdaptiveTimeStep = false;
+static float adaptiveTolerance = 0.01f; // K, adaptive step error target
+static float steadyStateTolerance = 0.0f; // K/s, 0 = run full duration
 static float theta = 0.5f;
+static int nThreads = 0; // Slice worker threads, 0 = all cores
+static int searchWays = 2; // TPS search candidates per round, 2 = bisection
+static bool useResultCache = true; // Reuse TPS trial results across slices and runs
+static bool enableProfiling = false; // Record profiling zones and write a Chrome trace
+static int historyEvery = 1; // Keep every Nth time-history row
 static char outputFile[512] = "summary_output.csv";
 static bool meshLoadedForVis = false; // Track if mesh is loaded for visualization
 static int selectedSlice = 10; // Currently selected slice number for plots (1-based)
@@ -76,6 +116,22 @@ static int selectedSlice = 10; // Currently selected slice number for plots (1-b
 // 🌟 Mesh Handler and Solver Objects (keep them persistent)
 MeshHandler meshHandler;
 HeatEquationSolver solver; // Keep solver instance for potential result access
+SimulationCache resultCache; // Survives between runs, so re-running is cheap
+ResultsStore resultsStore;   // Last run's results; plots and mesh coloring read from here
+MeshRenderer meshRenderer;   // GPU buffers for meshHandler (render thread only)
+std::atomic<int> meshRevision(0); // Bumped whenever meshHandler is reloaded
+enum MeshColorTag { TEMPERATURE_COLORS, THICKNESS_COLORS, PLAYBACK_COLORS };
+SliceIndex sliceIndex;       // Face -> slice bins of meshHandler for the current nSlices
+PlaybackFrames playbackFrames;          // Histories of resultsStore resampled for playback
+unsigned long playbackFramesRevision = 0; // Bumped whenever playbackFrames is rebuilt
+
+// Background run; a new run cancels the previous one instead of waiting for it
+std::shared_ptr<SimulationJob> simulationJob;
+
+// Objects built by a job for the GUI thread, installed by installJobResults()
+std::mutex jobHandoffMutex;
+std::unique_ptr<MeshHandler> pendingMesh;
+std::unique_ptr<HeatEquationSolver> pendingSolver;
 
 // Global variables for 3D visualization
 bool cameraMovementEnabled = true; // Enable by default
@@ -88,14 +144,89 @@ bool showMesh = true;           // NEW: Toggle for mesh visibility
 const float mouseSensitivity = 0.4f;
 const float zoomSensitivity = 0.5f;
 const float panSensitivity = 0.01f; // Sensitivity for panning
-enum VisualizationMode { TEMPERATURE_VIS, THICKNESS_VIS, LINE_PLOT_VIS };  // Added LINE_PLOT_VIS mode
+enum VisualizationMode { TEMPERATURE_VIS, THICKNESS_VIS, LINE_PLOT_VIS, PLAYBACK_VIS };  // Added LINE_PLOT_VIS mode
 VisualizationMode currentVisMode = THICKNESS_VIS; // Default to thickness visualization
 bool showColorScale = true; // Whether to show the color scale
 bool showSliceLines = true; // Add toggle for slice lines
 bool autoAdjustCameraOnLoad = true; // Automatically center camera on mesh load
 
+// History playback (PLAYBACK_VIS): interface temperatures of every slice over time
+int playbackField = static_cast<int>(HistoryField::Steel);
+bool playbackOptimized = true;  // Optimized runs (original where a slice has none)
+float playbackTime = 0.0f;      // Simulated time shown (s)
+bool playbackPlaying = false;
+bool playbackLoop = true;
+float playbackLength = 10.0f;   // Seconds for one pass through the whole run
+
+// Snapshot of the current GUI inputs for a new run
+SimulationParams captureSimulationParams() {
+    SimulationParams params;
+    params.meshPath = meshPath;
+    params.initTempPath = initTempPath;
+    params.outputFile = outputFile;
+    params.simDuration = simDuration;
+    params.timeStep = timeStep;
+    params.nSlices = nSlices;
+    params.pointsPerLayer = pointsPerLayer;
+    params.useAdaptiveTimeStep = useAdaptiveTimeStep;
+    params.adaptiveTolerance = adaptiveTolerance;
+    params.steadyStateTolerance = steadyStateTolerance;
+    params.theta = theta;
+    params.nThreads = nThreads;
+    params.searchWays = searchWays;
+    params.useResultCache = useResultCache;
+    params.enableProfiling = enableProfiling;
+    params.historyEvery = historyEvery;
+    return params;
+}
+
+// GUI thread only: take over the mesh / solver a job handed over
+void installJobResults() {
+    std::lock_guard<std::mutex> lock(jobHandoffMutex);
+    if (pendingMesh) {
+        meshHandler = *pendingMesh;
+        pendingMesh.reset();
+        ++meshRevision;
+        meshLoadedForVis = true; // Mark mesh as loaded for visualization
+    }
+    if (pendingSolver) {
+        solver = *pendingSolver; // Final state of the last slice, for the temperature view
+        pendingSolver.reset();
+    }
+}
+
+// Once per frame: drain the job's log, progress and status into the GUI
+// state and note how it ended
+void pollSimulationJob() {
+    installJobResults();
+    if (!simulationJob) return;
+
+    appLog += simulationJob->takeLog();
+    progress = simulationJob->getFraction();
+    if (!simulationJob->isDone()) {
+        currentProcessingStatus = simulationJob->isCancelled() ? "Cancelling..." : simulationJob->getStatus();
+        return;
+    }
+
+    switch (simulationJob->getState()) {
+    case SimulationJob::State::Completed:
+        simulationCompleted = true;
+        currentProcessingStatus.clear();
+        break;
+    case SimulationJob::State::Cancelled:
+        currentProcessingStatus = "Simulation cancelled.";
+        break;
+    default:
+        currentProcessingStatus = "Simulation finished with errors or was stopped.";
+        break;
+    }
+    appLog += simulationJob->takeLog();
+    simulationJob.reset();
+}
+
 // Reset function to clear all inputs
 void resetSimulation() {
+    if (simulationJob) simulationJob->cancel(); // Its results are about to be cleared
     meshPath[0] = '\0';
     initTempPath[0] = '\0';
     simDuration = 10.0f;
@@ -103,7 +234,16 @@ void resetSimulation() {
     nSlices = 10;
     pointsPerLayer = 100;
     useAdaptiveTimeStep = false;
+    adaptiveTolerance = 0.01f;
+    steadyStateTolerance = 0.0f;
     theta = 0.5f;
+    nThreads = 0;
+    searchWays = 2;
+    useResultCache = true;
+    enableProfiling = false;
+    historyEvery = 1;
+    resultCache.clear();
+    resultsStore.reset(0);
     strcpy_s(outputFile, sizeof(outputFile), "summary_output.csv"); // Use strcpy_s for safety
     progress = 0.0f;
     appLog.clear();
@@ -169,38 +309,29 @@ void lookAtGL(GLdouble eyeX, GLdouble eyeY, GLdouble eyeZ,
     glTranslated(-eyeX, -eyeY, -eyeZ);
 }
 
-// Helper function to swap Y and Z axes when drawing vertices
-void drawVertexWithYZSwap(const std::array<float, 3>& vertex) {
-    // Swap Y and Z coordinates to make Z the vertical axis
-    double x = static_cast<double>(vertex[0]);
-    double y = static_cast<double>(vertex[2]); // Use Z as Y (vertical)
-    double z = static_cast<double>(vertex[1]); // Use Y as Z (depth)
-    glVertex3d(x, y, z);
+// Face -> slice bins for mesh, rebuilt when the mesh or the slice count changes
+const SliceIndex& currentSliceIndex(const MeshHandler& mesh) {
+    if (!sliceIndex.isCurrent(meshRevision.load(), nSlices)) {
+        sliceIndex.build(mesh, meshRevision.load(), nSlices, 1, nThreads);
+    }
+    return sliceIndex;
 }
 
-// Helper function to calculate normal with Y-Z swap
-std::array<double, 3> calculateNormalWithYZSwap(const std::array<float, 3>& v1, 
-                                               const std::array<float, 3>& v2, 
-                                               const std::array<float, 3>& v3) {
-    // Convert coordinates with Y-Z swap for normal calculation
-    double v1x = v1[0], v1y = v1[2], v1z = v1[1]; // Swap Y and Z
-    double v2x = v2[0], v2y = v2[2], v2z = v2[1]; // Swap Y and Z
-    double v3x = v3[0], v3y = v3[2], v3z = v3[1]; // Swap Y and Z
-    
-    // Calculate normal for the swapped coordinates
-    double nx = (v2y - v1y) * (v3z - v1z) - (v2z - v1z) * (v3y - v1y);
-    double ny = (v2z - v1z) * (v3x - v1x) - (v2x - v1x) * (v3z - v1z);
-    double nz = (v2x - v1x) * (v3y - v1y) - (v2y - v1y) * (v3x - v1x);
-    
-    // Normalize
-    double len = sqrt(nx*nx + ny*ny + nz*nz);
-    if (len > 0) {
-        nx /= len;
-        ny /= len;
-        nz /= len;
+// Histories of the published slices resampled onto one time grid, rebuilt
+// when the results, the shown field or the slice count change
+const PlaybackFrames& currentPlaybackFrames() {
+    static unsigned long builtVersion = 0;
+    static int builtKey = -1;
+    int key = (nSlices * 3 + playbackField) * 2 + (playbackOptimized ? 1 : 0);
+    unsigned long version = resultsStore.getVersion();
+    if (key != builtKey || version != builtVersion) {
+        playbackFrames = PlaybackFrames::build(resultsStore.getAll(), nSlices,
+                                               static_cast<HistoryField>(playbackField), playbackOptimized);
+        builtKey = key;
+        builtVersion = version;
+        ++playbackFramesRevision;
     }
-    
-    return {nx, ny, nz};
+    return playbackFrames;
 }
 
 // Helper function to draw coordinate axes
@@ -297,7 +428,16 @@ void renderSimulationControls() {
     ImGui::InputInt("Number of Slices", &nSlices);
     ImGui::InputInt("Points Per Layer", &pointsPerLayer);
     ImGui::Checkbox("Use Adaptive Time Step", &useAdaptiveTimeStep);
+    if (useAdaptiveTimeStep) {
+        ImGui::InputFloat("Adaptive Tolerance (K)", &adaptiveTolerance, 0.001f, 0.01f, "%.4f");
+    }
+    ImGui::InputFloat("Steady-State Stop (K/s)", &steadyStateTolerance, 0.001f, 0.01f, "%.4f");
     ImGui::InputFloat("Theta Parameter", &theta, 0.05f, 0.1f, "%.2f");
+    ImGui::InputInt("Threads (0 = all cores)", &nThreads);
+    ImGui::InputInt("TPS Search Ways", &searchWays);
+    ImGui::Checkbox("Cache Results", &useResultCache);
+    ImGui::Checkbox("Profile (Chrome trace)", &enableProfiling);
+    ImGui::InputInt("History Every N Steps", &historyEvery);
     ImGui::InputText("Output File", outputFile, sizeof(outputFile));
 
     // Clamp inputs to reasonable values
@@ -305,19 +445,27 @@ void renderSimulationControls() {
     if (timeStep <= 0) timeStep = 0.001f;
     if (nSlices < 1) nSlices = 1;
     if (pointsPerLayer < 2) pointsPerLayer = 2;
+    if (adaptiveTolerance <= 0) adaptiveTolerance = 1e-4f;
+    if (steadyStateTolerance < 0) steadyStateTolerance = 0.0f;
+    if (nThreads < 0) nThreads = 0;
+    if (searchWays < 2) searchWays = 2;
+    if (historyEvery < 1) historyEvery = 1;
     theta = std::clamp(theta, 0.0f, 1.0f); // Clamp theta [0, 1]
 
-    if (triggerSimulation) {
-        ImGui::BeginDisabled(true); // Disable button while running
-        ImGui::Button("Running...");
-        ImGui::EndDisabled();
-    } else {
-       if (ImGui::Button("Run Simulation")) {
-            triggerSimulation = true; // This will trigger the logic in the main loop
-            simulationCompleted = false;
-            progress = 0.0f;
-            appLog.clear();
-            currentProcessingStatus = "Starting simulation...";
+    // While a run is active the button restarts it with the current inputs
+    bool simulationRunning = simulationJob && !simulationJob->isDone();
+    if (ImGui::Button(simulationRunning ? "Restart Simulation" : "Run Simulation")) {
+        triggerSimulation = true; // This will trigger the logic in the main loop
+        simulationCompleted = false;
+        progress = 0.0f;
+        appLog.clear();
+        currentProcessingStatus = "Starting simulation...";
+    }
+    if (simulationRunning) {
+        ImGui::SameLine();
+        if (ImGui::Button("Cancel")) {
+            simulationJob->cancel();
+            currentProcessingStatus = "Cancelling...";
         }
     }
 
@@ -367,17 +515,20 @@ void drawMeshWithTemperatures(const MeshHandler& mesh, const HeatEquationSolver&
     
     if (depthRange <= 0) depthRange = 1.0; // Avoid division by zero
 
-    glBegin(GL_TRIANGLES);
+    meshRenderer.ensureMesh(mesh, meshRevision.load());
+    if (meshRenderer.colorsMatch(TEMPERATURE_COLORS, resultsStore.getVersion(), 0)) {
+        meshRenderer.draw(true); // Colors are current, nothing to rebuild
+        return;
+    }
+
+    std::vector<std::array<float, 3>> faceColors;
+    faceColors.reserve(faces.size());
     for (const auto& face : faces) {
         // Get vertices for this face
         const auto& v1 = vertices[face[0]];
         const auto& v2 = vertices[face[1]];
         const auto& v3 = vertices[face[2]];
 
-        // Calculate normal with Y-Z swapped coordinates
-        auto normal = calculateNormalWithYZSwap(v1, v2, v3);
-        glNormal3d(normal[0], normal[1], normal[2]); // Set normal per face
-
         // Calculate average Y position of this face (becomes Z in visualization)
         double avgY = (v1[1] + v2[1] + v3[1]) / 3.0;
         
@@ -402,14 +553,59 @@ void drawMeshWithTemperatures(const MeshHandler& mesh, const HeatEquationSolver&
         t = std::clamp(t, 0.0f, 1.0f); // Clamp [0, 1]
         
         // Apply color to all vertices of this face
-        glColor3f(t, 0.0f, 1.0f - t);  // Red to Blue gradient
+        faceColors.push_back({t, 0.0f, 1.0f - t});  // Red to Blue gradient
+    }
+    meshRenderer.setFaceColors(faceColors, TEMPERATURE_COLORS, resultsStore.getVersion(), 0);
+    meshRenderer.draw(true);
+}
+
+// Helper function to draw the mesh colored by the slice temperatures at playbackTime.
+// On the GPU the histories stay in a texture and a frame only sets the time;
+// without shader support the face colors are rebuilt when the frame changes.
+void drawMeshPlayback(const MeshHandler& mesh) {
+    const PlaybackFrames& frames = currentPlaybackFrames();
+    if (mesh.getFaces().empty()) return;
+    if (frames.empty()) {
+        drawMeshDefault(mesh); // No histories yet
+        return;
+    }
 
-        // Draw all vertices with Y-Z swap
-        for (int i = 0; i < 3; ++i) {
-            drawVertexWithYZSwap(vertices[face[i]]);
+    meshRenderer.ensureMesh(mesh, meshRevision.load());
+    const SliceIndex& index = currentSliceIndex(mesh);
+    const double frame = frames.frameOf(playbackTime);
+    const unsigned long revision = playbackFramesRevision;
+
+    if (meshRenderer.supportsPlayback()) {
+        if (!meshRenderer.faceSlicesMatch(meshRevision.load(), index.getNumSlices())) {
+            meshRenderer.setFaceSlices(index.getFaceSlices(), meshRevision.load(), index.getNumSlices());
+        }
+        if (!meshRenderer.playbackFramesMatch(PLAYBACK_COLORS, revision)) {
+            meshRenderer.setPlaybackFrames(frames, frames.minTemp, frames.maxTemp, PLAYBACK_COLORS, revision);
+        }
+        if (meshRenderer.hasPlaybackFrames()) {
+            meshRenderer.drawPlayback(frame);
+            return;
         }
     }
-    glEnd();
+
+    // CPU fallback, same colormap as the shader
+    const int frameParam = static_cast<int>(std::lround(frame));
+    if (!meshRenderer.colorsMatch(PLAYBACK_COLORS, revision, frameParam)) {
+        double range = frames.maxTemp > frames.minTemp ? frames.maxTemp - frames.minTemp : 1.0;
+        double time = frames.startTime + frameParam * frames.frameStep();
+        std::vector<std::array<float, 3>> sliceColors(index.getNumSlices(), {0.5f, 0.5f, 0.5f});
+        for (int slice = 0; slice < index.getNumSlices() && slice < frames.nSlices; ++slice) {
+            if (!frames.valid[slice]) continue;
+            float t = static_cast<float>((frames.sample(slice, time) - frames.minTemp) / range);
+            t = std::clamp(t, 0.0f, 1.0f);
+            sliceColors[slice] = {t, 0.0f, 1.0f - t};
+        }
+        const auto& faceSlices = index.getFaceSlices();
+        std::vector<std::array<float, 3>> faceColors(faceSlices.size());
+        for (size_t f = 0; f < faceSlices.size(); ++f) faceColors[f] = sliceColors[faceSlices[f]];
+        meshRenderer.setFaceColors(faceColors, PLAYBACK_COLORS, revision, frameParam);
+    }
+    meshRenderer.draw(true);
 }
 
 // Helper function to draw mesh with TPU thickness visualization
@@ -419,14 +615,15 @@ void drawMeshWithThickness(const MeshHandler& mesh, const HeatEquationSolver& so
 
     if (vertices.empty() || faces.empty()) return;
 
-    // After Y-Z swap, we want to use Y coordinates (visualized as Z) for color mapping
-    double yMin = mesh.getMinY(); // Min of new Z axis (former Y)
-    double yMax = mesh.getMaxY(); // Max of new Z axis (former Y)
-    double depthRange = yMax - yMin;
-    
-    if (depthRange <= 0) depthRange = 1.0; // Avoid division by zero
+    // Colors only change with the results or the slice count
+    meshRenderer.ensureMesh(mesh, meshRevision.load());
+    unsigned long resultsVersion = resultsStore.getVersion();
+    if (meshRenderer.colorsMatch(THICKNESS_COLORS, resultsVersion, nSlices)) {
+        meshRenderer.draw(true);
+        return;
+    }
 
-    // Load TPS thickness data from summary file if available
+    // TPS thickness per slice, from the results store
     struct SliceData {
         int sliceNumber;  // Add slice number for tracking
         double lL;
@@ -434,74 +631,15 @@ void drawMeshWithThickness(const MeshHandler& mesh, const HeatEquationSolver& so
     };
     std::vector<SliceData> sliceData;
     
-    // Try to load from summary_output.csv first (contains optimal TPS thickness)
-    std::ifstream summaryFile("summary_output.csv");
-    if (summaryFile.is_open()) {
-        std::string line;
-        // Skip header
-        std::getline(summaryFile, line);
-        
-        while (std::getline(summaryFile, line)) {
-            std::stringstream ss(line);
-            std::string token;
-            
-            // Read slice number
-            std::getline(ss, token, ',');
-            int sliceNum = std::stoi(token);
-            
-            // Read l/L
-            std::getline(ss, token, ',');
-            double lL = std::stod(token);
-            
-            // Skip method
-            std::getline(ss, token, ',');
-            
-            // Skip final steel temperature
-            std::getline(ss, token, ',');
-            
-            // Read TPS thickness
-            std::getline(ss, token, ',');
-            double tpsThickness = std::stod(token);
-            
-            // Ensure we have a positive value (sometimes optimization returns negative values)
-            if (tpsThickness > 0) {
-                sliceData.push_back({sliceNum, lL, tpsThickness});
-            }
-        }
-        summaryFile.close();
-    }
-
-    // If summary_output.csv didn't work, try stack_details.csv (contains initial TPS thickness)
-    if (sliceData.empty()) {
-        std::ifstream detailsFile("stack_details.csv");
-        if (detailsFile.is_open()) {
-            std::string line;
-            // Skip header
-            std::getline(detailsFile, line);
-            
-            while (std::getline(detailsFile, line)) {
-                std::stringstream ss(line);
-                std::string token;
-                
-                // Read slice number
-                std::getline(ss, token, ',');
-                int sliceNum = std::stoi(token);
-                
-                // Read l/L
-                std::getline(ss, token, ',');
-                double lL = std::stod(token);
-                
-                // Read TPS thickness
-                std::getline(ss, token, ',');
-                double tpsThickness = std::stod(token);
-                
-                sliceData.push_back({sliceNum, lL, tpsThickness});
-            }
-            detailsFile.close();
+    // Optimized TPS thickness per slice (original where the optimization failed)
+    for (const auto& result : resultsStore.getAll()) {
+        double tpsThickness = result->reportedTPS();
+        if (tpsThickness > 0) {
+            sliceData.push_back({result->slice, result->lL, tpsThickness});
         }
     }
 
-    // If no data was loaded from CSV files, use default values without logging errors
+    // If there are no results yet, use default values without logging errors
     if (sliceData.empty()) {
         // Default thickness values as a fallback - ensure we cover the ENTIRE mesh
         for (int i = 0; i < nSlices; i++) {
@@ -528,54 +666,21 @@ void drawMeshWithThickness(const MeshHandler& mesh, const HeatEquationSolver& so
     std::sort(sliceData.begin(), sliceData.end(), 
              [](const SliceData& a, const SliceData& b) { return a.lL < b.lL; });
     
-    // Calculate slice boundaries along the Y axis (which becomes Z in visualization)
-    // NOTE: We reverse the slice order so that slice 1 is at the bottom (yMin)
-    std::vector<double> sliceBoundaries;
-    if (nSlices > 1) {
-        // Use nSlices+1 boundaries to define nSlices regions
-        for (int i = 0; i <= nSlices; i++) {
-            double boundary = yMin + (static_cast<double>(i) / nSlices) * depthRange;
-            sliceBoundaries.push_back(boundary);
-        }
-    } else {
-        // If only one slice, use the entire Y range
-        sliceBoundaries.push_back(yMin);
-        sliceBoundaries.push_back(yMax);
-    }
+    // Faces are binned once per mesh and slice count (Y becomes Z in visualization)
+    const SliceIndex& index = currentSliceIndex(mesh);
+    const int bins = index.getNumSlices();
 
-    // Draw mesh with color based on TPS thickness
-    glBegin(GL_TRIANGLES);
-    for (const auto& face : faces) {
-        // Get vertices for this face
-        const auto& v1 = vertices[face[0]];
-        const auto& v2 = vertices[face[1]];
-        const auto& v3 = vertices[face[2]];
-
-        // Calculate normal with Y-Z swapped coordinates
-        auto normal = calculateNormalWithYZSwap(v1, v2, v3);
-        glNormal3d(normal[0], normal[1], normal[2]);
-
-        // Determine the average Y position of this face (becomes Z in visualization)
-        double avgY = (v1[1] + v2[1] + v3[1]) / 3.0;
-        
-        // Find which slice this face belongs to
-        int sliceIndex = 0;
-        for (size_t i = 0; i < sliceBoundaries.size() - 1; i++) {
-            if (avgY >= sliceBoundaries[i] && avgY <= sliceBoundaries[i+1]) {
-                sliceIndex = i;
-                break;
-            }
-        }
-        
+    // Per-slice color table, then one lookup per face
+    std::vector<std::array<float, 3>> sliceColors(bins);
+    for (int sliceIndex = 0; sliceIndex < bins; ++sliceIndex) {
         // Map slice index to l/L value - use evenly distributed l/L values
-        // But reverse the mapping so that slice 1 (bottom) has l/L = 0
+        // so that slice 1 (bottom) has l/L = 0
         double sliceLL = (nSlices > 1) ? 
                       static_cast<double>(sliceIndex) / (nSlices - 1) : 
                       0.5;
         
-        // Find the corresponding slice data - need to match reversed slice numbering
+        // Find the corresponding slice data
         double thickness = 0.001; // Default
-        int reversedSliceIndex = nSlices - 1 - sliceIndex; // Convert to the right slice number
         int actualSliceNumber = sliceIndex + 1; // Original slice number (1-based)
         
         for (const auto& slice : sliceData) {
@@ -592,14 +697,16 @@ void drawMeshWithThickness(const MeshHandler& mesh, const HeatEquationSolver& so
         t = std::clamp(t, 0.0f, 1.0f);
         
         // Yellow (thick) to Green (thin) gradient
-        glColor3f(1.0f - t, 1.0f, 0.0f);
-        
-        // Draw all vertices with Y-Z swap
-        for (int i = 0; i < 3; ++i) {
-            drawVertexWithYZSwap(vertices[face[i]]);
-        }
+        sliceColors[sliceIndex] = {1.0f - t, 1.0f, 0.0f};
     }
-    glEnd();
+
+    std::vector<std::array<float, 3>> faceColors(faces.size());
+    const auto& faceSlices = index.getFaceSlices();
+    for (size_t f = 0; f < faces.size(); ++f) {
+        faceColors[f] = sliceColors[faceSlices[f]];
+    }
+    meshRenderer.setFaceColors(faceColors, THICKNESS_COLORS, resultsVersion, nSlices);
+    meshRenderer.draw(true);
 }
 
 // Helper function to draw horizontal slice planes at different Z positions
@@ -610,17 +717,12 @@ void drawSliceLines(const MeshHandler& mesh) {
     // After Y-Z swap, Y becomes Z and Z becomes Y in the visualization
     double xMin = mesh.getMinX();
     double xMax = mesh.getMaxX();
-    double yMin = mesh.getMinY(); // This becomes zMin in visualization
-    double yMax = mesh.getMaxY(); // This becomes zMax in visualization (fixed typo)
     double zMin = mesh.getMinZ(); // This becomes yMin in visualization
     double zMax = mesh.getMaxZ(); // This becomes yMax in visualization
-    
-    // We want to slice along the new Z axis (which was Y before the swap)
-    double depthMin = yMin; // Min of new Z axis (former Y)
-    double depthMax = yMax; // Max of new Z axis (former Y)
-    double depthRange = depthMax - depthMin;
-    
-    if (depthRange <= 0) depthRange = 1.0; // Avoid division by zero
+
+    // We slice along the new Z axis (which was Y before the swap); the
+    // shared slice index holds that range and the stack positions
+    const SliceIndex& index = currentSliceIndex(mesh);
 
     // Extend boundaries a bit for better visibility
     double xExtend = (xMax - xMin) * 0.1;
@@ -632,10 +734,8 @@ void drawSliceLines(const MeshHandler& mesh) {
 
     // Calculate slice positions along the NEW Z-axis (former Y) - depth axis after swap
     std::vector<double> sliceZPositions; // Z in visualization is the former Y
-    for (int slice = 0; slice < nSlices; ++slice) {
-        // Ensure we cover the ENTIRE range from depthMin to depthMax inclusively
-        double depth = depthMin + ((nSlices > 1) ? (double(slice) / (nSlices - 1)) * depthRange : depthRange / 2.0);
-        sliceZPositions.push_back(depth); // This Y value becomes Z in visualization
+    for (int slice = 0; slice < index.getNumSlices(); ++slice) {
+        sliceZPositions.push_back(index.samplePosition(slice)); // This Y value becomes Z in visualization
     }
 
     // Save the current OpenGL state
@@ -703,22 +803,9 @@ void drawMeshDefault(const MeshHandler& mesh) {
     glMaterialfv(GL_FRONT, GL_SPECULAR, material_specular);
     glMaterialf(GL_FRONT, GL_SHININESS, material_shininess);
 
-    glBegin(GL_TRIANGLES);
-    for (const auto& face : faces) {
-         // Calculate face normal for proper lighting (flat shading)
-         const auto& v1 = vertices[face[0]];
-         const auto& v2 = vertices[face[1]];
-         const auto& v3 = vertices[face[2]];
-
-         auto normal = calculateNormalWithYZSwap(v1, v2, v3);
-         glNormal3d(normal[0], normal[1], normal[2]); // Set normal once per face
-
-        for (int i = 0; i < 3; ++i) {
-            const auto& vertex = vertices[face[i]];
-            drawVertexWithYZSwap(vertex);
-        }
-    }
-    glEnd();
+    // Flat-shaded geometry from the mesh's vertex buffers
+    meshRenderer.ensureMesh(mesh, meshRevision.load());
+    meshRenderer.draw(false);
 }
 
 // Helper function to draw a color scale for temperature or thickness visualization
@@ -772,6 +859,10 @@ void drawColorScale(int x, int y, int width, int height, bool isTemperature) {
         double minTemp = 273.0; // Default min (0°C)
         double maxTemp = solver.getTemperatureDistribution().empty() ? 
                         800.0 : solver.getTemperatureDistribution().back(); // Default max
+        if (currentVisMode == PLAYBACK_VIS && !playbackFrames.empty()) {
+            minTemp = playbackFrames.minTemp; // The playback colors span all slices and times
+            maxTemp = playbackFrames.maxTemp;
+        }
         
         // Draw temperature labels
         std::string maxLabel = "Max: " + std::to_string((int)maxTemp) + "K";
@@ -781,49 +872,17 @@ void drawColorScale(int x, int y, int width, int height, bool isTemperature) {
         
         // Title
         ImGui::SetCursorPos(ImVec2(10, barHeight + 20));
-        ImGui::Text("Temperature (K)");
+        if (currentVisMode == PLAYBACK_VIS && !playbackFrames.empty()) {
+            ImGui::Text("T (K) at %.3f s", playbackTime);
+        } else {
+            ImGui::Text("Temperature (K)");
+        }
     } else {
         // Get min/max TPU thickness from the simulation data
         double minThickness = DBL_MAX;
         double maxThickness = -DBL_MAX;
 
-        std::ifstream summaryFile("summary_output.csv");
-        if (summaryFile.is_open()) {
-            std::string line;
-            std::getline(summaryFile, line); // Skip header
-            while (std::getline(summaryFile, line)) {
-                std::stringstream ss(line);
-                std::string token;
-                std::getline(ss, token, ','); // slice
-                std::getline(ss, token, ','); // l/L
-                std::getline(ss, token, ','); // method
-                std::getline(ss, token, ','); // finalSteelTemp
-                std::getline(ss, token, ','); // TPS_thickness
-                double thickness = std::stod(token);
-                if (thickness > 0) {
-                    if (thickness < minThickness) minThickness = thickness;
-                    if (thickness > maxThickness) maxThickness = thickness;
-                }
-            }
-            summaryFile.close();
-        } else {
-            std::ifstream detailsFile("stack_details.csv");
-            if (detailsFile.is_open()) {
-                std::string line;
-                std::getline(detailsFile, line); // Skip header
-                while (std::getline(detailsFile, line)) {
-                    std::stringstream ss(line);
-                    std::string token;
-                    std::getline(ss, token, ','); // slice
-                    std::getline(ss, token, ','); // l/L
-                    std::getline(ss, token, ','); // TPS_thickness
-                    double thickness = std::stod(token);
-                    if (thickness < minThickness) minThickness = thickness;
-                    if (thickness > maxThickness) maxThickness = thickness;
-                }
-                detailsFile.close();
-            }
-        }
+        resultsStore.thicknessRange(minThickness, maxThickness); // untouched if there are no results
 
         if (minThickness == DBL_MAX) minThickness = 0.0;
         if (maxThickness == -DBL_MAX) maxThickness = 0.001; // Default max if no data
@@ -865,183 +924,29 @@ void drawTemperaturePlot(int x, int y, int width, int height) {
     const float tickSize = 5.0f;
     const ImU32 axisColor = IM_COL32(255, 255, 255, 255); // White
 
-    // ---- LOAD DATA ----
-    // Time history data structure
-    struct TimeHistoryData {
-        std::vector<double> time;
-        std::vector<double> carbonGlueTemp;
-        std::vector<double> glueSteelTemp;
-        std::vector<double> steelTemp;
-    };
-
-    TimeHistoryData origData, optData;
-
-    // Load original time history data
-    std::ifstream origHistFile("time_history_orig_slice_" + std::to_string(selectedSlice) + ".csv");
-    if (origHistFile.is_open()) {
-        std::string line;
-        // Skip header
-        std::getline(origHistFile, line);
-        
-        while (std::getline(origHistFile, line)) {
-            std::stringstream ss(line);
-            std::string token;
-            
-            // Read time
-            std::getline(ss, token, ',');
-            origData.time.push_back(std::stod(token));
-            
-            // Read carbon-glue temperature
-            std::getline(ss, token, ',');
-            origData.carbonGlueTemp.push_back(std::stod(token));
-            
-            // Read glue-steel temperature
-            std::getline(ss, token, ',');
-            origData.glueSteelTemp.push_back(std::stod(token));
-            
-            // Read steel temperature
-            std::getline(ss, token, ',');
-            origData.steelTemp.push_back(std::stod(token));
-        }
-        origHistFile.close();
-    }
-
-    // Load optimized time history data
-    std::ifstream optHistFile("time_history_opt_slice_" + std::to_string(selectedSlice) + ".csv");
-    if (optHistFile.is_open()) {
-        std::string line;
-        // Skip header
-        std::getline(optHistFile, line);
-        
-        while (std::getline(optHistFile, line)) {
-            std::stringstream ss(line);
-            std::string token;
-            
-            // Read time
-            std::getline(ss, token, ',');
-            optData.time.push_back(std::stod(token));
-            
-            // Read carbon-glue temperature
-            std::getline(ss, token, ',');
-            optData.carbonGlueTemp.push_back(std::stod(token));
-            
-            // Read glue-steel temperature
-            std::getline(ss, token, ',');
-            optData.glueSteelTemp.push_back(std::stod(token));
-            
-            // Read steel temperature
-            std::getline(ss, token, ',');
-            optData.steelTemp.push_back(std::stod(token));
-        }
-        optHistFile.close();
-    }
-
-    // Final temperature data structure
-    struct FinalTempData {
-        std::vector<double> positions;
-        std::vector<double> temperatures;
-    };
+    // ---- DATA (from the in-memory results store; no file I/O per frame) ----
+    static const SliceResult noResult;
+    std::shared_ptr<const SliceResult> result = resultsStore.getSlice(selectedSlice - 1);
+    const SliceResult& data = result ? *result : noResult;
 
-    FinalTempData finalOrigData, finalOptData;
+    const SliceHistory& origData = data.origHistory;
+    const SliceHistory& optData = data.optHistory;
+    const TemperatureProfile& finalOrigData = data.finalOrig;
+    const TemperatureProfile& finalOptData = data.finalOpt;
 
-    // Load original final temperature data
-    std::ifstream finalOrigFile("final_temperature_orig_slice_" + std::to_string(selectedSlice) + ".csv");
-    if (finalOrigFile.is_open()) {
-        std::string line;
-        // Skip header
-        std::getline(finalOrigFile, line);
-        
-        while (std::getline(finalOrigFile, line)) {
-            std::stringstream ss(line);
-            std::string token;
-            
-            // Read position
-            std::getline(ss, token, ',');
-            finalOrigData.positions.push_back(std::stod(token));
-            
-            // Read temperature
-            std::getline(ss, token, ',');
-            finalOrigData.temperatures.push_back(std::stod(token));
-        }
-        finalOrigFile.close();
-    }
-
-    // Load optimized final temperature data
-    std::ifstream finalOptFile("final_temperature_opt_slice_" + std::to_string(selectedSlice) + ".csv");
-    if (finalOptFile.is_open()) {
-        std::string line;
-        // Skip header
-        std::getline(finalOptFile, line);
-        
-        while (std::getline(finalOptFile, line)) {
-            std::stringstream ss(line);
-            std::string token;
-            
-            // Read position
-            std::getline(ss, token, ',');
-            finalOptData.positions.push_back(std::stod(token));
-            
-            // Read temperature
-            std::getline(ss, token, ',');
-            finalOptData.temperatures.push_back(std::stod(token));
-        }
-        finalOptFile.close();
-    }
-
-    // Try to load material layer info from stack_details.csv for marking interfaces
+    // Material layer boundaries of the original stack, for marking interfaces
     std::vector<std::pair<std::string, double>> layerBoundaries;
-    std::ifstream detailsFile("stack_details.csv");
-    if (detailsFile.is_open()) {
-        // Read header to get column positions
-        std::string header;
-        std::getline(detailsFile, header);
-        std::stringstream headerSS(header);
-        std::string col;
-        std::vector<std::string> columns;
-        
-        while (std::getline(headerSS, col, ',')) {
-            columns.push_back(col);
-        }
-        
-        // Find the row for selected slice
-        std::string dataRow;
-        while (std::getline(detailsFile, dataRow)) {
-            std::stringstream ss(dataRow);
-            std::string sliceValue;
-            std::getline(ss, sliceValue, ',');
-            
-            if (sliceValue == std::to_string(selectedSlice)) { // Found selected slice
-                std::stringstream dataSS(dataRow);
-                std::vector<std::string> values;
-                std::string val;
-                
-                while (std::getline(dataSS, val, ',')) {
-                    values.push_back(val);
-                }
-                
-                // Get layer thicknesses - Original TPS, CarbonFiber, Glue, Steel
-                if (values.size() >= 6) {
-                    double position = 0.0;
-                    double tpsThick = std::stod(values[2]);
-                    double cfThick = std::stod(values[3]);
-                    double glueThick = std::stod(values[4]);
-                    double steelThick = std::stod(values[5]);
-                    
-                    layerBoundaries.push_back({"TPS Start", position});
-                    position += tpsThick;
-                    layerBoundaries.push_back({"Carbon Fiber Start", position});
-                    position += cfThick;
-                    layerBoundaries.push_back({"Glue Start", position});
-                    position += glueThick;
-                    layerBoundaries.push_back({"Steel Start", position});
-                    position += steelThick;
-                    layerBoundaries.push_back({"End", position});
-                }
-                
-                break; // Found what we needed
-            }
-        }
-        detailsFile.close();
+    if (result) {
+        double position = 0.0;
+        layerBoundaries.push_back({"TPS Start", position});
+        position += data.tpsThickness;
+        layerBoundaries.push_back({"Carbon Fiber Start", position});
+        position += data.carbonFiberThickness;
+        layerBoundaries.push_back({"Glue Start", position});
+        position += data.glueThickness;
+        layerBoundaries.push_back({"Steel Start", position});
+        position += data.steelThickness;
+        layerBoundaries.push_back({"End", position});
     }
 
     // ---- FIRST PLOT: TIME HISTORY (ORIGINAL) ----
@@ -1727,12 +1632,25 @@ void drawTemperaturePlot(int x, int y, int width, int height) {
 }
 
 // ---- Simulation Logic ----
-void runSimulationLogic() {
+// Results, log text and timings produced by one slice task
+struct SliceOutput {
+    std::string log;
+    std::string summaryRow;
+    std::string detailsRow;
+    double tStackSetup = 0.0;
+    double tOrigSolve = 0.0;
+    double tHistOrigSave = 0.0;
+    double tOptSolve = 0.0;
+    double tOptSuggestion = 0.0;
+    double tHistOptSave = 0.0;
+    double tSummaryDetailsWrite = 0.0;
+};
+
+bool runSimulationLogic(const SimulationParams& params, SimulationJob& job) {
     try {
-        if (strlen(meshPath) == 0) {
-            appLog += "❌ Error: Please select a mesh file.\n";
-            triggerSimulation = false; // Stop trigger if error
-            return;
+        if (params.meshPath.empty()) {
+            job.log("❌ Error: Please select a mesh file.\n");
+            return false;
         }
 
         // === TIMERS ===
@@ -1749,56 +1667,59 @@ void runSimulationLogic() {
         // overall timer
         auto overall_start = std::chrono::high_resolution_clock::now();
 
-        // Use the MeshHandler constructor with filename parameter
-        auto start = std::chrono::high_resolution_clock::now();
-        meshHandler = MeshHandler(meshPath); // Use the constructor that takes a filename
-        tMeshLoad = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+        Profiler::enable(params.enableProfiling);
+        Profiler::reset();
+
+        // Load into a local mesh; the GUI thread takes a copy in installJobResults()
+        std::unique_ptr<MeshHandler> mesh;
+        {
+            ProfileZone zone("mesh_load", -1, &tMeshLoad);
+            mesh.reset(new MeshHandler(params.meshPath)); // Use the constructor that takes a filename
+        }
         
         // Check if mesh is properly loaded
-        if (meshHandler.getVertices().empty() || meshHandler.getFaces().empty()) {
-            appLog += "❌ Error: Failed to load mesh file or mesh is empty: " + std::string(meshPath) + "\n";
-            triggerSimulation = false; // Stop trigger if error
-            meshLoadedForVis = false;
-            return;
+        if (mesh->getVertices().empty() || mesh->getFaces().empty()) {
+            job.log("❌ Error: Failed to load mesh file or mesh is empty: " + params.meshPath + "\n");
+            return false;
         }
-        meshLoadedForVis = true; // Mark mesh as loaded for visualization
-        appLog += "✅ Mesh loaded successfully for simulation.\n";
+        job.log("✅ Mesh loaded successfully for simulation.\n");
 
         // Get mesh bounds - use safe accessors with error checking
-        double zmin = meshHandler.getMinZ();
-        double zmax = meshHandler.getMaxZ();
+        double zmin = mesh->getMinZ();
+        double zmax = mesh->getMaxZ();
+        {
+            std::lock_guard<std::mutex> lock(jobHandoffMutex);
+            pendingMesh = std::move(mesh);
+        }
         double height = zmax - zmin;
         if (height <= 0) height = 1.0; // Avoid division by zero if mesh is flat
 
         // ---- Initial temperature loading ----
-        auto init_start = std::chrono::high_resolution_clock::now();
+        ProfileZone initZone("init_temp_load", -1, &tInitTempLoad);
         std::vector<double> uniformInit;
-        if (strlen(initTempPath) > 0) {
+        if (!params.initTempPath.empty()) {
             InitialTemperature tempLoader;
-            if (!std::filesystem::exists(initTempPath)) {
-                appLog += "⚠️ Warning: Initial temperature file not found: " + std::string(initTempPath) + ". Using default 300K.\n";
+            if (!std::filesystem::exists(params.initTempPath)) {
+                job.log("⚠️ Warning: Initial temperature file not found: " + params.initTempPath + ". Using default 300K.\n");
             } else {
-                uniformInit = tempLoader.loadInitialTemperature(initTempPath);
+                uniformInit = tempLoader.loadInitialTemperature(params.initTempPath);
                 if (uniformInit.empty()) {
-                    appLog += "⚠️ Warning: Failed to load or empty initial temperature file. Using default 300K.\n";
+                    job.log("⚠️ Warning: Failed to load or empty initial temperature file. Using default 300K.\n");
                 }
             }
         }
-        tInitTempLoad = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - init_start).count();
-
-        // Material properties
-        MaterialProperties matProps;
+        initZone.stop();
 
         // Open output files with better error handling
-        std::ofstream summaryOut(outputFile);
+        std::ofstream summaryOut(params.outputFile);
         if (!summaryOut) {
-            appLog += "❌ Error: Could not open summary output file: " + std::string(outputFile) + "\n";
-            triggerSimulation = false; return;
+            job.log("❌ Error: Could not open summary output file: " + params.outputFile + "\n");
+            return false;
         }
         std::ofstream detailsOut("stack_details.csv");
         if (!detailsOut) {
-            appLog += "❌ Error: Could not open details output file: stack_details.csv\n";
-            triggerSimulation = false; return;
+            job.log("❌ Error: Could not open details output file: stack_details.csv\n");
+            return false;
         }
 
         summaryOut << "slice,l/L,method,finalSteelTemp,TPS_thickness,OriginalSteelTemp\n";
@@ -1807,147 +1728,142 @@ void runSimulationLogic() {
                   << "PreCarbonTemp,PreGlueTemp,PreSteelTemp,"
                   << "OptimizedTPS,PostCarbonTemp,PostGlueTemp,PostSteelTemp\n";
 
-        double totalSolveMs = 0.0;
-        HeatEquationSolver currentSolver; // Local solver for the simulation run
-
-        // Loop over all slices
-        for (int slice = 0; slice < nSlices; ++slice) {
-            currentProcessingStatus = "Processing stack " + std::to_string(slice + 1) + " of " + std::to_string(nSlices);
-
-            double z = zmin + (nSlices > 1 ? (double(slice)/(nSlices-1)) * height : height / 2.0); // Handle nSlices=1 case
-            double lL = (nSlices > 1 ? (z - zmin) / height : 0.5);
+        // Each slice task fills its own entry; rows and log text are merged
+        // back in slice order so the output does not depend on the thread count.
+        std::vector<SliceOutput> outputs(params.nSlices);
+
+        const std::vector<std::string> historyColumns =
+            { "time[s]", "T_carbon_glue[K]", "T_glue_steel[K]", "T_steel[K]" };
+        HistoryOptions histOptions;
+        histOptions.every = params.historyEvery;
+
+        // Solver and search settings of every slice; the initial profile is
+        // applied per slice, where a mismatch falls back to 300 K
+        SliceSettings settings;
+        settings.dt             = params.timeStep;
+        settings.theta          = params.theta;
+        settings.duration       = params.simDuration;
+        settings.adaptive       = params.useAdaptiveTimeStep;
+        settings.pointsPerLayer = params.pointsPerLayer;
+        settings.steps.adaptiveTolerance = params.adaptiveTolerance;
+        settings.steps.steadyStateRate   = params.steadyStateTolerance;
+        settings.searchWays     = params.searchWays;
+        settings.searchThreads  = SliceScheduler::nestedThreads(params.nThreads);
+        if (params.useResultCache) settings.cache = &resultCache;
+        settings.cancelToken    = &job.getToken();
+
+        auto runSlice = [&](int slice) {
+            SliceOutput& out = outputs[slice];
+            if (job.isCancelled()) return; // Queued slices of a cancelled run
+            ProfileZone sliceZone("slice", slice);
+            job.setStatus("Processing stack " + std::to_string(slice + 1) + " of " + std::to_string(params.nSlices));
+
+            double z = zmin + (params.nSlices > 1 ? (double(slice)/(params.nSlices-1)) * height : height / 2.0); // Handle nSlices=1 case
+            double lL = (params.nSlices > 1 ? (z - zmin) / height : 0.5);
             if (height <= 0) lL = 0.0; // Handle flat mesh case
 
             // ---- Stack setup (incl. grid gen) ----
-            auto stack_start = std::chrono::high_resolution_clock::now();
-            Stack stack;
-            stack.id = slice + 1;
-
-            // Define layers within the loop for clarity
-            Layer tpsLayer = {{"TPS", 0.2, 160.0, 1200.0, 0.0, 1200.0}, matProps.getTPSThickness(lL), pointsPerLayer};
-            Layer carbonFiberLayer = {{"CarbonFiber", 500.0, 1600.0, 700.0, 0.0, 350.0}, matProps.getCarbonFiberThickness(lL), pointsPerLayer};
-            Layer glueLayer = {{"Glue", 200.0, 1300.0, 900.0, 0.0, 400.0}, matProps.getGlueThickness(lL), pointsPerLayer};
-            Layer steelLayer = {{"Steel", 100.0, 7850.0, 500.0, 800.0, 0.0}, matProps.getSteelThickness(lL), pointsPerLayer};
-
-            stack.layers = { tpsLayer, carbonFiberLayer, glueLayer, steelLayer };
-            
-            double tpsThick = matProps.getTPSThickness(lL);
-            double cfThick = matProps.getCarbonFiberThickness(lL);
-            double glueThick = matProps.getGlueThickness(lL);
-            double steelThick = matProps.getSteelThickness(lL);
-
-            matProps.generateGrid(stack, pointsPerLayer);
-            tStackSetup = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - stack_start).count();
+            ProfileZone stackZone("slice.stack_setup", slice, &out.tStackSetup);
+            SliceRun run(settings, slice + 1, lL);
+            const Stack& stack = run.getStack();
+            double tpsThick = stack.layers[0].thickness;
+            double cfThick = stack.layers[1].thickness;
+            double glueThick = stack.layers[2].thickness;
+            double steelThick = stack.layers[3].thickness;
+            stackZone.stop();
 
             if (stack.xGrid.empty()) {
-                appLog += "❌ Error: Grid generation failed for slice " + std::to_string(slice + 1) + "\n";
-                continue; // Skip this slice
+                out.log += "❌ Error: Grid generation failed for slice " + std::to_string(slice + 1) + "\n";
+                return; // Skip this slice
             }
 
-            // Compute interface indices
-            double posCG = tpsThick + cfThick;
-            double posGS = posCG + glueThick;
-            auto idxCarbonGlue = std::lower_bound(stack.xGrid.begin(), stack.xGrid.end(), posCG) - stack.xGrid.begin();
-            auto idxGlueSteel = std::lower_bound(stack.xGrid.begin(), stack.xGrid.end(), posGS) - stack.xGrid.begin();
+            SliceResult result; // Published to resultsStore once the slice is done
+            result.slice = slice + 1;
+            result.lL = lL;
+            result.tpsThickness = tpsThick;
+            result.carbonFiberThickness = cfThick;
+            result.glueThickness = glueThick;
+            result.steelThickness = steelThick;
 
-            // Initialize solver for this slice
-            TimeHandler timer(simDuration, timeStep, useAdaptiveTimeStep);
-            currentSolver = HeatEquationSolver(theta); // Use the local solver
-            currentSolver.initialize(stack, timer);
+            // Initialize solver for this slice (step control, exhaust-gas surface)
+            HeatEquationSolver currentSolver(params.theta); // Local solver for this slice
+            try {
+                run.setUp(currentSolver);
+            } catch (const std::exception& bc_err) {
+                out.log += "❌ Error setting up the solver: " + std::string(bc_err.what()) + "\n";
+                return; // Skip slice if the setup fails
+            }
 
             // Set initial temperature
             if (!uniformInit.empty()) {
                 // Check if size matches grid size
                 if (uniformInit.size() != stack.xGrid.size()) {
-                    appLog += "⚠️ Warning: Initial temperature data size mismatch (expected "
+                    out.log += "⚠️ Warning: Initial temperature data size mismatch (expected "
                             + std::to_string(stack.xGrid.size()) + ", got "
                             + std::to_string(uniformInit.size()) + "). Using default 300K.\n";
-                    currentSolver.setInitialTemperature(std::vector<double>(stack.xGrid.size(), 300.0));
                 } else {
                     currentSolver.setInitialTemperature(uniformInit);
                 }
-            } else {
-                currentSolver.setInitialTemperature(std::vector<double>(stack.xGrid.size(), 300.0));
-                if (slice == 0) { // Only log this once per run
-                    appLog += "Using default initial temperature: 300K\n";
-                }
+            } else if (slice == 0) { // Only log this once per run
+                out.log += "Using default initial temperature: 300K\n";
             }
 
-            // Set boundary conditions
-            try {
-                currentSolver.setBoundaryConditions(
-                    new DirichletCondition(static_cast<float>(matProps.getExhaustTemp(lL))), 
-                    new NeumannCondition(0.0f)
-                );
-            } catch (const std::exception& bc_err) {
-                appLog += "❌ Error setting boundary conditions: " + std::string(bc_err.what()) + "\n";
-                continue; // Skip slice if BCs fail
+            // Stream the time history for original thickness (CSV, the plots read it)
+            HistoryWriter histOrig("time_history_orig_slice_" + std::to_string(slice+1) + ".csv",
+                                   historyColumns, histOptions);
+            if (!histOrig.isOpen()) {
+                out.log += "⚠️ Warning: Could not save original time history for slice " + std::to_string(slice+1) + "\n";
             }
 
-            // Prepare time history buffer for original thickness
-            std::ostringstream histOrigBuffer;
-            histOrigBuffer << "time[s],T_carbon_glue[K],T_glue_steel[K],T_steel[K]\n";
+            long origRows = 0;
 
             // Timer for solver per slice
-            auto solve_start = std::chrono::high_resolution_clock::now();
-            double maxSteps = (timeStep > 0) ? (simDuration / timeStep) : 1.0; // Avoid division by zero
-            if (maxSteps <= 0) maxSteps = 1.0;
+            ProfileZone solveZone("slice.orig_solve", slice, &out.tOrigSolve);
 
             // ---- Original solver run ----
-            while (!timer.isFinished()) {
-                try {
-                    currentSolver.step();
-                } catch (const std::exception& step_err) {
-                    appLog += "❌ Error during solver step for slice " + std::to_string(slice+1) + ": " + std::string(step_err.what()) + "\n";
-                    goto next_slice; // Break inner loop, go to next slice
-                }
-                
-                double t = timer.getCurrentTime();
-                const auto& Tdist = currentSolver.getTemperatureDistribution();
-                
-                // Record interface temperatures for history
-                if (idxCarbonGlue < Tdist.size() && idxGlueSteel < Tdist.size()) {
-                    histOrigBuffer 
-                        << t << ","
-                        << Tdist[idxCarbonGlue] << ","
-                        << Tdist[idxGlueSteel] << ","
-                        << Tdist.back() << "\n";
-                }
-                
-                timer.advance();
-                // Update progress (divide by nSlices to show overall progress)
-                progress = (slice + (static_cast<float>(timer.getStepCount()) / maxSteps)) / (nSlices * 2); // First half of progress
+            // (the solver owns the possibly adaptive clock; cancellation is checked between steps)
+            InterfaceTemperatures orig;
+            try {
+                orig = run.transient(currentSolver, [&](const HeatEquationSolver& solver) {
+                    double t = solver.getCurrentTime();
+                    InterfaceTemperatures T = run.readInterfaces(solver.getTemperatureDistribution());
+                    // Record interface temperatures for history
+                    histOrig.record({ t, T.carbonGlue, T.glueSteel, T.steel });
+                    if (origRows++ % params.historyEvery == 0 || solver.isFinished()) {
+                        result.origHistory.append(t, T.carbonGlue, T.glueSteel, T.steel);
+                    }
+                });
+            } catch (const JobCancelled&) {
+                return;
+            } catch (const std::exception& step_err) {
+                out.log += "❌ Error during solver step for slice " + std::to_string(slice+1) + ": " + std::string(step_err.what()) + "\n";
+                return; // Abandon this slice
             }
+            job.advance(); // Each run is half a slice
 
-            auto solve_end = std::chrono::high_resolution_clock::now();
-            tOrigSolve = std::chrono::duration<double, std::milli>(solve_end - solve_start).count();
-            totalSolveMs += tOrigSolve;
+            solveZone.stop();
 
-            // ---- Original history CSV save ----
-            auto saveOrig_start = std::chrono::high_resolution_clock::now();
+            // ---- Original history flush (waits for the writer thread) ----
             {
-                std::ofstream histOrig(
-                    "time_history_orig_slice_" + std::to_string(slice+1) + ".csv"
-                );
-                if (histOrig) {
-                    histOrig << histOrigBuffer.str();
-                    histOrig.close();
-                } else {
-                    appLog += "⚠️ Warning: Could not save original time history for slice " + std::to_string(slice+1) + "\n";
-                }
+                ProfileZone zone("slice.orig_history_flush", slice, &out.tHistOrigSave);
+                histOrig.close();
             }
-            tHistOrigSave = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - saveOrig_start).count();
 
             // Get results for original thickness
             const auto& Tdist = currentSolver.getTemperatureDistribution();
             if (Tdist.empty()) {
-                appLog += "⚠️ Warning: No temperature distribution result for slice " + std::to_string(slice + 1) + "\n";
-                continue; // Skip results processing for this slice
+                out.log += "⚠️ Warning: No temperature distribution result for slice " + std::to_string(slice + 1) + "\n";
+                return; // Skip results processing for this slice
             }
             
-            double origTempCarbon = (idxCarbonGlue < Tdist.size()) ? Tdist[idxCarbonGlue] : 0.0;
-            double origTempGlue = (idxGlueSteel < Tdist.size()) ? Tdist[idxGlueSteel] : 0.0;
-            double origTempSteel = Tdist.back(); // Assume last point is steel surface
+            double origTempCarbon = orig.carbonGlue;
+            double origTempGlue = orig.glueSteel;
+            double origTempSteel = orig.steel;
+            result.preCarbonTemp = origTempCarbon;
+            result.preGlueTemp = origTempGlue;
+            result.preSteelTemp = origTempSteel;
+            result.finalOrig.positions.assign(stack.xGrid.begin(), stack.xGrid.begin() + std::min(Tdist.size(), stack.xGrid.size()));
+            result.finalOrig.temperatures.assign(Tdist.begin(), Tdist.begin() + result.finalOrig.positions.size());
 
             // Export final temperature distribution for each slice - Original version
             {
@@ -1959,11 +1875,11 @@ void runSimulationLogic() {
                     }
                     outFile.close();
                 } else {
-                    appLog += "❌ Error: Could not open final_temperature_orig_slice_" + std::to_string(slice+1) + ".csv for writing.\n";
+                    out.log += "❌ Error: Could not open final_temperature_orig_slice_" + std::to_string(slice+1) + ".csv for writing.\n";
                 }
                 
                 // Also save to final_temperature_orig.csv if it's the last slice
-                if (slice == nSlices - 1) {
+                if (slice == params.nSlices - 1) {
                     std::ofstream finalOutFile("final_temperature_orig.csv");
                     if (finalOutFile) {
                         finalOutFile << "x,Temperature\n"; // Add header
@@ -1972,43 +1888,28 @@ void runSimulationLogic() {
                         }
                         finalOutFile.close();
                     } else {
-                        appLog += "❌ Error: Could not open final_temperature_orig.csv for writing.\n";
+                        out.log += "❌ Error: Could not open final_temperature_orig.csv for writing.\n";
                     }
                 }
             }
 
             // Suggest optimal TPS thickness
-            currentProcessingStatus = "Optimizing TPS thickness for stack " + std::to_string(slice + 1);
+            job.setStatus("Optimizing TPS thickness for stack " + std::to_string(slice + 1));
             double tpsOpt = -1.0; // Default invalid value
             
-            auto optSuggest_start = std::chrono::high_resolution_clock::now();
+            ProfileZone suggestZone("slice.tps_search", slice, &out.tOptSuggestion);
             try {
-                TemperatureComparator comp;
-                comp.setTimeStep(timeStep, useAdaptiveTimeStep);
-                comp.setGridResolution(pointsPerLayer);
-                
-                // Ensure stack is valid before passing to comparator
-                if (!stack.layers.empty() && !stack.xGrid.empty()) {
-                    tpsOpt = comp.suggestTPSThickness(
-                        stack,
-                        800.0,   // max steel temp @ steel/glue
-                        400.0,   // max glue  temp @ glue/carbon
-                        350.0,   // max carbon temp @ carbon/external
-                        simDuration,
-                        lL,
-                        matProps,
-                        theta
-                    );
-                } else {
-                    appLog += "⚠️ Warning: Cannot optimize TPS for slice " + std::to_string(slice + 1) + " due to invalid stack.\n";
-                }
+                // Limits of the stack's materials (800/400/350 K)
+                tpsOpt = run.suggestThickness(run.materialLimits());
+            } catch (const JobCancelled&) {
+                return;
             } catch (const std::exception& opt_err) {
-                appLog += "❌ Error during TPS optimization for slice " + std::to_string(slice+1) + ": " + std::string(opt_err.what()) + "\n";
+                out.log += "❌ Error during TPS optimization for slice " + std::to_string(slice+1) + ": " + std::string(opt_err.what()) + "\n";
             }
-            tOptSuggestion = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - optSuggest_start).count();
+            suggestZone.stop();
 
             // --- Re-run solver with optimized thickness ---
-            currentProcessingStatus = "Running with optimized thickness for stack " + std::to_string(slice + 1);
+            job.setStatus("Running with optimized thickness for stack " + std::to_string(slice + 1));
             
             // Only run optimized simulation if we got a valid thickness
             double postTempCarbon = 0.0;
@@ -2016,89 +1917,66 @@ void runSimulationLogic() {
             double postTempSteel = 0.0;
             
             if (tpsOpt > 0) {
-                stack.layers[0].thickness = tpsOpt;
-                matProps.generateGrid(stack, pointsPerLayer);
-
-                TimeHandler timerOpt(simDuration, timeStep, useAdaptiveTimeStep);
-                HeatEquationSolver solverOpt(theta);
-                solverOpt.initialize(stack, timerOpt);
-                
-                if (uniformInit.empty() || uniformInit.size() != stack.xGrid.size()) {
-                    solverOpt.setInitialTemperature(std::vector<double>(stack.xGrid.size(), 300.0));
-                } else {
-                    solverOpt.setInitialTemperature(uniformInit);
-                }
-                
+                run.setTPSThickness(tpsOpt);
+                HeatEquationSolver solverOpt(params.theta);
                 try {
-                    solverOpt.setBoundaryConditions(
-                        new DirichletCondition(static_cast<float>(matProps.getExhaustTemp(lL))),
-                        new NeumannCondition(0.0f)
-                    );
+                    run.setUp(solverOpt);
                 } catch (const std::exception& bc_err) {
-                    appLog += "❌ Error setting boundary conditions for optimized run: " + std::string(bc_err.what()) + "\n";
-                    goto skip_opt_run; // Skip optimized simulation if BCs fail
+                    out.log += "❌ Error setting up the optimized run: " + std::string(bc_err.what()) + "\n";
+                    goto skip_opt_run; // Skip optimized simulation if the setup fails
+                }
+                if (!uniformInit.empty() && uniformInit.size() == stack.xGrid.size()) {
+                    solverOpt.setInitialTemperature(uniformInit);
                 }
 
-                auto solveOpt_start = std::chrono::high_resolution_clock::now();
-                std::ostringstream histOptBuffer;
-                histOptBuffer << "time[s],T_carbon_glue[K],T_glue_steel[K],T_steel[K]\n";
+                long optRows = 0;
+                ProfileZone solveOptZone("slice.opt_solve", slice, &out.tOptSolve);
+                HistoryWriter histOpt("time_history_opt_slice_" + std::to_string(slice+1) + ".csv",
+                                      historyColumns, histOptions);
+                if (!histOpt.isOpen()) {
+                    out.log += "⚠️ Warning: Could not save optimized time history for slice " + std::to_string(slice+1) + "\n";
+                }
                 
-                while (!timerOpt.isFinished()) {
-                    try {
-                        solverOpt.step();
-                    } catch (const std::exception& step_err) {
-                        appLog += "❌ Error during optimized solver step: " + std::string(step_err.what()) + "\n";
-                        break;
-                    }
-                    
-                    double t2 = timerOpt.getCurrentTime();
-                    const auto& T2 = solverOpt.getTemperatureDistribution();
-                    
-                    if (idxCarbonGlue < T2.size() && idxGlueSteel < T2.size()) {
-                        histOptBuffer
-                            << t2 << ","
-                            << T2[idxCarbonGlue] << ","
-                            << T2[idxGlueSteel] << ","
-                            << T2.back() << "\n";
-                    }
-                    
-                    timerOpt.advance();
-                    // Update progress for second half (optimized run)
-                    progress = 0.5 + (slice + (static_cast<float>(timerOpt.getStepCount()) / maxSteps)) / (nSlices * 2);
+                try {
+                    run.transient(solverOpt, [&](const HeatEquationSolver& solver) {
+                        double t2 = solver.getCurrentTime();
+                        InterfaceTemperatures T = run.readInterfaces(solver.getTemperatureDistribution());
+                        histOpt.record({ t2, T.carbonGlue, T.glueSteel, T.steel });
+                        if (optRows++ % params.historyEvery == 0 || solver.isFinished()) {
+                            result.optHistory.append(t2, T.carbonGlue, T.glueSteel, T.steel);
+                        }
+                    });
+                } catch (const JobCancelled&) {
+                    return;
+                } catch (const std::exception& step_err) {
+                    out.log += "❌ Error during optimized solver step: " + std::string(step_err.what()) + "\n";
                 }
                 
-                tOptSolve = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - solveOpt_start).count();
-                totalSolveMs += tOptSolve;
+                solveOptZone.stop();
                 
-                // ---- Optimized history CSV save ----
-                auto saveOpt_start = std::chrono::high_resolution_clock::now();
+                // ---- Optimized history flush ----
                 {
-                    std::ofstream histOpt(
-                        "time_history_opt_slice_" + std::to_string(slice+1) + ".csv"
-                    );
-                    if (histOpt) {
-                        histOpt << histOptBuffer.str();
-                        histOpt.close();
-                    } else {
-                        appLog += "⚠️ Warning: Could not save optimized time history for slice " + std::to_string(slice+1) + "\n";
-                    }
+                    ProfileZone zone("slice.opt_history_flush", slice, &out.tHistOptSave);
+                    histOpt.close();
                 }
-                tHistOptSave = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - saveOpt_start).count();
 
                 // Sample optimized steel temp
-                const auto& Topt = solverOpt.getTemperatureDistribution();
-                postTempCarbon = (idxCarbonGlue < Topt.size()) ? Topt[idxCarbonGlue] : 0.0;
-                postTempGlue = (idxGlueSteel < Topt.size()) ? Topt[idxGlueSteel] : 0.0;
-                postTempSteel = Topt.back();
+                InterfaceTemperatures post = run.readInterfaces(solverOpt.getTemperatureDistribution());
+                postTempCarbon = post.carbonGlue;
+                postTempGlue = post.glueSteel;
+                postTempSteel = post.steel;
                 
                 // Store the optimized solver result if it's the last slice
-                if (slice == nSlices - 1) {
-                    solver = solverOpt; // Store the solver state globally for visualization
+                if (slice == params.nSlices - 1) {
+                    std::lock_guard<std::mutex> lock(jobHandoffMutex);
+                    pendingSolver.reset(new HeatEquationSolver(solverOpt)); // For the temperature view
                 }
 
                 // Export final temperature distribution for each slice - Optimized version
                 if (tpsOpt > 0 && postTempSteel > 0) {
                     const auto& Topt = solverOpt.getTemperatureDistribution();
+                    result.finalOpt.positions.assign(stack.xGrid.begin(), stack.xGrid.begin() + std::min(Topt.size(), stack.xGrid.size()));
+                    result.finalOpt.temperatures.assign(Topt.begin(), Topt.begin() + result.finalOpt.positions.size());
                     std::ofstream outFile("final_temperature_opt_slice_" + std::to_string(slice+1) + ".csv");
                     if (outFile) {
                         outFile << "x,Temperature\n"; // Add header
@@ -2107,11 +1985,11 @@ void runSimulationLogic() {
                         }
                         outFile.close();
                     } else {
-                        appLog += "❌ Error: Could not open final_temperature_opt_slice_" + std::to_string(slice+1) + ".csv for writing.\n";
+                        out.log += "❌ Error: Could not open final_temperature_opt_slice_" + std::to_string(slice+1) + ".csv for writing.\n";
                     }
                     
                     // Also save to final_temperature_opt.csv if it's the last slice
-                    if (slice == nSlices - 1) {
+                    if (slice == params.nSlices - 1) {
                         std::ofstream finalOutFile("final_temperature_opt.csv");
                         if (finalOutFile) {
                             finalOutFile << "x,Temperature\n"; // Add header
@@ -2120,7 +1998,7 @@ void runSimulationLogic() {
                             }
                             finalOutFile.close();
                         } else {
-                            appLog += "❌ Error: Could not open final_temperature_opt.csv for writing.\n";
+                            out.log += "❌ Error: Could not open final_temperature_opt.csv for writing.\n";
                         }
                     }
                 }
@@ -2136,11 +2014,11 @@ void runSimulationLogic() {
                         }
                         outFile.close();
                     } else {
-                        appLog += "❌ Error: Could not open final_temperature_slice_" + std::to_string(slice+1) + ".csv for writing.\n";
+                        out.log += "❌ Error: Could not open final_temperature_slice_" + std::to_string(slice+1) + ".csv for writing.\n";
                     }
                     
                     // Also save to final_temperature.csv if it's the last slice (for backward compatibility with visualization)
-                    if (slice == nSlices - 1) {
+                    if (slice == params.nSlices - 1) {
                         std::ofstream finalOutFile("final_temperature.csv");
                         if (finalOutFile) {
                             finalOutFile << "x,Temperature\n"; // Add header
@@ -2150,27 +2028,32 @@ void runSimulationLogic() {
                             }
                             finalOutFile.close();
                         } else {
-                            appLog += "❌ Error: Could not open final_temperature.csv for writing.\n";
+                            out.log += "❌ Error: Could not open final_temperature.csv for writing.\n";
                         }
                     }
                 }
             }
             
 skip_opt_run:
-            // ---- Summary & details CSV writes ----
-            auto out_start = std::chrono::high_resolution_clock::now();
+            job.advance();
 
-            // Write summary CSV with the optimized‐thickness temperature
-            summaryOut 
+            // ---- Summary & details rows (written in order after the run) ----
+            ProfileZone rowsZone("slice.rows", slice, &out.tSummaryDetailsWrite);
+
+            // Summary row with the optimized‐thickness temperature
+            std::ostringstream summaryRow;
+            summaryRow 
                 << (slice + 1) << ","
                 << lL << ","
                 << "BTCS" << ","
                 << (postTempSteel > 0 ? postTempSteel : origTempSteel) << ","
                 << (tpsOpt > 0 ? tpsOpt : tpsThick) << ","
                 << origTempSteel << "\n";
+            out.summaryRow = summaryRow.str();
 
-            // write the detailed interface temps
-            detailsOut
+            // the detailed interface temps
+            std::ostringstream detailsRow;
+            detailsRow
                 << (slice+1) << ","
                 << lL << ","
                 << tpsThick << ","  // original TPS
@@ -2184,14 +2067,40 @@ skip_opt_run:
                 << (postTempCarbon > 0 ? postTempCarbon : origTempCarbon) << ","
                 << (postTempGlue > 0 ? postTempGlue : origTempGlue) << ","
                 << (postTempSteel > 0 ? postTempSteel : origTempSteel) << "\n";
-                
-            tSummaryDetailsWrite = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - out_start).count();
+            out.detailsRow = detailsRow.str();
+
+            result.optimizedTPS = tpsOpt;
+            result.postCarbonTemp = postTempCarbon > 0 ? postTempCarbon : origTempCarbon;
+            result.postGlueTemp = postTempGlue > 0 ? postTempGlue : origTempGlue;
+            result.postSteelTemp = postTempSteel > 0 ? postTempSteel : origTempSteel;
+            if (job.isCancelled()) return; // Results of a cancelled run are dropped
+            resultsStore.publish(slice, std::move(result));
+        };
 
-next_slice:; // Label for jumping to next slice on error
-        } // End slice loop
+        // Run all slices on the work-stealing pool
+        resultsStore.reset(params.nSlices);
+        job.setTotal(params.nSlices * 2);
+        SliceScheduler scheduler(params.nThreads);
+        scheduler.run(params.nSlices, runSlice);
 
-        // Clear processing status when done
-        currentProcessingStatus.clear();
+        if (job.isCancelled()) {
+            job.log("⏹ Simulation cancelled.\n");
+            return false; // Reported as cancelled
+        }
+
+        // Gather rows, log text and timers back in slice order
+        for (const auto& out : outputs) {
+            job.log(out.log);
+            summaryOut << out.summaryRow;
+            detailsOut << out.detailsRow;
+            tStackSetup          += out.tStackSetup;
+            tOrigSolve           += out.tOrigSolve;
+            tHistOrigSave        += out.tHistOrigSave;
+            tOptSolve            += out.tOptSolve;
+            tOptSuggestion       += out.tOptSuggestion;
+            tHistOptSave         += out.tHistOptSave;
+            tSummaryDetailsWrite += out.tSummaryDetailsWrite;
+        }
 
         // Close output files
         summaryOut.close();
@@ -2200,37 +2109,49 @@ next_slice:; // Label for jumping to next slice on error
         // overall end
         double overallMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - overall_start).count();
 
-        appLog += "✅ Simulation completed!\n";
-        appLog += "Processed " + std::to_string(nSlices) + " slices.\n";
-        appLog += "\n=== Performance ===\n";
-        appLog += "Mesh load time:             " + std::to_string(tMeshLoad) + " ms\n";
-        appLog += "Init temp load time:        " + std::to_string(tInitTempLoad) + " ms\n";
-        appLog += "Original solver time:       " + std::to_string(tOrigSolve) + " ms\n";
-        appLog += "TPS optimization time:      " + std::to_string(tOptSuggestion) + " ms\n";
-        appLog += "Optimized solver time:      " + std::to_string(tOptSolve) + " ms\n";
-        appLog += "Total computation time:     " + std::to_string(overallMs) + " ms\n";
-        appLog += "\n=== Output Files ===\n";
-        appLog += "- final_temperature_slice_*.csv: Temperature distribution for each slice\n";
-        appLog += "- " + std::string(outputFile) + ": Summary results\n";
-        appLog += "- stack_details.csv: Detailed layer information\n";
-        appLog += "- time_history_orig_slice_*.csv: Original time histories\n";
-        appLog += "- time_history_opt_slice_*.csv: Optimized time histories\n";
-        
-        simulationCompleted = true; // Mark as completed
-        triggerSimulation = false;  // Reset trigger
-
+        job.log("✅ Simulation completed!\n");
+        job.log("Processed " + std::to_string(params.nSlices) + " slices.\n");
+        job.log("\n=== Performance ===\n");
+        job.log("Mesh load time:             " + std::to_string(tMeshLoad) + " ms\n");
+        job.log("Init temp load time:        " + std::to_string(tInitTempLoad) + " ms\n");
+        job.log("Original solver time:       " + std::to_string(tOrigSolve) + " ms\n");
+        job.log("TPS optimization time:      " + std::to_string(tOptSuggestion) + " ms\n");
+        job.log("Optimized solver time:      " + std::to_string(tOptSolve) + " ms\n");
+        job.log("Worker threads:             " + std::to_string(scheduler.getNumThreads()) + "\n");
+        if (params.useResultCache) {
+            SimulationCache::Stats cs = resultCache.getStats();
+            job.log("Result cache:               " + std::to_string(cs.hits) + " hits, "
+                    + std::to_string(cs.misses) + " misses ("
+                    + std::to_string(100.0 * cs.hitRate()) + "% hit rate)\n");
+        }
+        job.log("Total computation time:     " + std::to_string(overallMs) + " ms\n");
+        if (params.enableProfiling) {
+            job.log("\n=== Profile ===\n" + Profiler::summary());
+            if (Profiler::writeChromeTrace("heatstack_trace.json")) {
+                job.log("Chrome trace written to heatstack_trace.json (open in ui.perfetto.dev)\n");
+            } else {
+                job.log("⚠️ Warning: Could not write heatstack_trace.json\n");
+            }
+            Profiler::enable(false);
+        }
+        job.log("\n=== Output Files ===\n");
+        job.log("- final_temperature_slice_*.csv: Temperature distribution for each slice\n");
+        job.log("- " + params.outputFile + ": Summary results\n");
+        job.log("- stack_details.csv: Detailed layer information\n");
+        job.log("- time_history_orig_slice_*.csv: Original time histories\n");
+        job.log("- time_history_opt_slice_*.csv: Optimized time histories\n");
+        return true;
+
+    } catch (const JobCancelled&) {
+        throw; // The job records the cancellation
     } catch (const std::exception& e) {
-        appLog += "❌ Exception in runSimulationLogic: ";
-        appLog += e.what();
-        appLog += "\n";
-        currentProcessingStatus.clear();
-        triggerSimulation = false; // Ensure trigger is reset on exception
-        simulationCompleted = false;
+        job.log("❌ Exception in runSimulationLogic: ");
+        job.log(e.what());
+        job.log("\n");
+        return false;
     } catch (...) {
-        appLog += "❌ Unknown exception occurred in runSimulationLogic.\n";
-        currentProcessingStatus.clear();
-        triggerSimulation = false;
-        simulationCompleted = false;
+        job.log("❌ Unknown exception occurred in runSimulationLogic.\n");
+        return false;
     }
 }
 
@@ -2268,6 +2189,42 @@ void renderVisualizationControls() {
     if (ImGui::RadioButton("Line Plot", currentVisMode == LINE_PLOT_VIS)) { // NEW: Line plot mode
         currentVisMode = LINE_PLOT_VIS;
     }
+    ImGui::SameLine();
+    if (ImGui::RadioButton("Playback", currentVisMode == PLAYBACK_VIS)) {
+        currentVisMode = PLAYBACK_VIS;
+    }
+
+    if (currentVisMode == PLAYBACK_VIS) {
+        const char* fields[] = { "Carbon/Glue", "Glue/Steel", "Steel" };
+        ImGui::Combo("Interface", &playbackField, fields, IM_ARRAYSIZE(fields));
+        ImGui::Checkbox("Optimized Runs", &playbackOptimized);
+
+        const PlaybackFrames& frames = currentPlaybackFrames();
+        if (frames.empty()) {
+            ImGui::Text("No temperature histories yet.");
+        } else {
+            float start = static_cast<float>(frames.startTime);
+            float end = static_cast<float>(frames.endTime);
+            if (playbackPlaying) {
+                // Advance so one pass through the run takes playbackLength seconds
+                playbackTime += ImGui::GetIO().DeltaTime * (end - start) / std::max(playbackLength, 0.1f);
+                if (playbackTime > end) {
+                    playbackTime = playbackLoop ? start : end;
+                    playbackPlaying = playbackLoop;
+                }
+            }
+            playbackTime = std::clamp(playbackTime, start, end);
+            if (ImGui::Button(playbackPlaying ? "Pause" : "Play")) {
+                if (!playbackPlaying && playbackTime >= end) playbackTime = start;
+                playbackPlaying = !playbackPlaying;
+            }
+            ImGui::SameLine();
+            ImGui::Checkbox("Loop", &playbackLoop);
+            ImGui::SliderFloat("Time (s)", &playbackTime, start, end, "%.3f");
+            ImGui::InputFloat("Pass Length (s)", &playbackLength, 1.0f, 10.0f, "%.1f");
+            ImGui::Text("%d frames x %d slices", frames.nFrames, frames.nSlices);
+        }
+    }
 
     ImGui::Separator();
     ImGui::Text("Camera:");
@@ -2430,6 +2387,7 @@ void renderVisualization(int vx, int vy, int vw, int vh, bool isHovered) {
     if (!meshLoadedForVis && strlen(meshPath) > 0) {
         try {
             if (meshHandler.loadMesh(meshPath)) {
+                ++meshRevision;
                 meshLoadedForVis = true;
                 autoAdjustCameraOnLoad = true; // Force camera adjustment on new mesh load
                 appLog += "✅ Mesh loaded successfully for visualization.\n";
@@ -2451,6 +2409,8 @@ void renderVisualization(int vx, int vy, int vw, int vh, bool isHovered) {
                 drawMeshWithTemperatures(meshHandler, solver); // Temperature visualization
             } else if (currentVisMode == THICKNESS_VIS) {
                 drawMeshWithThickness(meshHandler, solver); // TPU thickness visualization
+            } else if (currentVisMode == PLAYBACK_VIS) {
+                drawMeshPlayback(meshHandler); // Temperatures over time
             } else {
                 drawMeshDefault(meshHandler); // Default material
             }
@@ -2470,7 +2430,8 @@ void renderVisualization(int vx, int vy, int vw, int vh, bool isHovered) {
         int scaleHeight = 300;
         int scaleX = vx + vw - scaleWidth - 10; // Position near the right edge
         int scaleY = vy + 10; // Position near the top
-        drawColorScale(scaleX, scaleY, scaleWidth, scaleHeight, currentVisMode == TEMPERATURE_VIS);
+        drawColorScale(scaleX, scaleY, scaleWidth, scaleHeight,
+                       currentVisMode == TEMPERATURE_VIS || currentVisMode == PLAYBACK_VIS);
     }
     
     // Draw temperature line plot if that mode is selected
@@ -2510,34 +2471,19 @@ int main(int argc, char** argv) {
     ImGui_ImplGlfw_InitForOpenGL(window, true);
     ImGui_ImplOpenGL3_Init("#version 130");
 
-    // --- Simulation Thread ---
-    std::future<void> simulationFuture;
-    bool isSimThreadRunning = false;
-
     // --- Main Loop ---
     while (!glfwWindowShouldClose(window)) {
         glfwPollEvents();
 
-        // Handle simulation triggering and thread management
-        if (triggerSimulation && !isSimThreadRunning) {
-            // Start simulation in a separate thread using std::async
-            simulationFuture = std::async(std::launch::async, runSimulationLogic);
-            isSimThreadRunning = true;
+        // Start a run on its own thread; a running one is cancelled, not awaited
+        if (triggerSimulation) {
             triggerSimulation = false; // Consume the trigger
+            SimulationParams params = captureSimulationParams();
+            simulationJob = SimulationJob::start(
+                [params](SimulationJob& job) { return runSimulationLogic(params, job); },
+                simulationJob);
         }
-
-        // Check if simulation thread finished
-        if (isSimThreadRunning) {
-            // Non-blocking check if thread is finished using future_status
-            auto status = simulationFuture.wait_for(std::chrono::seconds(0));
-            if (status == std::future_status::ready) {
-                isSimThreadRunning = false;
-                // SimulationCompleted flag should be set by runSimulationLogic
-                if (!simulationCompleted) { // If logic finished but didn't set completed (e.g., due to error)
-                    currentProcessingStatus = "Simulation finished with errors or was stopped.";
-                }
-            }
-        }
+        pollSimulationJob();
 
         // Start the Dear ImGui frame
         ImGui_ImplOpenGL3_NewFrame();
@@ -2590,6 +2536,9 @@ int main(int argc, char** argv) {
     }
 
     // --- Cleanup ---
+    if (simulationJob) simulationJob->cancel();
+    simulationJob.reset(); // Joins; the run stops at its next solver step
+    meshRenderer.release(); // needs the GL context, so before teardown
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
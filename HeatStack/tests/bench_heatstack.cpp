@@ -0,0 +1,312 @@
+// HeatStackBench: micro and macro benchmarks for the solver pipeline.
+// Not registered with ctest; run it by hand (from HeatStack/) and compare
+// the numbers against a previous build to catch regressions.
+//
+//   HeatStackBench [--quick] [--filter <name>] [--mesh <file>] [--threads <n>]
+#include "../include/BTCSMatrixSolver.h"
+#include "../include/CoupledSliceSolver.h"
+#include "../include/HeatEquationSolver.h"
+#include "../include/TemperatureComparator.h"
+#include "../include/MaterialProperties.h"
+#include "../include/MeshHandler.h"
+#include "../include/SliceScheduler.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+// ---- Allocation counting ----
+// Every global operator new goes through here, so a benchmark can report how
+// many heap allocations one step costs.
+static std::atomic<unsigned long long> g_allocations(0);
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (size == 0) size = 1;
+    if (void* p = std::malloc(size)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) { return operator new(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+using Clock = std::chrono::steady_clock;
+
+// Keep the optimizer from discarding benchmark results
+static volatile double g_sink = 0.0;
+
+struct BenchResult {
+    std::string name;
+    long long iterations;
+    double totalNs;
+    unsigned long long allocations;
+};
+
+// Run body() with the iteration count doubled until at least minMs elapses;
+// body(n) runs n iterations and is timed as a whole.
+static BenchResult measure(const std::string& name, double minMs,
+                           const std::function<void(long long)>& body) {
+    body(1); // warm-up
+    long long n = 1;
+    for (;;) {
+        unsigned long long alloc0 = g_allocations.load();
+        auto start = Clock::now();
+        body(n);
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        unsigned long long allocs = g_allocations.load() - alloc0;
+        if (ns >= minMs * 1e6 || n >= (1LL << 40)) return { name, n, ns, allocs };
+        n *= 2;
+    }
+}
+
+static void report(const BenchResult& r) {
+    double nsPerIter = r.totalNs / r.iterations;
+    std::printf("%-40s %12lld %14.1f %14.1f %12.2f\n",
+                r.name.c_str(), r.iterations, nsPerIter,
+                1e9 / nsPerIter, double(r.allocations) / r.iterations);
+}
+
+// Default four-layer stack at l/L with the given points per layer
+static Stack makeStack(MaterialProperties& props, double lL, int pointsPerLayer) {
+    Stack s;
+    s.id = 1;
+    s.layers = {
+        {{"TPS",         0.2,  160.0, 1200.0,   0.0, 1200.0}, props.getTPSThickness(lL),          pointsPerLayer},
+        {{"CarbonFiber", 500.0,1600.0, 700.0,   0.0,  350.0}, props.getCarbonFiberThickness(lL),  pointsPerLayer},
+        {{"Glue",        200.0,1300.0, 900.0,   0.0,  400.0}, props.getGlueThickness(lL),         pointsPerLayer},
+        {{"Steel",       100.0,7850.0, 500.0, 800.0,    0.0}, props.getSteelThickness(lL),        pointsPerLayer}
+    };
+    props.generateGrid(s, pointsPerLayer);
+    return s;
+}
+
+static void setupSolver(HeatEquationSolver& solver, const Stack& s, const TimeHandler& th,
+                        const MaterialProperties& props, double lL) {
+    solver.initialize(s, th);
+    solver.setInitialTemperature(std::vector<double>(s.xGrid.size(), 300.0));
+    solver.setBoundaryConditions(
+        new DirichletCondition(static_cast<float>(props.getExhaustTemp(lL))),
+        new NeumannCondition(0.0f));
+}
+
+// Diagonally dominant test system of the given size
+static void fillSystem(BTCSMatrixSolver& solver, int n) {
+    solver.setupMatrix(n);
+    for (int i = 0; i < n; ++i) {
+        solver.b_[i] = 2.5 + 0.001 * i;
+        if (i < n - 1) {
+            solver.a_[i] = -1.0;
+            solver.c_[i] = -1.0;
+        }
+    }
+}
+
+// ---- Micro benchmarks ----
+
+static void benchMatrixSolve(double minMs, std::vector<BenchResult>& out) {
+    for (int n : { 40, 160, 1000, 10000 }) {
+        BTCSMatrixSolver solver;
+        fillSystem(solver, n);
+        std::vector<double> b(n, 1.0);
+
+        out.push_back(measure("BTCSMatrixSolver::solve n=" + std::to_string(n), minMs,
+            [&](long long iters) {
+                for (long long k = 0; k < iters; ++k) {
+                    std::vector<double> x = solver.solve(b);
+                    g_sink = g_sink + x[n / 2];
+                }
+            }));
+
+        solver.factorize();
+        std::vector<double> rhs(n, 1.0);
+        out.push_back(measure("BTCSMatrixSolver::solveFactored n=" + std::to_string(n), minMs,
+            [&](long long iters) {
+                for (long long k = 0; k < iters; ++k) {
+                    std::fill(rhs.begin(), rhs.end(), 1.0);
+                    solver.solveFactored(rhs);
+                }
+                g_sink = g_sink + rhs[n / 2];
+            }));
+    }
+}
+
+static void benchSolverStep(double minMs, std::vector<BenchResult>& out) {
+    MaterialProperties props;
+    const double lL = 0.5;
+    for (int points : { 10, 50 }) {
+        Stack s = makeStack(props, lL, points);
+        for (bool adaptive : { false, true }) {
+            std::string name = std::string("HeatEquationSolver::step ")
+                             + (adaptive ? "adaptive" : "fixed") + " p=" + std::to_string(points);
+            out.push_back(measure(name, minMs, [&](long long iters) {
+                // A very long run so the solver never finishes inside the loop
+                TimeHandler th(1e12, 0.5, adaptive);
+                HeatEquationSolver solver(1.0);
+                setupSolver(solver, s, th, props, lL);
+                for (long long k = 0; k < iters; ++k) solver.step();
+                g_sink = g_sink + solver.getTemperatureDistribution().back();
+            }));
+        }
+    }
+}
+
+static void benchSuggestThickness(double minMs, bool quick, std::vector<BenchResult>& out) {
+    MaterialProperties props;
+    const double lL = 0.5;
+    Stack s = makeStack(props, lL, 10);
+    double duration = quick ? 30.0 : 300.0;
+
+    for (int ways : { 2, 4 }) {
+        std::string name = "suggestTPSThickness ways=" + std::to_string(ways)
+                         + " t=" + std::to_string(int(duration));
+        out.push_back(measure(name, minMs, [&](long long iters) {
+            for (long long k = 0; k < iters; ++k) {
+                TemperatureComparator comp;
+                comp.setTimeStep(0.5, false);
+                comp.setGridResolution(10);
+                comp.setSearchWays(ways);
+                g_sink = g_sink + comp.suggestTPSThickness(s, 800.0, 400.0, 350.0,
+                                                           duration, lL, props, 1.0);
+            }
+        }));
+    }
+
+    std::string name = "suggestTPSThickness newton t=" + std::to_string(int(duration));
+    out.push_back(measure(name, minMs, [&](long long iters) {
+        for (long long k = 0; k < iters; ++k) {
+            TemperatureComparator comp;
+            comp.setTimeStep(0.5, false);
+            comp.setGridResolution(10);
+            comp.setSearchMethod(SearchMethod::Newton);
+            g_sink = g_sink + comp.suggestTPSThickness(s, 800.0, 400.0, 350.0,
+                                                       duration, lL, props, 1.0);
+        }
+    }));
+}
+
+static void benchCoupledStep(double minMs, int nThreads, bool quick, std::vector<BenchResult>& out) {
+    MaterialProperties props;
+    for (int nSlices : { 100, quick ? 500 : 2000 }) {
+        for (int points : { 10, 50 }) {
+            std::vector<Stack> stacks;
+            std::vector<double> surface;
+            for (int s = 0; s < nSlices; ++s) {
+                double lL = double(s) / (nSlices - 1);
+                stacks.push_back(makeStack(props, lL, points));
+                surface.push_back(props.getExhaustTemp(lL));
+            }
+            CoupledSliceSolver solver(nThreads);
+            solver.initialize(stacks, 1.0 / (nSlices - 1), TimeHandler(1e12, 0.5, false));
+            solver.setInitialTemperature(std::vector<double>(stacks[0].xGrid.size(), 300.0));
+            solver.setSurfaceTemperatures(surface);
+
+            std::string name = "CoupledSliceSolver::step s=" + std::to_string(nSlices)
+                             + " n=" + std::to_string(solver.getNumNodes())
+                             + " t=" + std::to_string(solver.getNumThreads());
+            out.push_back(measure(name, minMs, [&](long long iters) {
+                for (long long k = 0; k < iters; ++k) solver.step();
+                g_sink = g_sink + solver.getTemperature(nSlices / 2, solver.getNumNodes() - 1);
+            }));
+        }
+    }
+}
+
+// ---- Macro benchmark: the CLI slice pipeline without file output ----
+
+static void benchPipeline(const std::string& meshFile, int nThreads, bool quick,
+                          std::vector<BenchResult>& out) {
+    MeshHandler mesh;
+    if (!mesh.loadMesh(meshFile)) {
+        std::cerr << "Skipping pipeline benchmark: cannot load " << meshFile << "\n";
+        return;
+    }
+    double zmin = mesh.getMinZ(), height = mesh.getMaxZ() - zmin;
+    const int nSlices = quick ? 4 : 12;
+    const double tFinal = quick ? 30.0 : 300.0;
+    const double dt = 0.5;
+    MaterialProperties matProps;
+
+    std::vector<long long> steps(nSlices, 0);
+    auto runSlice = [&](int slice) {
+        MaterialProperties sliceProps;
+        double z = zmin + (double(slice) / (nSlices - 1)) * height;
+        double lL = (z - zmin) / height;
+        Stack s = makeStack(sliceProps, lL, 10);
+
+        TimeHandler th(tFinal, dt, false);
+        HeatEquationSolver solver(1.0);
+        setupSolver(solver, s, th, matProps, lL);
+        while (!solver.isFinished()) { solver.step(); ++steps[slice]; }
+
+        TemperatureComparator comp;
+        comp.setTimeStep(dt, false);
+        comp.setGridResolution(10);
+        double tpsOpt = comp.suggestTPSThickness(s, 800.0, 400.0, 350.0, tFinal, lL, matProps, 1.0);
+
+        s.layers[0].thickness = tpsOpt;
+        sliceProps.generateGrid(s, 10);
+        TimeHandler th2(tFinal, dt, false);
+        HeatEquationSolver solverOpt(1.0);
+        setupSolver(solverOpt, s, th2, matProps, lL);
+        while (!solverOpt.isFinished()) { solverOpt.step(); ++steps[slice]; }
+        g_sink = g_sink + solverOpt.getTemperatureDistribution().back();
+    };
+
+    SliceScheduler scheduler(nThreads);
+    unsigned long long alloc0 = g_allocations.load();
+    auto start = Clock::now();
+    scheduler.run(nSlices, runSlice);
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    unsigned long long allocs = g_allocations.load() - alloc0;
+
+    // Reported per solver step of the two reported runs; the search's own
+    // trial runs are included in the time but not in the step count.
+    long long totalSteps = 0;
+    for (long long n : steps) totalSteps += n;
+    std::string name = "pipeline slices=" + std::to_string(nSlices)
+                     + " threads=" + std::to_string(scheduler.getNumThreads());
+    out.push_back({ name, totalSteps, ns, allocs });
+    std::printf("# pipeline wall time: %.1f ms\n", ns / 1e6);
+}
+
+int main(int argc, char* argv[]) {
+    bool quick = false;
+    std::string filter;
+    std::string meshFile = "tests/humanoid_robot.obj";
+    int nThreads = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--quick") == 0) quick = true;
+        else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) filter = argv[++i];
+        else if (std::strcmp(argv[i], "--mesh") == 0 && i + 1 < argc) meshFile = argv[++i];
+        else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) nThreads = std::atoi(argv[++i]);
+        else {
+            std::cerr << "Usage: HeatStackBench [--quick] [--filter <name>] [--mesh <file>] [--threads <n>]\n";
+            return 1;
+        }
+    }
+    double minMs = quick ? 20.0 : 200.0;
+    auto selected = [&](const char* group) {
+        return filter.empty() || std::string(group).find(filter) != std::string::npos;
+    };
+
+    std::vector<BenchResult> results;
+    if (selected("solve"))    benchMatrixSolve(minMs, results);
+    if (selected("step"))     benchSolverStep(minMs, results);
+    if (selected("suggest"))  benchSuggestThickness(minMs, quick, results);
+    if (selected("coupled"))  benchCoupledStep(minMs, nThreads, quick, results);
+    if (selected("pipeline")) benchPipeline(meshFile, nThreads, quick, results);
+
+    std::printf("%-40s %12s %14s %14s %12s\n",
+                "benchmark", "iterations", "ns/iter", "iter/s", "allocs/iter");
+    for (const auto& r : results) report(r);
+    return 0;
+}
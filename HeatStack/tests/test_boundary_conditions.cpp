@@ -1,6 +1,10 @@
 #include "../include/BoundaryConditions.h"
 #include <iostream>
 #include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
 
 void testDirichlet() {
     DirichletCondition dirichlet(100.0f);
@@ -18,9 +22,57 @@ void testNeumann() {
     std::cout << "Neumann test passed.\n";
 }
 
+void testBatchedEvaluate() {
+    // Default: one getValue per point
+    DirichletCondition dirichlet(100.0f);
+    std::vector<float> out;
+    dirichlet.evaluate(5.0, { {0, 0, 0}, {0, 0, 1} }, out);
+    assert(out.size() == 2 && out[0] == 100.0f && out[1] == 100.0f);
+    assert(!dirichlet.isTimeDependent());
+
+    // Two times, T = 300 + 100 * l/L at t = 0 and 500 + 200 * l/L at t = 10
+    BoundaryProfile profile({ 0.0, 10.0 }, { 0.0, 0.5, 1.0 },
+                            { 300.0, 350.0, 400.0, 500.0, 600.0, 700.0 }, 65);
+    assert(profile.isTimeDependent());
+    assert(std::fabs(profile.valueAt(0.0, 0.25) - 325.0) < 1e-9);
+    assert(std::fabs(profile.valueAt(5.0, 0.5) - 475.0) < 1e-9 && "Rows blend linearly in time");
+    assert(profile.valueAt(-1.0, 1.0) == 400.0 && profile.valueAt(20.0, 2.0) == 700.0 && "Edges hold");
+
+    // Surface from z = 2 to 6 m
+    TabulatedCondition tabulated(&profile, 2.0f, 4.0f);
+    assert(tabulated.getType() == BoundaryType::Dirichlet && tabulated.isTimeDependent());
+    tabulated.evaluate(10.0, { {0, 0, 2}, {0, 0, 4}, {0, 0, 5} }, out);
+    assert(out.size() == 3 && out[0] == 500.0f && out[1] == 600.0f && out[2] == 650.0f);
+    assert(tabulated.getValue({0, 0, 6}) == 400.0f);
+
+    // Steady law, resampled on the table's own nodes
+    BoundaryProfile law = BoundaryProfile::fromFunction([](double l) { return 900.0 - 100.0 * l; }, 11);
+    assert(!law.isTimeDependent() && std::fabs(law.valueAt(123.0, 0.3) - 870.0) < 1e-9);
+    std::cout << "Batched evaluate test passed.\n";
+}
+
+void testProfileCsv() {
+    const std::string path = "test_surface_profile.csv";
+    {
+        std::ofstream out(path);
+        out << "time,0,1\n0,300,400\n10,500,700\n";
+    }
+    BoundaryProfile profile = BoundaryProfile::loadCsv(path);
+    assert(std::fabs(profile.valueAt(5.0, 0.5) - 475.0) < 1e-9);
+
+    { std::ofstream out(path); out << "time,0,1\n0,300\n"; }
+    bool threw = false;
+    try { BoundaryProfile::loadCsv(path); } catch (const std::runtime_error&) { threw = true; }
+    assert(threw && "Short rows must be rejected");
+    std::remove(path.c_str());
+    std::cout << "Profile CSV test passed.\n";
+}
+
 int main() {
     testDirichlet();
     testNeumann();
+    testBatchedEvaluate();
+    testProfileCsv();
     std::cout << "All boundary condition tests passed.\n";
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,47 @@
+#include "../include/Checkpoint.h"
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+void testSaveLoadRoundTrip() {
+    const std::string path = "test_checkpoint.ckpt";
+    SliceCheckpoint c;
+    c.stage = SliceCheckpoint::Stage::Search;
+    c.solverState = std::string("state\0with\0nulls", 16);
+    c.historyBytes = 12345;
+    c.origCarbonGlue = 351.5;
+    c.origGlueSteel = 402.25;
+    c.origSteel = 799.0;
+    c.search.rounds = 7;
+    c.search.minThickness = 0.01;
+    c.search.maxThickness = 0.02;
+    c.search.thickness = 0.015;
+    c.search.lastStep = 0.3;
+    c.tpsOpt = 0.0;
+    c.fromSurrogate = true;
+    assert(c.save(path, "run-a"));
+
+    SliceCheckpoint loaded;
+    assert(loaded.load(path, "run-a"));
+    assert(loaded.stage == c.stage && loaded.solverState == c.solverState);
+    assert(loaded.historyBytes == c.historyBytes && loaded.origGlueSteel == c.origGlueSteel);
+    assert(loaded.search.rounds == 7 && loaded.search.thickness == 0.015 && loaded.fromSurrogate);
+
+    // Another run's checkpoint and a truncated file leave the target as it was
+    SliceCheckpoint other;
+    assert(!other.load(path, "run-b") && other.stage == SliceCheckpoint::Stage::OriginalSolve);
+    { std::ofstream out(path, std::ios::binary | std::ios::trunc); out << "HSCK"; }
+    assert(!loaded.load(path, "run-a") && loaded.search.rounds == 7);
+    assert(!loaded.load("missing.ckpt", "run-a"));
+    std::remove(path.c_str());
+
+    assert(SliceCheckpoint::path("ck", 0).find("slice_1.ckpt") != std::string::npos);
+    std::cout << "Slice checkpoint test passed.\n";
+}
+
+int main() {
+    testSaveLoadRoundTrip();
+    std::cout << "All checkpoint tests passed.\n";
+    return 0;
+}
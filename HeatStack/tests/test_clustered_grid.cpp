@@ -0,0 +1,113 @@
+#include "../include/MaterialProperties.h"
+#include "../include/HeatEquationSolver.h"
+#include "../include/BoundaryConditions.h"
+#include "../include/SimulationCache.h"
+#include <cassert>
+#include <iostream>
+#include <cmath>
+#include <stdexcept>
+
+static Stack makeStack(const MaterialProperties& props, double lL) {
+    Stack s;
+    s.id = 1;
+    s.layers = {
+        {{"TPS",         0.2,  160.0, 1200.0,   0.0, 1200.0}, 0.01,                              10},
+        {{"CarbonFiber", 500.0,1600.0, 700.0,   0.0,  350.0}, props.getCarbonFiberThickness(lL), 10},
+        {{"Glue",        200.0,1300.0, 900.0,   0.0,  400.0}, props.getGlueThickness(lL),        10},
+        {{"Steel",       100.0,7850.0, 500.0, 800.0,    0.0}, props.getSteelThickness(lL),       10}
+    };
+    return s;
+}
+
+static double steelTemperature(const Stack& s) {
+    HeatEquationSolver solver(1.0);
+    solver.initialize(s, TimeHandler(300.0, 0.5, false));
+    solver.setInitialTemperature(std::vector<double>(s.xGrid.size(), 300.0));
+    solver.setBoundaryConditions(new DirichletCondition(900.0), new NeumannCondition(0.0));
+    while (!solver.isFinished()) solver.step();
+    return solver.getTemperatureDistribution().back();
+}
+
+void testClusteredLayout() {
+    MaterialProperties props;
+    GridOptions options;
+    options.spacing = GridSpacing::Clustered;
+    props.setGridOptions(options);
+    Stack s = makeStack(props, 0.5);
+    props.generateGrid(s, 10);
+    assert(s.spacing == GridSpacing::Clustered);
+
+    // Interfaces are nodes at the exact layer sums, nodes are strictly increasing
+    size_t node = 0;
+    double x = 0.0;
+    for (const auto& layer : s.layers) {
+        assert(layer.numPoints >= options.minPointsPerLayer && layer.numPoints <= options.maxPointsPerLayer);
+        node += layer.numPoints - 1;
+        x += layer.thickness;
+        assert(s.xGrid[node] == x);
+    }
+    assert(node + 1 == s.xGrid.size() && s.totalThickness == x);
+    for (size_t i = 1; i < s.xGrid.size(); ++i) assert(s.xGrid[i] > s.xGrid[i - 1]);
+
+    // TPS cells are finest at both faces and grow by at most the stretch ratio
+    int n = s.layers[0].numPoints;
+    for (int i = 1; i + 1 < n; ++i) {
+        double left = s.xGrid[i] - s.xGrid[i - 1], right = s.xGrid[i + 1] - s.xGrid[i];
+        double ratio = std::max(left, right) / std::min(left, right);
+        assert(ratio <= options.stretchRatio * (1 + 1e-9));
+    }
+    assert(s.xGrid[1] - s.xGrid[0] < s.xGrid[n / 2] - s.xGrid[n / 2 - 1]);
+
+    // Uniform spacing is still the default
+    MaterialProperties uniform;
+    Stack u = makeStack(uniform, 0.5);
+    uniform.generateGrid(u, 10);
+    assert(u.spacing == GridSpacing::Uniform && u.xGrid.size() == 37);
+
+    bool threw = false;
+    try {
+        options.targetFourier = 0.0;
+        props.setGridOptions(options);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw && "Invalid grid options must be rejected");
+    std::cout << "Clustered grid layout test passed.\n";
+}
+
+void testClusteredGridConverges() {
+    // Against a fine grid in the same (flux) form, the clustered grid is as
+    // accurate as far more uniformly spaced nodes
+    MaterialProperties props;
+    Stack fine = makeStack(props, 0.5);
+    props.generateGrid(fine, 400);
+    fine.spacing = GridSpacing::Clustered; // flux form on the fine uniform grid
+    double reference = steelTemperature(fine);
+
+    GridOptions options;
+    options.spacing = GridSpacing::Clustered;
+    props.setGridOptions(options);
+    Stack clustered = makeStack(props, 0.5);
+    props.generateGrid(clustered, 10);
+    assert(clustered.xGrid.size() < 25);
+    assert(std::fabs(steelTemperature(clustered) - reference) < 0.05);
+    std::cout << "Clustered grid accuracy test passed.\n";
+}
+
+void testCacheKeysSeparateGrids() {
+    MaterialProperties props;
+    Stack s = makeStack(props, 0.5);
+    GridOptions clustered;
+    clustered.spacing = GridSpacing::Clustered;
+    std::string uniformKey = SimulationCache::makeKey(s, 10, 0.5, false, 1.0, 300.0, 900.0);
+    assert(uniformKey == SimulationCache::makeKey(s, 10, 0.5, false, 1.0, 300.0, 900.0, false, GridOptions()));
+    assert(uniformKey != SimulationCache::makeKey(s, 10, 0.5, false, 1.0, 300.0, 900.0, false, clustered));
+    std::cout << "Clustered grid cache key test passed.\n";
+}
+
+int main() {
+    testClusteredLayout();
+    testClusteredGridConverges();
+    testCacheKeysSeparateGrids();
+    return 0;
+}
@@ -0,0 +1,188 @@
+#include "../include/CoupledSliceSolver.h"
+#include "../include/HeatEquationSolver.h"
+#include "../include/MaterialProperties.h"
+#include "../include/BoundaryConditions.h"
+#include <cassert>
+#include <iostream>
+#include <cmath>
+
+static Stack makeStack(MaterialProperties& props, double lL, int pointsPerLayer) {
+    Stack s;
+    s.id = 1;
+    s.layers = {
+        {{"TPS",         0.2,  160.0, 1200.0,   0.0, 1200.0}, props.getTPSThickness(lL),          pointsPerLayer},
+        {{"CarbonFiber", 500.0,1600.0, 700.0,   0.0,  350.0}, props.getCarbonFiberThickness(lL),  pointsPerLayer},
+        {{"Glue",        200.0,1300.0, 900.0,   0.0,  400.0}, props.getGlueThickness(lL),         pointsPerLayer},
+        {{"Steel",       100.0,7850.0, 500.0, 800.0,    0.0}, props.getSteelThickness(lL),        pointsPerLayer}
+    };
+    props.generateGrid(s, pointsPerLayer);
+    return s;
+}
+
+void testUniformSlicesMatchCrankNicolson() {
+    // Identical slices have no lateral gradient, so every slice follows the 1-D solver
+    MaterialProperties props;
+    Stack stack = makeStack(props, 0.3, 10);
+    std::vector<double> init(stack.xGrid.size(), 300.0);
+    init[0] = 900.0; // start on the surface value so both schemes see the same BC history
+
+    TimeHandler th(60.0, 0.5, false);
+    HeatEquationSolver single(0.5);
+    single.initialize(stack, th);
+    single.setInitialTemperature(init);
+    single.setBoundaryConditions(new DirichletCondition(900.0f), new NeumannCondition(0.0f));
+    while (!single.isFinished()) single.step();
+
+    const int nSlices = 5;
+    CoupledSliceSolver coupled(2);
+    coupled.initialize(std::vector<Stack>(nSlices, stack), 0.01, th);
+    coupled.setInitialTemperature(init);
+    coupled.setSurfaceTemperatures(std::vector<double>(nSlices, 900.0));
+    while (!coupled.isFinished()) coupled.step();
+
+    const auto& expected = single.getTemperatureDistribution();
+    for (int s = 0; s < nSlices; ++s) {
+        std::vector<double> T = coupled.getTemperatureDistribution(s);
+        for (size_t i = 0; i < T.size(); ++i) {
+            assert(std::fabs(T[i] - expected[i]) < 1e-8 * expected[i] && "Uniform slices must match Crank-Nicolson");
+        }
+    }
+    std::cout << "Uniform coupled slices test passed.\n";
+}
+
+void testLateralConduction() {
+    // One hot slice in the middle: neighbours warm up, symmetrically, more
+    // than without coupling, and the far ends stay close to the cold value
+    MaterialProperties props;
+    Stack stack = makeStack(props, 0.5, 10);
+    const int nSlices = 9;
+    const int n = static_cast<int>(stack.xGrid.size());
+    std::vector<double> surface(nSlices, 400.0);
+    surface[nSlices / 2] = 1200.0;
+
+    TimeHandler th(120.0, 0.5, false);
+    CoupledSliceSolver coupled(1);
+    coupled.initialize(std::vector<Stack>(nSlices, stack), 0.002, th);
+    coupled.setInitialTemperature(std::vector<double>(n, 300.0));
+    coupled.setSurfaceTemperatures(surface);
+    while (!coupled.isFinished()) coupled.step();
+
+    TimeHandler thCold(120.0, 0.5, false);
+    HeatEquationSolver cold(0.5);
+    cold.initialize(stack, thCold);
+    cold.setInitialTemperature(std::vector<double>(n, 300.0));
+    cold.setBoundaryConditions(new DirichletCondition(400.0f), new NeumannCondition(0.0f));
+    while (!cold.isFinished()) cold.step();
+    double uncoupled = cold.getTemperatureDistribution().back();
+
+    int mid = nSlices / 2;
+    double hot = coupled.getTemperature(mid, n - 1);
+    double near = coupled.getTemperature(mid + 1, n - 1);
+    double far = coupled.getTemperature(nSlices - 1, n - 1);
+    assert(std::fabs(coupled.getTemperature(mid - 1, n - 1) - near) < 1e-9 * near && "Lateral field must be symmetric");
+    assert(hot > near && near > far && "Temperature must fall off away from the hot slice");
+    assert(near > uncoupled + 1e-3 && "Neighbours of the hot slice must gain heat laterally");
+    assert(far >= uncoupled - 1e-9);
+    assert(coupled.getTemperature(mid, 0) == 1200.0 && coupled.getTemperature(0, 0) == 400.0);
+    std::cout << "Lateral conduction test passed.\n";
+}
+
+void testThreadCountDoesNotChangeResult() {
+    // Large enough to split into blocks; line solves are independent, so
+    // the field is bit-identical for any thread count
+    MaterialProperties props;
+    const int nSlices = 400;
+    std::vector<Stack> stacks;
+    std::vector<double> surface;
+    for (int s = 0; s < nSlices; ++s) {
+        double lL = double(s) / (nSlices - 1);
+        stacks.push_back(makeStack(props, lL, 20));
+        surface.push_back(props.getExhaustTemp(lL));
+    }
+    const int n = static_cast<int>(stacks[0].xGrid.size());
+
+    std::vector<std::vector<double>> results;
+    for (int threads : { 1, 4 }) {
+        TimeHandler th(5.0, 0.5, false);
+        CoupledSliceSolver solver(threads);
+        solver.initialize(stacks, 0.005, th);
+        solver.setInitialTemperature(std::vector<double>(n, 300.0));
+        solver.setSurfaceTemperatures(surface);
+        while (!solver.isFinished()) solver.step();
+        if (threads > 1) assert(solver.getNumThreads() > 1);
+        std::vector<double> all;
+        for (int s = 0; s < nSlices; ++s) {
+            std::vector<double> T = solver.getTemperatureDistribution(s);
+            all.insert(all.end(), T.begin(), T.end());
+        }
+        results.push_back(all);
+    }
+    assert(results[0] == results[1] && "Threaded sweeps must match the serial result");
+    std::cout << "Coupled solver thread invariance test passed.\n";
+}
+
+void testRejectsMismatchedGrids() {
+    MaterialProperties props;
+    std::vector<Stack> stacks = { makeStack(props, 0.1, 10), makeStack(props, 0.2, 12) };
+    CoupledSliceSolver solver(1);
+    bool threw = false;
+    try {
+        solver.initialize(stacks, 0.01, TimeHandler(1.0, 0.5, false));
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw && "Grids of different sizes cannot be coupled");
+    std::cout << "Mismatched grid test passed.\n";
+}
+
+void testSurfaceCondition() {
+    MaterialProperties props;
+    Stack stack = makeStack(props, 0.3, 10);
+    const int nSlices = 4;
+    std::vector<std::array<float, 3>> positions;
+    for (int s = 0; s < nSlices; ++s) positions.push_back({ 0.0f, 0.0f, s / float(nSlices - 1) });
+
+    // Time-independent condition: same as the fixed temperatures
+    BoundaryProfile steady({ 0.0 }, { 0.0, 1.0 }, { 900.0, 800.0 }, 4);
+    TabulatedCondition steadyBC(&steady);
+    std::vector<float> values;
+    steadyBC.evaluate(0.0, positions, values);
+    std::vector<double> surface(values.begin(), values.end());
+    TimeHandler th(20.0, 0.5, false);
+    CoupledSliceSolver fixed(1), tabulated(1);
+    for (CoupledSliceSolver* solver : { &fixed, &tabulated }) {
+        solver->initialize(std::vector<Stack>(nSlices, stack), 0.01, th);
+        solver->setInitialTemperature(std::vector<double>(stack.xGrid.size(), 300.0));
+    }
+    fixed.setSurfaceTemperatures(surface);
+    tabulated.setSurfaceCondition(&steadyBC, positions);
+    while (!fixed.isFinished()) { fixed.step(); tabulated.step(); }
+    for (int s = 0; s < nSlices; ++s) {
+        assert(fixed.getTemperatureDistribution(s) == tabulated.getTemperatureDistribution(s));
+    }
+
+    // Ramp: the surface row follows the profile at each step's end
+    BoundaryProfile ramp({ 0.0, 20.0 }, { 0.0, 1.0 }, { 300.0, 300.0, 1000.0, 600.0 });
+    TabulatedCondition rampBC(&ramp);
+    CoupledSliceSolver coupled(2);
+    coupled.initialize(std::vector<Stack>(nSlices, stack), 0.01, th);
+    coupled.setInitialTemperature(std::vector<double>(stack.xGrid.size(), 300.0));
+    coupled.setSurfaceCondition(&rampBC, positions);
+    while (!coupled.isFinished()) {
+        coupled.step();
+        for (int s = 0; s < nSlices; ++s) {
+            double expected = static_cast<float>(ramp.valueAt(coupled.getCurrentTime(), positions[s][2]));
+            assert(coupled.getTemperature(s, 0) == expected);
+        }
+    }
+    std::cout << "Coupled surface condition test passed.\n";
+}
+
+int main() {
+    testUniformSlicesMatchCrankNicolson();
+    testLateralConduction();
+    testThreadCountDoesNotChangeResult();
+    testRejectsMismatchedGrids();
+    testSurfaceCondition();
+    return 0;
+}
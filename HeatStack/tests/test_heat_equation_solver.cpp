@@ -3,6 +3,9 @@
 #include "../include/BoundaryConditions.h"
 #include <cassert>
 #include <iostream>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
 
 void testHeatEquationSolver() {
     MaterialProperties props;
@@ -19,7 +22,243 @@ void testHeatEquationSolver() {
     std::cout << "HeatEquationSolver test passed.\n";
 }
 
+void testAdaptiveErrorEstimateKeepsState() {
+    MaterialProperties props;
+    Stack stack = props.getStack(1);
+    TimeHandler timeHandler(10.0, 0.1, true);
+    HeatEquationSolver solver(0.5); // Crank-Nicolson uses the step-doubling estimate
+    solver.initialize(stack, timeHandler);
+    solver.setInitialTemperature(std::vector<double>(stack.xGrid.size(), 300.0));
+    solver.setBoundaryConditions(new DirichletCondition(1200.0), new NeumannCondition(0.0));
+    solver.step();
+
+    std::vector<double> before = solver.getTemperatureDistribution();
+    solver.adjustTimeStep(1e-3);
+    assert(solver.getTemperatureDistribution() == before && "Error estimate must not modify the solution");
+
+    solver.step();
+    assert(solver.getTemperatureDistribution().size() == stack.xGrid.size());
+    std::cout << "Adaptive error estimate test passed.\n";
+}
+
+void testAdaptiveSteppingAndSteadyState() {
+    MaterialProperties props;
+    Stack stack = props.getStack(1);
+
+    // Adaptive run lands exactly on the end time with far fewer steps than fixed dt
+    TimeHandler adaptiveTime(200.0, 0.01, true);
+    HeatEquationSolver adaptive(0.5);
+    adaptive.initialize(stack, adaptiveTime);
+    adaptive.setInitialTemperature(std::vector<double>(stack.xGrid.size(), 300.0));
+    adaptive.setBoundaryConditions(new DirichletCondition(900.0), new NeumannCondition(0.0));
+    adaptive.setAdaptiveTolerance(1e-2);
+    int steps = 0;
+    while (!adaptive.isFinished()) {
+        adaptive.step();
+        ++steps;
+    }
+    assert(std::fabs(adaptive.getCurrentTime() - 200.0) < 1e-9);
+    assert(steps < 200.0 / 0.01);
+    assert(std::fabs(adaptive.getTemperatureDistribution().back() - 900.0) < 1.0);
+
+    // Thin stack settles quickly: steady-state detection stops well before the end
+    TimeHandler fixedTime(1000.0, 0.5, false);
+    HeatEquationSolver steady(1.0);
+    steady.initialize(stack, fixedTime);
+    steady.setInitialTemperature(std::vector<double>(stack.xGrid.size(), 300.0));
+    steady.setBoundaryConditions(new DirichletCondition(900.0), new NeumannCondition(0.0));
+    steady.setSteadyStateTolerance(1e-3);
+    while (!steady.isFinished()) steady.step();
+    assert(steady.reachedSteadyState());
+    assert(steady.getCurrentTime() < 1000.0);
+    std::cout << "Adaptive stepping and steady-state test passed.\n";
+}
+
+void testFloatSolverTracksDouble() {
+    MaterialProperties props;
+    Stack stack = props.getStack(1);
+    props.generateGrid(stack, 10);
+    std::vector<std::vector<double>> results;
+    for (int pass = 0; pass < 2; ++pass) {
+        TimeHandler timeHandler(120.0, 0.5, false);
+        std::vector<double> init(stack.xGrid.size(), 300.0);
+        if (pass == 0) {
+            HeatEquationSolver solver(0.5);
+            solver.initialize(stack, timeHandler);
+            solver.setInitialTemperature(init);
+            solver.setBoundaryConditions(new DirichletCondition(1200.0), new NeumannCondition(0.0));
+            while (!solver.isFinished()) solver.step();
+            results.push_back(solver.getTemperatureDistribution());
+        } else {
+            BasicHeatEquationSolver<float> solver(0.5);
+            solver.initialize(stack, timeHandler);
+            solver.setInitialTemperature(init);
+            solver.setBoundaryConditions(new DirichletCondition(1200.0), new NeumannCondition(0.0));
+            while (!solver.isFinished()) solver.step();
+            const std::vector<float>& T = solver.getTemperatureDistribution();
+            results.emplace_back(T.begin(), T.end());
+        }
+    }
+    assert(results[0].size() == results[1].size());
+    for (size_t i = 0; i < results[0].size(); ++i) {
+        assert(std::fabs(results[0][i] - results[1][i]) < 0.1 && "Float solver must stay close to double");
+    }
+    std::cout << "Float solver test passed.\n";
+}
+
+void testBoundaryKernels() {
+    // Every scheme/boundary kernel: insulated on both faces a uniform field
+    // stays put, fixed on both faces it stays inside the boundary values
+    MaterialProperties props;
+    Stack stack = props.getStack(1);
+    props.generateGrid(stack, 10);
+    for (double theta : { 1.0, 0.5, 0.7 }) {
+        HeatEquationSolver insulated(theta);
+        insulated.initialize(stack, TimeHandler(20.0, 0.5, false));
+        insulated.setInitialTemperature(std::vector<double>(stack.xGrid.size(), 350.0));
+        insulated.setBoundaryConditions(new NeumannCondition(0.0), new NeumannCondition(0.0));
+        while (!insulated.isFinished()) insulated.step();
+        for (double T : insulated.getTemperatureDistribution()) {
+            assert(std::fabs(T - 350.0) < 1e-9 && "Insulated uniform field must not change");
+        }
+
+        HeatEquationSolver fixed(theta);
+        fixed.initialize(stack, TimeHandler(20.0, 0.5, false));
+        fixed.setInitialTemperature(std::vector<double>(stack.xGrid.size(), 300.0));
+        fixed.setBoundaryConditions(new DirichletCondition(400.0), new DirichletCondition(500.0));
+        while (!fixed.isFinished()) fixed.step();
+        const auto& T = fixed.getTemperatureDistribution();
+        assert(T.front() == 400.0 && T.back() == 500.0);
+        for (double t : T) assert(t >= 300.0 - 1e-9 && t <= 500.0 + 1e-9);
+    }
+    std::cout << "Boundary kernel test passed.\n";
+}
+
+static std::vector<double> runTPS(double tps, double theta, std::vector<double>* sensitivity) {
+    MaterialProperties props;
+    Stack stack = props.getStack(1);
+    stack.layers[0].thickness = tps;
+    props.generateGrid(stack, 10);
+    HeatEquationSolver solver(theta);
+    solver.initialize(stack, TimeHandler(120.0, 0.5, false));
+    solver.setInitialTemperature(std::vector<double>(stack.xGrid.size(), 300.0));
+    solver.setBoundaryConditions(new DirichletCondition(800.0), new NeumannCondition(0.0));
+    if (sensitivity) solver.enableThicknessSensitivity(0);
+    while (!solver.isFinished()) solver.step();
+    if (sensitivity) *sensitivity = solver.getThicknessSensitivity();
+    return solver.getTemperatureDistribution();
+}
+
+void testThicknessSensitivityMatchesFiniteDifference() {
+    // Per node index: the grid stretches with the layer, as the TPS search sees it
+    for (double theta : { 1.0, 0.5 }) {
+        for (double tps : { 0.005, 0.02 }) {
+            std::vector<double> sens;
+            std::vector<double> T = runTPS(tps, theta, &sens);
+            double h = tps * 1e-5;
+            std::vector<double> Tp = runTPS(tps + h, theta, nullptr);
+            std::vector<double> Tm = runTPS(tps - h, theta, nullptr);
+            assert(sens.size() == T.size() && sens.front() == 0.0);
+            for (size_t i = 1; i < T.size(); ++i) {
+                double fd = (Tp[i] - Tm[i]) / (2.0 * h);
+                assert(std::fabs(sens[i] - fd) <= 1e-4 * std::fabs(fd) + 1e-3 && "Tangent must match finite differences");
+            }
+        }
+    }
+    std::cout << "Thickness sensitivity test passed.\n";
+}
+
+void testCheckpointResumesBitIdentical() {
+    MaterialProperties props;
+    Stack stack = props.getStack(1);
+    props.generateGrid(stack, 10);
+    for (bool adaptive : { false, true }) {
+        auto makeSolver = [&](HeatEquationSolver& solver, double total) {
+            solver.initialize(stack, TimeHandler(total, 0.5, adaptive));
+            solver.setInitialTemperature(std::vector<double>(stack.xGrid.size(), 300.0));
+            solver.setBoundaryConditions(new DirichletCondition(1000.0), new NeumannCondition(0.0));
+        };
+        HeatEquationSolver whole(0.5), first(0.5), resumed(0.5), longer(0.5);
+        makeSolver(whole, 60.0);
+        while (!whole.isFinished()) whole.step();
+
+        makeSolver(first, 60.0);
+        while (first.getCurrentTime() < 25.0) first.step();
+        std::stringstream state;
+        first.saveCheckpoint(state);
+
+        makeSolver(resumed, 60.0);
+        resumed.loadCheckpoint(state);
+        assert(resumed.getCurrentTime() == first.getCurrentTime());
+        while (!resumed.isFinished()) resumed.step();
+        assert(resumed.getTemperatureDistribution() == whole.getTemperatureDistribution());
+
+        // Branching: the loaded clock keeps the new run's total time
+        state.clear();
+        state.seekg(0);
+        makeSolver(longer, 90.0);
+        longer.loadCheckpoint(state);
+        while (!longer.isFinished()) longer.step();
+        assert(longer.getCurrentTime() >= 90.0 - 1e-9);
+    }
+
+    // Another grid is refused
+    HeatEquationSolver saved(1.0);
+    saved.initialize(stack, TimeHandler(10.0, 0.5, false));
+    saved.setInitialTemperature(std::vector<double>(stack.xGrid.size(), 300.0));
+    std::stringstream state;
+    saved.saveCheckpoint(state);
+    Stack other = props.getStack(1);
+    props.generateGrid(other, 5);
+    HeatEquationSolver wrong(1.0);
+    wrong.initialize(other, TimeHandler(10.0, 0.5, false));
+    bool threw = false;
+    try { wrong.loadCheckpoint(state); } catch (const std::runtime_error&) { threw = true; }
+    assert(threw && "A checkpoint of another grid must be refused");
+    std::cout << "Solver checkpoint test passed.\n";
+}
+
+void testTimeDependentBoundary() {
+    MaterialProperties props;
+    Stack stack = props.getStack(1);
+    props.generateGrid(stack, 10);
+    // Surface ramps from 300 K to 1000 K over 60 s
+    BoundaryProfile ramp({ 0.0, 60.0 }, { 0.0, 1.0 }, { 300.0, 300.0, 1000.0, 1000.0 });
+    for (bool adaptive : { false, true }) {
+        HeatEquationSolver solver(0.5);
+        solver.initialize(stack, TimeHandler(60.0, 0.5, adaptive));
+        solver.setInitialTemperature(std::vector<double>(stack.xGrid.size(), 300.0));
+        solver.setBoundaryConditions(new TabulatedCondition(&ramp), new NeumannCondition(0.0));
+        while (!solver.isFinished()) {
+            solver.step();
+            double expected = static_cast<float>(ramp.valueAt(solver.getCurrentTime(), 0.0));
+            assert(solver.getTemperatureDistribution()[0] == expected && "Surface follows the profile at the step's end");
+        }
+    }
+
+    // A constant table is the plain Dirichlet condition
+    BoundaryProfile flat({ 0.0 }, { 0.0, 1.0 }, { 900.0, 900.0 });
+    HeatEquationSolver tabulated(1.0), dirichlet(1.0);
+    for (HeatEquationSolver* solver : { &tabulated, &dirichlet }) {
+        solver->initialize(stack, TimeHandler(30.0, 0.5, false));
+        solver->setInitialTemperature(std::vector<double>(stack.xGrid.size(), 300.0));
+    }
+    tabulated.setBoundaryConditions(new TabulatedCondition(&flat), new NeumannCondition(0.0));
+    tabulated.setBoundaryPosition({ 0.0f, 0.0f, 0.4f });
+    dirichlet.setBoundaryConditions(new DirichletCondition(900.0), new NeumannCondition(0.0));
+    while (!tabulated.isFinished()) { tabulated.step(); dirichlet.step(); }
+    assert(tabulated.getTemperatureDistribution() == dirichlet.getTemperatureDistribution());
+    std::cout << "Time-dependent boundary test passed.\n";
+}
+
 int main() {
     testHeatEquationSolver();
+    testAdaptiveErrorEstimateKeepsState();
+    testAdaptiveSteppingAndSteadyState();
+    testFloatSolverTracksDouble();
+    testBoundaryKernels();
+    testThicknessSensitivityMatchesFiniteDifference();
+    testCheckpointResumesBitIdentical();
+    testTimeDependentBoundary();
     return 0;
 }
\ No newline at end of file
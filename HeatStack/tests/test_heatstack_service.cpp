@@ -0,0 +1,132 @@
+#include "../include/HeatStackService.h"
+#include "../include/ParameterSweep.h"
+#include "../include/Json.h"
+#include <cassert>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+static HeatStackService makeService() {
+    SweepManifest defaults;
+    defaults.meshFile = "tests/humanoid_robot.obj";
+    defaults.nSlices = 3;
+    SweepConfig base;
+    base.duration = 20.0;
+    defaults.configs.push_back(base);
+    SweepOptions options;
+    options.numThreads = 2;
+    return HeatStackService(defaults, options);
+}
+
+static JsonValue answer(HeatStackService& service, const std::string& request) {
+    JsonValue v = parseJson(service.handle(request), "response");
+    assert(v.type == JsonValue::Type::Object);
+    return v;
+}
+
+void testRequestsMatchSweep() {
+    HeatStackService service = makeService();
+    JsonValue all = answer(service, R"({"id": 1, "op": "suggest", "theta": 0.5})");
+    assert(all.find("ok")->boolean && all.find("id")->number == 1.0);
+    const JsonValue& rows = *all.find("rows");
+    assert(rows.array.size() == 3);
+
+    // Same numbers as a --sweep of the same config
+    SweepManifest m;
+    m.meshFile = "tests/humanoid_robot.obj";
+    m.nSlices = 3;
+    SweepConfig c;
+    c.duration = 20.0;
+    c.theta = 0.5;
+    m.configs.push_back(c);
+    std::vector<SweepRow> ref = ParameterSweep(m, SweepOptions()).run();
+    for (int i = 0; i < 3; ++i) {
+        assert(rows.array[i].find("slice")->number == ref[i].slice);
+        assert(rows.array[i].find("optimizedTPS")->number == ref[i].optimizedTPS);
+        assert(rows.array[i].find("postSteelTemp")->number == ref[i].postSteelTemp);
+    }
+
+    // One slice, no search: the original stack only
+    JsonValue one = answer(service, R"({"id": "b", "op": "simulate", "slice": 2, "theta": 0.5})");
+    assert(one.find("id")->string == "b");
+    const JsonValue& row = one.find("rows")->array.at(0);
+    assert(one.find("rows")->array.size() == 1 && row.find("slice")->number == 2.0);
+    assert(row.find("optimizedTPS")->number == ref[1].originalTPS);
+    assert(row.find("preSteelTemp")->number == ref[1].preSteelTemp);
+    std::cout << "Service request test passed.\n";
+}
+
+void testStateStaysWarm() {
+    HeatStackService service = makeService();
+    // Crank-Nicolson: every trial runs to the end and is cached
+    answer(service, R"({"op": "suggest", "slice": 3, "theta": 0.5})");
+    SimulationCache::Stats first = service.getCacheStats();
+    answer(service, R"({"op": "suggest", "slice": 3, "theta": 0.5})");
+    SimulationCache::Stats second = service.getCacheStats();
+    assert(second.misses == first.misses && second.hits > first.hits && "Repeated searches are served from the cache");
+    assert(service.getStats().meshLoads == 1);
+
+    JsonValue stats = answer(service, R"({"op": "stats"})");
+    assert(stats.find("stats")->find("meshLoads")->number == 1.0);
+    assert(stats.find("stats")->find("threads")->number == 2.0);
+    std::cout << "Warm state test passed.\n";
+}
+
+void testErrorsAndShutdown() {
+    HeatStackService service = makeService();
+    std::istringstream in(
+        "{\"id\": 1, \"op\": \"simulate\", \"dt\": -1}\n"
+        "not json\n"
+        "\n"
+        "{\"id\": 2, \"op\": \"explode\"}\n"
+        "{\"id\": 3, \"op\": \"simulate\", \"slice\": 9}\n"
+        "{\"id\": 4, \"op\": \"simulate\", \"mesh\": \"missing.obj\"}\n"
+        "{\"id\": 5, \"op\": \"shutdown\"}\n"
+        "{\"id\": 6, \"op\": \"stats\"}\n");
+    std::ostringstream out;
+    service.serve(in, out);
+
+    std::istringstream lines(out.str());
+    std::string line;
+    int n = 0;
+    while (std::getline(lines, line)) {
+        JsonValue v = parseJson(line, "response");
+        ++n;
+        if (n < 6) {
+            assert(!v.find("ok")->boolean && !v.find("error")->string.empty());
+        } else {
+            assert(v.find("ok")->boolean && v.find("id")->number == 5.0);
+        }
+    }
+    assert(n == 6 && "One answer per request, nothing after shutdown");
+    assert(service.isShutdownRequested() && service.getStats().errors == 5);
+    std::cout << "Service error test passed.\n";
+}
+
+void testWorkerMode() {
+    HeatStackService service = makeService();
+    service.setWorkerMode(true);
+    // Server-side files and shutdown are refused; the service keeps going
+    JsonValue v = answer(service, R"({"id": 1, "op": "simulate", "mesh": "tests/humanoid_robot.obj", "zRange": [0, 1]})");
+    assert(!v.find("ok")->boolean);
+    v = answer(service, R"({"id": 2, "op": "simulate", "init": "init.txt", "zRange": [0, 1]})");
+    assert(!v.find("ok")->boolean);
+    v = answer(service, R"({"id": 3, "op": "simulate", "slice": 2})");
+    assert(!v.find("ok")->boolean && "The default mesh is not read either");
+    v = answer(service, R"({"id": 4, "op": "shutdown"})");
+    assert(!v.find("ok")->boolean && !service.isShutdownRequested());
+    assert(service.getStats().meshLoads == 0);
+
+    v = answer(service, R"({"id": 5, "op": "simulate", "slice": 2, "zRange": [0, 1]})");
+    assert(v.find("ok")->boolean && v.find("rows")->array.size() == 1);
+    std::cout << "Worker mode test passed.\n";
+}
+
+int main() {
+    testRequestsMatchSweep();
+    testStateStaysWarm();
+    testErrorsAndShutdown();
+    testWorkerMode();
+    std::cout << "All service tests passed.\n";
+    return 0;
+}
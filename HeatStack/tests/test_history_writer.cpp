@@ -0,0 +1,134 @@
+#include "../include/HistoryWriter.h"
+#include <iostream>
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static const std::vector<std::string> kColumns = { "time[s]", "T_a[K]", "T_b[K]" };
+
+std::string readFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::ostringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+void testCsvMatchesStreamFormatting() {
+    std::ostringstream expected;
+    expected << "time[s],T_a[K],T_b[K]\n";
+    HistoryOptions options;
+    options.blockRows = 7; // force several blocks through the writer thread
+    {
+        HistoryWriter writer("test_history.csv", kColumns, options);
+        assert(writer.isOpen());
+        for (int i = 1; i <= 50; ++i) {
+            double t = 0.5 * i, a = 300.0 + i / 3.0, b = 1.0 / i;
+            writer.record({ t, a, b });
+            expected << t << "," << a << "," << b << "\n";
+        }
+    }
+    assert(readFile("test_history.csv") == expected.str());
+    std::remove("test_history.csv");
+    std::cout << "CSV history test passed.\n";
+}
+
+void testBinaryRoundTripAndDecimation() {
+    HistoryOptions options;
+    options.format = HistoryFormat::Binary;
+    options.every = 10;
+    options.blockRows = 4;
+    {
+        HistoryWriter writer("test_history.bin", kColumns, options);
+        for (int i = 0; i < 95; ++i) {
+            writer.record({ double(i), 300.0 + i, 0.0 });
+        }
+        writer.close();
+        // rows 0,10,...,90 plus the final row 94
+        assert(writer.getWrittenRows() == 11);
+    }
+
+    std::vector<std::string> columns;
+    std::vector<std::vector<double>> data;
+    assert(HistoryWriter::readBinary("test_history.bin", columns, data));
+    assert(columns == kColumns);
+    assert(data.size() == 3 && data[0].size() == 11);
+    assert(data[0][1] == 10.0 && data[1][1] == 310.0);
+    assert(data[0].back() == 94.0);
+
+    assert(HistoryWriter::exportCsv("test_history.bin", "test_history_export.csv"));
+    std::string csv = readFile("test_history_export.csv");
+    assert(csv.compare(0, 22, "time[s],T_a[K],T_b[K]\n") == 0);
+    assert(csv.find("94,394,0\n") != std::string::npos);
+
+    std::remove("test_history.bin");
+    std::remove("test_history_export.csv");
+    std::cout << "Binary history test passed.\n";
+}
+
+void testDeltaThresholdKeepsTransients() {
+    HistoryOptions options;
+    options.every = 1000;
+    options.deltaThreshold = 5.0;
+    HistoryWriter writer("test_history_delta.csv", kColumns, options);
+    writer.record({ 0.0, 300.0, 300.0 });
+    writer.record({ 1.0, 301.0, 300.0 }); // small change, dropped
+    writer.record({ 2.0, 320.0, 300.0 }); // jump, kept
+    writer.record({ 3.0, 321.0, 300.0 }); // dropped, but last row is kept on close
+    writer.close();
+    assert(writer.getWrittenRows() == 3);
+    std::remove("test_history_delta.csv");
+    std::cout << "Delta threshold history test passed.\n";
+}
+
+void testSyncAndResume() {
+    // A run stopped after a sync (with extra rows written after it) and
+    // resumed at the synced size gives the file of a run that never stopped
+    for (HistoryFormat format : { HistoryFormat::Csv, HistoryFormat::Binary }) {
+        HistoryOptions options;
+        options.format = format;
+        options.blockRows = 5;
+        const std::string whole = "test_history_whole.dat", resumed = "test_history_resumed.dat";
+        {
+            HistoryWriter writer(whole, kColumns, options);
+            for (int i = 1; i <= 40; ++i) writer.record({ 0.5 * i, 300.0 + i, 1.0 / i });
+        }
+        std::uint64_t synced;
+        {
+            HistoryWriter writer(resumed, kColumns, options);
+            for (int i = 1; i <= 23; ++i) writer.record({ 0.5 * i, 300.0 + i, 1.0 / i });
+            synced = writer.sync();
+            for (int i = 24; i <= 30; ++i) writer.record({ 0.5 * i, 300.0 + i, 1.0 / i });
+        }
+        assert(synced > 0);
+        options.resumeBytes = synced;
+        {
+            HistoryWriter writer(resumed, kColumns, options);
+            assert(writer.sync() == synced);
+            for (int i = 24; i <= 40; ++i) writer.record({ 0.5 * i, 300.0 + i, 1.0 / i });
+        }
+        if (format == HistoryFormat::Csv) {
+            assert(readFile(resumed) == readFile(whole));
+        } else {
+            // Same rows; sync() ends a block early, so block sizes differ
+            std::vector<std::string> colsA, colsB;
+            std::vector<std::vector<double>> a, b;
+            assert(HistoryWriter::readBinary(whole, colsA, a) && HistoryWriter::readBinary(resumed, colsB, b));
+            assert(colsA == colsB && a == b);
+        }
+        std::remove(whole.c_str());
+        std::remove(resumed.c_str());
+    }
+    std::cout << "History sync/resume test passed.\n";
+}
+
+int main() {
+    testCsvMatchesStreamFormatting();
+    testBinaryRoundTripAndDecimation();
+    testDeltaThresholdKeepsTransients();
+    testSyncAndResume();
+    std::cout << "All history writer tests passed.\n";
+    return 0;
+}
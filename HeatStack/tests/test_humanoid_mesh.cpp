@@ -1,6 +1,9 @@
 #include "../include/MeshHandler.h"
 #include <iostream>
 #include <cassert>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
 
 void testHumanoidMesh() {
     MeshHandler mesh;
@@ -25,7 +28,72 @@ void testHumanoidMesh() {
     std::cout << "Humanoid MeshHandler test passed.\n";
 }
 
+void testChunkedLoadMatchesSerial() {
+    MeshHandler serial;
+    serial.setParseThreads(1);
+    serial.setUseMeshCache(false);
+    assert(serial.loadMesh("tests/humanoid_robot.obj"));
+
+    // Chunked parsing must give the same mesh, in the same order
+    for (int threads : {2, 3, 7, 64}) {
+        MeshHandler chunked;
+        chunked.setParseThreads(threads);
+        chunked.setUseMeshCache(false);
+        assert(chunked.loadMesh("tests/humanoid_robot.obj"));
+        assert(chunked.getVertices() == serial.getVertices());
+        assert(chunked.getFaces() == serial.getFaces());
+        assert(chunked.getMinY() == serial.getMinY() && chunked.getMaxY() == serial.getMaxY());
+    }
+
+    // Cached bounds equal a scan of the vertices
+    float lo[3] = {1e30f, 1e30f, 1e30f}, hi[3] = {-1e30f, -1e30f, -1e30f};
+    for (const auto& v : serial.getVertices()) {
+        for (int k = 0; k < 3; ++k) {
+            lo[k] = std::min(lo[k], v[k]);
+            hi[k] = std::max(hi[k], v[k]);
+        }
+    }
+    assert(serial.getMinX() == lo[0] && serial.getMaxX() == hi[0]);
+    assert(serial.getMinY() == lo[1] && serial.getMaxY() == hi[1]);
+    assert(serial.getMinZ() == lo[2] && serial.getMaxZ() == hi[2]);
+    std::cout << "Chunked OBJ load test passed.\n";
+}
+
+void testObjSyntax() {
+    const char* path = "test_mesh_syntax.obj";
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "# comment\r\n"
+            << "v 0 0 0\r\n"
+            << "v +1.5 0 0 extra\r\n"
+            << "  v 0 2e0 0\n"
+            << "v 0 0 -3\n"
+            << "vn 0 0 1\n"
+            << "f 1/1/1 2//1 3\n"
+            << "f -4 -3 -2 -1\n"   // Relative indices, quad
+            << "f 1 2\n";          // Skipped with a warning
+    }
+    for (int threads : {1, 4}) {
+        MeshHandler mesh;
+        mesh.setParseThreads(threads);
+        mesh.setUseMeshCache(false);
+        assert(mesh.loadMesh(path));
+        assert(mesh.getVertices().size() == 4);
+        assert(mesh.getVertices()[1][0] == 1.5f);
+        const auto& faces = mesh.getFaces();
+        assert(faces.size() == 3);
+        assert((faces[0] == std::array<int, 3>{0, 1, 2}));
+        assert((faces[1] == std::array<int, 3>{0, 1, 2}));
+        assert((faces[2] == std::array<int, 3>{0, 2, 3}));
+        assert(mesh.getMinZ() == -3.0f && mesh.getMaxY() == 2.0f);
+    }
+    std::remove(path);
+    std::cout << "OBJ syntax test passed.\n";
+}
+
 int main() {
     testHumanoidMesh();
+    testChunkedLoadMatchesSerial();
+    testObjSyntax();
     return 0;
 }
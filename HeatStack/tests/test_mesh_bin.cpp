@@ -0,0 +1,125 @@
+#include "../include/MeshBin.h"
+#include "../include/MeshHandler.h"
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+static void writeText(const char* path, const char* text) {
+    std::ofstream out(path, std::ios::binary);
+    out << text;
+}
+
+void testRoundTrip() {
+    const char* path = "test_roundtrip.meshbin";
+    std::vector<double> positions = {0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 1};
+    std::vector<std::int32_t> triangles = {0, 1, 2, 0, 2, 3};
+    std::vector<std::int32_t> offsets = {0, 4};
+    std::vector<std::int32_t> elements = {0, -1, 0, 1, -1, 0, 2, -1, 0, 3, -1, 0};
+    std::vector<double> normals = {0, 0, 1};
+
+    MeshBin::Data data;
+    data.positions = positions.data();
+    data.positionsF64 = true;
+    data.vertexCount = 4;
+    data.triangles = triangles.data();
+    data.triangleCount = 2;
+    data.polygonOffsets = offsets.data();
+    data.polygonElements = elements.data();
+    data.polygonCount = 1;
+    data.polygonElementCount = 4;
+    data.normals = normals.data();
+    data.normalCount = 1;
+    MeshBin::SourceStamp stamp;
+    stamp.size = 42;
+    stamp.mtime = 1234;
+    stamp.hash = 99;
+    assert(MeshBin::write(path, data, stamp));
+
+    MeshBin::View view;
+    assert(view.open(path));
+    assert(view.matches(stamp));
+    stamp.hash = 100;
+    assert(!view.matches(stamp));
+    const MeshBin::Header& h = view.header();
+    assert(h.vertexCount == 4 && h.triangleCount == 2 && h.polygonCount == 1);
+    assert(view.positionsF64() && (h.flags & MeshBin::HasPolygons));
+    assert(view.positionsF64Data()[11] == 1.0);
+    assert(view.triangles()[5] == 3);
+    assert(view.polygonOffsets()[1] == 4 && view.polygonElements()[9] == 3);
+    assert(view.normals()[2] == 1.0);
+    assert(view.texCoords() == nullptr);
+
+    // Truncated files are rejected
+    {
+        std::ifstream in(path, std::ios::binary);
+        std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size() - 8));
+    }
+    MeshBin::View truncated;
+    assert(!truncated.open(path));
+    std::remove(path);
+    std::cout << "MeshBin round-trip test passed.\n";
+}
+
+void testSidecarCache() {
+    const char* obj = "test_sidecar.obj";
+    std::string cache = MeshBin::sidecarPath(obj);
+    std::remove(cache.c_str());
+    writeText(obj, "v 0 0 0\nv 1 0 0\nv 0 1 0\nv 0 0 1\nf 1 2 3 4\n");
+
+    MeshHandler parsed;
+    assert(parsed.loadMesh(obj));
+    std::ifstream created(cache, std::ios::binary);
+    assert(created.is_open() && "loadMesh should create the sidecar");
+    created.close();
+
+    // A second load comes from the cache and gives the same mesh
+    MeshHandler cached;
+    assert(cached.loadMesh(obj));
+    assert(cached.getVertices() == parsed.getVertices());
+    assert(cached.getFaces() == parsed.getFaces());
+    assert(cached.getMaxZ() == 1.0f && cached.getMinX() == 0.0f);
+
+    // The quad keeps its polygon index, and the cache loads on its own (MeshX export)
+    const std::vector<int> quadOffsets = {0, 2};
+    assert(parsed.getPolygonCount() == 1 && parsed.getPolygonOffsets() == quadOffsets);
+    assert(cached.getPolygonCount() == 1 && cached.getPolygonOffsets() == quadOffsets);
+    MeshHandler direct;
+    assert(direct.loadMesh(cache));
+    assert(direct.getFaces() == parsed.getFaces() && direct.getPolygonOffsets() == quadOffsets);
+
+    // A cache that does not match the source is ignored and rebuilt
+    writeText(obj, "v 0 0 0\nv 2 0 0\nv 0 2 0\nf 1 2 3\n");
+    MeshHandler changed;
+    assert(changed.loadMesh(obj));
+    assert(changed.getVertices().size() == 3 && changed.getFaces().size() == 1);
+    assert(changed.getMaxX() == 2.0f);
+
+    std::remove(obj);
+    std::remove(cache.c_str());
+    std::cout << "MeshBin sidecar cache test passed.\n";
+}
+
+void testHumanoidCache() {
+    MeshHandler parsed;
+    parsed.setUseMeshCache(false);
+    assert(parsed.loadMesh("tests/humanoid_robot.obj"));
+
+    MeshHandler first, second;
+    assert(first.loadMesh("tests/humanoid_robot.obj"));   // May build the sidecar
+    assert(second.loadMesh("tests/humanoid_robot.obj"));  // From the sidecar
+    assert(second.getVertices() == parsed.getVertices());
+    assert(second.getFaces() == parsed.getFaces());
+    assert(second.getMinZ() == parsed.getMinZ() && second.getMaxY() == parsed.getMaxY());
+    std::cout << "MeshBin humanoid cache test passed.\n";
+}
+
+int main() {
+    testRoundTrip();
+    testSidecarCache();
+    testHumanoidCache();
+    return 0;
+}
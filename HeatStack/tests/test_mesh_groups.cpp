@@ -0,0 +1,136 @@
+#include "../include/MeshGroups.h"
+#include "../include/MeshHandler.h"
+#include "../include/MaterialProperties.h"
+#include "../include/SliceIndex.h"
+#include "../include/StackAssignment.h"
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+static void writeText(const char* path, const char* text) {
+    std::ofstream out(path, std::ios::binary);
+    out << text;
+}
+
+static bool throws(const std::string& json) {
+    try {
+        MeshGroups::parse(json);
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+// Two quads stacked along z (polygons 0 and 1) and a triangle above them (polygon 2)
+static const char* kMesh =
+    "v 0 0 0\nv 1 0 0\nv 1 0 1\nv 0 0 1\nv 1 0 2\nv 0 0 2\nv 0 0 3\n"
+    "f 1 2 3 4\nf 4 3 5 6\nf 6 5 7\n";
+
+void testParse() {
+    MeshGroups groups = MeshGroups::parse(
+        "{ \"Nozzle\": { \"faceIndices\": [4, 1, 1], \"faceRanges\": [10, 3],"
+        "                \"elementTags\": [\"hot\"], \"boundaryConditions\": {} },"
+        "  \"Skirt\": { \"groupName\": \"Skirt\", \"spatialData\": [ { \"faceIndex\": 7, \"centroid\": [0, 0, 0] } ] },"
+        "  \"Cols\": { \"spatialData\": { \"faceIndex\": [2, 0], \"centroid\": [] } } }");
+    assert(groups.groups.size() == 3);
+    const std::vector<int> nozzle = {1, 4, 10, 11, 12};
+    assert(groups.groups[0].faces == nozzle && groups.groups[0].tags.size() == 1);
+    assert(groups.groups[1].faces == std::vector<int>{7});
+    assert((groups.groups[2].faces == std::vector<int>{0, 2}));
+    assert(groups.find("Skirt") == 1 && groups.find("None") == -1);
+
+    assert(throws("[]"));
+    assert(throws("{ \"A\": { \"faceIndices\": [-1] } }"));
+    assert(throws("{ \"A\": { \"faceIndices\": [1.5] } }"));
+    assert(throws("{ \"A\": { \"faceRanges\": [1] } }"));
+    assert(throws("{ \"A\": {}, \"B\": { \"groupName\": \"A\" } }"));
+    std::cout << "Mesh groups parse test passed.\n";
+}
+
+void testTriangleGroups() {
+    const char* obj = "test_groups.obj";
+    writeText(obj, kMesh);
+    MeshHandler mesh;
+    mesh.setUseMeshCache(false);
+    assert(mesh.loadMesh(obj));
+    assert(mesh.getFaces().size() == 5 && mesh.getPolygonCount() == 3);
+
+    // Polygon 1 is in both groups and goes to the first
+    MeshGroups groups = MeshGroups::parse(
+        "{ \"Upper\": { \"faceIndices\": [1, 2] }, \"Lower\": { \"faceIndices\": [0, 1] } }");
+    for (int threads : { 1, 3 }) {
+        const std::vector<int> expected = {1, 1, 0, 0, 0};
+        assert(groups.triangleGroups(mesh, threads) == expected);
+    }
+    assert(MeshGroups::parse("{}").triangleGroups(mesh) == std::vector<int>(5, -1));
+
+    bool threw = false;
+    try {
+        MeshGroups::parse("{ \"A\": { \"faceIndices\": [3] } }").triangleGroups(mesh);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw && "faces past the end of the mesh should throw");
+    std::remove(obj);
+    std::cout << "Mesh groups triangle mapping test passed.\n";
+}
+
+void testStackAssignment() {
+    const char* obj = "test_groups.obj";
+    const char* stacksFile = "test_groups_stacks.json";
+    writeText(obj, kMesh);
+    writeText(stacksFile,
+        "{ \"stacks\": [ { \"id\": 2, \"groups\": [\"Lower\"],"
+        "  \"layers\": [ { \"material\": \"TPS\", \"thickness\": 0.002 },"
+        "               { \"material\": { \"name\": \"CFRP\", \"k\": 5, \"rho\": 1550, \"c\": 900 } },"
+        "               { \"material\": \"Glue\" }, { \"material\": \"Steel\" } ] },"
+        "  { \"id\": 5, \"groups\": [\"Upper\"], \"layers\": [ { \"material\": \"Steel\" } ] } ] }");
+    MeshHandler mesh;
+    mesh.setUseMeshCache(false);
+    assert(mesh.loadMesh(obj));
+
+    MaterialProperties props;
+    props.loadStacks(stacksFile);
+    Stack lower = props.getStack(2);
+    assert(lower.layers.size() == 4 && lower.groups == std::vector<std::string>{"Lower"});
+    assert(lower.layers[0].thickness == 0.002 && lower.layers[2].thickness == 0.0);
+    assert(lower.layers[1].material.name == "CFRP" && lower.layers[1].material.k == 5.0);
+    assert(lower.layers[3].material.rho == MaterialProperties::getMaterial("Steel").rho);
+
+    MeshGroups groups = MeshGroups::parse(
+        "{ \"Lower\": { \"faceIndices\": [0] }, \"Upper\": { \"faceIndices\": [1, 2] } }");
+    SliceIndex index;
+    index.build(mesh, 0, 3, 2, 1);
+    StackAssignment assignment;
+    assignment.build(mesh, groups, props.getStacks(), index, 2);
+    assert((assignment.getTriangleStacks() == std::vector<int>{2, 2, 5, 5, 5}));
+    assert(assignment.getSliceStack(0) == 2 && assignment.getSliceCoverage(0) == 1.0);
+    assert(assignment.getSliceStack(1) == 5 && assignment.getSliceStack(2) == 5);
+
+    // Stacks must name known groups, each group once
+    writeText(stacksFile, "{ \"stacks\": [ { \"id\": 1, \"groups\": [\"Middle\"], \"layers\": [ { \"material\": \"TPS\" } ] } ] }");
+    MaterialProperties unknown;
+    unknown.loadStacks(stacksFile);
+    bool threw = false;
+    try {
+        assignment.build(mesh, groups, unknown.getStacks(), index);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    std::remove(obj);
+    std::remove(stacksFile);
+    std::cout << "Stack assignment test passed.\n";
+}
+
+int main() {
+    testParse();
+    testTriangleGroups();
+    testStackAssignment();
+    return 0;
+}
@@ -0,0 +1,124 @@
+#include "../include/ParameterSweep.h"
+#include "../include/HeatEquationSolver.h"
+#include "../include/MaterialProperties.h"
+#include "../include/BoundaryConditions.h"
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+void testManifestExpansion() {
+    SweepManifest defaults;
+    defaults.meshFile = "default.obj";
+    defaults.configs.push_back(SweepConfig());
+    defaults.configs[0].duration = 42.0;
+
+    SweepManifest m = SweepManifest::parse(R"({
+        "mesh": "tests/humanoid_robot.obj",
+        "slices": 4,
+        "output": "out.csv",
+        "base": { "dt": 0.25, "maxSteelTemp": 750 },
+        "sweep": { "theta": [0.5, 1.0], "points": [10, 20, 30] }
+    })", defaults);
+
+    assert(m.meshFile == "tests/humanoid_robot.obj" && m.outputFile == "out.csv" && m.nSlices == 4);
+    assert(m.initFile.empty());
+    assert(m.configs.size() == 6);
+    // First key slowest, last key fastest; base and defaults apply to every config
+    assert(m.configs[0].theta == 0.5 && m.configs[0].pointsPerLayer == 10);
+    assert(m.configs[2].theta == 0.5 && m.configs[2].pointsPerLayer == 30);
+    assert(m.configs[3].theta == 1.0 && m.configs[3].pointsPerLayer == 10);
+    for (const auto& c : m.configs) {
+        assert(c.dt == 0.25 && c.maxSteelTemp == 750.0 && c.duration == 42.0);
+    }
+
+    // No sweep section: one config, the base
+    SweepManifest single = SweepManifest::parse(R"({ "base": { "adaptive": true } })", defaults);
+    assert(single.configs.size() == 1 && single.configs[0].adaptive && single.meshFile == "default.obj");
+    std::cout << "Sweep manifest expansion test passed.\n";
+}
+
+void testManifestErrors() {
+    const char* bad[] = {
+        R"({ "sweep": { "theta": 0.5 } })",          // sweep values must be lists
+        R"({ "base": { "thetaa": 0.5 } })",          // unknown config key
+        R"({ "mesh": "a.obj", })",                   // trailing comma
+        R"({ "slices": 1 })",                        // too few slices
+        R"({ "base": { "dt": 0 } })",                // invalid dt
+        R"([1, 2])"                                  // not an object
+    };
+    for (const char* json : bad) {
+        bool threw = false;
+        try {
+            SweepManifest::parse(json, SweepManifest());
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        assert(threw && "Invalid manifest must be rejected");
+    }
+    std::cout << "Sweep manifest error test passed.\n";
+}
+
+void testSweepRun() {
+    SweepManifest defaults;
+    defaults.meshFile = "tests/humanoid_robot.obj";
+    SweepManifest m = SweepManifest::parse(R"({
+        "slices": 3,
+        "base": { "time": 20, "dt": 0.5 },
+        "sweep": { "theta": [1.0, 0.5] }
+    })", defaults);
+
+    SweepOptions options;
+    options.numThreads = 2;
+    ParameterSweep sweep(m, options);
+    std::vector<SweepRow> rows = sweep.run();
+    assert(rows.size() == 6);
+    for (size_t j = 0; j < rows.size(); ++j) {
+        assert(rows[j].config == static_cast<int>(j / 3) && rows[j].slice == static_cast<int>(j % 3) + 1);
+        assert(rows[j].optimizedTPS > 0.0);
+    }
+    assert(rows[0].lL == 0.0 && rows[2].lL == 1.0);
+
+    // Each row is the same run a standalone solver does for that slice
+    MaterialProperties props;
+    const SweepRow& r = rows[4]; // theta 0.5, middle slice
+    Stack s;
+    s.id = 1;
+    s.layers = {
+        {{"TPS",         0.2,  160.0, 1200.0,   0.0, 1200.0}, props.getTPSThickness(r.lL),          10},
+        {{"CarbonFiber", 500.0,1600.0, 700.0,   0.0,  350.0}, props.getCarbonFiberThickness(r.lL),  10},
+        {{"Glue",        200.0,1300.0, 900.0,   0.0,  400.0}, props.getGlueThickness(r.lL),         10},
+        {{"Steel",       100.0,7850.0, 500.0, 800.0,    0.0}, props.getSteelThickness(r.lL),        10}
+    };
+    props.generateGrid(s, 10);
+    HeatEquationSolver solver(0.5);
+    solver.initialize(s, TimeHandler(20.0, 0.5, false));
+    solver.setInitialTemperature(std::vector<double>(s.xGrid.size(), 300.0));
+    solver.setBoundaryConditions(new DirichletCondition(static_cast<float>(props.getExhaustTemp(r.lL))),
+                                 new NeumannCondition(0.0f));
+    while (!solver.isFinished()) solver.step();
+    assert(solver.getTemperatureDistribution().back() == r.preSteelTemp);
+
+    // One table: header plus one line per job
+    const std::string path = "test_sweep_results.csv";
+    assert(sweep.writeTable(path, rows));
+    std::ifstream in(path);
+    std::string line;
+    std::getline(in, line);
+    assert(line.compare(0, 10, "config,dt,") == 0);
+    int lines = 0;
+    while (std::getline(in, line)) ++lines;
+    assert(lines == 6);
+    in.close();
+    std::remove(path.c_str());
+    std::cout << "Sweep run test passed.\n";
+}
+
+int main() {
+    testManifestExpansion();
+    testManifestErrors();
+    testSweepRun();
+    return 0;
+}
@@ -0,0 +1,75 @@
+#include "../include/PlaybackFrames.h"
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+static std::shared_ptr<const SliceResult> slice(int number, const std::vector<double>& time,
+                                                const std::vector<double>& steel, bool optimized = false) {
+    auto r = std::make_shared<SliceResult>();
+    r->slice = number;
+    SliceHistory& h = optimized ? r->optHistory : r->origHistory;
+    for (size_t i = 0; i < time.size(); ++i) h.append(time[i], steel[i] + 2.0, steel[i] + 1.0, steel[i]);
+    return r;
+}
+
+static bool near(double a, double b) { return std::fabs(a - b) < 1e-4; }
+
+void testResample() {
+    // Slice 1 samples every second, slice 3 every two seconds and stops early;
+    // slice 2 has no result
+    std::vector<std::shared_ptr<const SliceResult>> results = {
+        slice(1, {0, 1, 2, 3, 4}, {300, 310, 320, 330, 340}),
+        slice(3, {0, 2}, {300, 400}),
+    };
+    PlaybackFrames frames = PlaybackFrames::build(results, 3, HistoryField::Steel, false);
+    assert(frames.nSlices == 3 && frames.nFrames == 5);
+    assert(frames.startTime == 0.0 && frames.endTime == 4.0 && frames.frameStep() == 1.0);
+    assert(frames.minTemp == 300.0 && frames.maxTemp == 400.0);
+    assert(frames.valid[0] && !frames.valid[1] && frames.valid[2]);
+    assert(frames.values.size() == 15);
+
+    assert(near(frames.sample(0, 2.5), 325.0));
+    assert(near(frames.sample(2, 1.0), 350.0));
+    assert(near(frames.sample(2, 3.5), 400.0)); // Holds its last value
+    assert(near(frames.sample(0, -1.0), 300.0) && near(frames.sample(0, 9.0), 340.0));
+    assert(frames.frameOf(2.5) == 2.5 && frames.frameOf(-3.0) == 0.0 && frames.frameOf(10.0) == 4.0);
+
+    // Other interface, fewer frames
+    PlaybackFrames glue = PlaybackFrames::build(results, 3, HistoryField::GlueSteel, false, 3);
+    assert(glue.nFrames == 3 && glue.frameStep() == 2.0);
+    assert(near(glue.sample(0, 2.0), 321.0) && glue.maxTemp == 401.0);
+    std::cout << "Playback resample test passed.\n";
+}
+
+void testOptimizedFallback() {
+    auto both = std::make_shared<SliceResult>();
+    both->slice = 1;
+    both->origHistory.append(0.0, 0.0, 0.0, 500.0);
+    both->origHistory.append(1.0, 0.0, 0.0, 500.0);
+    both->optHistory.append(0.0, 0.0, 0.0, 350.0);
+    both->optHistory.append(1.0, 0.0, 0.0, 360.0);
+    std::vector<std::shared_ptr<const SliceResult>> results = { both, slice(2, {0, 1}, {600, 600}) };
+
+    PlaybackFrames opt = PlaybackFrames::build(results, 2, HistoryField::Steel, true);
+    assert(near(opt.sample(0, 1.0), 360.0));
+    assert(near(opt.sample(1, 1.0), 600.0)); // No optimized run: original
+    PlaybackFrames orig = PlaybackFrames::build(results, 2, HistoryField::Steel, false);
+    assert(near(orig.sample(0, 1.0), 500.0));
+
+    // Results outside the slice count and empty stores give no frames
+    assert(PlaybackFrames::build(results, 0, HistoryField::Steel, true).empty());
+    assert(PlaybackFrames::build({ slice(5, {0}, {300}) }, 2, HistoryField::Steel, true).empty());
+
+    // A single instant is one frame
+    PlaybackFrames single = PlaybackFrames::build({ slice(1, {0}, {300}) }, 1, HistoryField::Steel, false);
+    assert(single.nFrames == 1 && near(single.sample(0, 5.0), 300.0));
+    std::cout << "Playback optimized fallback test passed.\n";
+}
+
+int main() {
+    testResample();
+    testOptimizedFallback();
+    return 0;
+}
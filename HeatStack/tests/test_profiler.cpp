@@ -0,0 +1,62 @@
+#include "../include/Profiler.h"
+#include <iostream>
+#include <cassert>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <cstdio>
+
+void testDisabledRecordsNothing() {
+    Profiler::enable(false);
+    Profiler::reset();
+    double ms = 0.0;
+    {
+        ProfileZone zone("disabled.zone", -1, &ms);
+        Profiler::count(ProfileCounter::SolverSteps, 5);
+    }
+    // The accumulator still works, but no zone or count is kept
+    assert(ms >= 0.0);
+    std::string s = Profiler::summary();
+    assert(s.find("disabled.zone") == std::string::npos);
+    assert(s.find("solver steps 0") != std::string::npos);
+    std::cout << "Disabled profiler test passed.\n";
+}
+
+void testZonesAndCountersAcrossThreads() {
+    Profiler::enable(true);
+    Profiler::reset();
+    auto work = [](int slice) {
+        ProfileZone zone("test.slice", slice);
+        Profiler::count(ProfileCounter::SolverSteps, 10);
+        Profiler::count(ProfileCounter::MatrixSolves);
+    };
+    std::thread a(work, 0), b(work, 1);
+    a.join();
+    b.join();
+    work(2);
+
+    std::string s = Profiler::summary();
+    assert(s.find("test.slice") != std::string::npos);
+    assert(s.find("solver steps 30") != std::string::npos);
+    assert(s.find("matrix solves 3") != std::string::npos);
+
+    const char* path = "test_profiler_trace.json";
+    assert(Profiler::writeChromeTrace(path));
+    std::ifstream in(path);
+    std::stringstream json;
+    json << in.rdbuf();
+    in.close();
+    std::remove(path);
+    assert(json.str().find("\"traceEvents\"") != std::string::npos);
+    assert(json.str().find("\"slice\":3") != std::string::npos);
+
+    Profiler::enable(false);
+    std::cout << "Profiler zones and counters test passed.\n";
+}
+
+int main() {
+    testDisabledRecordsNothing();
+    testZonesAndCountersAcrossThreads();
+    std::cout << "All profiler tests passed.\n";
+    return 0;
+}
@@ -0,0 +1,74 @@
+#include "../include/ResultsStore.h"
+#include <iostream>
+#include <cassert>
+#include <thread>
+#include <vector>
+
+void testPublishAndRead() {
+    ResultsStore store;
+    store.reset(3);
+    assert(store.getSlice(0) == nullptr);
+    assert(store.getAll().empty());
+
+    double lo = -1.0, hi = -1.0;
+    assert(!store.thicknessRange(lo, hi));
+    assert(lo == -1.0 && hi == -1.0);
+
+    SliceResult r;
+    r.slice = 2;
+    r.tpsThickness = 0.02;
+    r.optimizedTPS = 0.01;
+    r.origHistory.append(1.0, 300.0, 301.0, 302.0);
+    unsigned long v = store.getVersion();
+    store.publish(1, r);
+    assert(store.getVersion() > v);
+
+    auto s = store.getSlice(1);
+    assert(s && s->slice == 2 && s->origHistory.time.size() == 1);
+    assert(s->reportedTPS() == 0.01);
+
+    SliceResult failed;
+    failed.slice = 3;
+    failed.tpsThickness = 0.03; // optimization failed: report the original
+    store.publish(2, failed);
+    assert(store.getAll().size() == 2);
+    assert(store.thicknessRange(lo, hi));
+    assert(lo == 0.01 && hi == 0.03);
+
+    // Readers keep their snapshot across a reset
+    store.reset(3);
+    assert(store.getSlice(1) == nullptr);
+    assert(s->origHistory.steelTemp[0] == 302.0);
+    std::cout << "Results store publish/read test passed.\n";
+}
+
+void testConcurrentPublish() {
+    ResultsStore store;
+    const int n = 64;
+    store.reset(n);
+    std::vector<std::thread> writers;
+    for (int w = 0; w < 4; ++w) {
+        writers.emplace_back([&store, w]() {
+            for (int i = w; i < n; i += 4) {
+                SliceResult r;
+                r.slice = i + 1;
+                r.tpsThickness = 0.001 * (i + 1);
+                store.publish(i, r);
+            }
+        });
+    }
+    for (int i = 0; i < 1000; ++i) store.getAll(); // reads race with the writers
+    for (auto& t : writers) t.join();
+
+    auto all = store.getAll();
+    assert(static_cast<int>(all.size()) == n);
+    for (int i = 0; i < n; ++i) assert(all[i]->slice == i + 1);
+    std::cout << "Results store concurrent publish test passed.\n";
+}
+
+int main() {
+    testPublishAndRead();
+    testConcurrentPublish();
+    std::cout << "All results store tests passed.\n";
+    return 0;
+}
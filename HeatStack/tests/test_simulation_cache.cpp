@@ -0,0 +1,103 @@
+#include "../include/SimulationCache.h"
+#include "../include/TemperatureComparator.h"
+#include "../include/MaterialProperties.h"
+#include <iostream>
+#include <cassert>
+#include <filesystem>
+
+void testMemoryTier() {
+    MaterialProperties props;
+    Stack stack = props.getStack(1);
+    SimulationCache cache;
+
+    std::string key = SimulationCache::makeKey(stack, 10, 0.5, false, 1.0, 300.0, 900.0);
+    std::string other = SimulationCache::makeKey(stack, 10, 0.5, false, 0.5, 300.0, 900.0);
+    assert(key != other);
+    // Float trial runs never answer double lookups
+    assert(key != SimulationCache::makeKey(stack, 10, 0.5, false, 1.0, 300.0, 900.0, true));
+    // Adaptive runs with other step control are different runs
+    StepOptions tight;
+    tight.adaptiveTolerance = 1e-4;
+    std::string adaptive = SimulationCache::makeKey(stack, 10, 0.5, true, 1.0, 300.0, 900.0);
+    assert(adaptive != SimulationCache::makeKey(stack, 10, 0.5, true, 1.0, 300.0, 900.0, false,
+                                                GridOptions(), tight));
+    assert(key == SimulationCache::makeKey(stack, 10, 0.5, false, 1.0, 300.0, 900.0, false,
+                                           GridOptions(), tight));
+    StepOptions steady;
+    steady.steadyStateRate = 0.01;
+    assert(key != SimulationCache::makeKey(stack, 10, 0.5, false, 1.0, 300.0, 900.0, false,
+                                           GridOptions(), steady));
+
+    InterfaceTemperatures temps;
+    assert(!cache.lookup(key, temps));
+    cache.store(key, {310.0, 305.0, 301.5});
+    assert(cache.lookup(key, temps));
+    assert(temps.carbonGlue == 310.0 && temps.glueSteel == 305.0 && temps.steel == 301.5);
+
+    SimulationCache::Stats stats = cache.getStats();
+    assert(stats.hits == 1 && stats.misses == 1);
+    assert(stats.hitRate() == 0.5);
+    std::cout << "Memory cache test passed.\n";
+}
+
+void testDiskTier() {
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "heatstack_cache_test";
+    std::filesystem::remove_all(dir);
+
+    MaterialProperties props;
+    Stack stack = props.getStack(1);
+    std::string key = SimulationCache::makeKey(stack, 10, 0.5, false, 1.0, 300.0, 900.0);
+    InterfaceTemperatures stored = {312.345678901234, 306.1, 300.000000001};
+    {
+        SimulationCache writer(dir.string());
+        writer.store(key, stored);
+    }
+
+    SimulationCache reader(dir.string());
+    InterfaceTemperatures temps;
+    assert(reader.lookup(key, temps));
+    assert(temps.carbonGlue == stored.carbonGlue && temps.steel == stored.steel);
+    assert(reader.getStats().diskHits == 1);
+
+    std::filesystem::remove_all(dir);
+    std::cout << "Disk cache test passed.\n";
+}
+
+void testComparatorReusesResults() {
+    MaterialProperties props;
+    Stack stack = props.getStack(1);
+    SimulationCache cache;
+
+    TemperatureComparator comp;
+    comp.setTimeStep(1.0, false);
+    comp.setGridResolution(5);
+    comp.setEarlyStop(false); // Every trial runs to the end and is cached
+    double uncached = comp.suggestTPSThickness(stack, 800.0, 400.0, 350.0, 30.0, 0.5, props, 1.0);
+
+    comp.setCache(&cache);
+    double first = comp.suggestTPSThickness(stack, 800.0, 400.0, 350.0, 30.0, 0.5, props, 1.0);
+    double second = comp.suggestTPSThickness(stack, 800.0, 400.0, 350.0, 30.0, 0.5, props, 1.0);
+    assert(first == uncached && second == uncached);
+
+    SimulationCache::Stats stats = cache.getStats();
+    assert(stats.misses > 0 && stats.hits == stats.misses);
+
+    // Early-stopped trials are not cached, the full (passing) ones are
+    SimulationCache stopCache;
+    comp.setEarlyStop(true);
+    comp.setCache(&stopCache);
+    first = comp.suggestTPSThickness(stack, 800.0, 400.0, 350.0, 30.0, 0.5, props, 1.0);
+    second = comp.suggestTPSThickness(stack, 800.0, 400.0, 350.0, 30.0, 0.5, props, 1.0);
+    assert(first == uncached && second == uncached);
+    stats = stopCache.getStats();
+    assert(stats.hits > 0 && stats.hits < stats.misses);
+    std::cout << "Comparator cache test passed.\n";
+}
+
+int main() {
+    testMemoryTier();
+    testDiskTier();
+    testComparatorReusesResults();
+    std::cout << "All simulation cache tests passed.\n";
+    return 0;
+}
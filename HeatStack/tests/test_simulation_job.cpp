@@ -0,0 +1,101 @@
+#include "../include/SimulationJob.h"
+#include "../include/SimulationCache.h"
+#include "../include/TemperatureComparator.h"
+#include "../include/MaterialProperties.h"
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <thread>
+
+void testCompletesWithProgress() {
+    auto job = SimulationJob::start([](SimulationJob& job) {
+        job.setTotal(4);
+        for (int i = 0; i < 4; ++i) job.advance();
+        job.log("done\n");
+        return true;
+    });
+    job->wait();
+    assert(job->getState() == SimulationJob::State::Completed);
+    assert(job->getDone() == 4 && job->getFraction() == 1.0f);
+    assert(job->takeLog() == "done\n");
+    assert(job->takeLog().empty());
+    std::cout << "Job completion test passed.\n";
+}
+
+void testFailure() {
+    auto failed = SimulationJob::start([](SimulationJob&) { return false; });
+    auto threw = SimulationJob::start([](SimulationJob&) -> bool { throw std::runtime_error("boom"); });
+    failed->wait();
+    threw->wait();
+    assert(failed->getState() == SimulationJob::State::Failed);
+    assert(threw->getState() == SimulationJob::State::Failed);
+    assert(threw->takeLog().find("boom") != std::string::npos);
+    std::cout << "Job failure test passed.\n";
+}
+
+void testRestartCancelsPrevious() {
+    // A long run that only stops when cancelled
+    auto first = SimulationJob::start([](SimulationJob& job) {
+        while (true) {
+            job.getToken().throwIfCancelled();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    // Starting the next run returns at once; it runs after the first one stopped
+    auto started = std::chrono::steady_clock::now();
+    auto second = SimulationJob::start([first](SimulationJob&) {
+        return first->isDone();
+    }, first);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+    assert(ms < 1000.0);
+
+    second->wait();
+    assert(first->getState() == SimulationJob::State::Cancelled);
+    assert(second->getState() == SimulationJob::State::Completed);
+    std::cout << "Job restart test passed.\n";
+}
+
+void testCancelledSearch() {
+    MaterialProperties props;
+    Stack stack = props.getStack(1);
+    props.generateGrid(stack, 10);
+
+    SimulationCache cache;
+    CancellationToken token;
+    token.cancel();
+    TemperatureComparator comp;
+    comp.setTimeStep(0.5, false);
+    comp.setCache(&cache);
+    comp.setCancellationToken(&token);
+
+    bool cancelled = false;
+    try {
+        comp.suggestTPSThickness(stack, 800.0, 400.0, 350.0, 300.0, 0.5, props, 1.0);
+    } catch (const JobCancelled&) {
+        cancelled = true;
+    }
+    assert(cancelled);
+    assert(cache.size() == 0 && "a cancelled trial must not be cached");
+
+    // Same for the parallel search, whose trials run on pool threads
+    comp.setSearchWays(4);
+    cancelled = false;
+    try {
+        comp.suggestTPSThickness(stack, 800.0, 400.0, 350.0, 300.0, 0.5, props, 1.0);
+    } catch (const JobCancelled&) {
+        cancelled = true;
+    }
+    assert(cancelled && cache.size() == 0);
+    std::cout << "Cancelled TPS search test passed.\n";
+}
+
+int main() {
+    testCompletesWithProgress();
+    testFailure();
+    testRestartCancelsPrevious();
+    testCancelledSearch();
+    return 0;
+}
@@ -0,0 +1,144 @@
+#include "../include/SliceCoordinator.h"
+#include "../include/HeatStackService.h"
+#include "../include/MeshHandler.h"
+#include "../include/TcpChannel.h"
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// In-process --worker: worker mode as in main.cpp, so it takes no "shutdown";
+// the destructor raises stop and wakes the accept with one more connection
+struct TestWorker {
+    std::unique_ptr<TcpListener> listener;
+    std::atomic<bool> stop{false};
+    std::thread thread;
+
+    TestWorker() : listener(new TcpListener(0)) {
+        thread = std::thread([this] {
+            SweepManifest defaults;
+            defaults.configs.push_back(SweepConfig());
+            SweepOptions options;
+            options.numThreads = 2;
+            HeatStackService service(defaults, options);
+            service.setWorkerMode(true);
+            for (;;) {
+                std::unique_ptr<TcpChannel> channel = listener->accept();
+                if (stop) break;
+                std::string line;
+                while (channel->readLine(line)) {
+                    if (!channel->writeLine(service.handle(line))) break;
+                }
+            }
+        });
+    }
+
+    WorkerAddress address() const { return WorkerAddress{"127.0.0.1", listener->getPort()}; }
+
+    ~TestWorker() {
+        stop = true;
+        TcpChannel::connect("127.0.0.1", listener->getPort());
+        thread.join();
+    }
+};
+
+static SliceRequest makeRequest(int nSlices) {
+    MeshHandler mesh;
+    bool loaded = mesh.loadMesh("tests/humanoid_robot.obj");
+    assert(loaded);
+    SliceRequest request;
+    request.nSlices = nSlices;
+    request.zMin = mesh.getMinZ();
+    request.zMax = mesh.getMaxZ();
+    request.config.duration = 20.0;
+    request.config.theta = 0.5;
+    return request;
+}
+
+void testMatchesLocalSweep() {
+    SliceRequest request = makeRequest(5);
+
+    SweepManifest m;
+    m.meshFile = "tests/humanoid_robot.obj";
+    m.nSlices = 5;
+    m.configs.push_back(request.config);
+    std::vector<SweepRow> ref = ParameterSweep(m, SweepOptions()).run();
+
+    TestWorker a, b;
+    SliceCoordinator coordinator({a.address(), b.address()});
+    coordinator.setBatchSize(1);
+    std::vector<SweepRow> rows = coordinator.run(request);
+    assert(rows.size() == ref.size());
+    for (size_t i = 0; i < rows.size(); ++i) {
+        assert(rows[i].slice == static_cast<int>(i) + 1);
+        assert(rows[i].lL == ref[i].lL);
+        assert(rows[i].optimizedTPS == ref[i].optimizedTPS);
+        assert(rows[i].preSteelTemp == ref[i].preSteelTemp);
+        assert(rows[i].postSteelTemp == ref[i].postSteelTemp);
+    }
+    const std::vector<int>& perWorker = coordinator.getSlicesPerWorker();
+    assert(perWorker[0] + perWorker[1] == 5);
+    std::cout << "Coordinator result test passed.\n";
+}
+
+void testDeadWorkerTolerated() {
+    SliceRequest request = makeRequest(3);
+    request.search = false;
+    TestWorker a;
+    // Nothing listens on port 1: its share goes to the live worker
+    SliceCoordinator coordinator({WorkerAddress{"127.0.0.1", 1}, a.address()});
+    std::vector<SweepRow> rows = coordinator.run(request);
+    assert(rows.size() == 3 && rows[2].slice == 3);
+    assert(coordinator.getSlicesPerWorker()[0] == 0 && coordinator.getSlicesPerWorker()[1] == 3);
+
+    // No live worker at all
+    bool threw = false;
+    try {
+        SliceCoordinator({WorkerAddress{"127.0.0.1", 1}}).run(request);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+    std::cout << "Coordinator dead worker test passed.\n";
+}
+
+void testRejectedRequest() {
+    SliceRequest request = makeRequest(3);
+    request.config.dt = -1.0;
+    TestWorker a;
+    bool threw = false;
+    try {
+        SliceCoordinator({a.address()}).run(request);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+    std::cout << "Coordinator rejected request test passed.\n";
+}
+
+void testParseWorkerList() {
+    std::vector<WorkerAddress> w = parseWorkerList("node1:7000,10.0.0.2:7001");
+    assert(w.size() == 2 && w[0].host == "node1" && w[0].port == 7000 && w[1].port == 7001);
+    for (const char* bad : {"", "node1", ":7000", "node1:x", "node1:70000"}) {
+        bool threw = false;
+        try {
+            parseWorkerList(bad);
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        assert(threw);
+    }
+    std::cout << "Worker list test passed.\n";
+}
+
+int main() {
+    testParseWorkerList();
+    testMatchesLocalSweep();
+    testDeadWorkerTolerated();
+    testRejectedRequest();
+    return 0;
+}
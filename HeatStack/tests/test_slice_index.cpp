@@ -0,0 +1,64 @@
+#include "../include/SliceIndex.h"
+#include "../include/MeshHandler.h"
+#include <iostream>
+#include <cassert>
+
+// Reference: the boundary scan the GUI used before the index existed
+int scanSlice(double avgY, double yMin, double depthRange, int nSlices) {
+    std::vector<double> boundaries;
+    for (int i = 0; i <= nSlices; i++) {
+        boundaries.push_back(yMin + (static_cast<double>(i) / nSlices) * depthRange);
+    }
+    for (size_t i = 0; i < boundaries.size() - 1; i++) {
+        if (avgY >= boundaries[i] && avgY <= boundaries[i+1]) return static_cast<int>(i);
+    }
+    return 0;
+}
+
+void testMatchesBoundaryScan() {
+    MeshHandler mesh;
+    bool loaded = mesh.loadMesh("tests/humanoid_robot.obj");
+    assert(loaded && "Failed to load humanoid_robot.obj");
+    const auto& v = mesh.getVertices();
+    const auto& faces = mesh.getFaces();
+    double yMin = mesh.getMinY();
+    double depthRange = mesh.getMaxY() - yMin;
+
+    for (int n : { 1, 3, 10, 37 }) {
+        SliceIndex index;
+        index.build(mesh, 7, n, 1, 3);
+        assert(index.isCurrent(7, n) && !index.isCurrent(8, n) && !index.isCurrent(7, n + 1));
+
+        size_t total = 0;
+        for (size_t c : index.getFaceCounts()) total += c;
+        assert(total == faces.size());
+
+        for (size_t f = 0; f < faces.size(); ++f) {
+            const auto& face = faces[f];
+            double avgY = (v[face[0]][1] + v[face[1]][1] + v[face[2]][1]) / 3.0;
+            int expected = (n > 1) ? scanSlice(avgY, yMin, depthRange, n) : 0;
+            assert(index.sliceOf(f) == expected);
+        }
+    }
+    std::cout << "Slice index matches boundary scan test passed.\n";
+}
+
+void testEdgesGoToLowerBand() {
+    MeshHandler mesh;
+    mesh.loadMesh("tests/humanoid_robot.obj");
+    SliceIndex index;
+    index.build(mesh, 0, 4);
+    assert(index.binOf(index.getMin()) == 0);
+    assert(index.binOf(index.boundary(2)) == 1);
+    assert(index.binOf(index.getMax()) == 3);
+    assert(index.binOf(index.getMax() + 1.0) == 0); // outside the range
+    assert(index.samplePosition(0) == index.getMin());
+    std::cout << "Slice index edge test passed.\n";
+}
+
+int main() {
+    testMatchesBoundaryScan();
+    testEdgesGoToLowerBand();
+    std::cout << "All slice index tests passed.\n";
+    return 0;
+}
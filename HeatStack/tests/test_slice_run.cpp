@@ -0,0 +1,67 @@
+#include "../include/SliceRun.h"
+#include <iostream>
+#include <cassert>
+#include <cmath>
+
+void testDefaultStack() {
+    SliceSettings settings;
+    settings.duration = 20.0;
+    SliceRun run(settings, 3, 0.5);
+    const Stack& s = run.getStack();
+    MaterialProperties props;
+    assert(s.id == 3 && s.layers.size() == 4);
+    assert(s.layers[0].material.name == "TPS" && s.layers[3].material.name == "Steel");
+    assert(s.layers[1].thickness == props.getCarbonFiberThickness(0.5));
+
+    // Built-in materials give the 800/400/350 K limits
+    InterfaceTemperatures limits = run.materialLimits();
+    assert(limits.steel == 800.0 && limits.glueSteel == 400.0 && limits.carbonGlue == 350.0);
+
+    // Interface nodes sit on the interfaces, also after the TPS changes
+    for (double tps : { s.layers[0].thickness, 0.0237845 }) {
+        run.setTPSThickness(tps);
+        const Stack& t = run.getStack();
+        double posCG = t.layers[0].thickness + t.layers[1].thickness;
+        double posGS = posCG + t.layers[2].thickness;
+        const auto& nodes = run.getInterfaceNodes();
+        assert(std::fabs(t.xGrid[nodes[0]] - posCG) < 1e-12);
+        assert(std::fabs(t.xGrid[nodes[1]] - posGS) < 1e-12);
+        assert(nodes[2] == static_cast<int>(t.xGrid.size()) - 1);
+    }
+
+    HeatEquationSolver solver(settings.theta);
+    run.setUp(solver);
+    int steps = 0;
+    InterfaceTemperatures end = run.transient(solver, [&](const HeatEquationSolver&) { ++steps; });
+    assert(steps == 40);
+    assert(end.steel == solver.getTemperatureDistribution().back());
+    std::cout << "Default stack test passed.\n";
+}
+
+void testGroupStack() {
+    Stack group;
+    group.id = 2;
+    group.layers = {
+        { MaterialProperties::getMaterial("TPS"),   0.0,   0 },
+        { { "CFRP", 5.0, 1550.0, 900.0, 0.0, 420.0 }, 0.004, 0 },
+        { MaterialProperties::getMaterial("Glue"),  0.0,   0 },
+        { { "Alloy", 120.0, 2700.0, 900.0, 0.0, 0.0 }, 0.0, 0 }
+    };
+    SliceSettings settings;
+    SliceRun run(settings, 1, 0.25, &group);
+    const Stack& s = run.getStack();
+    MaterialProperties props;
+    assert(s.layers[1].material.name == "CFRP" && s.layers[1].thickness == 0.004);
+    assert(s.layers[0].thickness == props.getTPSThickness(0.25)); // 0 keeps the profile
+    InterfaceTemperatures limits = run.materialLimits();
+    assert(limits.carbonGlue == 420.0 && limits.glueSteel == 400.0);
+    assert(std::isinf(limits.steel)); // maxTemp 0: no limit
+    std::cout << "Group stack test passed.\n";
+}
+
+int main() {
+    testDefaultStack();
+    testGroupStack();
+    std::cout << "All slice run tests passed.\n";
+    return 0;
+}
@@ -0,0 +1,77 @@
+#include "../include/SliceScheduler.h"
+#include <iostream>
+#include <cassert>
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+void testEverySliceRunsOnce() {
+    SliceScheduler scheduler(4);
+    assert(scheduler.getNumThreads() == 4);
+
+    const int nSlices = 37;
+    std::vector<std::atomic<int>> hits(nSlices);
+    for (auto& h : hits) h = 0;
+    scheduler.run(nSlices, [&](int slice) { hits[slice]++; });
+
+    for (int i = 0; i < nSlices; ++i) {
+        assert(hits[i] == 1);
+    }
+    std::cout << "Every slice runs once test passed.\n";
+}
+
+void testExceptionPropagates() {
+    SliceScheduler scheduler(3);
+    bool caught = false;
+    try {
+        scheduler.run(10, [](int slice) {
+            if (slice == 5) throw std::runtime_error("slice failed");
+        });
+    } catch (const std::runtime_error&) {
+        caught = true;
+    }
+    assert(caught);
+    std::cout << "Exception propagation test passed.\n";
+}
+
+void testReusedAcrossRuns() {
+    // Parked workers pick up every later run, including wider ones
+    SliceScheduler scheduler(4);
+    for (int nSlices : { 2, 9, 1, 40, 3 }) {
+        for (int repeat = 0; repeat < 20; ++repeat) {
+            std::vector<std::atomic<int>> hits(nSlices);
+            for (auto& h : hits) h = 0;
+            scheduler.run(nSlices, [&](int slice) { hits[slice]++; });
+            for (int i = 0; i < nSlices; ++i) assert(hits[i] == 1);
+        }
+    }
+    // A failed run leaves the pool usable
+    bool caught = false;
+    try {
+        scheduler.run(8, [](int slice) { if (slice == 3) throw std::runtime_error("x"); });
+    } catch (const std::runtime_error&) {
+        caught = true;
+    }
+    assert(caught);
+    std::atomic<int> count(0);
+    scheduler.run(16, [&](int) { count++; });
+    assert(count == 16);
+    std::cout << "Scheduler reuse test passed.\n";
+}
+
+void testNestedThreads() {
+    int cores = SliceScheduler(0).getNumThreads();
+    assert(SliceScheduler::nestedThreads(1) == cores);
+    assert(SliceScheduler::nestedThreads(0) == 1);
+    assert(SliceScheduler::nestedThreads(cores * 2) == 1);
+    std::cout << "Nested thread budget test passed.\n";
+}
+
+int main() {
+    testEverySliceRunsOnce();
+    testExceptionPropagates();
+    testReusedAcrossRuns();
+    testNestedThreads();
+    std::cout << "All slice scheduler tests passed.\n";
+    return 0;
+}
@@ -0,0 +1,108 @@
+#include "../include/SnapshotStore.h"
+#include "../include/HeatEquationSolver.h"
+#include "../include/MaterialProperties.h"
+#include "../include/BoundaryConditions.h"
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+// Fields of a 60 s run at dt = 0.5 for one slice, one per step
+static std::vector<std::vector<double>> sliceFields(int slice, std::vector<double>& xGrid) {
+    MaterialProperties props;
+    Stack stack = props.getStack(1);
+    props.generateGrid(stack, 10);
+    xGrid = stack.xGrid;
+    HeatEquationSolver solver(1.0);
+    solver.initialize(stack, TimeHandler(60.0, 0.5, false));
+    solver.setInitialTemperature(std::vector<double>(stack.xGrid.size(), 300.0));
+    solver.setBoundaryConditions(new DirichletCondition(900.0 + 100.0 * slice), new NeumannCondition(0.0));
+    std::vector<std::vector<double>> fields;
+    while (!solver.isFinished()) {
+        solver.step();
+        fields.push_back(solver.getTemperatureDistribution());
+    }
+    return fields;
+}
+
+void testBoundedErrorRandomAccess() {
+    const std::string path = "test_snapshots.bin";
+    std::vector<double> xGrid;
+    std::vector<std::vector<double>> fields[3];
+    for (int s = 0; s < 3; ++s) fields[s] = sliceFields(s, xGrid);
+
+    SnapshotOptions options;
+    options.quantum = 0.01;
+    options.chunkFrames = 16;
+    SnapshotWriter writer(path, options);
+    assert(writer.isOpen());
+    std::vector<std::thread> threads;
+    for (int s = 0; s < 3; ++s) {
+        threads.emplace_back([&, s] {
+            writer.setGrid(s, xGrid);
+            for (std::size_t f = 0; f < fields[s].size(); ++f) writer.record(s, 0.5 * (f + 1), fields[s][f]);
+        });
+    }
+    for (auto& t : threads) t.join();
+    assert(writer.close());
+    assert(writer.getWrittenFrames() == 3 * fields[0].size());
+    assert(writer.getWrittenBytes() < writer.getRawBytes() / 3 && "Quantized fields must compress");
+
+    SnapshotReader reader(path);
+    assert(reader.isOpen() && reader.getSlices().size() == 3);
+    assert(reader.getGrid(1) == xGrid && reader.getNodeCount(1) == xGrid.size());
+    TemperatureDistribution field;
+    // Out of order, across chunks and slices
+    for (std::size_t f : { std::size_t(100), std::size_t(3), std::size_t(119), std::size_t(16), std::size_t(0) }) {
+        for (int s : { 2, 0, 1 }) {
+            assert(reader.read(s, f, field));
+            for (std::size_t i = 0; i < field.data().size(); ++i) {
+                assert(std::fabs(field.data()[i] - fields[s][f][i]) <= 0.005 + 1e-9 && "Error must stay within quantum/2");
+            }
+        }
+    }
+    assert(reader.findFrame(0, 10.2) == 19 && reader.getFrameTime(0, 19) == 10.0);
+    assert(reader.findFrame(0, 0.0) == 0);
+    assert(!reader.read(0, fields[0].size(), field) && !reader.read(7, 0, field));
+    std::remove(path.c_str());
+    std::cout << "Snapshot bounded-error test passed.\n";
+}
+
+void testLosslessAndDecimation() {
+    const std::string path = "test_snapshots_lossless.bin";
+    std::vector<double> xGrid;
+    std::vector<std::vector<double>> fields = sliceFields(0, xGrid);
+
+    SnapshotOptions options;
+    options.quantum = 0.0;
+    options.every = 7;
+    {
+        SnapshotWriter writer(path, options);
+        for (std::size_t f = 0; f < fields.size(); ++f) writer.record(5, 0.5 * (f + 1), fields[f]);
+    }
+
+    SnapshotReader reader(path);
+    assert(reader.isOpen() && reader.getGrid(5).empty());
+    // Frames 0, 7, 14, ... and the last offered one
+    std::size_t frames = reader.getFrameCount(5);
+    assert(frames == (fields.size() - 1) / 7 + 1 + ((fields.size() - 1) % 7 != 0));
+    assert(reader.getFrameTime(5, frames - 1) == 0.5 * fields.size());
+    TemperatureDistribution field;
+    assert(reader.read(5, 1, field) && field.data() == fields[7]);
+    assert(reader.read(5, frames - 1, field) && field.data() == fields.back());
+
+    // A truncated file is rejected
+    { std::ofstream out(path, std::ios::binary | std::ios::trunc); out << "HSSN"; }
+    assert(!SnapshotReader(path).isOpen());
+    std::remove(path.c_str());
+    std::cout << "Snapshot lossless/decimation test passed.\n";
+}
+
+int main() {
+    testBoundedErrorRandomAccess();
+    testLosslessAndDecimation();
+    std::cout << "All snapshot store tests passed.\n";
+    return 0;
+}
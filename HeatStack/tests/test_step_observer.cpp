@@ -0,0 +1,92 @@
+#include "../include/StepObserver.h"
+#include "../include/HeatEquationSolver.h"
+#include "../include/MaterialProperties.h"
+#include "../include/BoundaryConditions.h"
+#include <cassert>
+#include <iostream>
+
+static Stack makeStack() {
+    MaterialProperties props;
+    Stack stack = props.getStack(1);
+    props.generateGrid(stack, 10);
+    return stack;
+}
+
+static void setup(HeatEquationSolver& solver, const Stack& stack, double total) {
+    solver.initialize(stack, TimeHandler(total, 0.5, false));
+    solver.setInitialTemperature(std::vector<double>(stack.xGrid.size(), 300.0));
+    solver.setBoundaryConditions(new DirichletCondition(1000.0), new NeumannCondition(0.0));
+}
+
+void testRunMatchesStepping() {
+    Stack stack = makeStack();
+    HeatEquationSolver stepped(1.0), run(1.0);
+    setup(stepped, stack, 60.0);
+    setup(run, stack, 60.0);
+    while (!stepped.isFinished()) stepped.step();
+
+    // Callbacks see every step, in order
+    int calls = 0;
+    double lastTime = 0.0;
+    CallbackObserver<double> history([&](double time, const std::vector<double>& T) {
+        assert(time > lastTime && T.size() == stack.xGrid.size());
+        lastTime = time;
+        ++calls;
+        return true;
+    });
+    RunResult result = run.run({ &history });
+    assert(result.reason == StopReason::Finished && result.observer == -1);
+    assert(result.steps == 120 && calls == 120 && result.time == run.getCurrentTime());
+    assert(run.getTemperatureDistribution() == stepped.getTemperatureDistribution());
+    std::cout << "Observed run test passed.\n";
+}
+
+void testLimitStopsEarly() {
+    Stack stack = makeStack();
+    int node = static_cast<int>(stack.xGrid.size()) / 3;
+    HeatEquationSolver solver(1.0);
+    setup(solver, stack, 600.0);
+
+    int calls = 0;
+    CallbackObserver<double> history([&](double, const std::vector<double>&) { ++calls; return true; });
+    LimitMonitor<double> limits;
+    limits.addLimit("inner", static_cast<int>(stack.xGrid.size()) - 1, 1e9);
+    limits.addLimit("probe", node, 320.0);
+    RunResult result = solver.run({ &limits, &history });
+    assert(result.reason == StopReason::Observer && result.observer == 0);
+    assert(limits.exceededLimit() == 1 && result.detail.find("probe") == 0);
+    assert(result.time < 600.0 && calls == result.steps && "Later observers still see the last step");
+    assert(solver.getTemperatureDistribution()[node] >= 320.0);
+
+    // The step before had not reached it
+    HeatEquationSolver replay(1.0);
+    setup(replay, stack, result.time - 0.5);
+    replay.run();
+    assert(replay.getTemperatureDistribution()[node] < 320.0);
+    std::cout << "Limit monitor test passed.\n";
+}
+
+void testSteadyState() {
+    Stack stack = makeStack();
+    HeatEquationSolver solver(1.0);
+    setup(solver, stack, 1e7);
+    SteadyStateMonitor<double> steady(1e-3);
+    RunResult result = solver.run({ &steady });
+    assert(result.reason == StopReason::Observer && result.time < 1e7);
+    assert(!result.detail.empty());
+
+    // The solver's own tolerance is reported as such
+    HeatEquationSolver own(1.0);
+    setup(own, stack, 1e7);
+    own.setSteadyStateTolerance(1e-3);
+    assert(own.run().reason == StopReason::SteadyState);
+    std::cout << "Steady-state monitor test passed.\n";
+}
+
+int main() {
+    testRunMatchesStepping();
+    testLimitStopsEarly();
+    testSteadyState();
+    std::cout << "All step observer tests passed.\n";
+    return 0;
+}
@@ -0,0 +1,128 @@
+#include "../include/SurrogateTable.h"
+#include "../include/TemperatureComparator.h"
+#include "../include/MaterialProperties.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+// Small table: 60 s at dt = 1 s on a 5-point grid builds in well under a second
+static SurrogateSpec smallSpec() {
+    SurrogateSpec spec;
+    spec.tpsPoints = 24;
+    spec.lLPointsPerSegment = 5;
+    spec.maxDuration = 60.0;
+    spec.durationPoints = 11;
+    spec.dt = 1.0;
+    spec.pointsPerLayer = 5;
+    spec.validationSamples = 16;
+    return spec;
+}
+
+static Stack sliceStack(const MaterialProperties& props, double lL, double tps) {
+    Stack s = props.getStack(1);
+    s.layers[0].thickness = tps;
+    s.layers[1].thickness = props.getCarbonFiberThickness(lL);
+    s.layers[2].thickness = props.getGlueThickness(lL);
+    s.layers[3].thickness = props.getSteelThickness(lL);
+    MaterialProperties gridProps;
+    gridProps.generateGrid(s, 5);
+    return s;
+}
+
+static TemperatureComparator makeComparator() {
+    TemperatureComparator comp;
+    comp.setTimeStep(1.0, false);
+    comp.setGridResolution(5);
+    return comp;
+}
+
+void testNodeMatchesSolve(const SurrogateTable& table) {
+    // l/L = 0.52 is node 2 of the [0.48, 0.56] segment, 15 s is duration node 5
+    MaterialProperties props;
+    const SurrogateSpec& spec = table.getSpec();
+    double tps = std::exp(std::log(spec.minTPS) + std::log(spec.maxTPS / spec.minTPS) * 6 / (spec.tpsPoints - 1));
+    double lL = 0.52, duration = 15.0;
+    Stack s = sliceStack(props, lL, tps);
+
+    TemperatureComparator comp = makeComparator();
+    std::vector<double> T = comp.runSimulation(s, duration, 1.0, lL);
+    InterfaceTemperatures interp;
+    assert(table.interpolate(s, lL, duration, interp));
+    assert(std::fabs(interp.steel - T.back()) < 1e-3);
+    assert(std::fabs(interp.carbonGlue - T[8]) < 1e-3 || std::fabs(interp.carbonGlue - T[9]) < 1e-3);
+
+    // Outside the axes
+    assert(!table.interpolate(sliceStack(props, lL, 1.0), lL, duration, interp));
+    assert(!table.interpolate(s, lL, 120.0, interp));
+    assert(table.getMaxError() >= table.getRmsError() && table.getRmsError() > 0.0);
+    std::cout << "Surrogate node test passed.\n";
+}
+
+void testSaveLoadRoundTrip(const SurrogateTable& table) {
+    const std::string path = "test_surrogate_table.bin";
+    assert(table.save(path));
+    SurrogateTable loaded;
+    assert(loaded.load(path));
+    assert(loaded.getMaxError() == table.getMaxError());
+    assert(loaded.getSpec().tpsPoints == table.getSpec().tpsPoints);
+
+    MaterialProperties props;
+    for (double lL : { 0.1, 0.33, 0.97 }) {
+        Stack s = sliceStack(props, lL, 0.004);
+        InterfaceTemperatures a, b;
+        assert(table.interpolate(s, lL, 42.0, a) && loaded.interpolate(s, lL, 42.0, b));
+        assert(a.carbonGlue == b.carbonGlue && a.glueSteel == b.glueSteel && a.steel == b.steel);
+    }
+
+    // A truncated file is rejected and leaves the table as it was
+    { std::ofstream out(path, std::ios::binary | std::ios::trunc); out << "HSSURR"; }
+    assert(!loaded.load(path));
+    assert(!loaded.empty());
+    std::remove(path.c_str());
+    std::cout << "Surrogate save/load test passed.\n";
+}
+
+void testComparatorConfirmsSurrogate(const SurrogateTable& table) {
+    MaterialProperties props;
+    double lL = 0.5;
+    Stack s = sliceStack(props, lL, props.getTPSThickness(lL));
+
+    TemperatureComparator comp = makeComparator();
+    comp.setSurrogate(&table);
+    double t = comp.suggestTPSThickness(s, 800.0, 400.0, 350.0, 60.0, lL, props, 1.0);
+    assert(comp.lastSuggestionFromSurrogate());
+
+    // The confirmed thickness meets every limit
+    Stack check = sliceStack(props, lL, t);
+    std::vector<double> T = comp.runSimulation(check, 60.0, 1.0, lL);
+    size_t idxCG = std::lower_bound(check.xGrid.begin(), check.xGrid.end(),
+                                    t + check.layers[1].thickness) - check.xGrid.begin();
+    assert(T[idxCG] < 350.0 && T.back() < 800.0);
+
+    // Other settings than the table's: the usual search
+    TemperatureComparator other;
+    other.setTimeStep(0.5, false);
+    other.setGridResolution(5);
+    other.setSurrogate(&table);
+    TemperatureComparator plain;
+    plain.setTimeStep(0.5, false);
+    plain.setGridResolution(5);
+    double tOther = other.suggestTPSThickness(s, 800.0, 400.0, 350.0, 60.0, lL, props, 1.0);
+    assert(!other.lastSuggestionFromSurrogate());
+    assert(tOther == plain.suggestTPSThickness(s, 800.0, 400.0, 350.0, 60.0, lL, props, 1.0));
+    std::cout << "Surrogate comparator test passed.\n";
+}
+
+int main() {
+    MaterialProperties props;
+    SurrogateTable table = SurrogateTable::build(smallSpec(), props.getStack(1), props);
+    assert(!table.empty());
+    testNodeMatchesSolve(table);
+    testSaveLoadRoundTrip(table);
+    testComparatorConfirmsSurrogate(table);
+    std::cout << "All surrogate table tests passed.\n";
+    return 0;
+}
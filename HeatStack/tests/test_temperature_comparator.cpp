@@ -0,0 +1,201 @@
+#include "../include/TemperatureComparator.h"
+#include "../include/MaterialProperties.h"
+#include "../include/SimulationCache.h"
+#include "../include/Profiler.h"
+#include <array>
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <string>
+#include <vector>
+
+// A counter's total from Profiler::summary()
+static unsigned long long counterTotal(const std::string& name) {
+    std::string s = Profiler::summary();
+    std::size_t at = s.find(name + " ", s.find("Counters: "));
+    assert(at != std::string::npos);
+    return std::stoull(s.substr(at + name.size() + 1));
+}
+
+// Whether stack with this TPS thickness stays below 800/400/350 K (the
+// steel, glue and carbon limits of the searches here)
+static bool meetsLimits(Stack stack, double thickness, double duration, double lL) {
+    MaterialProperties props;
+    stack.layers[0].thickness = thickness;
+    props.generateGrid(stack, 5);
+    TemperatureComparator comp;
+    comp.setTimeStep(1.0, false);
+    comp.setGridResolution(5);
+    std::vector<double> T = comp.runSimulation(stack, duration, 1.0, lL);
+    std::array<int, 3> nodes = interfaceNodes(stack);
+    return T[nodes[0]] < 350.0 && T[nodes[1]] < 400.0 && T[nodes[2]] < 800.0;
+}
+
+void testKSectionMatchesBisection() {
+    MaterialProperties props;
+    Stack stack = props.getStack(1);
+    double lL = 0.5;
+    stack.layers[1].thickness = props.getCarbonFiberThickness(lL);
+    stack.layers[2].thickness = props.getGlueThickness(lL);
+    stack.layers[3].thickness = props.getSteelThickness(lL);
+
+    TemperatureComparator serial;
+    serial.setTimeStep(1.0, false);
+    serial.setGridResolution(5);
+    double tSerial = serial.suggestTPSThickness(stack, 800.0, 400.0, 350.0, 60.0, lL, props, 1.0);
+
+    TemperatureComparator parallel;
+    parallel.setTimeStep(1.0, false);
+    parallel.setGridResolution(5);
+    parallel.setSearchWays(4);
+    parallel.setSearchThreads(3);
+    double tParallel = parallel.suggestTPSThickness(stack, 800.0, 400.0, 350.0, 60.0, lL, props, 1.0);
+
+    // Both return the passing end of a bracket narrower than the tolerance
+    // around the same threshold
+    assert(meetsLimits(stack, tSerial, 60.0, lL) && meetsLimits(stack, tParallel, 60.0, lL));
+    assert(std::fabs(tSerial - tParallel) <= 1e-5);
+    std::cout << "k-section TPS search test passed.\n";
+}
+
+void testMixedPrecisionMatchesDouble() {
+    MaterialProperties props;
+    for (double lL : { 0.2, 0.7 }) {
+        Stack stack = props.getStack(1);
+        stack.layers[1].thickness = props.getCarbonFiberThickness(lL);
+        stack.layers[2].thickness = props.getGlueThickness(lL);
+        stack.layers[3].thickness = props.getSteelThickness(lL);
+
+        double t[3];
+        SearchPrecision modes[3] = { SearchPrecision::Double, SearchPrecision::Mixed, SearchPrecision::Float };
+        for (int m = 0; m < 3; ++m) {
+            TemperatureComparator comp;
+            comp.setTimeStep(1.0, false);
+            comp.setGridResolution(5);
+            comp.setPrecision(modes[m]);
+            t[m] = comp.suggestTPSThickness(stack, 800.0, 400.0, 350.0, 60.0, lL, props, 1.0);
+        }
+        // Mixed re-checks close calls in double, so it lands on the same thickness
+        assert(t[1] == t[0] && "Mixed precision must reproduce the double search");
+        assert(std::fabs(t[2] - t[0]) <= 1e-3);
+    }
+    std::cout << "Mixed precision TPS search test passed.\n";
+}
+
+void testNewtonNeedsFewerTrials() {
+    MaterialProperties props;
+    size_t bisectTrials = 0, newtonTrials = 0;
+    for (double lL : { 0.2, 0.5, 0.9 }) {
+        Stack stack = props.getStack(1);
+        stack.layers[1].thickness = props.getCarbonFiberThickness(lL);
+        stack.layers[2].thickness = props.getGlueThickness(lL);
+        stack.layers[3].thickness = props.getSteelThickness(lL);
+
+        double t[2];
+        SearchMethod methods[2] = { SearchMethod::Bisection, SearchMethod::Newton };
+        for (int m = 0; m < 2; ++m) {
+            SimulationCache cache; // Misses count the trial solves
+            TemperatureComparator comp;
+            comp.setTimeStep(1.0, false);
+            comp.setGridResolution(5);
+            comp.setCache(&cache);
+            comp.setSearchMethod(methods[m]);
+            t[m] = comp.suggestTPSThickness(stack, 800.0, 400.0, 350.0, 60.0, lL, props, 1.0);
+            (m == 0 ? bisectTrials : newtonTrials) += cache.getStats().misses;
+        }
+        // Both bracket a passing thickness; the grid's node rounding makes
+        // the limit crossing ragged, so they need not share one bracket
+        assert(std::fabs(t[1] - t[0]) <= 2e-3);
+    }
+    assert(newtonTrials < bisectTrials && "Newton search must save trial solves");
+    std::cout << "Newton TPS search test passed.\n";
+}
+
+void testEarlyStopKeepsVerdicts() {
+    MaterialProperties props;
+    Profiler::enable(true);
+    for (double lL : { 0.1, 0.6 }) {
+        Stack stack = props.getStack(1);
+        stack.layers[1].thickness = props.getCarbonFiberThickness(lL);
+        stack.layers[2].thickness = props.getGlueThickness(lL);
+        stack.layers[3].thickness = props.getSteelThickness(lL);
+        for (int ways : { 2, 4 }) {
+            for (SearchPrecision p : { SearchPrecision::Double, SearchPrecision::Mixed }) {
+                double t[2];
+                unsigned long long steps[2];
+                for (int stop = 0; stop < 2; ++stop) {
+                    Profiler::reset();
+                    TemperatureComparator comp;
+                    comp.setTimeStep(1.0, false);
+                    comp.setGridResolution(5);
+                    comp.setSearchWays(ways);
+                    comp.setPrecision(p);
+                    comp.setEarlyStop(stop == 1);
+                    t[stop] = comp.suggestTPSThickness(stack, 800.0, 400.0, 350.0, 120.0, lL, props, 1.0);
+                    steps[stop] = counterTotal("solver steps");
+                    assert((counterTotal("early stops") > 0) == (stop == 1));
+                }
+                assert(t[1] == t[0] && "Stopping failed trials early must not change the answer");
+                assert(steps[1] < steps[0]);
+            }
+        }
+    }
+
+    // Crank-Nicolson can overshoot and fall back: trials run to the end
+    Profiler::reset();
+    Stack stack = props.getStack(1);
+    TemperatureComparator comp;
+    comp.setTimeStep(1.0, false);
+    comp.setGridResolution(5);
+    comp.suggestTPSThickness(stack, 800.0, 400.0, 350.0, 60.0, 0.5, props, 0.5);
+    assert(counterTotal("early stops") == 0);
+    Profiler::enable(false);
+    std::cout << "Early stop test passed.\n";
+}
+
+void testSearchResumesFromProgress() {
+    MaterialProperties props;
+    double lL = 0.5;
+    Stack stack = props.getStack(1);
+    stack.layers[1].thickness = props.getCarbonFiberThickness(lL);
+    stack.layers[2].thickness = props.getGlueThickness(lL);
+    stack.layers[3].thickness = props.getSteelThickness(lL);
+
+    for (SearchMethod m : { SearchMethod::Bisection, SearchMethod::Newton }) {
+        TemperatureComparator whole;
+        whole.setTimeStep(1.0, false);
+        whole.setGridResolution(5);
+        whole.setSearchMethod(m);
+        double tWhole = whole.suggestTPSThickness(stack, 800.0, 400.0, 350.0, 60.0, lL, props, 1.0);
+
+        // Stop after five rounds (as a killed run would), then resume
+        SearchProgress progress;
+        struct Stop {};
+        TemperatureComparator first;
+        first.setTimeStep(1.0, false);
+        first.setGridResolution(5);
+        first.setSearchMethod(m);
+        first.setSearchProgress(&progress, [&] { if (progress.rounds == 5) throw Stop(); });
+        try { first.suggestTPSThickness(stack, 800.0, 400.0, 350.0, 60.0, lL, props, 1.0); assert(false); }
+        catch (const Stop&) {}
+
+        TemperatureComparator resumed;
+        resumed.setTimeStep(1.0, false);
+        resumed.setGridResolution(5);
+        resumed.setSearchMethod(m);
+        resumed.setSearchProgress(&progress);
+        assert(resumed.suggestTPSThickness(stack, 800.0, 400.0, 350.0, 60.0, lL, props, 1.0) == tWhole);
+        assert(progress.rounds > 5);
+    }
+    std::cout << "Resumed TPS search test passed.\n";
+}
+
+int main() {
+    testKSectionMatchesBisection();
+    testMixedPrecisionMatchesDouble();
+    testNewtonNeedsFewerTrials();
+    testSearchResumesFromProgress();
+    testEarlyStopKeepsVerdicts();
+    std::cout << "All temperature comparator tests passed.\n";
+    return 0;
+}
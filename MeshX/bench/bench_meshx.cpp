@@ -0,0 +1,319 @@
+// MeshXBench: throughput, memory and thread-scaling benchmarks for the MeshX
+// pipeline on synthetic tori from 10k faces up. Not part of the GUI; run it
+// by hand and compare the numbers against a previous build.
+//
+//   MeshXBench [--quick] [--filter <name>] [--max-faces <n>] [--threads <n>]
+//
+// Peak RSS is the process high-water mark when a benchmark finishes, so it
+// only grows along a run; use --filter to see one benchmark's own peak.
+#include "AdaptiveMeshGenerator.h"
+#include "Mesh.h"
+#include "MeshBooleanOperations.h"
+#include "MeshConverter.h"
+#include "MeshIO.h"
+#include "MeshValidator.h"
+#include "ObjExporter.h"
+#include "ObjParser.h"
+#include <tbb/task_arena.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+// Keep the optimizer from discarding benchmark results
+static volatile double g_sink = 0.0;
+
+struct BenchResult {
+    std::string name;
+    long long iterations;
+    double totalNs;
+    double items;   // work items (faces, tetrahedra) per iteration
+    double peakMb;
+};
+
+static double peakRssMb() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return counters.PeakWorkingSetSize / (1024.0 * 1024.0);
+    return 0.0;
+#else
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss / (1024.0 * 1024.0); // bytes
+#else
+    return usage.ru_maxrss / 1024.0;            // kilobytes
+#endif
+#endif
+}
+
+// Run body() with the iteration count doubled until at least minMs elapses;
+// body(n) runs n iterations and is timed as a whole. The large meshes take
+// longer than minMs on their own, so they run once and without warm-up.
+static BenchResult measure(const std::string& name, double minMs, double items,
+                           const std::function<void(long long)>& body) {
+    long long n = 1;
+    for (;;) {
+        auto start = Clock::now();
+        body(n);
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        if (ns >= minMs * 1e6 || n >= (1LL << 20)) return { name, n, ns, items, peakRssMb() };
+        n *= 2;
+    }
+}
+
+static void report(const BenchResult& r) {
+    double msPerIter = r.totalNs / r.iterations / 1e6;
+    std::printf("%-52s %8lld %12.2f %14.3f %10.1f\n",
+                r.name.c_str(), r.iterations, msPerIter,
+                r.items / (msPerIter * 1e3), r.peakMb);
+}
+
+static std::string facesLabel(std::size_t faces) {
+    if (faces >= 1000000) return std::to_string(faces / 1000000) + "M";
+    return std::to_string(faces / 1000) + "k";
+}
+
+// Thread counts 1, 2, 4, ... up to the limit (0: hardware threads)
+static std::vector<int> threadCounts(int limit) {
+    int hw = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    int top = limit > 0 ? limit : hw;
+    std::vector<int> counts;
+    for (int t = 1; t < top; t *= 2) counts.push_back(t);
+    counts.push_back(top);
+    return counts;
+}
+
+// Closed triangulated torus with about targetFaces faces (8 k^2 for k tube
+// segments and 4k ring segments), centred at offset.
+static Mesh makeTorus(std::size_t targetFaces, double offset = 0.0) {
+    const int k = std::max(3, static_cast<int>(std::lround(std::sqrt(targetFaces / 8.0))));
+    const int ring = 4 * k, tube = k;
+    const double R = 2.0, r = 0.7, twoPi = 6.283185307179586;
+    Mesh mesh;
+    mesh.vertices.reserve(static_cast<std::size_t>(ring) * tube);
+    for (int i = 0; i < ring; ++i) {
+        double u = twoPi * i / ring;
+        for (int j = 0; j < tube; ++j) {
+            double v = twoPi * j / tube;
+            mesh.vertices.push_back({ (R + r * std::cos(v)) * std::cos(u) + offset,
+                                      (R + r * std::cos(v)) * std::sin(u) + 0.3 * offset,
+                                      r * std::sin(v) + 0.2 * offset });
+        }
+    }
+    mesh.faces.reserve(2 * static_cast<std::size_t>(ring) * tube, 6 * static_cast<std::size_t>(ring) * tube);
+    auto index = [&](int i, int j) { return (i % ring) * tube + (j % tube); };
+    for (int i = 0; i < ring; ++i) {
+        for (int j = 0; j < tube; ++j) {
+            int a = index(i, j), b = index(i + 1, j), c = index(i + 1, j + 1), d = index(i, j + 1);
+            mesh.faces.addFace({ FaceElement(a), FaceElement(b), FaceElement(c) });
+            mesh.faces.addFace({ FaceElement(a), FaceElement(c), FaceElement(d) });
+        }
+    }
+    return mesh;
+}
+
+// ---- Benchmarks ----
+
+static void benchParse(const std::vector<std::size_t>& sizes, const std::string& dir, int threads,
+                       double minMs, std::vector<BenchResult>& out) {
+    for (std::size_t size : sizes) {
+        Mesh mesh = makeTorus(size);
+        const double faces = static_cast<double>(mesh.faces.size());
+        std::string file = dir + "/torus_" + facesLabel(size) + ".obj";
+        if (!ObjExporter::exportMesh(mesh, file)) continue;
+        mesh = Mesh();
+
+        ObjParser streaming;
+        streaming.setMode(ObjParser::Mode::Streaming);
+        out.push_back(measure("ObjParser::parse streaming f=" + facesLabel(size), minMs, faces,
+            [&](long long iters) {
+                for (long long k = 0; k < iters; ++k) g_sink = g_sink + streaming.parse(file).faces.size();
+            }));
+        for (int t : threadCounts(threads)) {
+            ObjParser parser;
+            parser.setThreadCount(static_cast<unsigned>(t));
+            out.push_back(measure("ObjParser::parse f=" + facesLabel(size) + " t=" + std::to_string(t), minMs, faces,
+                [&](long long iters) {
+                    for (long long k = 0; k < iters; ++k) g_sink = g_sink + parser.parse(file).faces.size();
+                }));
+        }
+    }
+}
+
+static void benchValidate(const std::vector<std::size_t>& sizes, int threads, double minMs,
+                          std::vector<BenchResult>& out) {
+    for (std::size_t size : sizes) {
+        Mesh mesh = makeTorus(size);
+        const double faces = static_cast<double>(mesh.faces.size());
+        for (int t : threadCounts(threads)) {
+            tbb::task_arena arena(t);
+            const std::string suffix = " f=" + facesLabel(size) + " t=" + std::to_string(t);
+            out.push_back(measure("MeshValidator::check topology" + suffix, minMs, faces,
+                [&](long long iters) {
+                    arena.execute([&] {
+                        for (long long k = 0; k < iters; ++k)
+                            g_sink = g_sink + MeshValidator::check(mesh, MeshValidator::ClosedSurface |
+                                                                         MeshValidator::Orientation).faceErrors.size();
+                    });
+                }));
+            out.push_back(measure("MeshValidator::check all" + suffix, minMs, faces,
+                [&](long long iters) {
+                    arena.execute([&] {
+                        for (long long k = 0; k < iters; ++k)
+                            g_sink = g_sink + MeshValidator::check(mesh).faceErrors.size();
+                    });
+                }));
+        }
+        out.push_back(measure("MeshValidator::validate f=" + facesLabel(size), minMs, faces,
+            [&](long long iters) {
+                for (long long k = 0; k < iters; ++k) g_sink = g_sink + MeshValidator::validate(mesh).size();
+            }));
+    }
+}
+
+static void benchConvert(const std::vector<std::size_t>& sizes, const std::string& dir, double minMs,
+                         std::vector<BenchResult>& out) {
+    for (std::size_t size : sizes) {
+        Mesh mesh = makeTorus(size);
+        const double faces = static_cast<double>(mesh.faces.size());
+        MeshConverter converter;
+        out.push_back(measure("MeshConverter Mesh->Polyhedron->Mesh f=" + facesLabel(size), minMs, faces,
+            [&](long long iters) {
+                for (long long k = 0; k < iters; ++k) {
+                    MeshBooleanOperations::Polyhedron poly;
+                    Mesh back;
+                    converter.convertMeshToPolyhedron(mesh, poly);
+                    converter.convertPolyhedronToMesh(poly, back);
+                    g_sink = g_sink + back.faces.size();
+                }
+            }));
+
+        std::string obj = dir + "/convert_" + facesLabel(size) + ".obj";
+        std::string off = dir + "/convert_" + facesLabel(size) + ".off";
+        std::string objBack = dir + "/convert_" + facesLabel(size) + "_back.obj";
+        if (!ObjExporter::exportMesh(mesh, obj)) continue;
+        out.push_back(measure("MeshConverter OBJ->OFF->OBJ f=" + facesLabel(size), minMs, faces,
+            [&](long long iters) {
+                for (long long k = 0; k < iters; ++k)
+                    g_sink = g_sink + (converter.convertObjToOff(obj, off) && converter.convertOffToObj(off, objBack));
+            }));
+    }
+}
+
+static void benchBoolean(const std::vector<std::size_t>& sizes, double minMs, std::vector<BenchResult>& out) {
+    typedef bool (*Operation)(const std::vector<MeshBooleanOperations::Polyhedron>&,
+                              MeshBooleanOperations::Polyhedron&);
+    const std::pair<const char*, Operation> operations[] = {
+        { "union", &MeshBooleanOperations::computeUnion },
+        { "intersection", &MeshBooleanOperations::computeIntersection },
+        { "difference", &MeshBooleanOperations::computeDifference }
+    };
+    for (std::size_t size : sizes) {
+        MeshConverter converter;
+        std::vector<MeshBooleanOperations::Polyhedron> operands(2);
+        converter.convertMeshToPolyhedron(makeTorus(size), operands[0]);
+        converter.convertMeshToPolyhedron(makeTorus(size, 1.0), operands[1]);
+        const double faces = static_cast<double>(operands[0].size_of_facets() + operands[1].size_of_facets());
+        for (const auto& operation : operations) {
+            out.push_back(measure(std::string("MeshBooleanOperations ") + operation.first + " f=2x" + facesLabel(size),
+                                  minMs, faces,
+                [&](long long iters) {
+                    for (long long k = 0; k < iters; ++k) {
+                        MeshBooleanOperations::Polyhedron result;
+                        operation.second(operands, result);
+                        g_sink = g_sink + result.size_of_facets();
+                    }
+                }));
+        }
+    }
+}
+
+static void benchVolume(std::size_t size, const std::string& dir, int threads, bool quick,
+                        std::vector<BenchResult>& out) {
+    std::string file = dir + "/volume_" + facesLabel(size) + ".off";
+    if (!MeshIO::write(file, makeTorus(size))) return;
+    AdaptiveMeshGenerator::Options options;
+    options.cubeSize = 4.0;
+    options.sizingField = quick ? 0.5 : 0.25;
+    for (int t : threadCounts(threads)) {
+        options.threads = t;
+        // One run; reported per generated tetrahedron
+        Mesh volume;
+        AdaptiveMeshGenerator generator;
+        auto start = Clock::now();
+        bool ok = generator.generateVolumeMesh(file, options, "", nullptr, &volume);
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        if (!ok) {
+            std::cerr << "AdaptiveMeshGenerator failed with " << t << " threads\n";
+            continue;
+        }
+        out.push_back({ "AdaptiveMeshGenerator tets=" + std::to_string(volume.tetrahedrons.size()) +
+                        " f=" + facesLabel(size) + " t=" + std::to_string(t),
+                        1, ns, static_cast<double>(volume.tetrahedrons.size()), peakRssMb() });
+    }
+}
+
+int main(int argc, char* argv[]) {
+    bool quick = false;
+    std::string filter;
+    std::size_t maxFaces = 1000000;
+    int nThreads = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--quick") == 0) quick = true;
+        else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) filter = argv[++i];
+        else if (std::strcmp(argv[i], "--max-faces") == 0 && i + 1 < argc) maxFaces = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) nThreads = std::atoi(argv[++i]);
+        else {
+            std::cerr << "Usage: MeshXBench [--quick] [--filter <name>] [--max-faces <n>] [--threads <n>]\n";
+            return 1;
+        }
+    }
+    if (quick) maxFaces = std::min<std::size_t>(maxFaces, 100000);
+    double minMs = quick ? 20.0 : 200.0;
+    auto selected = [&](const char* group) {
+        return filter.empty() || std::string(group).find(filter) != std::string::npos;
+    };
+
+    // 10k, 100k, 1M, 10M faces, up to --max-faces; the CGAL booleans and the
+    // volume mesher only run on the small end
+    std::vector<std::size_t> sizes;
+    for (std::size_t size = 10000; size <= maxFaces && size <= 10000000; size *= 10) sizes.push_back(size);
+    std::vector<std::size_t> booleanSizes(sizes.begin(), sizes.begin() + std::min<std::size_t>(sizes.size(), 2));
+
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "meshx_bench";
+    std::filesystem::create_directories(dir);
+
+    std::vector<BenchResult> results;
+    if (selected("parse"))    benchParse(sizes, dir.string(), nThreads, minMs, results);
+    if (selected("validate")) benchValidate(sizes, nThreads, minMs, results);
+    if (selected("convert"))  benchConvert(sizes, dir.string(), minMs, results);
+    if (selected("boolean"))  benchBoolean(booleanSizes, minMs, results);
+    if (selected("volume") && !sizes.empty()) benchVolume(sizes.front(), dir.string(), nThreads, quick, results);
+
+    std::error_code ec;
+    std::filesystem::remove_all(dir, ec);
+
+    std::printf("%-52s %8s %12s %14s %10s\n",
+                "benchmark", "iters", "ms/iter", "Mitems/s", "peak MB");
+    for (const auto& r : results) report(r);
+    return 0;
+}
@@ -10,7 +10,11 @@
  #ifndef ADAPTIVE_MESH_GENERATOR_H
  #define ADAPTIVE_MESH_GENERATOR_H
  
+ #include <atomic>
+ #include <future>
+ #include <memory>
  #include <string>
+ #include "Mesh.h"
  #include <CGAL/Exact_predicates_inexact_constructions_kernel.h>
  #include <CGAL/Surface_mesh.h>
  #include <CGAL/Mesh_polyhedron_3.h>
@@ -57,17 +61,97 @@
       */
      AdaptiveMeshGenerator();
  
+     /**
+      * @struct Options
+      * @brief Size of the outer cube, meshing criteria and threads.
+      *
+      * The sizing field (Sizing_field_with_aabb_tree) bounds the edge, facet
+      * and cell sizes: smaller values give denser meshes and longer runs.
+      */
+     struct Options {
+         double cubeSize = 10.0;            ///< Half-size of the cube (from -cubeSize to cubeSize)
+         double sizingField = 0.7;          ///< Base size of the adaptive sizing field
+         double edgeDistance = 0.01;        ///< Largest distance of feature edges to the input
+         double facetAngle = 25.0;          ///< Smallest facet angle in degrees
+         double facetDistance = 0.01;       ///< Largest distance of facets to the input
+         double cellRadiusEdgeRatio = 3.0;  ///< Largest circumradius / shortest edge of a cell
+         int threads = 0;                   ///< TBB arena size; 0 uses all hardware threads
+     };
+
+     /**
+      * @brief Steps of a generation, in order.
+      */
+     enum Stage {
+         Reading,    ///< Reading the inner mesh
+         Difference, ///< Computing cube \ inner
+         Domain,     ///< Building the mesh domain
+         Meshing,    ///< Running make_mesh_3
+         Writing,    ///< Writing the output file
+         Done,       ///< Finished (successfully or not)
+         StageCount
+     };
+
+     /**
+      * @struct Progress
+      * @brief State shared between a running generation and its caller.
+      */
+     struct Progress {
+         std::atomic<int> stage{Reading};     ///< Current Stage
+         std::atomic<bool> cancelled{false};  ///< Set by the caller to stop the generation
+     };
+
+     /**
+      * @brief Returns a display name of a stage.
+      */
+     static const char* stageName(int stage);
+ 
      /**
       * @brief Generates the volume mesh by computing the Boolean difference (cube \ inner).
       *
-      * @param innerMeshFile Path to the inner mesh OFF file.
-      * @param cubeSize Half-size of the cube (cube extends from -cubeSize to cubeSize).
-      * @param outputMeshFile Filename for the output mesh (default is "adaptive_mesh.off").
+      * Runs inside a TBB arena of options.threads threads. If progress is given,
+      * its stage is updated as the generation advances, and setting its
+      * cancelled flag stops the generation (also in the middle of meshing,
+      * where the flag is checked on every sizing query), which then returns false.
+      *
+      * The tetrahedra are extracted from the complex into a flat index array
+      * (Mesh::tetrahedrons, with the boundary triangles as faces). Output files
+      * ending in .mesh or .vtu are streamed from that array by VolumeMeshWriter;
+      * other names go to CGAL::dump_c3t3 as before.
+      *
+      * @param innerMeshFile Path to the inner mesh (OFF, OBJ, PLY or MESHBIN file).
+      * @param options Cube size, criteria and thread count.
+      * @param outputMeshFile Filename for the output mesh (default is "adaptive_mesh.off"); empty writes no file.
+      * @param progress Optional progress and cancellation state.
+      * @param volumeMesh Optional: receives the vertices, tetrahedrons, subdomains and boundary triangles.
+      * @param boundaryMesh Optional: receives only the boundary triangles and their vertices, for display.
       * @return Returns true if the mesh is generated successfully.
       */
      bool generateVolumeMesh(const std::string &innerMeshFile,
-                             int cubeSize,
-                             const std::string &outputMeshFile = "adaptive_mesh.off");
+                             const Options &options,
+                             const std::string &outputMeshFile = "adaptive_mesh.off",
+                             Progress *progress = nullptr,
+                             Mesh *volumeMesh = nullptr,
+                             Mesh *boundaryMesh = nullptr);
+
+     /**
+      * @brief Runs generateVolumeMesh on a background thread.
+      *
+      * @param innerMeshFile Path to the inner mesh; it is read at the start of the job.
+      * @param options Cube size, criteria and thread count.
+      * @param outputMeshFile Filename for the output mesh.
+      * @param progress Progress and cancellation state, kept alive by the job.
+      * @param boundaryMesh Optional: receives the boundary triangles once the job succeeds.
+      * @return Future holding the result of generateVolumeMesh.
+      */
+     static std::future<bool> generateVolumeMeshAsync(const std::string &innerMeshFile,
+                                                      const Options &options,
+                                                      const std::string &outputMeshFile,
+                                                      std::shared_ptr<Progress> progress,
+                                                      std::shared_ptr<Mesh> boundaryMesh = nullptr);
+
+ private:
+     bool run(const std::string &innerMeshFile, const Options &options, const std::string &outputMeshFile,
+              Progress *progress, Mesh *volumeMesh, Mesh *boundaryMesh);
  };
  
  #endif // ADAPTIVE_MESH_GENERATOR_H
@@ -0,0 +1,162 @@
+/**
+ * @file BatchPipeline.h
+ * @brief Declares BatchPipeline, running MeshX jobs from a job file without the GUI.
+ */
+
+ #ifndef BATCHPIPELINE_H
+ #define BATCHPIPELINE_H
+
+ #include "AdaptiveMeshGenerator.h"
+ #include "Mesh.h"
+ #include "MeshMetadata.h"
+ #include "MeshTransform.h"
+ #include "MeshValidator.h"
+ #include <functional>
+ #include <future>
+ #include <map>
+ #include <memory>
+ #include <mutex>
+ #include <string>
+ #include <vector>
+
+ /**
+  * @class BatchPipeline
+  * @brief Runs independent mesh jobs concurrently under one thread budget.
+  *
+  * A job reads one or more meshes, optionally validates and transforms them,
+  * combines them with a boolean operation, and writes the result, a volume
+  * mesh and a metadata file: the steps the GUI drives from its buttons.
+  *
+  * Jobs run on up to concurrentJobs threads. The TBB work inside them
+  * (validation, transforms, volume meshing) shares a pool capped at the thread
+  * budget, and the OBJ parser gets an equal share of it per running job.
+  * Inputs are read once per file: jobs naming the same file share the parsed
+  * mesh (and its validation), which is dropped after the last of them.
+  */
+ class BatchPipeline {
+ public:
+     /**
+      * @brief What to do with validation errors of the inputs.
+      */
+     enum class Validation {
+         None,    ///< Do not validate
+         Report,  ///< Validate and log the errors
+         Require  ///< Validate and fail the job on errors
+     };
+
+     /**
+      * @brief How the inputs of a job are combined.
+      */
+     enum class Boolean {
+         None,         ///< Single input, used as is
+         Union,
+         Intersection,
+         Difference    ///< First input minus the others
+     };
+
+     /**
+      * @struct Input
+      * @brief A mesh file and the transform applied to it.
+      */
+     struct Input {
+         std::string file;
+         MeshTransform::Matrix transform = MeshTransform::identity();
+     };
+
+     /**
+      * @struct Group
+      * @brief A metadata group and the faces of the result it covers.
+      */
+     struct Group {
+         GroupMetadata metadata;  ///< Name, conditions, material and tags; faceIndices as listed
+         bool allFaces = false;   ///< Assign every face of the result instead
+     };
+
+     /**
+      * @struct Job
+      * @brief One job of a job file.
+      */
+     struct Job {
+         std::string name;
+         std::vector<Input> inputs;
+         Validation validation = Validation::Report;
+         Boolean boolean = Boolean::None;
+         std::string output;                          ///< Result mesh (any MeshIO format); empty: not written
+         std::string volumeOutput;                    ///< Volume mesh of the output; empty: none
+         AdaptiveMeshGenerator::Options volumeOptions;
+         std::string metadataOutput;                  ///< Metadata file (see MetadataExporter); empty: none
+         std::vector<Group> groups;
+         bool centroids = false;                      ///< Record face centroids in the metadata
+         bool faceVertices = false;                   ///< Record face vertices in the metadata
+         MetadataEncoding encoding;
+     };
+
+     /**
+      * @struct Result
+      * @brief Outcome of one job.
+      */
+     struct Result {
+         std::string name;
+         bool success = false;
+         double milliseconds = 0.0;
+         std::vector<std::string> log;
+     };
+
+     /**
+      * @brief Reads a JSON job file.
+      *
+      * @param path The job file.
+      * @param jobs Receives the jobs.
+      * @param threads Set to the file's "threads" entry if present.
+      * @param concurrentJobs Set to the file's "concurrentJobs" entry if present.
+      * @return True if the file was read; errors are reported on std::cerr.
+      */
+     static bool loadJobFile(const std::string& path, std::vector<Job>& jobs,
+                             unsigned& threads, unsigned& concurrentJobs);
+
+     /**
+      * @brief Creates a pipeline.
+      * @param threads Thread budget; 0 uses all hardware threads.
+      * @param concurrentJobs Jobs run at the same time; 0 runs up to the thread budget.
+      */
+     explicit BatchPipeline(unsigned threads = 0, unsigned concurrentJobs = 0);
+
+     /**
+      * @brief Runs the jobs and waits for all of them.
+      *
+      * @param jobs The jobs; their output files should be distinct.
+      * @param onFinished Optional callback for each finished job, called from the
+      *        job's thread, one call at a time.
+      * @return One result per job, in job order.
+      */
+     std::vector<Result> run(const std::vector<Job>& jobs,
+                             const std::function<void(const Result&)>& onFinished = nullptr);
+
+ private:
+     /** @brief An input file as read, shared by the jobs naming it. */
+     struct LoadedInput {
+         std::shared_ptr<const Mesh> mesh;  ///< Null if the file could not be read
+         MeshValidator::Report validation;
+         bool validated = false;
+         double milliseconds = 0.0;
+     };
+
+     /** @brief Cache entry: the reading (started by the first job) and its remaining users. */
+     struct CachedInput {
+         std::shared_future<std::shared_ptr<const LoadedInput>> loaded;
+         int users = 0;
+         bool validate = false;
+     };
+
+     std::shared_ptr<const LoadedInput> acquireInput(const std::string& key, const std::string& file);
+     void releaseInput(const std::string& key);
+     bool runJob(const Job& job, Result& result);
+
+     unsigned threads_;
+     unsigned concurrentJobs_;
+     unsigned parserThreads_ = 1;
+     std::mutex cacheMutex_;
+     std::map<std::string, CachedInput> cache_;
+ };
+
+ #endif // BATCHPIPELINE_H
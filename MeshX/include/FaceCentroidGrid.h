@@ -0,0 +1,58 @@
+/**
+ * @file FaceCentroidGrid.h
+ * @brief Declares FaceCentroidGrid, cached face centroids with a 2-D grid for rectangle queries.
+ */
+
+ #ifndef FACECENTROIDGRID_H
+ #define FACECENTROIDGRID_H
+
+ #include "Mesh.h"
+ #include <array>
+ #include <cstdint>
+ #include <vector>
+
+ /**
+  * @class FaceCentroidGrid
+  * @brief Face centroids of a mesh, bucketed by x and y in a uniform grid.
+  *
+  * The viewer projects orthographically along z and the camera only pans and
+  * zooms, so a screen rectangle is an x/y rectangle in mesh coordinates for
+  * any camera. The grid is therefore built once per mesh (about two faces per
+  * cell) and a drag selection only visits the cells the rectangle covers.
+  */
+ class FaceCentroidGrid {
+ public:
+     /**
+      * @brief Computes the centroids of all faces and buckets them.
+      * @param mesh The mesh; faces with out-of-range vertex indices get a centroid but no bucket.
+      */
+     void build(const Mesh& mesh);
+
+     /** @brief Drops the cached data (call when the mesh changes). */
+     void clear();
+
+     /** @brief True until build() has run on a mesh with faces. */
+     bool empty() const { return centroids_.empty(); }
+
+     /** @brief Centroid of every face, in face order. */
+     const std::vector<std::array<double, 3>>& centroids() const { return centroids_; }
+
+     /**
+      * @brief Faces whose centroid lies in [x0, x1] x [y0, y1].
+      * @return Face indices in ascending order.
+      */
+     std::vector<int> query(double x0, double y0, double x1, double y1) const;
+
+ private:
+     int cellX(double x) const;
+     int cellY(double y) const;
+
+     std::vector<std::array<double, 3>> centroids_;
+     double minX_ = 0.0, minY_ = 0.0;
+     double cellSize_ = 1.0;
+     int columns_ = 0, rows_ = 0;
+     std::vector<std::uint32_t> cellStart_; ///< Faces of cell c: cellFaces_[cellStart_[c], cellStart_[c + 1])
+     std::vector<int> cellFaces_;
+ };
+
+ #endif // FACECENTROIDGRID_H
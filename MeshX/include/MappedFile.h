@@ -0,0 +1,56 @@
+/**
+ * @file MappedFile.h
+ * @brief Declares MappedFile, a read-only view of a whole file.
+ */
+
+ #ifndef MAPPEDFILE_H
+ #define MAPPEDFILE_H
+
+ #include <cstddef>
+ #include <string>
+
+ /**
+  * @class MappedFile
+  * @brief Read-only view of a whole file.
+  *
+  * The file is memory-mapped where possible (POSIX mmap, Win32 file mapping)
+  * and otherwise read into an owned buffer, so callers always get one
+  * contiguous range of bytes.
+  */
+ class MappedFile {
+ public:
+     /**
+      * @brief Maps (or reads) the file.
+      * @param path The file to open; check isOpen() afterwards.
+      */
+     explicit MappedFile(const std::string& path);
+     ~MappedFile();
+
+     MappedFile(const MappedFile&) = delete;
+     MappedFile& operator=(const MappedFile&) = delete;
+
+     /**
+      * @brief True if the file could be opened (it may be empty).
+      */
+     bool isOpen() const { return open_; }
+
+     /**
+      * @brief First byte of the file, nullptr if it is not open or empty.
+      */
+     const char* data() const { return data_; }
+
+     /**
+      * @brief File size in bytes.
+      */
+     std::size_t size() const { return size_; }
+
+ private:
+     const char* data_ = nullptr;
+     std::size_t size_ = 0;
+     bool open_ = false;
+     bool mapped_ = false;
+     void* mapping_ = nullptr; ///< Win32 mapping handle
+     std::string buffer_;      ///< Contents when the file is not mapped
+ };
+
+ #endif // MAPPEDFILE_H
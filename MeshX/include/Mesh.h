@@ -2,8 +2,8 @@
  * @file Mesh.h
  * @brief Defines structures and classes for representing a 3D mesh.
  *
- * This file contains the definitions for the Vertex, FaceElement, Face, and Mesh
- * classes, which are used to represent the geometry of a 3D mesh. The Mesh class
+ * This file contains the definitions for the Vertex, FaceElement, Face, FaceTable
+ * and Mesh classes, which are used to represent the geometry of a 3D mesh. The Mesh class
  * holds the entire mesh data, including vertices, faces, normals, and texture coordinates.
  */
 
@@ -12,7 +12,11 @@
  
  #include <vector>
  #include <array>
- #include <tuple>
+ #include <cstddef>
+ #include <cstdint>
+ #include <initializer_list>
+ #include <iterator>
+ #include <utility>
  
  /**
   * @struct Vertex
@@ -46,11 +50,190 @@
  /**
   * @struct Face
   * @brief Represents a face in the mesh, which is a collection of face elements.
+  *
+  * Meshes store their faces in a FaceTable; a Face is a standalone face,
+  * e.g. one being built before FaceTable::push_back().
   */
  struct Face {
      std::vector<FaceElement> elements; ///< Collection of face elements defining the face.
  };
  
+ /**
+  * @class FaceElementRange
+  * @brief The face elements of one face of a FaceTable, stored contiguously.
+  *
+  * Offers the parts of std::vector used on Face::elements (size, operator[],
+  * range-for), so code written against Face also works on table faces.
+  */
+ template <typename T>
+ class FaceElementRange {
+ public:
+     FaceElementRange(T* first, std::size_t count) : first_(first), count_(count) {}
+
+     std::size_t size() const { return count_; }
+     bool empty() const { return count_ == 0; }
+     T& operator[](std::size_t i) const { return first_[i]; }
+     T& front() const { return first_[0]; }
+     T& back() const { return first_[count_ - 1]; }
+     T* begin() const { return first_; }
+     T* end() const { return first_ + count_; }
+
+ private:
+     T* first_;
+     std::size_t count_;
+ };
+
+ /**
+  * @struct BasicFaceView
+  * @brief One face of a FaceTable, shaped like Face.
+  *
+  * Views are cheap values; they stay valid until faces are added to the table.
+  */
+ template <typename T>
+ struct BasicFaceView {
+     FaceElementRange<T> elements; ///< The face's elements, in order.
+ };
+ using FaceView = BasicFaceView<FaceElement>;           ///< Face whose indices can be changed.
+ using ConstFaceView = BasicFaceView<const FaceElement>; ///< Read-only face.
+
+ /**
+  * @class FaceTable
+  * @brief All faces of a mesh in compressed sparse row (CSR) form.
+  *
+  * The face elements of every face are stored back to back in one array, and
+  * face f spans [offset(f), offset(f + 1)) of it. While every face is a
+  * triangle the offsets array stays empty and face f is simply elements
+  * 3f..3f+2; trianglesOnly() tells loops they can use that stride directly.
+  *
+  * `mesh.faces[i].elements` and `for (const auto& face : mesh.faces)` work as
+  * they did with std::vector<Face>, so callers can move to the flat arrays
+  * (elements(), offset()) one at a time.
+  */
+ class FaceTable {
+ public:
+     /**
+      * @brief Iterator over the faces, yielding views by value.
+      */
+     template <typename Table, typename View>
+     class BasicIterator {
+     public:
+         using iterator_category = std::forward_iterator_tag;
+         using value_type = View;
+         using difference_type = std::ptrdiff_t;
+         using pointer = void;
+         using reference = View;
+
+         BasicIterator(Table* table, std::size_t face) : table_(table), face_(face) {}
+         View operator*() const { return (*table_)[face_]; }
+         BasicIterator& operator++() { ++face_; return *this; }
+         BasicIterator operator++(int) { BasicIterator old = *this; ++face_; return old; }
+         bool operator==(const BasicIterator& other) const { return face_ == other.face_; }
+         bool operator!=(const BasicIterator& other) const { return face_ != other.face_; }
+
+     private:
+         Table* table_;
+         std::size_t face_;
+     };
+     using iterator = BasicIterator<FaceTable, FaceView>;
+     using const_iterator = BasicIterator<const FaceTable, ConstFaceView>;
+
+     /** @brief Number of faces. */
+     std::size_t size() const { return offsets_.empty() ? elements_.size() / 3 : offsets_.size() - 1; }
+     bool empty() const { return size() == 0; }
+
+     /** @brief True if every face is a triangle (no offsets are stored). */
+     bool trianglesOnly() const { return offsets_.empty(); }
+
+     /** @brief Index in elements() of the first element of a face; offset(size()) is the total. */
+     std::size_t offset(std::size_t face) const { return offsets_.empty() ? 3 * face : offsets_[face]; }
+
+     /** @brief Number of elements of a face. */
+     std::size_t faceSize(std::size_t face) const { return offset(face + 1) - offset(face); }
+
+     ConstFaceView operator[](std::size_t face) const {
+         return { FaceElementRange<const FaceElement>(elements_.data() + offset(face), faceSize(face)) };
+     }
+     FaceView operator[](std::size_t face) {
+         return { FaceElementRange<FaceElement>(elements_.data() + offset(face), faceSize(face)) };
+     }
+
+     iterator begin() { return iterator(this, 0); }
+     iterator end() { return iterator(this, size()); }
+     const_iterator begin() const { return const_iterator(this, 0); }
+     const_iterator end() const { return const_iterator(this, size()); }
+
+     /** @brief The elements of all faces, face after face. */
+     const std::vector<FaceElement>& elements() const { return elements_; }
+
+     /** @brief Elements for changing indices in place (not for adding or removing). */
+     std::vector<FaceElement>& elements() { return elements_; }
+
+     /** @brief Face start offsets (size() + 1 entries), empty while trianglesOnly(). */
+     const std::vector<std::uint32_t>& offsets() const { return offsets_; }
+
+     /**
+      * @brief Appends a face.
+      * @param first The face's first element.
+      * @param count Number of elements.
+      */
+     void addFace(const FaceElement* first, std::size_t count) {
+         if (offsets_.empty() && count != 3) buildOffsets();
+         elements_.insert(elements_.end(), first, first + count);
+         if (!offsets_.empty()) offsets_.push_back(static_cast<std::uint32_t>(elements_.size()));
+     }
+     void addFace(std::initializer_list<FaceElement> elements) { addFace(elements.begin(), elements.size()); }
+     void push_back(const Face& face) { addFace(face.elements.data(), face.elements.size()); }
+
+     /** @brief Appends all faces of another table. */
+     void append(const FaceTable& other) {
+         if (offsets_.empty() && !other.offsets_.empty()) buildOffsets();
+         const std::size_t base = elements_.size();
+         elements_.insert(elements_.end(), other.elements_.begin(), other.elements_.end());
+         if (offsets_.empty()) return;
+         for (std::size_t f = 1; f <= other.size(); ++f) {
+             offsets_.push_back(static_cast<std::uint32_t>(base + other.offset(f)));
+         }
+     }
+
+     /**
+      * @brief Replaces the contents with prepared arrays.
+      * @param elements Elements of all faces.
+      * @param offsets Face start offsets (faces + 1 entries, first 0, last
+      *        elements.size()), or empty if every face is a triangle.
+      */
+     void assign(std::vector<FaceElement> elements, std::vector<std::uint32_t> offsets) {
+         elements_ = std::move(elements);
+         offsets_ = std::move(offsets);
+         bool triangles = elements_.size() % 3 == 0;
+         for (std::size_t f = 0; triangles && f + 1 < offsets_.size(); ++f) {
+             triangles = offsets_[f + 1] - offsets_[f] == 3;
+         }
+         if (triangles) offsets_.clear();
+     }
+
+     /** @brief Reserves room for faces with the given total element count. */
+     void reserve(std::size_t faces, std::size_t elements) {
+         elements_.reserve(elements);
+         if (!offsets_.empty() || elements != 3 * faces) offsets_.reserve(faces + 1);
+     }
+
+     void clear() {
+         elements_.clear();
+         offsets_.clear();
+     }
+
+ private:
+     /** @brief Switches from the implicit triangle layout to explicit offsets. */
+     void buildOffsets() {
+         const std::size_t faces = elements_.size() / 3;
+         offsets_.resize(faces + 1);
+         for (std::size_t f = 0; f <= faces; ++f) offsets_[f] = static_cast<std::uint32_t>(3 * f);
+     }
+
+     std::vector<FaceElement> elements_;
+     std::vector<std::uint32_t> offsets_;
+ };
+
  /**
   * @class Mesh
   * @brief Represents the entire mesh data.
@@ -60,7 +243,7 @@
  class Mesh {
  public:
      std::vector<Vertex> vertices; ///< List of vertices in the mesh.
-     std::vector<Face> faces; ///< List of faces in the mesh.
+     FaceTable faces; ///< Faces of the mesh, in flat CSR form.
      std::vector<Vertex> normals; ///< Optional normals for shading calculations.
      std::vector<std::array<double, 2>> texCoords; ///< Optional texture coordinates.
  
@@ -68,10 +251,12 @@
       * @typedef Tetrahedron
       * @brief Represents a tetrahedral element in a volumetric mesh.
       *
-      * A Tetrahedron is represented as a tuple containing four vertex indices.
+      * A Tetrahedron holds four vertex indices, positively oriented; the
+      * tetrahedrons of a mesh form one flat index array (4 ints each).
       */
-     using Tetrahedron = std::tuple<int, int, int, int>;
+     using Tetrahedron = std::array<int, 4>;
      std::vector<Tetrahedron> tetrahedrons; ///< List of tetrahedrons for volumetric meshes.
+     std::vector<int> tetrahedronDomains; ///< Optional subdomain index of each tetrahedron.
  };
  
  #endif // MESH_H
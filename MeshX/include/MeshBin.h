@@ -0,0 +1,136 @@
+/**
+ * @file MeshBin.h
+ * @brief Declares the MeshBin binary mesh cache shared with HeatStack.
+ *
+ * A .meshbin file holds a mesh as flat arrays behind a fixed header, so it can
+ * be memory-mapped and used without parsing. HeatStack (HeatStack/include/MeshBin.h)
+ * reads and writes the same layout; both tools keep a "<mesh>.meshbin" sidecar
+ * next to an OBJ file and reuse it while the OBJ is unchanged. MeshX also
+ * saves meshes as standalone .meshbin files, its native binary format.
+ */
+
+ #ifndef MESHBIN_H
+ #define MESHBIN_H
+
+ #include "Mesh.h"
+ #include <cstdint>
+ #include <string>
+
+ /**
+  * @class MeshBin
+  * @brief Reader and writer for the versioned .meshbin mesh cache.
+  *
+  * Layout (native byte order): a 136-byte Header followed by these arrays,
+  * each padded to a multiple of 8 bytes:
+  * - positions: vertexCount * 3 doubles (floats unless PositionsF64 is set)
+  * - triangles: triangleCount * 3 int32, fan triangulation of the faces
+  * - polygonOffsets: (polygonCount + 1) int32, only with HasPolygons
+  * - polygonElements: polygonElementCount * 3 int32 (vertex, texcoord, normal), only with HasPolygons
+  * - normals: normalCount * 3 doubles
+  * - texCoords: texCoordCount * 2 doubles
+  *
+  * All indices are 0-based, -1 marks an absent texcoord or normal.
+  */
+ class MeshBin {
+ public:
+     static const std::uint32_t kVersion = 1; ///< Bumped on any layout change.
+
+     /**
+      * @brief Header flags.
+      */
+     enum Flags : std::uint32_t {
+         PositionsF64 = 1u << 0, ///< Positions are doubles.
+         HasPolygons  = 1u << 1, ///< Polygon sections are present.
+         Lenient      = 1u << 2  ///< The writer skipped malformed OBJ input.
+     };
+
+     /**
+      * @struct Header
+      * @brief Fixed header at the start of a .meshbin file.
+      */
+     struct Header {
+         char          magic[8];            ///< "MESHBIN\0"
+         std::uint32_t version;             ///< kVersion
+         std::uint32_t flags;               ///< Combination of Flags
+         std::uint64_t sourceSize;          ///< Size of the source file in bytes
+         std::int64_t  sourceMtime;         ///< Source modification time (seconds since the epoch)
+         std::uint64_t sourceHash;          ///< Source content fingerprint
+         std::uint64_t vertexCount;
+         std::uint64_t triangleCount;
+         std::uint64_t polygonCount;
+         std::uint64_t polygonElementCount;
+         std::uint64_t normalCount;
+         std::uint64_t texCoordCount;
+         double        bounds[6];           ///< min x, y, z, max x, y, z
+     };
+
+     /**
+      * @struct SourceStamp
+      * @brief Identity of the source file a cache was built from.
+      *
+      * The hash is FNV-1a over the file size and the first and last 64 KiB,
+      * so computing a stamp stays cheap for large files.
+      */
+     struct SourceStamp {
+         std::uint64_t size = 0;
+         std::int64_t  mtime = 0;
+         std::uint64_t hash = 0;
+     };
+
+     /**
+      * @brief Computes the stamp of a file.
+      * @param path The file to stamp.
+      * @param stamp Receives the stamp.
+      * @return False if the file cannot be read.
+      */
+     static bool stampOf(const std::string& path, SourceStamp& stamp);
+
+     /**
+      * @brief Returns the sidecar cache path for a mesh file ("<mesh>.meshbin").
+      */
+     static std::string sidecarPath(const std::string& meshPath);
+
+     /**
+      * @brief Writes a mesh, with positions as doubles and the full face data.
+      *
+      * The file is written to a temporary name and renamed into place.
+      *
+      * @param path Destination file.
+      * @param mesh The mesh to store (tetrahedrons are not stored).
+      * @param stamp Stamp of the source file.
+      * @param lenient True if the source had malformed lines that were skipped.
+      * @return False on any I/O error.
+      */
+     static bool write(const std::string& path, const Mesh& mesh, const SourceStamp& stamp, bool lenient);
+
+     /**
+      * @brief Reads a cache written for the given source into a Mesh.
+      *
+      * The file is memory-mapped and copied straight into the mesh arrays.
+      * Caches without double positions and polygon data (e.g. written by
+      * HeatStack) are rejected so the caller re-parses and rewrites them.
+      *
+      * @param path Cache file.
+      * @param stamp Stamp the cache must have been built from.
+      * @param mesh Receives the mesh on success.
+      * @return True if a valid, matching cache was read.
+      */
+     static bool read(const std::string& path, const SourceStamp& stamp, Mesh& mesh);
+
+     /**
+      * @brief Reads a standalone .meshbin file (a mesh saved in MeshX's native
+      *        format rather than a cache), whatever source it was stamped with.
+      *
+      * Such files are written with write() and an empty stamp.
+      *
+      * @param path The file to read.
+      * @param mesh Receives the mesh on success.
+      * @return True if a valid file was read.
+      */
+     static bool read(const std::string& path, Mesh& mesh);
+
+ private:
+     static bool readFile(const std::string& path, const SourceStamp* stamp, Mesh& mesh);
+ };
+
+ #endif // MESHBIN_H
@@ -72,10 +72,49 @@
       */
      static bool writeOFF(const std::string &filename, const Polyhedron &poly);
  
+     /**
+      * @brief Computes the union of multiple meshes in place.
+      *
+      * Copy-free variant of computeUnion(): corefinement works directly on the
+      * given meshes. On success meshes[0] holds the union and all other
+      * elements are consumed (left empty); move it out with std::move. On
+      * failure the contents of meshes are unspecified.
+      *
+      * @param meshes The input meshes (consumed).
+      * @return True if the operation is successful, false otherwise.
+      */
+     static bool computeUnionInPlace(std::vector<Polyhedron> &meshes);
+
+     /**
+      * @brief Computes the intersection of multiple meshes in place.
+      *
+      * As computeUnionInPlace(), for mesh[0] ∩ mesh[1] ∩ ... ∩ mesh[n]. A mesh
+      * whose bounding box misses the intermediate result empties it at once.
+      *
+      * @param meshes The input meshes (consumed); the intersection is left in meshes[0].
+      * @return True if the operation is successful, false otherwise.
+      */
+     static bool computeIntersectionInPlace(std::vector<Polyhedron> &meshes);
+
+     /**
+      * @brief Computes the difference of multiple meshes in place.
+      *
+      * As computeUnionInPlace(), for mesh[0] \ (mesh[1] ∪ mesh[2] ∪ ...).
+      *
+      * @param meshes The input meshes (consumed); the difference is left in meshes[0].
+      * @return True if the operation is successful, false otherwise.
+      */
+     static bool computeDifferenceInPlace(std::vector<Polyhedron> &meshes);
+
      /**
       * @brief Computes the union of multiple meshes.
       *
-      * The operation is performed iteratively: result = mesh[0] ∪ mesh[1] ∪ ... ∪ mesh[n].
+      * result = mesh[0] ∪ mesh[1] ∪ ... ∪ mesh[n], computed as a balanced tree of
+      * pairwise unions whose independent pairs run in parallel (TBB). Meshes with
+      * disjoint bounding boxes are combined without corefinement.
+      *
+      * The inputs are left untouched, so they are copied once (corefinement
+      * modifies its operands); the InPlace variant avoids the copies.
       *
       * @param meshes A vector of Polyhedrons representing the input meshes.
       * @param result Reference to store the resulting unioned mesh.
@@ -88,6 +127,9 @@
       *
       * The operation is performed iteratively: result = mesh[0] ∩ mesh[1] ∩ ... ∩ mesh[n].
       *
+      * The inputs are left untouched, so they are copied once (corefinement
+      * modifies its operands); the InPlace variant avoids the copies.
+      *
       * @param meshes A vector of Polyhedrons representing the input meshes.
       * @param result Reference to store the resulting intersected mesh.
       * @return True if the operation is successful, false otherwise.
@@ -98,7 +140,10 @@
       * @brief Computes the difference of multiple meshes.
       *
       * This operation subtracts the union of all meshes (except the first) from the first mesh:
-      * result = mesh[0] \ (mesh[1] ∪ mesh[2] ∪ ...).
+      * result = mesh[0] \ (mesh[1] ∪ mesh[2] ∪ ...). The union is computed as in computeUnion().
+      *
+      * The inputs are left untouched, so they are copied once (corefinement
+      * modifies its operands); the InPlace variant avoids the copies.
       *
       * @param meshes A vector of Polyhedrons representing the input meshes.
       * @param result Reference to store the resulting difference mesh.
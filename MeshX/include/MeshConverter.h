@@ -4,7 +4,7 @@
  *
  * This file provides the MeshConverter class, which includes functions for converting
  * OBJ files to OFF files, OFF files to OBJ files, and converting a custom Mesh object
- * into a CGAL Polyhedron representation.
+ * to and from a CGAL Polyhedron representation.
  */
 
  #ifndef MESHCONVERTER_H
@@ -48,10 +48,16 @@
      /**
       * @brief Converts an OBJ file to an OFF file.
       *
-      * Reads a mesh from an OBJ file and writes it to an OFF file.
+      * The file is streamed: a reader thread loads chunks of a few MB, the
+      * calling thread converts them and a writer thread writes the result,
+      * so memory use does not grow with the mesh. Vertex coordinates are
+      * copied as written; face corners keep their vertex indices (negative
+      * ones resolved) and texture/normal indices, groups and materials are
+      * dropped. Faces are spooled to "<output>.faces.tmp" until all vertices
+      * are written. The mesh is not checked for being a valid surface.
       *
       * @param input_filename The path to the input OBJ file.
-      * @param output_filename The path to the output OFF file.
+      * @param output_filename The path to the output OFF file; removed if the conversion fails.
       * @return True if the conversion is successful, false otherwise.
       */
      bool convertObjToOff(const std::string& input_filename, const std::string& output_filename);
@@ -59,10 +65,12 @@
      /**
       * @brief Converts an OFF file to an OBJ file.
       *
-      * Reads a mesh from an OFF file and writes it to an OBJ file.
+      * Streamed like convertObjToOff(), with constant memory. Expects one
+      * vertex or face per line, as OFF writers emit; '#' comments and extra
+      * columns (e.g. colours) are skipped, and coordinates are copied as written.
       *
       * @param offFile The path to the input OFF file.
-      * @param objFile The path to the output OBJ file.
+      * @param objFile The path to the output OBJ file; removed if the conversion fails.
       * @return True if the conversion is successful, false otherwise.
       */
      bool convertOffToObj(const std::string& offFile, const std::string& objFile);
@@ -70,14 +78,29 @@
      /**
       * @brief Converts a custom Mesh object into a CGAL Polyhedron representation.
       *
-      * This function converts a given Mesh object into a CGAL Polyhedron (OFF format)
-      * that can be used for Boolean operations or other CGAL processing.
+      * This function builds a CGAL Polyhedron straight from the mesh's vertex and
+      * face arrays (no OFF text in between) and triangulates it, so it can be
+      * used for Boolean operations or other CGAL processing.
       *
       * @param mesh The input custom Mesh object.
       * @param poly Reference to the output CGAL Polyhedron.
-      * @return True if the conversion is successful, false otherwise.
+      * @return True if the conversion is successful, false otherwise (invalid
+      *         indices or a non-manifold surface); poly is then empty.
       */
      bool convertMeshToPolyhedron(const Mesh &mesh, MeshBooleanOperations::Polyhedron &poly);
+
+     /**
+      * @brief Converts a CGAL Polyhedron back into a custom Mesh object.
+      *
+      * Vertices keep the Polyhedron's order (the order an OFF file of it would
+      * have) and full double precision; faces reference them 0-based, without
+      * texture coordinates or normals.
+      *
+      * @param poly The input CGAL Polyhedron, e.g. a Boolean operation result.
+      * @param mesh Reference to the output Mesh; replaced entirely.
+      * @return True if the conversion is successful, false otherwise.
+      */
+     bool convertPolyhedronToMesh(const MeshBooleanOperations::Polyhedron &poly, Mesh &mesh);
  };
  
  #endif // MESHCONVERTER_H
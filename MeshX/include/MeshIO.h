@@ -0,0 +1,79 @@
+/**
+ * @file MeshIO.h
+ * @brief Declares MeshIO, reading and writing meshes by file extension.
+ */
+
+ #ifndef MESHIO_H
+ #define MESHIO_H
+
+ #include "Mesh.h"
+ #include <string>
+
+ /**
+  * @class MeshIO
+  * @brief Reads and writes a Mesh in any of the formats MeshX handles.
+  *
+  * The format follows from the file extension (case-insensitive):
+  * - .obj: text OBJ (ObjParser, ObjExporter)
+  * - .off: text OFF; coordinates are written exactly
+  * - .ply: PLY; written as binary little-endian with double positions,
+  *   read in ascii or binary form of either byte order
+  * - .meshbin: MeshX's native binary format (see MeshBin), memory-mapped
+  *   and copied into the mesh without parsing
+  *
+  * OFF and PLY carry positions and faces only; normals, texture coordinates
+  * and tetrahedrons are dropped when writing them.
+  */
+ class MeshIO {
+ public:
+     /**
+      * @brief File formats.
+      */
+     enum class Format {
+         Unknown,
+         Obj,
+         Off,
+         Ply,
+         MeshBin
+     };
+
+     /**
+      * @brief Returns the format of a path from its extension.
+      */
+     static Format formatOf(const std::string& path);
+
+     /**
+      * @brief True if the path has an extension MeshIO can read and write.
+      */
+     static bool isSupported(const std::string& path) { return formatOf(path) != Format::Unknown; }
+
+     /**
+      * @brief Reads a mesh.
+      * @param path The file to read.
+      * @param mesh Receives the mesh on success.
+      * @return True if the file was read; errors are reported on std::cerr.
+      */
+     static bool read(const std::string& path, Mesh& mesh);
+
+     /**
+      * @brief Writes a mesh.
+      * @param path The file to write.
+      * @param mesh The mesh to store.
+      * @return True if the file was written; errors are reported on std::cerr.
+      */
+     static bool write(const std::string& path, const Mesh& mesh);
+
+     /** @brief Reads a text OFF file. */
+     static bool readOff(const std::string& path, Mesh& mesh);
+
+     /** @brief Writes a text OFF file with exact coordinates. */
+     static bool writeOff(const std::string& path, const Mesh& mesh);
+
+     /** @brief Reads an ascii or binary PLY file (the "vertex" and "face" elements). */
+     static bool readPly(const std::string& path, Mesh& mesh);
+
+     /** @brief Writes a binary little-endian PLY file. */
+     static bool writePly(const std::string& path, const Mesh& mesh);
+ };
+
+ #endif // MESHIO_H
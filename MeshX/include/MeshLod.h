@@ -0,0 +1,105 @@
+/**
+ * @file MeshLod.h
+ * @brief Declares MeshLod, coarser display copies of a mesh built in the background.
+ */
+
+ #ifndef MESHLOD_H
+ #define MESHLOD_H
+
+ #include "Mesh.h"
+ #include <atomic>
+ #include <cstddef>
+ #include <future>
+ #include <memory>
+ #include <vector>
+
+ /**
+  * @class MeshLod
+  * @brief Levels of detail of a mesh for drawing it when it is small on screen.
+  *
+  * start() simplifies a copy of the mesh on a worker thread with CGAL edge
+  * collapse: each level keeps about a quarter of the faces of the one before,
+  * down to a few thousand faces. The levels are for display only; they are
+  * triangle meshes in the coordinates of the mesh they were built from, and
+  * selection, validation and booleans keep using the full mesh.
+  *
+  * Meshes below kMinFaces get no levels. Destroying or reassigning a MeshLod
+  * cancels a build still running.
+  */
+ class MeshLod {
+ public:
+     static const std::size_t kMinFaces = 20000;     ///< Smaller meshes are always drawn in full
+     static const std::size_t kCoarsestFaces = 2000; ///< No level is built below this face count
+
+     MeshLod() = default;
+     ~MeshLod();
+
+     MeshLod(const MeshLod&) = delete;
+     MeshLod& operator=(const MeshLod&) = delete;
+     MeshLod(MeshLod&& other) noexcept = default;
+     MeshLod& operator=(MeshLod&& other) noexcept;
+
+     /**
+      * @brief Simplifies the faces of a mesh into successively coarser levels.
+      *
+      * Polygons are fanned into triangles; faces that would make the surface
+      * non-manifold are left out of the levels.
+      *
+      * @param mesh The mesh to simplify.
+      * @param cancelled Optional flag; when set, simplification stops and no levels are returned.
+      * @return The levels, finest first; empty if the mesh has fewer than kMinFaces faces.
+      */
+     static std::vector<Mesh> buildLevels(const Mesh& mesh, const std::atomic<bool>* cancelled = nullptr);
+
+     /**
+      * @brief Starts building the levels of a mesh on a worker thread.
+      *
+      * Replaces the levels of a previous build; one still running is cancelled.
+      */
+     void start(std::shared_ptr<const Mesh> mesh);
+
+     /**
+      * @brief Collects a finished build.
+      * @return True once, when the levels of the last start() became available.
+      */
+     bool poll();
+
+     /** @brief The levels, finest first, until releaseMeshes(). */
+     const std::vector<Mesh>& levels() const { return levels_; }
+
+     /** @brief Frees the level meshes, e.g. after they were uploaded; the face counts stay. */
+     void releaseMeshes();
+
+     /** @brief Number of levels available (0 while building or for small meshes). */
+     std::size_t size() const { return faceCounts_.size(); }
+
+     /**
+      * @brief Picks the level to draw for the size of the mesh on screen.
+      *
+      * Aims at about one triangle per pixel of the mesh's projected bounding
+      * box: the coarsest level with at least that many faces is used.
+      *
+      * @param screenDiagonal Length of the bounding box diagonal on screen, in pixels.
+      * @return 0 for the full mesh, otherwise 1 + the index into the levels.
+      */
+     std::size_t select(double screenDiagonal) const;
+
+     /** @brief Bounding box diagonal of the mesh the levels were built from. */
+     double diagonal() const { return diagonal_; }
+
+ private:
+     struct Result {
+         std::vector<Mesh> levels;
+         double diagonal = 0.0;
+     };
+
+     void cancel();
+
+     std::shared_ptr<std::atomic<bool>> cancelled_;
+     std::future<Result> job_;
+     std::vector<Mesh> levels_;
+     std::vector<std::size_t> faceCounts_;
+     double diagonal_ = 0.0;
+ };
+
+ #endif // MESHLOD_H
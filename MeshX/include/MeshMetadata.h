@@ -13,6 +13,8 @@
  #include <vector>
  #include <map>
  #include <array>
+ #include <cstddef>
+ #include <cstdint>
  #include "nlohmann/json.hpp"
  
  using json = nlohmann::json;
@@ -44,6 +46,20 @@
      int faceIndex;                           ///< Index of the face.
      std::array<double, 3> centroid;          ///< Centroid coordinates (x, y, z).
      std::vector<std::array<double, 3>> vertices; ///< Optional: Full vertex coordinates for the face.
+     std::vector<int> vertexIndices;          ///< Optional: Indices of those vertices in the mesh.
+ };
+ 
+ /**
+  * @struct MetadataEncoding
+  * @brief Selects compact layouts for MeshMetadata::toJson.
+  *
+  * The defaults give the original layout, one object per face with its
+  * vertex coordinates repeated.
+  */
+ struct MetadataEncoding {
+     bool faceRanges = false;       ///< Write "faceRanges" as [first, count] runs instead of "faceIndices".
+     bool columnar = false;         ///< Write spatialData as parallel flat arrays instead of one object per face.
+     bool vertexReferences = false; ///< Write face vertices as 0-based mesh vertex indices instead of coordinates.
  };
  
  /**
@@ -62,6 +78,14 @@
  /**
   * @class MeshMetadata
   * @brief Manages metadata for mesh element groups.
+  *
+  * Besides the groups themselves, MeshMetadata keeps a face-to-group index:
+  * every group gets a small dense id, a bitset of its faces (the union of
+  * faceIndices and the spatialData face indices), and each face records the
+  * lowest id of the groups containing it plus how many groups do. The index
+  * is updated through add/update/removeGroupMetadata; after editing a group
+  * in place through getGroupMetadata, call refreshGroupFaces. Only the faces
+  * that changed are touched, apart from one pass over the group's bitset.
   */
  class MeshMetadata {
  public:
@@ -99,14 +123,82 @@
       */
      const std::map<std::string, GroupMetadata>& getAllMetadata() const;
  
+     /**
+      * @brief Re-indexes the faces of a group after it was edited in place.
+      * @param groupName The name of the element group.
+      * @return true if the group exists; false otherwise.
+      */
+     bool refreshGroupFaces(const std::string& groupName);
+ 
+     /**
+      * @brief Sizes the face index for a mesh; larger face indices grow it on demand.
+      * @param faceCount The number of faces of the mesh the groups refer to.
+      */
+     void setFaceCount(std::size_t faceCount);
+ 
+     /**
+      * @brief Returns the dense id of a group.
+      * @param groupName The name of the element group.
+      * @return The id, or -1 if there is no such group.
+      */
+     int groupId(const std::string& groupName) const;
+ 
+     /**
+      * @brief Returns the group owning a face: the lowest id of the groups containing it.
+      * @param face The face index.
+      * @return The group id, or -1 if no group contains the face.
+      */
+     int faceGroup(int face) const {
+         return face >= 0 && static_cast<std::size_t>(face) < faceGroups_.size() ? faceGroups_[face] : -1;
+     }
+ 
+     /**
+      * @brief Returns the owning group id of every face (-1 for none); may be
+      * shorter than the mesh's face count.
+      */
+     const std::vector<int>& faceGroups() const { return faceGroups_; }
+ 
+     /**
+      * @brief True if the group with the given id contains the face.
+      */
+     bool groupContainsFace(int groupId, int face) const;
+ 
+     /**
+      * @brief Returns the number of faces that belong to more than one group.
+      */
+     std::size_t overlappingFaceCount() const { return overlappingFaces_; }
+ 
+     /**
+      * @brief Counter bumped whenever face membership changes, to detect stale views.
+      */
+     std::uint64_t membershipVersion() const { return membershipVersion_; }
+ 
      /**
       * @brief Converts the metadata to a JSON object.
       * @return A JSON representation of the metadata.
       */
-     json toJson() const;
+     json toJson() const { return toJson(MetadataEncoding()); }
+ 
+     /**
+      * @brief Converts the metadata to a JSON object using the given layout.
+      * @param encoding The compact layouts to use.
+      * @return A JSON representation of the metadata.
+      */
+     json toJson(const MetadataEncoding& encoding) const;
  
  private:
+     void indexGroup(int id, const GroupMetadata* group);
+     void growFaces(std::size_t faceCount);
+     int lowestGroupContaining(int face) const;
+ 
      std::map<std::string, GroupMetadata> groupMetadataMap; ///< Mapping from group names to their metadata.
+     std::map<std::string, int> groupIds_;                  ///< Dense id of each group.
+     std::vector<std::vector<std::uint64_t>> groupFaces_;   ///< Face bitset per group id; empty for free ids.
+     std::vector<bool> idUsed_;                             ///< Whether each id belongs to a group.
+     std::vector<int> faceGroups_;                          ///< Owning (lowest) group id per face, or -1.
+     std::vector<std::uint16_t> faceGroupCounts_;           ///< Number of groups containing each face.
+     std::size_t overlappingFaces_ = 0;                     ///< Faces with a count above one.
+     std::uint64_t membershipVersion_ = 0;
  };
  
  #endif // MESH_METADATA_H
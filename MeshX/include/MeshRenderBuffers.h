@@ -0,0 +1,113 @@
+/**
+ * @file MeshRenderBuffers.h
+ * @brief Declares MeshRenderBuffers, retained OpenGL geometry for one scene mesh.
+ */
+
+ #ifndef MESHRENDERBUFFERS_H
+ #define MESHRENDERBUFFERS_H
+
+ #include "Mesh.h"
+ #include <cstdint>
+ #include <vector>
+
+ /**
+  * @class MeshRenderBuffers
+  * @brief Vertex and index buffers for drawing a mesh without per-face GL calls.
+  *
+  * upload() triangulates the faces once (fans) and stores the positions in a
+  * vertex buffer and two index buffers: triangles for filled drawing and the
+  * polygon edges for wireframe, so quads keep their outline. Both index buffers
+  * are sorted by face colour: ungrouped clean faces, then each face group, then
+  * faces with errors; draw() colours each range with one glColor call. A change
+  * of face groups re-sorts and re-uploads the index buffers only (setFaceGroups).
+  *
+  * Buffer objects are used when the context provides them (see loadGL());
+  * otherwise the arrays stay in memory and are drawn as client-side vertex
+  * arrays. Must be used on the thread owning the GL context.
+  */
+ class MeshRenderBuffers {
+ public:
+     MeshRenderBuffers() = default;
+     ~MeshRenderBuffers();
+
+     MeshRenderBuffers(const MeshRenderBuffers&) = delete;
+     MeshRenderBuffers& operator=(const MeshRenderBuffers&) = delete;
+     MeshRenderBuffers(MeshRenderBuffers&& other) noexcept;
+     MeshRenderBuffers& operator=(MeshRenderBuffers&& other) noexcept;
+
+     /**
+      * @brief Loads the buffer object entry points of the current context.
+      *
+      * Call once after the context is made current.
+      *
+      * @return True if buffer objects are available.
+      */
+     static bool loadGL();
+
+     /**
+      * @brief Rebuilds the buffers from a mesh.
+      * @param mesh The mesh to draw.
+      * @param faceErrors Per-face error flags (nonzero: drawn in the error colour);
+      *        may be shorter than the face count.
+      * @param faceGroups Per-face group ids (see MeshMetadata::faceGroups; -1 or
+      *        missing: ungrouped).
+      */
+     void upload(const Mesh& mesh, const std::vector<std::uint8_t>& faceErrors,
+                 const std::vector<int>& faceGroups = std::vector<int>());
+ 
+     /**
+      * @brief Rebuilds only the index buffers for new face groups.
+      *
+      * The mesh must be the one last uploaded.
+      */
+     void setFaceGroups(const Mesh& mesh, const std::vector<std::uint8_t>& faceErrors,
+                        const std::vector<int>& faceGroups);
+ 
+     /**
+      * @brief The colour faces of a group are drawn in.
+      * @param group A group id (MeshMetadata::groupId).
+      * @param rgb Receives the colour.
+      */
+     static void groupColor(int group, float rgb[3]);
+
+     /**
+      * @brief Draws the mesh with the current transform.
+      * @param wireframe Draw polygon outlines instead of filled triangles.
+      */
+     void draw(bool wireframe) const;
+
+     /**
+      * @brief Frees the buffers.
+      */
+     void release();
+
+ private:
+     /** @brief A run of indices drawn in one colour. */
+     struct Range {
+         int colour;          ///< kClean, kError or a group id
+         std::uint32_t count; ///< Number of indices
+     };
+ 
+     /** @brief One index buffer, sorted into colour ranges. */
+     struct Indices {
+         std::vector<std::uint32_t> data; ///< Only kept without buffer objects
+         unsigned int buffer = 0;
+         std::vector<Range> ranges;
+     };
+ 
+     static const int kClean = -1;
+     static const int kError = -2;
+ 
+     void buildIndices(const Mesh& mesh, const std::vector<std::uint8_t>& faceErrors,
+                       const std::vector<int>& faceGroups);
+     void releaseIndices();
+
+     void drawIndices(const Indices& indices, unsigned int mode) const;
+
+     std::vector<float> positions_; ///< Only kept without buffer objects
+     unsigned int vertexBuffer_ = 0;
+     Indices triangles_;
+     Indices edges_;
+ };
+
+ #endif // MESHRENDERBUFFERS_H
@@ -7,15 +7,56 @@
  *
  * Usage:
  *  - Call `translate()`, `scale()`, or `rotate()` with the required parameters.
+ *  - Or compose matrices from `translation()`, `scaling()` and `rotation()` with
+ *    `compose()` and apply the result in one pass with `apply()`.
  */
 
  #ifndef MESHTRANSFORM_H
  #define MESHTRANSFORM_H
  
  #include "Mesh.h"
+ #include <array>
  
  class MeshTransform {
  public:
+     /**
+      * @brief Affine 4x4 matrix in column-major order, as taken by glMultMatrixd.
+      */
+     using Matrix = std::array<double, 16>;
+
+     /** @brief The identity matrix. */
+     static Matrix identity();
+
+     /** @brief True if m is exactly the identity. */
+     static bool isIdentity(const Matrix& m);
+
+     /** @brief Matrix of translate(). */
+     static Matrix translation(double tx, double ty, double tz);
+
+     /** @brief Matrix of scale(). */
+     static Matrix scaling(double sx, double sy, double sz);
+
+     /** @brief Matrix of rotate(): around X, then Y, then Z (degrees). */
+     static Matrix rotation(double angleX, double angleY, double angleZ);
+
+     /**
+      * @brief Composes two transforms.
+      * @return The matrix applying b first, then a (a * b).
+      */
+     static Matrix compose(const Matrix& a, const Matrix& b);
+
+     /**
+      * @brief Transforms all vertex positions of the mesh in one pass.
+      *
+      * The vertices are split into blocks processed in parallel (TBB); each
+      * block runs a branch-free loop the compiler vectorizes. Normals are left
+      * unchanged, as by translate(), scale() and rotate().
+      *
+      * @param mesh Reference to the Mesh object.
+      * @param m The affine transform.
+      */
+     static void apply(Mesh& mesh, const Matrix& m);
+
      /**
       * @brief Translates the mesh by given offsets.
       * @param mesh Reference to the Mesh object.
@@ -45,4 +86,3 @@
  };
  
  #endif // MESHTRANSFORM_H
- 
\ No newline at end of file
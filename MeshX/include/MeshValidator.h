@@ -11,6 +11,8 @@
  #define MESHVALIDATOR_H
  
  #include "Mesh.h"
+ #include <cstddef>
+ #include <cstdint>
  #include <vector>
  #include <string>
  
@@ -24,6 +26,93 @@
   */
  class MeshValidator {
  public:
+     /**
+      * @brief Validation stages for check(), combinable as bit flags.
+      */
+     enum Stage : unsigned {
+         ClosedSurface = 1,    ///< Every edge is shared by exactly two faces
+         Orientation = 2,      ///< Neighbouring faces run their shared edge in opposite directions
+         SelfIntersection = 4, ///< No two faces intersect, except at shared vertices and edges
+         AllStages = 7
+     };
+
+     /**
+      * @brief Per-face error bits in Report::faceErrors.
+      */
+     enum FaceError : std::uint8_t {
+         OpenEdge = 1,        ///< The face has an edge not shared by exactly two faces
+         FlippedFace = 2,     ///< The face is oriented against its neighbours
+         IntersectingFace = 4 ///< The face intersects another face
+     };
+
+     /**
+      * @brief An edge that is not shared by exactly two faces.
+      */
+     struct EdgeError {
+         int v1;    ///< Smaller vertex index
+         int v2;    ///< Larger vertex index
+         int count; ///< Number of faces using the edge
+     };
+
+     /**
+      * @brief Two faces, a < b.
+      */
+     struct FacePair {
+         std::uint32_t a;
+         std::uint32_t b;
+
+         bool operator<(const FacePair& other) const { return a != other.a ? a < other.a : b < other.b; }
+         bool operator==(const FacePair& other) const { return a == other.a && b == other.b; }
+     };
+
+     /**
+      * @brief Structured result of check().
+      *
+      * Holds compact records instead of strings; message() formats one error
+      * on demand, so callers only pay for the messages they display. Errors
+      * are numbered in the order edgeErrors, nonOrientable, flippedFaces,
+      * intersections.
+      */
+     struct Report {
+         std::vector<EdgeError> edgeErrors;       ///< Bad edges, sorted by (v1, v2)
+         std::vector<std::uint32_t> nonOrientable; ///< One face of each surface that cannot be oriented consistently
+         std::vector<std::uint32_t> flippedFaces;  ///< Faces oriented against the rest of their surface, sorted
+         std::vector<FacePair> intersections;      ///< Intersecting faces, sorted
+         std::vector<std::uint8_t> faceErrors;     ///< Per face: FaceError bits
+         std::size_t errorFaceCount = 0;           ///< Number of faces with any error bit
+
+         /** @brief True if no errors were found. */
+         bool valid() const { return errorCount() == 0; }
+
+         /** @brief Number of error messages. */
+         std::size_t errorCount() const {
+             return edgeErrors.size() + nonOrientable.size() + flippedFaces.size() + intersections.size();
+         }
+
+         /**
+          * @brief Formats one error message.
+          * @param i Index of the error, below errorCount().
+          * @return The message; edge errors use the wording of validate().
+          */
+         std::string message(std::size_t i) const;
+     };
+
+     /**
+      * @brief Runs the selected validation stages.
+      *
+      * Every edge is keyed once, the keys are sorted in parallel (TBB), and a
+      * single scan over the sorted keys yields the bad edges, the per-face
+      * error flags and the face adjacency. Orientation is propagated across
+      * that adjacency surface by surface; the faces in the minority of a
+      * surface are reported as flipped. Self-intersections are found with a
+      * TriangleBVH, traversed in parallel with one query per triangle.
+      *
+      * @param mesh The mesh to be validated.
+      * @param stages Stage bits to run.
+      * @return The errors found and the faces involved.
+      */
+     static Report check(const Mesh& mesh, unsigned stages = AllStages);
+
      /**
       * @brief Validates the mesh for closed surfaces, consistent face orientations, and other issues.
       *
@@ -32,6 +121,8 @@
       * - Consistent face orientations
       * - Other structural integrity checks
       *
+      * Formats every error of check(); prefer check() for large meshes.
+      *
       * @param mesh The mesh to be validated.
       * @return A vector of error messages if issues are found, otherwise an empty vector.
       */
@@ -39,4 +130,3 @@
  };
  
  #endif // MESHVALIDATOR_H
- 
\ No newline at end of file
@@ -3,7 +3,7 @@
  * @brief Defines the MetadataExporter class for exporting mesh metadata to a JSON file.
  *
  * This file provides the MetadataExporter class, which includes functionality to export
- * MeshMetadata objects to a JSON file format.
+ * MeshMetadata objects as JSON, or as its binary CBOR or MessagePack equivalents.
  */
 
  #ifndef METADATA_EXPORTER_H
@@ -15,20 +15,48 @@
  /**
   * @class MetadataExporter
   * @brief Provides functionality to export mesh metadata as JSON.
+  *
+  * The output format follows the file extension: .cbor and .msgpack (or .mpk)
+  * write the same document in binary form, anything else writes indented JSON.
   */
  class MetadataExporter {
  public:
+     /**
+      * @brief Output formats.
+      */
+     enum class Format {
+         Json,
+         Cbor,
+         MessagePack
+     };
+ 
+     /**
+      * @brief Returns the output format for a path from its extension.
+      */
+     static Format formatOf(const std::string& filePath);
+ 
      /**
       * @brief Exports the mesh metadata as JSON to a file.
       *
       * This function writes the provided MeshMetadata object to a specified file
       * in JSON format.
       *
-      * @param filePath The path to the output metadata file (should have a .json extension).
+      * @param filePath The path to the output metadata file (.json, .cbor or .msgpack).
       * @param metadata The MeshMetadata object containing the group metadata.
       * @return True if the file was successfully written, false otherwise.
       */
      static bool exportMetadata(const std::string& filePath, const MeshMetadata& metadata);
+ 
+     /**
+      * @brief Exports the mesh metadata using compact layouts.
+      *
+      * @param filePath The path to the output metadata file; its extension selects the format.
+      * @param metadata The MeshMetadata object containing the group metadata.
+      * @param encoding The layouts passed to MeshMetadata::toJson.
+      * @return True if the file was successfully written, false otherwise.
+      */
+     static bool exportMetadata(const std::string& filePath, const MeshMetadata& metadata,
+                                const MetadataEncoding& encoding);
  };
  
  #endif // METADATA_EXPORTER_H
\ No newline at end of file
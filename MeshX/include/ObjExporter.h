@@ -25,6 +25,8 @@
       *
       * This function takes a mesh and a file path, and exports the mesh to the specified
       * file in the OBJ format.
+      * Only the surface is written: tetrahedrons are skipped, volume meshes
+      * are written with VolumeMeshWriter.
       *
       * @param mesh The mesh to be exported.
       * @param filePath The path to the file where the mesh will be exported.
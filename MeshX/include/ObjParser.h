@@ -18,9 +18,36 @@
   *
   * The ObjParser class provides methods to parse an OBJ file and
   * return a Mesh object.
+  *
+  * By default the file is memory-mapped, cut into newline-aligned chunks and
+  * parsed by several threads, each into its own buffers; the buffers are then
+  * concatenated in file order. Negative (relative) OBJ indices refer to the
+  * elements defined before the line, as in the OBJ specification, and are
+  * fixed up when the chunks are merged. The result is identical to the
+  * line-by-line Streaming mode.
   */
  class ObjParser {
  public:
+     /**
+      * @brief How a file is read.
+      */
+     enum class Mode {
+         Parallel, ///< Memory-mapped, chunked, multi-threaded (default).
+         Streaming ///< One line at a time from a stream.
+     };
+
+     /**
+      * @brief Selects the parser used by parse() and parseSurfaceMesh().
+      * @param mode The parser to use.
+      */
+     void setMode(Mode mode) { mode_ = mode; }
+
+     /**
+      * @brief Sets the number of threads of the Parallel mode.
+      * @param threads Thread count; 0 (default) uses all hardware threads.
+      */
+     void setThreadCount(unsigned threads) { threads_ = threads; }
+
      /**
       * @brief Parses an OBJ file and returns a Mesh.
       *
@@ -42,6 +69,10 @@
       * @return A Mesh object representing the parsed surface of the 3D model.
       */
      Mesh parseSurfaceMesh(const std::string& filePath);
+
+ private:
+     Mode mode_ = Mode::Parallel;
+     unsigned threads_ = 0;
  };
  
  #endif // OBJPARSER_H
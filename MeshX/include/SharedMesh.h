@@ -0,0 +1,70 @@
+/**
+ * @file SharedMesh.h
+ * @brief Defines SharedMesh, a copy-on-write handle to immutable mesh data.
+ */
+
+ #ifndef SHAREDMESH_H
+ #define SHAREDMESH_H
+
+ #include "Mesh.h"
+ #include <memory>
+ #include <utility>
+
+ /**
+  * @class SharedMesh
+  * @brief A Mesh shared between copies of the handle until one of them edits it.
+  *
+  * Copying a SharedMesh copies a pointer; the geometry is read through * and
+  * ->. edit() gives write access, first cloning the mesh if any other handle
+  * or shared_ptr (see share()) still refers to it, so the others keep seeing
+  * the old geometry. This lets scene meshes, undo snapshots and background
+  * jobs hold the same large mesh without copying it.
+  *
+  * Handles are not synchronised: copy and edit them on one thread, and give
+  * other threads the shared_ptr from share().
+  */
+ class SharedMesh {
+ public:
+     /** @brief An empty mesh. */
+     SharedMesh() : SharedMesh(Mesh()) {}
+
+     /** @brief Takes ownership of a mesh. */
+     SharedMesh(Mesh mesh) {
+         std::shared_ptr<Mesh> owned = std::make_shared<Mesh>(std::move(mesh));
+         mutable_ = owned.get();
+         mesh_ = std::move(owned);
+     }
+
+     /** @brief Shares a mesh owned elsewhere; it is cloned on the first edit(). */
+     SharedMesh(std::shared_ptr<const Mesh> mesh)
+         : mesh_(mesh ? std::move(mesh) : std::make_shared<const Mesh>()) {}
+
+     const Mesh& operator*() const { return *mesh_; }
+     const Mesh* operator->() const { return mesh_.get(); }
+
+     /** @brief The mesh as a shared pointer, e.g. for a background job. */
+     const std::shared_ptr<const Mesh>& share() const { return mesh_; }
+
+     /** @brief True if no other handle or share() pointer refers to the mesh. */
+     bool unique() const { return mesh_.use_count() == 1; }
+
+     /**
+      * @brief The mesh for modification, cloned first if it is shared.
+      *
+      * The reference is valid until the handle is assigned or copied and edited again.
+      */
+     Mesh& edit() {
+         if (!mutable_ || !unique()) {
+             std::shared_ptr<Mesh> copy = std::make_shared<Mesh>(*mesh_);
+             mutable_ = copy.get();
+             mesh_ = std::move(copy);
+         }
+         return *mutable_;
+     }
+
+ private:
+     std::shared_ptr<const Mesh> mesh_;
+     Mesh* mutable_ = nullptr; ///< mesh_ when it was created by this class (not const), else null
+ };
+
+ #endif // SHAREDMESH_H
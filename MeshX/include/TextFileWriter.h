@@ -0,0 +1,115 @@
+/**
+ * @file TextFileWriter.h
+ * @brief Declares TextFileWriter, a buffered writer for large text mesh files.
+ */
+
+ #ifndef TEXTFILEWRITER_H
+ #define TEXTFILEWRITER_H
+
+ #include <algorithm>
+ #include <cstddef>
+ #include <fstream>
+ #include <string>
+ #include <thread>
+ #include <vector>
+
+ /**
+  * @class TextFileWriter
+  * @brief Writes line-based text files (OBJ, OFF) from pre-formatted chunks.
+  *
+  * Numbers are formatted with std::to_chars into string buffers instead of
+  * going through stream operators. writeRecords() splits a run of records
+  * (vertices, faces, ...) into chunks, formats a batch of chunks on several
+  * threads, and then writes the batch to the file in order, so the output is
+  * the same as formatting everything on one thread.
+  */
+ class TextFileWriter {
+ public:
+     static const std::size_t kRecordsPerChunk = 1 << 16; ///< Records formatted per task
+
+     /**
+      * @brief Opens (truncates) the file for writing.
+      * @param path The output file; check isOpen() afterwards.
+      */
+     explicit TextFileWriter(const std::string& path);
+
+     /**
+      * @brief True if the file could be opened.
+      */
+     bool isOpen() const { return out_.is_open(); }
+
+     /**
+      * @brief Sets the number of formatting threads.
+      * @param threads Thread count; 0 (default) uses all hardware threads.
+      */
+     void setThreadCount(unsigned threads) { threads_ = threads; }
+
+     /**
+      * @brief Writes a string as is.
+      */
+     void write(const std::string& text) { out_.write(text.data(), static_cast<std::streamsize>(text.size())); }
+
+     /**
+      * @brief Formats and writes records 0 .. count - 1.
+      *
+      * @param count Number of records.
+      * @param format Callable format(std::string& out, std::size_t i) appending
+      *        record i to out. It is called concurrently for different records,
+      *        so it must only read shared state.
+      */
+     template <class Format>
+     void writeRecords(std::size_t count, Format format) {
+         if (count == 0) return;
+         const std::size_t chunks = (count + kRecordsPerChunk - 1) / kRecordsPerChunk;
+         unsigned threads = threads_ ? threads_ : std::max(1u, std::thread::hardware_concurrency());
+         const std::size_t batchSize = std::min<std::size_t>(threads, chunks);
+         std::vector<std::string> buffers(batchSize);
+
+         for (std::size_t firstChunk = 0; firstChunk < chunks; firstChunk += batchSize) {
+             const std::size_t batch = std::min(batchSize, chunks - firstChunk);
+             auto formatChunk = [&](std::size_t b) {
+                 std::string& buffer = buffers[b];
+                 buffer.clear();
+                 const std::size_t begin = (firstChunk + b) * kRecordsPerChunk;
+                 const std::size_t end = std::min(count, begin + kRecordsPerChunk);
+                 for (std::size_t i = begin; i < end; ++i) format(buffer, i);
+             };
+             std::vector<std::thread> workers;
+             for (std::size_t b = 1; b < batch; ++b) workers.emplace_back(formatChunk, b);
+             formatChunk(0);
+             for (auto& worker : workers) worker.join();
+             for (std::size_t b = 0; b < batch; ++b) write(buffers[b]);
+         }
+     }
+
+     /**
+      * @brief Flushes and closes the file.
+      * @return True if every write succeeded.
+      */
+     bool close();
+
+     /**
+      * @brief Appends a number with 6 significant digits, as `stream << value`
+      *        does by default.
+      */
+     static void appendNumber(std::string& out, double value);
+
+     /**
+      * @brief Appends the shortest text that reads back as exactly the same double.
+      */
+     static void appendExact(std::string& out, double value);
+
+     /**
+      * @brief Appends an integer.
+      */
+     static void appendNumber(std::string& out, long long value);
+
+     /** @brief Appends an integer. */
+     static void appendNumber(std::string& out, int value) { appendNumber(out, static_cast<long long>(value)); }
+
+ private:
+     std::ofstream out_;
+     unsigned threads_ = 0;
+ };
+
+ #endif // TEXTFILEWRITER_H
@@ -0,0 +1,112 @@
+/**
+ * @file TriangleBVH.h
+ * @brief Declares TriangleBVH, a bounding volume hierarchy over mesh triangles.
+ */
+
+ #ifndef TRIANGLEBVH_H
+ #define TRIANGLEBVH_H
+
+ #include "Mesh.h"
+ #include <atomic>
+ #include <cstddef>
+ #include <cstdint>
+ #include <vector>
+
+ /**
+  * @class TriangleBVH
+  * @brief Axis-aligned bounding box tree over the triangles of a mesh.
+  *
+  * Polygons are fan-triangulated. The triangles are ordered along a Morton
+  * curve of their centroids (parallel sort) and the tree is built top-down over
+  * that order, splitting each range in half; the two halves of large ranges
+  * are built in parallel (TBB). Leaves hold up to kLeafSize triangles, and the
+  * children of an inner node are stored next to each other.
+  */
+ class TriangleBVH {
+ public:
+     static const std::size_t kLeafSize = 4; ///< Most triangles per leaf
+
+     /**
+      * @brief Axis-aligned box.
+      */
+     struct Box {
+         double min[3];
+         double max[3];
+
+         /** @brief True if the boxes touch or overlap. */
+         bool overlaps(const Box& other) const {
+             return min[0] <= other.max[0] && other.min[0] <= max[0] &&
+                    min[1] <= other.max[1] && other.min[1] <= max[1] &&
+                    min[2] <= other.max[2] && other.min[2] <= max[2];
+         }
+     };
+
+     /**
+      * @brief A triangle of the mesh.
+      */
+     struct Triangle {
+         int v[3];           ///< Vertex indices
+         std::uint32_t face; ///< Face the triangle was cut from
+     };
+
+     /**
+      * @brief Builds the tree over all faces of a mesh.
+      *
+      * Faces with fewer than three corners or with out-of-range vertex indices
+      * are skipped.
+      *
+      * @param mesh The mesh; the tree keeps no reference to it.
+      */
+     explicit TriangleBVH(const Mesh& mesh);
+
+     /** @brief Triangles in tree order. */
+     const std::vector<Triangle>& triangles() const { return triangles_; }
+
+     /** @brief Bounding box of triangle i (tree order). */
+     const Box& bounds(std::size_t i) const { return boxes_[i]; }
+
+     /**
+      * @brief Calls visit(i) for every triangle i whose box overlaps the given box.
+      * @param box The query box.
+      * @param visit Callback taking the triangle index (tree order).
+      */
+     template <class Visit>
+     void query(const Box& box, Visit&& visit) const {
+         if (nodes_.empty()) return;
+         std::uint32_t stack[64];
+         int top = 0;
+         stack[top++] = 0;
+         while (top > 0) {
+             const Node& node = nodes_[stack[--top]];
+             if (!node.box.overlaps(box)) continue;
+             if (node.count > 0) {
+                 for (std::uint32_t i = node.first; i < node.first + node.count; ++i) {
+                     if (boxes_[i].overlaps(box)) visit(static_cast<std::size_t>(i));
+                 }
+             } else {
+                 stack[top++] = node.first;
+                 stack[top++] = node.first + 1;
+             }
+         }
+     }
+
+ private:
+     /**
+      * @brief Tree node: a leaf holds triangles [first, first + count), an
+      * inner node (count == 0) has its children at first and first + 1.
+      */
+     struct Node {
+         Box box;
+         std::uint32_t first;
+         std::uint32_t count;
+     };
+
+     void build(std::uint32_t node, std::uint32_t first, std::uint32_t count);
+
+     std::vector<Triangle> triangles_;
+     std::vector<Box> boxes_;
+     std::vector<Node> nodes_;
+     std::atomic<std::uint32_t> nodeCount_{0};
+ };
+
+ #endif // TRIANGLEBVH_H
@@ -0,0 +1,51 @@
+/**
+ * @file VolumeMeshWriter.h
+ * @brief Declares VolumeMeshWriter, writing tetrahedral meshes for FE tools.
+ */
+
+ #ifndef VOLUMEMESHWRITER_H
+ #define VOLUMEMESHWRITER_H
+
+ #include "Mesh.h"
+ #include <string>
+
+ /**
+  * @class VolumeMeshWriter
+  * @brief Writes the tetrahedrons of a Mesh as MEDIT .mesh or VTK .vtu files.
+  *
+  * Both writers stream from the mesh arrays: MEDIT text is formatted in
+  * parallel chunks (TextFileWriter), and the VTU arrays are appended as raw
+  * binary, copied straight from the mesh or generated chunk by chunk, so no
+  * full-size intermediate is built.
+  *
+  * Besides the tetrahedrons, MEDIT files get the triangular faces of the mesh
+  * (the boundary of a generated volume mesh). Subdomain indices
+  * (Mesh::tetrahedronDomains) become the MEDIT references and the VTU
+  * "Domain" cell array when present.
+  */
+ class VolumeMeshWriter {
+ public:
+     /**
+      * @brief True for the extensions written here (.mesh and .vtu).
+      */
+     static bool isVolumeFormat(const std::string& path);
+
+     /**
+      * @brief Writes by extension: .vtu for VTU, anything else as MEDIT.
+      */
+     static bool write(const std::string& path, const Mesh& mesh);
+
+     /**
+      * @brief Writes a MEDIT .mesh file (1-based indices).
+      * @return True if the file was written; errors are reported on std::cerr.
+      */
+     static bool writeMedit(const std::string& path, const Mesh& mesh);
+
+     /**
+      * @brief Writes a VTK XML unstructured grid with raw appended binary data.
+      * @return True if the file was written; errors are reported on std::cerr.
+      */
+     static bool writeVtu(const std::string& path, const Mesh& mesh);
+ };
+
+ #endif // VOLUMEMESHWRITER_H
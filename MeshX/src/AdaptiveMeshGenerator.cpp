@@ -4,6 +4,8 @@
  */
 
  #include "AdaptiveMeshGenerator.h"
+ #include "MeshIO.h"
+ #include "VolumeMeshWriter.h"
  #include <CGAL/Mesh_triangulation_3.h>
  #include <CGAL/Mesh_complex_3_in_triangulation_3.h>
  #include <CGAL/Mesh_criteria_3.h>
@@ -12,11 +14,122 @@
  #include <CGAL/Polyhedral_mesh_domain_with_features_3.h>
  #include <CGAL/Polygon_mesh_processing/corefinement.h>
  #include <CGAL/Polygon_mesh_processing/triangulate_faces.h>
+ #include <tbb/task_arena.h>
  #include <fstream>
  #include <iostream>
  #include <cstdlib>
+ #include <unordered_map>
+ #include <utility>
  
  namespace PMP = CGAL::Polygon_mesh_processing;
+
+ namespace {
+
+ /** @brief Thrown from inside make_mesh_3 to abandon a cancelled run. */
+ struct Cancelled {};
+
+ /**
+  * @brief Sizing field that checks the cancellation flag on every query.
+  *
+  * make_mesh_3 has no public stop hook, but it queries the sizing field
+  * constantly; throwing from here unwinds the mesher (TBB carries the
+  * exception out of the worker threads).
+  */
+ template <class Field>
+ struct CancellableSizingField {
+     typedef typename Field::FT FT;
+     typedef typename Field::Point_3 Point_3;
+     typedef typename Field::Index Index;
+
+     const Field &field;
+     const std::atomic<bool> *cancelled;
+
+     FT operator()(const Point_3 &p, const int dim, const Index &index) const {
+         if (cancelled && cancelled->load(std::memory_order_relaxed))
+             throw Cancelled();
+         return field(p, dim, index);
+     }
+ };
+
+
+ /**
+  * @brief Numbers complex vertices on first use and copies their positions.
+  */
+ class VertexNumbering {
+ public:
+     explicit VertexNumbering(std::vector<Vertex> &vertices) : vertices_(vertices) {}
+
+     template <class VertexHandle>
+     int operator()(VertexHandle v) {
+         auto inserted = index_.emplace(&*v, static_cast<int>(vertices_.size()));
+         if (inserted.second) {
+             const auto &p = v->point();
+             vertices_.push_back({ CGAL::to_double(p.x()), CGAL::to_double(p.y()), CGAL::to_double(p.z()) });
+         }
+         return inserted.first->second;
+     }
+
+ private:
+     std::vector<Vertex> &vertices_;
+     std::unordered_map<const void*, int> index_; // Vertex address -> position
+ };
+
+ /**
+  * @brief Appends the facets of the complex as triangles, facing out of their cell.
+  */
+ template <class C3t3>
+ void appendBoundary(const C3t3 &c3t3, FaceTable &faces, VertexNumbering &number) {
+     const auto &tr = c3t3.triangulation();
+     faces.reserve(faces.size() + c3t3.number_of_facets_in_complex(),
+                   faces.elements().size() + 3 * c3t3.number_of_facets_in_complex());
+     for (auto f = c3t3.facets_in_complex_begin(); f != c3t3.facets_in_complex_end(); ++f) {
+         auto facet = *f;
+         if (!c3t3.is_in_complex(facet.first))
+             facet = tr.mirror_facet(facet);
+         const auto cell = facet.first;
+         const int i = facet.second;
+         auto a = cell->vertex((i + 1) & 3), b = cell->vertex((i + 2) & 3), c = cell->vertex((i + 3) & 3);
+         // Turn the normal away from the opposite vertex of the cell
+         const auto &pa = a->point(), &pb = b->point(), &pc = c->point(), &pd = cell->vertex(i)->point();
+         const double u[3] = { pb.x() - pa.x(), pb.y() - pa.y(), pb.z() - pa.z() };
+         const double w[3] = { pc.x() - pa.x(), pc.y() - pa.y(), pc.z() - pa.z() };
+         const double n[3] = { u[1] * w[2] - u[2] * w[1], u[2] * w[0] - u[0] * w[2], u[0] * w[1] - u[1] * w[0] };
+         if (n[0] * (pd.x() - pa.x()) + n[1] * (pd.y() - pa.y()) + n[2] * (pd.z() - pa.z()) > 0)
+             std::swap(b, c);
+         faces.addFace({ FaceElement(number(a)), FaceElement(number(b)), FaceElement(number(c)) });
+     }
+ }
+
+ /**
+  * @brief Extracts the cells of the complex into a flat tetrahedron array, plus the boundary.
+  */
+ template <class C3t3>
+ void extractVolume(const C3t3 &c3t3, Mesh &mesh) {
+     Mesh result;
+     VertexNumbering number(result.vertices);
+     result.tetrahedrons.reserve(c3t3.number_of_cells_in_complex());
+     result.tetrahedronDomains.reserve(c3t3.number_of_cells_in_complex());
+     for (auto c = c3t3.cells_in_complex_begin(); c != c3t3.cells_in_complex_end(); ++c) {
+         result.tetrahedrons.push_back({ number(c->vertex(0)), number(c->vertex(1)),
+                                         number(c->vertex(2)), number(c->vertex(3)) });
+         result.tetrahedronDomains.push_back(static_cast<int>(c3t3.subdomain_index(c)));
+     }
+     appendBoundary(c3t3, result.faces, number);
+     mesh = std::move(result);
+ }
+
+ /**
+  * @brief Extracts only the boundary triangles and the vertices they use.
+  */
+ template <class C3t3>
+ void extractBoundary(const C3t3 &c3t3, Mesh &mesh) {
+     Mesh result;
+     VertexNumbering number(result.vertices);
+     appendBoundary(c3t3, result.faces, number);
+     mesh = std::move(result);
+ }
+
+ } // namespace
  
  #ifdef CGAL_CONCURRENT_MESH_3
    typedef CGAL::Parallel_tag Concurrency_tag;
@@ -28,6 +141,12 @@
   * @brief Default constructor for the AdaptiveMeshGenerator class.
   */
  AdaptiveMeshGenerator::AdaptiveMeshGenerator() {}
+
+ const char* AdaptiveMeshGenerator::stageName(int stage) {
+     static const char* names[StageCount] = { "Reading input", "Boolean difference", "Mesh domain",
+                                              "Meshing", "Writing output", "Done" };
+     return stage >= 0 && stage < StageCount ? names[stage] : "";
+ }
  
  /**
   * @brief Generates a volume mesh by computing the Boolean difference between a cube and an inner mesh.
@@ -36,21 +155,107 @@
   * between the cube and the inner mesh, and generates a volume mesh based on the difference. The resulting mesh is
   * saved to an output file.
   *
-  * @param innerMeshFile The file path to the inner mesh.
-  * @param cubeSize The size of the cube (bounding volume) to be created.
+  * @param innerMeshFile The file path to the inner mesh (OFF, OBJ, PLY or MESHBIN).
+  * @param options The cube size, meshing criteria and TBB arena size.
   * @param outputMeshFile The file path where the output mesh will be saved.
+  * @param progress Optional progress and cancellation state.
   * @return True if the volume mesh generation is successful, false otherwise.
   */
  bool AdaptiveMeshGenerator::generateVolumeMesh(const std::string &innerMeshFile,
-                                                  int cubeSize,
-                                                  const std::string &outputMeshFile)
+                                                  const Options &options,
+                                                  const std::string &outputMeshFile,
+                                                  Progress *progress,
+                                                  Mesh *volumeMesh,
+                                                  Mesh *boundaryMesh)
  {
-     // 1. Read the inner object from file.
-     SurfaceMesh inner;
-     std::ifstream inner_in(innerMeshFile);
-     if (!inner_in || !(inner_in >> inner)) {
-         std::cerr << "Error: Cannot read file " << innerMeshFile << std::endl;
+     tbb::task_arena arena(options.threads > 0 ? options.threads : tbb::task_arena::automatic);
+     bool success = false;
+     try {
+         success = arena.execute([&]() {
+             return run(innerMeshFile, options, outputMeshFile, progress, volumeMesh, boundaryMesh);
+         });
+     } catch (const Cancelled &) {
+         std::cerr << "Volume mesh generation cancelled." << std::endl;
+     }
+     if (progress)
+         progress->stage = Done;
+     return success;
+ }
+
+ /**
+  * @brief Starts generateVolumeMesh on a background thread.
+  * @return Future holding the result.
+  */
+ std::future<bool> AdaptiveMeshGenerator::generateVolumeMeshAsync(const std::string &innerMeshFile,
+                                                                  const Options &options,
+                                                                  const std::string &outputMeshFile,
+                                                                  std::shared_ptr<Progress> progress,
+                                                                  std::shared_ptr<Mesh> boundaryMesh)
+ {
+     return std::async(std::launch::async, [innerMeshFile, options, outputMeshFile, progress, boundaryMesh]() {
+         AdaptiveMeshGenerator generator;
+         return generator.generateVolumeMesh(innerMeshFile, options, outputMeshFile, progress.get(),
+                                             nullptr, boundaryMesh.get());
+     });
+ }
+
+ /**
+  * @brief The generation itself, run inside the arena.
+  */
+ bool AdaptiveMeshGenerator::run(const std::string &innerMeshFile,
+                                 const Options &options,
+                                 const std::string &outputMeshFile,
+                                 Progress *progress,
+                                 Mesh *volumeMesh,
+                                 Mesh *boundaryMesh)
+ {
+     // Moves to the next stage; false once cancelled
+     auto advance = [progress](Stage stage) {
+         if (!progress)
+             return true;
+         progress->stage = stage;
+         return !progress->cancelled.load();
+     };
+     auto cancelled = [&]() {
+         std::cerr << "Volume mesh generation cancelled." << std::endl;
          return false;
+     };
+
+     if (!advance(Reading))
+         return cancelled();
+     // 1. Read the inner object from file (OFF directly, other formats through MeshIO).
+     SurfaceMesh inner;
+     if (MeshIO::formatOf(innerMeshFile) == MeshIO::Format::Off) {
+         std::ifstream inner_in(innerMeshFile);
+         if (!inner_in || !(inner_in >> inner)) {
+             std::cerr << "Error: Cannot read file " << innerMeshFile << std::endl;
+             return false;
+         }
+     } else {
+         Mesh innerMesh;
+         if (!MeshIO::read(innerMeshFile, innerMesh)) {
+             std::cerr << "Error: Cannot read file " << innerMeshFile << std::endl;
+             return false;
+         }
+         std::vector<SurfaceMesh::Vertex_index> vertices;
+         vertices.reserve(innerMesh.vertices.size());
+         for (const auto &v : innerMesh.vertices)
+             vertices.push_back(inner.add_vertex(Point(v.x, v.y, v.z)));
+         std::vector<SurfaceMesh::Vertex_index> corners;
+         for (const auto &face : innerMesh.faces) {
+             corners.clear();
+             for (const auto &fe : face.elements) {
+                 if (fe.vertexIndex < 0 || fe.vertexIndex >= static_cast<int>(vertices.size())) {
+                     std::cerr << "Error: Invalid vertex index in " << innerMeshFile << std::endl;
+                     return false;
+                 }
+                 corners.push_back(vertices[fe.vertexIndex]);
+             }
+             if (inner.add_face(corners) == SurfaceMesh::null_face()) {
+                 std::cerr << "Error: Non-manifold face in " << innerMeshFile << std::endl;
+                 return false;
+             }
+         }
      }
      if (!CGAL::is_closed(inner)) {
          std::cerr << "Error: Inner mesh is not closed." << std::endl;
@@ -60,6 +265,9 @@
      PMP::triangulate_faces(inner);
  
      // 2. Create a cube (outer bounding volume) with corners at (-cubeSize,...)
+     if (!advance(Difference))
+         return cancelled();
+     const double cubeSize = options.cubeSize;
      SurfaceMesh cube;
      {
          Point p0(-cubeSize, -cubeSize, -cubeSize), p1(cubeSize, -cubeSize, -cubeSize);
@@ -94,29 +302,51 @@
      }
  
      // 5. Create a mesh domain with features from the difference polyhedron.
+     if (!advance(Domain))
+         return cancelled();
      typedef CGAL::Polyhedral_mesh_domain_with_features_3<Kernel, Polyhedron> Mesh_domain;
      Mesh_domain domain(diff_poly);
      // Optionally, you can call: domain.detect_features();
  
      // 6. Define an adaptive sizing field using CGAL's Sizing_field_with_aabb_tree.
      typedef CGAL::Sizing_field_with_aabb_tree<Kernel, Mesh_domain> Sizing_field;
-     Sizing_field sizing_field(0.7, domain);
+     Sizing_field base_sizing_field(options.sizingField, domain);
+     CancellableSizingField<Sizing_field> sizing_field{ base_sizing_field, progress ? &progress->cancelled : nullptr };
  
      // 7. Set up mesh criteria.
      typedef CGAL::Mesh_triangulation_3<Mesh_domain, CGAL::Default, Concurrency_tag>::type Tr;
      typedef CGAL::Mesh_complex_3_in_triangulation_3<Tr, Mesh_domain::Corner_index, Mesh_domain::Curve_index> C3t3;
      typedef CGAL::Mesh_criteria_3<Tr> Mesh_criteria;
      Mesh_criteria criteria(params::edge_size(sizing_field).
-                            edge_distance(0.01).
-                            facet_angle(25).
+                            edge_distance(options.edgeDistance).
+                            facet_angle(options.facetAngle).
                             facet_size(sizing_field).
-                            facet_distance(0.01).
-                            cell_radius_edge_ratio(3).
+                            facet_distance(options.facetDistance).
+                            cell_radius_edge_ratio(options.cellRadiusEdgeRatio).
                             cell_size(sizing_field));
  
      // 8. Generate the volume mesh.
+     if (!advance(Meshing))
+         return cancelled();
      C3t3 c3t3 = CGAL::make_mesh_3<C3t3>(domain, criteria, params::no_exude().no_perturb());
-     CGAL::dump_c3t3(c3t3, outputMeshFile.c_str());
+     if (!advance(Writing))
+         return cancelled();
+
+     // 9. Extract and write. The complex is freed before streaming the arrays.
+     if (boundaryMesh)
+         extractBoundary(c3t3, *boundaryMesh);
+     const bool streamed = VolumeMeshWriter::isVolumeFormat(outputMeshFile);
+     if (!outputMeshFile.empty() && !streamed)
+         CGAL::dump_c3t3(c3t3, outputMeshFile.c_str());
+     if (streamed || volumeMesh) {
+         Mesh volume;
+         extractVolume(c3t3, volume);
+         c3t3.clear();
+         if (streamed && !VolumeMeshWriter::write(outputMeshFile, volume))
+             return false;
+         if (volumeMesh)
+             *volumeMesh = std::move(volume);
+     }
  
      std::cout << "Mesh generation complete. Output written to " << outputMeshFile << std::endl;
      return true;
@@ -0,0 +1,427 @@
+/**
+ * @file BatchPipeline.cpp
+ * @brief Implementation of BatchPipeline.
+ */
+
+ #include "BatchPipeline.h"
+ #include "FaceCentroidGrid.h"
+ #include "MeshBooleanOperations.h"
+ #include "MeshConverter.h"
+ #include "MeshIO.h"
+ #include "MetadataExporter.h"
+ #include "ObjParser.h"
+ #include "Timer.h"
+ #include <tbb/global_control.h>
+ #include <algorithm>
+ #include <atomic>
+ #include <filesystem>
+ #include <fstream>
+ #include <iostream>
+ #include <numeric>
+ #include <stdexcept>
+ #include <thread>
+ #include "nlohmann/json.hpp"
+
+ using json = nlohmann::json;
+
+ namespace {
+
+ const std::size_t kLoggedErrors = 5; ///< Validation messages logged per input
+
+ /** @brief Reads [x, y, z], or a single number for all three. */
+ std::array<double, 3> readTriple(const json& value, double fallback) {
+     if (value.is_number()) {
+         const double v = value.get<double>();
+         return {v, v, v};
+     }
+     if (value.is_array() && value.size() == 3)
+         return {value[0].get<double>(), value[1].get<double>(), value[2].get<double>()};
+     if (!value.is_null()) throw std::runtime_error("expected a number or [x, y, z]: " + value.dump());
+     return {fallback, fallback, fallback};
+ }
+
+ /**
+  * @brief Reads an input: a file name, or {"file", "translate", "scale", "rotate"}
+  * applied like the GUI (translate, then scale, then rotate in degrees), or
+  * {"file", "matrix"} with 16 column-major values.
+  */
+ BatchPipeline::Input readInput(const json& value) {
+     BatchPipeline::Input input;
+     if (value.is_string()) {
+         input.file = value.get<std::string>();
+         return input;
+     }
+     input.file = value.at("file").get<std::string>();
+     if (value.contains("matrix")) {
+         const json& matrix = value.at("matrix");
+         if (!matrix.is_array() || matrix.size() != 16) throw std::runtime_error("\"matrix\" needs 16 values");
+         for (std::size_t i = 0; i < 16; ++i) input.transform[i] = matrix[i].get<double>();
+         return input;
+     }
+     const auto t = readTriple(value.value("translate", json()), 0.0);
+     const auto s = readTriple(value.value("scale", json()), 1.0);
+     const auto r = readTriple(value.value("rotate", json()), 0.0);
+     input.transform = MeshTransform::compose(MeshTransform::rotation(r[0], r[1], r[2]),
+         MeshTransform::compose(MeshTransform::scaling(s[0], s[1], s[2]), MeshTransform::translation(t[0], t[1], t[2])));
+     return input;
+ }
+
+ BatchPipeline::Group readGroup(const json& value) {
+     BatchPipeline::Group group;
+     GroupMetadata& g = group.metadata;
+     g.groupName = value.at("name").get<std::string>();
+     const json bc = value.value("boundaryCondition", json::object());
+     g.boundaryCondition.type = bc.value("type", std::string("fixed"));
+     g.boundaryCondition.parameters = bc.value("parameters", std::vector<double>{0.0});
+     const json material = value.value("materialProperties", json::object());
+     g.materialProperties.density = material.value("density", 7850.0);
+     g.materialProperties.elasticModulus = material.value("elasticModulus", 210e9);
+     g.materialProperties.poissonRatio = material.value("poissonRatio", 0.3);
+     g.elementTags = value.value("elementTags", std::vector<std::string>());
+     const json faces = value.value("faces", json("all"));
+     if (faces.is_string() && faces.get<std::string>() == "all")
+         group.allFaces = true;
+     else
+         g.faceIndices = faces.get<std::vector<int>>();
+     return group;
+ }
+
+ BatchPipeline::Job readJob(const json& value, std::size_t index) {
+     BatchPipeline::Job job;
+     job.name = value.value("name", "job" + std::to_string(index + 1));
+     for (const json& input : value.at("inputs")) job.inputs.push_back(readInput(input));
+     if (job.inputs.empty()) throw std::runtime_error("no inputs");
+
+     const std::string validation = value.value("validate", std::string("report"));
+     if (validation == "none") job.validation = BatchPipeline::Validation::None;
+     else if (validation == "report") job.validation = BatchPipeline::Validation::Report;
+     else if (validation == "require") job.validation = BatchPipeline::Validation::Require;
+     else throw std::runtime_error("\"validate\" must be none, report or require");
+
+     const std::string boolean = value.value("boolean", std::string("none"));
+     if (boolean == "none") job.boolean = BatchPipeline::Boolean::None;
+     else if (boolean == "union") job.boolean = BatchPipeline::Boolean::Union;
+     else if (boolean == "intersection") job.boolean = BatchPipeline::Boolean::Intersection;
+     else if (boolean == "difference") job.boolean = BatchPipeline::Boolean::Difference;
+     else throw std::runtime_error("\"boolean\" must be none, union, intersection or difference");
+     if (job.boolean == BatchPipeline::Boolean::None && job.inputs.size() != 1)
+         throw std::runtime_error("several inputs need a \"boolean\" operation");
+
+     job.output = value.value("output", std::string());
+     if (value.contains("volume")) {
+         const json& volume = value.at("volume");
+         AdaptiveMeshGenerator::Options& o = job.volumeOptions;
+         job.volumeOutput = volume.at("file").get<std::string>();
+         o.cubeSize = volume.value("cubeSize", o.cubeSize);
+         o.sizingField = volume.value("sizingField", o.sizingField);
+         o.edgeDistance = volume.value("edgeDistance", o.edgeDistance);
+         o.facetAngle = volume.value("facetAngle", o.facetAngle);
+         o.facetDistance = volume.value("facetDistance", o.facetDistance);
+         o.cellRadiusEdgeRatio = volume.value("cellRadiusEdgeRatio", o.cellRadiusEdgeRatio);
+         o.threads = volume.value("threads", o.threads);
+         if (job.output.empty()) throw std::runtime_error("\"volume\" meshes the \"output\" file, which is missing");
+     }
+     if (value.contains("metadata")) {
+         const json& metadata = value.at("metadata");
+         job.metadataOutput = metadata.at("file").get<std::string>();
+         for (const json& group : metadata.value("groups", json::array())) job.groups.push_back(readGroup(group));
+         job.centroids = metadata.value("centroids", false);
+         job.faceVertices = metadata.value("faceVertices", false);
+         job.encoding.faceRanges = metadata.value("faceRanges", false);
+         job.encoding.columnar = metadata.value("columnar", false);
+         job.encoding.vertexReferences = metadata.value("vertexReferences", false);
+     }
+     return job;
+ }
+
+ /** @brief Cache key of an input: its canonical path where it exists. */
+ std::string inputKey(const std::string& file) {
+     std::error_code ec;
+     const std::filesystem::path canonical = std::filesystem::weakly_canonical(file, ec);
+     return ec ? file : canonical.string();
+ }
+
+ } // namespace
+
+ bool BatchPipeline::loadJobFile(const std::string& path, std::vector<Job>& jobs,
+                                 unsigned& threads, unsigned& concurrentJobs) {
+     std::ifstream file(path);
+     if (!file.is_open()) {
+         std::cerr << "Error: Cannot open job file: " << path << std::endl;
+         return false;
+     }
+     std::size_t index = 0;
+     try {
+         const json root = json::parse(file);
+         if (root.contains("threads")) threads = root.at("threads").get<unsigned>();
+         if (root.contains("concurrentJobs")) concurrentJobs = root.at("concurrentJobs").get<unsigned>();
+         std::vector<Job> read;
+         for (const json& job : root.at("jobs")) {
+             read.push_back(readJob(job, index));
+             ++index;
+         }
+         jobs.swap(read);
+         return true;
+     } catch (const std::exception& ex) {
+         std::cerr << "Error: Invalid job file " << path << " (job " << index + 1 << "): " << ex.what() << std::endl;
+         return false;
+     }
+ }
+
+ BatchPipeline::BatchPipeline(unsigned threads, unsigned concurrentJobs)
+     : threads_(threads ? threads : std::max(1u, std::thread::hardware_concurrency())),
+       concurrentJobs_(concurrentJobs) {}
+
+ std::vector<BatchPipeline::Result> BatchPipeline::run(const std::vector<Job>& jobs,
+                                                       const std::function<void(const Result&)>& onFinished) {
+     std::vector<Result> results(jobs.size());
+     if (jobs.empty()) return results;
+
+     // Count the users of every input, so it is read once and dropped after its last job
+     cache_.clear();
+     for (const Job& job : jobs) {
+         for (const Input& input : job.inputs) {
+             CachedInput& cached = cache_[inputKey(input.file)];
+             ++cached.users;
+             cached.validate = cached.validate || job.validation != Validation::None;
+         }
+     }
+
+     const unsigned concurrency = std::max(1u, std::min<unsigned>(concurrentJobs_ ? concurrentJobs_ : threads_,
+                                                                   static_cast<unsigned>(jobs.size())));
+     parserThreads_ = std::max(1u, threads_ / concurrency);
+     tbb::global_control budget(tbb::global_control::max_allowed_parallelism, threads_);
+
+     std::atomic<std::size_t> next(0);
+     std::mutex reportMutex;
+     auto worker = [&]() {
+         for (std::size_t i = next++; i < jobs.size(); i = next++) {
+             Result& result = results[i];
+             result.name = jobs[i].name;
+             Timer timer;
+             try {
+                 result.success = runJob(jobs[i], result);
+             } catch (const std::exception& ex) {
+                 result.log.push_back(std::string("Error: ") + ex.what());
+                 result.success = false;
+             }
+             result.milliseconds = timer.elapsed();
+             if (onFinished) {
+                 std::lock_guard<std::mutex> lock(reportMutex);
+                 onFinished(result);
+             }
+         }
+     };
+     std::vector<std::thread> pool;
+     for (unsigned t = 1; t < concurrency; ++t) pool.emplace_back(worker);
+     worker();
+     for (std::thread& thread : pool) thread.join();
+     cache_.clear();
+     return results;
+ }
+
+ std::shared_ptr<const BatchPipeline::LoadedInput> BatchPipeline::acquireInput(const std::string& key,
+                                                                               const std::string& file) {
+     std::unique_lock<std::mutex> lock(cacheMutex_);
+     CachedInput& cached = cache_[key];
+     if (cached.loaded.valid()) {
+         auto loaded = cached.loaded;
+         lock.unlock();
+         return loaded.get();
+     }
+     // First user: read it here, the others wait on the future
+     std::promise<std::shared_ptr<const LoadedInput>> promise;
+     cached.loaded = promise.get_future().share();
+     const bool validate = cached.validate;
+     lock.unlock();
+
+     auto loaded = std::make_shared<LoadedInput>();
+     Timer timer;
+     auto mesh = std::make_shared<Mesh>();
+     bool ok = false;
+     try {
+         if (MeshIO::formatOf(file) == MeshIO::Format::Obj) {
+             ObjParser parser;
+             parser.setThreadCount(parserThreads_);
+             *mesh = parser.parse(file);
+             ok = true;
+         } else {
+             ok = MeshIO::read(file, *mesh);
+         }
+         if (ok && validate) {
+             loaded->validation = MeshValidator::check(*mesh);
+             loaded->validated = true;
+         }
+     } catch (const std::exception& ex) {
+         std::cerr << "Error: Cannot read " << file << ": " << ex.what() << std::endl;
+         ok = false;
+     }
+     if (ok) loaded->mesh = mesh;
+     loaded->milliseconds = timer.elapsed();
+     promise.set_value(loaded);
+     return loaded;
+ }
+
+ void BatchPipeline::releaseInput(const std::string& key) {
+     std::lock_guard<std::mutex> lock(cacheMutex_);
+     auto it = cache_.find(key);
+     if (it != cache_.end() && --it->second.users <= 0) cache_.erase(it);
+ }
+
+ bool BatchPipeline::runJob(const Job& job, Result& result) {
+     auto log = [&result](const std::string& line) { result.log.push_back(line); };
+
+     // Inputs stay acquired until their meshes have been used
+     struct Lease {
+         BatchPipeline& pipeline;
+         std::vector<std::string> keys;
+         void release() {
+             for (const std::string& key : keys) pipeline.releaseInput(key);
+             keys.clear();
+         }
+         ~Lease() { release(); }
+     } lease{*this, {}};
+
+     std::vector<std::shared_ptr<const LoadedInput>> inputs;
+     for (const Input& input : job.inputs) {
+         lease.keys.push_back(inputKey(input.file));
+         inputs.push_back(acquireInput(lease.keys.back(), input.file));
+         const LoadedInput& loaded = *inputs.back();
+         if (!loaded.mesh) {
+             log("Cannot read " + input.file);
+             return false;
+         }
+         log("Read " + input.file + ": " + std::to_string(loaded.mesh->faces.size()) + " faces (" +
+             std::to_string(loaded.milliseconds) + " ms)");
+         if (job.validation == Validation::None || !loaded.validated) continue;
+         const MeshValidator::Report& report = loaded.validation;
+         if (report.valid()) {
+             log("Valid: " + input.file);
+             continue;
+         }
+         log(std::to_string(report.errorCount()) + " validation errors in " + input.file);
+         for (std::size_t i = 0; i < std::min(report.errorCount(), kLoggedErrors); ++i) log("  " + report.message(i));
+         if (job.validation == Validation::Require) return false;
+     }
+
+     // Transform and combine
+     std::shared_ptr<const Mesh> mesh;
+     if (job.boolean == Boolean::None) {
+         const Input& input = job.inputs.front();
+         if (MeshTransform::isIdentity(input.transform)) {
+             mesh = inputs.front()->mesh;
+         } else {
+             auto transformed = std::make_shared<Mesh>(*inputs.front()->mesh);
+             MeshTransform::apply(*transformed, input.transform);
+             mesh = transformed;
+         }
+     } else {
+         MeshConverter converter;
+         std::vector<MeshBooleanOperations::Polyhedron> operands(inputs.size());
+         for (std::size_t i = 0; i < inputs.size(); ++i) {
+             bool converted;
+             if (MeshTransform::isIdentity(job.inputs[i].transform)) {
+                 converted = converter.convertMeshToPolyhedron(*inputs[i]->mesh, operands[i]);
+             } else {
+                 Mesh transformed = *inputs[i]->mesh;
+                 MeshTransform::apply(transformed, job.inputs[i].transform);
+                 converted = converter.convertMeshToPolyhedron(transformed, operands[i]);
+             }
+             if (!converted) {
+                 log("Cannot convert " + job.inputs[i].file + " for the boolean operation");
+                 return false;
+             }
+         }
+         inputs.clear();
+         lease.release(); // The inputs are no longer needed by this job
+
+         Timer timer;
+         bool ok = false;
+         const char* name = "";
+         switch (job.boolean) {
+         case Boolean::Union: ok = MeshBooleanOperations::computeUnionInPlace(operands); name = "Union"; break;
+         case Boolean::Intersection: ok = MeshBooleanOperations::computeIntersectionInPlace(operands); name = "Intersection"; break;
+         case Boolean::Difference: ok = MeshBooleanOperations::computeDifferenceInPlace(operands); name = "Difference"; break;
+         case Boolean::None: break;
+         }
+         if (!ok) {
+             log(std::string(name) + " failed");
+             return false;
+         }
+         auto combined = std::make_shared<Mesh>();
+         if (!converter.convertPolyhedronToMesh(operands.front(), *combined)) {
+             log("Cannot convert the boolean result");
+             return false;
+         }
+         log(std::string(name) + ": " + std::to_string(combined->faces.size()) + " faces (" +
+             std::to_string(timer.elapsed()) + " ms)");
+         mesh = combined;
+     }
+     inputs.clear();
+     lease.release();
+
+     if (!job.output.empty()) {
+         if (!MeshIO::write(job.output, *mesh)) {
+             log("Cannot write " + job.output);
+             return false;
+         }
+         log("Wrote " + job.output);
+     }
+
+     if (!job.volumeOutput.empty()) {
+         Timer timer;
+         AdaptiveMeshGenerator generator;
+         if (!generator.generateVolumeMesh(job.output, job.volumeOptions, job.volumeOutput)) {
+             log("Volume meshing of " + job.output + " failed");
+             return false;
+         }
+         log("Wrote volume mesh " + job.volumeOutput + " (" + std::to_string(timer.elapsed()) + " ms)");
+     }
+
+     if (!job.metadataOutput.empty()) {
+         const bool spatial = job.centroids || job.faceVertices;
+         const int faceCount = static_cast<int>(mesh->faces.size());
+         FaceCentroidGrid grid;
+         if (spatial) grid.build(*mesh);
+         MeshMetadata metadata;
+         metadata.setFaceCount(mesh->faces.size());
+         for (const Group& spec : job.groups) {
+             GroupMetadata group = spec.metadata;
+             if (spec.allFaces) {
+                 group.faceIndices.resize(mesh->faces.size());
+                 std::iota(group.faceIndices.begin(), group.faceIndices.end(), 0);
+             } else {
+                 const std::size_t listed = group.faceIndices.size();
+                 group.faceIndices.erase(std::remove_if(group.faceIndices.begin(), group.faceIndices.end(),
+                                                        [faceCount](int f) { return f < 0 || f >= faceCount; }),
+                                         group.faceIndices.end());
+                 if (group.faceIndices.size() != listed)
+                     log("Group " + group.groupName + ": dropped " + std::to_string(listed - group.faceIndices.size()) +
+                         " faces outside the result");
+             }
+             if (spatial) {
+                 group.spatialData.reserve(group.faceIndices.size());
+                 for (int f : group.faceIndices) {
+                     FaceSpatialData fsd;
+                     fsd.faceIndex = f;
+                     fsd.centroid = grid.centroids()[f];
+                     if (job.faceVertices) {
+                         for (const auto& elem : mesh->faces[f].elements) {
+                             const Vertex& v = mesh->vertices[elem.vertexIndex];
+                             fsd.vertices.push_back({v.x, v.y, v.z});
+                             fsd.vertexIndices.push_back(elem.vertexIndex);
+                         }
+                     }
+                     group.spatialData.push_back(std::move(fsd));
+                 }
+             }
+             metadata.addGroupMetadata(group);
+         }
+         if (!MetadataExporter::exportMetadata(job.metadataOutput, metadata, job.encoding)) {
+             log("Cannot write " + job.metadataOutput);
+             return false;
+         }
+         log("Wrote metadata " + job.metadataOutput);
+     }
+     return true;
+ }
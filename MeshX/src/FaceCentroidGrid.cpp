@@ -0,0 +1,121 @@
+/**
+ * @file FaceCentroidGrid.cpp
+ * @brief Implementation of FaceCentroidGrid.
+ */
+
+ #include "FaceCentroidGrid.h"
+ #include <algorithm>
+ #include <cmath>
+ #include <limits>
+
+ void FaceCentroidGrid::clear() {
+     centroids_.clear();
+     cellStart_.clear();
+     cellFaces_.clear();
+     columns_ = rows_ = 0;
+ }
+
+ namespace {
+
+ // Clamped before the conversion: query rectangles may lie far outside the grid
+ int cellIndex(double t, int count) {
+     return static_cast<int>(std::min(static_cast<double>(count - 1), std::max(0.0, std::floor(t))));
+ }
+
+ } // namespace
+
+ int FaceCentroidGrid::cellX(double x) const {
+     return cellIndex((x - minX_) / cellSize_, columns_);
+ }
+
+ int FaceCentroidGrid::cellY(double y) const {
+     return cellIndex((y - minY_) / cellSize_, rows_);
+ }
+
+ void FaceCentroidGrid::build(const Mesh& mesh) {
+     clear();
+     const std::size_t faceCount = mesh.faces.size();
+     const int vertexCount = static_cast<int>(mesh.vertices.size());
+     centroids_.assign(faceCount, {0.0, 0.0, 0.0});
+     std::vector<char> valid(faceCount, 0);
+
+     double maxX = -std::numeric_limits<double>::infinity(), maxY = maxX;
+     minX_ = minY_ = std::numeric_limits<double>::infinity();
+     for (std::size_t f = 0; f < faceCount; ++f) {
+         const auto face = mesh.faces[f];
+         const std::size_t n = face.elements.size();
+         if (n == 0) continue;
+         std::array<double, 3>& c = centroids_[f];
+         bool ok = true;
+         for (const auto& elem : face.elements) {
+             if (elem.vertexIndex < 0 || elem.vertexIndex >= vertexCount) {
+                 ok = false;
+                 break;
+             }
+             const Vertex& v = mesh.vertices[elem.vertexIndex];
+             c[0] += v.x;
+             c[1] += v.y;
+             c[2] += v.z;
+         }
+         if (!ok) continue;
+         c[0] /= n;
+         c[1] /= n;
+         c[2] /= n;
+         valid[f] = 1;
+         minX_ = std::min(minX_, c[0]);
+         maxX = std::max(maxX, c[0]);
+         minY_ = std::min(minY_, c[1]);
+         maxY = std::max(maxY, c[1]);
+     }
+     const std::size_t bucketed = static_cast<std::size_t>(std::count(valid.begin(), valid.end(), 1));
+     if (bucketed == 0) {
+         columns_ = rows_ = 1;
+         cellStart_.assign(2, 0);
+         return;
+     }
+
+     // Square cells, about two faces per cell over the bounding rectangle
+     const double width = std::max(maxX - minX_, 0.0), height = std::max(maxY - minY_, 0.0);
+     const double area = std::max(width * height, 1e-300);
+     cellSize_ = std::sqrt(2.0 * area / static_cast<double>(bucketed));
+     if (!(cellSize_ > 0.0)) cellSize_ = std::max(std::max(width, height), 1.0);
+     const double maxCells = 4.0 * static_cast<double>(bucketed) + 1.0;
+     columns_ = static_cast<int>(std::min(maxCells, std::floor(width / cellSize_) + 1.0));
+     rows_ = static_cast<int>(std::min(maxCells / columns_, std::floor(height / cellSize_) + 1.0));
+     rows_ = std::max(rows_, 1);
+     cellSize_ = std::max(cellSize_, std::max(width / columns_, height / rows_));
+
+     // Counting sort of the faces by cell
+     const std::size_t cellCount = static_cast<std::size_t>(columns_) * rows_;
+     cellStart_.assign(cellCount + 1, 0);
+     std::vector<std::uint32_t> cellOf(faceCount, 0);
+     for (std::size_t f = 0; f < faceCount; ++f) {
+         if (!valid[f]) continue;
+         cellOf[f] = static_cast<std::uint32_t>(cellY(centroids_[f][1]) * columns_ + cellX(centroids_[f][0]));
+         ++cellStart_[cellOf[f] + 1];
+     }
+     for (std::size_t c = 0; c < cellCount; ++c) cellStart_[c + 1] += cellStart_[c];
+     cellFaces_.resize(bucketed);
+     std::vector<std::uint32_t> fill(cellStart_.begin(), cellStart_.end() - 1);
+     for (std::size_t f = 0; f < faceCount; ++f) {
+         if (valid[f]) cellFaces_[fill[cellOf[f]]++] = static_cast<int>(f);
+     }
+ }
+
+ std::vector<int> FaceCentroidGrid::query(double x0, double y0, double x1, double y1) const {
+     std::vector<int> faces;
+     if (cellFaces_.empty() || x1 < x0 || y1 < y0) return faces;
+     const int cx0 = cellX(x0), cx1 = cellX(x1);
+     const int cy0 = cellY(y0), cy1 = cellY(y1);
+     for (int cy = cy0; cy <= cy1; ++cy) {
+         for (int cx = cx0; cx <= cx1; ++cx) {
+             const std::size_t cell = static_cast<std::size_t>(cy) * columns_ + cx;
+             for (std::uint32_t i = cellStart_[cell]; i < cellStart_[cell + 1]; ++i) {
+                 const std::array<double, 3>& c = centroids_[cellFaces_[i]];
+                 if (c[0] >= x0 && c[0] <= x1 && c[1] >= y0 && c[1] <= y1) faces.push_back(cellFaces_[i]);
+             }
+         }
+     }
+     std::sort(faces.begin(), faces.end());
+     return faces;
+ }
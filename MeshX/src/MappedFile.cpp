@@ -0,0 +1,73 @@
+/**
+ * @file MappedFile.cpp
+ * @brief Implementation of MappedFile.
+ */
+
+ #include "MappedFile.h"
+ #include <fstream>
+ #include <iterator>
+
+ #ifdef _WIN32
+ #define NOMINMAX
+ #include <windows.h>
+ #else
+ #include <fcntl.h>
+ #include <sys/mman.h>
+ #include <sys/stat.h>
+ #include <unistd.h>
+ #endif
+
+ MappedFile::MappedFile(const std::string& path) {
+ #ifdef _WIN32
+     HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                               OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+     if (file != INVALID_HANDLE_VALUE) {
+         LARGE_INTEGER size;
+         if (GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+             HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+             if (mapping) {
+                 data_ = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+                 if (data_) {
+                     size_ = static_cast<std::size_t>(size.QuadPart);
+                     mapping_ = mapping;
+                     mapped_ = true;
+                 } else {
+                     CloseHandle(mapping);
+                 }
+             }
+         }
+         CloseHandle(file);
+         if (mapped_) { open_ = true; return; }
+     }
+ #else
+     int fd = ::open(path.c_str(), O_RDONLY);
+     if (fd >= 0) {
+         struct stat st;
+         if (fstat(fd, &st) == 0 && st.st_size > 0) {
+             void* p = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+             if (p != MAP_FAILED) {
+                 data_ = static_cast<const char*>(p);
+                 size_ = static_cast<std::size_t>(st.st_size);
+                 mapped_ = true;
+             }
+         }
+         ::close(fd);
+         if (mapped_) { open_ = true; return; }
+     }
+ #endif
+     std::ifstream in(path, std::ios::binary);
+     if (!in.is_open()) return;
+     buffer_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+     data_ = buffer_.empty() ? nullptr : buffer_.data();
+     size_ = buffer_.size();
+     open_ = true;
+ }
+
+ MappedFile::~MappedFile() {
+ #ifdef _WIN32
+     if (mapped_) UnmapViewOfFile(data_);
+     if (mapping_) CloseHandle(static_cast<HANDLE>(mapping_));
+ #else
+     if (mapped_) munmap(const_cast<char*>(data_), size_);
+ #endif
+ }
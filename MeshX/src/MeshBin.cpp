@@ -0,0 +1,226 @@
+/**
+ * @file MeshBin.cpp
+ * @brief Implementation of the MeshBin binary mesh cache.
+ */
+
+ #include "MeshBin.h"
+ #include "MappedFile.h"
+ #include <sys/stat.h>
+ #include <algorithm>
+ #include <cstdio>
+ #include <cstring>
+ #include <filesystem>
+ #include <fstream>
+ #include <limits>
+ #include <sstream>
+ #include <thread>
+ #include <vector>
+
+ static_assert(sizeof(MeshBin::Header) == 136, "MeshBin header layout changed");
+ static_assert(sizeof(Vertex) == 3 * sizeof(double), "Vertex must be three packed doubles");
+ static_assert(sizeof(FaceElement) == 3 * sizeof(std::int32_t), "FaceElement must be three packed ints");
+
+ namespace {
+
+ const char kMagic[8] = {'M', 'E', 'S', 'H', 'B', 'I', 'N', '\0'};
+ const std::size_t kFingerprintBlock = 64 * 1024;
+
+ std::uint64_t fnv1a(const char* data, std::size_t n, std::uint64_t h) {
+     for (std::size_t i = 0; i < n; ++i) {
+         h ^= static_cast<unsigned char>(data[i]);
+         h *= 1099511628211ULL;
+     }
+     return h;
+ }
+
+ std::uint64_t padded(std::uint64_t bytes) {
+     return (bytes + 7) & ~std::uint64_t(7);
+ }
+
+ /**
+  * @brief Byte sizes of the six sections, in file order.
+  */
+ void sectionSizes(const MeshBin::Header& h, std::uint64_t sizes[6]) {
+     bool polygons = (h.flags & MeshBin::HasPolygons) != 0;
+     sizes[0] = h.vertexCount * 3 * ((h.flags & MeshBin::PositionsF64) ? sizeof(double) : sizeof(float));
+     sizes[1] = h.triangleCount * 3 * sizeof(std::int32_t);
+     sizes[2] = polygons ? (h.polygonCount + 1) * sizeof(std::int32_t) : 0;
+     sizes[3] = polygons ? h.polygonElementCount * 3 * sizeof(std::int32_t) : 0;
+     sizes[4] = h.normalCount * 3 * sizeof(double);
+     sizes[5] = h.texCoordCount * 2 * sizeof(double);
+ }
+
+ void writeSection(std::ofstream& out, const void* data, std::uint64_t bytes) {
+     static const char zeros[8] = {0};
+     if (bytes == 0) return;
+     out.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+     out.write(zeros, static_cast<std::streamsize>(padded(bytes) - bytes));
+ }
+
+ } // namespace
+
+ bool MeshBin::stampOf(const std::string& path, SourceStamp& stamp) {
+     struct stat st;
+     if (stat(path.c_str(), &st) != 0) return false;
+     stamp.size = static_cast<std::uint64_t>(st.st_size);
+     stamp.mtime = static_cast<std::int64_t>(st.st_mtime);
+
+     std::ifstream in(path, std::ios::binary);
+     if (!in.is_open()) return false;
+     std::vector<char> block(kFingerprintBlock);
+     std::uint64_t h = fnv1a(reinterpret_cast<const char*>(&stamp.size), sizeof(stamp.size),
+                             14695981039346656037ULL);
+     in.read(block.data(), static_cast<std::streamsize>(block.size()));
+     h = fnv1a(block.data(), static_cast<std::size_t>(in.gcount()), h);
+     if (stamp.size > kFingerprintBlock) {
+         in.clear();
+         std::uint64_t tail = std::max<std::uint64_t>(kFingerprintBlock, stamp.size - kFingerprintBlock);
+         in.seekg(static_cast<std::streamoff>(tail));
+         in.read(block.data(), static_cast<std::streamsize>(block.size()));
+         h = fnv1a(block.data(), static_cast<std::size_t>(in.gcount()), h);
+     }
+     stamp.hash = h;
+     return true;
+ }
+
+ std::string MeshBin::sidecarPath(const std::string& meshPath) {
+     return meshPath + ".meshbin";
+ }
+
+ bool MeshBin::write(const std::string& path, const Mesh& mesh, const SourceStamp& stamp, bool lenient) {
+     // The face elements are written as they are stored; offsets and a fan
+     // triangulation for HeatStack are built here
+     const FaceTable& faces = mesh.faces;
+     const std::vector<FaceElement>& elements = faces.elements();
+     std::vector<std::int32_t> offsets, triangles;
+     offsets.reserve(faces.size() + 1);
+     triangles.reserve(elements.size());
+     for (std::size_t f = 0; f <= faces.size(); ++f) {
+         offsets.push_back(static_cast<std::int32_t>(faces.offset(f)));
+     }
+     for (const auto& face : faces) {
+         for (std::size_t i = 1; i + 1 < face.elements.size(); ++i) {
+             triangles.insert(triangles.end(), { face.elements[0].vertexIndex,
+                                                 face.elements[i].vertexIndex,
+                                                 face.elements[i + 1].vertexIndex });
+         }
+     }
+
+     Header h;
+     std::memset(&h, 0, sizeof(h));
+     std::memcpy(h.magic, kMagic, sizeof(kMagic));
+     h.version = kVersion;
+     h.flags = PositionsF64 | HasPolygons | (lenient ? Lenient : 0u);
+     h.sourceSize = stamp.size;
+     h.sourceMtime = stamp.mtime;
+     h.sourceHash = stamp.hash;
+     h.vertexCount = mesh.vertices.size();
+     h.triangleCount = triangles.size() / 3;
+     h.polygonCount = mesh.faces.size();
+     h.polygonElementCount = elements.size();
+     h.normalCount = mesh.normals.size();
+     h.texCoordCount = mesh.texCoords.size();
+     for (int k = 0; k < 3; ++k) {
+         h.bounds[k] = mesh.vertices.empty() ? 0.0 : std::numeric_limits<double>::max();
+         h.bounds[k + 3] = mesh.vertices.empty() ? 0.0 : std::numeric_limits<double>::lowest();
+     }
+     for (const auto& v : mesh.vertices) {
+         const double p[3] = { v.x, v.y, v.z };
+         for (int k = 0; k < 3; ++k) {
+             h.bounds[k] = std::min(h.bounds[k], p[k]);
+             h.bounds[k + 3] = std::max(h.bounds[k + 3], p[k]);
+         }
+     }
+
+     std::uint64_t sizes[6];
+     sectionSizes(h, sizes);
+     const void* sections[6] = { mesh.vertices.data(), triangles.data(), offsets.data(),
+                                 elements.data(), mesh.normals.data(), mesh.texCoords.data() };
+
+     // Several processes may build the same cache; the rename keeps it whole
+     std::ostringstream tmpName;
+     tmpName << path << "." << std::hash<std::thread::id>()(std::this_thread::get_id()) << ".tmp";
+     std::string tmpPath = tmpName.str();
+     {
+         std::ofstream out(tmpPath, std::ios::binary);
+         if (!out.is_open()) return false;
+         out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+         for (int s = 0; s < 6; ++s) writeSection(out, sections[s], sizes[s]);
+         if (!out) {
+             out.close();
+             std::remove(tmpPath.c_str());
+             return false;
+         }
+     }
+     std::error_code ec;
+     std::filesystem::rename(tmpPath, path, ec);
+     if (ec) {
+         std::filesystem::remove(tmpPath, ec);
+         return false;
+     }
+     return true;
+ }
+
+ bool MeshBin::read(const std::string& path, const SourceStamp& stamp, Mesh& mesh) {
+     return readFile(path, &stamp, mesh);
+ }
+
+ bool MeshBin::read(const std::string& path, Mesh& mesh) {
+     return readFile(path, nullptr, mesh);
+ }
+
+ bool MeshBin::readFile(const std::string& path, const SourceStamp* stamp, Mesh& mesh) {
+     MappedFile file(path);
+     if (!file.data() || file.size() < sizeof(Header)) return false;
+
+     const Header* h = reinterpret_cast<const Header*>(file.data());
+     if (std::memcmp(h->magic, kMagic, sizeof(kMagic)) != 0 || h->version != kVersion) return false;
+     if (stamp && (h->sourceSize != stamp->size || h->sourceMtime != stamp->mtime || h->sourceHash != stamp->hash))
+         return false;
+     if ((h->flags & (PositionsF64 | HasPolygons)) != (PositionsF64 | HasPolygons)) return false;
+
+     // Rule out counts whose byte sizes would overflow
+     const std::uint64_t limit = file.size();
+     if (h->vertexCount > limit || h->triangleCount > limit || h->polygonCount > limit
+         || h->polygonElementCount > limit || h->normalCount > limit || h->texCoordCount > limit)
+         return false;
+
+     std::uint64_t sizes[6];
+     sectionSizes(*h, sizes);
+     std::uint64_t total = sizeof(Header);
+     for (std::uint64_t s : sizes) total += padded(s);
+     if (total != file.size()) return false;
+
+     const char* sections[6];
+     const char* p = file.data() + sizeof(Header);
+     for (int s = 0; s < 6; ++s) {
+         sections[s] = p;
+         p += padded(sizes[s]);
+     }
+     const std::int32_t* offsets = reinterpret_cast<const std::int32_t*>(sections[2]);
+     const std::int32_t* elements = reinterpret_cast<const std::int32_t*>(sections[3]);
+     if (offsets[0] != 0 || offsets[h->polygonCount] != static_cast<std::int32_t>(h->polygonElementCount))
+         return false;
+     for (std::uint64_t f = 0; f < h->polygonCount; ++f) {
+         if (offsets[f + 1] < offsets[f]) return false;
+     }
+
+     Mesh result;
+     result.vertices.resize(h->vertexCount);
+     if (sizes[0]) std::memcpy(result.vertices.data(), sections[0], sizes[0]);
+     result.normals.resize(h->normalCount);
+     if (sizes[4]) std::memcpy(result.normals.data(), sections[4], sizes[4]);
+     result.texCoords.resize(h->texCoordCount);
+     if (sizes[5]) std::memcpy(result.texCoords.data(), sections[5], sizes[5]);
+
+     // Polygon elements are stored as (vertex, texCoord, normal) int32 triples
+     std::vector<FaceElement> faceElements;
+     faceElements.reserve(h->polygonElementCount);
+     for (std::uint64_t e = 0; e < h->polygonElementCount; ++e) {
+         const std::int32_t* triple = elements + 3 * e;
+         faceElements.emplace_back(triple[0], triple[1], triple[2]);
+     }
+     result.faces.assign(std::move(faceElements), std::vector<std::uint32_t>(offsets, offsets + h->polygonCount + 1));
+     mesh = std::move(result);
+     return true;
+ }
@@ -4,6 +4,58 @@
  */
 
 #include "MeshBooleanOperations.h"
+#include "TextFileWriter.h"
+#include <CGAL/Polygon_mesh_processing/bbox.h>
+#include <tbb/parallel_for.h>
+#include <atomic>
+#include <unordered_map>
+
+namespace {
+
+/**
+ * @brief Unions operands[first..] by a balanced pairwise reduction.
+ *
+ * Round k joins operand i with operand i + 2^k (for i - first a multiple of
+ * 2^(k+1)), in place into operand i, so each round halves the operand count and
+ * the pairs of a round are independent; they run on the TBB pool. Operands whose
+ * bounding boxes do not overlap cannot intersect, so they are appended to each
+ * other without corefinement. The union ends up in operands[first]; the other
+ * operands are consumed.
+ *
+ * @param operands The meshes to unite (at least one from first on).
+ * @param first Index of the first operand.
+ * @return True if every corefinement succeeded.
+ */
+bool reduceUnion(std::vector<MeshBooleanOperations::Polyhedron> &operands, std::size_t first) {
+    const std::size_t n = operands.size() - first;
+    std::vector<CGAL::Bbox_3> boxes(n);
+    tbb::parallel_for(std::size_t(0), n, [&](std::size_t i) {
+        boxes[i] = PMP::bbox(operands[first + i]);
+    });
+
+    std::atomic<bool> failed(false);
+    for (std::size_t step = 1; step < n && !failed; step *= 2) {
+        const std::size_t pairs = (n + 2 * step - 1) / (2 * step);
+        tbb::parallel_for(std::size_t(0), pairs, [&](std::size_t pair) {
+            const std::size_t i = pair * 2 * step;
+            const std::size_t j = i + step;
+            if (j >= n || failed) return;
+            auto &a = operands[first + i];
+            auto &b = operands[first + j];
+            if (!CGAL::do_overlap(boxes[i], boxes[j])) {
+                CGAL::copy_face_graph(b, a);
+            } else if (!PMP::corefine_and_compute_union(a, b, a)) {
+                failed = true;
+                return;
+            }
+            boxes[i] = boxes[i] + boxes[j];
+            b.clear(); // Free the consumed operand early
+        });
+    }
+    return !failed;
+}
+
+} // namespace
 
 /**
  * @brief Reads a mesh from an OFF file.
@@ -29,123 +81,166 @@ bool MeshBooleanOperations::readOFF(const std::string &filename, Polyhedron &pol
  * @return True if the file is successfully written, false otherwise.
  */
 bool MeshBooleanOperations::writeOFF(const std::string &filename, const Polyhedron &poly) {
-    std::ofstream out(filename);
-    if (!out) {
+    TextFileWriter out(filename);
+    if (!out.isOpen()) {
+        std::cerr << "Error: Cannot write OFF file: " << filename << std::endl;
+        return false;
+    }
+
+    // Index the vertices and facets so chunks can be formatted independently
+    std::vector<Polyhedron::Vertex_const_handle> vertices;
+    vertices.reserve(poly.size_of_vertices());
+    std::unordered_map<const void*, int> index; // Vertex address -> position
+    index.reserve(poly.size_of_vertices());
+    for (auto v = poly.vertices_begin(); v != poly.vertices_end(); ++v) {
+        index.emplace(&*v, static_cast<int>(vertices.size()));
+        vertices.push_back(v);
+    }
+    std::vector<Polyhedron::Facet_const_handle> facets;
+    facets.reserve(poly.size_of_facets());
+    for (auto f = poly.facets_begin(); f != poly.facets_end(); ++f) facets.push_back(f);
+
+    std::string header = "OFF\n";
+    TextFileWriter::appendNumber(header, static_cast<long long>(vertices.size()));
+    header += ' ';
+    TextFileWriter::appendNumber(header, static_cast<long long>(facets.size()));
+    header += " 0\n";
+    out.write(header);
+
+    // Coordinates are written exactly: the file is the input of volume meshing
+    out.writeRecords(vertices.size(), [&](std::string &text, std::size_t i) {
+        const auto &p = vertices[i]->point();
+        TextFileWriter::appendExact(text, CGAL::to_double(p.x()));
+        text += ' ';
+        TextFileWriter::appendExact(text, CGAL::to_double(p.y()));
+        text += ' ';
+        TextFileWriter::appendExact(text, CGAL::to_double(p.z()));
+        text += '\n';
+    });
+    out.writeRecords(facets.size(), [&](std::string &text, std::size_t i) {
+        Polyhedron::Halfedge_around_facet_const_circulator h = facets[i]->facet_begin(), start = h;
+        TextFileWriter::appendNumber(text, static_cast<long long>(CGAL::circulator_size(h)));
+        do {
+            text += ' ';
+            TextFileWriter::appendNumber(text, index.find(&*h->vertex())->second);
+        } while (++h != start);
+        text += '\n';
+    });
+
+    if (!out.close()) {
         std::cerr << "Error: Cannot write OFF file: " << filename << std::endl;
         return false;
     }
-    out << poly;
     return true;
 }
 
 /**
- * @brief Computes the union of multiple meshes.
- * @param meshes Vector of Polyhedron objects representing input meshes.
- * @param result Reference to store the resulting unioned mesh.
+ * @brief Computes the union of multiple meshes in place.
+ * @param meshes Input meshes; the union is left in meshes[0], the others are consumed.
  * @return True if the operation is successful, false otherwise.
  */
-bool MeshBooleanOperations::computeUnion(const std::vector<Polyhedron> &meshes, Polyhedron &result) {
+bool MeshBooleanOperations::computeUnionInPlace(std::vector<Polyhedron> &meshes) {
     if (meshes.empty()) {
         std::cerr << "Error: No meshes provided for union operation." << std::endl;
         return false;
     }
-    result = meshes[0];
-    for (size_t i = 1; i < meshes.size(); ++i) {
-        Polyhedron temp;
-        bool success = PMP::corefine_and_compute_union(
-            result, 
-            const_cast<Polyhedron&>(meshes[i]), 
-            temp, 
-            PMP::parameters::all_default(), 
-            PMP::parameters::all_default(), 
-            PMP::parameters::all_default()
-        );
-        if (!success) {
-            std::cerr << "Error: Union operation failed between meshes." << std::endl;
-            return false;
-        }
-        result = temp;
+    if (!reduceUnion(meshes, 0)) {
+        std::cerr << "Error: Union operation failed between meshes." << std::endl;
+        return false;
     }
     return true;
 }
 
 /**
- * @brief Computes the intersection of multiple meshes.
- * @param meshes Vector of Polyhedron objects representing input meshes.
- * @param result Reference to store the resulting intersected mesh.
+ * @brief Computes the intersection of multiple meshes in place.
+ * @param meshes Input meshes; the intersection is left in meshes[0], the others are consumed.
  * @return True if the operation is successful, false otherwise.
  */
-bool MeshBooleanOperations::computeIntersection(const std::vector<Polyhedron> &meshes, Polyhedron &result) {
+bool MeshBooleanOperations::computeIntersectionInPlace(std::vector<Polyhedron> &meshes) {
     if (meshes.empty()) {
         std::cerr << "Error: No meshes provided for intersection operation." << std::endl;
         return false;
     }
-    result = meshes[0];
     for (size_t i = 1; i < meshes.size(); ++i) {
-        Polyhedron temp;
-        bool success = PMP::corefine_and_compute_intersection(
-            result, 
-            const_cast<Polyhedron&>(meshes[i]), 
-            temp
-        );
-        if (!success) {
+        // Disjoint bounding boxes: nothing is left
+        if (!CGAL::do_overlap(PMP::bbox(meshes[0]), PMP::bbox(meshes[i]))) {
+            for (auto &mesh : meshes) mesh.clear();
+            return true;
+        }
+        if (!PMP::corefine_and_compute_intersection(meshes[0], meshes[i], meshes[0])) {
             std::cerr << "Error: Intersection operation failed between meshes." << std::endl;
             return false;
         }
-        result = temp;
+        meshes[i].clear();
     }
     return true;
 }
 
 /**
- * @brief Computes the difference of multiple meshes.
- * @param meshes Vector of Polyhedron objects representing input meshes.
- * @param result Reference to store the resulting difference mesh.
+ * @brief Computes the difference of multiple meshes in place.
+ * @param meshes Input meshes; meshes[0] \ (meshes[1] ∪ ...) is left in meshes[0], the others are consumed.
  * @return True if the operation is successful, false otherwise.
  */
-bool MeshBooleanOperations::computeDifference(const std::vector<Polyhedron> &meshes, Polyhedron &result) {
+bool MeshBooleanOperations::computeDifferenceInPlace(std::vector<Polyhedron> &meshes) {
     if (meshes.empty()) {
         std::cerr << "Error: No meshes provided for difference operation." << std::endl;
         return false;
     }
     if (meshes.size() == 1) {
-        result = meshes[0];
         return true;
     }
-    
-    // First, compute the union of all meshes except the first.
-    Polyhedron unionOther = meshes[1];
-    for (size_t i = 2; i < meshes.size(); ++i) {
-        Polyhedron temp;
-        bool success = PMP::corefine_and_compute_union(
-            unionOther, 
-            const_cast<Polyhedron&>(meshes[i]), 
-            temp,
-            PMP::parameters::all_default(), 
-            PMP::parameters::all_default(), 
-            PMP::parameters::all_default()
-        );
-        if (!success) {
-            std::cerr << "Error: Union operation failed during difference computation." << std::endl;
-            return false;
-        }
-        unionOther = temp;
+
+    // First, compute the union of all meshes except the first (into meshes[1]).
+    if (!reduceUnion(meshes, 1)) {
+        std::cerr << "Error: Union operation failed during difference computation." << std::endl;
+        return false;
     }
-    
-    // Create a non-const copy of the first mesh
-    Polyhedron mesh0 = meshes[0];
-    
+
     // Compute the difference: mesh0 minus the union of the others.
-    bool diffSuccess = PMP::corefine_and_compute_difference(
-        mesh0, 
-        unionOther, 
-        result,
-        PMP::parameters::all_default(), 
-        PMP::parameters::all_default(), 
-        PMP::parameters::all_default()
-    );
+    bool diffSuccess = PMP::corefine_and_compute_difference(meshes[0], meshes[1], meshes[0]);
     if (!diffSuccess) {
         std::cerr << "Error: Difference operation failed." << std::endl;
+        return false;
     }
-    return diffSuccess;
-}
\ No newline at end of file
+    meshes[1].clear();
+    return true;
+}
+
+/**
+ * @brief Computes the union of multiple meshes.
+ * @param meshes Vector of Polyhedron objects representing input meshes.
+ * @param result Reference to store the resulting unioned mesh.
+ * @return True if the operation is successful, false otherwise.
+ */
+bool MeshBooleanOperations::computeUnion(const std::vector<Polyhedron> &meshes, Polyhedron &result) {
+    std::vector<Polyhedron> operands(meshes); // Corefinement modifies its operands
+    if (!computeUnionInPlace(operands)) return false;
+    result = std::move(operands[0]);
+    return true;
+}
+
+/**
+ * @brief Computes the intersection of multiple meshes.
+ * @param meshes Vector of Polyhedron objects representing input meshes.
+ * @param result Reference to store the resulting intersected mesh.
+ * @return True if the operation is successful, false otherwise.
+ */
+bool MeshBooleanOperations::computeIntersection(const std::vector<Polyhedron> &meshes, Polyhedron &result) {
+    std::vector<Polyhedron> operands(meshes);
+    if (!computeIntersectionInPlace(operands)) return false;
+    result = std::move(operands[0]);
+    return true;
+}
+
+/**
+ * @brief Computes the difference of multiple meshes.
+ * @param meshes Vector of Polyhedron objects representing input meshes.
+ * @param result Reference to store the resulting difference mesh.
+ * @return True if the operation is successful, false otherwise.
+ */
+bool MeshBooleanOperations::computeDifference(const std::vector<Polyhedron> &meshes, Polyhedron &result) {
+    std::vector<Polyhedron> operands(meshes);
+    if (!computeDifferenceInPlace(operands)) return false;
+    result = std::move(operands[0]);
+    return true;
+}
@@ -4,11 +4,19 @@
  */
 
  #include "MeshConverter.h"
- #include <CGAL/IO/OBJ.h>   // For reading OBJ files.
- #include <CGAL/IO/OFF.h>   // For writing OFF files.
- #include <fstream>
+ #include "TextFileWriter.h"
+ #include <CGAL/Polyhedron_incremental_builder_3.h>
+ #include <algorithm>
+ #include <charconv>
+ #include <condition_variable>
+ #include <cstdio>
+ #include <cstring>
+ #include <deque>
  #include <iostream>
- #include <sstream>
+ #include <mutex>
+ #include <thread>
+ #include <unordered_map>
+ #include <vector>
  
  /**
   * @brief Default constructor for the MeshConverter class.
@@ -17,117 +25,529 @@
      // Constructor can initialize members if needed.
  }
  
+ namespace {
+
+ const std::size_t kStreamChunkBytes = std::size_t(4) << 20; ///< Input read per chunk
+ const std::size_t kStreamQueueDepth = 4;                     ///< Chunks waiting per queue
+
+ /**
+  * @brief Bounded queue handing chunks from one thread to another.
+  *
+  * push() blocks while the queue is full, so a fast producer cannot run
+  * ahead of the consumer by more than kStreamQueueDepth chunks.
+  */
+ template <class T>
+ class ChunkQueue {
+ public:
+     /** @brief Adds a chunk; false if the queue was closed (the consumer gave up). */
+     bool push(T&& chunk) {
+         std::unique_lock<std::mutex> lock(mutex_);
+         notFull_.wait(lock, [this] { return closed_ || chunks_.size() < kStreamQueueDepth; });
+         if (closed_)
+             return false;
+         chunks_.push_back(std::move(chunk));
+         notEmpty_.notify_one();
+         return true;
+     }
+
+     /** @brief Takes the next chunk; false once the queue is closed and empty. */
+     bool pop(T& chunk) {
+         std::unique_lock<std::mutex> lock(mutex_);
+         notEmpty_.wait(lock, [this] { return closed_ || !chunks_.empty(); });
+         if (chunks_.empty())
+             return false;
+         chunk = std::move(chunks_.front());
+         chunks_.pop_front();
+         notFull_.notify_one();
+         return true;
+     }
+
+     /** @brief No more chunks: wakes both sides. Chunks already queued can still be popped. */
+     void close() {
+         std::lock_guard<std::mutex> lock(mutex_);
+         closed_ = true;
+         notFull_.notify_all();
+         notEmpty_.notify_all();
+     }
+
+ private:
+     std::mutex mutex_;
+     std::condition_variable notFull_, notEmpty_;
+     std::deque<T> chunks_;
+     bool closed_ = false;
+ };
+
+ /**
+  * @brief Reads a file on a thread of its own as chunks of whole lines.
+  *
+  * Each chunk ends at a line break (a line longer than a chunk makes its
+  * chunk longer); only the last one may lack it.
+  */
+ class LineChunkReader {
+ public:
+     explicit LineChunkReader(const std::string& path) : file_(std::fopen(path.c_str(), "rb")) {
+         if (file_)
+             thread_ = std::thread([this] { run(); });
+     }
+
+     ~LineChunkReader() {
+         queue_.close(); // Stops a reader still blocked on a full queue
+         if (thread_.joinable())
+             thread_.join();
+         if (file_)
+             std::fclose(file_);
+     }
+
+     bool isOpen() const { return file_ != nullptr; }
+
+     /** @brief The next chunk; false at the end of the file. */
+     bool next(std::string& chunk) { return queue_.pop(chunk); }
+
+     /** @brief True if reading failed (valid after next() returned false). */
+     bool failed() const { return failed_; }
+
+ private:
+     void run() {
+         std::string carry; // Start of a line continued in the next block
+         std::vector<char> block(kStreamChunkBytes);
+         for (;;) {
+             const std::size_t n = std::fread(block.data(), 1, block.size(), file_);
+             if (n == 0)
+                 break;
+             std::size_t lineEnd = n;
+             while (lineEnd > 0 && block[lineEnd - 1] != '\n')
+                 --lineEnd;
+             if (lineEnd == 0) {
+                 carry.append(block.data(), n); // No line ends in this block
+                 continue;
+             }
+             std::string chunk;
+             chunk.reserve(carry.size() + lineEnd);
+             chunk.append(carry).append(block.data(), lineEnd);
+             carry.assign(block.data() + lineEnd, n - lineEnd);
+             if (!queue_.push(std::move(chunk)))
+                 return;
+         }
+         failed_ = std::ferror(file_) != 0;
+         if (!carry.empty())
+             queue_.push(std::move(carry));
+         queue_.close();
+     }
+
+     std::FILE* file_;
+     ChunkQueue<std::string> queue_;
+     std::thread thread_;
+     bool failed_ = false;
+ };
+
+ /**
+  * @brief Writes text chunks on a thread of its own, to the output file or a spool file.
+  */
+ class ChunkWriter {
+ public:
+     ChunkWriter(std::FILE* out, std::FILE* spool) : out_(out), spool_(spool) {
+         thread_ = std::thread([this] { run(); });
+     }
+
+     ~ChunkWriter() { finish(); }
+
+     /** @brief Queues text for the output (spool = false) or the spool file. */
+     void write(std::string&& text, bool spool = false) {
+         if (!text.empty())
+             queue_.push(Chunk{ std::move(text), spool });
+     }
+
+     /** @brief Waits until everything queued is written; false if a write failed. */
+     bool finish() {
+         queue_.close();
+         if (thread_.joinable())
+             thread_.join();
+         return !failed_;
+     }
+
+ private:
+     struct Chunk {
+         std::string text;
+         bool spool = false;
+     };
+
+     void run() {
+         Chunk chunk;
+         while (queue_.pop(chunk)) {
+             std::FILE* file = chunk.spool ? spool_ : out_;
+             if (!failed_ && std::fwrite(chunk.text.data(), 1, chunk.text.size(), file) != chunk.text.size())
+                 failed_ = true; // Keep draining so write() never blocks
+         }
+     }
+
+     std::FILE* out_;
+     std::FILE* spool_;
+     ChunkQueue<Chunk> queue_;
+     std::thread thread_;
+     bool failed_ = false;
+ };
+
+ /**
+  * @brief Cursor over the whitespace-separated tokens of one line.
+  */
+ struct LineTokens {
+     const char* p;
+     const char* end;
+
+     bool next(const char*& begin, const char*& tokenEnd) {
+         while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\v' || *p == '\f'))
+             ++p;
+         if (p == end)
+             return false;
+         begin = p;
+         while (p < end && !(*p == ' ' || *p == '\t' || *p == '\r' || *p == '\v' || *p == '\f'))
+             ++p;
+         tokenEnd = p;
+         return true;
+     }
+ };
+
+ /**
+  * @brief Calls onLine(begin, end) for every line of a chunk (without the line break).
+  * @return False as soon as onLine does.
+  */
+ template <class OnLine>
+ bool forEachLine(const std::string& chunk, OnLine onLine) {
+     const char* p = chunk.data();
+     const char* end = p + chunk.size();
+     while (p < end) {
+         const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', static_cast<std::size_t>(end - p)));
+         if (!lineEnd)
+             lineEnd = end;
+         if (!onLine(p, lineEnd))
+             return false;
+         p = lineEnd + 1;
+     }
+     return true;
+ }
+
+ /** @brief True if [begin, end) is a whole number as from_chars reads it (a leading '+' allowed). */
+ bool isNumber(const char* begin, const char* end) {
+     if (begin < end && *begin == '+')
+         ++begin;
+     double value;
+     auto result = std::from_chars(begin, end, value);
+     return result.ec == std::errc() && result.ptr == end;
+ }
+
+ /** @brief Parses an integer that fills [begin, end). */
+ bool parseIndex(const char* begin, const char* end, long long& value) {
+     if (begin < end && *begin == '+')
+         ++begin;
+     auto result = std::from_chars(begin, end, value);
+     return result.ec == std::errc() && result.ptr == end;
+ }
+
+ /** @brief Opens a file for binary writing (and reading back, with readBack), or null. */
+ std::FILE* openForWriting(const std::string& path, bool readBack = false) {
+     return std::fopen(path.c_str(), readBack ? "w+b" : "wb");
+ }
+
+ } // namespace
+
  /**
   * @brief Converts an OBJ file to an OFF file.
   *
-  * This function reads a mesh from an OBJ file and writes it to an OFF file.
+  * Streams the file in one pass: vertices go straight to the output, face
+  * lines to a spool file appended after them, and the counts are written
+  * into a header reserved at the start.
   *
   * @param input_filename Path to the input OBJ file.
   * @param output_filename Path to the output OFF file.
   * @return True if conversion is successful, false otherwise.
   */
  bool MeshConverter::convertObjToOff(const std::string& input_filename, const std::string& output_filename) {
-     // Open the input OBJ file.
-     std::ifstream input(input_filename);
-     if (!input) {
+     LineChunkReader reader(input_filename);
+     if (!reader.isOpen()) {
          std::cerr << "Error: Cannot open input file " << input_filename << std::endl;
          return false;
      }
- 
-     CGALMesh mesh;
-     // Read the OBJ file into the mesh.
-     if (!CGAL::IO::read_OBJ(input, mesh)) {
-         std::cerr << "Error: Failed to read OBJ file " << input_filename << std::endl;
+     const std::string spoolPath = output_filename + ".faces.tmp";
+     std::FILE* out = openForWriting(output_filename);
+     std::FILE* spool = out ? openForWriting(spoolPath, true) : nullptr;
+     if (!out || !spool) {
+         if (out)
+             std::fclose(out);
+         std::cerr << "Error: Cannot open output file " << output_filename << std::endl;
          return false;
      }
-     input.close();
- 
-     // Open the output OFF file.
-     std::ofstream output(output_filename);
-     if (!output) {
-         std::cerr << "Error: Cannot open output file " << output_filename << std::endl;
+
+     // Room for the counts, filled in at the end; OFF readers skip the padding
+     const std::size_t headerWidth = 64;
+     std::string header = "OFF\n" + std::string(headerWidth - 1, ' ') + "\n";
+
+     long long vertexCount = 0, faceCount = 0, maxIndex = -1;
+     std::string error;
+     bool writesOk;
+     {
+         ChunkWriter writer(out, spool);
+         writer.write(std::move(header));
+         std::string chunk;
+         std::vector<long long> corners;
+         while (error.empty() && reader.next(chunk)) {
+             std::string vertices, faces;
+             vertices.reserve(chunk.size());
+             forEachLine(chunk, [&](const char* p, const char* end) {
+                 LineTokens tokens{ p, end };
+                 const char *b, *e;
+                 if (!tokens.next(b, e))
+                     return true;
+                 if (e - b == 1 && *b == 'v') {
+                     const char *x[3], *xe[3];
+                     for (int k = 0; k < 3; ++k) {
+                         if (!tokens.next(x[k], xe[k]) || !isNumber(x[k], xe[k])) {
+                             error = "invalid vertex " + std::to_string(vertexCount + 1);
+                             return false;
+                         }
+                     }
+                     // Coordinates are copied as written, so no precision is lost
+                     for (int k = 0; k < 3; ++k) {
+                         vertices.append(x[k], xe[k]);
+                         vertices += k < 2 ? ' ' : '\n';
+                     }
+                     ++vertexCount;
+                 } else if (e - b == 1 && *b == 'f') {
+                     corners.clear();
+                     while (tokens.next(b, e)) {
+                         const char* slash = static_cast<const char*>(std::memchr(b, '/', static_cast<std::size_t>(e - b)));
+                         long long index;
+                         if (!parseIndex(b, slash ? slash : e, index) || index == 0) {
+                             error = "invalid face " + std::to_string(faceCount + 1);
+                             return false;
+                         }
+                         // Negative indices count back from the last vertex read
+                         index = index < 0 ? vertexCount + index : index - 1;
+                         if (index < 0) {
+                             error = "invalid face " + std::to_string(faceCount + 1);
+                             return false;
+                         }
+                         maxIndex = std::max(maxIndex, index);
+                         corners.push_back(index);
+                     }
+                     if (corners.empty())
+                         return true;
+                     TextFileWriter::appendNumber(faces, static_cast<long long>(corners.size()));
+                     for (long long index : corners) {
+                         faces += ' ';
+                         TextFileWriter::appendNumber(faces, index);
+                     }
+                     faces += '\n';
+                     ++faceCount;
+                 }
+                 return true; // vt, vn, groups, materials, ... have no OFF counterpart
+             });
+             writer.write(std::move(vertices));
+             writer.write(std::move(faces), true);
+         }
+         writesOk = writer.finish();
+     }
+     if (error.empty() && reader.failed())
+         error = "read error";
+     if (error.empty() && maxIndex >= vertexCount)
+         error = "face refers to vertex " + std::to_string(maxIndex + 1) + " of " + std::to_string(vertexCount);
+
+     // Faces after the vertices, then the counts into the header
+     if (error.empty() && writesOk) {
+         writesOk = std::fflush(spool) == 0 && std::fseek(spool, 0, SEEK_SET) == 0;
+         std::vector<char> buffer(kStreamChunkBytes);
+         std::size_t n;
+         while (writesOk && (n = std::fread(buffer.data(), 1, buffer.size(), spool)) > 0)
+             writesOk = std::fwrite(buffer.data(), 1, n, out) == n;
+         writesOk = writesOk && !std::ferror(spool);
+         const std::string counts = std::to_string(vertexCount) + " " + std::to_string(faceCount) + " 0";
+         writesOk = writesOk && std::fseek(out, 4, SEEK_SET) == 0
+             && std::fwrite(counts.data(), 1, counts.size(), out) == counts.size();
+     }
+     std::fclose(spool);
+     std::remove(spoolPath.c_str());
+     writesOk = std::fclose(out) == 0 && writesOk;
+
+     if (!error.empty()) {
+         std::remove(output_filename.c_str());
+         std::cerr << "Error: Failed to read OBJ file " << input_filename << ": " << error << std::endl;
          return false;
      }
- 
-     // Write the mesh to the OFF file.
-     if (!CGAL::IO::write_OFF(output, mesh)) {
+     if (!writesOk) {
+         std::remove(output_filename.c_str());
          std::cerr << "Error: Failed to write OFF file " << output_filename << std::endl;
          return false;
      }
-     output.close();
- 
      return true;
  }
- 
+
  /**
   * @brief Converts an OFF file to an OBJ file.
   *
-  * This function reads a mesh from an OFF file and writes it to an OBJ file.
+  * Streams the file in one pass, converting each chunk of lines as it
+  * arrives while the previous one is written.
   *
   * @param offFile Path to the input OFF file.
   * @param objFile Path to the output OBJ file.
   * @return True if conversion is successful, false otherwise.
   */
  bool MeshConverter::convertOffToObj(const std::string& offFile, const std::string& objFile) {
-     // Open the OFF file for reading
-     std::ifstream in(offFile);
-     if (!in) {
+     LineChunkReader reader(offFile);
+     if (!reader.isOpen()) {
          std::cerr << "Failed to open OFF file: " << offFile << std::endl;
          return false;
      }
- 
-     // Read the header and check if it's a valid OFF file
-     std::string header;
-     in >> header;
-     if (header != "OFF") {
-         std::cerr << "File " << offFile << " is not a valid OFF file." << std::endl;
+     std::FILE* out = openForWriting(objFile);
+     if (!out) {
+         std::cerr << "Failed to open OBJ file for writing: " << objFile << std::endl;
          return false;
      }
- 
-     // Read the number of vertices, faces, and edges
-     int nVertices, nFaces, nEdges;
-     in >> nVertices >> nFaces >> nEdges;
- 
-     // Read the vertices
-     std::vector<std::array<double, 3>> vertices(nVertices);
-     for (int i = 0; i < nVertices; i++) {
-         in >> vertices[i][0] >> vertices[i][1] >> vertices[i][2];
-     }
- 
-     // Read the faces
-     std::vector<std::vector<int>> faces(nFaces);
-     for (int i = 0; i < nFaces; i++) {
-         int count;
-         in >> count;
-         faces[i].resize(count);
-         for (int j = 0; j < count; j++) {
-             in >> faces[i][j];
+
+     enum class Section { Keyword, Counts, Vertices, Faces, Done };
+     Section section = Section::Keyword;
+     long long nVertices = 0, nFaces = 0, vertex = 0, face = 0;
+     std::string error;
+     bool writesOk;
+     {
+         ChunkWriter writer(out, nullptr);
+         std::string chunk;
+         while (error.empty() && section != Section::Done && reader.next(chunk)) {
+             std::string text;
+             text.reserve(chunk.size() + chunk.size() / 4);
+             forEachLine(chunk, [&](const char* p, const char* end) {
+                 const char* hash = static_cast<const char*>(std::memchr(p, '#', static_cast<std::size_t>(end - p)));
+                 LineTokens tokens{ p, hash ? hash : end };
+                 const char *b, *e;
+                 if (!tokens.next(b, e))
+                     return true; // Blank or comment
+                 if (section == Section::Keyword) {
+                     if (std::string(b, e) != "OFF") {
+                         error = "missing OFF keyword";
+                         return false;
+                     }
+                     section = Section::Counts;
+                     if (!tokens.next(b, e))
+                         return true; // Counts on the next line
+                 }
+                 if (section == Section::Counts) {
+                     const char *fb, *fe;
+                     if (!parseIndex(b, e, nVertices) || !tokens.next(fb, fe) || !parseIndex(fb, fe, nFaces)
+                         || nVertices < 0 || nFaces < 0) {
+                         error = "invalid counts";
+                         return false;
+                     }
+                     section = nVertices > 0 ? Section::Vertices : nFaces > 0 ? Section::Faces : Section::Done;
+                     return true;
+                 }
+                 if (section == Section::Vertices) {
+                     // Extra columns (colours, normals of COFF-style lines) are ignored
+                     text += "v";
+                     for (int k = 0; k < 3; ++k) {
+                         if (k > 0 && !tokens.next(b, e)) {
+                             error = "invalid vertex " + std::to_string(vertex);
+                             return false;
+                         }
+                         if (!isNumber(b, e)) {
+                             error = "invalid vertex " + std::to_string(vertex);
+                             return false;
+                         }
+                         text += ' ';
+                         text.append(b, e);
+                     }
+                     text += '\n';
+                     if (++vertex == nVertices)
+                         section = nFaces > 0 ? Section::Faces : Section::Done;
+                     return true;
+                 }
+                 if (section == Section::Faces) {
+                     long long count, index;
+                     if (!parseIndex(b, e, count) || count < 0) {
+                         error = "invalid face " + std::to_string(face);
+                         return false;
+                     }
+                     text += 'f';
+                     for (long long i = 0; i < count; ++i) {
+                         if (!tokens.next(b, e) || !parseIndex(b, e, index) || index < 0 || index >= nVertices) {
+                             error = "invalid face " + std::to_string(face);
+                             return false;
+                         }
+                         text += ' ';
+                         TextFileWriter::appendNumber(text, index + 1); // OBJ indices are 1-based
+                     }
+                     text += '\n';
+                     if (++face == nFaces)
+                         section = Section::Done;
+                     return true;
+                 }
+                 return false; // Done: the rest of the file is not read
+             });
+             writer.write(std::move(text));
          }
+         writesOk = writer.finish();
      }
-     in.close();
- 
-     // Open the OBJ file for writing
-     std::ofstream out(objFile);
-     if (!out) {
-         std::cerr << "Failed to open OBJ file for writing: " << objFile << std::endl;
+     if (error.empty() && section != Section::Done)
+         error = reader.failed() ? "read error" : "file ends after " + std::to_string(vertex) + " vertices and "
+                                                       + std::to_string(face) + " faces";
+     writesOk = std::fclose(out) == 0 && writesOk;
+
+     if (!error.empty()) {
+         std::remove(objFile.c_str());
+         std::cerr << "File " << offFile << " is not a valid OFF file: " << error << std::endl;
+         return false;
+     }
+     if (!writesOk) {
+         std::remove(objFile.c_str());
+         std::cerr << "Failed to write OBJ file: " << objFile << std::endl;
          return false;
      }
- 
-     // Write the vertices to the OBJ file
-     for (int i = 0; i < nVertices; i++)
-         out << "v " << vertices[i][0] << " " << vertices[i][1] << " " << vertices[i][2] << "\n";
- 
-     // Write the faces to the OBJ file
-     for (int i = 0; i < nFaces; i++) {
-         out << "f";
-         for (int idx : faces[i])
-             out << " " << (idx + 1); // OBJ indices are 1-based
-         out << "\n";
-     }
-     out.close();
      return true;
  }
- 
+
+ namespace {
+
+ /**
+  * @brief Builds a Polyhedron from a Mesh's index arrays with CGAL's incremental builder.
+  */
+ template <class HDS>
+ class MeshPolyhedronBuilder : public CGAL::Modifier_base<HDS> {
+ public:
+     explicit MeshPolyhedronBuilder(const Mesh &mesh) : mesh_(mesh) {}
+
+     void operator()(HDS &hds) override {
+         typedef CGAL::Polyhedron_incremental_builder_3<HDS> Builder;
+         typedef typename HDS::Vertex::Point HdsPoint;
+         Builder builder(hds);
+         builder.begin_surface(mesh_.vertices.size(), mesh_.faces.size(), mesh_.faces.elements().size());
+         for (const auto &v : mesh_.vertices)
+             builder.add_vertex(HdsPoint(v.x, v.y, v.z));
+         for (const auto &face : mesh_.faces) {
+             builder.begin_facet();
+             for (const auto &elem : face.elements)
+                 builder.add_vertex_to_facet(static_cast<std::size_t>(elem.vertexIndex));
+             builder.end_facet();
+             if (builder.error()) break;
+         }
+         if (builder.error()) {
+             builder.rollback();
+             return;
+         }
+         builder.end_surface();
+         // As the OFF reader does: vertices used by no face are dropped
+         if (builder.check_unconnected_vertices() && !builder.remove_unconnected_vertices()) {
+             builder.rollback();
+             return;
+         }
+         built_ = true;
+     }
+
+     bool built() const { return built_; }
+
+ private:
+     const Mesh &mesh_;
+     bool built_ = false;
+ };
+
+ } // namespace
+
  /**
   * @brief Converts a mesh to a Polyhedron.
   *
@@ -138,32 +558,70 @@
   * @return True if conversion is successful, false otherwise.
   */
  bool MeshConverter::convertMeshToPolyhedron(const Mesh &mesh, MeshBooleanOperations::Polyhedron &poly) {
-     // Create a stringstream to hold the OFF format data
-     std::stringstream ss;
-     ss << "OFF\n";
-     ss << mesh.vertices.size() << " " << mesh.faces.size() << " 0\n";
-     
-     // Write vertices to the stringstream
-     for (const auto &v : mesh.vertices)
-         ss << v.x << " " << v.y << " " << v.z << "\n";
-     
-     // Write faces to the stringstream
+     poly.clear();
+
+     // The builder asserts on indices it does not know; reject them here
+     const int nVertices = static_cast<int>(mesh.vertices.size());
      for (const auto &face : mesh.faces) {
-         ss << face.elements.size();
+         bool valid = face.elements.size() >= 3;
          for (const auto &elem : face.elements)
-             ss << " " << elem.vertexIndex;
-         ss << "\n";
+             valid = valid && elem.vertexIndex >= 0 && elem.vertexIndex < nVertices;
+         if (!valid) {
+             std::cerr << "Error converting mesh to Polyhedron" << std::endl;
+             return false;
+         }
      }
-     
-     // Clear the polyhedron and read from the stringstream
-     poly.clear();
-     if (!(ss >> poly)) {
+
+     MeshPolyhedronBuilder<MeshBooleanOperations::Polyhedron::HalfedgeDS> builder(mesh);
+     poly.delegate(builder);
+     if (!builder.built() || !poly.is_valid()) {
+         poly.clear();
          std::cerr << "Error converting mesh to Polyhedron" << std::endl;
          return false;
      }
-     
+
      // Triangulate faces of the polyhedron
      CGAL::Polygon_mesh_processing::triangulate_faces(poly);
      return true;
  }
- 
\ No newline at end of file
+
+ /**
+  * @brief Converts a Polyhedron to a mesh.
+  *
+  * This function copies the vertices and facets of a CGAL Polyhedron into a mesh,
+  * e.g. to bring a Boolean operation result back without writing a file.
+  *
+  * @param poly The input CGAL Polyhedron.
+  * @param mesh The output mesh structure.
+  * @return True if conversion is successful, false otherwise.
+  */
+ bool MeshConverter::convertPolyhedronToMesh(const MeshBooleanOperations::Polyhedron &poly, Mesh &mesh) {
+     typedef MeshBooleanOperations::Polyhedron Polyhedron;
+     Mesh result;
+     result.vertices.reserve(poly.size_of_vertices());
+     std::unordered_map<const void*, int> index; // Vertex address -> position
+     index.reserve(poly.size_of_vertices());
+     for (auto v = poly.vertices_begin(); v != poly.vertices_end(); ++v) {
+         index.emplace(&*v, static_cast<int>(result.vertices.size()));
+         const auto &p = v->point();
+         result.vertices.push_back({ CGAL::to_double(p.x()), CGAL::to_double(p.y()), CGAL::to_double(p.z()) });
+     }
+
+     result.faces.reserve(poly.size_of_facets(), poly.size_of_halfedges());
+     std::vector<FaceElement> corners;
+     for (auto f = poly.facets_begin(); f != poly.facets_end(); ++f) {
+         corners.clear();
+         Polyhedron::Halfedge_around_facet_const_circulator h = f->facet_begin(), start = h;
+         do {
+             auto it = index.find(&*h->vertex());
+             if (it == index.end()) {
+                 std::cerr << "Error converting Polyhedron to mesh" << std::endl;
+                 return false;
+             }
+             corners.emplace_back(it->second);
+         } while (++h != start);
+         result.faces.addFace(corners.data(), corners.size());
+     }
+     mesh = std::move(result);
+     return true;
+ }
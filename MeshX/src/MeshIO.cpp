@@ -0,0 +1,516 @@
+/**
+ * @file MeshIO.cpp
+ * @brief Implementation of MeshIO.
+ */
+
+ #include "MeshIO.h"
+ #include "MappedFile.h"
+ #include "MeshBin.h"
+ #include "ObjExporter.h"
+ #include "ObjParser.h"
+ #include "TextFileWriter.h"
+ #include <algorithm>
+ #include <cctype>
+ #include <charconv>
+ #include <cstdint>
+ #include <cstring>
+ #include <fstream>
+ #include <iostream>
+ #include <sstream>
+ #include <stdexcept>
+ #include <type_traits>
+ #include <vector>
+
+ namespace {
+
+ bool hostLittleEndian() {
+     const std::uint16_t probe = 1;
+     unsigned char first;
+     std::memcpy(&first, &probe, 1);
+     return first == 1;
+ }
+
+ /** @brief Appends an integer in little-endian byte order. */
+ template <class T>
+ void putLE(char*& out, T value) {
+     static_assert(std::is_integral<T>::value, "integers only");
+     typename std::make_unsigned<T>::type bits = static_cast<typename std::make_unsigned<T>::type>(value);
+     for (std::size_t i = 0; i < sizeof(T); ++i) {
+         *out++ = static_cast<char>(bits & 0xff);
+         bits = static_cast<typename std::make_unsigned<T>::type>(bits >> 8);
+     }
+ }
+
+ void putLE(char*& out, double value) {
+     std::uint64_t bits;
+     std::memcpy(&bits, &value, sizeof(bits));
+     putLE(out, bits);
+ }
+
+ /**
+  * @brief Whitespace-separated tokens of a text mesh file, '#' comments skipped.
+  */
+ class TextCursor {
+ public:
+     TextCursor(const char* begin, const char* end) : p_(begin), end_(end) {}
+
+     std::string token() {
+         skipSpace();
+         const char* start = p_;
+         while (p_ < end_ && !std::isspace(static_cast<unsigned char>(*p_))) ++p_;
+         return std::string(start, p_);
+     }
+
+     bool number(double& value) {
+         skipSpace();
+         if (p_ < end_ && *p_ == '+') ++p_; // from_chars takes no '+'
+         auto result = std::from_chars(p_, end_, value);
+         if (result.ec != std::errc()) return false;
+         p_ = result.ptr;
+         return true;
+     }
+
+     bool number(long long& value) {
+         skipSpace();
+         if (p_ < end_ && *p_ == '+') ++p_;
+         auto result = std::from_chars(p_, end_, value);
+         if (result.ec != std::errc()) return false;
+         p_ = result.ptr;
+         return true;
+     }
+
+     /** @brief Skips the rest of the current line (extra OFF columns such as colours). */
+     void skipLine() {
+         while (p_ < end_ && *p_ != '\n') ++p_;
+     }
+
+ private:
+     void skipSpace() {
+         while (p_ < end_) {
+             if (*p_ == '#') {
+                 skipLine();
+             } else if (std::isspace(static_cast<unsigned char>(*p_))) {
+                 ++p_;
+             } else {
+                 break;
+             }
+         }
+     }
+
+     const char* p_;
+     const char* end_;
+ };
+
+ // --- PLY ---
+
+ enum class PlyType { Int8, UInt8, Int16, UInt16, Int32, UInt32, Float32, Float64 };
+
+ bool plyTypeOf(const std::string& name, PlyType& type) {
+     static const struct { const char* name; PlyType type; } names[] = {
+         {"char", PlyType::Int8},     {"int8", PlyType::Int8},
+         {"uchar", PlyType::UInt8},   {"uint8", PlyType::UInt8},
+         {"short", PlyType::Int16},   {"int16", PlyType::Int16},
+         {"ushort", PlyType::UInt16}, {"uint16", PlyType::UInt16},
+         {"int", PlyType::Int32},     {"int32", PlyType::Int32},
+         {"uint", PlyType::UInt32},   {"uint32", PlyType::UInt32},
+         {"float", PlyType::Float32}, {"float32", PlyType::Float32},
+         {"double", PlyType::Float64}, {"float64", PlyType::Float64}};
+     for (const auto& entry : names) {
+         if (name == entry.name) { type = entry.type; return true; }
+     }
+     return false;
+ }
+
+ std::size_t plySize(PlyType type) {
+     switch (type) {
+     case PlyType::Int8: case PlyType::UInt8: return 1;
+     case PlyType::Int16: case PlyType::UInt16: return 2;
+     case PlyType::Int32: case PlyType::UInt32: case PlyType::Float32: return 4;
+     default: return 8;
+     }
+ }
+
+ struct PlyProperty {
+     std::string name;
+     PlyType type = PlyType::Float64;
+     bool list = false;
+     PlyType countType = PlyType::UInt8;
+ };
+
+ struct PlyElement {
+     std::string name;
+     std::uint64_t count = 0;
+     std::vector<PlyProperty> properties;
+ };
+
+ /**
+  * @brief Reads the values of a PLY body one at a time, in any of the three encodings.
+  */
+ class PlyBody {
+ public:
+     enum Encoding { Ascii, LittleEndian, BigEndian };
+
+     PlyBody(const char* begin, const char* end, Encoding encoding)
+         : text_(begin, end), p_(begin), end_(end), encoding_(encoding),
+           swap_(encoding != Ascii && (encoding == LittleEndian) != hostLittleEndian()) {}
+
+     /** @brief Reads the next value; sets failed() at the end of the data. */
+     double value(PlyType type) {
+         if (encoding_ == Ascii) {
+             double v = 0.0;
+             if (!text_.number(v)) failed_ = true;
+             return v;
+         }
+         const std::size_t size = plySize(type);
+         if (static_cast<std::size_t>(end_ - p_) < size) {
+             failed_ = true;
+             return 0.0;
+         }
+         unsigned char bytes[8];
+         std::memcpy(bytes, p_, size);
+         p_ += size;
+         if (swap_) std::reverse(bytes, bytes + size);
+         switch (type) {
+         case PlyType::Int8: { std::int8_t v; std::memcpy(&v, bytes, 1); return v; }
+         case PlyType::UInt8: return bytes[0];
+         case PlyType::Int16: { std::int16_t v; std::memcpy(&v, bytes, 2); return v; }
+         case PlyType::UInt16: { std::uint16_t v; std::memcpy(&v, bytes, 2); return v; }
+         case PlyType::Int32: { std::int32_t v; std::memcpy(&v, bytes, 4); return v; }
+         case PlyType::UInt32: { std::uint32_t v; std::memcpy(&v, bytes, 4); return v; }
+         case PlyType::Float32: { float v; std::memcpy(&v, bytes, 4); return v; }
+         default: { double v; std::memcpy(&v, bytes, 8); return v; }
+         }
+     }
+
+     bool failed() const { return failed_; }
+
+ private:
+     TextCursor text_;
+     const char* p_;
+     const char* end_;
+     Encoding encoding_;
+     bool swap_;
+     bool failed_ = false;
+ };
+
+ } // namespace
+
+ MeshIO::Format MeshIO::formatOf(const std::string& path) {
+     const std::size_t dot = path.find_last_of('.');
+     const std::size_t slash = path.find_last_of("/\\");
+     if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) return Format::Unknown;
+     std::string ext = path.substr(dot + 1);
+     std::transform(ext.begin(), ext.end(), ext.begin(),
+                    [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+     if (ext == "obj") return Format::Obj;
+     if (ext == "off") return Format::Off;
+     if (ext == "ply") return Format::Ply;
+     if (ext == "meshbin") return Format::MeshBin;
+     return Format::Unknown;
+ }
+
+ bool MeshIO::read(const std::string& path, Mesh& mesh) {
+     switch (formatOf(path)) {
+     case Format::Obj:
+         try {
+             ObjParser parser;
+             mesh = parser.parse(path);
+             return true;
+         } catch (const std::exception& ex) {
+             std::cerr << "Error reading OBJ file " << path << ": " << ex.what() << std::endl;
+             return false;
+         }
+     case Format::Off:
+         return readOff(path, mesh);
+     case Format::Ply:
+         return readPly(path, mesh);
+     case Format::MeshBin:
+         if (!MeshBin::read(path, mesh)) {
+             std::cerr << "Error: Cannot read mesh file " << path << std::endl;
+             return false;
+         }
+         return true;
+     default:
+         std::cerr << "Error: Unsupported mesh file type: " << path << std::endl;
+         return false;
+     }
+ }
+
+ bool MeshIO::write(const std::string& path, const Mesh& mesh) {
+     switch (formatOf(path)) {
+     case Format::Obj:
+         return ObjExporter::exportMesh(mesh, path);
+     case Format::Off:
+         return writeOff(path, mesh);
+     case Format::Ply:
+         return writePly(path, mesh);
+     case Format::MeshBin:
+         if (!MeshBin::write(path, mesh, MeshBin::SourceStamp(), false)) {
+             std::cerr << "Error: Cannot write mesh file " << path << std::endl;
+             return false;
+         }
+         return true;
+     default:
+         std::cerr << "Error: Unsupported mesh file type: " << path << std::endl;
+         return false;
+     }
+ }
+
+ bool MeshIO::readOff(const std::string& path, Mesh& mesh) {
+     MappedFile file(path);
+     if (!file.isOpen()) {
+         std::cerr << "Error: Cannot read OFF file: " << path << std::endl;
+         return false;
+     }
+     TextCursor in(file.data(), file.data() + file.size());
+     const std::string header = in.token();
+     long long vertexCount = 0, faceCount = 0, edgeCount = 0;
+     if (header.size() < 3 || header.compare(header.size() - 3, 3, "OFF") != 0
+         || !in.number(vertexCount) || !in.number(faceCount) || !in.number(edgeCount)
+         || vertexCount < 0 || faceCount < 0) {
+         std::cerr << "File " << path << " is not a valid OFF file." << std::endl;
+         return false;
+     }
+
+     Mesh result;
+     result.vertices.resize(static_cast<std::size_t>(vertexCount));
+     for (auto& v : result.vertices) {
+         if (!in.number(v.x) || !in.number(v.y) || !in.number(v.z)) {
+             std::cerr << "Error: Truncated vertex list in OFF file " << path << std::endl;
+             return false;
+         }
+         in.skipLine();
+     }
+     std::vector<FaceElement> corners;
+     for (long long f = 0; f < faceCount; ++f) {
+         long long n = 0;
+         if (!in.number(n) || n < 0) {
+             std::cerr << "Error: Truncated face list in OFF file " << path << std::endl;
+             return false;
+         }
+         corners.clear();
+         for (long long i = 0; i < n; ++i) {
+             long long v = 0;
+             if (!in.number(v)) {
+                 std::cerr << "Error: Truncated face list in OFF file " << path << std::endl;
+                 return false;
+             }
+             corners.emplace_back(static_cast<int>(v));
+         }
+         in.skipLine();
+         result.faces.addFace(corners.data(), corners.size());
+     }
+     mesh = std::move(result);
+     return true;
+ }
+
+ bool MeshIO::writeOff(const std::string& path, const Mesh& mesh) {
+     TextFileWriter out(path);
+     if (!out.isOpen()) {
+         std::cerr << "Error: Cannot write OFF file: " << path << std::endl;
+         return false;
+     }
+     std::string header = "OFF\n";
+     TextFileWriter::appendNumber(header, static_cast<long long>(mesh.vertices.size()));
+     header += ' ';
+     TextFileWriter::appendNumber(header, static_cast<long long>(mesh.faces.size()));
+     header += " 0\n";
+     out.write(header);
+
+     out.writeRecords(mesh.vertices.size(), [&](std::string& text, std::size_t i) {
+         const Vertex& v = mesh.vertices[i];
+         TextFileWriter::appendExact(text, v.x);
+         text += ' ';
+         TextFileWriter::appendExact(text, v.y);
+         text += ' ';
+         TextFileWriter::appendExact(text, v.z);
+         text += '\n';
+     });
+     const auto& elements = mesh.faces.elements();
+     out.writeRecords(mesh.faces.size(), [&](std::string& text, std::size_t f) {
+         const std::size_t begin = mesh.faces.offset(f), end = mesh.faces.offset(f + 1);
+         TextFileWriter::appendNumber(text, static_cast<long long>(end - begin));
+         for (std::size_t i = begin; i < end; ++i) {
+             text += ' ';
+             TextFileWriter::appendNumber(text, elements[i].vertexIndex);
+         }
+         text += '\n';
+     });
+     if (!out.close()) {
+         std::cerr << "Error: Cannot write OFF file: " << path << std::endl;
+         return false;
+     }
+     return true;
+ }
+
+ bool MeshIO::readPly(const std::string& path, Mesh& mesh) {
+     MappedFile file(path);
+     if (!file.isOpen()) {
+         std::cerr << "Error: Cannot read PLY file: " << path << std::endl;
+         return false;
+     }
+     const char* data = file.data();
+     const char* end = data + file.size();
+
+     // Header: one keyword line at a time up to end_header
+     PlyBody::Encoding encoding = PlyBody::Ascii;
+     std::vector<PlyElement> elements;
+     const char* line = data;
+     bool magic = false, format = false, headerDone = false;
+     while (line < end && !headerDone) {
+         const char* eol = static_cast<const char*>(std::memchr(line, '\n', static_cast<std::size_t>(end - line)));
+         if (!eol) eol = end;
+         std::istringstream words(std::string(line, eol));
+         line = eol < end ? eol + 1 : end;
+         std::string keyword;
+         words >> keyword;
+         if (!magic) {
+             if (keyword != "ply") break;
+             magic = true;
+         } else if (keyword == "format") {
+             std::string name;
+             words >> name;
+             if (name == "ascii") encoding = PlyBody::Ascii;
+             else if (name == "binary_little_endian") encoding = PlyBody::LittleEndian;
+             else if (name == "binary_big_endian") encoding = PlyBody::BigEndian;
+             else break;
+             format = true;
+         } else if (keyword == "element") {
+             PlyElement element;
+             if (!(words >> element.name >> element.count)) break;
+             elements.push_back(element);
+         } else if (keyword == "property") {
+             PlyProperty property;
+             std::string type;
+             words >> type;
+             if (type == "list") {
+                 std::string countType;
+                 words >> countType >> type;
+                 property.list = true;
+                 if (!plyTypeOf(countType, property.countType)) break;
+             }
+             if (!plyTypeOf(type, property.type) || !(words >> property.name) || elements.empty()) break;
+             elements.back().properties.push_back(property);
+         } else if (keyword == "end_header") {
+             headerDone = true;
+         }
+         // comment and obj_info lines are ignored
+     }
+     if (!magic || !format || !headerDone) {
+         std::cerr << "File " << path << " is not a valid PLY file." << std::endl;
+         return false;
+     }
+
+     Mesh result;
+     PlyBody body(line, end, encoding);
+     std::vector<double> values;
+     std::vector<FaceElement> corners;
+     for (const PlyElement& element : elements) {
+         const bool isVertex = element.name == "vertex";
+         const bool isFace = element.name == "face";
+         int coordinate[3] = {-1, -1, -1}; // Property index of x, y, z
+         int indices = -1;                 // Property index of the vertex index list
+         for (std::size_t k = 0; k < element.properties.size(); ++k) {
+             const PlyProperty& property = element.properties[k];
+             if (isVertex && !property.list) {
+                 if (property.name == "x") coordinate[0] = static_cast<int>(k);
+                 if (property.name == "y") coordinate[1] = static_cast<int>(k);
+                 if (property.name == "z") coordinate[2] = static_cast<int>(k);
+             }
+             if (isFace && property.list && (property.name == "vertex_indices" || property.name == "vertex_index"))
+                 indices = static_cast<int>(k);
+         }
+         if (isVertex && (coordinate[0] < 0 || coordinate[1] < 0 || coordinate[2] < 0)) {
+             std::cerr << "Error: PLY file " << path << " has no x, y, z vertex properties." << std::endl;
+             return false;
+         }
+         if (isVertex) result.vertices.reserve(static_cast<std::size_t>(std::min<std::uint64_t>(element.count, file.size())));
+
+         values.resize(element.properties.size());
+         for (std::uint64_t item = 0; item < element.count && !body.failed(); ++item) {
+             for (std::size_t k = 0; k < element.properties.size(); ++k) {
+                 const PlyProperty& property = element.properties[k];
+                 if (!property.list) {
+                     values[k] = body.value(property.type);
+                     continue;
+                 }
+                 const double count = body.value(property.countType);
+                 if (count < 0 || count > static_cast<double>(file.size())) {
+                     std::cerr << "Error: Corrupt list in PLY file " << path << std::endl;
+                     return false;
+                 }
+                 const bool keep = static_cast<int>(k) == indices;
+                 if (keep) corners.clear();
+                 for (std::size_t i = 0; i < static_cast<std::size_t>(count) && !body.failed(); ++i) {
+                     const double v = body.value(property.type);
+                     if (keep) corners.emplace_back(static_cast<int>(v));
+                 }
+             }
+             if (isVertex) {
+                 result.vertices.push_back({values[coordinate[0]], values[coordinate[1]], values[coordinate[2]]});
+             } else if (isFace && indices >= 0) {
+                 result.faces.addFace(corners.data(), corners.size());
+             }
+         }
+         if (body.failed()) {
+             std::cerr << "Error: Truncated PLY file " << path << std::endl;
+             return false;
+         }
+     }
+     mesh = std::move(result);
+     return true;
+ }
+
+ bool MeshIO::writePly(const std::string& path, const Mesh& mesh) {
+     std::ofstream out(path, std::ios::binary);
+     if (!out.is_open()) {
+         std::cerr << "Error: Cannot write PLY file: " << path << std::endl;
+         return false;
+     }
+     const FaceTable& faces = mesh.faces;
+     const auto& elements = faces.elements();
+     std::size_t largestFace = 0;
+     for (std::size_t f = 0; f < faces.size(); ++f) largestFace = std::max(largestFace, faces.faceSize(f));
+     const bool shortLists = largestFace <= 255;
+
+     std::ostringstream header;
+     header << "ply\n"
+            << "format binary_little_endian 1.0\n"
+            << "comment Written by MeshX\n"
+            << "element vertex " << mesh.vertices.size() << "\n"
+            << "property double x\n"
+            << "property double y\n"
+            << "property double z\n"
+            << "element face " << faces.size() << "\n"
+            << "property list " << (shortLists ? "uchar" : "uint") << " int vertex_indices\n"
+            << "end_header\n";
+     const std::string headerText = header.str();
+     out.write(headerText.data(), static_cast<std::streamsize>(headerText.size()));
+
+     std::vector<char> buffer(mesh.vertices.size() * 3 * sizeof(double));
+     char* p = buffer.data();
+     for (const Vertex& v : mesh.vertices) {
+         putLE(p, v.x);
+         putLE(p, v.y);
+         putLE(p, v.z);
+     }
+     out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+
+     buffer.assign(faces.size() * (shortLists ? 1 : 4) + elements.size() * sizeof(std::int32_t), 0);
+     p = buffer.data();
+     for (std::size_t f = 0; f < faces.size(); ++f) {
+         const std::size_t begin = faces.offset(f), n = faces.faceSize(f);
+         if (shortLists)
+             putLE(p, static_cast<std::uint8_t>(n));
+         else
+             putLE(p, static_cast<std::uint32_t>(n));
+         for (std::size_t i = begin; i < begin + n; ++i) putLE(p, static_cast<std::int32_t>(elements[i].vertexIndex));
+     }
+     out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+
+     if (!out) {
+         std::cerr << "Error: Cannot write PLY file: " << path << std::endl;
+         return false;
+     }
+     return true;
+ }
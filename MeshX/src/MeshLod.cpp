@@ -0,0 +1,197 @@
+/**
+ * @file MeshLod.cpp
+ * @brief Implements MeshLod.
+ */
+
+ #include "MeshLod.h"
+ #include <CGAL/Exact_predicates_inexact_constructions_kernel.h>
+ #include <CGAL/Surface_mesh.h>
+ #include <CGAL/Surface_mesh_simplification/edge_collapse.h>
+ #include <algorithm>
+ #include <chrono>
+ #include <cmath>
+ #include <exception>
+ #include <limits>
+
+ namespace SMS = CGAL::Surface_mesh_simplification;
+
+ namespace {
+
+ typedef CGAL::Exact_predicates_inexact_constructions_kernel Kernel;
+ typedef CGAL::Surface_mesh<Kernel::Point_3> SurfaceMesh;
+ typedef SurfaceMesh::Vertex_index VertexIndex;
+
+ /** Stops at a fraction of the initial edges, or at once when cancelled. */
+ struct RatioStop {
+     double ratio;
+     const std::atomic<bool>* cancelled;
+
+     template <typename FT, typename Profile>
+     bool operator()(const FT&, const Profile&, std::size_t initialEdges, std::size_t currentEdges) const {
+         if (cancelled && cancelled->load(std::memory_order_relaxed))
+             return true;
+         return static_cast<double>(currentEdges) < ratio * static_cast<double>(initialEdges);
+     }
+ };
+
+ void toSurfaceMesh(const Mesh& mesh, SurfaceMesh& sm) {
+     sm.reserve(mesh.vertices.size(), 0, 0);
+     for (const Vertex& v : mesh.vertices)
+         sm.add_vertex(Kernel::Point_3(v.x, v.y, v.z));
+     const int vertexCount = static_cast<int>(mesh.vertices.size());
+     auto valid = [vertexCount](int i) { return i >= 0 && i < vertexCount; };
+     for (const auto& face : mesh.faces) {
+         const auto& elements = face.elements;
+         if (elements.size() < 3)
+             continue;
+         const int a = elements[0].vertexIndex;
+         for (std::size_t i = 1; i + 1 < elements.size(); ++i) {
+             const int b = elements[i].vertexIndex;
+             const int c = elements[i + 1].vertexIndex;
+             if (!valid(a) || !valid(b) || !valid(c) || a == b || b == c || a == c)
+                 continue;
+             // Returns a null face, adding nothing, where the surface would become non-manifold
+             sm.add_face(VertexIndex(a), VertexIndex(b), VertexIndex(c));
+         }
+     }
+ }
+
+ void toMesh(SurfaceMesh& sm, Mesh& mesh) {
+     sm.collect_garbage();
+     mesh.vertices.clear();
+     mesh.vertices.reserve(sm.number_of_vertices());
+     for (VertexIndex v : sm.vertices()) {
+         const Kernel::Point_3& p = sm.point(v);
+         mesh.vertices.push_back({ p.x(), p.y(), p.z() });
+     }
+     mesh.faces.clear();
+     mesh.faces.reserve(sm.number_of_faces(), 3 * sm.number_of_faces());
+     for (auto f : sm.faces()) {
+         int corner[3];
+         int n = 0;
+         for (VertexIndex v : CGAL::vertices_around_face(sm.halfedge(f), sm)) {
+             if (n < 3) corner[n] = static_cast<int>(v.idx());
+             ++n;
+         }
+         if (n == 3)
+             mesh.faces.addFace({ FaceElement(corner[0]), FaceElement(corner[1]), FaceElement(corner[2]) });
+     }
+ }
+
+ double boundingDiagonal(const Mesh& mesh) {
+     if (mesh.vertices.empty())
+         return 0.0;
+     double lo[3], hi[3];
+     lo[0] = lo[1] = lo[2] = std::numeric_limits<double>::max();
+     hi[0] = hi[1] = hi[2] = std::numeric_limits<double>::lowest();
+     for (const Vertex& v : mesh.vertices) {
+         const double p[3] = { v.x, v.y, v.z };
+         for (int k = 0; k < 3; ++k) {
+             lo[k] = std::min(lo[k], p[k]);
+             hi[k] = std::max(hi[k], p[k]);
+         }
+     }
+     return std::sqrt((hi[0] - lo[0]) * (hi[0] - lo[0]) + (hi[1] - lo[1]) * (hi[1] - lo[1]) +
+                      (hi[2] - lo[2]) * (hi[2] - lo[2]));
+ }
+
+ } // namespace
+
+ MeshLod::~MeshLod() {
+     cancel();
+ }
+
+ MeshLod& MeshLod::operator=(MeshLod&& other) noexcept {
+     if (this != &other) {
+         cancel();
+         job_ = std::future<Result>(); // Waits for the cancelled build
+         cancelled_ = std::move(other.cancelled_);
+         job_ = std::move(other.job_);
+         levels_ = std::move(other.levels_);
+         faceCounts_ = std::move(other.faceCounts_);
+         diagonal_ = other.diagonal_;
+     }
+     return *this;
+ }
+
+ void MeshLod::cancel() {
+     if (cancelled_)
+         *cancelled_ = true;
+ }
+
+ std::vector<Mesh> MeshLod::buildLevels(const Mesh& mesh, const std::atomic<bool>* cancelled) {
+     std::vector<Mesh> levels;
+     if (mesh.faces.size() < kMinFaces)
+         return levels;
+
+     SurfaceMesh sm;
+     toSurfaceMesh(mesh, sm);
+     // Each level is collapsed from the previous one, so the whole cascade
+     // costs little more than the first level
+     const double ratio = 0.25;
+     std::size_t faces = sm.number_of_faces();
+     while (faces * ratio >= kCoarsestFaces) {
+         RatioStop stop{ ratio, cancelled };
+         SMS::edge_collapse(sm, stop);
+         if (cancelled && cancelled->load())
+             return std::vector<Mesh>();
+         // Stalls on meshes that cannot be collapsed further (e.g. many small components)
+         if (sm.number_of_faces() > faces * 0.75)
+             break;
+         faces = sm.number_of_faces();
+         levels.emplace_back();
+         toMesh(sm, levels.back());
+     }
+     return levels;
+ }
+
+ void MeshLod::start(std::shared_ptr<const Mesh> mesh) {
+     cancel();
+     job_ = std::future<Result>();
+     levels_.clear();
+     faceCounts_.clear();
+     diagonal_ = 0.0;
+     if (!mesh || mesh->faces.size() < kMinFaces) {
+         cancelled_.reset();
+         return;
+     }
+     cancelled_ = std::make_shared<std::atomic<bool>>(false);
+     std::shared_ptr<std::atomic<bool>> cancelled = cancelled_;
+     job_ = std::async(std::launch::async, [mesh, cancelled]() {
+         Result result;
+         result.diagonal = boundingDiagonal(*mesh);
+         try {
+             result.levels = buildLevels(*mesh, cancelled.get());
+         } catch (const std::exception&) {
+             // No levels: the mesh is drawn in full
+         }
+         return result;
+     });
+ }
+
+ bool MeshLod::poll() {
+     if (!job_.valid() || job_.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+         return false;
+     Result result = job_.get();
+     levels_ = std::move(result.levels);
+     diagonal_ = result.diagonal;
+     faceCounts_.clear();
+     for (const Mesh& level : levels_)
+         faceCounts_.push_back(level.faces.size());
+     return true;
+ }
+
+ void MeshLod::releaseMeshes() {
+     std::vector<Mesh>().swap(levels_);
+ }
+
+ std::size_t MeshLod::select(double screenDiagonal) const {
+     // About one triangle per pixel of the bounding square on screen
+     const double wanted = 0.5 * screenDiagonal * screenDiagonal;
+     std::size_t level = 0;
+     for (std::size_t i = 0; i < faceCounts_.size(); ++i) {
+         if (static_cast<double>(faceCounts_[i]) >= wanted)
+             level = i + 1;
+     }
+     return level;
+ }
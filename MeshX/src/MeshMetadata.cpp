@@ -4,6 +4,7 @@
  */
 
  #include "MeshMetadata.h"
+ #include <algorithm>
 
  /**
   * @brief Adds metadata for a mesh group.
@@ -11,7 +12,19 @@
   * @param metadata The metadata associated with the mesh group.
   */
  void MeshMetadata::addGroupMetadata(const GroupMetadata& metadata) {
-     groupMetadataMap[metadata.groupName] = metadata;
+     GroupMetadata& stored = groupMetadataMap[metadata.groupName];
+     stored = metadata;
+     auto id = groupIds_.find(metadata.groupName);
+     if (id == groupIds_.end()) {
+         const int freeId = static_cast<int>(std::find(idUsed_.begin(), idUsed_.end(), false) - idUsed_.begin());
+         if (static_cast<std::size_t>(freeId) == idUsed_.size()) {
+             idUsed_.push_back(false);
+             groupFaces_.emplace_back();
+         }
+         idUsed_[freeId] = true;
+         id = groupIds_.emplace(metadata.groupName, freeId).first;
+     }
+     indexGroup(id->second, &stored);
  }
  
  /**
@@ -39,6 +52,7 @@
      auto it = groupMetadataMap.find(groupName);
      if (it != groupMetadataMap.end()) {
          it->second = metadata;
+         indexGroup(groupIds_.at(groupName), &it->second);
          return true;
      }
      return false;
@@ -51,6 +65,12 @@
   * @return True if the group metadata was removed, false if the group was not found.
   */
  bool MeshMetadata::removeGroupMetadata(const std::string& groupName) {
+     auto id = groupIds_.find(groupName);
+     if (id == groupIds_.end()) return false;
+     indexGroup(id->second, nullptr);
+     idUsed_[id->second] = false;
+     groupFaces_[id->second].clear();
+     groupIds_.erase(id);
      return groupMetadataMap.erase(groupName) > 0;
  }
  
@@ -63,12 +83,159 @@
      return groupMetadataMap;
  }
  
+ /**
+  * @brief Re-indexes the faces of a group after it was edited in place.
+  *
+  * @param groupName The name of the group.
+  * @return True if the group exists, false otherwise.
+  */
+ bool MeshMetadata::refreshGroupFaces(const std::string& groupName) {
+     auto it = groupMetadataMap.find(groupName);
+     if (it == groupMetadataMap.end()) return false;
+     indexGroup(groupIds_.at(groupName), &it->second);
+     return true;
+ }
+ 
+ void MeshMetadata::setFaceCount(std::size_t faceCount) {
+     if (faceCount > faceGroups_.size()) growFaces(faceCount);
+ }
+ 
+ int MeshMetadata::groupId(const std::string& groupName) const {
+     auto it = groupIds_.find(groupName);
+     return it == groupIds_.end() ? -1 : it->second;
+ }
+ 
+ bool MeshMetadata::groupContainsFace(int groupId, int face) const {
+     if (groupId < 0 || static_cast<std::size_t>(groupId) >= groupFaces_.size() || face < 0) return false;
+     const auto& bits = groupFaces_[groupId];
+     const std::size_t word = static_cast<std::size_t>(face) >> 6;
+     return word < bits.size() && ((bits[word] >> (face & 63)) & 1u);
+ }
+ 
+ void MeshMetadata::growFaces(std::size_t faceCount) {
+     faceGroups_.resize(faceCount, -1);
+     faceGroupCounts_.resize(faceCount, 0);
+     for (std::size_t id = 0; id < groupFaces_.size(); ++id) {
+         if (idUsed_[id]) groupFaces_[id].resize((faceCount + 63) / 64, 0);
+     }
+ }
+ 
+ int MeshMetadata::lowestGroupContaining(int face) const {
+     for (std::size_t id = 0; id < groupFaces_.size(); ++id) {
+         if (groupContainsFace(static_cast<int>(id), face)) return static_cast<int>(id);
+     }
+     return -1;
+ }
+ 
+ /**
+  * @brief Rebuilds the bitset of one group and updates the faces whose membership changed.
+  *
+  * @param id The group id.
+  * @param group The group's metadata, or nullptr to drop all of its faces.
+  */
+ void MeshMetadata::indexGroup(int id, const GroupMetadata* group) {
+     std::vector<std::uint64_t> bits((faceGroups_.size() + 63) / 64, 0);
+     auto add = [&](int face) {
+         if (face < 0) return;
+         if (static_cast<std::size_t>(face) >= faceGroups_.size()) {
+             growFaces(std::max<std::size_t>(static_cast<std::size_t>(face) + 1, 2 * faceGroups_.size()));
+             bits.resize((faceGroups_.size() + 63) / 64, 0);
+         }
+         bits[static_cast<std::size_t>(face) >> 6] |= std::uint64_t(1) << (face & 63);
+     };
+     if (group) {
+         for (int face : group->faceIndices) add(face);
+         for (const auto& fsd : group->spatialData) add(fsd.faceIndex);
+     }
+ 
+     std::vector<std::uint64_t>& current = groupFaces_[id];
+     current.resize(bits.size(), 0);
+     std::vector<int> added, removed;
+     for (std::size_t w = 0; w < bits.size(); ++w) {
+         for (std::uint64_t diff = current[w] ^ bits[w]; diff; diff &= diff - 1) {
+             int bit = 0;
+             while (!((diff >> bit) & 1u)) ++bit;
+             const int face = static_cast<int>(w * 64 + bit);
+             ((bits[w] >> bit) & 1u ? added : removed).push_back(face);
+         }
+     }
+     current.swap(bits);
+     if (added.empty() && removed.empty()) return;
+ 
+     for (int face : added) {
+         if (++faceGroupCounts_[face] == 2) ++overlappingFaces_;
+         if (faceGroups_[face] < 0 || id < faceGroups_[face]) faceGroups_[face] = id;
+     }
+     for (int face : removed) {
+         if (faceGroupCounts_[face]-- == 2) --overlappingFaces_;
+         if (faceGroups_[face] == id) faceGroups_[face] = faceGroupCounts_[face] ? lowestGroupContaining(face) : -1;
+     }
+     ++membershipVersion_;
+ }
+ 
+ namespace {
+ 
+ /**
+  * @brief Encodes face indices as flat [first, count] pairs of consecutive runs.
+  */
+ std::vector<int> faceRuns(const std::vector<int>& faces) {
+     std::vector<int> runs;
+     for (std::size_t i = 0; i < faces.size();) {
+         std::size_t end = i + 1;
+         while (end < faces.size() && faces[end] == faces[end - 1] + 1) ++end;
+         runs.push_back(faces[i]);
+         runs.push_back(static_cast<int>(end - i));
+         i = end;
+     }
+     return runs;
+ }
+ 
+ /**
+  * @brief Spatial data as parallel arrays: faceIndex, flat centroid xyz and,
+  * for faces recorded with vertices, vertexCount plus flat vertex data.
+  */
+ json columnarSpatialData(const std::vector<FaceSpatialData>& spatialData, bool vertexReferences) {
+     std::vector<int> faceIndex, vertexCount, vertexIndices;
+     std::vector<double> centroid, vertices;
+     faceIndex.reserve(spatialData.size());
+     centroid.reserve(3 * spatialData.size());
+     bool withVertices = false;
+     for (const auto& fsd : spatialData) {
+         faceIndex.push_back(fsd.faceIndex);
+         centroid.insert(centroid.end(), fsd.centroid.begin(), fsd.centroid.end());
+         withVertices = withVertices || !fsd.vertices.empty();
+     }
+     json columns;
+     columns["faceIndex"] = faceIndex;
+     columns["centroid"] = centroid;
+     if (!withVertices) return columns;
+ 
+     vertexCount.reserve(spatialData.size());
+     for (const auto& fsd : spatialData) {
+         vertexCount.push_back(static_cast<int>(fsd.vertices.size()));
+         if (vertexReferences) {
+             vertexIndices.insert(vertexIndices.end(), fsd.vertexIndices.begin(), fsd.vertexIndices.end());
+         } else {
+             for (const auto& vert : fsd.vertices) vertices.insert(vertices.end(), vert.begin(), vert.end());
+         }
+     }
+     columns["vertexCount"] = vertexCount;
+     if (vertexReferences)
+         columns["vertexIndices"] = vertexIndices;
+     else
+         columns["vertices"] = vertices;
+     return columns;
+ }
+ 
+ } // namespace
+ 
  /**
   * @brief Converts the mesh metadata to a JSON representation.
   *
+  * @param encoding The compact layouts to use; the default reproduces the original layout.
   * @return A JSON object representing the mesh metadata.
   */
- json MeshMetadata::toJson() const {
+ json MeshMetadata::toJson(const MetadataEncoding& encoding) const {
      json j;
      for (const auto& pair : groupMetadataMap) {
          const GroupMetadata& group = pair.second;
@@ -84,21 +251,31 @@
              {"poissonRatio", group.materialProperties.poissonRatio}
          };
          jGroup["elementTags"] = group.elementTags;
-         jGroup["faceIndices"] = group.faceIndices;
-         jGroup["spatialData"] = json::array();
-         for (const auto& fsd : group.spatialData) {
-             json jFsd;
-             jFsd["faceIndex"] = fsd.faceIndex;
-             jFsd["centroid"] = {fsd.centroid[0], fsd.centroid[1], fsd.centroid[2]};
-             jFsd["vertices"] = json::array();
-             for (const auto &vert : fsd.vertices) {
-                 jFsd["vertices"].push_back({vert[0], vert[1], vert[2]});
+         if (encoding.faceRanges)
+             jGroup["faceRanges"] = faceRuns(group.faceIndices);
+         else
+             jGroup["faceIndices"] = group.faceIndices;
+         if (encoding.columnar) {
+             jGroup["spatialData"] = columnarSpatialData(group.spatialData, encoding.vertexReferences);
+         } else {
+             jGroup["spatialData"] = json::array();
+             for (const auto& fsd : group.spatialData) {
+                 json jFsd;
+                 jFsd["faceIndex"] = fsd.faceIndex;
+                 jFsd["centroid"] = {fsd.centroid[0], fsd.centroid[1], fsd.centroid[2]};
+                 if (encoding.vertexReferences) {
+                     jFsd["vertexIndices"] = fsd.vertexIndices;
+                 } else {
+                     jFsd["vertices"] = json::array();
+                     for (const auto &vert : fsd.vertices) {
+                         jFsd["vertices"].push_back({vert[0], vert[1], vert[2]});
+                     }
+                 }
+                 jGroup["spatialData"].push_back(jFsd);
              }
-             jGroup["spatialData"].push_back(jFsd);
          }
          // Use group name as the key.
          j[group.groupName] = jGroup;
      }
      return j;
  }
- 
\ No newline at end of file
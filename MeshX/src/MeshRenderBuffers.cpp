@@ -0,0 +1,257 @@
+/**
+ * @file MeshRenderBuffers.cpp
+ * @brief Implementation of MeshRenderBuffers.
+ */
+
+ #include "MeshRenderBuffers.h"
+ #include "GLFW/glfw3.h"
+ #include <algorithm>
+ #include <cstddef>
+ #include <utility>
+
+ // Buffer object tokens (OpenGL 1.5), missing from OpenGL 1.1 headers
+ #ifndef GL_ARRAY_BUFFER
+ #define GL_ARRAY_BUFFER 0x8892
+ #endif
+ #ifndef GL_ELEMENT_ARRAY_BUFFER
+ #define GL_ELEMENT_ARRAY_BUFFER 0x8893
+ #endif
+ #ifndef GL_STATIC_DRAW
+ #define GL_STATIC_DRAW 0x88E4
+ #endif
+
+ #ifdef _WIN32
+ #define MESHX_GL_CALL __stdcall
+ #else
+ #define MESHX_GL_CALL
+ #endif
+
+ namespace {
+
+ typedef void (MESHX_GL_CALL *GenBuffersProc)(GLsizei, GLuint*);
+ typedef void (MESHX_GL_CALL *DeleteBuffersProc)(GLsizei, const GLuint*);
+ typedef void (MESHX_GL_CALL *BindBufferProc)(GLenum, GLuint);
+ typedef void (MESHX_GL_CALL *BufferDataProc)(GLenum, std::ptrdiff_t, const void*, GLenum);
+
+ GenBuffersProc genBuffers = nullptr;
+ DeleteBuffersProc deleteBuffers = nullptr;
+ BindBufferProc bindBuffer = nullptr;
+ BufferDataProc bufferData = nullptr;
+
+ bool haveBuffers() { return genBuffers && deleteBuffers && bindBuffer && bufferData; }
+ 
+ /** @brief Group colours, avoiding the clean (green) and error (red) colours. */
+ const float kGroupColours[][3] = {
+     {0.20f, 0.45f, 1.00f}, {1.00f, 0.60f, 0.10f}, {0.70f, 0.30f, 0.90f}, {0.10f, 0.85f, 0.90f},
+     {1.00f, 0.90f, 0.20f}, {0.95f, 0.35f, 0.75f}, {0.55f, 0.40f, 0.25f}, {0.60f, 0.60f, 0.60f}
+ };
+
+ /** @brief Creates a buffer object holding data; 0 without buffer objects. */
+ template <class T>
+ GLuint createBuffer(GLenum target, const std::vector<T>& data) {
+     if (!haveBuffers()) return 0;
+     GLuint buffer = 0;
+     genBuffers(1, &buffer);
+     bindBuffer(target, buffer);
+     bufferData(target, static_cast<std::ptrdiff_t>(data.size() * sizeof(T)), data.data(), GL_STATIC_DRAW);
+     bindBuffer(target, 0);
+     return buffer;
+ }
+
+ } // namespace
+
+ bool MeshRenderBuffers::loadGL() {
+     genBuffers = reinterpret_cast<GenBuffersProc>(glfwGetProcAddress("glGenBuffers"));
+     deleteBuffers = reinterpret_cast<DeleteBuffersProc>(glfwGetProcAddress("glDeleteBuffers"));
+     bindBuffer = reinterpret_cast<BindBufferProc>(glfwGetProcAddress("glBindBuffer"));
+     bufferData = reinterpret_cast<BufferDataProc>(glfwGetProcAddress("glBufferData"));
+     return haveBuffers();
+ }
+
+ MeshRenderBuffers::~MeshRenderBuffers() {
+     release();
+ }
+
+ MeshRenderBuffers::MeshRenderBuffers(MeshRenderBuffers&& other) noexcept {
+     *this = std::move(other);
+ }
+
+ MeshRenderBuffers& MeshRenderBuffers::operator=(MeshRenderBuffers&& other) noexcept {
+     if (this != &other) {
+         release();
+         positions_ = std::move(other.positions_);
+         vertexBuffer_ = other.vertexBuffer_;
+         triangles_ = std::move(other.triangles_);
+         edges_ = std::move(other.edges_);
+         other.vertexBuffer_ = 0;
+         other.triangles_ = Indices();
+         other.edges_ = Indices();
+     }
+     return *this;
+ }
+
+ void MeshRenderBuffers::groupColor(int group, float rgb[3]) {
+     const std::size_t count = sizeof(kGroupColours) / sizeof(kGroupColours[0]);
+     const float* colour = kGroupColours[static_cast<std::size_t>(group < 0 ? 0 : group) % count];
+     rgb[0] = colour[0];
+     rgb[1] = colour[1];
+     rgb[2] = colour[2];
+ }
+ 
+ void MeshRenderBuffers::release() {
+     if (haveBuffers() && vertexBuffer_) deleteBuffers(1, &vertexBuffer_);
+     positions_.clear();
+     vertexBuffer_ = 0;
+     releaseIndices();
+ }
+ 
+ void MeshRenderBuffers::releaseIndices() {
+     if (haveBuffers()) {
+         const GLuint buffers[2] = {triangles_.buffer, edges_.buffer};
+         for (GLuint buffer : buffers) {
+             if (buffer) deleteBuffers(1, &buffer);
+         }
+     }
+     triangles_ = Indices();
+     edges_ = Indices();
+ }
+
+ void MeshRenderBuffers::upload(const Mesh& mesh, const std::vector<std::uint8_t>& faceErrors,
+                                const std::vector<int>& faceGroups) {
+     release();
+     const std::size_t vertexCount = mesh.vertices.size();
+     positions_.resize(3 * vertexCount);
+     for (std::size_t i = 0; i < vertexCount; ++i) {
+         positions_[3 * i] = static_cast<float>(mesh.vertices[i].x);
+         positions_[3 * i + 1] = static_cast<float>(mesh.vertices[i].y);
+         positions_[3 * i + 2] = static_cast<float>(mesh.vertices[i].z);
+     }
+     vertexBuffer_ = createBuffer(GL_ARRAY_BUFFER, positions_);
+     if (vertexBuffer_) std::vector<float>().swap(positions_); // The GPU has its own copy
+     buildIndices(mesh, faceErrors, faceGroups);
+ }
+ 
+ void MeshRenderBuffers::setFaceGroups(const Mesh& mesh, const std::vector<std::uint8_t>& faceErrors,
+                                       const std::vector<int>& faceGroups) {
+     releaseIndices();
+     buildIndices(mesh, faceErrors, faceGroups);
+ }
+ 
+ void MeshRenderBuffers::buildIndices(const Mesh& mesh, const std::vector<std::uint8_t>& faceErrors,
+                                      const std::vector<int>& faceGroups) {
+     const FaceTable& faces = mesh.faces;
+     const auto& elements = faces.elements();
+     const std::size_t vertexCount = mesh.vertices.size();
+ 
+     // Colour slot of each face: 0 clean, 1 + group id, last for errors; -1 not drawable
+     int groupLimit = 0;
+     for (int group : faceGroups) groupLimit = std::max(groupLimit, group + 1);
+     const int errorSlot = groupLimit + 1;
+     auto usable = [&](std::size_t f) {
+         const std::size_t begin = faces.offset(f), end = faces.offset(f + 1);
+         if (end - begin < 3) return false;
+         for (std::size_t i = begin; i < end; ++i) {
+             const int v = elements[i].vertexIndex;
+             if (v < 0 || static_cast<std::size_t>(v) >= vertexCount) return false;
+         }
+         return true;
+     };
+     std::vector<int> slots(faces.size());
+     std::vector<std::size_t> triangleStart(errorSlot + 2, 0), edgeStart(errorSlot + 2, 0);
+     for (std::size_t f = 0; f < faces.size(); ++f) {
+         int slot = -1;
+         if (usable(f)) {
+             if (f < faceErrors.size() && faceErrors[f] != 0)
+                 slot = errorSlot;
+             else if (f < faceGroups.size() && faceGroups[f] >= 0)
+                 slot = 1 + faceGroups[f];
+             else
+                 slot = 0;
+             const std::size_t n = faces.faceSize(f);
+             triangleStart[slot + 1] += 3 * (n - 2);
+             edgeStart[slot + 1] += 2 * n;
+         }
+         slots[f] = slot;
+     }
+     for (int slot = 0; slot <= errorSlot; ++slot) {
+         const std::uint32_t triangleCount = static_cast<std::uint32_t>(triangleStart[slot + 1]);
+         const std::uint32_t edgeCount = static_cast<std::uint32_t>(edgeStart[slot + 1]);
+         const int colour = slot == 0 ? kClean : slot == errorSlot ? kError : slot - 1;
+         if (triangleCount) triangles_.ranges.push_back({colour, triangleCount});
+         if (edgeCount) edges_.ranges.push_back({colour, edgeCount});
+         triangleStart[slot + 1] += triangleStart[slot];
+         edgeStart[slot + 1] += edgeStart[slot];
+     }
+ 
+     // Scatter each face into its slot's range (fans for triangles)
+     triangles_.data.resize(triangleStart[errorSlot + 1]);
+     edges_.data.resize(edgeStart[errorSlot + 1]);
+     for (std::size_t f = 0; f < faces.size(); ++f) {
+         if (slots[f] < 0) continue;
+         const std::size_t begin = faces.offset(f), n = faces.faceSize(f);
+         std::uint32_t* triangle = triangles_.data.data() + triangleStart[slots[f]];
+         std::uint32_t* edge = edges_.data.data() + edgeStart[slots[f]];
+         const std::uint32_t first = static_cast<std::uint32_t>(elements[begin].vertexIndex);
+         for (std::size_t i = 1; i + 1 < n; ++i) {
+             *triangle++ = first;
+             *triangle++ = static_cast<std::uint32_t>(elements[begin + i].vertexIndex);
+             *triangle++ = static_cast<std::uint32_t>(elements[begin + i + 1].vertexIndex);
+         }
+         for (std::size_t i = 0; i < n; ++i) {
+             *edge++ = static_cast<std::uint32_t>(elements[begin + i].vertexIndex);
+             *edge++ = static_cast<std::uint32_t>(elements[begin + (i + 1) % n].vertexIndex);
+         }
+         triangleStart[slots[f]] += 3 * (n - 2);
+         edgeStart[slots[f]] += 2 * n;
+     }
+ 
+     triangles_.buffer = createBuffer(GL_ELEMENT_ARRAY_BUFFER, triangles_.data);
+     edges_.buffer = createBuffer(GL_ELEMENT_ARRAY_BUFFER, edges_.data);
+     if (triangles_.buffer) {
+         std::vector<std::uint32_t>().swap(triangles_.data);
+         std::vector<std::uint32_t>().swap(edges_.data);
+     }
+ }
+ 
+ void MeshRenderBuffers::draw(bool wireframe) const {
+     if (!vertexBuffer_ && positions_.empty()) return;
+     glEnableClientState(GL_VERTEX_ARRAY);
+     if (vertexBuffer_) {
+         bindBuffer(GL_ARRAY_BUFFER, vertexBuffer_);
+         glVertexPointer(3, GL_FLOAT, 0, nullptr);
+     } else {
+         glVertexPointer(3, GL_FLOAT, 0, positions_.data());
+     }
+     if (wireframe)
+         drawIndices(edges_, GL_LINES);
+     else
+         drawIndices(triangles_, GL_TRIANGLES);
+     if (vertexBuffer_) bindBuffer(GL_ARRAY_BUFFER, 0);
+     glDisableClientState(GL_VERTEX_ARRAY);
+ }
+
+ void MeshRenderBuffers::drawIndices(const Indices& indices, unsigned int mode) const {
+     // With a bound index buffer the "pointers" are byte offsets into it
+     if (indices.buffer)
+         bindBuffer(GL_ELEMENT_ARRAY_BUFFER, indices.buffer);
+     else if (indices.data.empty())
+         return;
+     std::size_t first = 0;
+     for (const Range& range : indices.ranges) {
+         if (range.colour == kClean) {
+             glColor3f(0.0f, 1.0f, 0.0f);
+         } else if (range.colour == kError) {
+             glColor3f(1.0f, 0.0f, 0.0f);
+         } else {
+             float rgb[3];
+             groupColor(range.colour, rgb);
+             glColor3fv(rgb);
+         }
+         const void* start = indices.buffer
+             ? reinterpret_cast<const void*>(static_cast<std::uintptr_t>(first * sizeof(std::uint32_t)))
+             : static_cast<const void*>(indices.data.data() + first);
+         glDrawElements(mode, static_cast<GLsizei>(range.count), GL_UNSIGNED_INT, start);
+         first += range.count;
+     }
+     if (indices.buffer) bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+ }
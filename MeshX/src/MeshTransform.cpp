@@ -4,6 +4,8 @@
  */
 
  #include "MeshTransform.h"
+ #include <tbb/blocked_range.h>
+ #include <tbb/parallel_for.h>
  #include <cmath>
  
  // Define M_PI if not defined
@@ -11,6 +13,98 @@
  #define M_PI 3.14159265358979323846
  #endif
  
+ // Element (row, col) of a column-major matrix
+ #define AT(m, row, col) (m)[(col) * 4 + (row)]
+ 
+ MeshTransform::Matrix MeshTransform::identity() {
+     return Matrix{1, 0, 0, 0,
+                   0, 1, 0, 0,
+                   0, 0, 1, 0,
+                   0, 0, 0, 1};
+ }
+ 
+ bool MeshTransform::isIdentity(const Matrix& m) {
+     return m == identity();
+ }
+ 
+ MeshTransform::Matrix MeshTransform::translation(double tx, double ty, double tz) {
+     Matrix m = identity();
+     AT(m, 0, 3) = tx;
+     AT(m, 1, 3) = ty;
+     AT(m, 2, 3) = tz;
+     return m;
+ }
+ 
+ MeshTransform::Matrix MeshTransform::scaling(double sx, double sy, double sz) {
+     Matrix m = identity();
+     AT(m, 0, 0) = sx;
+     AT(m, 1, 1) = sy;
+     AT(m, 2, 2) = sz;
+     return m;
+ }
+ 
+ /**
+  * @brief Rotation around the x, y, and z axes, in that order.
+  *
+  * Same convention as rotate(): the product Rz * Ry * Rx of the three axis rotations.
+  */
+ MeshTransform::Matrix MeshTransform::rotation(double angleX, double angleY, double angleZ) {
+     // Convert angles from degrees to radians
+     double radX = angleX * M_PI / 180.0;
+     double radY = angleY * M_PI / 180.0;
+     double radZ = angleZ * M_PI / 180.0;
+ 
+     double cosX = cos(radX), sinX = sin(radX);
+     double cosY = cos(radY), sinY = sin(radY);
+     double cosZ = cos(radZ), sinZ = sin(radZ);
+ 
+     Matrix rx = identity(), ry = identity(), rz = identity();
+     AT(rx, 1, 1) = cosX; AT(rx, 1, 2) = -sinX;
+     AT(rx, 2, 1) = sinX; AT(rx, 2, 2) = cosX;
+     AT(ry, 0, 0) = cosY; AT(ry, 0, 2) = sinY;
+     AT(ry, 2, 0) = -sinY; AT(ry, 2, 2) = cosY;
+     AT(rz, 0, 0) = cosZ; AT(rz, 0, 1) = -sinZ;
+     AT(rz, 1, 0) = sinZ; AT(rz, 1, 1) = cosZ;
+     return compose(rz, compose(ry, rx));
+ }
+ 
+ MeshTransform::Matrix MeshTransform::compose(const Matrix& a, const Matrix& b) {
+     Matrix m{};
+     for (int row = 0; row < 4; ++row) {
+         for (int col = 0; col < 4; ++col) {
+             double sum = 0.0;
+             for (int k = 0; k < 4; ++k) sum += AT(a, row, k) * AT(b, k, col);
+             AT(m, row, col) = sum;
+         }
+     }
+     return m;
+ }
+ 
+ /**
+  * @brief Applies an affine transform to every vertex of a mesh.
+  *
+  * The coefficients are copied into locals so the inner loop has no aliasing
+  * or branches to stop the compiler from vectorizing it.
+  *
+  * @param mesh The mesh to be transformed.
+  * @param m The affine transform.
+  */
+ void MeshTransform::apply(Mesh& mesh, const Matrix& m) {
+     const double m00 = AT(m, 0, 0), m01 = AT(m, 0, 1), m02 = AT(m, 0, 2), m03 = AT(m, 0, 3);
+     const double m10 = AT(m, 1, 0), m11 = AT(m, 1, 1), m12 = AT(m, 1, 2), m13 = AT(m, 1, 3);
+     const double m20 = AT(m, 2, 0), m21 = AT(m, 2, 1), m22 = AT(m, 2, 2), m23 = AT(m, 2, 3);
+     Vertex* vertices = mesh.vertices.data();
+     tbb::parallel_for(tbb::blocked_range<std::size_t>(0, mesh.vertices.size(), 16384),
+                       [=](const tbb::blocked_range<std::size_t>& range) {
+         for (std::size_t i = range.begin(); i != range.end(); ++i) {
+             const double x = vertices[i].x, y = vertices[i].y, z = vertices[i].z;
+             vertices[i].x = m00 * x + m01 * y + m02 * z + m03;
+             vertices[i].y = m10 * x + m11 * y + m12 * z + m13;
+             vertices[i].z = m20 * x + m21 * y + m22 * z + m23;
+         }
+     });
+ }
+ 
  /**
   * @brief Translates a mesh by a given offset.
   *
@@ -22,11 +116,7 @@
   * @param tz Translation along the z-axis.
   */
  void MeshTransform::translate(Mesh& mesh, double tx, double ty, double tz) {
-     for (auto& vertex : mesh.vertices) {
-         vertex.x += tx;
-         vertex.y += ty;
-         vertex.z += tz;
-     }
+     apply(mesh, translation(tx, ty, tz));
  }
  
  /**
@@ -40,17 +130,14 @@
   * @param sz Scaling factor along the z-axis.
   */
  void MeshTransform::scale(Mesh& mesh, double sx, double sy, double sz) {
-     for (auto& vertex : mesh.vertices) {
-         vertex.x *= sx;
-         vertex.y *= sy;
-         vertex.z *= sz;
-     }
+     apply(mesh, scaling(sx, sy, sz));
  }
  
  /**
   * @brief Rotates a mesh around the x, y, and z axes by specified angles.
   *
-  * The function rotates all vertices in the mesh using rotation matrices for each axis.
+  * The three axis rotations are combined into one matrix, so every vertex is
+  * transformed once.
   *
   * @param mesh The mesh to be rotated.
   * @param angleX Rotation angle (in degrees) around the x-axis.
@@ -58,34 +145,5 @@
   * @param angleZ Rotation angle (in degrees) around the z-axis.
   */
  void MeshTransform::rotate(Mesh& mesh, double angleX, double angleY, double angleZ) {
-     // Convert angles from degrees to radians
-     double radX = angleX * M_PI / 180.0;
-     double radY = angleY * M_PI / 180.0;
-     double radZ = angleZ * M_PI / 180.0;
- 
-     // Rotation matrices
-     double cosX = cos(radX), sinX = sin(radX);
-     double cosY = cos(radY), sinY = sin(radY);
-     double cosZ = cos(radZ), sinZ = sin(radZ);
- 
-     for (auto& vertex : mesh.vertices) {
-         // Rotate around X-axis
-         double y1 = cosX * vertex.y - sinX * vertex.z;
-         double z1 = sinX * vertex.y + cosX * vertex.z;
-         vertex.y = y1;
-         vertex.z = z1;
- 
-         // Rotate around Y-axis
-         double x2 = cosY * vertex.x + sinY * vertex.z;
-         double z2 = -sinY * vertex.x + cosY * vertex.z;
-         vertex.x = x2;
-         vertex.z = z2;
- 
-         // Rotate around Z-axis
-         double x3 = cosZ * vertex.x - sinZ * vertex.y;
-         double y3 = sinZ * vertex.x + cosZ * vertex.y;
-         vertex.x = x3;
-         vertex.y = y3;
-     }
+     apply(mesh, rotation(angleX, angleY, angleZ));
  }
- 
\ No newline at end of file
@@ -4,9 +4,361 @@
  */
 
  #include "MeshValidator.h"
- #include <map>
- #include <sstream>
+ #include "TriangleBVH.h"
+ #include <tbb/blocked_range.h>
+ #include <tbb/combinable.h>
+ #include <tbb/parallel_for.h>
+ #include <tbb/parallel_sort.h>
  #include <algorithm>
+ #include <cmath>
+ 
+ namespace {
+ 
+ /** @brief An edge occurrence: sorted vertex pair packed into one key, its face and direction. */
+ struct EdgeKey {
+     std::uint64_t key;
+     std::uint32_t face;
+     std::uint8_t forward; ///< 1 if the face runs the edge from the smaller to the larger vertex
+ 
+     bool operator<(const EdgeKey& other) const { return key < other.key; }
+ };
+ 
+ /** @brief Two faces sharing a manifold edge; flip is 1 if they run it the same way. */
+ struct Adjacency {
+     std::uint32_t a;
+     std::uint32_t b;
+     std::uint8_t flip;
+ };
+ 
+ // Flipping the sign bit makes unsigned key order match signed (v1, v2) order
+ const std::uint32_t signBit = 0x80000000u;
+ 
+ std::uint64_t packEdge(int v1, int v2) {
+     if (v1 > v2) std::swap(v1, v2);
+     return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(v1) ^ signBit) << 32) |
+            (static_cast<std::uint32_t>(v2) ^ signBit);
+ }
+ 
+ int unpackVertex(std::uint64_t half) {
+     return static_cast<int>(static_cast<std::uint32_t>(half) ^ signBit);
+ }
+ 
+ /**
+  * @brief Propagates orientation across the face adjacency, one connected surface at a time.
+  *
+  * Each surface is walked breadth-first from its lowest face, which fixes its
+  * orientation. A face reached along two paths with different orientations
+  * makes the surface non-orientable; otherwise the smaller of the two
+  * orientation classes is reported as flipped.
+  */
+ void propagateOrientation(std::size_t faceCount, const std::vector<Adjacency>& adjacent,
+                           MeshValidator::Report& report) {
+     std::vector<std::uint32_t> start(faceCount + 1, 0);
+     for (const Adjacency& e : adjacent) {
+         ++start[e.a + 1];
+         ++start[e.b + 1];
+     }
+     for (std::size_t f = 0; f < faceCount; ++f) start[f + 1] += start[f];
+     std::vector<std::pair<std::uint32_t, std::uint8_t>> neighbours(start[faceCount]);
+     std::vector<std::uint32_t> fill(start.begin(), start.end() - 1);
+     for (const Adjacency& e : adjacent) {
+         neighbours[fill[e.a]++] = {e.b, e.flip};
+         neighbours[fill[e.b]++] = {e.a, e.flip};
+     }
+ 
+     const std::uint8_t unvisited = 2;
+     std::vector<std::uint8_t> parity(faceCount, unvisited);
+     std::vector<std::uint32_t> surface;
+     for (std::size_t seed = 0; seed < faceCount; ++seed) {
+         if (parity[seed] != unvisited) continue;
+         parity[seed] = 0;
+         surface.assign(1, static_cast<std::uint32_t>(seed));
+         std::size_t flipped = 0;
+         bool consistent = true;
+         for (std::size_t k = 0; k < surface.size(); ++k) {
+             const std::uint32_t f = surface[k];
+             for (std::uint32_t n = start[f]; n < start[f + 1]; ++n) {
+                 const std::uint32_t g = neighbours[n].first;
+                 const std::uint8_t want = parity[f] ^ neighbours[n].second;
+                 if (parity[g] == unvisited) {
+                     parity[g] = want;
+                     flipped += want;
+                     surface.push_back(g);
+                 } else if (parity[g] != want) {
+                     consistent = false;
+                     report.faceErrors[f] |= MeshValidator::FlippedFace;
+                     report.faceErrors[g] |= MeshValidator::FlippedFace;
+                 }
+             }
+         }
+         if (!consistent) {
+             report.nonOrientable.push_back(static_cast<std::uint32_t>(seed));
+             continue;
+         }
+         const std::uint8_t minority = 2 * flipped <= surface.size() ? 1 : 0;
+         for (std::uint32_t f : surface) {
+             if (parity[f] != minority) continue;
+             report.flippedFaces.push_back(f);
+             report.faceErrors[f] |= MeshValidator::FlippedFace;
+         }
+     }
+     std::sort(report.flippedFaces.begin(), report.flippedFaces.end());
+ }
+ 
+ struct Vec3 {
+     double x, y, z;
+ };
+ 
+ Vec3 operator-(const Vec3& a, const Vec3& b) { return {a.x - b.x, a.y - b.y, a.z - b.z}; }
+ Vec3 operator+(const Vec3& a, const Vec3& b) { return {a.x + b.x, a.y + b.y, a.z + b.z}; }
+ Vec3 operator*(double s, const Vec3& a) { return {s * a.x, s * a.y, s * a.z}; }
+ double dot(const Vec3& a, const Vec3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+ Vec3 cross(const Vec3& a, const Vec3& b) {
+     return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+ }
+ 
+ struct Vec2 {
+     double x, y;
+ };
+ 
+ /** @brief Drops the coordinate along which n is largest. */
+ Vec2 project(const Vec3& p, const Vec3& n) {
+     const double ax = std::abs(n.x), ay = std::abs(n.y), az = std::abs(n.z);
+     if (ax >= ay && ax >= az) return {p.y, p.z};
+     if (ay >= az) return {p.z, p.x};
+     return {p.x, p.y};
+ }
+ 
+ double orient2(const Vec2& a, const Vec2& b, const Vec2& c) {
+     return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+ }
+ 
+ bool onSegment2(const Vec2& a, const Vec2& b, const Vec2& p) {
+     return std::min(a.x, b.x) <= p.x && p.x <= std::max(a.x, b.x) &&
+            std::min(a.y, b.y) <= p.y && p.y <= std::max(a.y, b.y);
+ }
+ 
+ bool segmentsMeet2(const Vec2& a, const Vec2& b, const Vec2& c, const Vec2& d) {
+     const double d1 = orient2(c, d, a), d2 = orient2(c, d, b);
+     const double d3 = orient2(a, b, c), d4 = orient2(a, b, d);
+     if (((d1 > 0 && d2 < 0) || (d1 < 0 && d2 > 0)) && ((d3 > 0 && d4 < 0) || (d3 < 0 && d4 > 0))) return true;
+     return (d1 == 0 && onSegment2(c, d, a)) || (d2 == 0 && onSegment2(c, d, b)) ||
+            (d3 == 0 && onSegment2(a, b, c)) || (d4 == 0 && onSegment2(a, b, d));
+ }
+ 
+ bool insideTriangle2(const Vec2& p, const Vec2& a, const Vec2& b, const Vec2& c) {
+     const double o1 = orient2(a, b, p), o2 = orient2(b, c, p), o3 = orient2(c, a, p);
+     return (o1 >= 0 && o2 >= 0 && o3 >= 0) || (o1 <= 0 && o2 <= 0 && o3 <= 0);
+ }
+ 
+ /**
+  * @brief True if segment pq touches triangle abc.
+  * @param eps Distance below which a point counts as lying in the triangle's plane.
+  */
+ bool segmentHitsTriangle(const Vec3& p, const Vec3& q, const Vec3 (&t)[3], double eps) {
+     const Vec3 n = cross(t[1] - t[0], t[2] - t[0]);
+     const double length = std::sqrt(dot(n, n));
+     if (length == 0.0) return false; // Degenerate triangle
+     const double dp = dot(n, p - t[0]) / length;
+     const double dq = dot(n, q - t[0]) / length;
+     if ((dp > eps && dq > eps) || (dp < -eps && dq < -eps)) return false;
+ 
+     if (std::abs(dp) <= eps && std::abs(dq) <= eps) {
+         // Coplanar: compare in the plane's dominant projection
+         const Vec2 p2 = project(p, n), q2 = project(q, n);
+         const Vec2 a = project(t[0], n), b = project(t[1], n), c = project(t[2], n);
+         return insideTriangle2(p2, a, b, c) || insideTriangle2(q2, a, b, c) ||
+                segmentsMeet2(p2, q2, a, b) || segmentsMeet2(p2, q2, b, c) || segmentsMeet2(p2, q2, c, a);
+     }
+ 
+     const double s = std::min(1.0, std::max(0.0, dp / (dp - dq)));
+     const Vec3 x = p + s * (q - p);
+     return dot(cross(t[1] - t[0], x - t[0]), n) >= 0 &&
+            dot(cross(t[2] - t[1], x - t[1]), n) >= 0 &&
+            dot(cross(t[0] - t[2], x - t[2]), n) >= 0;
+ }
+ 
+ /**
+  * @brief True if two triangles of the mesh intersect other than along shared vertices.
+  *
+  * Triangles sharing an edge are not tested (they could only overlap when
+  * coplanar). Triangles sharing one vertex intersect exactly when the edge of
+  * one opposite that vertex touches the other. Otherwise two triangles
+  * intersect exactly when an edge of one touches the other.
+  */
+ bool trianglesIntersect(const std::vector<Vertex>& vertices, const TriangleBVH::Triangle& ta,
+                         const TriangleBVH::Triangle& tb, double eps) {
+     int shared = 0, sharedA = -1, sharedB = -1;
+     for (int i = 0; i < 3; ++i) {
+         for (int j = 0; j < 3; ++j) {
+             if (ta.v[i] == tb.v[j]) {
+                 ++shared;
+                 sharedA = i;
+                 sharedB = j;
+             }
+         }
+     }
+     if (shared >= 2) return false;
+ 
+     Vec3 a[3], b[3];
+     for (int i = 0; i < 3; ++i) {
+         const Vertex& va = vertices[ta.v[i]];
+         const Vertex& vb = vertices[tb.v[i]];
+         a[i] = {va.x, va.y, va.z};
+         b[i] = {vb.x, vb.y, vb.z};
+     }
+     if (shared == 1) {
+         return segmentHitsTriangle(a[(sharedA + 1) % 3], a[(sharedA + 2) % 3], b, eps) ||
+                segmentHitsTriangle(b[(sharedB + 1) % 3], b[(sharedB + 2) % 3], a, eps);
+     }
+ 
+     // Quick reject: b entirely on one side of a's plane
+     const Vec3 n = cross(a[1] - a[0], a[2] - a[0]);
+     const double length = std::sqrt(dot(n, n));
+     if (length > 0.0) {
+         const double d0 = dot(n, b[0] - a[0]) / length;
+         const double d1 = dot(n, b[1] - a[0]) / length;
+         const double d2 = dot(n, b[2] - a[0]) / length;
+         if ((d0 > eps && d1 > eps && d2 > eps) || (d0 < -eps && d1 < -eps && d2 < -eps)) return false;
+     }
+     for (int i = 0; i < 3; ++i) {
+         if (segmentHitsTriangle(a[i], a[(i + 1) % 3], b, eps)) return true;
+         if (segmentHitsTriangle(b[i], b[(i + 1) % 3], a, eps)) return true;
+     }
+     return false;
+ }
+ 
+ /**
+  * @brief Finds intersecting faces with a BVH, one parallel query per triangle.
+  */
+ void findSelfIntersections(const Mesh& mesh, MeshValidator::Report& report) {
+     const TriangleBVH bvh(mesh);
+     const auto& triangles = bvh.triangles();
+     tbb::combinable<std::vector<MeshValidator::FacePair>> found;
+     tbb::parallel_for(tbb::blocked_range<std::size_t>(0, triangles.size()),
+                       [&](const tbb::blocked_range<std::size_t>& range) {
+         std::vector<MeshValidator::FacePair>& local = found.local();
+         for (std::size_t i = range.begin(); i != range.end(); ++i) {
+             const TriangleBVH::Box& box = bvh.bounds(i);
+             bvh.query(box, [&](std::size_t j) {
+                 const TriangleBVH::Triangle& ta = triangles[i];
+                 const TriangleBVH::Triangle& tb = triangles[j];
+                 if (j <= i || ta.face == tb.face) return;
+                 // Tolerance relative to the size of the pair
+                 const TriangleBVH::Box& other = bvh.bounds(j);
+                 double extent = 0.0;
+                 for (int a = 0; a < 3; ++a) {
+                     extent = std::max(extent, std::max(box.max[a], other.max[a]) - std::min(box.min[a], other.min[a]));
+                 }
+                 if (trianglesIntersect(mesh.vertices, ta, tb, 1e-12 * extent)) {
+                     local.push_back({std::min(ta.face, tb.face), std::max(ta.face, tb.face)});
+                 }
+             });
+         }
+     });
+ 
+     found.combine_each([&](const std::vector<MeshValidator::FacePair>& pairs) {
+         report.intersections.insert(report.intersections.end(), pairs.begin(), pairs.end());
+     });
+     std::sort(report.intersections.begin(), report.intersections.end());
+     report.intersections.erase(std::unique(report.intersections.begin(), report.intersections.end()),
+                                report.intersections.end());
+     for (const auto& pair : report.intersections) {
+         report.faceErrors[pair.a] |= MeshValidator::IntersectingFace;
+         report.faceErrors[pair.b] |= MeshValidator::IntersectingFace;
+     }
+ }
+ 
+ } // namespace
+ 
+ std::string MeshValidator::Report::message(std::size_t i) const {
+     if (i < edgeErrors.size()) {
+         const EdgeError& e = edgeErrors[i];
+         return "Edge (" + std::to_string(e.v1) + ", " + std::to_string(e.v2) + ") appears " +
+                std::to_string(e.count) + " times. Expected 2 for a closed surface.";
+     }
+     i -= edgeErrors.size();
+     if (i < nonOrientable.size()) {
+         return "Faces connected to face " + std::to_string(nonOrientable[i]) +
+                " cannot be oriented consistently (non-orientable surface).";
+     }
+     i -= nonOrientable.size();
+     if (i < flippedFaces.size()) {
+         return "Face " + std::to_string(flippedFaces[i]) + " is oriented opposite to its neighbours.";
+     }
+     i -= flippedFaces.size();
+     const FacePair& pair = intersections[i];
+     return "Faces " + std::to_string(pair.a) + " and " + std::to_string(pair.b) + " intersect.";
+ }
+ 
+ /**
+  * @brief Runs the selected validation stages.
+  *
+  * The closed-surface and orientation stages share one edge array: each face
+  * writes its edge keys into its own slice (starting at the face's element
+  * offset, one edge per corner), the array is sorted in parallel, and runs of
+  * equal keys are scanned once. A run whose length is not 2 is a bad edge, and
+  * every face in it is flagged; a run of two faces is an adjacency for
+  * orientation propagation.
+  *
+  * @param mesh The mesh to be validated.
+  * @param stages Stage bits to run.
+  * @return The errors found and per-face error flags.
+  */
+ MeshValidator::Report MeshValidator::check(const Mesh& mesh, unsigned stages) {
+     Report report;
+     const FaceTable& faces = mesh.faces;
+     const std::size_t faceCount = faces.size();
+     const auto& elements = faces.elements();
+     report.faceErrors.assign(faceCount, 0);
+ 
+     if (stages & (ClosedSurface | Orientation)) {
+         std::vector<EdgeKey> edges(elements.size());
+         tbb::parallel_for(std::size_t(0), faceCount, [&](std::size_t f) {
+             const std::size_t begin = faces.offset(f);
+             const std::size_t n = faces.offset(f + 1) - begin;
+             for (std::size_t i = 0; i < n; ++i) {
+                 int v1 = elements[begin + i].vertexIndex;
+                 int v2 = elements[begin + (i + 1) % n].vertexIndex;
+                 edges[begin + i] = EdgeKey{packEdge(v1, v2), static_cast<std::uint32_t>(f),
+                                            static_cast<std::uint8_t>(v1 < v2)};
+             }
+         });
+         tbb::parallel_sort(edges.begin(), edges.end());
+ 
+         std::vector<Adjacency> adjacent;
+         for (std::size_t run = 0; run < edges.size();) {
+             std::size_t end = run + 1;
+             while (end < edges.size() && edges[end].key == edges[run].key) ++end;
+             if (end - run == 2) {
+                 const EdgeKey& a = edges[run];
+                 const EdgeKey& b = edges[run + 1];
+                 if ((stages & Orientation) && a.face != b.face) {
+                     adjacent.push_back(Adjacency{a.face, b.face, static_cast<std::uint8_t>(a.forward == b.forward)});
+                 }
+             } else if (stages & ClosedSurface) {
+                 report.edgeErrors.push_back(EdgeError{unpackVertex(edges[run].key >> 32),
+                                                       unpackVertex(edges[run].key),
+                                                       static_cast<int>(end - run)});
+                 for (std::size_t i = run; i < end; ++i) {
+                     report.faceErrors[edges[i].face] |= OpenEdge;
+                 }
+             }
+             run = end;
+         }
+         if (stages & Orientation) {
+             propagateOrientation(faceCount, adjacent, report);
+         }
+     }
+ 
+     if (stages & SelfIntersection) {
+         findSelfIntersections(mesh, report);
+     }
+ 
+     report.errorFaceCount = static_cast<std::size_t>(
+         std::count_if(report.faceErrors.begin(), report.faceErrors.end(), [](std::uint8_t e) { return e != 0; }));
+     return report;
+ }
  
  /**
   * @brief Validates the given mesh for various conditions and returns a list of error messages.
@@ -14,42 +366,19 @@
   * The validation checks include:
   * - **Closed surfaces**: Ensures every edge is shared by exactly two faces.
   *   - If an edge is not shared by exactly two faces, an error message is generated.
-  * - **Additional validations** (placeholders for future implementation):
-  *   - **Consistent face orientation**: Compute and compare normals.
-  *   - **Self-intersections**: Implement spatial partitioning/intersection tests.
+  * - **Consistent face orientation**: Neighbouring faces must run their shared edge
+  *   in opposite directions.
+  * - **Self-intersections**: No two faces may intersect.
   *
   * @param mesh The mesh to be validated.
   * @return A vector of strings containing error messages, if any.
   */
  std::vector<std::string> MeshValidator::validate(const Mesh& mesh) {
+     Report report = check(mesh);
      std::vector<std::string> errors;
-     
-     // Check for closed surfaces: every edge should be shared by exactly two faces.
-     std::map<std::pair<int, int>, int> edgeCount;
-     for (const auto& face : mesh.faces) {
-         size_t numElements = face.elements.size();
-         for (size_t i = 0; i < numElements; ++i) {
-             int v1 = face.elements[i].vertexIndex;
-             int v2 = face.elements[(i + 1) % numElements].vertexIndex;
-             if (v1 > v2) std::swap(v1, v2);
-             std::pair<int, int> edge(v1, v2);
-             edgeCount[edge]++;
-         }
-     }
-     
-     for (const auto& entry : edgeCount) {
-         if (entry.second != 2) {
-             std::stringstream ss;
-             ss << "Edge (" << entry.first.first << ", " << entry.first.second << ") appears " 
-                << entry.second << " times. Expected 2 for a closed surface.";
-             errors.push_back(ss.str());
-         }
+     errors.reserve(report.errorCount());
+     for (std::size_t i = 0; i < report.errorCount(); ++i) {
+         errors.push_back(report.message(i));
      }
-     
-     // Placeholders for additional validations:
-     // - Consistent face orientation: compute and compare normals.
-     // - Self-intersections: implement spatial partitioning/intersection tests.
-     
      return errors;
  }
- 
\ No newline at end of file
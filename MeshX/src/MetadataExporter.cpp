@@ -4,11 +4,32 @@
  */
 
  #include "MetadataExporter.h"
+ #include <algorithm>
+ #include <cctype>
+ #include <cstdint>
  #include <fstream>
+ #include <vector>
  #include "nlohmann/json.hpp"
  
  using json = nlohmann::json;
  
+ namespace {
+ 
+ bool hasExtension(const std::string& path, const std::string& ext) {
+     if (path.size() < ext.size()) return false;
+     return std::equal(ext.rbegin(), ext.rend(), path.rbegin(), [](char a, char b) {
+         return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b));
+     });
+ }
+ 
+ } // namespace
+ 
+ MetadataExporter::Format MetadataExporter::formatOf(const std::string& filePath) {
+     if (hasExtension(filePath, ".cbor")) return Format::Cbor;
+     if (hasExtension(filePath, ".msgpack") || hasExtension(filePath, ".mpk")) return Format::MessagePack;
+     return Format::Json;
+ }
+ 
  /**
   * @brief Exports mesh metadata to a JSON file.
   *
@@ -19,12 +40,31 @@
   * @return True if the metadata is successfully written, false otherwise.
   */
  bool MetadataExporter::exportMetadata(const std::string& filePath, const MeshMetadata& metadata) {
-     std::ofstream file(filePath);
+     return exportMetadata(filePath, metadata, MetadataEncoding());
+ }
+ 
+ /**
+  * @brief Exports mesh metadata in the format given by the file extension.
+  *
+  * @param filePath The path of the file where metadata should be exported.
+  * @param metadata The MeshMetadata object containing metadata information.
+  * @param encoding The compact layouts to use.
+  * @return True if the metadata is successfully written, false otherwise.
+  */
+ bool MetadataExporter::exportMetadata(const std::string& filePath, const MeshMetadata& metadata,
+                                       const MetadataEncoding& encoding) {
+     const Format format = formatOf(filePath);
+     std::ofstream file(filePath, format == Format::Json ? std::ios::out : std::ios::out | std::ios::binary);
      if (!file.is_open()) {
          return false;
      }
-     json j = metadata.toJson();
-     file << j.dump(4); // Pretty print with 4-space indentation
+     json j = metadata.toJson(encoding);
+     if (format == Format::Json) {
+         file << j.dump(4); // Pretty print with 4-space indentation
+     } else {
+         const std::vector<std::uint8_t> bytes = format == Format::Cbor ? json::to_cbor(j) : json::to_msgpack(j);
+         file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+     }
      file.close();
-     return true;
- }
\ No newline at end of file
+     return static_cast<bool>(file);
+ }
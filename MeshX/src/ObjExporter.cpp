@@ -4,75 +4,82 @@
  */
 
  #include "ObjExporter.h"
- #include <fstream>
- #include <iostream>
+ #include "TextFileWriter.h"
  
  /**
   * @brief Exports the given mesh to an OBJ file at the specified file path.
   * 
   * This function writes the vertices, texture coordinates, normals, and faces of the mesh
   * to an OBJ file. The OBJ file format is a simple data format that represents 3D geometry.
+  * Each section is formatted in parallel chunks by TextFileWriter. OBJ has no
+  * volume elements, so tetrahedrons are not written (see VolumeMeshWriter).
   * 
   * @param mesh The mesh to be exported.
   * @param filePath The path to the file where the mesh will be exported.
   * @return true if the mesh was successfully exported, false otherwise.
   */
  bool ObjExporter::exportMesh(const Mesh& mesh, const std::string& filePath) {
-     std::ofstream file(filePath);
-     if (!file.is_open()) {
+     TextFileWriter file(filePath);
+     if (!file.isOpen()) {
          return false;
      }
      
      // Write vertices.
-     for (const auto& vertex : mesh.vertices) {
-         file << "v " << vertex.x << " " << vertex.y << " " << vertex.z << "\n";
-     }
+     file.writeRecords(mesh.vertices.size(), [&](std::string& out, std::size_t i) {
+         const Vertex& vertex = mesh.vertices[i];
+         out += "v ";
+         TextFileWriter::appendNumber(out, vertex.x);
+         out += ' ';
+         TextFileWriter::appendNumber(out, vertex.y);
+         out += ' ';
+         TextFileWriter::appendNumber(out, vertex.z);
+         out += '\n';
+     });
      
      // Write texture coordinates, if available.
-     for (const auto& tex : mesh.texCoords) {
-         file << "vt " << tex[0] << " " << tex[1] << "\n";
-     }
+     file.writeRecords(mesh.texCoords.size(), [&](std::string& out, std::size_t i) {
+         out += "vt ";
+         TextFileWriter::appendNumber(out, mesh.texCoords[i][0]);
+         out += ' ';
+         TextFileWriter::appendNumber(out, mesh.texCoords[i][1]);
+         out += '\n';
+     });
      
      // Write normals, if available.
-     for (const auto& normal : mesh.normals) {
-         file << "vn " << normal.x << " " << normal.y << " " << normal.z << "\n";
-     }
+     file.writeRecords(mesh.normals.size(), [&](std::string& out, std::size_t i) {
+         const auto& normal = mesh.normals[i];
+         out += "vn ";
+         TextFileWriter::appendNumber(out, normal.x);
+         out += ' ';
+         TextFileWriter::appendNumber(out, normal.y);
+         out += ' ';
+         TextFileWriter::appendNumber(out, normal.z);
+         out += '\n';
+     });
      
      // Write faces.
-     for (const auto& face : mesh.faces) {
-         file << "f";
-         for (const auto& fe : face.elements) {
-             file << " " << (fe.vertexIndex + 1);
+     const auto& elements = mesh.faces.elements();
+     file.writeRecords(mesh.faces.size(), [&](std::string& out, std::size_t f) {
+         out += 'f';
+         const std::size_t end = mesh.faces.offset(f + 1);
+         for (std::size_t i = mesh.faces.offset(f); i < end; ++i) {
+             const FaceElement& fe = elements[i];
+             out += ' ';
+             TextFileWriter::appendNumber(out, fe.vertexIndex + 1);
              // Write texture and normal indices if available.
              if (fe.texCoordIndex != -1 || fe.normalIndex != -1) {
-                 file << "/";
+                 out += '/';
                  if (fe.texCoordIndex != -1) {
-                     file << (fe.texCoordIndex + 1);
+                     TextFileWriter::appendNumber(out, fe.texCoordIndex + 1);
                  }
                  if (fe.normalIndex != -1) {
-                     file << "/" << (fe.normalIndex + 1);
+                     out += '/';
+                     TextFileWriter::appendNumber(out, fe.normalIndex + 1);
                  }
              }
          }
-         file << "\n";
-     }
+         out += '\n';
+     });
  
-     // Write tetrahedrons as triangular faces. Only for volume meshes.
-     for (const auto& tet : mesh.tetrahedrons) {
-         
-         int v0 = std::get<0>(tet) + 1;
-         int v1 = std::get<1>(tet) + 1;
-         int v2 = std::get<2>(tet) + 1;
-         int v3 = std::get<3>(tet) + 1;
- 
-         // Each tetrahedron is represented by 4 triangular faces.
-         file << "f " << v0 << " " << v1 << " " << v2 << "\n";
-         file << "f " << v0 << " " << v1 << " " << v3 << "\n";
-         file << "f " << v0 << " " << v2 << " " << v3 << "\n";
-         file << "f " << v1 << " " << v2 << " " << v3 << "\n";
-     }
-     
-     file.close();
-     return true;
+     return file.close();
  }
- 
\ No newline at end of file
@@ -4,13 +4,38 @@
  */
 
  #include "ObjParser.h"
+ #include "MappedFile.h"
+ #include "MeshBin.h"
  #include <fstream>
  #include <sstream>
  #include <iostream>
  #include <stdexcept>
  #include <algorithm>
+ #include <cctype>
+ #include <charconv>
+ #include <cstring>
+ #include <functional>
  #include <set>
- 
+ #include <thread>
+
+ namespace {
+
+ /**
+  * @brief Converts an OBJ index to a 0-based index.
+  *
+  * Positive indices are 1-based, negative ones count back from the end of the
+  * elements defined so far (-1 is the last). 0 is invalid and gives -1.
+  *
+  * @param raw The index as written in the file.
+  * @param count Number of elements of that kind defined before the line.
+  * @return The 0-based index (negative if it does not refer to an element).
+  */
+ int resolveIndex(int raw, std::size_t count) {
+     if (raw > 0) return raw - 1;
+     if (raw < 0) return static_cast<int>(count) + raw;
+     return -1;
+ }
+
  /**
   * @brief Helper function to parse a face element.
   *
@@ -18,45 +43,43 @@
   * and returns a FaceElement object.
   *
   * @param token The face element token to be parsed.
+  * @param mesh The mesh parsed so far, for relative indices.
   * @return A FaceElement object representing the parsed face element.
   */
- static FaceElement parseFaceElement(const std::string& token) {
+ FaceElement parseFaceElement(const std::string& token, const Mesh& mesh) {
      int v = -1, vt = -1, vn = -1;
      std::stringstream ss(token);
      std::string part;
-     
+
      if (std::getline(ss, part, '/')) {
-         v = std::stoi(part) - 1; // OBJ indices are 1-based.
+         v = resolveIndex(std::stoi(part), mesh.vertices.size());
      }
      if (std::getline(ss, part, '/')) {
          if (!part.empty()) {
-             vt = std::stoi(part) - 1;
+             vt = resolveIndex(std::stoi(part), mesh.texCoords.size());
          }
      }
      if (std::getline(ss, part, '/')) {
          if (!part.empty()) {
-             vn = std::stoi(part) - 1;
+             vn = resolveIndex(std::stoi(part), mesh.normals.size());
          }
      }
      return FaceElement(v, vt, vn);
  }
- 
+
  /**
-  * @brief Parses an OBJ file and returns a surface Mesh.
-  *
-  * This method takes the file path of an OBJ file as input,
-  * parses the file, and returns a Mesh object representing the surface of the 3D model.
-  *
-  * @param filePath The path to the OBJ file to be parsed.
-  * @return A Mesh object representing the parsed surface of the 3D model.
+  * @brief Line-by-line parser (Mode::Streaming).
+  * @param filePath The OBJ file.
+  * @param lenient Set if malformed input was skipped.
+  * @return The parsed mesh.
   */
- Mesh ObjParser::parseSurfaceMesh(const std::string& filePath) {
-     Mesh mesh;
+ Mesh parseStreaming(const std::string& filePath, bool& lenient) {
      std::ifstream file(filePath);
      if (!file.is_open()) {
          throw std::runtime_error("Failed to open file: " + filePath);
      }
-     
+     Mesh mesh;
+
      std::string line;
      int lineNumber = 0;
      while (std::getline(file, line)) {
@@ -64,13 +87,14 @@
          std::istringstream iss(line);
          std::string token;
          if (!(iss >> token)) continue; // Skip empty lines.
-         
+
          if (token[0] == '#') continue; // Comment line.
-         
+
          if (token == "v") {
              Vertex vertex;
              if (!(iss >> vertex.x >> vertex.y >> vertex.z)) {
                  std::cerr << "Error parsing vertex at line " << lineNumber << "\n";
+                 lenient = true;
                  continue;
              }
              mesh.vertices.push_back(vertex);
@@ -78,6 +102,7 @@
              std::array<double, 2> tex;
              if (!(iss >> tex[0] >> tex[1])) {
                  std::cerr << "Error parsing texture coordinate at line " << lineNumber << "\n";
+                 lenient = true;
                  continue;
              }
              mesh.texCoords.push_back(tex);
@@ -85,6 +110,7 @@
              Vertex normal;
              if (!(iss >> normal.x >> normal.y >> normal.z)) {
                  std::cerr << "Error parsing normal at line " << lineNumber << "\n";
+                 lenient = true;
                  continue;
              }
              mesh.normals.push_back(normal);
@@ -93,9 +119,11 @@
              std::string faceToken;
              while (iss >> faceToken) {
                  try {
-                     face.elements.push_back(parseFaceElement(faceToken));
+                     face.elements.push_back(parseFaceElement(faceToken, mesh));
+                     if (face.elements.back().vertexIndex < 0) lenient = true;
                  } catch (const std::exception& e) {
                      std::cerr << "Error parsing face at line " << lineNumber << ": " << e.what() << "\n";
+                     lenient = true;
                  }
              }
              mesh.faces.push_back(face);
@@ -103,8 +131,280 @@
      }
      return mesh;
  }
- 
- 
+
+ const std::size_t kMinChunkBytes = 1 << 20; ///< Smaller files are not split further.
+
+ /**
+  * @brief Output of one chunk of the Parallel mode.
+  *
+  * Relative indices are resolved against the chunk's own counts and listed
+  * in `relative`, so the merge can add the counts of the earlier chunks.
+  */
+ struct ObjChunk {
+     /**
+      * @brief A face element index that still needs the earlier chunks' count.
+      */
+     struct RelativeIndex {
+         std::size_t element; ///< Position in faces.elements()
+         int kind;            ///< 0 vertex, 1 texture coordinate, 2 normal
+     };
+     /**
+      * @brief A skipped line, reported after the merge with its file line number.
+      */
+     struct ParseError {
+         std::size_t line; ///< 1-based, within the chunk
+         const char* what;
+     };
+
+     std::vector<Vertex> vertices;
+     std::vector<Vertex> normals;
+     std::vector<std::array<double, 2>> texCoords;
+     FaceTable faces;
+     std::vector<RelativeIndex> relative;
+     std::vector<FaceElement> corners; ///< Elements of the face being read
+     std::vector<ParseError> errors;
+     std::size_t lines = 0; ///< Newlines in the chunk
+     bool lenient = false;
+ };
+
+ /**
+  * @brief Whitespace as skipped by operator>> (a line never holds '\\n').
+  */
+ inline bool isBlank(char c) {
+     return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+ }
+
+ /**
+  * @brief Reads the next double of a line, as `istream >> double` would.
+  * @return False (p unchanged) if there is no number.
+  */
+ bool readDouble(const char*& p, const char* end, double& value) {
+     const char* q = p;
+     while (q < end && isBlank(*q)) ++q;
+     if (q < end && *q == '+') ++q; // from_chars takes no '+'
+     // Neither does operator>> read "inf"/"nan" nor a second sign
+     if (q == end || !(std::isdigit(static_cast<unsigned char>(*q)) || *q == '.' || *q == '-')) return false;
+     if (*q == '-' && (q + 1 == end || !(std::isdigit(static_cast<unsigned char>(q[1])) || q[1] == '.'))) return false;
+     auto result = std::from_chars(q, end, value);
+     if (result.ec != std::errc()) return false;
+     p = result.ptr;
+     return true;
+ }
+
+ /**
+  * @brief Reads one '/'-separated part of a face token, as std::stoi would.
+  * @return False if the part does not start with an integer.
+  */
+ bool readIndex(const char* p, const char* end, int& value) {
+     if (p < end && *p == '+' && p + 1 < end && p[1] != '-') ++p;
+     auto result = std::from_chars(p, end, value);
+     return result.ec == std::errc();
+ }
+
+ /**
+  * @brief Parses one line into a chunk.
+  */
+ void parseLine(const char* p, const char* end, std::size_t lineNumber, ObjChunk& out) {
+     while (p < end && isBlank(*p)) ++p;
+     const char* token = p;
+     while (p < end && !isBlank(*p)) ++p;
+     const std::size_t length = static_cast<std::size_t>(p - token);
+     if (length == 0 || token[0] == '#') return;
+
+     if (length == 1 && token[0] == 'v') {
+         Vertex vertex;
+         if (!readDouble(p, end, vertex.x) || !readDouble(p, end, vertex.y) || !readDouble(p, end, vertex.z)) {
+             out.errors.push_back({ lineNumber, "vertex" });
+             out.lenient = true;
+             return;
+         }
+         out.vertices.push_back(vertex);
+     } else if (length == 2 && token[0] == 'v' && token[1] == 't') {
+         std::array<double, 2> tex;
+         if (!readDouble(p, end, tex[0]) || !readDouble(p, end, tex[1])) {
+             out.errors.push_back({ lineNumber, "texture coordinate" });
+             out.lenient = true;
+             return;
+         }
+         out.texCoords.push_back(tex);
+     } else if (length == 2 && token[0] == 'v' && token[1] == 'n') {
+         Vertex normal;
+         if (!readDouble(p, end, normal.x) || !readDouble(p, end, normal.y) || !readDouble(p, end, normal.z)) {
+             out.errors.push_back({ lineNumber, "normal" });
+             out.lenient = true;
+             return;
+         }
+         out.normals.push_back(normal);
+     } else if (length == 1 && token[0] == 'f') {
+         out.corners.clear();
+         const std::size_t counts[3] = { out.vertices.size(), out.texCoords.size(), out.normals.size() };
+         for (;;) {
+             while (p < end && isBlank(*p)) ++p;
+             if (p == end) break;
+             const char* tokenEnd = p;
+             while (tokenEnd < end && !isBlank(*tokenEnd)) ++tokenEnd;
+
+             // Up to three parts; a missing or empty vt/vn part stays -1
+             int indices[3] = { -1, -1, -1 };
+             bool relative[3] = { false, false, false };
+             bool ok = true;
+             const char* part = p;
+             for (int k = 0; k < 3 && ok; ++k) {
+                 const char* slash = std::find(part, tokenEnd, '/');
+                 if (k == 0 || slash > part) {
+                     int raw;
+                     ok = readIndex(part, slash, raw);
+                     if (ok) {
+                         indices[k] = resolveIndex(raw, counts[k]);
+                         relative[k] = raw < 0;
+                     }
+                 }
+                 if (slash == tokenEnd) break;
+                 part = slash + 1;
+             }
+             p = tokenEnd;
+             if (!ok) {
+                 out.errors.push_back({ lineNumber, "face" });
+                 out.lenient = true;
+                 continue;
+             }
+             for (int k = 0; k < 3; ++k) {
+                 if (relative[k]) out.relative.push_back({ out.faces.elements().size() + out.corners.size(), k });
+             }
+             if (!relative[0] && indices[0] < 0) out.lenient = true;
+             out.corners.emplace_back(indices[0], indices[1], indices[2]);
+         }
+         out.faces.addFace(out.corners.data(), out.corners.size());
+     }
+ }
+
+ /**
+  * @brief Parses the lines of [begin, end), which starts at a line start.
+  */
+ void parseChunk(const char* begin, const char* end, ObjChunk& out) {
+     const char* line = begin;
+     while (line < end) {
+         const char* newline = static_cast<const char*>(std::memchr(line, '\n', static_cast<std::size_t>(end - line)));
+         const char* lineEnd = newline ? newline : end;
+         parseLine(line, lineEnd, out.lines + 1, out);
+         if (!newline) break;
+         ++out.lines;
+         line = newline + 1;
+     }
+ }
+
+ /**
+  * @brief Memory-mapped, chunked parser (Mode::Parallel).
+  * @param filePath The OBJ file.
+  * @param threads Thread count, 0 = all hardware threads.
+  * @param lenient Set if malformed input was skipped.
+  * @return The parsed mesh.
+  */
+ Mesh parseParallel(const std::string& filePath, unsigned threads, bool& lenient) {
+     MappedFile file(filePath);
+     if (!file.isOpen()) {
+         throw std::runtime_error("Failed to open file: " + filePath);
+     }
+     const char* data = file.data();
+     const std::size_t size = file.size();
+
+     if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+     std::size_t chunkCount = std::max<std::size_t>(1, std::min<std::size_t>(threads, size / kMinChunkBytes));
+
+     // Chunk boundaries just after a newline
+     std::vector<const char*> bounds(1, data);
+     for (std::size_t c = 1; c < chunkCount; ++c) {
+         const char* target = data + size * c / chunkCount;
+         if (target < bounds.back()) target = bounds.back();
+         const char* newline = static_cast<const char*>(std::memchr(target, '\n', static_cast<std::size_t>(data + size - target)));
+         if (!newline) break;
+         bounds.push_back(newline + 1);
+     }
+     bounds.push_back(data + size);
+     chunkCount = bounds.size() - 1;
+
+     std::vector<ObjChunk> chunks(chunkCount);
+     std::vector<std::thread> workers;
+     for (std::size_t c = 1; c < chunkCount; ++c) {
+         workers.emplace_back(parseChunk, bounds[c], bounds[c + 1], std::ref(chunks[c]));
+     }
+     if (chunkCount > 0) parseChunk(bounds[0], bounds[1], chunks[0]);
+     for (auto& t : workers) t.join();
+
+     // Concatenate in file order; relative indices get the earlier chunks' counts
+     Mesh mesh;
+     std::size_t vertexCount = 0, texCoordCount = 0, normalCount = 0, faceCount = 0, elementCount = 0;
+     for (const auto& chunk : chunks) {
+         vertexCount += chunk.vertices.size();
+         texCoordCount += chunk.texCoords.size();
+         normalCount += chunk.normals.size();
+         faceCount += chunk.faces.size();
+         elementCount += chunk.faces.elements().size();
+     }
+     mesh.vertices.reserve(vertexCount);
+     mesh.texCoords.reserve(texCoordCount);
+     mesh.normals.reserve(normalCount);
+     mesh.faces.reserve(faceCount, elementCount);
+
+     std::size_t lineBase = 0;
+     for (auto& chunk : chunks) {
+         const int base[3] = { static_cast<int>(mesh.vertices.size()), static_cast<int>(mesh.texCoords.size()),
+                               static_cast<int>(mesh.normals.size()) };
+         for (const auto& r : chunk.relative) {
+             FaceElement& e = chunk.faces.elements()[r.element];
+             int& index = r.kind == 0 ? e.vertexIndex : (r.kind == 1 ? e.texCoordIndex : e.normalIndex);
+             index += base[r.kind];
+             if (r.kind == 0 && index < 0) chunk.lenient = true;
+         }
+         for (const auto& error : chunk.errors) {
+             std::cerr << "Error parsing " << error.what << " at line " << lineBase + error.line;
+             std::cerr << (std::strcmp(error.what, "face") == 0 ? ": invalid index\n" : "\n");
+         }
+         mesh.vertices.insert(mesh.vertices.end(), chunk.vertices.begin(), chunk.vertices.end());
+         mesh.texCoords.insert(mesh.texCoords.end(), chunk.texCoords.begin(), chunk.texCoords.end());
+         mesh.normals.insert(mesh.normals.end(), chunk.normals.begin(), chunk.normals.end());
+         mesh.faces.append(chunk.faces);
+         lineBase += chunk.lines;
+         lenient = lenient || chunk.lenient;
+         chunk = ObjChunk(); // Release the chunk's buffers early
+     }
+     return mesh;
+ }
+
+ } // namespace
+
+ /**
+  * @brief Parses an OBJ file and returns a surface Mesh.
+  *
+  * This method takes the file path of an OBJ file as input,
+  * parses the file, and returns a Mesh object representing the surface of the 3D model.
+  * If a "<file>.meshbin" sidecar built from the same file exists it is loaded
+  * instead; otherwise the sidecar is (re)written after parsing.
+  *
+  * @param filePath The path to the OBJ file to be parsed.
+  * @return A Mesh object representing the parsed surface of the 3D model.
+  */
+ Mesh ObjParser::parseSurfaceMesh(const std::string& filePath) {
+     Mesh mesh;
+     MeshBin::SourceStamp stamp;
+     bool cacheable = MeshBin::stampOf(filePath, stamp);
+     if (cacheable && MeshBin::read(MeshBin::sidecarPath(filePath), stamp, mesh)) {
+         return mesh;
+     }
+
+     bool lenient = false; // Set when malformed input is skipped
+     if (mode_ == Mode::Streaming) {
+         mesh = parseStreaming(filePath, lenient);
+     } else {
+         mesh = parseParallel(filePath, threads_, lenient);
+     }
+     if (cacheable) {
+         MeshBin::write(MeshBin::sidecarPath(filePath), mesh, stamp, lenient); // Best effort
+     }
+     return mesh;
+ }
+
+
  /**
   * @brief Parses an OBJ file and returns a Mesh with both surface and volume data.
   *
@@ -0,0 +1,36 @@
+/**
+ * @file TextFileWriter.cpp
+ * @brief Implementation of TextFileWriter.
+ */
+
+ #include "TextFileWriter.h"
+ #include <charconv>
+
+ TextFileWriter::TextFileWriter(const std::string& path)
+     : out_(path, std::ios::binary) {}
+
+ bool TextFileWriter::close() {
+     if (!out_.is_open()) return false;
+     out_.flush();
+     const bool ok = static_cast<bool>(out_);
+     out_.close();
+     return ok;
+ }
+
+ void TextFileWriter::appendNumber(std::string& out, double value) {
+     char text[32];
+     const auto result = std::to_chars(text, text + sizeof(text), value, std::chars_format::general, 6);
+     out.append(text, result.ptr);
+ }
+
+ void TextFileWriter::appendExact(std::string& out, double value) {
+     char text[32];
+     const auto result = std::to_chars(text, text + sizeof(text), value);
+     out.append(text, result.ptr);
+ }
+
+ void TextFileWriter::appendNumber(std::string& out, long long value) {
+     char text[24];
+     const auto result = std::to_chars(text, text + sizeof(text), value);
+     out.append(text, result.ptr);
+ }
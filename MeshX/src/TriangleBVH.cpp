@@ -0,0 +1,131 @@
+/**
+ * @file TriangleBVH.cpp
+ * @brief Implementation of TriangleBVH.
+ */
+
+ #include "TriangleBVH.h"
+ #include <tbb/parallel_for.h>
+ #include <tbb/parallel_invoke.h>
+ #include <tbb/parallel_sort.h>
+ #include <algorithm>
+ #include <limits>
+
+ namespace {
+
+ /** Ranges at least this large build their two halves in parallel */
+ const std::uint32_t kParallelBuildSize = 8192;
+
+ void grow(TriangleBVH::Box& box, const TriangleBVH::Box& other) {
+     for (int a = 0; a < 3; ++a) {
+         box.min[a] = std::min(box.min[a], other.min[a]);
+         box.max[a] = std::max(box.max[a], other.max[a]);
+     }
+ }
+
+ TriangleBVH::Box emptyBox() {
+     const double inf = std::numeric_limits<double>::infinity();
+     return TriangleBVH::Box{{inf, inf, inf}, {-inf, -inf, -inf}};
+ }
+
+ /** @brief Spreads the low 10 bits of x to every third bit. */
+ std::uint32_t spreadBits(std::uint32_t x) {
+     x = (x | (x << 16)) & 0x030000ffu;
+     x = (x | (x << 8)) & 0x0300f00fu;
+     x = (x | (x << 4)) & 0x030c30c3u;
+     x = (x | (x << 2)) & 0x09249249u;
+     return x;
+ }
+
+ } // namespace
+
+ TriangleBVH::TriangleBVH(const Mesh& mesh) {
+     const FaceTable& faces = mesh.faces;
+     const auto& elements = faces.elements();
+     const int vertexCount = static_cast<int>(mesh.vertices.size());
+     auto valid = [vertexCount](int v) { return v >= 0 && v < vertexCount; };
+
+     // Fan-triangulate the faces
+     triangles_.reserve(elements.size() >= 2 * faces.size() ? elements.size() - 2 * faces.size() : 0);
+     for (std::size_t f = 0; f < faces.size(); ++f) {
+         const std::size_t begin = faces.offset(f);
+         const std::size_t n = faces.faceSize(f);
+         for (std::size_t i = 1; i + 1 < n; ++i) {
+             Triangle t{{elements[begin].vertexIndex, elements[begin + i].vertexIndex,
+                         elements[begin + i + 1].vertexIndex},
+                        static_cast<std::uint32_t>(f)};
+             if (valid(t.v[0]) && valid(t.v[1]) && valid(t.v[2])) triangles_.push_back(t);
+         }
+     }
+     const std::size_t n = triangles_.size();
+     if (n == 0) return;
+
+     boxes_.resize(n);
+     tbb::parallel_for(std::size_t(0), n, [&](std::size_t i) {
+         Box box = emptyBox();
+         for (int c = 0; c < 3; ++c) {
+             const Vertex& p = mesh.vertices[triangles_[i].v[c]];
+             const double xyz[3] = {p.x, p.y, p.z};
+             grow(box, Box{{xyz[0], xyz[1], xyz[2]}, {xyz[0], xyz[1], xyz[2]}});
+         }
+         boxes_[i] = box;
+     });
+
+     // Morton order of the box centres; the index in the low bits keeps the sort deterministic
+     Box centres = emptyBox();
+     for (const Box& box : boxes_) {
+         for (int a = 0; a < 3; ++a) {
+             const double c = 0.5 * (box.min[a] + box.max[a]);
+             centres.min[a] = std::min(centres.min[a], c);
+             centres.max[a] = std::max(centres.max[a], c);
+         }
+     }
+     std::vector<std::uint64_t> keys(n);
+     tbb::parallel_for(std::size_t(0), n, [&](std::size_t i) {
+         std::uint32_t code = 0;
+         for (int a = 0; a < 3; ++a) {
+             const double extent = centres.max[a] - centres.min[a];
+             const double c = 0.5 * (boxes_[i].min[a] + boxes_[i].max[a]);
+             const double t = extent > 0.0 ? (c - centres.min[a]) / extent : 0.0;
+             code |= spreadBits(static_cast<std::uint32_t>(std::min(1023.0, std::max(0.0, t * 1023.0)))) << a;
+         }
+         keys[i] = (static_cast<std::uint64_t>(code) << 32) | i;
+     });
+     tbb::parallel_sort(keys.begin(), keys.end());
+
+     std::vector<Triangle> sortedTriangles(n);
+     std::vector<Box> sortedBoxes(n);
+     tbb::parallel_for(std::size_t(0), n, [&](std::size_t i) {
+         const std::size_t from = static_cast<std::uint32_t>(keys[i]);
+         sortedTriangles[i] = triangles_[from];
+         sortedBoxes[i] = boxes_[from];
+     });
+     triangles_.swap(sortedTriangles);
+     boxes_.swap(sortedBoxes);
+
+     // Every leaf but a lone one holds at least two triangles, so n nodes always suffice
+     nodes_.resize(n);
+     nodeCount_ = 1;
+     build(0, 0, static_cast<std::uint32_t>(n));
+     nodes_.resize(nodeCount_);
+ }
+
+ void TriangleBVH::build(std::uint32_t node, std::uint32_t first, std::uint32_t count) {
+     if (count <= kLeafSize) {
+         Box box = emptyBox();
+         for (std::uint32_t i = first; i < first + count; ++i) grow(box, boxes_[i]);
+         nodes_[node] = Node{box, first, count};
+         return;
+     }
+     const std::uint32_t children = nodeCount_.fetch_add(2);
+     const std::uint32_t half = count / 2;
+     if (count >= kParallelBuildSize) {
+         tbb::parallel_invoke([&] { build(children, first, half); },
+                              [&] { build(children + 1, first + half, count - half); });
+     } else {
+         build(children, first, half);
+         build(children + 1, first + half, count - half);
+     }
+     Box box = nodes_[children].box;
+     grow(box, nodes_[children + 1].box);
+     nodes_[node] = Node{box, children, 0};
+ }
@@ -0,0 +1,194 @@
+/**
+ * @file VolumeMeshWriter.cpp
+ * @brief Implementation of VolumeMeshWriter.
+ */
+
+ #include "VolumeMeshWriter.h"
+ #include "TextFileWriter.h"
+ #include <algorithm>
+ #include <cctype>
+ #include <cstdint>
+ #include <cstring>
+ #include <fstream>
+ #include <iostream>
+ #include <sstream>
+ #include <vector>
+
+ static_assert(sizeof(Vertex) == 3 * sizeof(double), "Vertex must be three packed doubles");
+ static_assert(sizeof(Mesh::Tetrahedron) == 4 * sizeof(int), "Tetrahedron must be four packed ints");
+
+ namespace {
+
+ const std::size_t kChunk = 1 << 16; ///< Generated values per write
+ const std::uint8_t kVtkTetra = 10;
+
+ bool hasExtension(const std::string& path, const std::string& ext) {
+     if (path.size() < ext.size()) return false;
+     return std::equal(ext.rbegin(), ext.rend(), path.rbegin(), [](char a, char b) {
+         return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b));
+     });
+ }
+
+ /** @brief Writes one appended VTU block: its byte count, then the bytes. */
+ void writeBlock(std::ofstream& out, const void* data, std::uint64_t bytes) {
+     out.write(reinterpret_cast<const char*>(&bytes), sizeof(bytes));
+     if (bytes) out.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+ }
+
+ /** @brief Writes an appended VTU block of count values value(i), generated in chunks. */
+ template <class T, class Value>
+ void writeGeneratedBlock(std::ofstream& out, std::size_t count, Value value) {
+     const std::uint64_t bytes = count * sizeof(T);
+     out.write(reinterpret_cast<const char*>(&bytes), sizeof(bytes));
+     std::vector<T> chunk;
+     chunk.reserve(std::min(count, kChunk));
+     for (std::size_t first = 0; first < count; first += kChunk) {
+         chunk.clear();
+         const std::size_t end = std::min(count, first + kChunk);
+         for (std::size_t i = first; i < end; ++i) chunk.push_back(value(i));
+         out.write(reinterpret_cast<const char*>(chunk.data()), static_cast<std::streamsize>(chunk.size() * sizeof(T)));
+     }
+ }
+
+ bool hostLittleEndian() {
+     const std::uint16_t probe = 1;
+     unsigned char first;
+     std::memcpy(&first, &probe, 1);
+     return first == 1;
+ }
+
+ } // namespace
+
+ bool VolumeMeshWriter::isVolumeFormat(const std::string& path) {
+     return hasExtension(path, ".mesh") || hasExtension(path, ".vtu");
+ }
+
+ bool VolumeMeshWriter::write(const std::string& path, const Mesh& mesh) {
+     return hasExtension(path, ".vtu") ? writeVtu(path, mesh) : writeMedit(path, mesh);
+ }
+
+ bool VolumeMeshWriter::writeMedit(const std::string& path, const Mesh& mesh) {
+     TextFileWriter out(path);
+     if (!out.isOpen()) {
+         std::cerr << "Error: Cannot write MEDIT file: " << path << std::endl;
+         return false;
+     }
+     auto section = [&](const char* name, std::size_t count) {
+         std::string text = name;
+         text += '\n';
+         TextFileWriter::appendNumber(text, static_cast<long long>(count));
+         text += '\n';
+         out.write(text);
+     };
+
+     out.write("MeshVersionFormatted 1\nDimension 3\n");
+     section("Vertices", mesh.vertices.size());
+     out.writeRecords(mesh.vertices.size(), [&](std::string& text, std::size_t i) {
+         const Vertex& v = mesh.vertices[i];
+         TextFileWriter::appendExact(text, v.x);
+         text += ' ';
+         TextFileWriter::appendExact(text, v.y);
+         text += ' ';
+         TextFileWriter::appendExact(text, v.z);
+         text += " 0\n";
+     });
+
+     // Only triangles have a MEDIT section of their own
+     std::vector<std::uint32_t> triangles;
+     for (std::size_t f = 0; f < mesh.faces.size(); ++f) {
+         if (mesh.faces.faceSize(f) == 3) triangles.push_back(static_cast<std::uint32_t>(f));
+     }
+     if (!triangles.empty()) {
+         const auto& elements = mesh.faces.elements();
+         section("Triangles", triangles.size());
+         out.writeRecords(triangles.size(), [&](std::string& text, std::size_t t) {
+             const std::size_t first = mesh.faces.offset(triangles[t]);
+             for (std::size_t i = first; i < first + 3; ++i) {
+                 TextFileWriter::appendNumber(text, elements[i].vertexIndex + 1);
+                 text += ' ';
+             }
+             text += "1\n";
+         });
+     }
+
+     const bool domains = mesh.tetrahedronDomains.size() == mesh.tetrahedrons.size();
+     section("Tetrahedra", mesh.tetrahedrons.size());
+     out.writeRecords(mesh.tetrahedrons.size(), [&](std::string& text, std::size_t t) {
+         for (int v : mesh.tetrahedrons[t]) {
+             TextFileWriter::appendNumber(text, v + 1);
+             text += ' ';
+         }
+         TextFileWriter::appendNumber(text, domains ? mesh.tetrahedronDomains[t] : 1);
+         text += '\n';
+     });
+     out.write("End\n");
+
+     if (!out.close()) {
+         std::cerr << "Error: Cannot write MEDIT file: " << path << std::endl;
+         return false;
+     }
+     return true;
+ }
+
+ bool VolumeMeshWriter::writeVtu(const std::string& path, const Mesh& mesh) {
+     std::ofstream out(path, std::ios::binary);
+     if (!out.is_open()) {
+         std::cerr << "Error: Cannot write VTU file: " << path << std::endl;
+         return false;
+     }
+     const std::size_t points = mesh.vertices.size();
+     const std::size_t cells = mesh.tetrahedrons.size();
+     const bool domains = mesh.tetrahedronDomains.size() == cells;
+
+     // Offsets of the appended blocks, each led by a UInt64 byte count
+     const std::uint64_t pointBytes = points * sizeof(Vertex);
+     const std::uint64_t connectivityBytes = cells * sizeof(Mesh::Tetrahedron);
+     const std::uint64_t offsetBytes = cells * sizeof(std::int64_t);
+     const std::uint64_t typeBytes = cells * sizeof(std::uint8_t);
+     std::uint64_t offsets[5];
+     offsets[0] = 0;
+     offsets[1] = offsets[0] + 8 + pointBytes;
+     offsets[2] = offsets[1] + 8 + connectivityBytes;
+     offsets[3] = offsets[2] + 8 + offsetBytes;
+     offsets[4] = offsets[3] + 8 + typeBytes;
+
+     std::ostringstream xml;
+     xml << "<?xml version=\"1.0\"?>\n"
+         << "<VTKFile type=\"UnstructuredGrid\" version=\"1.0\" byte_order=\""
+         << (hostLittleEndian() ? "LittleEndian" : "BigEndian") << "\" header_type=\"UInt64\">\n"
+         << "  <UnstructuredGrid>\n"
+         << "    <Piece NumberOfPoints=\"" << points << "\" NumberOfCells=\"" << cells << "\">\n"
+         << "      <Points>\n"
+         << "        <DataArray type=\"Float64\" NumberOfComponents=\"3\" format=\"appended\" offset=\"" << offsets[0] << "\"/>\n"
+         << "      </Points>\n"
+         << "      <Cells>\n"
+         << "        <DataArray type=\"Int32\" Name=\"connectivity\" format=\"appended\" offset=\"" << offsets[1] << "\"/>\n"
+         << "        <DataArray type=\"Int64\" Name=\"offsets\" format=\"appended\" offset=\"" << offsets[2] << "\"/>\n"
+         << "        <DataArray type=\"UInt8\" Name=\"types\" format=\"appended\" offset=\"" << offsets[3] << "\"/>\n"
+         << "      </Cells>\n";
+     if (domains) {
+         xml << "      <CellData Scalars=\"Domain\">\n"
+             << "        <DataArray type=\"Int32\" Name=\"Domain\" format=\"appended\" offset=\"" << offsets[4] << "\"/>\n"
+             << "      </CellData>\n";
+     }
+     xml << "    </Piece>\n"
+         << "  </UnstructuredGrid>\n"
+         << "  <AppendedData encoding=\"raw\">\n"
+         << "   _";
+     const std::string header = xml.str();
+     out.write(header.data(), static_cast<std::streamsize>(header.size()));
+
+     writeBlock(out, mesh.vertices.data(), pointBytes);
+     writeBlock(out, mesh.tetrahedrons.data(), connectivityBytes);
+     writeGeneratedBlock<std::int64_t>(out, cells, [](std::size_t i) { return static_cast<std::int64_t>(4 * (i + 1)); });
+     writeGeneratedBlock<std::uint8_t>(out, cells, [](std::size_t) { return kVtkTetra; });
+     if (domains) writeBlock(out, mesh.tetrahedronDomains.data(), cells * sizeof(int));
+
+     const char footer[] = "\n  </AppendedData>\n</VTKFile>\n";
+     out.write(footer, sizeof(footer) - 1);
+     if (!out) {
+         std::cerr << "Error: Cannot write VTU file: " << path << std::endl;
+         return false;
+     }
+     return true;
+ }
@@ -3,7 +3,7 @@
  * @brief Mesh viewer and editor application with ImGui-based GUI.
  * 
  * This application allows users to load, visualize, transform, and validate 3D meshes.
- * It includes support for OBJ file import, boolean operations, adaptive mesh generation,
+ * It includes support for OBJ, OFF, PLY and MESHBIN import, boolean operations, adaptive mesh generation,
  * and metadata assignment to mesh groups.
  */
 
@@ -18,7 +18,12 @@
 #include <array>
 #include <cstring>
 #include <cstdlib>
+#include <cstdio>
+#include <cmath>
 #include <iterator>
+#include <future>
+#include <memory>
+#include <stdexcept>
 #include "Timer.h"
 // GUI headers
 #include "GLFW/glfw3.h"
@@ -32,7 +37,12 @@
 #include "ObjParser.h"
 #include "Mesh.h"
 #include "MeshValidator.h"
+#include "MeshRenderBuffers.h"
+#include "MeshLod.h"
+#include "SharedMesh.h"
+#include "FaceCentroidGrid.h"
 #include "ObjExporter.h"
+#include "MeshIO.h"
 #include "MeshMetadata.h"        
 #include "MetadataExporter.h"    
 #include "MeshTransform.h"
@@ -48,6 +58,7 @@ float camOffsetX = 0.0f;
 float camOffsetY = 0.0f;
 float camZoom = 1.0f;
 int renderMode = 1; // 0 = Faces, 1 = Wireframe
+bool useLod = true; // Draw large meshes from coarser copies when they are small on screen
 
 /** Transformation parameters */ 
 double tx = 0.0, ty = 0.0, tz = 0.0;
@@ -55,12 +66,12 @@ double sx = 1.0, sy = 1.0, sz = 1.0;
 double rx = 0.0, ry = 0.0, rz = 0.0;
 
 /** Adaptive Mesh Generator parameters */
-double amg_sizing_field = 0.7;
-double amg_edge_distance = 0.01;
-double amg_facet_angle = 25.0;
-double amg_facet_distance = 0.01;
-double amg_cell_radius_edge_ratio = 3.0;
-float amg_cube_size = 10.0f; // as float
+AdaptiveMeshGenerator::Options amgOptions;
+// Volume meshing runs in the background; the frame loop polls it
+std::future<bool> volumeMeshJob;
+std::shared_ptr<AdaptiveMeshGenerator::Progress> volumeMeshProgress;
+std::shared_ptr<Mesh> volumeMeshJobBoundary; ///< Filled by the job with the boundary of the volume mesh
+Timer volumeMeshTimer;
 
 // DEPRECATED: Mesh type selection: 0 = "surface", 1 = "volume", 2 = "both"
 // const char* meshTypeOptions[] = { "surface", "volume", "both" };
@@ -68,12 +79,21 @@ int currentMeshType = 0;
 
 /** Output file names */    
 char outputFileName[128] = "output.obj";
-char metadataFileName[128] = "metadata.json";
-char outputVolMeshFileName[128] = "output_volume_mesh";
+char metadataFileName[128] = "metadata.json"; // .json, or binary .cbor / .msgpack
+MetadataEncoding metadataEncoding;
+char outputVolMeshFileName[128] = "output_volume_mesh.mesh"; // .mesh (MEDIT) or .vtu; other names use CGAL's dump
 
-// File name for the Boolean operations result (OFF file)
+// File name for the Boolean operations result (volume meshing input); the extension picks the format
+const char* booleanResultFormats[] = { "off", "ply", "meshbin" };
+int booleanResultFormat = 0;
 std::string booleanResultFile = "boolean_result.off";
 bool booleanOperationPerformed = false;
+// Boolean results stay in memory; the result files are written in the background
+bool writeBooleanResultFiles = true;
+std::shared_ptr<const Mesh> booleanResultMesh; ///< Last result (volume meshing input)
+std::future<bool> booleanResultWrite; ///< Background result export in flight
+bool booleanResultOnDisk = false;     ///< booleanResultFile holds booleanResultMesh
+bool booleanResultValid = false;      ///< booleanResultMesh passed validation (volume meshing needs a clean surface)
 
 // Global merged metadata for the boolean-merged mesh.
 MeshMetadata mergedMeshMetadata;
@@ -86,6 +106,7 @@ bool dragSelectionActive = false;
 ImVec2 dragStart, dragEnd;
 bool exportCentroidInfo = false;  // If checked, export centroid info
 bool exportFaceInfo = false;      // If checked, export face info
+int selectionMode = 0;            // 0 = Replace, 1 = Add, 2 = Remove the dragged faces
 
 // Global log text string
 std::string logText = "";
@@ -98,12 +119,27 @@ void appendLog(const std::string &msg) {
 }
 
 
+/** Display levels of a scene mesh, shared with its undo snapshots (same geometry as loaded) */
+struct SceneLod {
+    MeshLod levels; ///< Display-only simplified copies of the mesh as loaded (before bakedTransform)
+    std::vector<MeshRenderBuffers> buffers; ///< GL geometry of the levels
+};
+
 /** Structure representing a scene mesh */
 struct SceneMesh {
-    Mesh mesh; ///< The mesh object
+    SharedMesh mesh; ///< The mesh object, shared with undo snapshots until modified
+    std::shared_ptr<const Mesh> source; ///< Untransformed mesh when it did not come from filePath (boolean results)
     std::string filePath; ///< File path of the mesh
-    std::vector<std::string> validationErrors; ///< Validation error messages
-    std::vector<bool> errorFaces; ///< Boolean array for faces with errors
+    MeshValidator::Report validation; ///< Validation result, including per-face error flags
+    MeshRenderBuffers renderBuffers; ///< Triangulated GL geometry of mesh
+    bool renderDirty = true; ///< mesh or validation changed: rebuild renderBuffers before drawing
+    std::uint64_t groupsVersion = 0; ///< MeshMetadata::membershipVersion the face colours were sorted for
+    std::shared_ptr<SceneLod> lod = std::make_shared<SceneLod>(); ///< Level of detail for drawing
+    std::size_t lodLevel = 0; ///< Level drawn in the last frame (0: full mesh)
+    FaceCentroidGrid selectionGrid; ///< Face centroids for drag selection; built on first use, cleared when mesh changes
+    bool booleanResult = false; ///< Output of a boolean operation (the merged mesh)
+    MeshTransform::Matrix transform = MeshTransform::identity(); ///< Pending transform, applied by the viewport until baked
+    MeshTransform::Matrix bakedTransform = MeshTransform::identity(); ///< Transform already written into mesh.vertices
     double loadTime; ///< Time taken to load the mesh (ms)
     bool enabled = true; ///< Visibility status of the mesh
 };
@@ -111,9 +147,28 @@ struct SceneMesh {
 /** Global list of scene meshes */
 std::vector<SceneMesh> sceneMeshes;
 
+/** Boundary of the last generated volume mesh, drawn on top of the scene */
+SceneMesh volumeBoundary;
+bool showVolumeBoundary = true;
+
 /** Index of the currently active mesh */
 int activeMeshIndex = -1;
 
+/** Scene state for undo/redo; the meshes share geometry and display levels with the scene */
+struct SceneSnapshot {
+    std::string label; ///< The operation undone (or redone) by restoring the snapshot
+    std::vector<SceneMesh> meshes;
+    int activeMeshIndex = -1;
+    bool booleanOperationPerformed = false;
+    MeshMetadata mergedMeshMetadata;
+    std::string activeGroupName;
+};
+
+/** Undo and redo histories, most recent last */
+std::vector<SceneSnapshot> undoHistory;
+std::vector<SceneSnapshot> redoHistory;
+const std::size_t undoLimit = 32;
+
 /**
  * @brief Extracts the filename from a full file path.
  * @param fullPath The complete file path.
@@ -126,42 +181,6 @@ std::string extractFilename(const std::string &fullPath) {
     return fullPath;
 }
 
-// Helper function to compute error faces.
-std::vector<bool> getErrorFaces(const Mesh &mesh) {
-    std::vector<bool> errorFaces(mesh.faces.size(), false);
-    // std::map<std::pair<int,int>, int> edgeCount; // Old code
-    std::unordered_map<std::pair<int,int>, int, boost::hash<std::pair<int,int>>> edgeCount;
-    // Count occurrences of each edge (store edges with sorted vertex indices)
-    for (const auto& face : mesh.faces) {
-        size_t n = face.elements.size();
-        for (size_t i = 0; i < n; i++) {
-            int v1 = face.elements[i].vertexIndex;
-            int v2 = face.elements[(i+1) % n].vertexIndex;
-            if (v1 > v2) std::swap(v1, v2);
-            edgeCount[{v1, v2}]++;
-        }
-    }
-    
-    // Mark any face with an edge that does not occur exactly twice.
-    for (size_t i = 0; i < mesh.faces.size(); i++) {
-        bool error = false;
-        const Face &face = mesh.faces[i];
-        size_t n = face.elements.size();
-        for (size_t j = 0; j < n; j++) {
-            int v1 = face.elements[j].vertexIndex;
-            int v2 = face.elements[(j+1) % n].vertexIndex;
-            if (v1 > v2) std::swap(v1, v2);
-            auto it = edgeCount.find({v1, v2});
-            if (it == edgeCount.end() || it->second != 2) {
-                error = true;
-                break;
-            }
-        }
-        errorFaces[i] = error;
-    }
-    return errorFaces;
-}
-
 // Global validation log text string
 std::string validationLogText = "";
 
@@ -170,6 +189,29 @@ void appendValidationLog(const std::string &msg) {
     validationLogText += msg + "\n";
 }
 
+/** Most validation errors written to the log per mesh; the rest are only counted */
+const size_t maxLoggedValidationErrors = 100;
+
+/**
+ * @brief Appends the errors of a validation report to the validation log.
+ *
+ * Only the first maxLoggedValidationErrors messages are formatted.
+ *
+ * @param report The validation result.
+ * @param header Line written before the errors.
+ */
+void appendValidationErrors(const MeshValidator::Report &report, const std::string &header) {
+    appendValidationLog(header);
+    size_t shown = std::min(report.errorCount(), maxLoggedValidationErrors);
+    for (size_t i = 0; i < shown; ++i) {
+        appendValidationLog("- " + report.message(i));
+    }
+    if (shown < report.errorCount()) {
+        appendValidationLog("- ... and " + std::to_string(report.errorCount() - shown) + " more (" +
+                            std::to_string(report.errorFaceCount) + " faces affected)");
+    }
+}
+
 /**
  * @brief Validates the active mesh and updates the validation log.
  */
@@ -179,15 +221,12 @@ void validateActiveMesh() {
         return;
     }
     SceneMesh &activeMesh = sceneMeshes[activeMeshIndex];
-    activeMesh.validationErrors = MeshValidator::validate(activeMesh.mesh);
-    activeMesh.errorFaces = getErrorFaces(activeMesh.mesh);
-    if (activeMesh.validationErrors.empty()) {
+    activeMesh.validation = MeshValidator::check(*activeMesh.mesh);
+    activeMesh.renderDirty = true;
+    if (activeMesh.validation.valid()) {
         appendValidationLog("Mesh " + extractFilename(activeMesh.filePath) + " passed validation.");
     } else {
-        appendValidationLog("Validation errors found in mesh " + extractFilename(activeMesh.filePath) + ":");
-        for (const auto &error : activeMesh.validationErrors) {
-            appendValidationLog("- " + error);
-        }
+        appendValidationErrors(activeMesh.validation, "Validation errors found in mesh " + extractFilename(activeMesh.filePath) + ":");
     }
 }
 
@@ -209,21 +248,98 @@ ImVec2 projectPoint(const std::array<double, 3>& point, double aspect, float zoo
     return screenPos;
 }
 
-// Process drag selection: add faces to the active group's metadata.
-void processDragSelection(int dispw, int disph, double aspect) {
-    // Find the merged mesh
-    int mergedIdx = -1;
-    for (int i = 0; i < (int)sceneMeshes.size(); i++) {
-        if (sceneMeshes[i].filePath == "boolean_result.obj") {
-            mergedIdx = i;
-            break;
+// Inverse of projectPoint for the x/y plane: screen position to mesh coordinates.
+std::array<double, 2> unprojectPoint(const ImVec2& screenPos, double aspect, float zoom,
+                                     float offsetX, float offsetY, int display_w, int display_h) {
+    double ndc_x = screenPos.x / display_w;
+    double ndc_y = 1.0 - screenPos.y / display_h;
+    return { (ndc_x * 2 * aspect - aspect) / zoom - offsetX,
+             (ndc_y * 2.0 - 1.0) / zoom - offsetY };
+}
+
+// Writes a scene mesh's pending transform into its vertices (before export, booleans and picking).
+// Validation results are unaffected: affine maps keep edges, orientation and intersections.
+void bakeTransform(SceneMesh &sceneMesh) {
+    if (MeshTransform::isIdentity(sceneMesh.transform))
+        return;
+    MeshTransform::apply(sceneMesh.mesh.edit(), sceneMesh.transform);
+    sceneMesh.bakedTransform = MeshTransform::compose(sceneMesh.transform, sceneMesh.bakedTransform);
+    sceneMesh.transform = MeshTransform::identity();
+    sceneMesh.renderDirty = true;
+    sceneMesh.selectionGrid.clear();
+}
+
+// Length on screen, in pixels, of a model-space distance drawn through the transform m
+// (its largest axis scale), at the current zoom.
+double screenDiagonal(double diagonal, const MeshTransform::Matrix &m, int display_h) {
+    double scale = 0.0;
+    for (int c = 0; c < 3; ++c)
+        scale = std::max(scale, std::sqrt(m[4 * c] * m[4 * c] + m[4 * c + 1] * m[4 * c + 1] + m[4 * c + 2] * m[4 * c + 2]));
+    // glOrtho maps [-1, 1] vertically onto the framebuffer height
+    return diagonal * scale * camZoom * display_h / 2.0;
+}
+
+// The most recent boolean result in the scene, or nullptr.
+SceneMesh *findMergedMesh() {
+    for (auto it = sceneMeshes.rbegin(); it != sceneMeshes.rend(); ++it) {
+        if (it->booleanResult)
+            return &*it;
+    }
+    return nullptr;
+}
+
+// Adds (remove = false) or removes the sorted faces to/from a face index list.
+void updateFaceSelection(std::vector<int> &faceIndices, const std::vector<int> &faces, bool remove) {
+    std::sort(faceIndices.begin(), faceIndices.end());
+    std::vector<int> updated;
+    updated.reserve(faceIndices.size() + (remove ? 0 : faces.size()));
+    if (remove)
+        std::set_difference(faceIndices.begin(), faceIndices.end(), faces.begin(), faces.end(), std::back_inserter(updated));
+    else
+        std::set_union(faceIndices.begin(), faceIndices.end(), faces.begin(), faces.end(), std::back_inserter(updated));
+    faceIndices.swap(updated);
+}
+
+// Adds or removes the sorted faces to/from spatial data records, kept sorted by face index.
+void updateFaceSelection(std::vector<FaceSpatialData> &spatialData, const std::vector<int> &faces, bool remove,
+                         const Mesh &mesh, const FaceCentroidGrid &grid, bool withVertices) {
+    auto byFace = [](const FaceSpatialData &a, const FaceSpatialData &b) { return a.faceIndex < b.faceIndex; };
+    std::sort(spatialData.begin(), spatialData.end(), byFace);
+    auto selected = [&faces](int face) { return std::binary_search(faces.begin(), faces.end(), face); };
+    if (remove) {
+        spatialData.erase(std::remove_if(spatialData.begin(), spatialData.end(),
+                                         [&](const FaceSpatialData &fsd) { return selected(fsd.faceIndex); }),
+                          spatialData.end());
+        return;
+    }
+    const size_t existing = spatialData.size();
+    for (int i : faces) {
+        FaceSpatialData fsd;
+        fsd.faceIndex = i;
+        if (std::binary_search(spatialData.begin(), spatialData.begin() + existing, fsd, byFace))
+            continue;
+        fsd.centroid = grid.centroids()[i];
+        if (withVertices) {
+            for (const auto &elem : mesh.faces[i].elements) {
+                const Vertex &v = mesh.vertices[elem.vertexIndex];
+                fsd.vertices.push_back({v.x, v.y, v.z});
+                fsd.vertexIndices.push_back(elem.vertexIndex);
+            }
         }
+        spatialData.push_back(std::move(fsd));
     }
-    if (mergedIdx < 0) {
+    std::inplace_merge(spatialData.begin(), spatialData.begin() + existing, spatialData.end(), byFace);
+}
+
+// Process drag selection: replace, add or remove the dragged faces in the active group's metadata.
+void processDragSelection(int dispw, int disph, double aspect) {
+    SceneMesh *merged = findMergedMesh();
+    if (!merged) {
         appendLog("No merged mesh found for drag selection.");
         return;
     }
-    auto &mergedMesh = sceneMeshes[mergedIdx].mesh;
+    bakeTransform(*merged);
+    const Mesh &mergedMesh = *merged->mesh;
 
     // Get the active group
     GroupMetadata* group = mergedMeshMetadata.getGroupMetadata(activeGroupName);
@@ -232,119 +348,220 @@ void processDragSelection(int dispw, int disph, double aspect) {
         return;
     }
 
-    // Clear existing face assignments in that group.
-    group->faceIndices.clear();
-    group->spatialData.clear();
+    if (selectionMode == 0) {
+        // Replace: clear existing face assignments in that group.
+        group->faceIndices.clear();
+        group->spatialData.clear();
+    }
 
-    // Determine the selection rectangle boundaries
+    // The selection rectangle in mesh x/y; the view looks along z, so this holds for any camera
     float x0 = std::min(dragStart.x, dragEnd.x);
     float x1 = std::max(dragStart.x, dragEnd.x);
     float y0 = std::min(dragStart.y, dragEnd.y);
     float y1 = std::max(dragStart.y, dragEnd.y);
-
-    // For each face, compute centroid, project it, check if inside selection rect.
-    for (int i = 0; i < (int)mergedMesh.faces.size(); i++) {
-        const Face &face = mergedMesh.faces[i];
-        double cx = 0, cy = 0, cz = 0;
-        for (auto &elem : face.elements) {
-            const Vertex &v = mergedMesh.vertices[elem.vertexIndex];
-            cx += v.x;
-            cy += v.y;
-            cz += v.z;
-        }
-        int n = face.elements.size();
-        if (n > 0) { 
-            cx /= n; cy /= n; cz /= n; 
-        }
-        std::array<double,3> centroid = {cx, cy, cz};
-        ImVec2 screenPt = projectPoint(centroid, aspect, camZoom, camOffsetX, camOffsetY, dispw, disph);
-
-        // Check if the projected point is within the selection rectangle
-        if (screenPt.x >= x0 && screenPt.x <= x1 && screenPt.y >= y0 && screenPt.y <= y1) {
-            // Depending on export flags:
-            if (exportCentroidInfo && !exportFaceInfo) {
-                FaceSpatialData fsd;
-                fsd.faceIndex = i;
-                fsd.centroid = centroid;
-                group->spatialData.push_back(fsd);
-            }
-            else if (!exportCentroidInfo && exportFaceInfo) {
-                group->faceIndices.push_back(i);
-            }
-            else if (exportCentroidInfo && exportFaceInfo) {
-                FaceSpatialData fsd;
-                fsd.faceIndex = i;
-                fsd.centroid = centroid;
-                for (auto &elem : face.elements) {
-                    const Vertex &v = mergedMesh.vertices[elem.vertexIndex];
-                    fsd.vertices.push_back({v.x, v.y, v.z});
-                }
-                group->spatialData.push_back(fsd);
-            }
-            // If neither is selected, do nothing with that face.
-        }
-    }
-    appendLog("Drag selection processed. Faces added to group: " + activeGroupName);
+    std::array<double, 2> lo = unprojectPoint(ImVec2(x0, y1), aspect, camZoom, camOffsetX, camOffsetY, dispw, disph);
+    std::array<double, 2> hi = unprojectPoint(ImVec2(x1, y0), aspect, camZoom, camOffsetX, camOffsetY, dispw, disph);
+
+    if (merged->selectionGrid.empty())
+        merged->selectionGrid.build(mergedMesh);
+    std::vector<int> faces = merged->selectionGrid.query(lo[0], lo[1], hi[0], hi[1]);
+
+    // Depending on export flags; removal applies to both lists.
+    bool remove = selectionMode == 2;
+    if (remove || (!exportCentroidInfo && exportFaceInfo))
+        updateFaceSelection(group->faceIndices, faces, remove);
+    if (remove || exportCentroidInfo)
+        updateFaceSelection(group->spatialData, faces, remove, mergedMesh, merged->selectionGrid, exportFaceInfo);
+    // If neither is selected, do nothing with those faces.
+    mergedMeshMetadata.refreshGroupFaces(activeGroupName);
+
+    appendLog("Drag selection processed: " + std::to_string(faces.size()) + " faces " +
+              (remove ? "removed from" : "added to") + " group " + activeGroupName);
 }
 
 // After boolean operation, disable individual meshes (all except merged one).
 void disableIndividualMeshes() {
     for (auto &mesh : sceneMeshes) {
-        if (mesh.filePath != "boolean_result.obj")
+        if (!mesh.booleanResult)
             mesh.enabled = false;
     }
 }
 
-// Convert the boolean result OFF to OBJ, add to the scene, create default group, disable others.
-void addBooleanOperationMesh(const std::string &offFile) {
+// Copy of a scene mesh for the undo history: the mesh and display levels are shared, GL buffers are not.
+SceneMesh snapshotOf(const SceneMesh &sceneMesh) {
+    SceneMesh copy;
+    copy.mesh = sceneMesh.mesh;
+    copy.source = sceneMesh.source;
+    copy.filePath = sceneMesh.filePath;
+    copy.validation = sceneMesh.validation;
+    copy.lod = sceneMesh.lod;
+    copy.booleanResult = sceneMesh.booleanResult;
+    copy.transform = sceneMesh.transform;
+    copy.bakedTransform = sceneMesh.bakedTransform;
+    copy.loadTime = sceneMesh.loadTime;
+    copy.enabled = sceneMesh.enabled;
+    return copy;
+}
+
+SceneSnapshot captureScene(const std::string &label) {
+    SceneSnapshot snapshot;
+    snapshot.label = label;
+    snapshot.meshes.reserve(sceneMeshes.size());
+    for (const auto &sceneMesh : sceneMeshes)
+        snapshot.meshes.push_back(snapshotOf(sceneMesh));
+    snapshot.activeMeshIndex = activeMeshIndex;
+    snapshot.booleanOperationPerformed = booleanOperationPerformed;
+    snapshot.mergedMeshMetadata = mergedMeshMetadata;
+    snapshot.activeGroupName = activeGroupName;
+    return snapshot;
+}
+
+void restoreScene(SceneSnapshot &&snapshot) {
+    sceneMeshes = std::move(snapshot.meshes); // Render buffers are rebuilt on the next draw
+    activeMeshIndex = snapshot.activeMeshIndex;
+    booleanOperationPerformed = snapshot.booleanOperationPerformed;
+    mergedMeshMetadata = std::move(snapshot.mergedMeshMetadata);
+    activeGroupName = std::move(snapshot.activeGroupName);
+}
+
+// Record the scene before an operation changing it; clears the redo history.
+void recordUndo(const std::string &label) {
+    undoHistory.push_back(captureScene(label));
+    if (undoHistory.size() > undoLimit)
+        undoHistory.erase(undoHistory.begin());
+    redoHistory.clear();
+}
+
+// Move the scene one step back (undo = true) or forward in the history.
+void stepHistory(bool undo) {
+    std::vector<SceneSnapshot> &from = undo ? undoHistory : redoHistory;
+    std::vector<SceneSnapshot> &to = undo ? redoHistory : undoHistory;
+    if (from.empty())
+        return;
+    SceneSnapshot snapshot = std::move(from.back());
+    from.pop_back();
+    to.push_back(captureScene(snapshot.label));
+    appendLog((undo ? "Undo: " : "Redo: ") + snapshot.label);
+    restoreScene(std::move(snapshot));
+}
+
+// Collect the background export of a boolean result; with wait = false only if it is done.
+void finishBooleanResultExport(bool wait) {
+    if (!booleanResultWrite.valid())
+        return;
+    if (!wait && booleanResultWrite.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        return;
+    booleanResultOnDisk = booleanResultWrite.get();
+    if (booleanResultOnDisk)
+        appendLog("Boolean result written to " + booleanResultFile + " and boolean_result.obj");
+    else
+        appendLog("Error writing boolean result to " + booleanResultFile + " / boolean_result.obj");
+}
+
+// Collect a finished volume meshing job; with wait = false only if it is done.
+void finishVolumeMeshJob(bool wait) {
+    if (!volumeMeshJob.valid())
+        return;
+    if (!wait && volumeMeshJob.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        return;
+    bool success = false;
+    try {
+        success = volumeMeshJob.get();
+    } catch (const std::exception &ex) {
+        appendLog("Error generating volume mesh: " + std::string(ex.what()));
+    }
+    if (success) {
+        appendLog("Volume mesh generated and exported to " + std::string(outputVolMeshFileName) + ".");
+        volumeBoundary = SceneMesh();
+        volumeBoundary.filePath = outputVolMeshFileName;
+        volumeBoundary.mesh = std::move(*volumeMeshJobBoundary);
+        volumeBoundary.loadTime = 0.0;
+        appendLog("Volume mesh boundary: " + std::to_string(volumeBoundary.mesh->faces.size()) + " triangles.");
+    }
+    else if (volumeMeshProgress->cancelled)
+        appendLog("Volume mesh generation cancelled.");
+    else
+        appendLog("Failed to generate volume mesh from boolean operation result.");
+    appendLog("Volume mesh processing time: " + std::to_string(volumeMeshTimer.elapsed()) + " ms");
+}
+
+// A running volume meshing job reads booleanResultFile first; do not overwrite it before that.
+void waitForVolumeMeshInput() {
+    while (volumeMeshJob.valid() && volumeMeshProgress->stage == AdaptiveMeshGenerator::Reading
+           && volumeMeshJob.wait_for(std::chrono::milliseconds(1)) != std::future_status::ready) {
+    }
+}
+
+// Make sure booleanResultFile holds the current result (volume meshing reads it from disk).
+bool ensureBooleanResultOnDisk() {
+    finishBooleanResultExport(true);
+    if (!booleanResultOnDisk && booleanResultMesh)
+        booleanResultOnDisk = MeshIO::write(booleanResultFile, *booleanResultMesh);
+    return booleanResultOnDisk;
+}
+
+// Add a boolean result to the scene straight from memory, create default group, disable others.
+// The result files are written asynchronously if writeBooleanResultFiles is set.
+void addBooleanOperationMesh(MeshBooleanOperations::Polyhedron &&resultPoly) {
     std::string newObjFile = "boolean_result.obj";
+    finishBooleanResultExport(true); // Never two writers on the same files
+    waitForVolumeMeshInput();
+    booleanResultMesh.reset();
+    booleanResultOnDisk = false;
+
     MeshConverter converter;
-    // Convert the OFF file to OBJ format
-    if (converter.convertOffToObj(offFile, newObjFile)) {
-        appendLog("Converted boolean result OFF to OBJ: " + newObjFile);
-        SceneMesh newMesh;
-        newMesh.filePath = newObjFile;
-        try {
-            // Parse the newly created OBJ file
-            ObjParser parser;
-            newMesh.mesh = parser.parse(newObjFile.c_str());
-            // Validate the mesh and get error faces
-            newMesh.validationErrors = MeshValidator::validate(newMesh.mesh);
-            newMesh.errorFaces = getErrorFaces(newMesh.mesh);
-            appendValidationLog("Boolean operation mesh added: " + extractFilename(newMesh.filePath));
-            if (newMesh.validationErrors.empty()) {
-                appendValidationLog("Mesh is valid after boolean operation.");
-            } else {
-                appendValidationLog("Validation errors in boolean operation mesh:");
-                for (const auto& error : newMesh.validationErrors) {
-                    appendValidationLog("- " + error);
-                }
-            }
-            newMesh.loadTime = 0.0;
-            // Add the new mesh to the scene
-            sceneMeshes.push_back(newMesh);
-            appendLog("Added boolean operation mesh to scene: " + extractFilename(newObjFile));
-            booleanOperationPerformed = true;
-            // Disable individual meshes after boolean operation
-            disableIndividualMeshes();
-            // Initialize merged metadata with a default group
-            mergedMeshMetadata = MeshMetadata();
-            GroupMetadata defaultGroup;
-            defaultGroup.groupName = "Inner";
-            defaultGroup.boundaryCondition.type = "fixed";
-            defaultGroup.boundaryCondition.parameters = {0.0};
-            defaultGroup.materialProperties.density = 7850.0;
-            defaultGroup.materialProperties.elasticModulus = 210e9;
-            defaultGroup.materialProperties.poissonRatio = 0.3;
-            mergedMeshMetadata.addGroupMetadata(defaultGroup);
-            activeGroupName = "Inner";
-            appendLog("Initialized default metadata group 'Inner'.");
-        } catch (const std::exception &ex) {
-            appendLog("Error reading OBJ file " + newObjFile + ": " + std::string(ex.what()));
-        }
+    auto resultMesh = std::make_shared<Mesh>();
+    if (!converter.convertPolyhedronToMesh(resultPoly, *resultMesh)) {
+        appendLog("Error converting boolean result to a mesh.");
+        return;
+    }
+    std::shared_ptr<const Mesh> source = resultMesh;
+    booleanResultMesh = source;
+    if (writeBooleanResultFiles) {
+        std::string resultFile = booleanResultFile;
+        booleanResultWrite = std::async(std::launch::async, [resultFile, newObjFile, source]() {
+            bool result = MeshIO::write(resultFile, *source);
+            bool obj = ObjExporter::exportMesh(*source, newObjFile);
+            return result && obj;
+        });
+    }
+
+    recordUndo("Boolean operation");
+    SceneMesh newMesh;
+    newMesh.filePath = newObjFile;
+    newMesh.source = source;
+    newMesh.booleanResult = true;
+    newMesh.mesh = source;
+    // Validate the mesh and get error faces
+    newMesh.validation = MeshValidator::check(*newMesh.mesh);
+    booleanResultValid = newMesh.validation.valid();
+    appendValidationLog("Boolean operation mesh added: " + extractFilename(newMesh.filePath));
+    if (newMesh.validation.valid()) {
+        appendValidationLog("Mesh is valid after boolean operation.");
     } else {
-        appendLog("Conversion from OFF to OBJ failed.");
+        appendValidationErrors(newMesh.validation, "Validation errors in boolean operation mesh:");
     }
+    newMesh.loadTime = 0.0;
+    newMesh.lod->levels.start(source);
+    // Add the new mesh to the scene
+    sceneMeshes.push_back(std::move(newMesh));
+    appendLog("Added boolean operation mesh to scene: " + extractFilename(newObjFile));
+    booleanOperationPerformed = true;
+    // Disable individual meshes after boolean operation
+    disableIndividualMeshes();
+    // Initialize merged metadata with a default group
+    mergedMeshMetadata = MeshMetadata();
+    mergedMeshMetadata.setFaceCount(sceneMeshes.back().mesh->faces.size());
+    GroupMetadata defaultGroup;
+    defaultGroup.groupName = "Inner";
+    defaultGroup.boundaryCondition.type = "fixed";
+    defaultGroup.boundaryCondition.parameters = {0.0};
+    defaultGroup.materialProperties.density = 7850.0;
+    defaultGroup.materialProperties.elasticModulus = 210e9;
+    defaultGroup.materialProperties.poissonRatio = 0.3;
+    mergedMeshMetadata.addGroupMetadata(defaultGroup);
+    activeGroupName = "Inner";
+    appendLog("Initialized default metadata group 'Inner'.");
 }
 
 // Function to load an image as an OpenGL texture
@@ -417,6 +634,8 @@ int main(int argc, char** argv) {
 
     glfwMakeContextCurrent(window);
     glfwSwapInterval(1);
+    if (!MeshRenderBuffers::loadGL())
+        std::cerr << "OpenGL buffer objects unavailable; drawing meshes from client memory" << std::endl;
     IMGUI_CHECKVERSION();
     ImGui::CreateContext();
     ImGuiIO &io = ImGui::GetIO(); (void)io;
@@ -477,6 +696,8 @@ int main(int argc, char** argv) {
 
 
         glfwGetFramebufferSize(window, &display_w, &display_h);
+        finishBooleanResultExport(false);
+        finishVolumeMeshJob(false);
         
         // --- Camera Controls ---
         ImGui::SetNextWindowPos(ImVec2(10, 10),  ImGuiCond_FirstUseEver);
@@ -486,6 +707,7 @@ int main(int argc, char** argv) {
         ImGui::Text("Offset: (%.2f, %.2f)", camOffsetX, camOffsetY);
         const char* modesArr[] = { "Faces", "Wireframe" };
         ImGui::Combo("Render Mode", &renderMode, modesArr, IM_ARRAYSIZE(modesArr));
+        ImGui::Checkbox("Level of Detail", &useLod);
         ImGui::End();
 
         // Drag camera if enabled
@@ -517,36 +739,40 @@ int main(int argc, char** argv) {
         // --- Add OBJ File ---
         ImGui::SetNextWindowPos(ImVec2(10, 70),  ImGuiCond_FirstUseEver);
         ImGui::Begin("Add OBJ File", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
-        ImGui::Text("Select an OBJ file to add.");
-        if (ImGui::Button("Select OBJ File")) {
-            const char* filterPatterns[1] = { "*.obj" };
-            const char* filePath = tinyfd_openFileDialog("Select OBJ File", "./", 1, filterPatterns, "OBJ Files", 0);
+        ImGui::Text("Select a mesh file (OBJ, OFF, PLY, MESHBIN) to add.");
+        if (ImGui::Button("Select Mesh File")) {
+            const char* filterPatterns[4] = { "*.obj", "*.off", "*.ply", "*.meshbin" };
+            const char* filePath = tinyfd_openFileDialog("Select Mesh File", "./", 4, filterPatterns, "Mesh Files", 0);
             if (filePath) {
                 SceneMesh newMesh;
                 newMesh.filePath = filePath;
                 Timer timer;
                 try {
-                    ObjParser parser;
-                    newMesh.mesh = parser.parse(filePath);
-                    newMesh.validationErrors = MeshValidator::validate(newMesh.mesh);
-                    newMesh.errorFaces = getErrorFaces(newMesh.mesh);
+                    Mesh loaded;
+                    if (MeshIO::formatOf(filePath) == MeshIO::Format::Obj) {
+                        ObjParser parser;
+                        loaded = parser.parse(filePath);
+                    } else if (!MeshIO::read(filePath, loaded)) {
+                        throw std::runtime_error("cannot read " + extractFilename(newMesh.filePath));
+                    }
+                    newMesh.mesh = std::move(loaded);
+                    newMesh.validation = MeshValidator::check(*newMesh.mesh);
                     // Append validation messages
                     appendValidationLog("Imported mesh: " + extractFilename(newMesh.filePath));
-                    if (newMesh.validationErrors.empty()) {
+                    if (newMesh.validation.valid()) {
                         appendValidationLog("Mesh is valid.");
                     } else {
-                        appendValidationLog("Validation errors in " + extractFilename(newMesh.filePath) + ":");
-                        for (const auto& error : newMesh.validationErrors) {
-                            appendValidationLog("- " + error);
-                        }
+                        appendValidationErrors(newMesh.validation, "Validation errors in " + extractFilename(newMesh.filePath) + ":");
                     }
                     appendLog("Imported mesh: " + extractFilename(newMesh.filePath));
+                    newMesh.lod->levels.start(newMesh.mesh.share());
                 } catch (const std::exception &ex) {
-                    appendLog("Error parsing OBJ file: " + std::string(ex.what()));
+                    appendLog("Error reading mesh file: " + std::string(ex.what()));
                 }
                 newMesh.loadTime = timer.elapsed();
                 appendLog("Mesh " + extractFilename(newMesh.filePath) + " loaded and validated in " + std::to_string(newMesh.loadTime) + " ms");
-                sceneMeshes.push_back(newMesh);
+                recordUndo("Import " + extractFilename(newMesh.filePath));
+                sceneMeshes.push_back(std::move(newMesh));
                 if (activeMeshIndex < 0) {
                     activeMeshIndex = 0;
                 }
@@ -554,6 +780,7 @@ int main(int argc, char** argv) {
         }
         
         if (ImGui::Button("Clear Meshes")) {
+            recordUndo("Clear meshes");
             sceneMeshes.clear();
             activeMeshIndex = -1;
             booleanOperationPerformed = false;
@@ -564,6 +791,16 @@ int main(int argc, char** argv) {
         // --- Mesh List ---
         ImGui::SetNextWindowPos(ImVec2(static_cast<float>(display_w - 220), 10.0f), ImGuiCond_FirstUseEver);
         ImGui::Begin("Mesh List", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
+        if (ImGui::Button("Undo") && !undoHistory.empty())
+            stepHistory(true);
+        if (!undoHistory.empty() && ImGui::IsItemHovered())
+            ImGui::SetTooltip("Undo %s", undoHistory.back().label.c_str());
+        ImGui::SameLine();
+        if (ImGui::Button("Redo") && !redoHistory.empty())
+            stepHistory(false);
+        if (!redoHistory.empty() && ImGui::IsItemHovered())
+            ImGui::SetTooltip("Redo %s", redoHistory.back().label.c_str());
+        ImGui::Separator();
         if (sceneMeshes.empty()) {
             ImGui::Text("No meshes loaded.");
         } else {
@@ -580,7 +817,12 @@ int main(int argc, char** argv) {
                     activeMeshIndex = i;
                 if (i == activeMeshIndex)
                     ImGui::PopStyleColor();
+                if (sceneMeshes[i].lodLevel > 0) {
+                    ImGui::SameLine();
+                    ImGui::TextDisabled("LOD %d", (int)sceneMeshes[i].lodLevel);
+                }
                 if (ImGui::Button("Remove")) {
+                    recordUndo("Remove " + meshName);
                     appendLog("Removed mesh: " + meshName);
                     sceneMeshes.erase(sceneMeshes.begin() + i);
                     if (activeMeshIndex >= (int)sceneMeshes.size())
@@ -614,27 +856,30 @@ int main(int argc, char** argv) {
             } else {
                 try {
                     SceneMesh &activeMesh = sceneMeshes[activeMeshIndex];
+                    recordUndo("Transform " + extractFilename(activeMesh.filePath));
                     Timer timer;
-                    ObjParser parser;
-                    if (currentMeshType == 0 || currentMeshType == 2)
-                        activeMesh.mesh = parser.parseSurfaceMesh(activeMesh.filePath.c_str());
-                    if (tx != 0.0 || ty != 0.0 || tz != 0.0)
-                        MeshTransform::translate(activeMesh.mesh, tx, ty, tz);
-                    if (sx != 1.0 || sy != 1.0 || sz != 1.0)
-                        MeshTransform::scale(activeMesh.mesh, sx, sy, sz);
-                    if (rx != 0.0 || ry != 0.0 || rz != 0.0)
-                        MeshTransform::rotate(activeMesh.mesh, rx, ry, rz);
+                    if (!MeshTransform::isIdentity(activeMesh.bakedTransform)) {
+                        // The vertices hold an earlier transform: start again from the original
+                        Mesh reloaded;
+                        if (activeMesh.source)
+                            activeMesh.mesh = activeMesh.source;
+                        else if ((currentMeshType == 0 || currentMeshType == 2) && !MeshIO::read(activeMesh.filePath, reloaded))
+                            appendLog("Error reloading " + extractFilename(activeMesh.filePath));
+                        else if (currentMeshType == 0 || currentMeshType == 2)
+                            activeMesh.mesh = std::move(reloaded);
+                        activeMesh.bakedTransform = MeshTransform::identity();
+                        activeMesh.renderDirty = true;
+                        activeMesh.selectionGrid.clear();
+                    }
+                    // Translate, then scale, then rotate; drawn through the matrix until baked
+                    activeMesh.transform = MeshTransform::compose(MeshTransform::rotation(rx, ry, rz),
+                        MeshTransform::compose(MeshTransform::scaling(sx, sy, sz), MeshTransform::translation(tx, ty, tz)));
                     double transformTime = timer.elapsed();
-                    activeMesh.validationErrors = MeshValidator::validate(activeMesh.mesh);
-                    activeMesh.errorFaces = getErrorFaces(activeMesh.mesh);
                     appendValidationLog("Transformations applied to " + extractFilename(activeMesh.filePath));
-                    if (activeMesh.validationErrors.empty()) {
+                    if (activeMesh.validation.valid()) {
                         appendValidationLog("Mesh is valid after transformation.");
                     } else {
-                        appendValidationLog("Validation errors after transformation:");
-                        for (const auto& error : activeMesh.validationErrors) {
-                            appendValidationLog("- " + error);
-                        }
+                        appendValidationErrors(activeMesh.validation, "Validation errors after transformation:");
                     }
                     appendLog("Transformations applied to mesh: " + extractFilename(activeMesh.filePath));
                     appendLog("Transformation time: " + std::to_string(transformTime) + " ms");
@@ -650,7 +895,8 @@ int main(int argc, char** argv) {
             } else {
                 try {
                     SceneMesh &activeMesh = sceneMeshes[activeMeshIndex];
-                    if (ObjExporter::exportMesh(activeMesh.mesh, outputFileName))
+                    bakeTransform(activeMesh);
+                    if (MeshIO::write(outputFileName, *activeMesh.mesh))
                         appendLog("Transformed mesh exported to " + std::string(outputFileName));
                     else
                         appendLog("Failed to export transformed mesh.");
@@ -665,30 +911,34 @@ int main(int argc, char** argv) {
         ImGui::SetNextWindowPos(ImVec2(250, 200),  ImGuiCond_FirstUseEver);
         ImGui::Begin("Boolean Operations", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
         ImGui::Text("Perform Boolean Operations on Transformed Meshes:");
+        ImGui::Checkbox("Write result files (boolean_result.*)", &writeBooleanResultFiles);
+        if (ImGui::Combo("Result format", &booleanResultFormat, booleanResultFormats, IM_ARRAYSIZE(booleanResultFormats))) {
+            finishBooleanResultExport(true); // The pending export targets the old name
+            waitForVolumeMeshInput();
+            booleanResultFile = std::string("boolean_result.") + booleanResultFormats[booleanResultFormat];
+            booleanResultOnDisk = false;
+        }
         if (ImGui::Button("Union")) {
             Timer timer;
             std::vector<MeshBooleanOperations::Polyhedron> polyMeshes;
             bool conversionSuccess = true;
             MeshConverter converter; // Create an instance of MeshConverter
-            for (const auto &sceneMesh : sceneMeshes) {
-                MeshBooleanOperations::Polyhedron poly;
-                if (!converter.convertMeshToPolyhedron(sceneMesh.mesh, poly)) {
+            polyMeshes.reserve(sceneMeshes.size());
+            for (auto &sceneMesh : sceneMeshes) {
+                bakeTransform(sceneMesh);
+                polyMeshes.emplace_back();
+                if (!converter.convertMeshToPolyhedron(*sceneMesh.mesh, polyMeshes.back())) {
                     conversionSuccess = false;
                     break;
                 }
-                polyMeshes.push_back(poly);
             }
             if (!conversionSuccess || polyMeshes.empty())
                 appendLog("Error: Failed to convert meshes for union operation.");
             else {
-                MeshBooleanOperations::Polyhedron resultPoly;
-                if (MeshBooleanOperations::computeUnion(polyMeshes, resultPoly)) {
-                    if (MeshBooleanOperations::writeOFF(booleanResultFile, resultPoly)) {
-                        appendLog("Union operation successful. Result saved to " + booleanResultFile);
-                        booleanOperationPerformed = true;
-                        addBooleanOperationMesh(booleanResultFile);
-                    } else
-                        appendLog("Error writing union result to OFF file.");
+                // The operands are consumed; the result is left in polyMeshes[0]
+                if (MeshBooleanOperations::computeUnionInPlace(polyMeshes)) {
+                    appendLog("Union operation successful.");
+                    addBooleanOperationMesh(std::move(polyMeshes[0]));
                 } else
                     appendLog("Union operation failed.");
             }
@@ -700,25 +950,22 @@ int main(int argc, char** argv) {
             std::vector<MeshBooleanOperations::Polyhedron> polyMeshes;
             bool conversionSuccess = true;
             MeshConverter converter;
-            for (const auto &sceneMesh : sceneMeshes) {
-                MeshBooleanOperations::Polyhedron poly;
-                if (!converter.convertMeshToPolyhedron(sceneMesh.mesh, poly)) {
+            polyMeshes.reserve(sceneMeshes.size());
+            for (auto &sceneMesh : sceneMeshes) {
+                bakeTransform(sceneMesh);
+                polyMeshes.emplace_back();
+                if (!converter.convertMeshToPolyhedron(*sceneMesh.mesh, polyMeshes.back())) {
                     conversionSuccess = false;
                     break;
                 }
-                polyMeshes.push_back(poly);
             }
             if (!conversionSuccess || polyMeshes.empty())
                 appendLog("Error: Failed to convert meshes for intersection operation.");
             else {
-                MeshBooleanOperations::Polyhedron resultPoly;
-                if (MeshBooleanOperations::computeIntersection(polyMeshes, resultPoly)) {
-                    if (MeshBooleanOperations::writeOFF(booleanResultFile, resultPoly)) {
-                        appendLog("Intersection operation successful. Result saved to " + booleanResultFile);
-                        booleanOperationPerformed = true;
-                        addBooleanOperationMesh(booleanResultFile);
-                    } else
-                        appendLog("Error writing intersection result to OFF file.");
+                // The operands are consumed; the result is left in polyMeshes[0]
+                if (MeshBooleanOperations::computeIntersectionInPlace(polyMeshes)) {
+                    appendLog("Intersection operation successful.");
+                    addBooleanOperationMesh(std::move(polyMeshes[0]));
                 } else
                     appendLog("Intersection operation failed.");
             }
@@ -730,25 +977,22 @@ int main(int argc, char** argv) {
             std::vector<MeshBooleanOperations::Polyhedron> polyMeshes;
             bool conversionSuccess = true;
             MeshConverter converter;
-            for (const auto &sceneMesh : sceneMeshes) {
-                MeshBooleanOperations::Polyhedron poly;
-                if (!converter.convertMeshToPolyhedron(sceneMesh.mesh, poly)) {
+            polyMeshes.reserve(sceneMeshes.size());
+            for (auto &sceneMesh : sceneMeshes) {
+                bakeTransform(sceneMesh);
+                polyMeshes.emplace_back();
+                if (!converter.convertMeshToPolyhedron(*sceneMesh.mesh, polyMeshes.back())) {
                     conversionSuccess = false;
                     break;
                 }
-                polyMeshes.push_back(poly);
             }
             if (!conversionSuccess || polyMeshes.empty())
                 appendLog("Error: Failed to convert meshes for difference operation.");
             else {
-                MeshBooleanOperations::Polyhedron resultPoly;
-                if (MeshBooleanOperations::computeDifference(polyMeshes, resultPoly)) {
-                    if (MeshBooleanOperations::writeOFF(booleanResultFile, resultPoly)) {
-                        appendLog("Difference operation successful. Result saved to " + booleanResultFile);
-                        booleanOperationPerformed = true;
-                        addBooleanOperationMesh(booleanResultFile);
-                    } else
-                        appendLog("Error writing difference result to OFF file.");
+                // The operands are consumed; the result is left in polyMeshes[0]
+                if (MeshBooleanOperations::computeDifferenceInPlace(polyMeshes)) {
+                    appendLog("Difference operation successful.");
+                    addBooleanOperationMesh(std::move(polyMeshes[0]));
                 } else
                     appendLog("Difference operation failed.");
             }
@@ -761,29 +1005,49 @@ int main(int argc, char** argv) {
         ImGui::SetNextWindowPos(ImVec2(250, 400),  ImGuiCond_FirstUseEver);
         ImGui::Begin("Adaptive Mesh Generator Controls", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
         ImGui::Text("AMG Parameters:");
-        ImGui::InputDouble("Sizing Field", &amg_sizing_field, 0.0, 0.0, "%.2f");
-        ImGui::InputDouble("Edge Distance", &amg_edge_distance, 0.0, 0.0, "%.3f");
-        ImGui::InputDouble("Facet Angle", &amg_facet_angle, 0.0, 0.0, "%.2f");
-        ImGui::InputDouble("Facet Distance", &amg_facet_distance, 0.0, 0.0, "%.3f");
-        ImGui::InputDouble("Cell Radius Edge Ratio", &amg_cell_radius_edge_ratio, 0.0, 0.0, "%.2f");
-        ImGui::InputFloat("Cube Size", &amg_cube_size, 0.0f, 0.0f, "%.2f");
-        if (ImGui::Button("Export Volume Mesh")) {
+        ImGui::InputDouble("Sizing Field", &amgOptions.sizingField, 0.0, 0.0, "%.2f");
+        ImGui::InputDouble("Edge Distance", &amgOptions.edgeDistance, 0.0, 0.0, "%.3f");
+        ImGui::InputDouble("Facet Angle", &amgOptions.facetAngle, 0.0, 0.0, "%.2f");
+        ImGui::InputDouble("Facet Distance", &amgOptions.facetDistance, 0.0, 0.0, "%.3f");
+        ImGui::InputDouble("Cell Radius Edge Ratio", &amgOptions.cellRadiusEdgeRatio, 0.0, 0.0, "%.2f");
+        ImGui::InputDouble("Cube Size", &amgOptions.cubeSize, 0.0, 0.0, "%.2f");
+        ImGui::InputInt("Threads (0 = all)", &amgOptions.threads);
+        amgOptions.threads = std::max(0, amgOptions.threads);
+        ImGui::InputText("Volume Mesh File", outputVolMeshFileName, IM_ARRAYSIZE(outputVolMeshFileName));
+        ImGui::Checkbox("Show volume mesh boundary", &showVolumeBoundary);
+        if (volumeMeshJob.valid()) {
+            // Stage-level progress; the meshing stage takes most of the time
+            int stage = volumeMeshProgress->stage;
+            char overlay[96];
+            std::snprintf(overlay, sizeof(overlay), "%s (%.0f s)", AdaptiveMeshGenerator::stageName(stage),
+                          volumeMeshTimer.elapsed() / 1000.0);
+            ImGui::ProgressBar(static_cast<float>(stage) / AdaptiveMeshGenerator::Done, ImVec2(-1.0f, 0.0f), overlay);
+            if (volumeMeshProgress->cancelled)
+                ImGui::Text("Cancelling...");
+            else if (ImGui::Button("Cancel Volume Mesh"))
+                volumeMeshProgress->cancelled = true;
+        } else if (ImGui::Button("Export Volume Mesh")) {
             if (!booleanOperationPerformed)
                 appendLog("No boolean operation result available for volume mesh generation.");
             else {
-                Timer timer;
                 try {
-                    AdaptiveMeshGenerator adaptiveMeshGen;
-                    if (adaptiveMeshGen.generateVolumeMesh(booleanResultFile, static_cast<int>(amg_cube_size), outputVolMeshFileName))
-                        appendLog("Volume mesh generated and exported using AMG parameters.");
-                    else
-                        appendLog("Failed to generate volume mesh from boolean operation result.");
+                    if (!booleanResultValid)
+                        appendLog("Boolean result failed validation (see Mesh Validation Log); volume mesh not generated.");
+                    else if (!ensureBooleanResultOnDisk())
+                        appendLog("Error writing boolean result to " + booleanResultFile);
+                    else {
+                        volumeMeshProgress = std::make_shared<AdaptiveMeshGenerator::Progress>();
+                        volumeMeshJobBoundary = std::make_shared<Mesh>();
+                        volumeMeshTimer.reset();
+                        volumeMeshJob = AdaptiveMeshGenerator::generateVolumeMeshAsync(booleanResultFile, amgOptions,
+                                                                                       outputVolMeshFileName, volumeMeshProgress,
+                                                                                       volumeMeshJobBoundary);
+                        appendLog("Volume mesh generation started.");
+                    }
                 } catch (const std::exception &ex) {
                     appendLog("Error exporting volume mesh: " + std::string(ex.what()));
                 }
-                double exportProcessingTime = timer.elapsed();
-                appendLog("Volume mesh export processing time: " + std::to_string(exportProcessingTime) + " ms");
-                if (MetadataExporter::exportMetadata(metadataFileName, mergedMeshMetadata))
+                if (MetadataExporter::exportMetadata(metadataFileName, mergedMeshMetadata, metadataEncoding))
                     appendLog("Metadata exported successfully to " + std::string(metadataFileName));
                 else
                     appendLog("Failed to export metadata to " + std::string(metadataFileName));
@@ -800,12 +1064,28 @@ int main(int argc, char** argv) {
 
             // Checkbox for Pick Faces mode
             ImGui::Checkbox("Pick Faces", &pickMode);
+            ImGui::RadioButton("Replace", &selectionMode, 0);
+            ImGui::SameLine();
+            ImGui::RadioButton("Add", &selectionMode, 1);
+            ImGui::SameLine();
+            ImGui::RadioButton("Remove", &selectionMode, 2);
             // Export options
             ImGui::Checkbox("Export Centroid Info", &exportCentroidInfo);
             ImGui::Checkbox("Export Face Info", &exportFaceInfo);
+            ImGui::InputText("Metadata File", metadataFileName, IM_ARRAYSIZE(metadataFileName));
+            ImGui::Checkbox("Face ranges", &metadataEncoding.faceRanges);
+            ImGui::SameLine();
+            ImGui::Checkbox("Columnar", &metadataEncoding.columnar);
+            ImGui::SameLine();
+            ImGui::Checkbox("Vertex indices", &metadataEncoding.vertexReferences);
 
             ImGui::Separator();
             ImGui::Text("Groups:");
+            if (mergedMeshMetadata.overlappingFaceCount() > 0) {
+                ImGui::SameLine();
+                ImGui::TextColored(ImVec4(1.0f, 0.6f, 0.1f, 1.0f), "(%zu faces in several groups)",
+                                   mergedMeshMetadata.overlappingFaceCount());
+            }
             // Retrieve group names from merged metadata
             std::vector<std::string> groupNames;
             for (auto const &pair : mergedMeshMetadata.getAllMetadata()) {
@@ -826,6 +1106,13 @@ int main(int argc, char** argv) {
                 ImGuiTreeNodeFlags node_flags = ImGuiTreeNodeFlags_DefaultOpen;
                 if (isActive) node_flags |= ImGuiTreeNodeFlags_Selected;
 
+                // Swatch in the group's viewport colour
+                float rgb[3];
+                MeshRenderBuffers::groupColor(mergedMeshMetadata.groupId(gName), rgb);
+                ImGui::ColorButton("##groupColour", ImVec4(rgb[0], rgb[1], rgb[2], 1.0f), ImGuiColorEditFlags_NoTooltip,
+                                   ImVec2(ImGui::GetFrameHeight(), ImGui::GetFrameHeight()));
+                ImGui::SameLine();
+
                 // Show the group name visually, but keep ID unique with ## suffix
                 std::string headerLabel = group->groupName + "##collapsing" + std::to_string(i);
                 bool nodeOpen = ImGui::CollapsingHeader(headerLabel.c_str(), node_flags);
@@ -982,7 +1269,7 @@ endGroupLoop:;
                     appendLog("No export option selected. Nothing done.");
                 } else {
                     Timer timer;
-                    bool success = MetadataExporter::exportMetadata(metadataFileName, mergedMeshMetadata);
+                    bool success = MetadataExporter::exportMetadata(metadataFileName, mergedMeshMetadata, metadataEncoding);
                     double exportTime = timer.elapsed();
                     if (success)
                         appendLog("Metadata exported to " + std::string(metadataFileName) + " in " + std::to_string(exportTime) + " ms");
@@ -1094,22 +1381,53 @@ endGroupLoop:;
         glEnd();
 
 
-        for (const auto &sceneMesh : sceneMeshes) {
+        // Faces of the merged mesh are coloured by metadata group
+        const SceneMesh *groupedMesh = booleanOperationPerformed ? findMergedMesh() : nullptr;
+        const std::vector<int> noGroups;
+        for (auto &sceneMesh : sceneMeshes) {
             if (!sceneMesh.enabled)
                 continue;
-            for (size_t i = 0; i < sceneMesh.mesh.faces.size(); i++) {
-                if (sceneMesh.errorFaces[i])
-                    glColor3f(1.0f, 0.0f, 0.0f);
-                else
-                    glColor3f(0.0f, 1.0f, 0.0f);
-                glBegin(GL_POLYGON);
-                const Face& face = sceneMesh.mesh.faces[i];
-                for (const auto &elem : face.elements) {
-                    const Vertex &v = sceneMesh.mesh.vertices[elem.vertexIndex];
-                    glVertex3d(v.x, v.y, v.z);
+            const bool grouped = &sceneMesh == groupedMesh;
+            const std::vector<int> &faceGroups = grouped ? mergedMeshMetadata.faceGroups() : noGroups;
+            if (sceneMesh.renderDirty) {
+                sceneMesh.renderBuffers.upload(*sceneMesh.mesh, sceneMesh.validation.faceErrors, faceGroups);
+                sceneMesh.groupsVersion = mergedMeshMetadata.membershipVersion();
+                sceneMesh.renderDirty = false;
+            } else if (grouped && sceneMesh.groupsVersion != mergedMeshMetadata.membershipVersion()) {
+                sceneMesh.renderBuffers.setFaceGroups(*sceneMesh.mesh, sceneMesh.validation.faceErrors, faceGroups);
+                sceneMesh.groupsVersion = mergedMeshMetadata.membershipVersion();
+            }
+            SceneLod &lod = *sceneMesh.lod;
+            if (lod.levels.poll()) {
+                lod.buffers.clear();
+                for (const Mesh &level : lod.levels.levels()) {
+                    lod.buffers.emplace_back();
+                    lod.buffers.back().upload(level, std::vector<std::uint8_t>());
                 }
-                glEnd();
+                lod.levels.releaseMeshes();
+            }
+            // Levels carry no error or group colours, so such meshes are always drawn in full
+            sceneMesh.lodLevel = 0;
+            MeshTransform::Matrix levelTransform = MeshTransform::compose(sceneMesh.transform, sceneMesh.bakedTransform);
+            if (useLod && !grouped && sceneMesh.validation.valid() && lod.levels.size() > 0)
+                sceneMesh.lodLevel = lod.levels.select(screenDiagonal(lod.levels.diagonal(), levelTransform, display_h));
+            glPushMatrix();
+            if (sceneMesh.lodLevel > 0) {
+                // The levels are in the coordinates of the mesh as loaded
+                glMultMatrixd(levelTransform.data());
+                lod.buffers[sceneMesh.lodLevel - 1].draw(renderMode == 1);
+            } else {
+                glMultMatrixd(sceneMesh.transform.data());
+                sceneMesh.renderBuffers.draw(renderMode == 1);
             }
+            glPopMatrix();
+        }
+        if (showVolumeBoundary && !volumeBoundary.mesh->faces.empty()) {
+            if (volumeBoundary.renderDirty) {
+                volumeBoundary.renderBuffers.upload(*volumeBoundary.mesh, volumeBoundary.validation.faceErrors);
+                volumeBoundary.renderDirty = false;
+            }
+            volumeBoundary.renderBuffers.draw(renderMode == 1);
         }
         glLineWidth(2.0f);
         glBegin(GL_LINES);
@@ -1129,6 +1447,14 @@ endGroupLoop:;
         ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
         glfwSwapBuffers(window);
     }
+    if (volumeMeshJob.valid()) {
+        volumeMeshProgress->cancelled = true;
+        finishVolumeMeshJob(true);
+    }
+    sceneMeshes.clear(); // Frees the GL buffers while the context exists
+    undoHistory.clear();
+    redoHistory.clear();
+    volumeBoundary = SceneMesh();
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
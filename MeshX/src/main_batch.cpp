@@ -0,0 +1,106 @@
+/**
+ * @file main_batch.cpp
+ * @brief MeshXBatch: runs the jobs of a JSON job file without the GUI.
+ *
+ * Usage: MeshXBatch <jobs.json> [--threads <n>] [--jobs <n>]
+ *        MeshXBatch --convert <in.off|in.obj> <out.obj|out.off>
+ *
+ * --threads overrides the file's thread budget and --jobs the number of jobs
+ * run at the same time. The exit code is 0 if every job succeeded.
+ *
+ * --convert streams one OFF file to OBJ or back with MeshConverter, in
+ * constant memory, for results too large to load.
+ */
+
+#include "BatchPipeline.h"
+#include "MeshConverter.h"
+#include "Timer.h"
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+bool hasExtension(const std::string &path, const char *extension) {
+    const std::size_t n = std::strlen(extension);
+    if (path.size() < n) return false;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (std::tolower(static_cast<unsigned char>(path[path.size() - n + i])) != extension[i]) return false;
+    }
+    return true;
+}
+
+int convert(const std::string &input, const std::string &output) {
+    MeshConverter converter;
+    Timer timer;
+    bool ok;
+    if (hasExtension(input, ".off") && hasExtension(output, ".obj")) {
+        ok = converter.convertOffToObj(input, output);
+    } else if (hasExtension(input, ".obj") && hasExtension(output, ".off")) {
+        ok = converter.convertObjToOff(input, output);
+    } else {
+        std::cerr << "--convert converts .off to .obj or .obj to .off\n";
+        return 1;
+    }
+    if (!ok) return 1;
+    std::cout << "Converted " << input << " to " << output << " in " << timer.elapsed() << " ms" << std::endl;
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    if (argc >= 2 && std::strcmp(argv[1], "--convert") == 0) {
+        if (argc != 4) {
+            std::cerr << "Usage: " << argv[0] << " --convert <in.off|in.obj> <out.obj|out.off>\n";
+            return 1;
+        }
+        return convert(argv[2], argv[3]);
+    }
+
+    std::string jobFile;
+    long threadsArg = -1, jobsArg = -1;
+    bool usage = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) threadsArg = std::atol(argv[++i]);
+        else if (std::strcmp(argv[i], "--jobs") == 0 && i + 1 < argc) jobsArg = std::atol(argv[++i]);
+        else if (jobFile.empty() && argv[i][0] != '-') jobFile = argv[i];
+        else usage = true;
+    }
+    if (usage || jobFile.empty() || threadsArg < -1 || jobsArg < -1) {
+        std::cerr << "Usage: " << argv[0] << " <jobs.json> [--threads <n>] [--jobs <n>]\n"
+                  << "       " << argv[0] << " --convert <in.off|in.obj> <out.obj|out.off>\n";
+        return 1;
+    }
+
+    std::vector<BatchPipeline::Job> jobs;
+    unsigned threads = 0, concurrentJobs = 0;
+    if (!BatchPipeline::loadJobFile(jobFile, jobs, threads, concurrentJobs))
+        return 1;
+    if (threadsArg >= 0) threads = static_cast<unsigned>(threadsArg);
+    if (jobsArg >= 0) concurrentJobs = static_cast<unsigned>(jobsArg);
+
+    // Each job's log is printed in one piece when it finishes
+    Timer timer;
+    BatchPipeline pipeline(threads, concurrentJobs);
+    std::vector<BatchPipeline::Result> results = pipeline.run(jobs, [](const BatchPipeline::Result &result) {
+        for (const std::string &line : result.log)
+            std::cout << "[" << result.name << "] " << line << "\n";
+        std::cout << "[" << result.name << "] " << (result.success ? "done" : "FAILED") << " in "
+                  << result.milliseconds << " ms" << std::endl;
+    });
+
+    std::size_t failed = 0;
+    for (const auto &result : results) {
+        if (!result.success) ++failed;
+    }
+    std::cout << results.size() - failed << " of " << results.size() << " jobs succeeded in "
+              << timer.elapsed() << " ms" << std::endl;
+    for (const auto &result : results) {
+        if (!result.success) std::cout << "  failed: " << result.name << "\n";
+    }
+    return failed ? 1 : 0;
+}